@@ -61,7 +61,8 @@ if(LINA_CLIENT_ENABLE_LOGGING)
 	target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_CLIENT_ENABLE_LOGGING=1)
 endif()
 
-if(LINA_ENABLE_EDITOR)
+# The editor draws through GLFW & the GL backend of ImGui, headless null device builds run without it.
+if(LINA_ENABLE_EDITOR AND NOT LINA_GRAPHICS_NULL_DEVICE)
 	target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_EDITOR=1)
 endif()
 
@@ -69,6 +70,10 @@ if(LINA_ENABLE_TIMEPROFILING)
 	target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_ENABLE_TIMEPROFILING=1)
 endif()
 
+if(LINA_GRAPHICS_NULL_DEVICE)
+	target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_GRAPHICS_NULL=1)
+endif()
+
 #--------------------------------------------------------------------
 # Build Type Config
 #--------------------------------------------------------------------
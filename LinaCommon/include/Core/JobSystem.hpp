@@ -0,0 +1,95 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: JobSystem
+
+Fixed pool of worker threads executing submitted jobs. Created on first use with one worker per
+hardware thread except the main one. Threads waiting for jobs help executing pending ones so that
+nested submissions don't dead-lock the pool.
+
+Timestamp: 10/19/2026 4:41:27 PM
+*/
+
+#pragma once
+
+#ifndef JobSystem_HPP
+#define JobSystem_HPP
+
+#include "Core/Common.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+namespace LinaEngine
+{
+	class JobSystem
+	{
+
+	public:
+
+		static JobSystem& Get();
+
+		// Queues the job, the returned future becomes ready once it is executed.
+		std::future<void> Submit(std::function<void()> job);
+
+		// Splits [0, count) into ranges of at least grainSize & blocks until all of them are processed.
+		void ParallelFor(uint32 count, uint32 grainSize, const std::function<void(uint32 begin, uint32 end)>& func);
+
+		// Blocks until the future is ready while executing pending jobs on the calling thread.
+		void Wait(std::future<void>& future);
+
+		// Executes a single pending job on the calling thread if there is any.
+		bool TryExecutePending();
+
+		uint32 GetWorkerCount() const { return (uint32)m_workers.size(); }
+
+	private:
+
+		JobSystem(uint32 workerCount);
+		~JobSystem();
+		DISALLOW_COPY_ASSIGN_MOVE(JobSystem);
+
+		void WorkerLoop();
+
+	private:
+
+		std::vector<std::thread> m_workers;
+		std::deque<std::packaged_task<void()>> m_jobs;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stopped = false;
+	};
+}
+
+#endif
@@ -39,7 +39,9 @@ Timestamp: 10/22/2020 11:04:40 PM
 #ifndef Timer_HPP
 #define Timer_HPP
 
+#include "Core/SizeDefinitions.hpp"
 #include <chrono>
+#include <functional>
 #include <string>
 #include <map>
 
@@ -84,6 +86,11 @@ namespace LinaEngine
 		static Timer& GetTimer(const std::string& name);
 		static void UnloadTimers();
 
+		// Best of iterations runs of func in milliseconds, used by the benchmarks. Setup runs before each
+		// iteration & isn't timed.
+		static double TimeBest(uint32 iterations, const std::function<void()>& func);
+		static double TimeBest(uint32 iterations, const std::function<void()>& setup, const std::function<void()>& func);
+
 	private:
 
 		const char* m_name = "";;
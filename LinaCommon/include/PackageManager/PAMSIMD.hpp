@@ -42,7 +42,7 @@ Timestamp: 4/9/2019 12:30:55 AM
 #include "Core/Environment.hpp"
 
 //Include appropriate header files for SIMD features and CPU architecture
-#if defined(SIMD_CPU_ARCH_x86) || defined(SIMD_CPU_ARCH_x86_64)
+#if SIMD_CPU_ARCH == SIMD_CPU_ARCH_x86 || SIMD_CPU_ARCH == SIMD_CPU_ARCH_x86_64
 #if SIMD_SUPPORTED_LEVEL >= SIMD_LEVEL_x86_AVX2
 #ifdef __GNUC__
 #include <x86intrin.h>
@@ -64,6 +64,25 @@ Timestamp: 4/9/2019 12:30:55 AM
 #elif SIMD_SUPPORTED_LEVEL == SIMD_LEVEL_x86_SSE
 #include <xmmintrin.h>
 #endif
+
+// Feature switches used by the vectorized code paths, scalar fallbacks are compiled otherwise.
+#if SIMD_SUPPORTED_LEVEL >= SIMD_LEVEL_x86_SSE
+#define LINA_SIMD_SSE
+#endif
+#if SIMD_SUPPORTED_LEVEL >= SIMD_LEVEL_x86_AVX
+#define LINA_SIMD_AVX
+#endif
+
+// Kernels above the baseline are compiled per function & selected at runtime from cpuid.
+#define LINA_SIMD_DISPATCH
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define LINA_SIMD_TARGET_SSE4 __attribute__((target("sse4.1")))
+#define LINA_SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define LINA_SIMD_TARGET_SSE4
+#define LINA_SIMD_TARGET_AVX2
+#endif
 #endif
 
 
@@ -0,0 +1,93 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: AABB
+
+Axis aligned bounding box & bounding sphere representations used for culling and spatial queries.
+
+Timestamp: 10/19/2026 3:02:41 PM
+*/
+
+#pragma once
+
+#ifndef AABB_HPP
+#define AABB_HPP
+
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include <cfloat>
+
+namespace LinaEngine
+{
+	class AABB
+	{
+	public:
+
+		AABB() {};
+		AABB(const Vector3& boundsMin, const Vector3& boundsMax) : m_boundsMin(boundsMin), m_boundsMax(boundsMax) {};
+
+		// Creates the tightest box containing the given positions.
+		static AABB FromPoints(const float* positions, size_t count, size_t stride = 3);
+
+		// Returns the world space box containing this box transformed by the given matrix.
+		AABB Transform(const Matrix& matrix) const;
+
+		void Expand(const Vector3& point);
+		void Expand(const AABB& other);
+		bool IsValid() const { return m_boundsMin.x <= m_boundsMax.x && m_boundsMin.y <= m_boundsMax.y && m_boundsMin.z <= m_boundsMax.z; }
+		bool Intersects(const AABB& other) const;
+		bool Contains(const Vector3& point) const;
+		Vector3 GetCenter() const { return (m_boundsMin + m_boundsMax) * 0.5f; }
+		Vector3 GetHalfExtents() const { return (m_boundsMax - m_boundsMin) * 0.5f; }
+		float GetSurfaceArea() const;
+
+		// Starts inverted so that the first expansion sets the bounds.
+		Vector3 m_boundsMin = Vector3(FLT_MAX);
+		Vector3 m_boundsMax = Vector3(-FLT_MAX);
+	};
+
+	class BoundingSphere
+	{
+	public:
+
+		BoundingSphere() {};
+		BoundingSphere(const Vector3& center, float radius) : m_center(center), m_radius(radius) {};
+
+		// Creates a sphere centered on the box containing all the given positions.
+		static BoundingSphere FromPoints(const AABB& box, const float* positions, size_t count, size_t stride = 3);
+
+		// Returns the world space sphere, radius is scaled by the largest axis scale of the matrix.
+		BoundingSphere Transform(const Matrix& matrix) const;
+
+		Vector3 m_center = Vector3::Zero;
+		float m_radius = 0.0f;
+	};
+}
+
+#endif
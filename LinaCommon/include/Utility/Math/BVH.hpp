@@ -0,0 +1,158 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: BVH
+
+Dynamic bounding volume hierarchy with 4-wide nodes. Moved proxies are refitted incrementally,
+new proxies are kept in a pending list until the next rebuild and destroyed ones are skipped.
+Rebuilds use binned SAH and run on the job system when the refitted tree degrades.
+
+Timestamp: 10/19/2026 5:18:44 PM
+*/
+
+#pragma once
+
+#ifndef BVH_HPP
+#define BVH_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include "AABB.hpp"
+#include "Ray.hpp"
+#include "Frustum.hpp"
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace LinaEngine
+{
+	class BVH
+	{
+
+	public:
+
+		struct RayHit
+		{
+			uint32 m_userData = 0xFFFFFFFF;
+			float m_distance = FLT_MAX;
+		};
+
+		// Optional narrow phase for ray casts, returns true & writes the distance if the primitive is hit.
+		typedef std::function<bool(uint32 userData, const Ray& ray, float& distance)> RayTestCallback;
+
+		BVH() {};
+		~BVH();
+
+		uint32 CreateProxy(const AABB& bounds, uint32 userData);
+		void DestroyProxy(uint32 proxy);
+		void MoveProxy(uint32 proxy, const AABB& bounds);
+		const AABB& GetProxyBounds(uint32 proxy) const { return m_proxies[proxy].m_bounds; }
+		uint32 GetUserData(uint32 proxy) const { return m_proxies[proxy].m_userData; }
+		void SetUserData(uint32 proxy, uint32 userData) { m_proxies[proxy].m_userData = userData; }
+
+		// Refits moved proxies, applies finished background builds & schedules a new one if the tree has degraded.
+		void Update();
+
+		// Rebuilds the tree synchronously on the calling thread.
+		void Rebuild();
+
+		bool RayCast(const Ray& ray, float maxDistance, RayHit& hit, const RayTestCallback& callback = nullptr) const;
+		void QueryAABB(const AABB& box, std::vector<uint32>& results) const;
+		void QueryFrustum(const Frustum& frustum, std::vector<uint32>& results) const;
+
+		uint32 GetProxyCount() const { return m_aliveCount; }
+		uint32 GetNodeCount() const { return (uint32)m_nodes.size(); }
+		bool IsRebuilding() const { return m_buildFuture.valid(); }
+
+	private:
+
+		// Child bounds are stored as SoA so that all four can be tested at once.
+		struct Node
+		{
+			float m_minX[4], m_minY[4], m_minZ[4];
+			float m_maxX[4], m_maxY[4], m_maxZ[4];
+
+			// > 0 inner node index, < 0 leaf with first primitive at -(child + 1), 0 with no count for empty slots.
+			int32 m_children[4];
+			uint32 m_counts[4];
+			int32 m_parent = -1;
+		};
+
+		struct Proxy
+		{
+			AABB m_bounds;
+			uint32 m_userData = 0;
+			int32 m_leafNode = -1;
+			bool m_alive = false;
+		};
+
+		struct BuildData
+		{
+			std::vector<AABB> m_bounds;
+			std::vector<uint32> m_proxies;
+			std::vector<Node> m_nodes;
+			std::vector<uint32> m_primitives;
+			std::vector<uint32> m_releasedProxies;
+		};
+
+		static void Build(BuildData& data);
+		static int32 BuildNode(BuildData& data, std::vector<uint32>& references, const std::vector<Vector3>& centroids, uint32 begin, uint32 end, int32 parent);
+		static uint32 SplitSAH(const BuildData& data, std::vector<uint32>& references, const std::vector<Vector3>& centroids, uint32 begin, uint32 end);
+
+		static void SetSlotBounds(Node& node, int slot, const AABB& bounds);
+		static AABB GetSlotBounds(const Node& node, int slot);
+		static bool IsEmptySlot(const Node& node, int slot) { return node.m_children[slot] == 0 && node.m_counts[slot] == 0; }
+
+		std::shared_ptr<BuildData> CreateBuildData();
+		void ApplyBuild(BuildData& data);
+		void MarkDirty(int32 node);
+		void RefitNode(int32 node);
+		float CalculateCost() const;
+		bool ShouldRebuild() const;
+
+	private:
+
+		std::vector<Node> m_nodes;
+		std::vector<uint8> m_dirtyNodes;
+		std::vector<uint32> m_primitives;
+		std::vector<Proxy> m_proxies;
+		std::vector<uint32> m_pendingProxies;
+		std::vector<uint32> m_freeProxies;
+		std::vector<uint32> m_releasedProxies;
+		uint32 m_aliveCount = 0;
+		uint32 m_dirtyCount = 0;
+		float m_builtCost = 0.0f;
+		float m_currentCost = 0.0f;
+
+		std::future<void> m_buildFuture;
+		std::shared_ptr<BuildData> m_buildData;
+	};
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: BVHBenchmark
+
+Times the BVH build, refits after moving a part or all of the proxies, and ray, box & frustum query
+throughput over a large random scene. Builds run synchronously on the calling thread.
+
+Timestamp: 10/20/2026 9:48:15 AM
+*/
+
+#pragma once
+
+#ifndef BVHBenchmark_HPP
+#define BVHBenchmark_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <string>
+#include <vector>
+
+namespace LinaEngine
+{
+	struct BVHBenchmarkResult
+	{
+		std::string m_operation;
+		uint32 m_count = 0;
+		double m_ms = 0.0;
+		double m_nsPerItem = 0.0;
+
+		// Hits or query results over all items, keeps the queries from being optimized away.
+		uint64 m_results = 0;
+	};
+
+	class BVHBenchmark
+	{
+	public:
+
+		// Best time of the iterations for each operation, queries are spread over the whole scene.
+		static std::vector<BVHBenchmarkResult> Run(uint32 primitiveCount = 1000000, uint32 queryCount = 10000, uint32 iterations = 3);
+		static void LogResults(const std::vector<BVHBenchmarkResult>& results);
+	};
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: Frustum
+
+Six planes extracted from a view-projection matrix, used to test bounding volumes against
+the camera. Batch sphere tests are vectorized when SSE is available.
+
+Timestamp: 10/19/2026 3:20:12 PM
+*/
+
+#pragma once
+
+#ifndef Frustum_HPP
+#define Frustum_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include "AABB.hpp"
+
+namespace LinaEngine
+{
+	enum FrustumPlane
+	{
+		FRUSTUM_LEFT = 0,
+		FRUSTUM_RIGHT = 1,
+		FRUSTUM_BOTTOM = 2,
+		FRUSTUM_TOP = 3,
+		FRUSTUM_NEAR = 4,
+		FRUSTUM_FAR = 5,
+		FRUSTUM_PLANE_COUNT = 6
+	};
+
+	class Frustum
+	{
+	public:
+
+		Frustum() {};
+		Frustum(const Matrix& viewProjection) { Extract(viewProjection); }
+
+		// Extracts & normalizes the planes, normals point inwards.
+		void Extract(const Matrix& viewProjection);
+
+		bool IntersectsSphere(const Vector3& center, float radius) const;
+		bool IntersectsAABB(const AABB& box) const;
+
+		// Tests spheres packed as (center, radius), writes 1 for visible & 0 for culled into results. Returns the visible count.
+		uint32 CullSpheres(const Vector4* spheres, uint32 count, uint8* results) const;
+
+		const Vector4& GetPlane(FrustumPlane plane) const { return m_planes[plane]; }
+
+	private:
+
+		Vector4 m_planes[FRUSTUM_PLANE_COUNT];
+	};
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: MathBatch
+
+Batch kernels for the per entity transform math, working on structure of arrays inputs. Each kernel
+has a scalar, an SSE4.1 & an AVX2/FMA version, the widest one the CPU supports is selected at runtime.
+Results match the glm based Matrix & Quaternion functions up to rounding.
+
+Timestamp: 10/20/2026 12:24:10 AM
+*/
+
+#pragma once
+
+#ifndef MathBatch_HPP
+#define MathBatch_HPP
+
+#include "Matrix.hpp"
+#include "AABB.hpp"
+#include "Core/SizeDefinitions.hpp"
+
+namespace LinaEngine
+{
+	enum class SIMDLevel : uint8
+	{
+		Scalar = 0,
+		SSE4 = 1,
+		AVX2 = 2
+	};
+
+	// Each array holds at least the element count passed to the kernels.
+	struct Vector3SoA
+	{
+		float* m_x = nullptr;
+		float* m_y = nullptr;
+		float* m_z = nullptr;
+	};
+
+	struct QuaternionSoA
+	{
+		float* m_x = nullptr;
+		float* m_y = nullptr;
+		float* m_z = nullptr;
+		float* m_w = nullptr;
+	};
+
+	class MathBatch
+	{
+	public:
+
+		// Widest level the CPU & the OS support, detected once.
+		static SIMDLevel GetSupportedLevel();
+
+		// Requests above the supported level are clamped, lowering it is meant for comparing the paths.
+		static void SetLevel(SIMDLevel level);
+		static SIMDLevel GetLevel();
+		static const char* GetLevelName(SIMDLevel level);
+
+		// out[i] = T * R * S, same as Matrix::TransformMatrix.
+		static void ComposeTRS(const Vector3SoA& positions, const QuaternionSoA& rotations, const Vector3SoA& scales, Matrix* out, size_t count);
+
+		// out[i] = a[i] * b[i], out may alias either input.
+		static void Multiply(const Matrix* a, const Matrix* b, Matrix* out, size_t count);
+
+		// Inverse of matrices with a last row of (0, 0, 0, 1), out may alias the input.
+		static void InverseAffine(const Matrix* in, Matrix* out, size_t count);
+
+		// Transposed inverse of affine matrices, same as Matrix::ToNormalMatrix.
+		static void NormalMatrix(const Matrix* in, Matrix* out, size_t count);
+
+		// out[i] = boxes[i].Transform(matrices[i]), out may alias the boxes.
+		static void TransformAABB(const AABB* boxes, const Matrix* matrices, AABB* out, size_t count);
+
+		// In place, zero length quaternions become identity like glm::normalize.
+		static void NormalizeQuaternions(const QuaternionSoA& rotations, size_t count);
+
+		// Shortest path interpolation for t in [0, 1], the SIMD versions use polynomial acos & sin. Out may alias from.
+		static void Slerp(const QuaternionSoA& from, const QuaternionSoA& to, const float* t, const QuaternionSoA& out, size_t count);
+	};
+}
+
+#endif
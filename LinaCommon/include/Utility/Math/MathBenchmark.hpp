@@ -0,0 +1,71 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: MathBenchmark
+
+Times the MathBatch kernels at every supported SIMD level against the per element glm path they
+replace, on the same random transforms. Also reports the largest deviation from the glm results.
+
+Timestamp: 10/20/2026 1:02:37 AM
+*/
+
+#pragma once
+
+#ifndef MathBenchmark_HPP
+#define MathBenchmark_HPP
+
+#include "MathBatch.hpp"
+#include <string>
+#include <vector>
+
+#define MATHBENCHMARK_LEVEL_COUNT 3
+
+namespace LinaEngine
+{
+	struct MathBenchmarkResult
+	{
+		std::string m_kernel;
+		double m_glmMS = 0.0;
+
+		// Indexed by SIMDLevel, negative times for the levels the CPU doesn't support.
+		double m_batchMS[MATHBENCHMARK_LEVEL_COUNT] = { -1.0, -1.0, -1.0 };
+		float m_maxError[MATHBENCHMARK_LEVEL_COUNT] = { 0.0f, 0.0f, 0.0f };
+	};
+
+	class MathBenchmark
+	{
+	public:
+
+		// Best time of the iterations for each kernel, the dispatch level is restored afterwards.
+		static std::vector<MathBenchmarkResult> Run(size_t count = 4096, uint32 iterations = 32);
+		static void LogResults(const std::vector<MathBenchmarkResult>& results);
+	};
+}
+
+#endif
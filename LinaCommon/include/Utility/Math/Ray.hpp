@@ -0,0 +1,65 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: Ray
+
+Half line defined by an origin & direction, used for picking and spatial queries.
+
+Timestamp: 10/19/2026 5:05:33 PM
+*/
+
+#pragma once
+
+#ifndef Ray_HPP
+#define Ray_HPP
+
+#include "Vector.hpp"
+#include "AABB.hpp"
+
+namespace LinaEngine
+{
+	class Ray
+	{
+	public:
+
+		Ray() {};
+		Ray(const Vector3& origin, const Vector3& direction) : m_origin(origin), m_direction(direction) {};
+
+		Vector3 GetPoint(float distance) const { return glm::vec3(m_origin) + glm::vec3(m_direction) * distance; }
+
+		// Distances are in units of the direction vector, which doesn't need to be normalized.
+		bool IntersectsAABB(const AABB& box, float maxDistance, float& distance) const;
+		bool IntersectsTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, float& distance) const;
+
+		Vector3 m_origin = Vector3::Zero;
+		Vector3 m_direction = Vector3::Forward;
+	};
+}
+
+#endif
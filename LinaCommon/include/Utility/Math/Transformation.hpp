@@ -156,6 +156,9 @@ namespace LinaEngine
 		void SetRotation(const Quaternion& rot, bool isThisPivot = true);
 		void SetScale(const Vector3& scale, bool isThisPivot = true);
 
+		// Sets both in one pass, children are refreshed once & leaf transformations skip the hierarchy entirely.
+		void SetLocationAndRotation(const Vector3& loc, const Quaternion& rot);
+
 		const Vector3& GetLocalLocation() { return m_localLocation; }
 		const Quaternion& GetLocalRotation() { return m_localRotation; }
 		const Vector3& GetLocalScale() { return m_localScale; }
@@ -100,6 +100,7 @@ namespace LinaEngine
 		bool operator>(const Vector2& rhs) const { return length() > rhs.length(); }
 		bool operator<(const Vector2& rhs) const { return length() < rhs.length(); }
 		float& operator[] (unsigned int i) { return (&x)[i]; }
+		const float& operator[] (unsigned int i) const { return (&x)[i]; }
 		Vector2 operator-() const { return Vector2(-*this); }
 		float* Get() { return &x; }
 
@@ -183,6 +184,7 @@ namespace LinaEngine
 		bool operator>(const Vector3& rhs) const { return length() > rhs.length(); }
 		bool operator<(const Vector3& rhs) const { return length() < rhs.length(); }
 		float& operator[] (unsigned int i) { return (&x)[i]; }
+		const float& operator[] (unsigned int i) const { return (&x)[i]; }
 		Vector3 operator-() const { return Vector3(-x, -y, -z); }
 		float* Get() { return &x; }
 
@@ -263,6 +265,7 @@ namespace LinaEngine
 		bool operator>(const Vector4& rhs) const { return length() > rhs.length(); }
 		bool operator<(const Vector4& rhs) const { return length() < rhs.length(); }
 		float& operator[] (unsigned int i) { return (&x)[i]; }
+		const float& operator[] (unsigned int i) const { return (&x)[i]; }
 		Vector4 operator-() const { return Vector4(-*this); }
 		float* Get() { return &x; }
 
@@ -0,0 +1,434 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: WideMath
+
+Lane wide float, mask, vector & quaternion types for data parallel gameplay code. Systems are written once
+against the xN templates & run 4 or 8 entities per instruction. floatx4 maps to SSE & floatx8 to AVX when
+the build targets them (LINA_SIMD_SSE/LINA_SIMD_AVX from PAMSIMD), otherwise they fall back to plain lanes
+& pairs of floatx4, so results are the same on every target up to rounding.
+
+Timestamp: 10/20/2026 2:14:09 AM
+*/
+
+#pragma once
+
+#ifndef WideMath_HPP
+#define WideMath_HPP
+
+#include "MathBatch.hpp"
+#include "Core/Common.hpp"
+#include "Quaternion.hpp"
+#include "PackageManager/PAMSIMD.hpp"
+#include <cmath>
+
+namespace LinaEngine
+{
+	// Lane masks, set lanes are all ones in the SIMD versions.
+	struct maskx4
+	{
+#ifdef LINA_SIMD_SSE
+		__m128 m_v;
+		maskx4() : m_v(_mm_setzero_ps()) {}
+		maskx4(__m128 v) : m_v(v) {}
+
+		maskx4 operator&(const maskx4& other) const { return _mm_and_ps(m_v, other.m_v); }
+		maskx4 operator|(const maskx4& other) const { return _mm_or_ps(m_v, other.m_v); }
+		maskx4 operator^(const maskx4& other) const { return _mm_xor_ps(m_v, other.m_v); }
+		maskx4 operator~() const { return _mm_xor_ps(m_v, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+
+		// Bit i is set when lane i is.
+		int ToBits() const { return _mm_movemask_ps(m_v); }
+#else
+		bool m_v[4] = { false, false, false, false };
+
+		maskx4 operator&(const maskx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] && other.m_v[i]; return r; }
+		maskx4 operator|(const maskx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] || other.m_v[i]; return r; }
+		maskx4 operator^(const maskx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] != other.m_v[i]; return r; }
+		maskx4 operator~() const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = !m_v[i]; return r; }
+
+		int ToBits() const { int bits = 0; for (int i = 0; i < 4; i++) bits |= m_v[i] ? (1 << i) : 0; return bits; }
+#endif
+		bool Any() const { return ToBits() != 0; }
+		bool All() const { return ToBits() == 0xF; }
+		bool None() const { return ToBits() == 0; }
+
+		// First count lanes set, for the tail of an array.
+		static maskx4 FirstLanes(int count);
+	};
+
+	// Generate(func) builds the lanes from func(lane) in registers, cheaper than a load from a freshly written array.
+	struct floatx4
+	{
+		typedef maskx4 Mask;
+		static constexpr int Width = 4;
+
+#ifdef LINA_SIMD_SSE
+		__m128 m_v;
+		floatx4() : m_v(_mm_setzero_ps()) {}
+		floatx4(__m128 v) : m_v(v) {}
+		floatx4(float v) : m_v(_mm_set1_ps(v)) {}
+		floatx4(float x, float y, float z, float w) : m_v(_mm_setr_ps(x, y, z, w)) {}
+
+		static floatx4 Load(const float* src) { return _mm_loadu_ps(src); }
+		template<typename Func> static FORCEINLINE floatx4 Generate(Func func) { return _mm_setr_ps(func(0), func(1), func(2), func(3)); }
+		void Store(float* dst) const { _mm_storeu_ps(dst, m_v); }
+
+		floatx4 operator+(const floatx4& other) const { return _mm_add_ps(m_v, other.m_v); }
+		floatx4 operator-(const floatx4& other) const { return _mm_sub_ps(m_v, other.m_v); }
+		floatx4 operator*(const floatx4& other) const { return _mm_mul_ps(m_v, other.m_v); }
+		floatx4 operator/(const floatx4& other) const { return _mm_div_ps(m_v, other.m_v); }
+		floatx4 operator-() const { return _mm_xor_ps(m_v, _mm_set1_ps(-0.0f)); }
+
+		maskx4 operator<(const floatx4& other) const { return _mm_cmplt_ps(m_v, other.m_v); }
+		maskx4 operator<=(const floatx4& other) const { return _mm_cmple_ps(m_v, other.m_v); }
+		maskx4 operator>(const floatx4& other) const { return _mm_cmpgt_ps(m_v, other.m_v); }
+		maskx4 operator>=(const floatx4& other) const { return _mm_cmpge_ps(m_v, other.m_v); }
+		maskx4 operator==(const floatx4& other) const { return _mm_cmpeq_ps(m_v, other.m_v); }
+		maskx4 operator!=(const floatx4& other) const { return _mm_cmpneq_ps(m_v, other.m_v); }
+#else
+		float m_v[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		floatx4() {}
+		floatx4(float v) { for (int i = 0; i < 4; i++) m_v[i] = v; }
+		floatx4(float x, float y, float z, float w) { m_v[0] = x; m_v[1] = y; m_v[2] = z; m_v[3] = w; }
+
+		static floatx4 Load(const float* src) { return floatx4(src[0], src[1], src[2], src[3]); }
+		template<typename Func> static FORCEINLINE floatx4 Generate(Func func) { return floatx4(func(0), func(1), func(2), func(3)); }
+		void Store(float* dst) const { for (int i = 0; i < 4; i++) dst[i] = m_v[i]; }
+
+		floatx4 operator+(const floatx4& other) const { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] + other.m_v[i]; return r; }
+		floatx4 operator-(const floatx4& other) const { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] - other.m_v[i]; return r; }
+		floatx4 operator*(const floatx4& other) const { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] * other.m_v[i]; return r; }
+		floatx4 operator/(const floatx4& other) const { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] / other.m_v[i]; return r; }
+		floatx4 operator-() const { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = -m_v[i]; return r; }
+
+		maskx4 operator<(const floatx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] < other.m_v[i]; return r; }
+		maskx4 operator<=(const floatx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] <= other.m_v[i]; return r; }
+		maskx4 operator>(const floatx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] > other.m_v[i]; return r; }
+		maskx4 operator>=(const floatx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] >= other.m_v[i]; return r; }
+		maskx4 operator==(const floatx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] == other.m_v[i]; return r; }
+		maskx4 operator!=(const floatx4& other) const { maskx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = m_v[i] != other.m_v[i]; return r; }
+#endif
+		floatx4& operator+=(const floatx4& other) { return *this = *this + other; }
+		floatx4& operator-=(const floatx4& other) { return *this = *this - other; }
+		floatx4& operator*=(const floatx4& other) { return *this = *this * other; }
+		floatx4& operator/=(const floatx4& other) { return *this = *this / other; }
+
+		float GetLane(int lane) const { float lanes[4]; Store(lanes); return lanes[lane]; }
+	};
+
+	FORCEINLINE maskx4 maskx4::FirstLanes(int count)
+	{
+		return floatx4(0.0f, 1.0f, 2.0f, 3.0f) < floatx4((float)count);
+	}
+
+#ifdef LINA_SIMD_SSE
+	FORCEINLINE floatx4 Min(const floatx4& a, const floatx4& b) { return _mm_min_ps(a.m_v, b.m_v); }
+	FORCEINLINE floatx4 Max(const floatx4& a, const floatx4& b) { return _mm_max_ps(a.m_v, b.m_v); }
+	FORCEINLINE floatx4 Sqrt(const floatx4& a) { return _mm_sqrt_ps(a.m_v); }
+	FORCEINLINE floatx4 Abs(const floatx4& a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.m_v); }
+
+	// Lanes of a where the mask is set, b elsewhere.
+	FORCEINLINE floatx4 Select(const maskx4& mask, const floatx4& a, const floatx4& b) { return _mm_or_ps(_mm_and_ps(mask.m_v, a.m_v), _mm_andnot_ps(mask.m_v, b.m_v)); }
+#else
+	FORCEINLINE floatx4 Min(const floatx4& a, const floatx4& b) { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = b.m_v[i] < a.m_v[i] ? b.m_v[i] : a.m_v[i]; return r; }
+	FORCEINLINE floatx4 Max(const floatx4& a, const floatx4& b) { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = a.m_v[i] < b.m_v[i] ? b.m_v[i] : a.m_v[i]; return r; }
+	FORCEINLINE floatx4 Sqrt(const floatx4& a) { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = std::sqrt(a.m_v[i]); return r; }
+	FORCEINLINE floatx4 Abs(const floatx4& a) { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = std::fabs(a.m_v[i]); return r; }
+	FORCEINLINE floatx4 Select(const maskx4& mask, const floatx4& a, const floatx4& b) { floatx4 r; for (int i = 0; i < 4; i++) r.m_v[i] = mask.m_v[i] ? a.m_v[i] : b.m_v[i]; return r; }
+#endif
+
+	// a * b + c.
+	FORCEINLINE floatx4 MulAdd(const floatx4& a, const floatx4& b, const floatx4& c) { return a * b + c; }
+
+#ifdef LINA_SIMD_AVX
+	struct maskx8
+	{
+		__m256 m_v;
+		maskx8() : m_v(_mm256_setzero_ps()) {}
+		maskx8(__m256 v) : m_v(v) {}
+
+		maskx8 operator&(const maskx8& other) const { return _mm256_and_ps(m_v, other.m_v); }
+		maskx8 operator|(const maskx8& other) const { return _mm256_or_ps(m_v, other.m_v); }
+		maskx8 operator^(const maskx8& other) const { return _mm256_xor_ps(m_v, other.m_v); }
+		maskx8 operator~() const { return _mm256_xor_ps(m_v, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+
+		int ToBits() const { return _mm256_movemask_ps(m_v); }
+		bool Any() const { return ToBits() != 0; }
+		bool All() const { return ToBits() == 0xFF; }
+		bool None() const { return ToBits() == 0; }
+
+		static maskx8 FirstLanes(int count);
+	};
+
+	struct floatx8
+	{
+		typedef maskx8 Mask;
+		static constexpr int Width = 8;
+
+		__m256 m_v;
+		floatx8() : m_v(_mm256_setzero_ps()) {}
+		floatx8(__m256 v) : m_v(v) {}
+		floatx8(float v) : m_v(_mm256_set1_ps(v)) {}
+
+		static floatx8 Load(const float* src) { return _mm256_loadu_ps(src); }
+		template<typename Func> static FORCEINLINE floatx8 Generate(Func func) { return _mm256_setr_ps(func(0), func(1), func(2), func(3), func(4), func(5), func(6), func(7)); }
+		void Store(float* dst) const { _mm256_storeu_ps(dst, m_v); }
+
+		floatx8 operator+(const floatx8& other) const { return _mm256_add_ps(m_v, other.m_v); }
+		floatx8 operator-(const floatx8& other) const { return _mm256_sub_ps(m_v, other.m_v); }
+		floatx8 operator*(const floatx8& other) const { return _mm256_mul_ps(m_v, other.m_v); }
+		floatx8 operator/(const floatx8& other) const { return _mm256_div_ps(m_v, other.m_v); }
+		floatx8 operator-() const { return _mm256_xor_ps(m_v, _mm256_set1_ps(-0.0f)); }
+
+		maskx8 operator<(const floatx8& other) const { return _mm256_cmp_ps(m_v, other.m_v, _CMP_LT_OQ); }
+		maskx8 operator<=(const floatx8& other) const { return _mm256_cmp_ps(m_v, other.m_v, _CMP_LE_OQ); }
+		maskx8 operator>(const floatx8& other) const { return _mm256_cmp_ps(m_v, other.m_v, _CMP_GT_OQ); }
+		maskx8 operator>=(const floatx8& other) const { return _mm256_cmp_ps(m_v, other.m_v, _CMP_GE_OQ); }
+		maskx8 operator==(const floatx8& other) const { return _mm256_cmp_ps(m_v, other.m_v, _CMP_EQ_OQ); }
+		maskx8 operator!=(const floatx8& other) const { return _mm256_cmp_ps(m_v, other.m_v, _CMP_NEQ_UQ); }
+
+		floatx8& operator+=(const floatx8& other) { return *this = *this + other; }
+		floatx8& operator-=(const floatx8& other) { return *this = *this - other; }
+		floatx8& operator*=(const floatx8& other) { return *this = *this * other; }
+		floatx8& operator/=(const floatx8& other) { return *this = *this / other; }
+
+		float GetLane(int lane) const { float lanes[8]; Store(lanes); return lanes[lane]; }
+	};
+
+	FORCEINLINE maskx8 maskx8::FirstLanes(int count)
+	{
+		return floatx8(_mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)) < floatx8((float)count);
+	}
+
+	FORCEINLINE floatx8 Min(const floatx8& a, const floatx8& b) { return _mm256_min_ps(a.m_v, b.m_v); }
+	FORCEINLINE floatx8 Max(const floatx8& a, const floatx8& b) { return _mm256_max_ps(a.m_v, b.m_v); }
+	FORCEINLINE floatx8 Sqrt(const floatx8& a) { return _mm256_sqrt_ps(a.m_v); }
+	FORCEINLINE floatx8 Abs(const floatx8& a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.m_v); }
+	FORCEINLINE floatx8 Select(const maskx8& mask, const floatx8& a, const floatx8& b) { return _mm256_blendv_ps(b.m_v, a.m_v, mask.m_v); }
+#ifdef __FMA__
+	FORCEINLINE floatx8 MulAdd(const floatx8& a, const floatx8& b, const floatx8& c) { return _mm256_fmadd_ps(a.m_v, b.m_v, c.m_v); }
+#else
+	FORCEINLINE floatx8 MulAdd(const floatx8& a, const floatx8& b, const floatx8& c) { return a * b + c; }
+#endif
+#else
+	// Without AVX the 8 wide types are two 4 wide halves, so code written for 8 lanes still compiles & vectorizes.
+	struct maskx8
+	{
+		maskx4 m_lo, m_hi;
+		maskx8() {}
+		maskx8(const maskx4& lo, const maskx4& hi) : m_lo(lo), m_hi(hi) {}
+
+		maskx8 operator&(const maskx8& other) const { return maskx8(m_lo & other.m_lo, m_hi & other.m_hi); }
+		maskx8 operator|(const maskx8& other) const { return maskx8(m_lo | other.m_lo, m_hi | other.m_hi); }
+		maskx8 operator^(const maskx8& other) const { return maskx8(m_lo ^ other.m_lo, m_hi ^ other.m_hi); }
+		maskx8 operator~() const { return maskx8(~m_lo, ~m_hi); }
+
+		int ToBits() const { return m_lo.ToBits() | (m_hi.ToBits() << 4); }
+		bool Any() const { return ToBits() != 0; }
+		bool All() const { return ToBits() == 0xFF; }
+		bool None() const { return ToBits() == 0; }
+
+		static maskx8 FirstLanes(int count) { return maskx8(maskx4::FirstLanes(count), maskx4::FirstLanes(count - 4)); }
+	};
+
+	struct floatx8
+	{
+		typedef maskx8 Mask;
+		static constexpr int Width = 8;
+
+		floatx4 m_lo, m_hi;
+		floatx8() {}
+		floatx8(float v) : m_lo(v), m_hi(v) {}
+		floatx8(const floatx4& lo, const floatx4& hi) : m_lo(lo), m_hi(hi) {}
+
+		static floatx8 Load(const float* src) { return floatx8(floatx4::Load(src), floatx4::Load(src + 4)); }
+		template<typename Func> static FORCEINLINE floatx8 Generate(Func func) { return floatx8(floatx4::Generate(func), floatx4::Generate([&](int lane) { return func(lane + 4); })); }
+		void Store(float* dst) const { m_lo.Store(dst); m_hi.Store(dst + 4); }
+
+		floatx8 operator+(const floatx8& other) const { return floatx8(m_lo + other.m_lo, m_hi + other.m_hi); }
+		floatx8 operator-(const floatx8& other) const { return floatx8(m_lo - other.m_lo, m_hi - other.m_hi); }
+		floatx8 operator*(const floatx8& other) const { return floatx8(m_lo * other.m_lo, m_hi * other.m_hi); }
+		floatx8 operator/(const floatx8& other) const { return floatx8(m_lo / other.m_lo, m_hi / other.m_hi); }
+		floatx8 operator-() const { return floatx8(-m_lo, -m_hi); }
+
+		maskx8 operator<(const floatx8& other) const { return maskx8(m_lo < other.m_lo, m_hi < other.m_hi); }
+		maskx8 operator<=(const floatx8& other) const { return maskx8(m_lo <= other.m_lo, m_hi <= other.m_hi); }
+		maskx8 operator>(const floatx8& other) const { return maskx8(m_lo > other.m_lo, m_hi > other.m_hi); }
+		maskx8 operator>=(const floatx8& other) const { return maskx8(m_lo >= other.m_lo, m_hi >= other.m_hi); }
+		maskx8 operator==(const floatx8& other) const { return maskx8(m_lo == other.m_lo, m_hi == other.m_hi); }
+		maskx8 operator!=(const floatx8& other) const { return maskx8(m_lo != other.m_lo, m_hi != other.m_hi); }
+
+		floatx8& operator+=(const floatx8& other) { return *this = *this + other; }
+		floatx8& operator-=(const floatx8& other) { return *this = *this - other; }
+		floatx8& operator*=(const floatx8& other) { return *this = *this * other; }
+		floatx8& operator/=(const floatx8& other) { return *this = *this / other; }
+
+		float GetLane(int lane) const { return lane < 4 ? m_lo.GetLane(lane) : m_hi.GetLane(lane - 4); }
+	};
+
+	FORCEINLINE floatx8 Min(const floatx8& a, const floatx8& b) { return floatx8(Min(a.m_lo, b.m_lo), Min(a.m_hi, b.m_hi)); }
+	FORCEINLINE floatx8 Max(const floatx8& a, const floatx8& b) { return floatx8(Max(a.m_lo, b.m_lo), Max(a.m_hi, b.m_hi)); }
+	FORCEINLINE floatx8 Sqrt(const floatx8& a) { return floatx8(Sqrt(a.m_lo), Sqrt(a.m_hi)); }
+	FORCEINLINE floatx8 Abs(const floatx8& a) { return floatx8(Abs(a.m_lo), Abs(a.m_hi)); }
+	FORCEINLINE floatx8 Select(const maskx8& mask, const floatx8& a, const floatx8& b) { return floatx8(Select(mask.m_lo, a.m_lo, b.m_lo), Select(mask.m_hi, a.m_hi, b.m_hi)); }
+	FORCEINLINE floatx8 MulAdd(const floatx8& a, const floatx8& b, const floatx8& c) { return a * b + c; }
+#endif
+
+	// Widest type the build targets, systems that don't care about the width use these.
+#ifdef LINA_SIMD_AVX
+#define WIDEMATH_NATIVE_WIDTH 8
+	typedef floatx8 floatxN;
+	typedef maskx8 maskxN;
+#else
+#define WIDEMATH_NATIVE_WIDTH 4
+	typedef floatx4 floatxN;
+	typedef maskx4 maskxN;
+#endif
+
+	template<typename F>
+	struct Vector3xN
+	{
+		F m_x, m_y, m_z;
+
+		Vector3xN() {}
+		Vector3xN(const F& x, const F& y, const F& z) : m_x(x), m_y(y), m_z(z) {}
+		explicit Vector3xN(const Vector3& v) : m_x(v.x), m_y(v.y), m_z(v.z) {}
+
+		// Lanes [index, index + Width) of the arrays.
+		static Vector3xN Load(const Vector3SoA& src, size_t index) { return Vector3xN(F::Load(src.m_x + index), F::Load(src.m_y + index), F::Load(src.m_z + index)); }
+		void Store(const Vector3SoA& dst, size_t index) const { m_x.Store(dst.m_x + index); m_y.Store(dst.m_y + index); m_z.Store(dst.m_z + index); }
+
+		Vector3 GetLane(int lane) const { return Vector3(m_x.GetLane(lane), m_y.GetLane(lane), m_z.GetLane(lane)); }
+
+		Vector3xN operator+(const Vector3xN& other) const { return Vector3xN(m_x + other.m_x, m_y + other.m_y, m_z + other.m_z); }
+		Vector3xN operator-(const Vector3xN& other) const { return Vector3xN(m_x - other.m_x, m_y - other.m_y, m_z - other.m_z); }
+		Vector3xN operator*(const Vector3xN& other) const { return Vector3xN(m_x * other.m_x, m_y * other.m_y, m_z * other.m_z); }
+		Vector3xN operator*(const F& scalar) const { return Vector3xN(m_x * scalar, m_y * scalar, m_z * scalar); }
+		Vector3xN operator/(const F& scalar) const { return Vector3xN(m_x / scalar, m_y / scalar, m_z / scalar); }
+		Vector3xN operator-() const { return Vector3xN(-m_x, -m_y, -m_z); }
+
+		Vector3xN& operator+=(const Vector3xN& other) { return *this = *this + other; }
+		Vector3xN& operator-=(const Vector3xN& other) { return *this = *this - other; }
+		Vector3xN& operator*=(const F& scalar) { return *this = *this * scalar; }
+
+		F Dot(const Vector3xN& other) const { return MulAdd(m_x, other.m_x, MulAdd(m_y, other.m_y, m_z * other.m_z)); }
+		Vector3xN Cross(const Vector3xN& other) const { return Vector3xN(m_y * other.m_z - m_z * other.m_y, m_z * other.m_x - m_x * other.m_z, m_x * other.m_y - m_y * other.m_x); }
+		F LengthSquared() const { return Dot(*this); }
+		F Length() const { return Sqrt(LengthSquared()); }
+
+		// Zero length lanes stay zero.
+		FORCEINLINE Vector3xN Normalized() const
+		{
+			const F lengthSquared = LengthSquared();
+			const F scale = Select(lengthSquared > F(0.0f), F(1.0f) / Sqrt(lengthSquared), F(0.0f));
+			return *this * scale;
+		}
+	};
+
+	template<typename F>
+	FORCEINLINE Vector3xN<F> Select(const typename F::Mask& mask, const Vector3xN<F>& a, const Vector3xN<F>& b)
+	{
+		return Vector3xN<F>(Select(mask, a.m_x, b.m_x), Select(mask, a.m_y, b.m_y), Select(mask, a.m_z, b.m_z));
+	}
+
+	// a * b + c.
+	template<typename F>
+	FORCEINLINE Vector3xN<F> MulAdd(const Vector3xN<F>& a, const F& b, const Vector3xN<F>& c)
+	{
+		return Vector3xN<F>(MulAdd(a.m_x, b, c.m_x), MulAdd(a.m_y, b, c.m_y), MulAdd(a.m_z, b, c.m_z));
+	}
+
+	template<typename F>
+	struct QuaternionxN
+	{
+		F m_x, m_y, m_z, m_w;
+
+		QuaternionxN() : m_w(1.0f) {}
+		QuaternionxN(const F& x, const F& y, const F& z, const F& w) : m_x(x), m_y(y), m_z(z), m_w(w) {}
+		explicit QuaternionxN(const Quaternion& q) : m_x(q.x), m_y(q.y), m_z(q.z), m_w(q.w) {}
+
+		static QuaternionxN Load(const QuaternionSoA& src, size_t index) { return QuaternionxN(F::Load(src.m_x + index), F::Load(src.m_y + index), F::Load(src.m_z + index), F::Load(src.m_w + index)); }
+		void Store(const QuaternionSoA& dst, size_t index) const { m_x.Store(dst.m_x + index); m_y.Store(dst.m_y + index); m_z.Store(dst.m_z + index); m_w.Store(dst.m_w + index); }
+
+		Quaternion GetLane(int lane) const { return Quaternion(m_x.GetLane(lane), m_y.GetLane(lane), m_z.GetLane(lane), m_w.GetLane(lane)); }
+
+		// Same order as glm, this * other applies other first.
+		FORCEINLINE QuaternionxN operator*(const QuaternionxN& o) const
+		{
+			return QuaternionxN(
+				m_w * o.m_x + m_x * o.m_w + m_y * o.m_z - m_z * o.m_y,
+				m_w * o.m_y + m_y * o.m_w + m_z * o.m_x - m_x * o.m_z,
+				m_w * o.m_z + m_z * o.m_w + m_x * o.m_y - m_y * o.m_x,
+				m_w * o.m_w - m_x * o.m_x - m_y * o.m_y - m_z * o.m_z);
+		}
+
+		F Dot(const QuaternionxN& other) const { return MulAdd(m_x, other.m_x, MulAdd(m_y, other.m_y, MulAdd(m_z, other.m_z, m_w * other.m_w))); }
+
+		// Zero length lanes become identity like glm::normalize.
+		FORCEINLINE QuaternionxN Normalized() const
+		{
+			const F lengthSquared = Dot(*this);
+			const typename F::Mask valid = lengthSquared > F(0.0f);
+			const F scale = Select(valid, F(1.0f) / Sqrt(lengthSquared), F(0.0f));
+			return QuaternionxN(m_x * scale, m_y * scale, m_z * scale, Select(valid, m_w * scale, F(1.0f)));
+		}
+
+		// v + 2w(u x v) + 2u x (u x v) for unit quaternions.
+		FORCEINLINE Vector3xN<F> Rotate(const Vector3xN<F>& v) const
+		{
+			const Vector3xN<F> u(m_x, m_y, m_z);
+			const Vector3xN<F> t = u.Cross(v) * F(2.0f);
+			return v + t * m_w + u.Cross(t);
+		}
+
+		// Advances the rotation by a world space angular velocity in radians per second, first order & renormalized.
+		FORCEINLINE QuaternionxN Integrate(const Vector3xN<F>& angularVelocity, const F& delta) const
+		{
+			const F halfDelta = delta * F(0.5f);
+			const QuaternionxN spin = QuaternionxN(angularVelocity.m_x, angularVelocity.m_y, angularVelocity.m_z, F(0.0f)) * *this;
+			return QuaternionxN(MulAdd(spin.m_x, halfDelta, m_x), MulAdd(spin.m_y, halfDelta, m_y), MulAdd(spin.m_z, halfDelta, m_z), MulAdd(spin.m_w, halfDelta, m_w)).Normalized();
+		}
+	};
+
+	template<typename F>
+	FORCEINLINE QuaternionxN<F> Select(const typename F::Mask& mask, const QuaternionxN<F>& a, const QuaternionxN<F>& b)
+	{
+		return QuaternionxN<F>(Select(mask, a.m_x, b.m_x), Select(mask, a.m_y, b.m_y), Select(mask, a.m_z, b.m_z), Select(mask, a.m_w, b.m_w));
+	}
+
+	typedef Vector3xN<floatx4> Vector3x4;
+	typedef Vector3xN<floatx8> Vector3x8;
+	typedef Vector3xN<floatxN> Vector3xNative;
+	typedef QuaternionxN<floatx4> Quaternionx4;
+	typedef QuaternionxN<floatx8> Quaternionx8;
+	typedef QuaternionxN<floatxN> QuaternionxNative;
+}
+
+#endif
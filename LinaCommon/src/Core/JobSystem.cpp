@@ -0,0 +1,142 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/JobSystem.hpp"
+
+namespace LinaEngine
+{
+	JobSystem& JobSystem::Get()
+	{
+		static JobSystem s_jobSystem(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1);
+		return s_jobSystem;
+	}
+
+	JobSystem::JobSystem(uint32 workerCount)
+	{
+		for (uint32 i = 0; i < workerCount; i++)
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopped = true;
+		}
+
+		m_condition.notify_all();
+
+		for (std::thread& worker : m_workers)
+			worker.join();
+	}
+
+	std::future<void> JobSystem::Submit(std::function<void()> job)
+	{
+		std::packaged_task<void()> task(std::move(job));
+		std::future<void> future = task.get_future();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(std::move(task));
+		}
+
+		m_condition.notify_one();
+		return future;
+	}
+
+	void JobSystem::ParallelFor(uint32 count, uint32 grainSize, const std::function<void(uint32 begin, uint32 end)>& func)
+	{
+		if (count == 0) return;
+
+		// Don't create more ranges than there are threads to run them.
+		const uint32 threadCount = GetWorkerCount() + 1;
+		const uint32 minGrain = grainSize == 0 ? 1 : grainSize;
+		const uint32 evenSize = (count + threadCount - 1) / threadCount;
+		const uint32 rangeSize = evenSize > minGrain ? evenSize : minGrain;
+
+		std::vector<std::future<void>> futures;
+		for (uint32 begin = rangeSize; begin < count; begin += rangeSize)
+		{
+			const uint32 end = begin + rangeSize < count ? begin + rangeSize : count;
+			futures.push_back(Submit([&func, begin, end]() { func(begin, end); }));
+		}
+
+		// Calling thread processes the first range.
+		func(0, rangeSize < count ? rangeSize : count);
+
+		for (std::future<void>& future : futures)
+			Wait(future);
+	}
+
+	void JobSystem::Wait(std::future<void>& future)
+	{
+		while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			if (!TryExecutePending())
+				std::this_thread::yield();
+		}
+
+		future.get();
+	}
+
+	bool JobSystem::TryExecutePending()
+	{
+		std::packaged_task<void()> task;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_jobs.empty()) return false;
+			task = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		task();
+		return true;
+	}
+
+	void JobSystem::WorkerLoop()
+	{
+		while (true)
+		{
+			std::packaged_task<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this] { return m_stopped || !m_jobs.empty(); });
+
+				if (m_stopped && m_jobs.empty())
+					return;
+
+				task = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+
+			task();
+		}
+	}
+}
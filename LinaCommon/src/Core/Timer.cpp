@@ -56,4 +56,25 @@ namespace LinaEngine
 
 		s_activeTimers.clear();
 	}
+
+	double Timer::TimeBest(uint32 iterations, const std::function<void()>& func)
+	{
+		return TimeBest(iterations, []() {}, func);
+	}
+
+	double Timer::TimeBest(uint32 iterations, const std::function<void()>& setup, const std::function<void()>& func)
+	{
+		double best = -1.0;
+
+		for (uint32 i = 0; i < iterations; i++)
+		{
+			setup();
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			func();
+			const double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			best = best < 0.0 || duration < best ? duration : best;
+		}
+
+		return best;
+	}
 }
\ No newline at end of file
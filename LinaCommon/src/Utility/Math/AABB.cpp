@@ -0,0 +1,119 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utility/Math/AABB.hpp"
+
+namespace LinaEngine
+{
+	AABB AABB::FromPoints(const float* positions, size_t count, size_t stride)
+	{
+		AABB box;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const float* p = positions + i * stride;
+			box.Expand(Vector3(p[0], p[1], p[2]));
+		}
+
+		return box;
+	}
+
+	AABB AABB::Transform(const Matrix& matrix) const
+	{
+		// Transform the center & project the extents onto the absolute rotation axes.
+		Vector3 center = GetCenter();
+		Vector3 extents = GetHalfExtents();
+		Vector3 worldCenter = Vector3(matrix * glm::vec4(center, 1.0f));
+		Vector3 worldExtents;
+
+		for (int i = 0; i < 3; i++)
+			worldExtents[i] = glm::abs(matrix[0][i]) * extents.x + glm::abs(matrix[1][i]) * extents.y + glm::abs(matrix[2][i]) * extents.z;
+
+		return AABB(worldCenter - worldExtents, worldCenter + worldExtents);
+	}
+
+	void AABB::Expand(const Vector3& point)
+	{
+		// Vector3::Min/Max compare lengths, bounds need per component results.
+		m_boundsMin = glm::min(glm::vec3(m_boundsMin), glm::vec3(point));
+		m_boundsMax = glm::max(glm::vec3(m_boundsMax), glm::vec3(point));
+	}
+
+	void AABB::Expand(const AABB& other)
+	{
+		m_boundsMin = glm::min(glm::vec3(m_boundsMin), glm::vec3(other.m_boundsMin));
+		m_boundsMax = glm::max(glm::vec3(m_boundsMax), glm::vec3(other.m_boundsMax));
+	}
+
+	bool AABB::Intersects(const AABB& other) const
+	{
+		return m_boundsMin.x <= other.m_boundsMax.x && m_boundsMax.x >= other.m_boundsMin.x &&
+			m_boundsMin.y <= other.m_boundsMax.y && m_boundsMax.y >= other.m_boundsMin.y &&
+			m_boundsMin.z <= other.m_boundsMax.z && m_boundsMax.z >= other.m_boundsMin.z;
+	}
+
+	bool AABB::Contains(const Vector3& point) const
+	{
+		return point.x >= m_boundsMin.x && point.x <= m_boundsMax.x &&
+			point.y >= m_boundsMin.y && point.y <= m_boundsMax.y &&
+			point.z >= m_boundsMin.z && point.z <= m_boundsMax.z;
+	}
+
+	float AABB::GetSurfaceArea() const
+	{
+		if (!IsValid()) return 0.0f;
+		glm::vec3 size = glm::vec3(m_boundsMax) - glm::vec3(m_boundsMin);
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	BoundingSphere BoundingSphere::FromPoints(const AABB& box, const float* positions, size_t count, size_t stride)
+	{
+		// Center on the box, radius from the farthest point which is tighter than the half diagonal.
+		BoundingSphere sphere;
+		sphere.m_center = box.GetCenter();
+		float radiusSqr = 0.0f;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const float* p = positions + i * stride;
+			radiusSqr = glm::max(radiusSqr, glm::length2(glm::vec3(p[0], p[1], p[2]) - glm::vec3(sphere.m_center)));
+		}
+
+		sphere.m_radius = glm::sqrt(radiusSqr);
+		return sphere;
+	}
+
+	BoundingSphere BoundingSphere::Transform(const Matrix& matrix) const
+	{
+		float scaleX = glm::length2(glm::vec3(matrix[0]));
+		float scaleY = glm::length2(glm::vec3(matrix[1]));
+		float scaleZ = glm::length2(glm::vec3(matrix[2]));
+		float maxScale = glm::sqrt(glm::max(scaleX, glm::max(scaleY, scaleZ)));
+		return BoundingSphere(Vector3(matrix * glm::vec4(m_center, 1.0f)), m_radius * maxScale);
+	}
+}
@@ -0,0 +1,757 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utility/Math/BVH.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Timer.hpp"
+#include "PackageManager/PAMSIMD.hpp"
+#include <algorithm>
+
+namespace LinaEngine
+{
+#define BVH_LEAF_SIZE 4
+#define BVH_BIN_COUNT 12
+#define BVH_SYNC_REBUILD_LIMIT 2048
+#define BVH_REBUILD_COST_RATIO 1.4f
+#define BVH_STACK_RESERVE 64
+
+	struct RayTraversalData
+	{
+		float m_origin[3];
+		float m_invDirection[3];
+	};
+
+	// Returns the mask of child slots hit by the ray within [0, maxDistance], entry distances are written to near.
+	// The slab test swaps min & max per axis, so the inverted bounds of empty slots are masked out explicitly.
+	static int IntersectRayNode(const float* minX, const float* minY, const float* minZ, const float* maxX, const float* maxY, const float* maxZ, const RayTraversalData& ray, float maxDistance, float* near)
+	{
+#ifdef LINA_SIMD_SSE
+		const __m128 ox = _mm_set1_ps(ray.m_origin[0]), oy = _mm_set1_ps(ray.m_origin[1]), oz = _mm_set1_ps(ray.m_origin[2]);
+		const __m128 ix = _mm_set1_ps(ray.m_invDirection[0]), iy = _mm_set1_ps(ray.m_invDirection[1]), iz = _mm_set1_ps(ray.m_invDirection[2]);
+		const __m128 tx0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minX), ox), ix);
+		const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxX), ox), ix);
+		const __m128 ty0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minY), oy), iy);
+		const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxY), oy), iy);
+		const __m128 tz0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minZ), oz), iz);
+		const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxZ), oz), iz);
+		const __m128 tMin = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)), _mm_max_ps(_mm_min_ps(tz0, tz1), _mm_setzero_ps()));
+		const __m128 tMax = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_max_ps(ty0, ty1)), _mm_min_ps(_mm_max_ps(tz0, tz1), _mm_set1_ps(maxDistance)));
+		const __m128 occupied = _mm_cmple_ps(_mm_loadu_ps(minX), _mm_loadu_ps(maxX));
+		_mm_storeu_ps(near, tMin);
+		return _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(tMin, tMax), occupied));
+#else
+		int mask = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			const float tx0 = (minX[i] - ray.m_origin[0]) * ray.m_invDirection[0], tx1 = (maxX[i] - ray.m_origin[0]) * ray.m_invDirection[0];
+			const float ty0 = (minY[i] - ray.m_origin[1]) * ray.m_invDirection[1], ty1 = (maxY[i] - ray.m_origin[1]) * ray.m_invDirection[1];
+			const float tz0 = (minZ[i] - ray.m_origin[2]) * ray.m_invDirection[2], tz1 = (maxZ[i] - ray.m_origin[2]) * ray.m_invDirection[2];
+			const float tMin = glm::max(glm::max(glm::min(tx0, tx1), glm::min(ty0, ty1)), glm::max(glm::min(tz0, tz1), 0.0f));
+			const float tMax = glm::min(glm::min(glm::max(tx0, tx1), glm::max(ty0, ty1)), glm::min(glm::max(tz0, tz1), maxDistance));
+			near[i] = tMin;
+			mask |= tMin <= tMax && minX[i] <= maxX[i] ? (1 << i) : 0;
+		}
+		return mask;
+#endif
+	}
+
+	// Returns the mask of child slots overlapping the box.
+	static int IntersectAABBNode(const float* minX, const float* minY, const float* minZ, const float* maxX, const float* maxY, const float* maxZ, const AABB& box)
+	{
+#ifdef LINA_SIMD_SSE
+		__m128 overlap = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minX), _mm_set1_ps(box.m_boundsMax.x)), _mm_cmpge_ps(_mm_loadu_ps(maxX), _mm_set1_ps(box.m_boundsMin.x)));
+		overlap = _mm_and_ps(overlap, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minY), _mm_set1_ps(box.m_boundsMax.y)), _mm_cmpge_ps(_mm_loadu_ps(maxY), _mm_set1_ps(box.m_boundsMin.y))));
+		overlap = _mm_and_ps(overlap, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(minZ), _mm_set1_ps(box.m_boundsMax.z)), _mm_cmpge_ps(_mm_loadu_ps(maxZ), _mm_set1_ps(box.m_boundsMin.z))));
+		return _mm_movemask_ps(overlap);
+#else
+		int mask = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			if (minX[i] <= box.m_boundsMax.x && maxX[i] >= box.m_boundsMin.x && minY[i] <= box.m_boundsMax.y && maxY[i] >= box.m_boundsMin.y && minZ[i] <= box.m_boundsMax.z && maxZ[i] >= box.m_boundsMin.z)
+				mask |= 1 << i;
+		}
+		return mask;
+#endif
+	}
+
+	// Returns the mask of child slots that are not fully outside one of the frustum planes.
+	static int IntersectFrustumNode(const float* minX, const float* minY, const float* minZ, const float* maxX, const float* maxY, const float* maxZ, const Frustum& frustum)
+	{
+#ifdef LINA_SIMD_SSE
+		__m128 inside = _mm_setzero_ps();
+		for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+		{
+			// The plane normal signs are shared by all lanes, so the positive vertex is selected per plane.
+			const Vector4& plane = frustum.GetPlane((FrustumPlane)p);
+			const __m128 x = _mm_loadu_ps(plane.x >= 0.0f ? maxX : minX);
+			const __m128 y = _mm_loadu_ps(plane.y >= 0.0f ? maxY : minY);
+			const __m128 z = _mm_loadu_ps(plane.z >= 0.0f ? maxZ : minZ);
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))), _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+			const __m128 inFront = _mm_cmpge_ps(distance, _mm_setzero_ps());
+			inside = p == 0 ? inFront : _mm_and_ps(inside, inFront);
+		}
+		return _mm_movemask_ps(inside);
+#else
+		int mask = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			if (frustum.IntersectsAABB(AABB(Vector3(minX[i], minY[i], minZ[i]), Vector3(maxX[i], maxY[i], maxZ[i]))))
+				mask |= 1 << i;
+		}
+		return mask;
+#endif
+	}
+
+	BVH::~BVH()
+	{
+		// Background build references its own data, but wait so that no job outlives the tree.
+		if (m_buildFuture.valid())
+			JobSystem::Get().Wait(m_buildFuture);
+	}
+
+	uint32 BVH::CreateProxy(const AABB& bounds, uint32 userData)
+	{
+		uint32 proxy = 0;
+
+		if (!m_freeProxies.empty())
+		{
+			proxy = m_freeProxies.back();
+			m_freeProxies.pop_back();
+		}
+		else
+		{
+			proxy = (uint32)m_proxies.size();
+			m_proxies.emplace_back();
+		}
+
+		// New proxies are tested brute force until the next rebuild places them into the tree.
+		Proxy& p = m_proxies[proxy];
+		p.m_bounds = bounds;
+		p.m_userData = userData;
+		p.m_leafNode = -1;
+		p.m_alive = true;
+		m_pendingProxies.push_back(proxy);
+		m_aliveCount++;
+		return proxy;
+	}
+
+	void BVH::DestroyProxy(uint32 proxy)
+	{
+		Proxy& p = m_proxies[proxy];
+		if (!p.m_alive) return;
+
+		p.m_alive = false;
+		m_aliveCount--;
+
+		std::vector<uint32>::iterator it = std::find(m_pendingProxies.begin(), m_pendingProxies.end(), proxy);
+		if (it != m_pendingProxies.end())
+		{
+			*it = m_pendingProxies.back();
+			m_pendingProxies.pop_back();
+		}
+
+		// Proxies referenced by the tree or a build in progress can only be reused after the next rebuild.
+		if (p.m_leafNode >= 0 || m_buildFuture.valid())
+		{
+			if (p.m_leafNode >= 0)
+				MarkDirty(p.m_leafNode);
+			m_releasedProxies.push_back(proxy);
+		}
+		else
+			m_freeProxies.push_back(proxy);
+	}
+
+	void BVH::MoveProxy(uint32 proxy, const AABB& bounds)
+	{
+		Proxy& p = m_proxies[proxy];
+		p.m_bounds = bounds;
+
+		if (p.m_leafNode >= 0)
+			MarkDirty(p.m_leafNode);
+	}
+
+	void BVH::Update()
+	{
+		// Swap in the finished background build.
+		if (m_buildFuture.valid() && m_buildFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			m_buildFuture.get();
+			ApplyBuild(*m_buildData);
+			m_buildData.reset();
+		}
+
+		// Refit dirty nodes bottom-up, children always have higher indices than their parents.
+		if (m_dirtyCount > 0)
+		{
+			LINA_TIMER_START("[BVH] Refit");
+			for (int32 i = (int32)m_nodes.size() - 1; i >= 0; i--)
+			{
+				if (!m_dirtyNodes[i]) continue;
+				RefitNode(i);
+				m_dirtyNodes[i] = 0;
+			}
+
+			m_dirtyCount = 0;
+			m_currentCost = CalculateCost();
+			LINA_TIMER_STOP("[BVH] Refit");
+		}
+
+		if (m_buildFuture.valid() || !ShouldRebuild())
+			return;
+
+		// Small trees are cheaper to rebuild in place than to hand over to a worker.
+		if (m_aliveCount <= BVH_SYNC_REBUILD_LIMIT)
+			Rebuild();
+		else
+		{
+			std::shared_ptr<BuildData> data = CreateBuildData();
+			m_buildData = data;
+			m_buildFuture = JobSystem::Get().Submit([data]() { Build(*data); });
+		}
+	}
+
+	void BVH::Rebuild()
+	{
+		if (m_buildFuture.valid())
+		{
+			JobSystem::Get().Wait(m_buildFuture);
+			ApplyBuild(*m_buildData);
+			m_buildData.reset();
+		}
+
+		LINA_TIMER_START("[BVH] Build");
+		std::shared_ptr<BuildData> data = CreateBuildData();
+		Build(*data);
+		ApplyBuild(*data);
+		LINA_TIMER_STOP("[BVH] Build");
+	}
+
+	bool BVH::ShouldRebuild() const
+	{
+		if (m_aliveCount == 0)
+			return !m_nodes.empty();
+
+		const size_t rebuildThreshold = 32 + m_aliveCount / 10;
+		if (!m_pendingProxies.empty() && (m_aliveCount <= BVH_SYNC_REBUILD_LIMIT || m_pendingProxies.size() > rebuildThreshold))
+			return true;
+
+		if (m_releasedProxies.size() > rebuildThreshold)
+			return true;
+
+		return m_builtCost > 0.0f && m_currentCost > m_builtCost * BVH_REBUILD_COST_RATIO;
+	}
+
+	std::shared_ptr<BVH::BuildData> BVH::CreateBuildData()
+	{
+		// Snapshot the alive proxies so that the build can run while the tree keeps being used.
+		std::shared_ptr<BuildData> data = std::make_shared<BuildData>();
+		data->m_bounds.reserve(m_aliveCount);
+		data->m_proxies.reserve(m_aliveCount);
+
+		for (uint32 i = 0; i < (uint32)m_proxies.size(); i++)
+		{
+			if (!m_proxies[i].m_alive) continue;
+			data->m_bounds.push_back(m_proxies[i].m_bounds);
+			data->m_proxies.push_back(i);
+		}
+
+		data->m_releasedProxies.swap(m_releasedProxies);
+		return data;
+	}
+
+	void BVH::Build(BuildData& data)
+	{
+		data.m_nodes.clear();
+		data.m_primitives.clear();
+
+		const uint32 count = (uint32)data.m_bounds.size();
+		if (count == 0) return;
+
+		std::vector<Vector3> centroids(count);
+		std::vector<uint32> references(count);
+		for (uint32 i = 0; i < count; i++)
+		{
+			centroids[i] = data.m_bounds[i].GetCenter();
+			references[i] = i;
+		}
+
+		data.m_nodes.reserve(count / 2 + 1);
+		BuildNode(data, references, centroids, 0, count, -1);
+
+		// Leaves point into the primitive list, which follows the partitioned reference order.
+		data.m_primitives.resize(count);
+		for (uint32 i = 0; i < count; i++)
+			data.m_primitives[i] = data.m_proxies[references[i]];
+	}
+
+	int32 BVH::BuildNode(BuildData& data, std::vector<uint32>& references, const std::vector<Vector3>& centroids, uint32 begin, uint32 end, int32 parent)
+	{
+		const int32 index = (int32)data.m_nodes.size();
+		data.m_nodes.emplace_back();
+		data.m_nodes[index].m_parent = parent;
+
+		// Keep splitting the largest group until there are four or all of them fit into leaves.
+		uint32 groupBegin[4] = { begin, 0, 0, 0 };
+		uint32 groupEnd[4] = { end, 0, 0, 0 };
+		int groupCount = 1;
+
+		while (groupCount < 4)
+		{
+			int largest = -1;
+			uint32 largestSize = BVH_LEAF_SIZE;
+			for (int i = 0; i < groupCount; i++)
+			{
+				if (groupEnd[i] - groupBegin[i] > largestSize)
+				{
+					largest = i;
+					largestSize = groupEnd[i] - groupBegin[i];
+				}
+			}
+
+			if (largest == -1) break;
+
+			const uint32 mid = SplitSAH(data, references, centroids, groupBegin[largest], groupEnd[largest]);
+			groupBegin[groupCount] = mid;
+			groupEnd[groupCount] = groupEnd[largest];
+			groupEnd[largest] = mid;
+			groupCount++;
+		}
+
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (slot >= groupCount)
+			{
+				Node& node = data.m_nodes[index];
+				node.m_children[slot] = 0;
+				node.m_counts[slot] = 0;
+				SetSlotBounds(node, slot, AABB());
+				continue;
+			}
+
+			AABB bounds;
+			for (uint32 i = groupBegin[slot]; i < groupEnd[slot]; i++)
+				bounds.Expand(data.m_bounds[references[i]]);
+
+			SetSlotBounds(data.m_nodes[index], slot, bounds);
+
+			const uint32 size = groupEnd[slot] - groupBegin[slot];
+			if (size <= BVH_LEAF_SIZE)
+			{
+				data.m_nodes[index].m_children[slot] = -(int32)(groupBegin[slot] + 1);
+				data.m_nodes[index].m_counts[slot] = size;
+			}
+			else
+			{
+				// Recursion grows the node list, don't hold references across it.
+				const int32 child = BuildNode(data, references, centroids, groupBegin[slot], groupEnd[slot], index);
+				data.m_nodes[index].m_children[slot] = child;
+				data.m_nodes[index].m_counts[slot] = 0;
+			}
+		}
+
+		return index;
+	}
+
+	uint32 BVH::SplitSAH(const BuildData& data, std::vector<uint32>& references, const std::vector<Vector3>& centroids, uint32 begin, uint32 end)
+	{
+		AABB centroidBounds;
+		for (uint32 i = begin; i < end; i++)
+			centroidBounds.Expand(centroids[references[i]]);
+
+		struct Bin
+		{
+			AABB m_bounds;
+			uint32 m_count = 0;
+		};
+
+		int bestAxis = -1;
+		int bestBin = 0;
+		float bestCost = FLT_MAX;
+		int largestAxis = 0;
+		float largestExtent = 0.0f;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const float extent = centroidBounds.m_boundsMax[axis] - centroidBounds.m_boundsMin[axis];
+			if (extent > largestExtent)
+			{
+				largestExtent = extent;
+				largestAxis = axis;
+			}
+
+			if (extent <= 1e-6f) continue;
+
+			Bin bins[BVH_BIN_COUNT];
+			const float scale = (float)BVH_BIN_COUNT / extent;
+			for (uint32 i = begin; i < end; i++)
+			{
+				const int bin = glm::min(BVH_BIN_COUNT - 1, (int)((centroids[references[i]][axis] - centroidBounds.m_boundsMin[axis]) * scale));
+				bins[bin].m_count++;
+				bins[bin].m_bounds.Expand(data.m_bounds[references[i]]);
+			}
+
+			// Sweep from both sides to get the area & count on each side of every bin plane.
+			float rightCosts[BVH_BIN_COUNT];
+			AABB right;
+			uint32 rightCount = 0;
+			for (int i = BVH_BIN_COUNT - 1; i > 0; i--)
+			{
+				right.Expand(bins[i].m_bounds);
+				rightCount += bins[i].m_count;
+				rightCosts[i - 1] = right.GetSurfaceArea() * rightCount;
+			}
+
+			AABB left;
+			uint32 leftCount = 0;
+			for (int i = 0; i < BVH_BIN_COUNT - 1; i++)
+			{
+				left.Expand(bins[i].m_bounds);
+				leftCount += bins[i].m_count;
+				const float cost = left.GetSurfaceArea() * leftCount + rightCosts[i];
+				if (leftCount > 0 && leftCount < end - begin && cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = i;
+				}
+			}
+		}
+
+		uint32 mid = begin;
+
+		if (bestAxis != -1)
+		{
+			const float scale = (float)BVH_BIN_COUNT / (centroidBounds.m_boundsMax[bestAxis] - centroidBounds.m_boundsMin[bestAxis]);
+			const float axisMin = centroidBounds.m_boundsMin[bestAxis];
+			std::vector<uint32>::iterator it = std::partition(references.begin() + begin, references.begin() + end, [&](uint32 reference)
+			{
+				return glm::min(BVH_BIN_COUNT - 1, (int)((centroids[reference][bestAxis] - axisMin) * scale)) <= bestBin;
+			});
+			mid = (uint32)(it - references.begin());
+		}
+
+		// Fall back to a median split when the centroids can't be separated.
+		if (mid == begin || mid == end)
+		{
+			mid = begin + (end - begin) / 2;
+			std::nth_element(references.begin() + begin, references.begin() + mid, references.begin() + end, [&](uint32 a, uint32 b)
+			{
+				return centroids[a][largestAxis] < centroids[b][largestAxis];
+			});
+		}
+
+		return mid;
+	}
+
+	void BVH::ApplyBuild(BuildData& data)
+	{
+		for (Proxy& proxy : m_proxies)
+			proxy.m_leafNode = -1;
+
+		m_nodes.swap(data.m_nodes);
+		m_primitives.swap(data.m_primitives);
+		m_dirtyNodes.assign(m_nodes.size(), 0);
+		m_dirtyCount = 0;
+
+		for (int32 i = 0; i < (int32)m_nodes.size(); i++)
+		{
+			const Node& node = m_nodes[i];
+			for (int slot = 0; slot < 4; slot++)
+			{
+				if (node.m_children[slot] >= 0) continue;
+				const uint32 start = (uint32)(-(node.m_children[slot] + 1));
+				for (uint32 j = start; j < start + node.m_counts[slot]; j++)
+					m_proxies[m_primitives[j]].m_leafNode = i;
+			}
+		}
+
+		// Proxies released before the snapshot aren't referenced by the new tree anymore.
+		m_freeProxies.insert(m_freeProxies.end(), data.m_releasedProxies.begin(), data.m_releasedProxies.end());
+
+		m_pendingProxies.clear();
+		for (uint32 i = 0; i < (uint32)m_proxies.size(); i++)
+		{
+			if (m_proxies[i].m_alive && m_proxies[i].m_leafNode < 0)
+				m_pendingProxies.push_back(i);
+		}
+
+		// Proxies might have moved during a background build, refit against the latest bounds.
+		for (int32 i = (int32)m_nodes.size() - 1; i >= 0; i--)
+			RefitNode(i);
+
+		m_builtCost = m_currentCost = CalculateCost();
+	}
+
+	void BVH::MarkDirty(int32 node)
+	{
+		while (node >= 0 && !m_dirtyNodes[node])
+		{
+			m_dirtyNodes[node] = 1;
+			m_dirtyCount++;
+			node = m_nodes[node].m_parent;
+		}
+	}
+
+	void BVH::RefitNode(int32 index)
+	{
+		Node& node = m_nodes[index];
+
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (IsEmptySlot(node, slot)) continue;
+
+			AABB bounds;
+			const int32 child = node.m_children[slot];
+
+			if (child < 0)
+			{
+				const uint32 start = (uint32)(-(child + 1));
+				for (uint32 i = start; i < start + node.m_counts[slot]; i++)
+				{
+					const Proxy& proxy = m_proxies[m_primitives[i]];
+					if (proxy.m_alive)
+						bounds.Expand(proxy.m_bounds);
+				}
+			}
+			else
+			{
+				const Node& childNode = m_nodes[child];
+				for (int childSlot = 0; childSlot < 4; childSlot++)
+				{
+					if (!IsEmptySlot(childNode, childSlot))
+						bounds.Expand(GetSlotBounds(childNode, childSlot));
+				}
+			}
+
+			SetSlotBounds(node, slot, bounds);
+		}
+	}
+
+	float BVH::CalculateCost() const
+	{
+		if (m_nodes.empty()) return 0.0f;
+
+		// Total child area relative to the root, the usual SAH quality measure without the leaf terms.
+		AABB root;
+		float area = 0.0f;
+		for (const Node& node : m_nodes)
+		{
+			for (int slot = 0; slot < 4; slot++)
+			{
+				if (IsEmptySlot(node, slot)) continue;
+				const AABB bounds = GetSlotBounds(node, slot);
+				area += bounds.GetSurfaceArea();
+				if (&node == &m_nodes[0])
+					root.Expand(bounds);
+			}
+		}
+
+		const float rootArea = root.GetSurfaceArea();
+		return rootArea > 0.0f ? area / rootArea : 0.0f;
+	}
+
+	void BVH::SetSlotBounds(Node& node, int slot, const AABB& bounds)
+	{
+		// Invalid bounds are stored inverted so that no overlap test passes, ray tests check min > max themselves.
+		const bool valid = bounds.IsValid();
+		node.m_minX[slot] = valid ? bounds.m_boundsMin.x : FLT_MAX;
+		node.m_minY[slot] = valid ? bounds.m_boundsMin.y : FLT_MAX;
+		node.m_minZ[slot] = valid ? bounds.m_boundsMin.z : FLT_MAX;
+		node.m_maxX[slot] = valid ? bounds.m_boundsMax.x : -FLT_MAX;
+		node.m_maxY[slot] = valid ? bounds.m_boundsMax.y : -FLT_MAX;
+		node.m_maxZ[slot] = valid ? bounds.m_boundsMax.z : -FLT_MAX;
+	}
+
+	AABB BVH::GetSlotBounds(const Node& node, int slot)
+	{
+		return AABB(Vector3(node.m_minX[slot], node.m_minY[slot], node.m_minZ[slot]), Vector3(node.m_maxX[slot], node.m_maxY[slot], node.m_maxZ[slot]));
+	}
+
+	bool BVH::RayCast(const Ray& ray, float maxDistance, RayHit& hit, const RayTestCallback& callback) const
+	{
+		hit = RayHit();
+		float closest = maxDistance;
+
+		auto testProxy = [&](uint32 index)
+		{
+			const Proxy& proxy = m_proxies[index];
+			float distance = 0.0f;
+			if (!proxy.m_alive || !ray.IntersectsAABB(proxy.m_bounds, closest, distance)) return;
+			if (callback && (!callback(proxy.m_userData, ray, distance) || distance > closest)) return;
+
+			closest = distance;
+			hit.m_userData = proxy.m_userData;
+			hit.m_distance = distance;
+		};
+
+		for (uint32 proxy : m_pendingProxies)
+			testProxy(proxy);
+
+		if (!m_nodes.empty())
+		{
+			// Zero direction components are replaced by a tiny value to keep the slab test free of NaNs.
+			RayTraversalData rayData;
+			for (int i = 0; i < 3; i++)
+			{
+				const float direction = ray.m_direction[i];
+				rayData.m_origin[i] = ray.m_origin[i];
+				rayData.m_invDirection[i] = 1.0f / (glm::abs(direction) > 1e-8f ? direction : (direction < 0.0f ? -1e-8f : 1e-8f));
+			}
+
+			std::vector<std::pair<int32, float>> stack;
+			stack.reserve(BVH_STACK_RESERVE);
+			stack.push_back(std::make_pair(0, 0.0f));
+
+			while (!stack.empty())
+			{
+				const std::pair<int32, float> entry = stack.back();
+				stack.pop_back();
+				if (entry.second > closest) continue;
+
+				const Node& node = m_nodes[entry.first];
+				float near[4];
+				int mask = IntersectRayNode(node.m_minX, node.m_minY, node.m_minZ, node.m_maxX, node.m_maxY, node.m_maxZ, rayData, closest, near);
+
+				// Visit the hit slots near to far, leaves are tested right away & inner nodes are pushed far first.
+				int order[4];
+				int hitCount = 0;
+				for (int slot = 0; slot < 4; slot++)
+				{
+					if ((mask & (1 << slot)) && !IsEmptySlot(node, slot))
+						order[hitCount++] = slot;
+				}
+
+				std::sort(order, order + hitCount, [&near](int a, int b) { return near[a] < near[b]; });
+
+				const size_t pushStart = stack.size();
+				for (int i = 0; i < hitCount; i++)
+				{
+					const int slot = order[i];
+					const int32 child = node.m_children[slot];
+
+					if (child < 0)
+					{
+						const uint32 start = (uint32)(-(child + 1));
+						for (uint32 j = start; j < start + node.m_counts[slot]; j++)
+							testProxy(m_primitives[j]);
+					}
+					else
+						stack.push_back(std::make_pair(child, near[slot]));
+				}
+
+				std::reverse(stack.begin() + pushStart, stack.end());
+			}
+		}
+
+		return hit.m_userData != 0xFFFFFFFF;
+	}
+
+	void BVH::QueryAABB(const AABB& box, std::vector<uint32>& results) const
+	{
+		for (uint32 proxy : m_pendingProxies)
+		{
+			if (m_proxies[proxy].m_bounds.Intersects(box))
+				results.push_back(m_proxies[proxy].m_userData);
+		}
+
+		if (m_nodes.empty()) return;
+
+		std::vector<int32> stack;
+		stack.reserve(BVH_STACK_RESERVE);
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			const int mask = IntersectAABBNode(node.m_minX, node.m_minY, node.m_minZ, node.m_maxX, node.m_maxY, node.m_maxZ, box);
+			for (int slot = 0; slot < 4; slot++)
+			{
+				if (!(mask & (1 << slot)) || IsEmptySlot(node, slot)) continue;
+
+				const int32 child = node.m_children[slot];
+				if (child > 0)
+				{
+					stack.push_back(child);
+					continue;
+				}
+
+				const uint32 start = (uint32)(-(child + 1));
+				for (uint32 i = start; i < start + node.m_counts[slot]; i++)
+				{
+					const Proxy& proxy = m_proxies[m_primitives[i]];
+					if (proxy.m_alive && proxy.m_bounds.Intersects(box))
+						results.push_back(proxy.m_userData);
+				}
+			}
+		}
+	}
+
+	void BVH::QueryFrustum(const Frustum& frustum, std::vector<uint32>& results) const
+	{
+		for (uint32 proxy : m_pendingProxies)
+		{
+			if (frustum.IntersectsAABB(m_proxies[proxy].m_bounds))
+				results.push_back(m_proxies[proxy].m_userData);
+		}
+
+		if (m_nodes.empty()) return;
+
+		std::vector<int32> stack;
+		stack.reserve(BVH_STACK_RESERVE);
+		stack.push_back(0);
+
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			const int mask = IntersectFrustumNode(node.m_minX, node.m_minY, node.m_minZ, node.m_maxX, node.m_maxY, node.m_maxZ, frustum);
+			for (int slot = 0; slot < 4; slot++)
+			{
+				if (!(mask & (1 << slot)) || IsEmptySlot(node, slot)) continue;
+
+				const int32 child = node.m_children[slot];
+				if (child > 0)
+				{
+					stack.push_back(child);
+					continue;
+				}
+
+				const uint32 start = (uint32)(-(child + 1));
+				for (uint32 i = start; i < start + node.m_counts[slot]; i++)
+				{
+					const Proxy& proxy = m_proxies[m_primitives[i]];
+					if (proxy.m_alive && frustum.IntersectsAABB(proxy.m_bounds))
+						results.push_back(proxy.m_userData);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,164 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utility/Math/BVHBenchmark.hpp"
+#include "Utility/Math/BVH.hpp"
+#include "Utility/Math/Matrix.hpp"
+#include "Utility/Log.hpp"
+#include "Core/Timer.hpp"
+#include <random>
+
+#define BVHBENCHMARK_WORLD_EXTENT 2000.0f
+#define BVHBENCHMARK_QUERY_EXTENT 20.0f
+#define BVHBENCHMARK_RAY_DISTANCE 1000.0f
+#define BVHBENCHMARK_FRUSTUM_COUNT 64
+
+namespace LinaEngine
+{
+	std::vector<BVHBenchmarkResult> BVHBenchmark::Run(uint32 primitiveCount, uint32 queryCount, uint32 iterations)
+	{
+		// Random but repeatable scene.
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> positionRange(-BVHBENCHMARK_WORLD_EXTENT, BVHBENCHMARK_WORLD_EXTENT), sizeRange(0.25f, 2.0f), jitterRange(-0.5f, 0.5f), unitRange(-1.0f, 1.0f);
+
+		std::vector<AABB> bounds(primitiveCount), movedBounds(primitiveCount);
+		for (uint32 i = 0; i < primitiveCount; i++)
+		{
+			const Vector3 center(positionRange(random), positionRange(random), positionRange(random));
+			const Vector3 extents(sizeRange(random), sizeRange(random), sizeRange(random));
+			const Vector3 jitter(jitterRange(random), jitterRange(random), jitterRange(random));
+			bounds[i] = AABB(center - extents, center + extents);
+			movedBounds[i] = AABB(center - extents + jitter, center + extents + jitter);
+		}
+
+		BVH bvh;
+		std::vector<uint32> proxies(primitiveCount);
+		for (uint32 i = 0; i < primitiveCount; i++)
+			proxies[i] = bvh.CreateProxy(bounds[i], i);
+
+		std::vector<BVHBenchmarkResult> results;
+		auto addResult = [&](const char* operation, uint32 count, double ms, uint64 resultCount)
+		{
+			BVHBenchmarkResult result;
+			result.m_operation = operation;
+			result.m_count = count;
+			result.m_ms = ms;
+			result.m_nsPerItem = ms * 1000000.0 / (double)(count == 0 ? 1 : count);
+			result.m_results = resultCount;
+			results.push_back(result);
+		};
+
+		const double buildMS = Timer::TimeBest(iterations, []() {}, [&]() { bvh.Rebuild(); });
+		addResult("Build", primitiveCount, buildMS, bvh.GetNodeCount());
+
+		// Refits alternate between the original & jittered bounds so every iteration moves the same proxies.
+		auto refit = [&](uint32 stride)
+		{
+			bool moved = false;
+			return Timer::TimeBest(iterations, []() {}, [&]()
+			{
+				const std::vector<AABB>& target = moved ? bounds : movedBounds;
+				for (uint32 i = 0; i < primitiveCount; i += stride)
+					bvh.MoveProxy(proxies[i], target[i]);
+
+				bvh.Update();
+				moved = !moved;
+			});
+		};
+
+		addResult("Refit 10% Moved", primitiveCount / 10, refit(10), 0);
+		addResult("Refit All Moved", primitiveCount, refit(1), 0);
+
+		// Queries run against a freshly built tree.
+		bvh.Rebuild();
+
+		std::vector<Ray> rays(queryCount);
+		std::vector<AABB> boxes(queryCount);
+		for (uint32 i = 0; i < queryCount; i++)
+		{
+			const Vector3 origin(positionRange(random), positionRange(random), positionRange(random));
+			rays[i] = Ray(origin, Vector3(unitRange(random), unitRange(random), unitRange(random)).Normalized());
+			boxes[i] = AABB(origin - Vector3(BVHBENCHMARK_QUERY_EXTENT), origin + Vector3(BVHBENCHMARK_QUERY_EXTENT));
+		}
+
+		uint64 hitCount = 0;
+		const double rayMS = Timer::TimeBest(iterations, [&]() { hitCount = 0; }, [&]()
+		{
+			BVH::RayHit hit;
+			for (const Ray& ray : rays)
+			{
+				hit = BVH::RayHit();
+				hitCount += bvh.RayCast(ray, BVHBENCHMARK_RAY_DISTANCE, hit) ? 1 : 0;
+			}
+		});
+		addResult("Ray Cast", queryCount, rayMS, hitCount);
+
+		std::vector<uint32> queryResults;
+		uint64 overlapCount = 0;
+		const double boxMS = Timer::TimeBest(iterations, [&]() { overlapCount = 0; }, [&]()
+		{
+			for (const AABB& box : boxes)
+			{
+				queryResults.clear();
+				bvh.QueryAABB(box, queryResults);
+				overlapCount += queryResults.size();
+			}
+		});
+		addResult("AABB Query", queryCount, boxMS, overlapCount);
+
+		// Cameras scattered through the scene looking at random points, each sees thousands of primitives.
+		std::vector<Frustum> frustums(BVHBENCHMARK_FRUSTUM_COUNT);
+		const Matrix projection = Matrix::Perspective(30.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+		for (Frustum& frustum : frustums)
+		{
+			const Vector3 location(positionRange(random), positionRange(random), positionRange(random));
+			const Vector3 target = location + Vector3(unitRange(random), unitRange(random), unitRange(random)).Normalized();
+			frustum.Extract(projection * Matrix::InitLookAt(location, target, Vector3(0.0f, 1.0f, 0.0f)));
+		}
+
+		uint64 visibleCount = 0;
+		const double frustumMS = Timer::TimeBest(iterations, [&]() { visibleCount = 0; }, [&]()
+		{
+			for (const Frustum& frustum : frustums)
+			{
+				queryResults.clear();
+				bvh.QueryFrustum(frustum, queryResults);
+				visibleCount += queryResults.size();
+			}
+		});
+		addResult("Frustum Query", BVHBENCHMARK_FRUSTUM_COUNT, frustumMS, visibleCount);
+
+		return results;
+	}
+
+	void BVHBenchmark::LogResults(const std::vector<BVHBenchmarkResult>& results)
+	{
+		for (const BVHBenchmarkResult& result : results)
+			LINA_CORE_TRACE("[BVH Benchmark] {0}: {1} items {2:.3f} ms ({3:.1f} ns per item), {4} results", result.m_operation, result.m_count, result.m_ms, result.m_nsPerItem, result.m_results);
+	}
+}
@@ -0,0 +1,140 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utility/Math/Frustum.hpp"
+#include "PackageManager/PAMSIMD.hpp"
+
+namespace LinaEngine
+{
+	void Frustum::Extract(const Matrix& viewProjection)
+	{
+		// Gribb & Hartmann, rows of the column major matrix combined with the w row.
+		const Matrix& m = viewProjection;
+		for (int i = 0; i < 3; i++)
+		{
+			const glm::vec4 row(m[0][i], m[1][i], m[2][i], m[3][i]);
+			const glm::vec4 rowW(m[0][3], m[1][3], m[2][3], m[3][3]);
+			m_planes[i * 2] = rowW + row;
+			m_planes[i * 2 + 1] = rowW - row;
+		}
+
+		for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++)
+		{
+			float length = glm::length(glm::vec3(m_planes[i]));
+			if (length > 0.0f)
+				m_planes[i] = glm::vec4(m_planes[i]) / length;
+		}
+	}
+
+	bool Frustum::IntersectsSphere(const Vector3& center, float radius) const
+	{
+		for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++)
+		{
+			const Vector4& p = m_planes[i];
+			if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool Frustum::IntersectsAABB(const AABB& box) const
+	{
+		// Test the corner furthest along each plane normal.
+		for (int i = 0; i < FRUSTUM_PLANE_COUNT; i++)
+		{
+			const Vector4& p = m_planes[i];
+			float x = p.x >= 0.0f ? box.m_boundsMax.x : box.m_boundsMin.x;
+			float y = p.y >= 0.0f ? box.m_boundsMax.y : box.m_boundsMin.y;
+			float z = p.z >= 0.0f ? box.m_boundsMax.z : box.m_boundsMin.z;
+			if (p.x * x + p.y * y + p.z * z + p.w < 0.0f)
+				return false;
+		}
+
+		return true;
+	}
+
+	uint32 Frustum::CullSpheres(const Vector4* spheres, uint32 count, uint8* results) const
+	{
+		uint32 visibleCount = 0;
+		uint32 i = 0;
+
+#ifdef LINA_SIMD_SSE
+		// Splat the plane components once, then test four spheres per iteration.
+		__m128 planeX[FRUSTUM_PLANE_COUNT], planeY[FRUSTUM_PLANE_COUNT], planeZ[FRUSTUM_PLANE_COUNT], planeW[FRUSTUM_PLANE_COUNT];
+		for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+		{
+			planeX[p] = _mm_set1_ps(m_planes[p].x);
+			planeY[p] = _mm_set1_ps(m_planes[p].y);
+			planeZ[p] = _mm_set1_ps(m_planes[p].z);
+			planeW[p] = _mm_set1_ps(m_planes[p].w);
+		}
+
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			// Transpose AoS spheres into x, y, z & radius lanes.
+			__m128 x = _mm_loadu_ps(&spheres[i].x);
+			__m128 y = _mm_loadu_ps(&spheres[i + 1].x);
+			__m128 z = _mm_loadu_ps(&spheres[i + 2].x);
+			__m128 r = _mm_loadu_ps(&spheres[i + 3].x);
+			_MM_TRANSPOSE4_PS(x, y, z, r);
+
+			const __m128 negativeRadius = _mm_xor_ps(r, signMask);
+			__m128 inside = _mm_setzero_ps();
+
+			for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, planeX[p]), _mm_mul_ps(y, planeY[p])), _mm_add_ps(_mm_mul_ps(z, planeZ[p]), planeW[p]));
+				__m128 inFront = _mm_cmpge_ps(distance, negativeRadius);
+				inside = p == 0 ? inFront : _mm_and_ps(inside, inFront);
+			}
+
+			const int mask = _mm_movemask_ps(inside);
+			for (int lane = 0; lane < 4; lane++)
+			{
+				const uint8 visible = (mask >> lane) & 1;
+				results[i + lane] = visible;
+				visibleCount += visible;
+			}
+		}
+#endif
+
+		// Scalar path for the remainder or when SIMD is not available.
+		for (; i < count; i++)
+		{
+			const Vector4& s = spheres[i];
+			const uint8 visible = IntersectsSphere(Vector3(s.x, s.y, s.z), s.w) ? 1 : 0;
+			results[i] = visible;
+			visibleCount += visible;
+		}
+
+		return visibleCount;
+	}
+}
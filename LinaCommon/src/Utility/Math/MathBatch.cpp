@@ -0,0 +1,684 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utility/Math/MathBatch.hpp"
+#include "PackageManager/PAMSIMD.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#ifdef LINA_SIMD_DISPATCH
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// Slerp falls back to a lerp above this, same threshold as glm::slerp.
+#define MATHBATCH_SLERP_LERP_THRESHOLD (1.0f - 1.192092896e-07f)
+
+namespace LinaEngine
+{
+	// GLOBALS DECLARATIONS
+	static SIMDLevel DetectLevel();
+	static SIMDLevel s_level = DetectLevel();
+
+	// ---------------------------------------------------------------------
+	// SCALAR KERNELS
+	// ---------------------------------------------------------------------
+
+	static void ComposeTRSScalar(const Vector3SoA& positions, const QuaternionSoA& rotations, const Vector3SoA& scales, Matrix* out, size_t begin, size_t count)
+	{
+		for (size_t i = begin; i < count; i++)
+		{
+			const float x = rotations.m_x[i], y = rotations.m_y[i], z = rotations.m_z[i], w = rotations.m_w[i];
+			const float xx2 = 2.0f * x * x, yy2 = 2.0f * y * y, zz2 = 2.0f * z * z;
+			const float xy2 = 2.0f * x * y, xz2 = 2.0f * x * z, yz2 = 2.0f * y * z;
+			const float wx2 = 2.0f * w * x, wy2 = 2.0f * w * y, wz2 = 2.0f * w * z;
+			const float sx = scales.m_x[i], sy = scales.m_y[i], sz = scales.m_z[i];
+
+			float* m = &out[i][0].x;
+			m[0] = (1.0f - yy2 - zz2) * sx;	m[1] = (xy2 + wz2) * sx;		m[2] = (xz2 - wy2) * sx;		m[3] = 0.0f;
+			m[4] = (xy2 - wz2) * sy;		m[5] = (1.0f - xx2 - zz2) * sy;	m[6] = (yz2 + wx2) * sy;		m[7] = 0.0f;
+			m[8] = (xz2 + wy2) * sz;		m[9] = (yz2 - wx2) * sz;		m[10] = (1.0f - xx2 - yy2) * sz;	m[11] = 0.0f;
+			m[12] = positions.m_x[i];		m[13] = positions.m_y[i];		m[14] = positions.m_z[i];		m[15] = 1.0f;
+		}
+	}
+
+	static void MultiplyScalar(const Matrix* a, const Matrix* b, Matrix* out, size_t begin, size_t count)
+	{
+		for (size_t i = begin; i < count; i++)
+			out[i] = glm::mat4(a[i]) * glm::mat4(b[i]);
+	}
+
+	// Rows of the inverse of the upper 3x3 from the cross products of its columns, translation is -inverse * t.
+	static void InvertAffineScalar(const Matrix& m, glm::vec3& r0, glm::vec3& r1, glm::vec3& r2, glm::vec3& translation)
+	{
+		const glm::vec3 c0 = glm::vec3(m[0]), c1 = glm::vec3(m[1]), c2 = glm::vec3(m[2]), t = glm::vec3(m[3]);
+		r0 = glm::cross(c1, c2);
+		r1 = glm::cross(c2, c0);
+		r2 = glm::cross(c0, c1);
+
+		const float invDet = 1.0f / glm::dot(c0, r0);
+		r0 *= invDet;
+		r1 *= invDet;
+		r2 *= invDet;
+		translation = -glm::vec3(glm::dot(r0, t), glm::dot(r1, t), glm::dot(r2, t));
+	}
+
+	static void InverseAffineScalar(const Matrix* in, Matrix* out, size_t begin, size_t count)
+	{
+		glm::vec3 r0, r1, r2, t;
+		for (size_t i = begin; i < count; i++)
+		{
+			InvertAffineScalar(in[i], r0, r1, r2, t);
+			out[i] = glm::mat4(glm::vec4(r0.x, r1.x, r2.x, 0.0f), glm::vec4(r0.y, r1.y, r2.y, 0.0f), glm::vec4(r0.z, r1.z, r2.z, 0.0f), glm::vec4(t, 1.0f));
+		}
+	}
+
+	static void NormalMatrixScalar(const Matrix* in, Matrix* out, size_t begin, size_t count)
+	{
+		glm::vec3 r0, r1, r2, t;
+		for (size_t i = begin; i < count; i++)
+		{
+			InvertAffineScalar(in[i], r0, r1, r2, t);
+			out[i] = glm::mat4(glm::vec4(r0, t.x), glm::vec4(r1, t.y), glm::vec4(r2, t.z), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+	}
+
+	static void TransformAABBScalar(const AABB* boxes, const Matrix* matrices, AABB* out, size_t begin, size_t count)
+	{
+		for (size_t i = begin; i < count; i++)
+			out[i] = boxes[i].Transform(matrices[i]);
+	}
+
+	static void NormalizeQuaternionsScalar(const QuaternionSoA& rotations, size_t begin, size_t count)
+	{
+		for (size_t i = begin; i < count; i++)
+		{
+			const glm::quat q = glm::normalize(glm::quat(rotations.m_w[i], rotations.m_x[i], rotations.m_y[i], rotations.m_z[i]));
+			rotations.m_x[i] = q.x;
+			rotations.m_y[i] = q.y;
+			rotations.m_z[i] = q.z;
+			rotations.m_w[i] = q.w;
+		}
+	}
+
+	static void SlerpScalar(const QuaternionSoA& from, const QuaternionSoA& to, const float* t, const QuaternionSoA& out, size_t begin, size_t count)
+	{
+		for (size_t i = begin; i < count; i++)
+		{
+			const glm::quat a = glm::quat(from.m_w[i], from.m_x[i], from.m_y[i], from.m_z[i]);
+			const glm::quat b = glm::quat(to.m_w[i], to.m_x[i], to.m_y[i], to.m_z[i]);
+			const glm::quat q = glm::slerp(a, b, t[i]);
+			out.m_x[i] = q.x;
+			out.m_y[i] = q.y;
+			out.m_z[i] = q.z;
+			out.m_w[i] = q.w;
+		}
+	}
+
+#ifdef LINA_SIMD_DISPATCH
+
+	// ---------------------------------------------------------------------
+	// SSE4.1 KERNELS
+	// ---------------------------------------------------------------------
+
+	// Writes one column of 4 consecutive matrices from per component lanes.
+	LINA_SIMD_TARGET_SSE4 static inline void StoreColumnsSSE4(Matrix* out, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&out[0][column].x, x);
+		_mm_storeu_ps(&out[1][column].x, y);
+		_mm_storeu_ps(&out[2][column].x, z);
+		_mm_storeu_ps(&out[3][column].x, w);
+	}
+
+	LINA_SIMD_TARGET_SSE4 static inline __m128 CrossSSE4(__m128 a, __m128 b)
+	{
+		const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+		return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+	}
+
+	// Columns of the normal matrix, the inverse rows with the inverse translation in w.
+	LINA_SIMD_TARGET_SSE4 static inline void InvertAffineSSE4(const Matrix& m, __m128& n0, __m128& n1, __m128& n2)
+	{
+		const __m128 c0 = _mm_loadu_ps(&m[0].x), c1 = _mm_loadu_ps(&m[1].x), c2 = _mm_loadu_ps(&m[2].x), c3 = _mm_loadu_ps(&m[3].x);
+		const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), _mm_dp_ps(c0, CrossSSE4(c1, c2), 0x7F));
+		const __m128 r0 = _mm_mul_ps(CrossSSE4(c1, c2), invDet);
+		const __m128 r1 = _mm_mul_ps(CrossSSE4(c2, c0), invDet);
+		const __m128 r2 = _mm_mul_ps(CrossSSE4(c0, c1), invDet);
+		const __m128 zero = _mm_setzero_ps();
+		n0 = _mm_blend_ps(r0, _mm_sub_ps(zero, _mm_dp_ps(r0, c3, 0x7F)), 0x8);
+		n1 = _mm_blend_ps(r1, _mm_sub_ps(zero, _mm_dp_ps(r1, c3, 0x7F)), 0x8);
+		n2 = _mm_blend_ps(r2, _mm_sub_ps(zero, _mm_dp_ps(r2, c3, 0x7F)), 0x8);
+	}
+
+	LINA_SIMD_TARGET_SSE4 static size_t ComposeTRSSSE4(const Vector3SoA& positions, const QuaternionSoA& rotations, const Vector3SoA& scales, Matrix* out, size_t count)
+	{
+		const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+		size_t i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(rotations.m_x + i), y = _mm_loadu_ps(rotations.m_y + i), z = _mm_loadu_ps(rotations.m_z + i), w = _mm_loadu_ps(rotations.m_w + i);
+			const __m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+			const __m128 xx2 = _mm_mul_ps(x, x2), yy2 = _mm_mul_ps(y, y2), zz2 = _mm_mul_ps(z, z2);
+			const __m128 xy2 = _mm_mul_ps(x, y2), xz2 = _mm_mul_ps(x, z2), yz2 = _mm_mul_ps(y, z2);
+			const __m128 wx2 = _mm_mul_ps(w, x2), wy2 = _mm_mul_ps(w, y2), wz2 = _mm_mul_ps(w, z2);
+			const __m128 sx = _mm_loadu_ps(scales.m_x + i), sy = _mm_loadu_ps(scales.m_y + i), sz = _mm_loadu_ps(scales.m_z + i);
+
+			StoreColumnsSSE4(out + i, 0, _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, yy2), zz2), sx), _mm_mul_ps(_mm_add_ps(xy2, wz2), sx), _mm_mul_ps(_mm_sub_ps(xz2, wy2), sx), zero);
+			StoreColumnsSSE4(out + i, 1, _mm_mul_ps(_mm_sub_ps(xy2, wz2), sy), _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx2), zz2), sy), _mm_mul_ps(_mm_add_ps(yz2, wx2), sy), zero);
+			StoreColumnsSSE4(out + i, 2, _mm_mul_ps(_mm_add_ps(xz2, wy2), sz), _mm_mul_ps(_mm_sub_ps(yz2, wx2), sz), _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx2), yy2), sz), zero);
+			StoreColumnsSSE4(out + i, 3, _mm_loadu_ps(positions.m_x + i), _mm_loadu_ps(positions.m_y + i), _mm_loadu_ps(positions.m_z + i), one);
+		}
+
+		return i;
+	}
+
+	LINA_SIMD_TARGET_SSE4 static size_t MultiplySSE4(const Matrix* a, const Matrix* b, Matrix* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const __m128 a0 = _mm_loadu_ps(&a[i][0].x), a1 = _mm_loadu_ps(&a[i][1].x), a2 = _mm_loadu_ps(&a[i][2].x), a3 = _mm_loadu_ps(&a[i][3].x);
+			__m128 columns[4];
+
+			for (int c = 0; c < 4; c++)
+			{
+				const __m128 bc = _mm_loadu_ps(&b[i][c].x);
+				__m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+				r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+				r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+				columns[c] = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3))));
+			}
+
+			for (int c = 0; c < 4; c++)
+				_mm_storeu_ps(&out[i][c].x, columns[c]);
+		}
+
+		return count;
+	}
+
+	LINA_SIMD_TARGET_SSE4 static size_t InverseAffineSSE4(const Matrix* in, Matrix* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			__m128 n0, n1, n2, n3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+			InvertAffineSSE4(in[i], n0, n1, n2);
+			_MM_TRANSPOSE4_PS(n0, n1, n2, n3);
+			_mm_storeu_ps(&out[i][0].x, n0);
+			_mm_storeu_ps(&out[i][1].x, n1);
+			_mm_storeu_ps(&out[i][2].x, n2);
+			_mm_storeu_ps(&out[i][3].x, n3);
+		}
+
+		return count;
+	}
+
+	LINA_SIMD_TARGET_SSE4 static size_t NormalMatrixSSE4(const Matrix* in, Matrix* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			__m128 n0, n1, n2;
+			InvertAffineSSE4(in[i], n0, n1, n2);
+			_mm_storeu_ps(&out[i][0].x, n0);
+			_mm_storeu_ps(&out[i][1].x, n1);
+			_mm_storeu_ps(&out[i][2].x, n2);
+			_mm_storeu_ps(&out[i][3].x, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+
+		return count;
+	}
+
+	LINA_SIMD_TARGET_SSE4 static size_t TransformAABBSSE4(const AABB* boxes, const Matrix* matrices, AABB* out, size_t count)
+	{
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		float boundsMin[4], boundsMax[4];
+
+		for (size_t i = 0; i < count; i++)
+		{
+			// Vector3s are 12 bytes, loaded per component so the last box isn't read past.
+			const AABB& box = boxes[i];
+			const __m128 minimum = _mm_setr_ps(box.m_boundsMin.x, box.m_boundsMin.y, box.m_boundsMin.z, 0.0f);
+			const __m128 maximum = _mm_setr_ps(box.m_boundsMax.x, box.m_boundsMax.y, box.m_boundsMax.z, 0.0f);
+			const __m128 center = _mm_mul_ps(_mm_add_ps(minimum, maximum), half);
+			const __m128 extents = _mm_mul_ps(_mm_sub_ps(maximum, minimum), half);
+
+			const Matrix& m = matrices[i];
+			const __m128 c0 = _mm_loadu_ps(&m[0].x), c1 = _mm_loadu_ps(&m[1].x), c2 = _mm_loadu_ps(&m[2].x), c3 = _mm_loadu_ps(&m[3].x);
+
+			__m128 worldCenter = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0))));
+			worldCenter = _mm_add_ps(worldCenter, _mm_mul_ps(c1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1))));
+			worldCenter = _mm_add_ps(worldCenter, _mm_mul_ps(c2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2))));
+
+			__m128 worldExtents = _mm_mul_ps(_mm_and_ps(c0, absMask), _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(0, 0, 0, 0)));
+			worldExtents = _mm_add_ps(worldExtents, _mm_mul_ps(_mm_and_ps(c1, absMask), _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(1, 1, 1, 1))));
+			worldExtents = _mm_add_ps(worldExtents, _mm_mul_ps(_mm_and_ps(c2, absMask), _mm_shuffle_ps(extents, extents, _MM_SHUFFLE(2, 2, 2, 2))));
+
+			_mm_storeu_ps(boundsMin, _mm_sub_ps(worldCenter, worldExtents));
+			_mm_storeu_ps(boundsMax, _mm_add_ps(worldCenter, worldExtents));
+			out[i].m_boundsMin = Vector3(boundsMin[0], boundsMin[1], boundsMin[2]);
+			out[i].m_boundsMax = Vector3(boundsMax[0], boundsMax[1], boundsMax[2]);
+		}
+
+		return count;
+	}
+
+	LINA_SIMD_TARGET_SSE4 static size_t NormalizeQuaternionsSSE4(const QuaternionSoA& rotations, size_t count)
+	{
+		const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+		size_t i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(rotations.m_x + i), y = _mm_loadu_ps(rotations.m_y + i), z = _mm_loadu_ps(rotations.m_z + i), w = _mm_loadu_ps(rotations.m_w + i);
+			const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+			const __m128 valid = _mm_cmpgt_ps(length, zero);
+			const __m128 invLength = _mm_div_ps(one, length);
+
+			_mm_storeu_ps(rotations.m_x + i, _mm_and_ps(_mm_mul_ps(x, invLength), valid));
+			_mm_storeu_ps(rotations.m_y + i, _mm_and_ps(_mm_mul_ps(y, invLength), valid));
+			_mm_storeu_ps(rotations.m_z + i, _mm_and_ps(_mm_mul_ps(z, invLength), valid));
+			_mm_storeu_ps(rotations.m_w + i, _mm_blendv_ps(one, _mm_mul_ps(w, invLength), valid));
+		}
+
+		return i;
+	}
+
+	// Abramowitz & Stegun 4.4.46, |error| < 2e-8 on [0, 1].
+	LINA_SIMD_TARGET_SSE4 static inline __m128 AcosSSE4(__m128 x)
+	{
+		__m128 p = _mm_set1_ps(-0.0012624911f);
+		p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(0.0066700901f));
+		p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-0.0170881256f));
+		p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(0.0308918810f));
+		p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-0.0501743046f));
+		p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(0.0889789874f));
+		p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-0.2145988016f));
+		p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.5707963050f));
+		return _mm_mul_ps(p, _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), x)));
+	}
+
+	// Taylor series up to x^11, |error| < 6e-8 on [0, pi / 2].
+	LINA_SIMD_TARGET_SSE4 static inline __m128 SinSSE4(__m128 x)
+	{
+		const __m128 x2 = _mm_mul_ps(x, x);
+		__m128 p = _mm_set1_ps(-2.5052108e-8f);
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(2.7557319e-6f));
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.9841270e-4f));
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(8.3333333e-3f));
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.6666667e-1f));
+		p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+		return _mm_mul_ps(p, x);
+	}
+
+	LINA_SIMD_TARGET_SSE4 static size_t SlerpSSE4(const QuaternionSoA& from, const QuaternionSoA& to, const float* t, const QuaternionSoA& out, size_t count)
+	{
+		const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), signMask = _mm_set1_ps(-0.0f);
+		size_t i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 ax = _mm_loadu_ps(from.m_x + i), ay = _mm_loadu_ps(from.m_y + i), az = _mm_loadu_ps(from.m_z + i), aw = _mm_loadu_ps(from.m_w + i);
+			__m128 bx = _mm_loadu_ps(to.m_x + i), by = _mm_loadu_ps(to.m_y + i), bz = _mm_loadu_ps(to.m_z + i), bw = _mm_loadu_ps(to.m_w + i);
+			__m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+
+			// Negate the destination of the lanes that would take the long way around.
+			const __m128 flip = _mm_and_ps(_mm_cmplt_ps(cosTheta, zero), signMask);
+			bx = _mm_xor_ps(bx, flip);
+			by = _mm_xor_ps(by, flip);
+			bz = _mm_xor_ps(bz, flip);
+			bw = _mm_xor_ps(bw, flip);
+			cosTheta = _mm_min_ps(_mm_xor_ps(cosTheta, flip), one);
+
+			const __m128 lt = _mm_loadu_ps(t + i);
+			const __m128 theta = AcosSSE4(cosTheta);
+			const __m128 invSinTheta = _mm_div_ps(one, SinSSE4(theta));
+			__m128 weightA = _mm_mul_ps(SinSSE4(_mm_mul_ps(_mm_sub_ps(one, lt), theta)), invSinTheta);
+			__m128 weightB = _mm_mul_ps(SinSSE4(_mm_mul_ps(lt, theta)), invSinTheta);
+
+			// Nearly parallel lanes lerp instead, their sin(theta) is too small to divide by.
+			const __m128 useLerp = _mm_cmpgt_ps(cosTheta, _mm_set1_ps(MATHBATCH_SLERP_LERP_THRESHOLD));
+			weightA = _mm_blendv_ps(weightA, _mm_sub_ps(one, lt), useLerp);
+			weightB = _mm_blendv_ps(weightB, lt, useLerp);
+
+			_mm_storeu_ps(out.m_x + i, _mm_add_ps(_mm_mul_ps(ax, weightA), _mm_mul_ps(bx, weightB)));
+			_mm_storeu_ps(out.m_y + i, _mm_add_ps(_mm_mul_ps(ay, weightA), _mm_mul_ps(by, weightB)));
+			_mm_storeu_ps(out.m_z + i, _mm_add_ps(_mm_mul_ps(az, weightA), _mm_mul_ps(bz, weightB)));
+			_mm_storeu_ps(out.m_w + i, _mm_add_ps(_mm_mul_ps(aw, weightA), _mm_mul_ps(bw, weightB)));
+		}
+
+		return i;
+	}
+
+	// ---------------------------------------------------------------------
+	// AVX2 KERNELS
+	// ---------------------------------------------------------------------
+
+	// Writes one column of 8 consecutive matrices from per component lanes.
+	LINA_SIMD_TARGET_AVX2 static inline void StoreColumnsAVX2(Matrix* out, int column, __m256 x, __m256 y, __m256 z, __m256 w)
+	{
+		StoreColumnsSSE4(out, column, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(w));
+		StoreColumnsSSE4(out + 4, column, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+	}
+
+	LINA_SIMD_TARGET_AVX2 static size_t ComposeTRSAVX2(const Vector3SoA& positions, const QuaternionSoA& rotations, const Vector3SoA& scales, Matrix* out, size_t count)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 x = _mm256_loadu_ps(rotations.m_x + i), y = _mm256_loadu_ps(rotations.m_y + i), z = _mm256_loadu_ps(rotations.m_z + i), w = _mm256_loadu_ps(rotations.m_w + i);
+			const __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+			const __m256 xx2 = _mm256_mul_ps(x, x2), yy2 = _mm256_mul_ps(y, y2), zz2 = _mm256_mul_ps(z, z2);
+			const __m256 xy2 = _mm256_mul_ps(x, y2), xz2 = _mm256_mul_ps(x, z2), yz2 = _mm256_mul_ps(y, z2);
+			const __m256 wx2 = _mm256_mul_ps(w, x2), wy2 = _mm256_mul_ps(w, y2), wz2 = _mm256_mul_ps(w, z2);
+			const __m256 sx = _mm256_loadu_ps(scales.m_x + i), sy = _mm256_loadu_ps(scales.m_y + i), sz = _mm256_loadu_ps(scales.m_z + i);
+
+			StoreColumnsAVX2(out + i, 0, _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(one, yy2), zz2), sx), _mm256_mul_ps(_mm256_add_ps(xy2, wz2), sx), _mm256_mul_ps(_mm256_sub_ps(xz2, wy2), sx), zero);
+			StoreColumnsAVX2(out + i, 1, _mm256_mul_ps(_mm256_sub_ps(xy2, wz2), sy), _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(one, xx2), zz2), sy), _mm256_mul_ps(_mm256_add_ps(yz2, wx2), sy), zero);
+			StoreColumnsAVX2(out + i, 2, _mm256_mul_ps(_mm256_add_ps(xz2, wy2), sz), _mm256_mul_ps(_mm256_sub_ps(yz2, wx2), sz), _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(one, xx2), yy2), sz), zero);
+			StoreColumnsAVX2(out + i, 3, _mm256_loadu_ps(positions.m_x + i), _mm256_loadu_ps(positions.m_y + i), _mm256_loadu_ps(positions.m_z + i), one);
+		}
+
+		return i;
+	}
+
+	LINA_SIMD_TARGET_AVX2 static size_t MultiplyAVX2(const Matrix* a, const Matrix* b, Matrix* out, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			// Two result columns per register, each half picks its own column's components of b.
+			const __m256 a0 = _mm256_broadcast_ps((const __m128*)&a[i][0].x), a1 = _mm256_broadcast_ps((const __m128*)&a[i][1].x);
+			const __m256 a2 = _mm256_broadcast_ps((const __m128*)&a[i][2].x), a3 = _mm256_broadcast_ps((const __m128*)&a[i][3].x);
+			const __m256 b01 = _mm256_loadu_ps(&b[i][0].x), b23 = _mm256_loadu_ps(&b[i][2].x);
+
+			__m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)));
+			r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)), r01);
+			r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2)), r01);
+			r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3)), r01);
+
+			__m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0)));
+			r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1)), r23);
+			r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2)), r23);
+			r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3)), r23);
+
+			_mm256_storeu_ps(&out[i][0].x, r01);
+			_mm256_storeu_ps(&out[i][2].x, r23);
+		}
+
+		return count;
+	}
+
+	LINA_SIMD_TARGET_AVX2 static size_t NormalizeQuaternionsAVX2(const QuaternionSoA& rotations, size_t count)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps();
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 x = _mm256_loadu_ps(rotations.m_x + i), y = _mm256_loadu_ps(rotations.m_y + i), z = _mm256_loadu_ps(rotations.m_z + i), w = _mm256_loadu_ps(rotations.m_w + i);
+			const __m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_fmadd_ps(z, z, _mm256_mul_ps(w, w)))));
+			const __m256 valid = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+			const __m256 invLength = _mm256_div_ps(one, length);
+
+			_mm256_storeu_ps(rotations.m_x + i, _mm256_and_ps(_mm256_mul_ps(x, invLength), valid));
+			_mm256_storeu_ps(rotations.m_y + i, _mm256_and_ps(_mm256_mul_ps(y, invLength), valid));
+			_mm256_storeu_ps(rotations.m_z + i, _mm256_and_ps(_mm256_mul_ps(z, invLength), valid));
+			_mm256_storeu_ps(rotations.m_w + i, _mm256_blendv_ps(one, _mm256_mul_ps(w, invLength), valid));
+		}
+
+		return i;
+	}
+
+	LINA_SIMD_TARGET_AVX2 static inline __m256 AcosAVX2(__m256 x)
+	{
+		__m256 p = _mm256_set1_ps(-0.0012624911f);
+		p = _mm256_fmadd_ps(p, x, _mm256_set1_ps(0.0066700901f));
+		p = _mm256_fmadd_ps(p, x, _mm256_set1_ps(-0.0170881256f));
+		p = _mm256_fmadd_ps(p, x, _mm256_set1_ps(0.0308918810f));
+		p = _mm256_fmadd_ps(p, x, _mm256_set1_ps(-0.0501743046f));
+		p = _mm256_fmadd_ps(p, x, _mm256_set1_ps(0.0889789874f));
+		p = _mm256_fmadd_ps(p, x, _mm256_set1_ps(-0.2145988016f));
+		p = _mm256_fmadd_ps(p, x, _mm256_set1_ps(1.5707963050f));
+		return _mm256_mul_ps(p, _mm256_sqrt_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), x)));
+	}
+
+	LINA_SIMD_TARGET_AVX2 static inline __m256 SinAVX2(__m256 x)
+	{
+		const __m256 x2 = _mm256_mul_ps(x, x);
+		__m256 p = _mm256_set1_ps(-2.5052108e-8f);
+		p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(2.7557319e-6f));
+		p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(-1.9841270e-4f));
+		p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(8.3333333e-3f));
+		p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(-1.6666667e-1f));
+		p = _mm256_fmadd_ps(p, x2, _mm256_set1_ps(1.0f));
+		return _mm256_mul_ps(p, x);
+	}
+
+	LINA_SIMD_TARGET_AVX2 static size_t SlerpAVX2(const QuaternionSoA& from, const QuaternionSoA& to, const float* t, const QuaternionSoA& out, size_t count)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps(), signMask = _mm256_set1_ps(-0.0f);
+		size_t i = 0;
+
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 ax = _mm256_loadu_ps(from.m_x + i), ay = _mm256_loadu_ps(from.m_y + i), az = _mm256_loadu_ps(from.m_z + i), aw = _mm256_loadu_ps(from.m_w + i);
+			__m256 bx = _mm256_loadu_ps(to.m_x + i), by = _mm256_loadu_ps(to.m_y + i), bz = _mm256_loadu_ps(to.m_z + i), bw = _mm256_loadu_ps(to.m_w + i);
+			__m256 cosTheta = _mm256_fmadd_ps(ax, bx, _mm256_fmadd_ps(ay, by, _mm256_fmadd_ps(az, bz, _mm256_mul_ps(aw, bw))));
+
+			const __m256 flip = _mm256_and_ps(_mm256_cmp_ps(cosTheta, zero, _CMP_LT_OQ), signMask);
+			bx = _mm256_xor_ps(bx, flip);
+			by = _mm256_xor_ps(by, flip);
+			bz = _mm256_xor_ps(bz, flip);
+			bw = _mm256_xor_ps(bw, flip);
+			cosTheta = _mm256_min_ps(_mm256_xor_ps(cosTheta, flip), one);
+
+			const __m256 lt = _mm256_loadu_ps(t + i);
+			const __m256 theta = AcosAVX2(cosTheta);
+			const __m256 invSinTheta = _mm256_div_ps(one, SinAVX2(theta));
+			__m256 weightA = _mm256_mul_ps(SinAVX2(_mm256_mul_ps(_mm256_sub_ps(one, lt), theta)), invSinTheta);
+			__m256 weightB = _mm256_mul_ps(SinAVX2(_mm256_mul_ps(lt, theta)), invSinTheta);
+
+			const __m256 useLerp = _mm256_cmp_ps(cosTheta, _mm256_set1_ps(MATHBATCH_SLERP_LERP_THRESHOLD), _CMP_GT_OQ);
+			weightA = _mm256_blendv_ps(weightA, _mm256_sub_ps(one, lt), useLerp);
+			weightB = _mm256_blendv_ps(weightB, lt, useLerp);
+
+			_mm256_storeu_ps(out.m_x + i, _mm256_fmadd_ps(ax, weightA, _mm256_mul_ps(bx, weightB)));
+			_mm256_storeu_ps(out.m_y + i, _mm256_fmadd_ps(ay, weightA, _mm256_mul_ps(by, weightB)));
+			_mm256_storeu_ps(out.m_z + i, _mm256_fmadd_ps(az, weightA, _mm256_mul_ps(bz, weightB)));
+			_mm256_storeu_ps(out.m_w + i, _mm256_fmadd_ps(aw, weightA, _mm256_mul_ps(bw, weightB)));
+		}
+
+		return i;
+	}
+
+#endif
+
+	// ---------------------------------------------------------------------
+	// DISPATCH
+	// ---------------------------------------------------------------------
+
+	SIMDLevel MathBatch::GetSupportedLevel()
+	{
+		static const SIMDLevel supported = DetectLevel();
+		return supported;
+	}
+
+	void MathBatch::SetLevel(SIMDLevel level)
+	{
+		s_level = (uint8)level > (uint8)GetSupportedLevel() ? GetSupportedLevel() : level;
+	}
+
+	SIMDLevel MathBatch::GetLevel()
+	{
+		return s_level;
+	}
+
+	const char* MathBatch::GetLevelName(SIMDLevel level)
+	{
+		if (level == SIMDLevel::AVX2) return "AVX2";
+		if (level == SIMDLevel::SSE4) return "SSE4";
+		return "Scalar";
+	}
+
+	void MathBatch::ComposeTRS(const Vector3SoA& positions, const QuaternionSoA& rotations, const Vector3SoA& scales, Matrix* out, size_t count)
+	{
+		size_t done = 0;
+#ifdef LINA_SIMD_DISPATCH
+		if (s_level == SIMDLevel::AVX2)
+			done = ComposeTRSAVX2(positions, rotations, scales, out, count);
+		else if (s_level == SIMDLevel::SSE4)
+			done = ComposeTRSSSE4(positions, rotations, scales, out, count);
+#endif
+		ComposeTRSScalar(positions, rotations, scales, out, done, count);
+	}
+
+	void MathBatch::Multiply(const Matrix* a, const Matrix* b, Matrix* out, size_t count)
+	{
+		size_t done = 0;
+#ifdef LINA_SIMD_DISPATCH
+		if (s_level == SIMDLevel::AVX2)
+			done = MultiplyAVX2(a, b, out, count);
+		else if (s_level == SIMDLevel::SSE4)
+			done = MultiplySSE4(a, b, out, count);
+#endif
+		MultiplyScalar(a, b, out, done, count);
+	}
+
+	void MathBatch::InverseAffine(const Matrix* in, Matrix* out, size_t count)
+	{
+		// Single matrix per iteration, AVX2 has nothing to add over the SSE4 version.
+		size_t done = 0;
+#ifdef LINA_SIMD_DISPATCH
+		if (s_level != SIMDLevel::Scalar)
+			done = InverseAffineSSE4(in, out, count);
+#endif
+		InverseAffineScalar(in, out, done, count);
+	}
+
+	void MathBatch::NormalMatrix(const Matrix* in, Matrix* out, size_t count)
+	{
+		size_t done = 0;
+#ifdef LINA_SIMD_DISPATCH
+		if (s_level != SIMDLevel::Scalar)
+			done = NormalMatrixSSE4(in, out, count);
+#endif
+		NormalMatrixScalar(in, out, done, count);
+	}
+
+	void MathBatch::TransformAABB(const AABB* boxes, const Matrix* matrices, AABB* out, size_t count)
+	{
+		size_t done = 0;
+#ifdef LINA_SIMD_DISPATCH
+		if (s_level != SIMDLevel::Scalar)
+			done = TransformAABBSSE4(boxes, matrices, out, count);
+#endif
+		TransformAABBScalar(boxes, matrices, out, done, count);
+	}
+
+	void MathBatch::NormalizeQuaternions(const QuaternionSoA& rotations, size_t count)
+	{
+		size_t done = 0;
+#ifdef LINA_SIMD_DISPATCH
+		if (s_level == SIMDLevel::AVX2)
+			done = NormalizeQuaternionsAVX2(rotations, count);
+		else if (s_level == SIMDLevel::SSE4)
+			done = NormalizeQuaternionsSSE4(rotations, count);
+#endif
+		NormalizeQuaternionsScalar(rotations, done, count);
+	}
+
+	void MathBatch::Slerp(const QuaternionSoA& from, const QuaternionSoA& to, const float* t, const QuaternionSoA& out, size_t count)
+	{
+		size_t done = 0;
+#ifdef LINA_SIMD_DISPATCH
+		if (s_level == SIMDLevel::AVX2)
+			done = SlerpAVX2(from, to, t, out, count);
+		else if (s_level == SIMDLevel::SSE4)
+			done = SlerpSSE4(from, to, t, out, count);
+#endif
+		SlerpScalar(from, to, t, out, done, count);
+	}
+
+	SIMDLevel DetectLevel()
+	{
+#ifdef LINA_SIMD_DISPATCH
+		int regs[4] = { 0 };
+#ifdef _MSC_VER
+		__cpuid(regs, 0);
+		const int maxLeaf = regs[0];
+		__cpuid(regs, 1);
+#else
+		unsigned int eax, ebx, ecx, edx;
+		__cpuid(0, eax, ebx, ecx, edx);
+		const int maxLeaf = (int)eax;
+		__cpuid(1, eax, ebx, ecx, edx);
+		regs[2] = (int)ecx;
+#endif
+		const bool sse41 = (regs[2] & (1 << 19)) != 0;
+		const bool fma = (regs[2] & (1 << 12)) != 0;
+		const bool osxsave = (regs[2] & (1 << 27)) != 0;
+		const bool avx = (regs[2] & (1 << 28)) != 0;
+		if (!sse41) return SIMDLevel::Scalar;
+
+		// The OS has to save the ymm registers too, not only the CPU support them.
+		bool ymmEnabled = false;
+		if (osxsave && avx)
+		{
+#ifdef _MSC_VER
+			ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+#else
+			unsigned int xcrLow, xcrHigh;
+			__asm__ volatile("xgetbv" : "=a"(xcrLow), "=d"(xcrHigh) : "c"(0));
+			ymmEnabled = (xcrLow & 0x6) == 0x6;
+#endif
+		}
+
+		bool avx2 = false;
+		if (ymmEnabled && fma && maxLeaf >= 7)
+		{
+#ifdef _MSC_VER
+			__cpuidex(regs, 7, 0);
+			avx2 = (regs[1] & (1 << 5)) != 0;
+#else
+			__cpuid_count(7, 0, eax, ebx, ecx, edx);
+			avx2 = (ebx & (1 << 5)) != 0;
+#endif
+		}
+
+		return avx2 ? SIMDLevel::AVX2 : SIMDLevel::SSE4;
+#else
+		return SIMDLevel::Scalar;
+#endif
+	}
+}
@@ -0,0 +1,200 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utility/Math/MathBenchmark.hpp"
+#include "Utility/Log.hpp"
+#include "Core/Timer.hpp"
+#include <functional>
+#include <random>
+
+namespace LinaEngine
+{
+	// GLOBALS DECLARATIONS
+	static float MaxError(const Matrix* a, const Matrix* b, size_t count);
+
+	std::vector<MathBenchmarkResult> MathBenchmark::Run(size_t count, uint32 iterations)
+	{
+		// Random but repeatable transforms, rotations are left unnormalized for the normalize kernel.
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> positionRange(-100.0f, 100.0f), scaleRange(0.5f, 2.0f), unitRange(-1.0f, 1.0f), factorRange(0.0f, 1.0f);
+
+		std::vector<float> px(count), py(count), pz(count), sx(count), sy(count), sz(count);
+		std::vector<float> qx(count), qy(count), qz(count), qw(count), tx(count), ty(count), tz(count), tw(count);
+		std::vector<float> nx(count), ny(count), nz(count), nw(count), ox(count), oy(count), oz(count), ow(count), factors(count);
+		std::vector<Vector3> positions(count), scales(count);
+		std::vector<Quaternion> rotations(count), targets(count), rawRotations(count), glmRotations(count);
+		std::vector<Matrix> matrices(count), otherMatrices(count), glmMatrices(count), batchMatrices(count);
+		std::vector<AABB> boxes(count), glmBoxes(count), batchBoxes(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			positions[i] = Vector3(positionRange(random), positionRange(random), positionRange(random));
+			scales[i] = Vector3(scaleRange(random), scaleRange(random), scaleRange(random));
+			rawRotations[i] = Quaternion(unitRange(random), unitRange(random), unitRange(random), unitRange(random));
+			rotations[i] = rawRotations[i].Normalized();
+			targets[i] = Quaternion(unitRange(random), unitRange(random), unitRange(random), unitRange(random)).Normalized();
+			factors[i] = factorRange(random);
+
+			px[i] = positions[i].x; py[i] = positions[i].y; pz[i] = positions[i].z;
+			sx[i] = scales[i].x; sy[i] = scales[i].y; sz[i] = scales[i].z;
+			qx[i] = rotations[i].x; qy[i] = rotations[i].y; qz[i] = rotations[i].z; qw[i] = rotations[i].w;
+			tx[i] = targets[i].x; ty[i] = targets[i].y; tz[i] = targets[i].z; tw[i] = targets[i].w;
+			nx[i] = rawRotations[i].x; ny[i] = rawRotations[i].y; nz[i] = rawRotations[i].z; nw[i] = rawRotations[i].w;
+
+			matrices[i] = Matrix::TransformMatrix(positions[i], rotations[i], scales[i]);
+			otherMatrices[i] = Matrix::TransformMatrix(Vector3(scales[i].x * 10.0f, scales[i].y * 10.0f, scales[i].z * 10.0f), targets[i], Vector3(scales[i].z, scales[i].x, scales[i].y));
+
+			const Vector3 extents(scales[i].x * 2.0f, scales[i].y * 2.0f, scales[i].z * 2.0f);
+			boxes[i] = AABB(positions[i] - extents, positions[i] + extents);
+		}
+
+		Vector3SoA positionsSoA, scalesSoA;
+		positionsSoA.m_x = px.data(); positionsSoA.m_y = py.data(); positionsSoA.m_z = pz.data();
+		scalesSoA.m_x = sx.data(); scalesSoA.m_y = sy.data(); scalesSoA.m_z = sz.data();
+
+		QuaternionSoA rotationsSoA, targetsSoA, normalizedSoA, slerpSoA;
+		rotationsSoA.m_x = qx.data(); rotationsSoA.m_y = qy.data(); rotationsSoA.m_z = qz.data(); rotationsSoA.m_w = qw.data();
+		targetsSoA.m_x = tx.data(); targetsSoA.m_y = ty.data(); targetsSoA.m_z = tz.data(); targetsSoA.m_w = tw.data();
+		normalizedSoA.m_x = nx.data(); normalizedSoA.m_y = ny.data(); normalizedSoA.m_z = nz.data(); normalizedSoA.m_w = nw.data();
+		slerpSoA.m_x = ox.data(); slerpSoA.m_y = oy.data(); slerpSoA.m_z = oz.data(); slerpSoA.m_w = ow.data();
+
+		std::vector<MathBenchmarkResult> results;
+		const SIMDLevel previousLevel = MathBatch::GetLevel();
+
+		// Times the glm path once & the batch kernel at every supported level, comparing each run's output.
+		auto runKernel = [&](const char* name, const std::function<void()>& glmPath, const std::function<void()>& batchPath, const std::function<float()>& error)
+		{
+			MathBenchmarkResult result;
+			result.m_kernel = name;
+			result.m_glmMS = Timer::TimeBest(iterations, glmPath);
+
+			for (uint8 level = 0; level <= (uint8)MathBatch::GetSupportedLevel(); level++)
+			{
+				MathBatch::SetLevel((SIMDLevel)level);
+				result.m_batchMS[level] = Timer::TimeBest(iterations, batchPath);
+				result.m_maxError[level] = error();
+			}
+
+			results.push_back(result);
+		};
+
+		auto quaternionError = [&](const QuaternionSoA& soa)
+		{
+			float error = 0.0f;
+			for (size_t i = 0; i < count; i++)
+			{
+				error = glm::max(error, glm::abs(soa.m_x[i] - glmRotations[i].x));
+				error = glm::max(error, glm::abs(soa.m_y[i] - glmRotations[i].y));
+				error = glm::max(error, glm::abs(soa.m_z[i] - glmRotations[i].z));
+				error = glm::max(error, glm::abs(soa.m_w[i] - glmRotations[i].w));
+			}
+			return error;
+		};
+
+		runKernel("ComposeTRS",
+			[&]() { for (size_t i = 0; i < count; i++) glmMatrices[i] = Matrix::TransformMatrix(positions[i], rotations[i], scales[i]); },
+			[&]() { MathBatch::ComposeTRS(positionsSoA, rotationsSoA, scalesSoA, batchMatrices.data(), count); },
+			[&]() { return MaxError(glmMatrices.data(), batchMatrices.data(), count); });
+
+		runKernel("Multiply",
+			[&]() { for (size_t i = 0; i < count; i++) glmMatrices[i] = matrices[i] * otherMatrices[i]; },
+			[&]() { MathBatch::Multiply(matrices.data(), otherMatrices.data(), batchMatrices.data(), count); },
+			[&]() { return MaxError(glmMatrices.data(), batchMatrices.data(), count); });
+
+		runKernel("InverseAffine",
+			[&]() { for (size_t i = 0; i < count; i++) glmMatrices[i] = matrices[i].Inverse(); },
+			[&]() { MathBatch::InverseAffine(matrices.data(), batchMatrices.data(), count); },
+			[&]() { return MaxError(glmMatrices.data(), batchMatrices.data(), count); });
+
+		runKernel("NormalMatrix",
+			[&]() { for (size_t i = 0; i < count; i++) glmMatrices[i] = matrices[i].ToNormalMatrix(); },
+			[&]() { MathBatch::NormalMatrix(matrices.data(), batchMatrices.data(), count); },
+			[&]() { return MaxError(glmMatrices.data(), batchMatrices.data(), count); });
+
+		runKernel("TransformAABB",
+			[&]() { for (size_t i = 0; i < count; i++) glmBoxes[i] = boxes[i].Transform(otherMatrices[i]); },
+			[&]() { MathBatch::TransformAABB(boxes.data(), otherMatrices.data(), batchBoxes.data(), count); },
+			[&]()
+			{
+				float error = 0.0f;
+				for (size_t i = 0; i < count; i++)
+				{
+					for (int c = 0; c < 3; c++)
+					{
+						error = glm::max(error, glm::abs(glmBoxes[i].m_boundsMin[c] - batchBoxes[i].m_boundsMin[c]));
+						error = glm::max(error, glm::abs(glmBoxes[i].m_boundsMax[c] - batchBoxes[i].m_boundsMax[c]));
+					}
+				}
+				return error;
+			});
+
+		// Normalizes in place, only the first iteration sees unnormalized input but the work is the same.
+		runKernel("NormalizeQuaternions",
+			[&]() { for (size_t i = 0; i < count; i++) glmRotations[i] = rawRotations[i].Normalized(); },
+			[&]() { MathBatch::NormalizeQuaternions(normalizedSoA, count); },
+			[&]() { return quaternionError(normalizedSoA); });
+
+		runKernel("Slerp",
+			[&]() { for (size_t i = 0; i < count; i++) glmRotations[i] = Quaternion::Slerp(rotations[i], targets[i], factors[i]); },
+			[&]() { MathBatch::Slerp(rotationsSoA, targetsSoA, factors.data(), slerpSoA, count); },
+			[&]() { return quaternionError(slerpSoA); });
+
+		MathBatch::SetLevel(previousLevel);
+		return results;
+	}
+
+	void MathBenchmark::LogResults(const std::vector<MathBenchmarkResult>& results)
+	{
+		for (const MathBenchmarkResult& result : results)
+		{
+			LINA_CORE_TRACE("[Math Benchmark] {0}: glm {1:.4f} ms", result.m_kernel, result.m_glmMS);
+
+			for (int level = 0; level < MATHBENCHMARK_LEVEL_COUNT; level++)
+			{
+				if (result.m_batchMS[level] < 0.0) continue;
+				LINA_CORE_TRACE("[Math Benchmark] {0}: {1} {2:.4f} ms, {3:.2f}x, max error {4}", result.m_kernel, MathBatch::GetLevelName((SIMDLevel)level), result.m_batchMS[level], result.m_glmMS / glm::max(result.m_batchMS[level], 1e-6), result.m_maxError[level]);
+			}
+		}
+	}
+
+	float MaxError(const Matrix* a, const Matrix* b, size_t count)
+	{
+		float error = 0.0f;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				for (int r = 0; r < 4; r++)
+					error = glm::max(error, glm::abs(a[i][c][r] - b[i][c][r]));
+			}
+		}
+
+		return error;
+	}
+}
@@ -0,0 +1,95 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Utility/Math/Ray.hpp"
+
+namespace LinaEngine
+{
+	bool Ray::IntersectsAABB(const AABB& box, float maxDistance, float& distance) const
+	{
+		float tMin = 0.0f;
+		float tMax = maxDistance;
+
+		for (int i = 0; i < 3; i++)
+		{
+			const float origin = m_origin[i];
+			const float direction = m_direction[i];
+
+			if (glm::abs(direction) < 1e-8f)
+			{
+				// Parallel to the slab, origin must be inside.
+				if (origin < box.m_boundsMin[i] || origin > box.m_boundsMax[i])
+					return false;
+				continue;
+			}
+
+			const float invDirection = 1.0f / direction;
+			float t0 = (box.m_boundsMin[i] - origin) * invDirection;
+			float t1 = (box.m_boundsMax[i] - origin) * invDirection;
+			if (t0 > t1) std::swap(t0, t1);
+			tMin = t0 > tMin ? t0 : tMin;
+			tMax = t1 < tMax ? t1 : tMax;
+
+			if (tMin > tMax)
+				return false;
+		}
+
+		distance = tMin;
+		return true;
+	}
+
+	bool Ray::IntersectsTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, float& distance) const
+	{
+		// Moller-Trumbore, both faces are accepted.
+		const glm::vec3 edge1 = glm::vec3(v1) - glm::vec3(v0);
+		const glm::vec3 edge2 = glm::vec3(v2) - glm::vec3(v0);
+		const glm::vec3 p = glm::cross(glm::vec3(m_direction), edge2);
+		const float determinant = glm::dot(edge1, p);
+
+		if (glm::abs(determinant) < 1e-8f)
+			return false;
+
+		const float invDeterminant = 1.0f / determinant;
+		const glm::vec3 s = glm::vec3(m_origin) - glm::vec3(v0);
+		const float u = glm::dot(s, p) * invDeterminant;
+		if (u < 0.0f || u > 1.0f)
+			return false;
+
+		const glm::vec3 q = glm::cross(s, edge1);
+		const float v = glm::dot(glm::vec3(m_direction), q) * invDeterminant;
+		if (v < 0.0f || u + v > 1.0f)
+			return false;
+
+		const float t = glm::dot(edge2, q) * invDeterminant;
+		if (t < 0.0f)
+			return false;
+
+		distance = t;
+		return true;
+	}
+}
@@ -83,6 +83,20 @@ namespace LinaEngine
 		}
 	}
 
+	void Transformation::SetLocationAndRotation(const Vector3& loc, const Quaternion& rot)
+	{
+		m_location = loc;
+		m_rotation = rot;
+		UpdateLocalLocation();
+		UpdateLocalRotation();
+
+		for (Transformation* child : m_children)
+		{
+			child->UpdateGlobalRotation();
+			child->UpdateGlobalLocation();
+		}
+	}
+
 	void Transformation::SetLocalScale(const Vector3& scale, bool isThisPivot)
 	{
 		m_localScale = scale;
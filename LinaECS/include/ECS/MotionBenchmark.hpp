@@ -0,0 +1,71 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: MotionBenchmark
+
+Times a typical velocity integration system (linear velocity & acceleration, angular velocity on the
+rotation) over a registry of benchmark entities. Compares the per entity glm loop through a view & an
+owning group against the WideMath versions gathering from the group at 4 & 8 lanes, and against the
+same math on plain structure of arrays data, which is the upper bound without any gather cost.
+
+Timestamp: 10/20/2026 3:06:18 AM
+*/
+
+#pragma once
+
+#ifndef MotionBenchmark_HPP
+#define MotionBenchmark_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <string>
+#include <vector>
+
+namespace LinaEngine::ECS
+{
+	struct MotionBenchmarkResult
+	{
+		std::string m_variant;
+		double m_ms = 0.0;
+		double m_nsPerEntity = 0.0;
+
+		// Largest location difference to the per entity glm loop after the same steps.
+		float m_maxError = 0.0f;
+	};
+
+	class MotionBenchmark
+	{
+	public:
+
+		// Best step time of the iterations for each variant, every variant starts from the same entities.
+		static std::vector<MotionBenchmarkResult> Run(size_t entityCount = 1000000, uint32 iterations = 8);
+		static void LogResults(const std::vector<MotionBenchmarkResult>& results);
+	};
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: WideGather
+
+Moves component data between entt pools & the lane wide WideMath types. Gathers & scatters take a fetch
+function returning the member for a lane by reference, so the same call works on the contiguous arrays of
+an owning group & on the per lane component pointers of a view. Lanes past the chunk size read as zero & aren't written.
+
+Timestamp: 10/20/2026 2:51:44 AM
+*/
+
+#pragma once
+
+#ifndef WideGather_HPP
+#define WideGather_HPP
+
+#include "ECS/ECSSystem.hpp"
+#include "Utility/Math/WideMath.hpp"
+#include <tuple>
+
+namespace LinaEngine::ECS
+{
+	// Full chunks take a fixed trip count so the lane loops unroll, gathers build them in registers.
+	template<typename F, typename Func>
+	FORCEINLINE void ForEachLane(int lanes, Func func)
+	{
+		if (lanes == F::Width)
+		{
+			for (int i = 0; i < F::Width; i++)
+				func(i);
+		}
+		else
+		{
+			for (int i = 0; i < lanes; i++)
+				func(i);
+		}
+	}
+
+	// fetch(lane) -> const float&.
+	template<typename F, typename Fetch>
+	FORCEINLINE F GatherFloat(int lanes, Fetch fetch)
+	{
+		if (lanes == F::Width)
+			return F::Generate([&](int i) { return fetch(i); });
+
+		float v[F::Width] = {};
+		for (int i = 0; i < lanes; i++)
+			v[i] = fetch(i);
+		return F::Load(v);
+	}
+
+	// fetch(lane) -> float&.
+	template<typename F, typename Fetch>
+	FORCEINLINE void ScatterFloat(const F& value, int lanes, Fetch fetch)
+	{
+		float v[F::Width];
+		value.Store(v);
+		ForEachLane<F>(lanes, [&](int i) { fetch(i) = v[i]; });
+	}
+
+	// fetch(lane) -> const Vector3&.
+	template<typename F, typename Fetch>
+	FORCEINLINE Vector3xN<F> GatherVector3(int lanes, Fetch fetch)
+	{
+		if (lanes == F::Width)
+			return Vector3xN<F>(F::Generate([&](int i) { return fetch(i).x; }), F::Generate([&](int i) { return fetch(i).y; }), F::Generate([&](int i) { return fetch(i).z; }));
+
+		float x[F::Width] = {}, y[F::Width] = {}, z[F::Width] = {};
+		for (int i = 0; i < lanes; i++)
+		{
+			const Vector3& v = fetch(i);
+			x[i] = v.x; y[i] = v.y; z[i] = v.z;
+		}
+		return Vector3xN<F>(F::Load(x), F::Load(y), F::Load(z));
+	}
+
+	// fetch(lane) -> Vector3&.
+	template<typename F, typename Fetch>
+	FORCEINLINE void ScatterVector3(const Vector3xN<F>& value, int lanes, Fetch fetch)
+	{
+		float x[F::Width], y[F::Width], z[F::Width];
+		value.m_x.Store(x); value.m_y.Store(y); value.m_z.Store(z);
+		ForEachLane<F>(lanes, [&](int i)
+		{
+			Vector3& v = fetch(i);
+			v.x = x[i]; v.y = y[i]; v.z = z[i];
+		});
+	}
+
+	// fetch(lane) -> const Quaternion&, unused lanes are identity.
+	template<typename F, typename Fetch>
+	FORCEINLINE QuaternionxN<F> GatherQuaternion(int lanes, Fetch fetch)
+	{
+		if (lanes == F::Width)
+			return QuaternionxN<F>(F::Generate([&](int i) { return fetch(i).x; }), F::Generate([&](int i) { return fetch(i).y; }), F::Generate([&](int i) { return fetch(i).z; }), F::Generate([&](int i) { return fetch(i).w; }));
+
+		float x[F::Width] = {}, y[F::Width] = {}, z[F::Width] = {}, w[F::Width];
+		for (int i = 0; i < F::Width; i++)
+			w[i] = 1.0f;
+
+		for (int i = 0; i < lanes; i++)
+		{
+			const Quaternion& q = fetch(i);
+			x[i] = q.x; y[i] = q.y; z[i] = q.z; w[i] = q.w;
+		}
+		return QuaternionxN<F>(F::Load(x), F::Load(y), F::Load(z), F::Load(w));
+	}
+
+	// fetch(lane) -> Quaternion&.
+	template<typename F, typename Fetch>
+	FORCEINLINE void ScatterQuaternion(const QuaternionxN<F>& value, int lanes, Fetch fetch)
+	{
+		float x[F::Width], y[F::Width], z[F::Width], w[F::Width];
+		value.m_x.Store(x); value.m_y.Store(y); value.m_z.Store(z); value.m_w.Store(w);
+		ForEachLane<F>(lanes, [&](int i)
+		{
+			Quaternion& q = fetch(i);
+			q.x = x[i]; q.y = y[i]; q.z = z[i]; q.w = w[i];
+		});
+	}
+
+	// Walks a full owning group of the components in chunks of F::Width, func(lanes, Components*...) gets
+	// the component arrays offset to the chunk. Owning groups keep the pools in the same order, so lane i
+	// of every array is the same entity. The components can't be owned by another group.
+	template<typename F, typename... Components, typename Func>
+	FORCEINLINE void ForEachWide(ECSRegistry& reg, Func func)
+	{
+		auto group = reg.group<Components...>();
+		const size_t count = group.size();
+
+		for (size_t first = 0; first < count; first += F::Width)
+		{
+			const int lanes = count - first < (size_t)F::Width ? (int)(count - first) : F::Width;
+			func(lanes, (group.template raw<Components>() + first)...);
+		}
+	}
+
+	template<typename F, typename Component>
+	struct WideLanePointers
+	{
+		Component* m_lanes[F::Width];
+	};
+
+	// Same over a view, for components that are owned elsewhere. func(lanes, Components**...) gets the
+	// components of the chunk's entities, looked up once per entity rather than once per member.
+	template<typename F, typename... Components, typename View, typename Func>
+	FORCEINLINE void ForEachWideView(View& view, Func func)
+	{
+		std::tuple<WideLanePointers<F, Components>...> pointers;
+		int lanes = 0;
+
+		for (ECSEntity entity : view)
+		{
+			((std::get<WideLanePointers<F, Components>>(pointers).m_lanes[lanes] = &view.template get<Components>(entity)), ...);
+
+			if (++lanes == F::Width)
+			{
+				func(lanes, std::get<WideLanePointers<F, Components>>(pointers).m_lanes...);
+				lanes = 0;
+			}
+		}
+
+		if (lanes > 0)
+			func(lanes, std::get<WideLanePointers<F, Components>>(pointers).m_lanes...);
+	}
+}
+
+#endif
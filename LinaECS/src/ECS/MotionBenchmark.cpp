@@ -0,0 +1,258 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ECS/MotionBenchmark.hpp"
+#include "ECS/WideGather.hpp"
+#include "Utility/Log.hpp"
+#include "Core/Timer.hpp"
+#include <algorithm>
+#include <functional>
+#include <random>
+
+#define MOTIONBENCHMARK_DELTA (1.0f / 60.0f)
+
+namespace LinaEngine::ECS
+{
+	struct BenchmarkTransform
+	{
+		Vector3 m_location;
+		Quaternion m_rotation;
+	};
+
+	struct BenchmarkMotion
+	{
+		Vector3 m_velocity;
+		Vector3 m_acceleration;
+		Vector3 m_angularVelocity;
+	};
+
+	// GLOBALS DECLARATIONS
+	static void Integrate(BenchmarkTransform& transform, BenchmarkMotion& motion, float delta);
+
+	// Semi implicit euler, velocity first then location with the new velocity.
+	template<typename F>
+	static FORCEINLINE void IntegrateWide(Vector3xN<F>& location, QuaternionxN<F>& rotation, Vector3xN<F>& velocity, const Vector3xN<F>& acceleration, const Vector3xN<F>& angularVelocity, const F& delta)
+	{
+		velocity = MulAdd(acceleration, delta, velocity);
+		location = MulAdd(velocity, delta, location);
+		rotation = rotation.Integrate(angularVelocity, delta);
+	}
+
+	template<typename F>
+	static void StepGroup(ECSRegistry& reg)
+	{
+		const F delta(MOTIONBENCHMARK_DELTA);
+
+		ForEachWide<F, BenchmarkTransform, BenchmarkMotion>(reg, [&](int lanes, BenchmarkTransform* transforms, BenchmarkMotion* motions)
+		{
+			Vector3xN<F> location = GatherVector3<F>(lanes, [&](int i) -> const Vector3& { return transforms[i].m_location; });
+			QuaternionxN<F> rotation = GatherQuaternion<F>(lanes, [&](int i) -> const Quaternion& { return transforms[i].m_rotation; });
+			Vector3xN<F> velocity = GatherVector3<F>(lanes, [&](int i) -> const Vector3& { return motions[i].m_velocity; });
+			const Vector3xN<F> acceleration = GatherVector3<F>(lanes, [&](int i) -> const Vector3& { return motions[i].m_acceleration; });
+			const Vector3xN<F> angularVelocity = GatherVector3<F>(lanes, [&](int i) -> const Vector3& { return motions[i].m_angularVelocity; });
+
+			IntegrateWide(location, rotation, velocity, acceleration, angularVelocity, delta);
+
+			ScatterVector3(location, lanes, [&](int i) -> Vector3& { return transforms[i].m_location; });
+			ScatterQuaternion(rotation, lanes, [&](int i) -> Quaternion& { return transforms[i].m_rotation; });
+			ScatterVector3(velocity, lanes, [&](int i) -> Vector3& { return motions[i].m_velocity; });
+		});
+	}
+
+	std::vector<MotionBenchmarkResult> MotionBenchmark::Run(size_t entityCount, uint32 iterations)
+	{
+		// Random but repeatable entities, created before the group so it sorts them once.
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> locationRange(-500.0f, 500.0f), velocityRange(-10.0f, 10.0f), unitRange(-1.0f, 1.0f);
+
+		ECSRegistry reg;
+		for (size_t i = 0; i < entityCount; i++)
+		{
+			const ECSEntity entity = reg.create();
+
+			BenchmarkTransform transform;
+			transform.m_location = Vector3(locationRange(random), locationRange(random), locationRange(random));
+			transform.m_rotation = glm::normalize(glm::quat(unitRange(random), unitRange(random), unitRange(random), unitRange(random)));
+			reg.emplace<BenchmarkTransform>(entity, transform);
+
+			BenchmarkMotion motion;
+			motion.m_velocity = Vector3(velocityRange(random), velocityRange(random), velocityRange(random));
+			motion.m_acceleration = Vector3(unitRange(random), unitRange(random) - 9.81f, unitRange(random));
+			motion.m_angularVelocity = Vector3(unitRange(random), unitRange(random), unitRange(random));
+			reg.emplace<BenchmarkMotion>(entity, motion);
+		}
+
+		auto group = reg.group<BenchmarkTransform, BenchmarkMotion>();
+		BenchmarkTransform* transforms = group.raw<BenchmarkTransform>();
+		BenchmarkMotion* motions = group.raw<BenchmarkMotion>();
+
+		// Every variant starts from these, in group order.
+		const std::vector<BenchmarkTransform> initialTransforms(transforms, transforms + entityCount);
+		const std::vector<BenchmarkMotion> initialMotions(motions, motions + entityCount);
+		std::vector<Vector3> reference(entityCount);
+
+		// Structure of arrays copy padded to the native width, so the loop has no tail.
+		const size_t paddedCount = (entityCount + WIDEMATH_NATIVE_WIDTH - 1) / WIDEMATH_NATIVE_WIDTH * WIDEMATH_NATIVE_WIDTH;
+		std::vector<float> soa(paddedCount * 16);
+		float* soaArrays[16];
+		for (int i = 0; i < 16; i++)
+			soaArrays[i] = soa.data() + paddedCount * i;
+
+		Vector3SoA soaLocation, soaVelocity, soaAcceleration, soaAngularVelocity;
+		QuaternionSoA soaRotation;
+		soaLocation.m_x = soaArrays[0]; soaLocation.m_y = soaArrays[1]; soaLocation.m_z = soaArrays[2];
+		soaRotation.m_x = soaArrays[3]; soaRotation.m_y = soaArrays[4]; soaRotation.m_z = soaArrays[5]; soaRotation.m_w = soaArrays[6];
+		soaVelocity.m_x = soaArrays[7]; soaVelocity.m_y = soaArrays[8]; soaVelocity.m_z = soaArrays[9];
+		soaAcceleration.m_x = soaArrays[10]; soaAcceleration.m_y = soaArrays[11]; soaAcceleration.m_z = soaArrays[12];
+		soaAngularVelocity.m_x = soaArrays[13]; soaAngularVelocity.m_y = soaArrays[14]; soaAngularVelocity.m_z = soaArrays[15];
+
+		auto resetRegistry = [&]()
+		{
+			std::copy(initialTransforms.begin(), initialTransforms.end(), transforms);
+			std::copy(initialMotions.begin(), initialMotions.end(), motions);
+		};
+
+		auto resetSoA = [&]()
+		{
+			std::fill(soa.begin(), soa.end(), 0.0f);
+			for (size_t i = 0; i < entityCount; i++)
+			{
+				const BenchmarkTransform& transform = initialTransforms[i];
+				const BenchmarkMotion& motion = initialMotions[i];
+				soaLocation.m_x[i] = transform.m_location.x; soaLocation.m_y[i] = transform.m_location.y; soaLocation.m_z[i] = transform.m_location.z;
+				soaRotation.m_x[i] = transform.m_rotation.x; soaRotation.m_y[i] = transform.m_rotation.y; soaRotation.m_z[i] = transform.m_rotation.z; soaRotation.m_w[i] = transform.m_rotation.w;
+				soaVelocity.m_x[i] = motion.m_velocity.x; soaVelocity.m_y[i] = motion.m_velocity.y; soaVelocity.m_z[i] = motion.m_velocity.z;
+				soaAcceleration.m_x[i] = motion.m_acceleration.x; soaAcceleration.m_y[i] = motion.m_acceleration.y; soaAcceleration.m_z[i] = motion.m_acceleration.z;
+				soaAngularVelocity.m_x[i] = motion.m_angularVelocity.x; soaAngularVelocity.m_y[i] = motion.m_angularVelocity.y; soaAngularVelocity.m_z[i] = motion.m_angularVelocity.z;
+			}
+		};
+
+		std::vector<MotionBenchmarkResult> results;
+
+		// Resets, times the steps & compares the locations against the reference through location(i).
+		auto runVariant = [&](const char* name, bool isSoA, const std::function<void()>& step, const std::function<Vector3(size_t)>& location)
+		{
+			if (isSoA) resetSoA(); else resetRegistry();
+
+			MotionBenchmarkResult result;
+			result.m_variant = name;
+			result.m_ms = Timer::TimeBest(iterations, step);
+			result.m_nsPerEntity = result.m_ms * 1000000.0 / glm::max((double)entityCount, 1.0);
+
+			for (size_t i = 0; i < entityCount; i++)
+			{
+				const glm::vec3 diff = glm::abs(glm::vec3(location(i)) - glm::vec3(reference[i]));
+				result.m_maxError = glm::max(result.m_maxError, glm::max(diff.x, glm::max(diff.y, diff.z)));
+			}
+
+			results.push_back(result);
+		};
+
+		auto groupLocation = [&](size_t i) { return transforms[i].m_location; };
+
+		// The per entity loop a system would write today, also the reference for the others.
+		auto view = reg.view<BenchmarkTransform, BenchmarkMotion>();
+		resetRegistry();
+		Timer::TimeBest(iterations, [&]() { view.each([](BenchmarkTransform& transform, BenchmarkMotion& motion) { Integrate(transform, motion, MOTIONBENCHMARK_DELTA); }); });
+		for (size_t i = 0; i < entityCount; i++)
+			reference[i] = transforms[i].m_location;
+
+		runVariant("glm view", false, [&]()
+		{
+			view.each([](BenchmarkTransform& transform, BenchmarkMotion& motion) { Integrate(transform, motion, MOTIONBENCHMARK_DELTA); });
+		}, groupLocation);
+
+		runVariant("glm group", false, [&]()
+		{
+			for (size_t i = 0; i < entityCount; i++)
+				Integrate(transforms[i], motions[i], MOTIONBENCHMARK_DELTA);
+		}, groupLocation);
+
+		runVariant("x4 group", false, [&]() { StepGroup<floatx4>(reg); }, groupLocation);
+		runVariant("x8 group", false, [&]() { StepGroup<floatx8>(reg); }, groupLocation);
+
+		runVariant("xN view", false, [&]()
+		{
+			const floatxN delta(MOTIONBENCHMARK_DELTA);
+
+			ForEachWideView<floatxN, BenchmarkTransform, BenchmarkMotion>(view, [&](int lanes, BenchmarkTransform** transforms, BenchmarkMotion** motions)
+			{
+				Vector3xNative location = GatherVector3<floatxN>(lanes, [&](int i) -> const Vector3& { return transforms[i]->m_location; });
+				QuaternionxNative rotation = GatherQuaternion<floatxN>(lanes, [&](int i) -> const Quaternion& { return transforms[i]->m_rotation; });
+				Vector3xNative velocity = GatherVector3<floatxN>(lanes, [&](int i) -> const Vector3& { return motions[i]->m_velocity; });
+				const Vector3xNative acceleration = GatherVector3<floatxN>(lanes, [&](int i) -> const Vector3& { return motions[i]->m_acceleration; });
+				const Vector3xNative angularVelocity = GatherVector3<floatxN>(lanes, [&](int i) -> const Vector3& { return motions[i]->m_angularVelocity; });
+
+				IntegrateWide(location, rotation, velocity, acceleration, angularVelocity, delta);
+
+				ScatterVector3(location, lanes, [&](int i) -> Vector3& { return transforms[i]->m_location; });
+				ScatterQuaternion(rotation, lanes, [&](int i) -> Quaternion& { return transforms[i]->m_rotation; });
+				ScatterVector3(velocity, lanes, [&](int i) -> Vector3& { return motions[i]->m_velocity; });
+			});
+		}, groupLocation);
+
+		runVariant("xN soa", true, [&]()
+		{
+			const floatxN delta(MOTIONBENCHMARK_DELTA);
+
+			for (size_t i = 0; i < paddedCount; i += WIDEMATH_NATIVE_WIDTH)
+			{
+				Vector3xNative location = Vector3xNative::Load(soaLocation, i);
+				QuaternionxNative rotation = QuaternionxNative::Load(soaRotation, i);
+				Vector3xNative velocity = Vector3xNative::Load(soaVelocity, i);
+
+				IntegrateWide(location, rotation, velocity, Vector3xNative::Load(soaAcceleration, i), Vector3xNative::Load(soaAngularVelocity, i), delta);
+
+				location.Store(soaLocation, i);
+				rotation.Store(soaRotation, i);
+				velocity.Store(soaVelocity, i);
+			}
+		}, [&](size_t i) { return Vector3(soaLocation.m_x[i], soaLocation.m_y[i], soaLocation.m_z[i]); });
+
+		return results;
+	}
+
+	void MotionBenchmark::LogResults(const std::vector<MotionBenchmarkResult>& results)
+	{
+		const double baseline = results.empty() ? 0.0 : results[0].m_ms;
+
+		for (const MotionBenchmarkResult& result : results)
+			LINA_CORE_TRACE("[Motion Benchmark] {0}: {1:.3f} ms, {2:.2f} ns per entity, {3:.2f}x, max error {4}", result.m_variant, result.m_ms, result.m_nsPerEntity, baseline / glm::max(result.m_ms, 1e-6), result.m_maxError);
+	}
+
+	void Integrate(BenchmarkTransform& transform, BenchmarkMotion& motion, float delta)
+	{
+		// Goes through glm::quat, the Quaternion operators forward to themselves.
+		const glm::quat rotation = transform.m_rotation;
+		const glm::quat spin(0.0f, motion.m_angularVelocity.x, motion.m_angularVelocity.y, motion.m_angularVelocity.z);
+
+		motion.m_velocity = glm::vec3(motion.m_velocity) + glm::vec3(motion.m_acceleration) * delta;
+		transform.m_location = glm::vec3(transform.m_location) + glm::vec3(motion.m_velocity) * delta;
+		transform.m_rotation = glm::normalize(rotation + (spin * rotation) * (delta * 0.5f));
+	}
+}
@@ -103,6 +103,8 @@ namespace LinaEditor
 		DebugViewPhysics = 61,
 		DebugViewShadows = 62,
 		DebugViewNormal = 63,
+		DebugViewOcclusion = 64,
+		MeshCacheReport = 65,
 
 	};
 
@@ -130,6 +132,9 @@ namespace LinaEditor
 		void DrawFPSCounter(int corner = 0);
 		void DrawCentralDockingSpace();
 
+		// Logs the vertex cache efficiency of every loaded mesh before & after the import optimizations.
+		void LogMeshCacheReport();
+
 	private:
 
 		LinaEngine::Graphics::DrawParams m_drawParameters;
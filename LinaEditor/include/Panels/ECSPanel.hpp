@@ -67,6 +67,7 @@ namespace LinaEditor
 		void Refresh();
 		void DrawEntityNode(int id,  LinaEngine::ECS::ECSEntity entity);
 		void OnLevelInstall(LinaEngine::World::Level* level);
+		void OnEntitySelected(LinaEngine::ECS::ECSEntity entity);
 
 	private:
 
@@ -40,7 +40,14 @@ Timestamp: 10/22/2020 11:22:48 PM
 #define ProfilerPanel_HPP
 
 #include "Panels/EditorPanel.hpp"
+#include "Utility/Math/MathBenchmark.hpp"
+#include "Utility/Math/BVHBenchmark.hpp"
+#include "ECS/MotionBenchmark.hpp"
+#include "Physics/PhysicsBenchmark.hpp"
+#include "Rendering/RenderQueueBenchmark.hpp"
+#include "Rendering/OcclusionBufferCheck.hpp"
 #include <deque>
+#include <future>
 
 namespace LinaEditor
 {
@@ -50,14 +57,28 @@ namespace LinaEditor
 	public:
 		
 		ProfilerPanel() {};
-		~ProfilerPanel() {};
+		~ProfilerPanel();
 
 		virtual void Setup() override;
 		virtual void Draw() override;
 		
+	private:
+
+		// Run button & result lines of a benchmark class with static Run & LogResults.
+		template<typename Benchmark, typename Result, typename DrawResult>
+		void DrawBenchmark(const char* label, std::vector<Result>& results, DrawResult drawResult);
+
 	private:
 
 		float m_lastMSDisplayTime = 0.0f;
+		std::vector<LinaEngine::MathBenchmarkResult> m_mathBenchmarkResults;
+		std::vector<LinaEngine::ECS::MotionBenchmarkResult> m_motionBenchmarkResults;
+		std::vector<LinaEngine::Physics::PhysicsBenchmarkResult> m_physicsBenchmarkResults;
+		std::vector<LinaEngine::Physics::PhysicsBenchmarkResult> m_pendingPhysicsBenchmarkResults;
+		std::future<void> m_physicsBenchmarkJob;
+		std::vector<LinaEngine::Graphics::RenderQueueBenchmarkResult> m_renderQueueBenchmarkResults;
+		std::vector<LinaEngine::BVHBenchmarkResult> m_bvhBenchmarkResults;
+		std::vector<LinaEngine::Graphics::OcclusionBufferCheckResult> m_occlusionCheckResults;
 
 	};
 }
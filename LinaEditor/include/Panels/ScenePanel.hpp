@@ -64,7 +64,8 @@ namespace LinaEditor
 		enum class DrawMode
 		{
 			FinalImage,
-			ShadowMap
+			ShadowMap,
+			OcclusionBuffer
 		};
 		
 		ScenePanel() {};
@@ -78,6 +79,7 @@ namespace LinaEditor
 		void Unselected();
 		void ProcessInput();
 		void DrawGizmos();
+		void ProcessPicking(const LinaEngine::Vector2& imageRectMin, const LinaEngine::Vector2& imageRectMax);
 		void SetDrawMode(DrawMode mode) { m_drawMode = mode; }
 		bool IsFocused() { return m_isFocused; }
 
@@ -32,6 +32,7 @@ SOFTWARE.
 #include "Physics/PhysicsEngine.hpp"
 #include "Input/InputEngine.hpp"
 #include "Rendering/RenderEngine.hpp"
+#include "Rendering/Mesh.hpp"
 #include "Core/EditorCommon.hpp"
 #include "Core/EditorApplication.hpp"
 #include "Utility/EditorUtility.hpp"
@@ -315,9 +316,31 @@ namespace LinaEditor
 		else if (item == MenuBarItems::DebugViewShadows)
 			m_scenePanel.SetDrawMode(LinaEditor::ScenePanel::DrawMode::ShadowMap);
 
+		else if (item == MenuBarItems::DebugViewOcclusion)
+			m_scenePanel.SetDrawMode(LinaEditor::ScenePanel::DrawMode::OcclusionBuffer);
+
 		else if (item == MenuBarItems::DebugViewNormal)
 			m_scenePanel.SetDrawMode(LinaEditor::ScenePanel::DrawMode::FinalImage);
 
+		else if (item == MenuBarItems::MeshCacheReport)
+			LogMeshCacheReport();
+
+	}
+
+	void GUILayer::LogMeshCacheReport()
+	{
+		LinaEngine::Graphics::MeshOptimizationReport total;
+
+		for (auto& pair : LinaEngine::Graphics::Mesh::GetLoadedMeshes())
+		{
+			const LinaEngine::Graphics::MeshOptimizationReport& report = pair.second.GetOptimizationReport();
+			total.Add(report);
+			LINA_CLIENT_INFO("{0} | Triangles: {1} | ACMR: {2:.3f} -> {3:.3f} | ATVR: {4:.3f} -> {5:.3f}", pair.second.GetPath(), report.m_after.m_triangleCount,
+				report.m_before.GetACMR(), report.m_after.GetACMR(), report.m_before.GetATVR(), report.m_after.GetATVR());
+		}
+
+		LINA_CLIENT_INFO("Total | Triangles: {0} | ACMR: {1:.3f} -> {2:.3f} | ATVR: {3:.3f} -> {4:.3f}", total.m_after.m_triangleCount,
+			total.m_before.GetACMR(), total.m_after.GetACMR(), total.m_before.GetATVR(), total.m_after.GetATVR());
 	}
 
 	void GUILayer::Refresh()
@@ -235,7 +235,8 @@ namespace LinaEditor
 		"SPHERE",
 		"BOX",
 		"CYLINDER",
-		"CAPSULE"
+		"CAPSULE",
+		"COMPOUND"
 	};
 
 	void ComponentDrawer::DrawTransformComponent(LinaEngine::ECS::ECSRegistry& ecs, LinaEngine::ECS::ECSEntity entity)
@@ -511,6 +512,12 @@ namespace LinaEditor
 			ImGui::SetCursorPosX(cursorPosValues);
 			ImGui::DragFloat("##mass", &rb.m_mass);
 
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Kinematic");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::Checkbox("##kinematic", &rb.m_isKinematic);
+
 			if (rb.m_collisionShape == ECS::CollisionShape::BOX || rb.m_collisionShape == ECS::CollisionShape::Cylinder)
 			{
 				ImGui::SetCursorPosX(cursorPosLabels);
@@ -541,6 +548,68 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::DragFloat("##height", &rb.m_capsuleHeight);
 			}
+			else if (rb.m_collisionShape == ECS::CollisionShape::Compound)
+			{
+				// Children are drawn with their own ids, a compound child can't be a compound.
+				for (int i = 0; i < (int)rb.m_compoundChildren.size(); i++)
+				{
+					ECS::CompoundCollisionChild& child = rb.m_compoundChildren[i];
+					int childShape = (int)child.m_collisionShape;
+					ImGui::PushID(i);
+
+					ImGui::SetCursorPosX(cursorPosLabels);
+					WidgetsUtility::AlignedText(("Child " + std::to_string(i)).c_str());
+					ImGui::SameLine();
+					ImGui::SetCursorPosX(cursorPosValues);
+					if (ImGui::Combo("##childshape", &childShape, rigidbodyShapes, IM_ARRAYSIZE(rigidbodyShapes) - 1))
+						child.m_collisionShape = (ECS::CollisionShape)childShape;
+
+					ImGui::SetCursorPosX(cursorPosLabels);
+					WidgetsUtility::AlignedText("Location");
+					ImGui::SameLine();
+					ImGui::SetCursorPosX(cursorPosValues);
+					ImGui::DragFloat3("##childlocation", &child.m_localLocation.x);
+
+					ImGui::SetCursorPosX(cursorPosLabels);
+					if (child.m_collisionShape == ECS::CollisionShape::BOX || child.m_collisionShape == ECS::CollisionShape::Cylinder)
+					{
+						WidgetsUtility::AlignedText("Half Extents");
+						ImGui::SameLine();
+						ImGui::SetCursorPosX(cursorPosValues);
+						ImGui::DragFloat3("##childhalfextents", &child.m_halfExtents.x);
+					}
+					else
+					{
+						WidgetsUtility::AlignedText("Radius");
+						ImGui::SameLine();
+						ImGui::SetCursorPosX(cursorPosValues);
+						ImGui::DragFloat("##childradius", &child.m_radius);
+
+						if (child.m_collisionShape == ECS::CollisionShape::CAPSULE)
+						{
+							ImGui::SetCursorPosX(cursorPosLabels);
+							WidgetsUtility::AlignedText("Height");
+							ImGui::SameLine();
+							ImGui::SetCursorPosX(cursorPosValues);
+							ImGui::DragFloat("##childheight", &child.m_capsuleHeight);
+						}
+					}
+
+					ImGui::SetCursorPosX(cursorPosLabels);
+					bool removeChild = ImGui::Button("Remove Child");
+					ImGui::PopID();
+
+					if (removeChild)
+					{
+						rb.m_compoundChildren.erase(rb.m_compoundChildren.begin() + i);
+						break;
+					}
+				}
+
+				ImGui::SetCursorPosX(cursorPosLabels);
+				if (ImGui::Button("Add Child"))
+					rb.m_compoundChildren.push_back(ECS::CompoundCollisionChild());
+			}
 
 			ImGui::SetCursorPosX(cursorPosLabels);
 			if (ImGui::Button("Apply"))
@@ -929,6 +998,18 @@ namespace LinaEditor
 			renderer.m_materialID = renderer.m_selectedMatID;
 			renderer.m_materialPath = renderer.m_selectedMatPath;
 
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Sorting Layer");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::DragInt("##sortingLayer", &renderer.m_sortingLayer);
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Order In Layer");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::DragInt("##orderInLayer", &renderer.m_orderInLayer);
+
 			WidgetsUtility::IncrementCursorPosY(CURSORPOS_Y_INCREMENT_AFTER);
 		}
 
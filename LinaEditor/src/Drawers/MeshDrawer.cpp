@@ -84,6 +84,36 @@ namespace LinaEditor
 		ImGui::SetCursorPosX(cursorPosValues);
 		ImGui::Checkbox("##flipWinding", &m_selectedParams.m_flipWinding);
 
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("Optimize Vertex Order");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::Checkbox("##optimizeVertexOrder", &m_selectedParams.m_optimizeVertexOrder);
+
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("Quantize Vertices");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::Checkbox("##quantizeVertices", &m_selectedParams.m_quantizeVertices);
+
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("LOD Count");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::DragInt("##lodCount", &m_selectedParams.m_lodCount, 0.1f, 0, 8);
+
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("LOD Reduction");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::DragFloat("##lodReduction", &m_selectedParams.m_lodReduction, 0.01f, 0.05f, 0.95f);
+
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("LOD Screen Size");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::DragFloat("##lodScreenSize", &m_selectedParams.m_lodScreenSize, 0.01f, 0.01f, 1.0f);
+
 		ImGui::SetCursorPosX(cursorPosLabels);
 
 		if (ImGui::Button("Apply"))
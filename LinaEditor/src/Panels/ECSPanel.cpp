@@ -44,6 +44,10 @@ namespace LinaEditor
 	{
 		LinaEngine::Application::GetEngineDispatcher().SubscribeAction<LinaEngine::World::Level*>("##ecspanel_levelinstall", LinaEngine::Action::ActionType::LevelInstalled,
 			std::bind(&ECSPanel::OnLevelInstall, this, std::placeholders::_1));
+
+		// Keep the hierarchy selection in sync with entities picked from other panels.
+		EditorApplication::GetEditorDispatcher().SubscribeAction<LinaEngine::ECS::ECSEntity>("##ecspanel_entityselected", LinaEngine::Action::ActionType::EntitySelected,
+			std::bind(&ECSPanel::OnEntitySelected, this, std::placeholders::_1));
 	}
 
 	void ECSPanel::Refresh()
@@ -110,6 +114,11 @@ namespace LinaEditor
 		m_selectedEntity = entt::null;
 	}
 
+	void ECSPanel::OnEntitySelected(LinaEngine::ECS::ECSEntity entity)
+	{
+		m_selectedEntity = entity;
+	}
+
 	void ECSPanel::Draw()
 	{
 		if (m_show)
@@ -110,6 +110,49 @@ namespace LinaEditor
 			WidgetsUtility::DrawBeveledLine();
 			WidgetsUtility::IncrementCursorPosY(6);
 
+			LinaEngine::Graphics::DynamicResolution& dynamicResolution = LinaEngine::Application::GetRenderEngine().GetDynamicResolution();
+			bool dynamicResolutionEnabled = dynamicResolution.GetEnabled();
+			float budget = dynamicResolution.GetBudget();
+			float minScale = dynamicResolution.GetMinScale();
+			float maxScale = dynamicResolution.GetMaxScale();
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Dynamic Resolution");
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Enabled");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			if (ImGui::Checkbox("##dynamicResolutionEnabled", &dynamicResolutionEnabled))
+				dynamicResolution.SetEnabled(dynamicResolutionEnabled);
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Budget (ms)");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			if (ImGui::DragFloat("##dynamicResolutionBudget", &budget, 0.1f, 1.0f, 100.0f))
+				dynamicResolution.SetBudget(budget);
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Min Scale");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			bool boundsChanged = ImGui::DragFloat("##dynamicResolutionMin", &minScale, 0.01f, 0.1f, 1.0f);
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Max Scale");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			boundsChanged |= ImGui::DragFloat("##dynamicResolutionMax", &maxScale, 0.01f, 0.1f, 1.0f);
+
+			if (boundsChanged)
+				dynamicResolution.SetScaleBounds(minScale, maxScale);
+
+			WidgetsUtility::IncrementCursorPosY(6);
+
+			WidgetsUtility::DrawBeveledLine();
+			WidgetsUtility::IncrementCursorPosY(6);
+
 			ImGui::SetCursorPosX(cursorPosLabels);
 			WidgetsUtility::AlignedText("Post FX General");
 
@@ -122,7 +122,9 @@ namespace LinaEditor
 		std::vector<MenuElement*> debug;
 		debug.emplace_back(new MenuItem(ICON_FA_BOXES, " Debug View Physics", std::bind(&HeaderPanel::DispatchMenuBarClickedAction, this, MenuBarItems::DebugViewPhysics)));
 		debug.emplace_back(new MenuItem(ICON_FA_ADJUST, " Debug View Shadows", std::bind(&HeaderPanel::DispatchMenuBarClickedAction, this, MenuBarItems::DebugViewShadows)));
+		debug.emplace_back(new MenuItem(ICON_FA_EYE_SLASH, " Debug View Occlusion", std::bind(&HeaderPanel::DispatchMenuBarClickedAction, this, MenuBarItems::DebugViewOcclusion)));
 		debug.emplace_back(new MenuItem(ICON_FA_IMAGES, " Debug View Normal", std::bind(&HeaderPanel::DispatchMenuBarClickedAction, this, MenuBarItems::DebugViewNormal)));
+		debug.emplace_back(new MenuItem(ICON_FA_CHART_BAR, " Mesh Cache Report", std::bind(&HeaderPanel::DispatchMenuBarClickedAction, this, MenuBarItems::MeshCacheReport)));
 		m_menuBarButtons.emplace_back(new MenuButton(/*ICON_FA_BUG*/ "Debug", "dbg_panel", debug, HEADER_COLOR_BG, true));
 
 		m_title = Application::GetAppWindow().GetWindowProperties().m_title;
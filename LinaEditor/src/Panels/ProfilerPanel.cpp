@@ -31,6 +31,9 @@ SOFTWARE.
 #include "Core/Application.hpp"
 #include "Core/EditorCommon.hpp"
 #include "Core/Timer.hpp"
+#include "Core/JobSystem.hpp"
+#include "Rendering/RenderEngine.hpp"
+#include "Physics/PhysicsEngine.hpp"
 #include "imgui/imgui.h"
 #include "imgui/implot/implot.h"
 
@@ -64,11 +67,35 @@ namespace LinaEditor
 
 	std::map<std::string, std::string> m_timerMSStorage;
 
+	ProfilerPanel::~ProfilerPanel()
+	{
+		// The benchmark job writes into the panel, let it finish.
+		if (m_physicsBenchmarkJob.valid())
+			LinaEngine::JobSystem::Get().Wait(m_physicsBenchmarkJob);
+	}
+
 	void ProfilerPanel::Setup()
 	{
 
 	}
 
+	template<typename Benchmark, typename Result, typename DrawResult>
+	void ProfilerPanel::DrawBenchmark(const char* label, std::vector<Result>& results, DrawResult drawResult)
+	{
+		WidgetsUtility::IncrementCursorPosX(12);
+		if (ImGui::Button(label))
+		{
+			results = Benchmark::Run();
+			Benchmark::LogResults(results);
+		}
+
+		for (const Result& result : results)
+		{
+			WidgetsUtility::IncrementCursorPosX(12);
+			drawResult(result);
+		}
+	}
+
 	void ProfilerPanel::Draw()
 	{
 		if (m_show)
@@ -103,11 +130,115 @@ namespace LinaEditor
 					m_timerMSStorage[it->first] = std::to_string(it->second->GetDuration());
 
 				WidgetsUtility::IncrementCursorPosX(12);
-				ImGui::Text(txt.c_str());
+				ImGui::TextUnformatted(txt.c_str());
 			}
 
 			displayMS = false;
 
+			// Culling stats.
+			const LinaEngine::ECS::MeshRendererSystem::CullingStats& cullingStats = LinaEngine::Application::GetRenderEngine().GetMeshRendererSystem()->GetCullingStats();
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Graphics] Visible Meshes %u", cullingStats.m_visible);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Graphics] Culled Meshes %u", cullingStats.m_culled);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Graphics] Occluded Meshes %u", cullingStats.m_occluded);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Graphics] Occluders %u (%u triangles)", cullingStats.m_occluders, cullingStats.m_occluderTriangles);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Graphics] Mesh Draw Calls %u (%u indirect draws)", cullingStats.m_drawCalls, cullingStats.m_indirectDraws);
+
+			// Known occluder & boxes against the software occlusion buffer, run on demand.
+			DrawBenchmark<LinaEngine::Graphics::OcclusionBufferCheck>("Run Occlusion Check", m_occlusionCheckResults, [](const LinaEngine::Graphics::OcclusionBufferCheckResult& result)
+			{
+				ImGui::Text("[Occlusion Check] %s: %s", result.m_passed ? "Passed" : "Failed", result.m_name.c_str());
+			});
+
+			// Dynamic resolution stats, GPU time is a few frames late.
+			LinaEngine::Graphics::RenderEngine& renderEngine = LinaEngine::Application::GetRenderEngine();
+			const LinaEngine::Graphics::DynamicResolutionStats& resolutionStats = renderEngine.GetDynamicResolution().GetStats();
+			const LinaEngine::Vector2 renderSize = renderEngine.GetScaledRenderSize();
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Graphics] Render Scale %.2f (%dx%d, target %.2f)", resolutionStats.m_scale, (int)renderSize.x, (int)renderSize.y, resolutionStats.m_targetScale);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Graphics] Frame Budget %.2f ms (headroom %.2f ms)", resolutionStats.m_budgetMS, resolutionStats.m_headroomMS);
+			WidgetsUtility::IncrementCursorPosX(12);
+			if (resolutionStats.m_hasGPUTime)
+				ImGui::Text("[Graphics] CPU %.2f ms, GPU %.2f ms%s", resolutionStats.m_cpuTimeMS, resolutionStats.m_gpuTimeMS, resolutionStats.m_isCPUBound ? " (CPU bound)" : "");
+			else
+				ImGui::Text("[Graphics] CPU %.2f ms, GPU n/a", resolutionStats.m_cpuTimeMS);
+
+			// Sort-key render queue build & sort against the per material map batching, run on demand.
+			DrawBenchmark<LinaEngine::Graphics::RenderQueueBenchmark>("Run Render Queue Benchmark", m_renderQueueBenchmarkResults, [](const LinaEngine::Graphics::RenderQueueBenchmarkResult& result)
+			{
+				ImGui::Text("[Render Queue] %u draws, map %.3f + %.3f ms, queue %.3f + %.3f ms", (uint32)result.m_drawCount, result.m_mapBuildMS, result.m_mapFlushMS, result.m_queueBuildMS, result.m_queueSortMS);
+			});
+
+			// Scene BVH build, refit & query throughput at 1M primitives.
+			DrawBenchmark<LinaEngine::BVHBenchmark>("Run BVH Benchmark", m_bvhBenchmarkResults, [](const LinaEngine::BVHBenchmarkResult& result)
+			{
+				ImGui::Text("[BVH] %s %u items %.3f ms (%.1f ns per item)", result.m_operation.c_str(), result.m_count, result.m_ms, result.m_nsPerItem);
+			});
+
+			// Batch math kernels against the per element glm path, run on demand.
+			DrawBenchmark<LinaEngine::MathBenchmark>("Run Math Benchmark", m_mathBenchmarkResults, [](const LinaEngine::MathBenchmarkResult& result)
+			{
+				std::string txt = "[Math] " + result.m_kernel + " glm " + std::to_string(result.m_glmMS) + " ms";
+
+				for (int level = 0; level < MATHBENCHMARK_LEVEL_COUNT; level++)
+				{
+					if (result.m_batchMS[level] >= 0.0)
+						txt += std::string(", ") + LinaEngine::MathBatch::GetLevelName((LinaEngine::SIMDLevel)level) + " " + std::to_string(result.m_batchMS[level]) + " ms";
+				}
+
+				ImGui::TextUnformatted(txt.c_str());
+			});
+
+			// Velocity integration over 1M entities, per entity glm against the wide types.
+			DrawBenchmark<LinaEngine::ECS::MotionBenchmark>("Run Motion Benchmark", m_motionBenchmarkResults, [](const LinaEngine::ECS::MotionBenchmarkResult& result)
+			{
+				ImGui::Text("[Motion] %s %.3f ms (%.2f ns per entity)", result.m_variant.c_str(), result.m_ms, result.m_nsPerEntity);
+			});
+
+			// Physics step times of a 10k body pile against the thread count.
+			LinaEngine::Physics::PhysicsEngine& physicsEngine = LinaEngine::Application::GetPhysicsEngine();
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("[Physics] %s world, %d of %d threads", physicsEngine.GetMultithreaded() ? "Multithreaded" : "Single threaded", physicsEngine.GetThreadCount(), physicsEngine.GetMaxThreadCount());
+
+			if (!LinaEngine::Physics::PhysicsTaskScheduler::IsBulletThreadSafe())
+			{
+				WidgetsUtility::IncrementCursorPosX(12);
+				ImGui::TextUnformatted("[Physics] Bullet libraries are built without BT_THREADSAFE, only the single threaded world runs.");
+			}
+
+			WidgetsUtility::IncrementCursorPosX(12);
+
+			// The benchmark steps its own worlds for seconds, it runs on a worker & the results are picked up once it is done.
+			if (m_physicsBenchmarkJob.valid())
+			{
+				if (m_physicsBenchmarkJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+				{
+					m_physicsBenchmarkJob.get();
+					m_physicsBenchmarkResults = std::move(m_pendingPhysicsBenchmarkResults);
+					LinaEngine::Physics::PhysicsBenchmark::LogResults(m_physicsBenchmarkResults);
+				}
+				else
+					ImGui::TextUnformatted("[Physics] Benchmark running...");
+			}
+			else if (ImGui::Button("Run Physics Benchmark"))
+			{
+				m_physicsBenchmarkJob = LinaEngine::JobSystem::Get().Submit([this]()
+				{
+					m_pendingPhysicsBenchmarkResults = LinaEngine::Physics::PhysicsBenchmark::Run();
+				});
+			}
+
+			for (const LinaEngine::Physics::PhysicsBenchmarkResult& result : m_physicsBenchmarkResults)
+			{
+				WidgetsUtility::IncrementCursorPosX(12);
+				ImGui::Text("[Physics] %s %d threads %.3f ms (max %.3f ms)", result.m_world.c_str(), result.m_threadCount, result.m_averageStepMS, result.m_maxStepMS);
+			}
+
 			WidgetsUtility::IncrementCursorPosX(12);
 			WidgetsUtility::IncrementCursorPosY(12);
 
@@ -33,6 +33,8 @@ SOFTWARE.
 #include "Widgets/WidgetsUtility.hpp"
 #include "ECS/Components/CameraComponent.hpp"
 #include "ECS/Components/TransformComponent.hpp"
+#include "ECS/Systems/MeshRendererSystem.hpp"
+#include "Utility/Math/Ray.hpp"
 #include "Core/EditorApplication.hpp"
 #include "Input/InputEngine.hpp"
 #include "Core/Application.hpp"
@@ -126,6 +128,8 @@ namespace LinaEditor
 					ImGui::GetWindowDrawList()->AddImage((void*)renderEngine.GetFinalImage(), imageRectMin, imageRectMax, ImVec2(0, 1), ImVec2(1, 0));
 				else if (m_drawMode == DrawMode::ShadowMap)
 					ImGui::GetWindowDrawList()->AddImage((void*)renderEngine.GetShadowMapImage(), imageRectMin, imageRectMax, ImVec2(0, 1), ImVec2(1, 0));
+				else if (m_drawMode == DrawMode::OcclusionBuffer)
+					ImGui::GetWindowDrawList()->AddImage((void*)renderEngine.GetOcclusionBufferImage(), imageRectMin, imageRectMax, ImVec2(0, 1), ImVec2(1, 0));
 
 
 				ImGuiIO& io = ImGui::GetIO();
@@ -137,6 +141,7 @@ namespace LinaEditor
 
 				ProcessInput();
 				DrawGizmos();
+				ProcessPicking(Vector2(imageRectMin.x, imageRectMin.y), Vector2(imageRectMax.x, imageRectMax.y));
 
 				ImGui::EndChild();
 
@@ -199,5 +204,39 @@ namespace LinaEditor
 
 	}
 
+	void ScenePanel::ProcessPicking(const Vector2& imageRectMin, const Vector2& imageRectMax)
+	{
+		// Clicks on the gizmo belong to the gizmo.
+		if (!ImGui::IsMouseClicked(ImGuiMouseButton_Left) || !ImGui::IsWindowHovered() || ImGuizmo::IsOver() || ImGuizmo::IsUsing())
+			return;
+
+		ImVec2 mousePos = ImGui::GetMousePos();
+		if (mousePos.x < imageRectMin.x || mousePos.y < imageRectMin.y || mousePos.x > imageRectMax.x || mousePos.y > imageRectMax.y)
+			return;
+
+		LinaEngine::Graphics::RenderEngine& renderEngine = LinaEngine::Application::GetRenderEngine();
+		Matrix& view = renderEngine.GetCameraSystem()->GetViewMatrix();
+		Matrix& projection = renderEngine.GetCameraSystem()->GetProjectionMatrix();
+
+		// Unproject the mouse position on the near & far planes to build the picking ray.
+		const float ndcX = (mousePos.x - imageRectMin.x) / (imageRectMax.x - imageRectMin.x) * 2.0f - 1.0f;
+		const float ndcY = 1.0f - (mousePos.y - imageRectMin.y) / (imageRectMax.y - imageRectMin.y) * 2.0f;
+		const Matrix inverseViewProjection = Matrix(projection * view).Inverse();
+		glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+		glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+		const glm::vec3 rayStart = glm::vec3(nearPoint) / nearPoint.w;
+		const glm::vec3 rayEnd = glm::vec3(farPoint) / farPoint.w;
+		const float rayLength = glm::length(rayEnd - rayStart);
+
+		if (rayLength <= 0.0f) return;
+
+		LinaEngine::ECS::ECSEntity entity;
+		float distance = 0.0f;
+		LinaEngine::Ray ray(rayStart, (rayEnd - rayStart) / rayLength);
+
+		if (renderEngine.GetMeshRendererSystem()->RayCast(ray, rayLength, entity, distance))
+			EditorApplication::GetEditorDispatcher().DispatchAction<LinaEngine::ECS::ECSEntity>(LinaEngine::Action::ActionType::EntitySelected, entity);
+	}
+
 
 }
\ No newline at end of file
@@ -17,15 +17,18 @@
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
+#include <../Instancing.glh>
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoords;
-layout (location = 2) in mat4 model;
-layout (location = 6) in mat4 inverseTransposeModel;
+layout (location = 2) in vec4 modelRow0;
+layout (location = 3) in vec4 modelRow1;
+layout (location = 4) in vec4 modelRow2;
 out vec2 TexCoords;
 out vec3 FragPos;
 
 void main()
 {
+	mat4 model = InstanceModel(modelRow0, modelRow1, modelRow2);
 	gl_Position = projection * view * model * vec4(position, 1.0);
 	FragPos = vec3(model * vec4(position,1.0));
 	TexCoords = texCoords;
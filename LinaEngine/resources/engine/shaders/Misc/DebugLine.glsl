@@ -18,22 +18,21 @@
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
 layout (location = 0) in vec3 position;
+layout (location = 1) in vec4 color;
+out vec4 Color;
 
 void main()
 {
+  Color = color;
   gl_Position = projection * view * vec4(position, 1.0);
 }
 
 #elif defined(FS_BUILD)
+in vec4 Color;
 out vec4 fragColor;
-struct Material
-{
-  vec3 color;
-};
-uniform Material material;
 
 void main()
 {
-   fragColor = vec4(material.color.x, material.color.y, material.color.z, 1);
+   fragColor = Color;
 }
 #endif
@@ -17,25 +17,30 @@
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
-layout (location = 0) in vec3 position;
+#include <../Instancing.glh>
+#include <../VertexDecode.glh>
+layout (location = 0) in vec4 position;
 layout (location = 1) in vec2 texCoords;
 layout (location = 2) in vec3 normal;
 layout (location = 3) in vec3 tangent;
 layout (location = 4) in vec3 biTangent;
-layout (location = 5) in mat4 model;
-layout (location = 9) in mat4 inverseTransposeModel;
+layout (location = 5) in vec4 modelRow0;
+layout (location = 6) in vec4 modelRow1;
+layout (location = 7) in vec4 modelRow2;
 out vec2 TexCoords;
 out vec3 WorldPos;
 out vec3 Normal;
-out vec4 FragPosLightSpace;
+out float ViewDepth;
 
 void main()
 {
+    mat4 model = InstanceModel(modelRow0, modelRow1, modelRow2);
     TexCoords = texCoords;
-    WorldPos = vec3(model * vec4(position, 1.0));
-    Normal = mat3(model) * normal;
-	FragPosLightSpace = lightSpace* vec4(WorldPos, 1.0);
-    gl_Position =  projection * view * vec4(WorldPos, 1.0);
+    WorldPos = vec3(model * vec4(DecodePosition(position), 1.0));
+    Normal = InstanceNormalMatrix(model) * DecodeNormal(normal);
+    vec4 viewPos = view * vec4(WorldPos, 1.0);
+    ViewDepth = viewPos.z;
+    gl_Position =  projection * viewPos;
 }
 
 #elif defined(FS_BUILD)
@@ -50,7 +55,7 @@ layout (location = 1) out vec4 brightColor;
 in vec2 TexCoords;
 in vec3 WorldPos;
 in vec3 Normal;
-in vec4 FragPosLightSpace;
+in float ViewDepth;
 
 struct Material
 {
@@ -82,7 +87,7 @@ void main()
   float roughness = material.roughnessMap.isActive  ? (texture(material.roughnessMap.texture, tiled).r * material.roughness) : material.roughness;
   float ao = material.aoMap.isActive? texture(material.aoMap.texture, tiled).r : 1.0;
 
-  vec3 N = material.normalMap.isActive ? getNormalFromMap(texture(material.normalMap.texture, tiled).rgb, tiled, WorldPos, Normal) : Normal;
+  vec3 N = material.normalMap.isActive ? getNormalFromMap(texture(material.normalMap.texture, tiled).rgb, tiled, WorldPos, Normal) : normalize(Normal);
   vec3 V = normalize(vec3(cameraPosition.x, cameraPosition.y, cameraPosition.z) - WorldPos);
 
 
@@ -95,41 +100,37 @@ void main()
     vec3 Lo = vec3(0.0);       	
     // Directional Light
     {
-      vec3 L = -directionalLight.direction;
-      vec3 radiance = directionalLight.color;
+      vec3 L = -dirLightDirection.xyz;
+      vec3 radiance = dirLightColor.rgb * GetCascadedShadow(WorldPos, normalize(Normal), ViewDepth);
       Lo += CalculateLight(N, V, L, albedo, metallic, roughness, radiance, F0);
     }
 
-    // Point lights.
-    for(int i = 0; i < pointLightCount; ++i)
+    // Point & spot lights of this fragment's cluster.
+    uvec2 cluster = GetLightCluster(gl_FragCoord.xy, ViewDepth);
+    for(uint i = 0u; i < cluster.y; ++i)
     {
-        // calculate per-light radiance
-        vec3 L = normalize(pointLights[i].position - WorldPos);
-        float distance = length(pointLights[i].position - WorldPos);
-        float attenuation = 1.0 / (distance * distance);
-        vec3 radiance = pointLights[i].color * attenuation;
-        Lo += CalculateLight(N, V, L, albedo, metallic, roughness, radiance, F0);
-    }
+      int lightIndex = int(texelFetch(lightClusterIndices, int(cluster.x + i)).r);
+      ClusterLight light = GetClusterLight(lightIndex);
 
-    // Spot lights
-    for(int i = 0; i < spotLightCount; ++i)
-    {
       // calculate per-light radiance
-      vec3 L = normalize(spotLights[i].position - WorldPos);
-      float distance = length(spotLights[i].position - WorldPos);
-      float attenuation = 1.0 / (distance * distance);
+      vec3 L = normalize(light.position - WorldPos);
+      float distance = length(light.position - WorldPos);
+      vec3 radiance = light.color * GetLightAttenuation(distance, light.range);
 
-      float theta = dot(L, normalize(-spotLights[i].direction));
-      float epsilon = (spotLights[i].cutOff - spotLights[i].outerCutOff);
-      float intensity = clamp((theta - spotLights[i].outerCutOff) / epsilon, 0.0, 1.0);
-      vec3 radiance = spotLights[i].color * attenuation * intensity;
+      if(lightIndex >= pointLightCount)
+      {
+        float theta = dot(L, normalize(-light.direction));
+        float epsilon = (light.cutOff - light.outerCutOff);
+        radiance *= clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+      }
 
       Lo += CalculateLight(N, V, L, albedo, metallic, roughness, radiance, F0);
     }
 
     vec3 ambient = vec3(0.0);
 
-    bool irrActive = material.irradianceMap.isActive;
+    bool shActive = iblParams.x > 0.5;
+    bool irrActive = material.irradianceMap.isActive || shActive;
     bool preActive = material.prefilterMap.isActive;
     bool lutActive = material.brdfLUTMap.isActive;
 
@@ -143,7 +144,7 @@ void main()
       vec3 kD = 1.0 - kS;
       kD *= 1.0 - metallic;
 	  
-      vec3 irradiance = texture(material.irradianceMap.texture, N).rgb;
+      vec3 irradiance = shActive ? GetIrradianceSH(N) : texture(material.irradianceMap.texture, N).rgb;
       vec3 diffuse = irradiance * albedo;
 
       // sample both the pre-filter map and the BRDF lut and combine them together as per the Split-Sum approximation to get the IBL specular part.
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2019 Inan Evin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+
+#if defined(VS_BUILD)
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texCoords;
+out vec2 TexCoords;
+
+void main()
+{
+    gl_Position = vec4(position.x, position.y, 0.0, 1.0);
+    TexCoords = texCoords;
+}
+
+#elif defined(FS_BUILD)
+#include <../MaterialSamplers.glh>
+out vec4 fragColor;
+in vec2 TexCoords;
+
+struct Material
+{
+  MaterialSampler2D screenMap;
+  bool karisAverage;
+  float renderScale;
+};
+uniform Material material;
+
+// Only the scaled region of the source was rendered, taps are kept inside it.
+vec3 Sample(vec2 offset, vec2 texelSize)
+{
+  vec2 uv = clamp(TexCoords * material.renderScale + offset * texelSize, texelSize * 0.5, vec2(material.renderScale) - texelSize * 0.5);
+  return texture(material.screenMap.texture, uv).rgb;
+}
+
+// Weights a box by its inverse luma, keeps single bright texels from flickering.
+float KarisWeight(vec3 color)
+{
+  return 1.0 / (1.0 + dot(color, vec3(0.2126, 0.7152, 0.0722)));
+}
+
+void main()
+{
+  // 13 taps around the destination texel, source is twice the destination size.
+  vec2 texelSize = 1.0 / textureSize(material.screenMap.texture, 0);
+  vec3 a = Sample(vec2(-2.0, 2.0), texelSize);
+  vec3 b = Sample(vec2(0.0, 2.0), texelSize);
+  vec3 c = Sample(vec2(2.0, 2.0), texelSize);
+  vec3 d = Sample(vec2(-2.0, 0.0), texelSize);
+  vec3 e = Sample(vec2(0.0, 0.0), texelSize);
+  vec3 f = Sample(vec2(2.0, 0.0), texelSize);
+  vec3 g = Sample(vec2(-2.0, -2.0), texelSize);
+  vec3 h = Sample(vec2(0.0, -2.0), texelSize);
+  vec3 i = Sample(vec2(2.0, -2.0), texelSize);
+  vec3 j = Sample(vec2(-1.0, 1.0), texelSize);
+  vec3 k = Sample(vec2(1.0, 1.0), texelSize);
+  vec3 l = Sample(vec2(-1.0, -1.0), texelSize);
+  vec3 m = Sample(vec2(1.0, -1.0), texelSize);
+
+  // Five overlapping boxes, the center one counts half.
+  vec3 center = (j + k + l + m) * 0.25;
+  vec3 topLeft = (a + b + d + e) * 0.25;
+  vec3 topRight = (b + c + e + f) * 0.25;
+  vec3 bottomLeft = (d + e + g + h) * 0.25;
+  vec3 bottomRight = (e + f + h + i) * 0.25;
+
+  vec3 result;
+  if(material.karisAverage)
+  {
+    float wc = KarisWeight(center) * 0.5;
+    float wtl = KarisWeight(topLeft) * 0.125;
+    float wtr = KarisWeight(topRight) * 0.125;
+    float wbl = KarisWeight(bottomLeft) * 0.125;
+    float wbr = KarisWeight(bottomRight) * 0.125;
+    result = (center * wc + topLeft * wtl + topRight * wtr + bottomLeft * wbl + bottomRight * wbr) / (wc + wtl + wtr + wbl + wbr);
+  }
+  else
+    result = center * 0.5 + (topLeft + topRight + bottomLeft + bottomRight) * 0.125;
+
+  fragColor = vec4(max(result, vec3(0.0)), 1.0);
+}
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019 Inan Evin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+
+#if defined(VS_BUILD)
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texCoords;
+out vec2 TexCoords;
+
+void main()
+{
+    gl_Position = vec4(position.x, position.y, 0.0, 1.0);
+    TexCoords = texCoords;
+}
+
+#elif defined(FS_BUILD)
+#include <../MaterialSamplers.glh>
+out vec4 fragColor;
+in vec2 TexCoords;
+
+struct Material
+{
+  MaterialSampler2D screenMap;
+  MaterialSampler2D bloomMap;
+  float renderScale;
+};
+uniform Material material;
+
+// Only the scaled region of the source was rendered, taps are kept inside it.
+vec3 Sample(vec2 offset, vec2 texelSize)
+{
+  vec2 uv = clamp(TexCoords * material.renderScale + offset * texelSize, texelSize * 0.5, vec2(material.renderScale) - texelSize * 0.5);
+  return texture(material.screenMap.texture, uv).rgb;
+}
+
+void main()
+{
+  // 3x3 tent over the lower level, screen map is half the destination size.
+  vec2 texelSize = 1.0 / textureSize(material.screenMap.texture, 0);
+  vec3 result = Sample(vec2(0.0, 0.0), texelSize) * 4.0;
+  result += (Sample(vec2(-1.0, 0.0), texelSize) + Sample(vec2(1.0, 0.0), texelSize) + Sample(vec2(0.0, -1.0), texelSize) + Sample(vec2(0.0, 1.0), texelSize)) * 2.0;
+  result += Sample(vec2(-1.0, -1.0), texelSize) + Sample(vec2(1.0, -1.0), texelSize) + Sample(vec2(-1.0, 1.0), texelSize) + Sample(vec2(1.0, 1.0), texelSize);
+  result /= 16.0;
+
+  // Blend with this level's downsample, wider levels fade out geometrically.
+  vec3 level = texture(material.bloomMap.texture, TexCoords * material.renderScale).rgb;
+  fragColor = vec4(mix(level, result, 0.5), 1.0);
+}
+#endif
@@ -45,9 +45,55 @@ struct Material
   float fxaaReduceMin;
   float fxaaReduceMul;
   float gamma;
+  float renderScale;
 };
 uniform Material material;
 
+// Scene & bloom only cover the bottom left renderScale region of their targets, taps are kept inside it.
+vec3 SampleScene(vec2 uv)
+{
+  vec2 halfTexel = material.inverseScreenMapSize.xy * 0.5;
+  return texture(material.screenMap.texture, clamp(uv, halfTexel, vec2(material.renderScale) - halfTexel)).rgb;
+}
+
+vec3 SampleBloom(vec2 uv, vec2 texelSize)
+{
+  return texture(material.bloomMap.texture, clamp(uv, texelSize * 0.5, vec2(material.renderScale) - texelSize * 0.5)).rgb;
+}
+
+// Catmull-Rom upscale of the scene from 9 bilinear taps, sharper than a plain bilinear fetch.
+vec3 SampleSceneCatmullRom(vec2 uv)
+{
+  vec2 texSize = 1.0 / material.inverseScreenMapSize.xy;
+  vec2 samplePos = uv * texSize;
+  vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+  vec2 f = samplePos - texPos1;
+
+  vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+  vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+  vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+  vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+  // Middle weights are folded into a single bilinear tap.
+  vec2 w12 = w1 + w2;
+  vec2 texPos0 = (texPos1 - 1.0) * material.inverseScreenMapSize.xy;
+  vec2 texPos3 = (texPos1 + 2.0) * material.inverseScreenMapSize.xy;
+  vec2 texPos12 = (texPos1 + w2 / w12) * material.inverseScreenMapSize.xy;
+
+  vec3 result = SampleScene(vec2(texPos0.x, texPos0.y)) * w0.x * w0.y;
+  result += SampleScene(vec2(texPos12.x, texPos0.y)) * w12.x * w0.y;
+  result += SampleScene(vec2(texPos3.x, texPos0.y)) * w3.x * w0.y;
+  result += SampleScene(vec2(texPos0.x, texPos12.y)) * w0.x * w12.y;
+  result += SampleScene(vec2(texPos12.x, texPos12.y)) * w12.x * w12.y;
+  result += SampleScene(vec2(texPos3.x, texPos12.y)) * w3.x * w12.y;
+  result += SampleScene(vec2(texPos0.x, texPos3.y)) * w0.x * w3.y;
+  result += SampleScene(vec2(texPos12.x, texPos3.y)) * w12.x * w3.y;
+  result += SampleScene(vec2(texPos3.x, texPos3.y)) * w3.x * w3.y;
+
+  // Negative lobes can ring below zero around bright edges.
+  return max(result, vec3(0.0));
+}
+
 float move(float x)
 	{
 		return abs(1.0 - mod(abs(x), 2.0)) * 5 - (5);
@@ -58,7 +104,8 @@ void main()
   if(material.screenMap.isActive)
   {
 
-    vec3 hdrColor = texture(material.screenMap.texture, TexCoords).rgb;
+    vec2 sceneUV = TexCoords * material.renderScale;
+    vec3 hdrColor = material.renderScale < 1.0 ? SampleSceneCatmullRom(sceneUV) : SampleScene(sceneUV);
 
     if(material.fxaaEnabled)
     {
@@ -68,11 +115,11 @@ void main()
 
       // Get lumas
       vec3 luma = vec3(0.299, 0.587, 0.114);
-      float lumaTL = dot(luma, texture(material.screenMap.texture, TexCoords.xy + vec2(-1.0, -1.0) * tcOffset).xyz);
-      float lumaTR = dot(luma, texture(material.screenMap.texture, TexCoords.xy + vec2(1.0, -1.0) * tcOffset).xyz);
-      float lumaBL = dot(luma, texture(material.screenMap.texture, TexCoords.xy + vec2(-1.0, 1.0) * tcOffset).xyz);
-      float lumaBR = dot(luma, texture(material.screenMap.texture, TexCoords.xy + vec2(1.0, 1.0) * tcOffset).xyz);
-      float lumaM = dot(luma, texture(material.screenMap.texture, TexCoords.xy).xyz);
+      float lumaTL = dot(luma, SampleScene(sceneUV + vec2(-1.0, -1.0) * tcOffset));
+      float lumaTR = dot(luma, SampleScene(sceneUV + vec2(1.0, -1.0) * tcOffset));
+      float lumaBL = dot(luma, SampleScene(sceneUV + vec2(-1.0, 1.0) * tcOffset));
+      float lumaBR = dot(luma, SampleScene(sceneUV + vec2(1.0, 1.0) * tcOffset));
+      float lumaM = dot(luma, SampleScene(sceneUV));
 
 
       // If pixel is edge, we'll have some magnitude in blurDirection vector.
@@ -86,12 +133,12 @@ void main()
       blurDirection = min(vec2(material.fxaaSpanMax), max(vec2(-material.fxaaSpanMax), blurDirection * inverseDirAdj)) * tcOffset;
 
       vec3 result1 = (1.0 / 2.0) * (
-        texture(material.screenMap.texture, TexCoords.xy + (blurDirection * vec2(1.0/3.0 - 0.5))).xyz +
-        texture(material.screenMap.texture, TexCoords.xy + (blurDirection * vec2(2.0/3.0 - 0.5))).xyz);
+        SampleScene(sceneUV + (blurDirection * vec2(1.0/3.0 - 0.5))) +
+        SampleScene(sceneUV + (blurDirection * vec2(2.0/3.0 - 0.5))));
 
       vec3 result2 = result1  * (1.0/2.0) + (1.0 / 4.0) * (
-        texture(material.screenMap.texture, TexCoords.xy + (blurDirection * vec2(0.0/3.0 - 0.5))).xyz +
-        texture(material.screenMap.texture, TexCoords.xy + (blurDirection * vec2(3.0/3.0 - 0.5))).xyz);
+        SampleScene(sceneUV + (blurDirection * vec2(0.0/3.0 - 0.5))) +
+        SampleScene(sceneUV + (blurDirection * vec2(3.0/3.0 - 0.5))));
 
       // Test if we've sampled too far.
       float lumaMin = min(lumaM, min(min(lumaTL, lumaTR), min(lumaBL, lumaBR)));
@@ -100,9 +147,17 @@ void main()
       hdrColor = (lumaResult2 < lumaMin || lumaResult2 > lumaMax) ? result1 : result2;
     }
 
-    // Add bloom.
+    // Add bloom, the last upsample of the mip chain is tent filtered here.
     if(material.bloomEnabled && material.bloomMap.isActive)
-      hdrColor += texture(material.bloomMap.texture, TexCoords).rgb;
+    {
+      vec2 bloomTexel = 1.0 / textureSize(material.bloomMap.texture, 0);
+      vec3 bloom = SampleBloom(sceneUV, bloomTexel) * 4.0;
+      bloom += (SampleBloom(sceneUV + vec2(-bloomTexel.x, 0.0), bloomTexel) + SampleBloom(sceneUV + vec2(bloomTexel.x, 0.0), bloomTexel)) * 2.0;
+      bloom += (SampleBloom(sceneUV + vec2(0.0, -bloomTexel.y), bloomTexel) + SampleBloom(sceneUV + vec2(0.0, bloomTexel.y), bloomTexel)) * 2.0;
+      bloom += SampleBloom(sceneUV - bloomTexel, bloomTexel) + SampleBloom(sceneUV + bloomTexel, bloomTexel);
+      bloom += SampleBloom(sceneUV + vec2(-bloomTexel.x, bloomTexel.y), bloomTexel) + SampleBloom(sceneUV + vec2(bloomTexel.x, -bloomTexel.y), bloomTexel);
+      hdrColor += bloom / 16.0;
+    }
 
     // Add outline
     if(material.outlineMap.isActive)
@@ -17,13 +17,21 @@
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
-layout (location = 0) in vec3 position;
+#include <../Instancing.glh>
+#include <../VertexDecode.glh>
+layout (location = 0) in vec4 position;
 layout (location = 1) in vec2 texCoords;
-layout (location = 5) in mat4 model;
+layout (location = 5) in vec4 modelRow0;
+layout (location = 6) in vec4 modelRow1;
+layout (location = 7) in vec4 modelRow2;
+
+// Light view projection of the cascade being drawn.
+uniform mat4 uf_lightViewProjection;
 
 void main()
 {
-    gl_Position = lightSpace * model * vec4(position, 1.0);
+    mat4 model = InstanceModel(modelRow0, modelRow1, modelRow2);
+    gl_Position = uf_lightViewProjection * model * vec4(DecodePosition(position), 1.0);
 }
 
 #elif defined(FS_BUILD)
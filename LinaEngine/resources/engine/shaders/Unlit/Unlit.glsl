@@ -17,20 +17,25 @@
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
-layout (location = 0) in vec3 position;
+#include <../Instancing.glh>
+#include <../VertexDecode.glh>
+layout (location = 0) in vec4 position;
 layout (location = 1) in vec2 texCoords;
 layout (location = 2) in vec3 normal;
 layout (location = 3) in vec3 tangent;
 layout (location = 4) in vec3 biTangent;
-layout (location = 5) in mat4 model;
-layout (location = 9) in mat4 inverseTransposeModel;
+layout (location = 5) in vec4 modelRow0;
+layout (location = 6) in vec4 modelRow1;
+layout (location = 7) in vec4 modelRow2;
 out vec2 TexCoords;
 out vec3 FragPos;
 
 void main()
 {
-  gl_Position = projection * view * model * vec4(position, 1.0);
-  FragPos = vec3(model * vec4(position,1.0));
+  mat4 model = InstanceModel(modelRow0, modelRow1, modelRow2);
+  vec3 localPos = DecodePosition(position);
+  gl_Position = projection * view * model * vec4(localPos, 1.0);
+  FragPos = vec3(model * vec4(localPos, 1.0));
   TexCoords = texCoords;
 }
 
@@ -205,6 +205,10 @@ namespace LinaEngine
 
 			LINA_TIMER_STOP("[Core] Main Pipeline");
 
+			// Occluders are rasterized on a worker while the physics steps, the test is skipped for frames where any of them moved.
+			if (m_canRender && m_activeLevelExists)
+				s_renderEngine->KickOcclusionCulling();
+
 			accumulator += deltaTime;
 
 			while (accumulator >= PHYSICS_DELTA)
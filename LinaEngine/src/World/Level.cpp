@@ -40,11 +40,19 @@ SOFTWARE.
 #include <cereal/archives/json.hpp>
 #include <cereal/archives/xml.hpp>
 #include <stdio.h>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 
+// Written in front of the registry snapshot, snapshots without it are older than the rigidbody versioning.
+#define LEVEL_SNAPSHOT_MAGIC 0x4C4E5353
+#define LEVEL_SNAPSHOT_VERSION 1
 
 namespace LinaEngine::World
 {
+	// GLOBALS DECLARATIONS
+	static bool LoadRegistrySnapshot(LinaEngine::ECS::ECSRegistry& registry, const std::string& data, const LinaEngine::ECS::RigidbodyLayout* legacyLayout);
+
 	bool Level::Install(bool loadFromFile, const std::string& path, const std::string& levelName)
 	{
 		if (loadFromFile)
@@ -147,6 +155,7 @@ namespace LinaEngine::World
 		std::ofstream registrySnapshotStream(path + "/" + levelName + "_ecsSnapshot.linasnapshot");
 		{
 			cereal::BinaryOutputArchive oarchive(registrySnapshotStream); // Create an output archive
+			oarchive(std::uint32_t(LEVEL_SNAPSHOT_MAGIC), std::uint32_t(LEVEL_SNAPSHOT_VERSION));
 			LinaEngine::Application::GetApp().SerializeRegistry(registry, oarchive);
 		}
 
@@ -172,15 +181,78 @@ namespace LinaEngine::World
 
 		}
 
-		registry.clear();
-
 		std::ifstream regSnapshotStream(path + "/" + levelName + "_ecsSnapshot.linasnapshot");
+		std::stringstream snapshot;
+		snapshot << regSnapshotStream.rdbuf();
+		const std::string snapshotData = snapshot.str();
+
+		std::uint32_t magic = 0, version = 0;
+		if (snapshotData.size() >= sizeof(magic) + sizeof(version))
+		{
+			std::memcpy(&magic, snapshotData.data(), sizeof(magic));
+			std::memcpy(&version, snapshotData.data() + sizeof(magic), sizeof(version));
+		}
+
+		if (magic == LEVEL_SNAPSHOT_MAGIC)
+		{
+			if (version != LEVEL_SNAPSHOT_VERSION || !LoadRegistrySnapshot(registry, snapshotData.substr(sizeof(magic) + sizeof(version)), nullptr))
+			{
+				LINA_CORE_ERR("[Level] -> Snapshot of {0} couldn't be read.", levelName);
+				registry.clear();
+			}
+		}
+		else
 		{
-			cereal::BinaryInputArchive iarchive(regSnapshotStream);
-			LinaEngine::Application::GetApp().DeserializeRegistry(registry, iarchive);
+			// Snapshots without the header store rigidbodies with one of the older layouts, first versioned but
+			// headerless ones, then the untagged ones from the newest to the oldest, until one reads the whole file.
+			const LinaEngine::ECS::RigidbodyLayout legacyLayouts[] = { LinaEngine::ECS::RigidbodyLayout::Kinematic, LinaEngine::ECS::RigidbodyLayout::CompoundChildren, LinaEngine::ECS::RigidbodyLayout::Base };
+			bool loaded = LoadRegistrySnapshot(registry, snapshotData, nullptr);
+
+			for (const LinaEngine::ECS::RigidbodyLayout& layout : legacyLayouts)
+			{
+				if (loaded) break;
+				loaded = LoadRegistrySnapshot(registry, snapshotData, &layout);
+			}
+
+			if (loaded)
+			{
+				LINA_CORE_WARN("[Level] -> {0} has an outdated snapshot, save the level again to update it.", levelName);
+			}
+			else
+			{
+				LINA_CORE_ERR("[Level] -> Snapshot of {0} couldn't be read.", levelName);
+				registry.clear();
+			}
 		}
 
 		registry.Refresh();
 
 	}
+
+	bool LoadRegistrySnapshot(LinaEngine::ECS::ECSRegistry& registry, const std::string& data, const LinaEngine::ECS::RigidbodyLayout* legacyLayout)
+	{
+		registry.clear();
+		std::istringstream stream(data);
+
+		try
+		{
+			if (legacyLayout == nullptr)
+			{
+				cereal::BinaryInputArchive iarchive(stream);
+				LinaEngine::Application::GetApp().DeserializeRegistry(registry, iarchive);
+			}
+			else
+			{
+				LinaEngine::ECS::RigidbodyLegacyInputArchive iarchive(stream, *legacyLayout);
+				LinaEngine::Application::GetApp().DeserializeRegistry(registry, iarchive);
+			}
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+
+		// A wrong layout either throws or leaves bytes behind.
+		return stream.peek() == std::char_traits<char>::eof();
+	}
 }
\ No newline at end of file
@@ -49,6 +49,10 @@ namespace LinaEngine::ECS
 		int m_selectedMatID = -1;
 		std::string m_selectedMatPath = "";
 
+		// Draw order for the sprite batcher, runtime only for now to keep existing level data loadable.
+		int m_sortingLayer = 0;
+		int m_orderInLayer = 0;
+
 		template<class Archive>
 		void serialize(Archive& archive)
 		{
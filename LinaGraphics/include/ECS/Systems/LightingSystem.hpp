@@ -46,6 +46,7 @@ Timestamp: 5/13/2019 12:49:19 AM
 #include "ECS/Components/TransformComponent.hpp"
 #include "ECS/Components/LightComponent.hpp"
 #include "PackageManager/PAMRenderDevice.hpp"
+#include "Rendering/LightClusterGrid.hpp"
 
 
 namespace LinaEngine
@@ -64,22 +65,22 @@ namespace LinaEngine::ECS
 
 		LightingSystem() {};
 
-		void Construct(ECSRegistry& registry, RenderDevice& rdIn, Graphics::RenderEngine& renderEngineIn)
-		{
-			BaseECSSystem::Construct(registry);
-			s_renderDevice = &rdIn;
-			m_renderEngine = &renderEngineIn;
-		}
+		void Construct(ECSRegistry& registry, RenderDevice& rdIn, Graphics::RenderEngine& renderEngineIn);
 
 		DirectionalLightComponent* GetDirLight() { return std::get<1>(m_directionalLight); }
 		virtual void UpdateComponents(float delta) override;
-		void SetLightingShaderData(uint32 shaderID);
-		void ResetLightData();
+		void UpdateLightClusters(const Matrix& view, const Matrix& projection, float zNear, float zFar);
+		void SetLightingShaderData(uint32 shaderID, Graphics::RenderCommandBuffer& commands);
 		Matrix GetDirectionalLightMatrix();
 		Matrix GetDirLightBiasMatrix();
 		std::vector<Matrix> GetPointLightMatrices();
 		Color& GetAmbientColor() { return m_ambientColor; }
 		const Vector3& GetDirectionalLightPos();
+		Vector3 GetDirectionalLightDirection();
+		Color GetDirectionalLightColor();
+		int GetPointLightCount() const { return m_clusterGrid.GetPointLightCount(); }
+		int GetSpotLightCount() const { return m_clusterGrid.GetSpotLightCount(); }
+		const Graphics::LightClusterGrid& GetClusterGrid() const { return m_clusterGrid; }
 
 	private:
 
@@ -89,6 +90,7 @@ namespace LinaEngine::ECS
 		std::vector<std::tuple<TransformComponent*, PointLightComponent*>> m_pointLights;
 		std::vector<std::tuple<TransformComponent*, SpotLightComponent*>> m_spotLights;
 		Color m_ambientColor = Color(0.0f, 0.0f, 0.0f);
+		Graphics::LightClusterGrid m_clusterGrid;
 	};
 }
 
@@ -45,7 +45,13 @@ Timestamp: 4/27/2019 5:38:44 PM
 #include "Rendering/RenderingCommon.hpp"
 #include "Rendering/RenderTarget.hpp"
 #include "Rendering/VertexArray.hpp"
-#include <queue>
+#include "Rendering/RenderQueue.hpp"
+#include "Rendering/RenderCommandBuffer.hpp"
+#include "Rendering/OcclusionBuffer.hpp"
+#include "Utility/Math/Frustum.hpp"
+#include "Utility/Math/BVH.hpp"
+#include <unordered_map>
+#include <future>
 
 namespace LinaEngine
 {
@@ -53,19 +59,7 @@ namespace LinaEngine
 	{
 		class RenderEngine;
 		class Material;
-
-		struct BatchDrawData
-		{
-			Graphics::VertexArray* m_vertexArray;
-			Graphics::Material* m_material;
-			float m_distance;
-		};
-
-		struct BatchModelData
-		{
-			std::vector<Matrix> m_models;
-			std::vector<Matrix> m_inverseTransposeModels;
-		};
+		class Mesh;
 	}
 }
 
@@ -76,29 +70,52 @@ namespace LinaEngine::ECS
 
 	class MeshRendererSystem : public BaseECSSystem
 	{
+		struct CullCandidate
+		{
+			Graphics::VertexArray* m_vertexArray = nullptr;
+			Graphics::Material* m_material = nullptr;
+			const AABB* m_localBounds = nullptr;
+			Matrix m_model;
+		};
 
-	public:
-
-		typedef std::tuple<Graphics::BatchDrawData, Graphics::BatchModelData>  BatchPair;
+		struct SceneProxy
+		{
+			ECSEntity m_entity = entt::null;
+			Graphics::Mesh* m_mesh = nullptr;
+			Graphics::Material* m_material = nullptr;
+			Matrix m_model;
+			uint32 m_frame = 0;
+			uint32 m_changeFrame = 0;
+			uint32 m_lod = 0;
+			uint32 m_shadowLOD = 0;
+		};
 
-		struct BatchComparison
+		struct Occluder
 		{
-			bool const operator()(const BatchPair& lhs, const BatchPair& rhs) const
-			{
-				
-				return std::get<0>(lhs).m_distance < std::get<0>(rhs).m_distance;
-			}
+			ECSEntity m_entity = entt::null;
+			uint32 m_proxy = 0;
+			Graphics::Mesh* m_mesh = nullptr;
+			Matrix m_model;
+			float m_screenSize = 0.0f;
 		};
 
-		struct BatchDrawDataComp
+	public:
+
+		struct CullingStats
 		{
-			bool const operator()(const Graphics::BatchDrawData& lhs, const Graphics::BatchDrawData& rhs) const
-			{
-				return std::tie(lhs.m_vertexArray, lhs.m_material) < std::tie(rhs.m_vertexArray, rhs.m_material);
-			}
+			uint32 m_visible = 0;
+			uint32 m_culled = 0;
+			uint32 m_occluded = 0;
+			uint32 m_occluders = 0;
+			uint32 m_occluderTriangles = 0;
+			uint32 m_staticShadowCasters = 0;
+			uint32 m_dynamicShadowCasters = 0;
+			uint32 m_drawCalls = 0;
+			uint32 m_indirectDraws = 0;
 		};
 
 		MeshRendererSystem() {};
+		~MeshRendererSystem();
 
 		void Construct(ECSRegistry& registry, Graphics::RenderEngine& renderEngineIn, RenderDevice& renderDeviceIn)
 		{
@@ -107,23 +124,103 @@ namespace LinaEngine::ECS
 			s_renderDevice = &renderDeviceIn;
 		}
 
-		void RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn);
-		void RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn, float priority);
-		void FlushOpaque(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
-		void FlushTransparent(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
-	
+		void RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn, float normalizedDepth = 0.0f);
+		void RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn, float normalizedDepth);
+
+		// Sorts the queues & splits the opaque batches into at most maxChunks ranges, returns the chunk count.
+		uint32 PrepareRecording(uint32 maxChunks);
+
+		// Records an opaque chunk or the transparent queue, chunks may be recorded from different threads at the same time.
+		void RecordOpaque(Graphics::RenderCommandBuffer& commands, uint32 chunk, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr);
+		void RecordTransparent(Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr);
+
+		// Clears the queues once every chunk is recorded.
+		void FinishRecording();
+
+		// Counts the draws recorded into the buffer, called on the submitting thread.
+		void AddDrawStats(const Graphics::RenderCommandBuffer& commands);
+
 		virtual void UpdateComponents(float delta) override;
 
+		// Draws the renderer right away, outside of the queues.
 		void FlushSingleRenderer(MeshRendererComponent& mrc, TransformComponent& transform, Graphics::DrawParams drawParams);
 
+		void SetFrustumCullingEnabled(bool enabled) { m_frustumCullingEnabled = enabled; }
+		bool GetFrustumCullingEnabled() const { return m_frustumCullingEnabled; }
+		const CullingStats& GetCullingStats() const { return m_cullingStats; }
+
+		// Picks the largest renderers on screen as occluders & rasterizes them on a worker, results are used by the next update.
+		void KickOcclusionCulling();
+		void SetOcclusionCullingEnabled(bool enabled) { m_occlusionCullingEnabled = enabled; }
+		bool GetOcclusionCullingEnabled() const { return m_occlusionCullingEnabled; }
+		const Graphics::OcclusionBuffer& GetOcclusionBuffer();
+
+		// Finds the closest renderer hit by the world space ray, tested against the mesh triangles.
+		bool RayCast(const Ray& ray, float maxDistance, ECSEntity& entity, float& distance) const;
+
+		// Collects the renderers whose world bounds overlap the box.
+		void QueryOverlaps(const AABB& box, std::vector<ECSEntity>& entities) const;
+
+		const BVH& GetSceneBVH() const { return m_sceneBVH; }
+
+		// Culls the renderers against the light frustum & records either the static or the moving ones with the shadow material.
+		void DrawShadowCasters(const Matrix& lightViewProjection, bool staticCasters, const Graphics::DrawParams& drawParams, Graphics::Material& shadowMaterial, Graphics::RenderCommandBuffer& commands);
+
+		// Changes whenever a renderer joins or leaves the static set, cached static shadows are stale after that.
+		uint32 GetStaticCasterVersion() const { return m_staticCasterVersion; }
+
+	private:
+
+		void RecordQueue(Graphics::RenderQueue& queue, Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, size_t firstBatch, size_t lastBatch);
+		void UpdateSceneProxy(ECSEntity entity, Graphics::Mesh& mesh, Graphics::Material& material, const Matrix& model);
+		void AddCullCandidates(const SceneProxy& proxy, uint32 lod);
+		void SelectLOD(SceneProxy& proxy, const Vector3& cameraLocation, float projectionScale);
+		bool IsStaticCaster(const SceneProxy& proxy) const;
+		void RasterizeOccluders();
+		void WaitOcclusionCulling();
+
+		// True if every occluder is still drawn with the transform it was rasterized with.
+		bool AreOccludersUnchanged() const;
+
 	private:
 
 		RenderDevice* s_renderDevice = nullptr;
 		Graphics::RenderEngine* m_renderEngine = nullptr;
 
-		// Map & queue to see the list of same vertex array & textures to compress them into single draw call.
-		std::map<Graphics::BatchDrawData, Graphics::BatchModelData, BatchDrawDataComp> m_opaqueRenderBatch;
-		std::priority_queue<BatchPair, std::vector<BatchPair>, BatchComparison> m_transparentRenderBatch;
+		// Sort-key queues, same vertex array & material runs are compressed into single instanced draw calls.
+		Graphics::RenderQueue m_opaqueQueue;
+		Graphics::RenderQueue m_transparentQueue;
+		Graphics::RenderQueue m_shadowQueue;
+
+		// First batch of every opaque chunk, the last entry is the batch count.
+		std::vector<size_t> m_opaqueChunks;
+		Graphics::RenderCommandBuffer m_singleCommands;
+
+		// Per frame culling data, world bounding spheres are tested in batches before the candidates are queued.
+		std::vector<CullCandidate> m_cullCandidates;
+		std::vector<Vector4> m_cullSpheres;
+		std::vector<uint8> m_cullResults;
+		CullingStats m_cullingStats;
+		bool m_frustumCullingEnabled = true;
+
+		// Renderers are tracked in a scene BVH, indexed by proxy. Proxies of renderers that weren't seen in a frame are destroyed.
+		BVH m_sceneBVH;
+		std::unordered_map<ECSEntity, uint32> m_entityProxies;
+		std::vector<SceneProxy> m_sceneProxies;
+		std::vector<uint32> m_visibleProxies;
+		std::vector<SceneProxy> m_unboundedRenderers;
+		uint32 m_frame = 0;
+
+		// Renderers that haven't changed for a while are static shadow casters.
+		std::vector<uint32> m_shadowProxies;
+		uint32 m_staticCasterVersion = 0;
+
+		// Software occlusion, the buffer is only touched by the worker while the future is valid.
+		Graphics::OcclusionBuffer m_occlusionBuffer;
+		std::vector<Occluder> m_occluders;
+		std::future<void> m_occlusionFuture;
+		bool m_occlusionCullingEnabled = true;
+		bool m_occlusionReady = false;
 	};
 }
 
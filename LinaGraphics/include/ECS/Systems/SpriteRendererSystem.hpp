@@ -30,7 +30,8 @@ SOFTWARE.
 Class: SpriteRendererSystem
 
 Responsible for adding all the sprite renderers into a pool which is then
-flushed to draw those renderers' data by the RenderEngine.
+flushed to draw those renderers' data by the RenderEngine. Sprites using the standard sprite
+shader are atlased & streamed as transformed quads, sorted by layer, drawn in one call per atlas page.
 
 Timestamp: 10/1/2020 9:27:40 AM
 */
@@ -43,7 +44,13 @@ Timestamp: 10/1/2020 9:27:40 AM
 #include "ECS/ECSSystem.hpp"
 #include "PackageManager/PAMRenderDevice.hpp"
 #include "Rendering/VertexArray.hpp"
+#include "Rendering/RenderCommandBuffer.hpp"
 #include "Rendering/IndexedModel.hpp"
+#include "Rendering/TextureAtlas.hpp"
+#include "Rendering/Material.hpp"
+
+#define SPRITEBATCH_MAX_SPRITES_PER_DRAW 16384
+#define SPRITEBATCH_MAX_SPRITES (1 << 24)
 
 namespace LinaEngine
 {
@@ -61,20 +68,42 @@ namespace LinaEngine::ECS
 
 		struct BatchModelData
 		{
-			std::vector<Matrix> m_models;
-			std::vector<Matrix> m_inverseTransposeModels;
+			std::vector<Graphics::InstanceTransform> m_instances;
+		};
+
+		struct SpriteBatch
+		{
+			uint32 m_page = 0;
+			uint32 m_firstSprite = 0;
+			uint32 m_spriteCount = 0;
 		};
 
 	public:
 		
 		SpriteRendererSystem() {};
-		~SpriteRendererSystem() {};
+		~SpriteRendererSystem();
 	
 		void Construct(ECSRegistry& registry, Graphics::RenderEngine& renderEngineIn, RenderDevice& renderDeviceIn);
 		virtual void UpdateComponents(float delta) override;
 
+		// Adds the sprite to the streaming batcher, falls back to instancing if the material or its texture can't be atlased.
+		void RenderSprite(Graphics::Material& material, const Matrix& transformIn, int sortingLayer = 0, int orderInLayer = 0);
 		void Render(Graphics::Material& material, const Matrix& transformIn);
-		void Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
+
+		// Sorts the batched sprites, called on the main thread before the sprites are recorded.
+		void PrepareRecording();
+
+		// Records the sprite draws into the command buffer, safe to run on a worker.
+		void Record(Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
+
+		Graphics::TextureAtlas& GetTextureAtlas() { return m_atlas; }
+		uint32 GetBatchedSpriteCount() const { return (uint32)m_sortKeys.size(); }
+		uint32 GetBatchDrawCount() const { return (uint32)m_spriteBatches.size(); }
+
+	private:
+
+		void BuildSpriteBatches();
+		void RecordSpriteBatches(Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams);
 
 	private:
 	
@@ -83,6 +112,19 @@ namespace LinaEngine::ECS
 		RenderDevice* s_renderDevice = nullptr;
 		Graphics::RenderEngine* m_renderEngine = nullptr;
 		std::map<Graphics::Material*, BatchModelData> m_renderBatch;
+
+		// Streaming batcher.
+		Graphics::TextureAtlas m_atlas;
+		Graphics::Material m_batchMaterial;
+		uint32 m_spriteShaderID = 0;
+		uint32 m_batchVertexArray = 0;
+		uint32 m_streamBuffer = 0;
+		uintptr m_streamBufferSize = 0;
+		std::vector<uint64> m_sortKeys;
+		std::vector<Graphics::SpriteVertex> m_vertices;
+		std::vector<Graphics::SpriteVertex> m_sortedVertices;
+		std::vector<SpriteBatch> m_spriteBatches;
+		bool m_spriteBatchesBuilt = true;
 	};
 }
 
@@ -161,6 +161,34 @@ namespace LinaEngine::Graphics
 			return params;
 		}
 
+		static DrawParams GetDebugLines()
+		{
+			// Debug lines are tested against the scene but don't write depth.
+			DrawParams params;
+			params.skipParameters = false;
+			params.useScissorTest = false;
+			params.useDepthTest = true;
+			params.useStencilTest = false;
+			params.primitiveType = PrimitiveType::PRIMITIVE_LINES;
+			params.faceCulling = FaceCulling::FACE_CULL_NONE;
+			params.sourceBlend = BlendFunc::BLEND_FUNC_SRC_ALPHA;
+			params.destBlend = BlendFunc::BLEND_FUNC_ONE_MINUS_SRC_ALPHA;
+			params.shouldWriteDepth = false;
+			params.depthFunc = DrawFunc::DRAW_FUNC_LEQUAL;
+			params.stencilFunc = DrawFunc::DRAW_FUNC_ALWAYS;
+			params.stencilComparisonVal = 1;
+			params.stencilTestMask = 0xFF;
+			params.stencilWriteMask = 0x00;
+			params.stencilFail = StencilOp::STENCIL_KEEP;
+			params.stencilPass = StencilOp::STENCIL_KEEP;
+			params.stencilPassButDepthFail = StencilOp::STENCIL_KEEP;
+			params.scissorStartX = 0;
+			params.scissorStartY = 0;
+			params.scissorWidth = 0;
+			params.scissorHeight = 0;
+			return params;
+		}
+
 		static DrawParams GetGUILayer() 
 		{
 			DrawParams params;
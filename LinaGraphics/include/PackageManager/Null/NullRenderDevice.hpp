@@ -0,0 +1,248 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: NullRenderDevice
+
+Render device without a graphics API behind it, used to benchmark & test the CPU side of rendering on
+machines without a GPU. Hands out fake handles, validates their usage & records the commands into a
+stream that can be replayed against the GL device. Selected with LINA_GRAPHICS_NULL.
+
+Timestamp: 10/19/2026 9:41:07 PM
+*/
+
+#pragma once
+
+#ifndef NullRenderDevice_HPP
+#define NullRenderDevice_HPP
+
+#include "Utility/Math/Matrix.hpp"
+#include "Utility/Math/Color.hpp"
+#include "Rendering/RenderingCommon.hpp"
+#include "PackageManager/Null/RenderCommandStream.hpp"
+#include <map>
+#include <set>
+#include <unordered_map>
+
+using namespace LinaEngine;
+
+namespace LinaEngine::Graphics
+{
+	enum class NullResourceType : uint8
+	{
+		Texture = 0,
+		VertexArray = 1,
+		Sampler = 2,
+		Buffer = 3,
+		Shader = 4,
+		RenderTarget = 5,
+		RenderBuffer = 6,
+		Query = 7
+	};
+
+	// Bookkeeping of a fake handle, enough to validate the commands using it.
+	struct NullResource
+	{
+		NullResourceType m_type = NullResourceType::Texture;
+		uintptr m_size = 0;
+		uint32 m_numVertices = 0;
+		uint32 m_numIndices = 0;
+		uint32 m_numBuffers = 0;
+		uint32 m_instanceComponentsStartIndex = 0;
+		std::vector<uint32> m_elementSizes;
+	};
+
+	// Uniforms declared in the shader text, there is no compiler to ask.
+	struct NullShaderProgram
+	{
+		std::set<std::string> m_uniforms;
+		ShaderUniformData m_uniformData;
+	};
+
+	class NullRenderDevice
+	{
+	public:
+
+		NullRenderDevice();
+		~NullRenderDevice();
+
+		void Initialize(int width, int height, DrawParams& defaultParams);
+
+		uint32 CreateTexture2D(Vector2 size, const void* data,  SamplerParameters samplerParams ,bool compress, bool useBorder = false, Color borderColor = Color::White);
+		uint32 CreateTextureHDRI(Vector2 size, float* data, SamplerParameters samplerParams);
+		uint32 CreateCubemapTexture(Vector2 size, SamplerParameters samplerParams, const std::vector<int32*>& data, uint32 dataSize = 6);
+		uint32 CreateCubemapTextureEmpty(Vector2 size, SamplerParameters samplerParams);
+		uint32 CreateTexture2DMSAA(Vector2 size, SamplerParameters samplerParams, int sampleCount);
+		uint32 CreateTexture2DEmpty(Vector2 size, SamplerParameters samplerParams);
+		void UpdateTexture2D(uint32 texture, Vector2 size, const void* data, PixelFormat pixelFormat);
+		void UpdateTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, Vector2 size, const uint16* data, PixelFormat pixelFormat);
+		bool ReadTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, uint16* data, PixelFormat pixelFormat);
+		
+		void SetupTextureParameters(uint32 textureTarget, SamplerParameters samplerParams, bool useBorder = false, float* borderColor = NULL);
+		void UpdateTextureParameters(uint32 bindMode, uint32 id, SamplerParameters samplerParmas);
+	
+		uint32 ReleaseTexture2D(uint32 texture2D);
+		uint32 CreateTextureBuffer(PixelFormat internalPixelFormat, uint32& buffer);
+		void UpdateTextureBuffer(uint32 buffer, const void* data, uintptr dataSize);
+		uint32 ReleaseTextureBuffer(uint32 texture, uint32 buffer);
+		uint32 CreateVertexArray(const float** vertexData, const uint32* vertexElementSizes, const uint32* vertexElementTypes, uint32 numVertexComponents, uint32 numInstanceComponents, uint32 numVertices, const uint32* indices, uint32 numIndices, BufferUsage bufferUsage);
+		uint32 CreateSkyboxVertexArray();
+		uint32 CreateScreenQuadVertexArray();
+		uint32 CreateLineVertexArray();
+		uint32 CreateSpriteBatchVertexArray(uint32 maxSprites);
+		uint32 CreateHDRICubeVertexArray();
+		uint32 ReleaseVertexArray(uint32 vao, bool checkMap = true);
+		uint32 CreateSampler(SamplerParameters samplerParams);
+		uint32 ReleaseSampler(uint32 sampler);
+		uint32 CreateUniformBuffer(const void* data, uintptr dataSize, BufferUsage usage);
+		uint32 ReleaseUniformBuffer(uint32 buffer);
+		uint32 CreateRingBuffer(uintptr size, void** persistentData);
+		uint32 ReleaseRingBuffer(uint32 buffer, bool persistent);
+		void OrphanRingBuffer(uint32 buffer, uintptr size);
+		void WriteRingBuffer(uint32 buffer, uintptr offset, const void* data, uintptr dataSize);
+		void* CreateFence();
+		void WaitFence(void* fence);
+		void ReleaseFence(void* fence);
+		uint32 CreateTimerQuery();
+		uint32 ReleaseTimerQuery(uint32 query);
+		void BeginTimerQuery(uint32 query);
+		void EndTimerQuery();
+		bool GetTimerQueryResult(uint32 query, uint64* elapsedNS);
+		bool SupportsPersistentMapping() { return false; }
+		bool SupportsMultiDrawIndirect() { return true; }
+		uint32 GetUniformBufferOffsetAlignment() { return 256; }
+		uint32 CreateShaderProgram(const std::string& shaderText, ShaderUniformData* data, bool usesGeometryShader);
+		bool ValidateShaderProgram(uint32 shader);
+	
+		uint32 ReleaseShaderProgram(uint32 shader);
+		uint32 CreateRenderTarget(uint32 texture, int32 width, int32 height, TextureBindMode bindTextureMode, FrameBufferAttachment attachment, uint32 attachmentNumber, uint32 mipLevel, bool noReadWrite, bool bindRBO = false, FrameBufferAttachment rboAtt = FrameBufferAttachment::ATTACHMENT_DEPTH_AND_STENCIL, uint32 rbo = 0, bool errorCheck = true);
+		
+		void BindTextureToRenderTarget(uint32 fbo, uint32 texture,TextureBindMode bindTextureMode, FrameBufferAttachment attachment, uint32 attachmentNumber, uint32 textureAttachmentNumber = 0, int mipLevel = 0, bool bindTexture = true, bool setDefaultFBO = true);
+		void MultipleDrawBuffersCommand(uint32 fbo, uint32 bufferCount, uint32* attachments);
+		void ResizeRTTexture(uint32 texture, Vector2 newSize, PixelFormat m_internalPixelFormat, PixelFormat m_pixelFormat, TextureBindMode bindMode = TextureBindMode::BINDTEXTURE_TEXTURE2D, bool compress = false);
+		void ResizeRenderBuffer(uint32 fbo, uint32 rbo, Vector2 newSize, RenderBufferStorage storage);
+		
+		uint32 ReleaseRenderTarget(uint32 target);
+		uint32 CreateRenderBufferObject(RenderBufferStorage storage, uint32 width, uint32 height, int sampleCount);
+		uint32 ReleaseRenderBufferObject(uint32 target);
+		
+		void UpdateSamplerParameters(uint32 sampler, SamplerParameters params);
+		void GenerateTextureMipmaps(uint32 texture, TextureBindMode bindMode);
+		void BlitFrameBuffers(uint32 readFBO, uint32 readWidth, uint32 readHeight, uint32 writeFBO, uint32 writeWidth, uint32 writeHeight, BufferBit mask, SamplerFilter filter);
+		bool IsRenderTargetComplete(uint32 fbo);
+		void CopyTextureRegion(uint32 srcTexture, Vector2 srcPos, Vector2 srcSize, uint32 dstTexture, Vector2 dstPos, Vector2 dstSize);
+		void UpdateVertexArray(uint32 vao, uint32 bufferIndex, const void* data, uintptr dataSize);
+		void SetVertexArrayInstanceBuffer(uint32 vao, uint32 bufferIndex, uint32 buffer, uintptr offset);
+		void UpdateVertexArrayRange(uint32 vao, const float** vertexData, uint32 firstVertex, uint32 numVertices, const uint32* indices, uint32 firstIndex, uint32 numIndices);
+		void SetSpriteBatchVertexSource(uint32 vao, uint32 buffer, uintptr offset);
+		void SetLineVertexSource(uint32 vao, uint32 buffer, uintptr offset);
+		void SetShader(uint32 shader);
+		void SetTexture(uint32 texture, uint32 sampler, uint32 unit, TextureBindMode bindTextureMode = TextureBindMode::BINDTEXTURE_TEXTURE2D, bool setSampler = false);
+		void SetShaderUniformBuffer(uint32 shader, const std::string& uniformBufferName, uint32 buffer);
+		void BindUniformBuffer(uint32 buffer, uint32 bindingPoint);
+		void BindUniformBufferRange(uint32 buffer, uint32 bindingPoint, uintptr offset, uintptr dataSize);
+		void BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName);
+		void UpdateVertexArrayBuffer(uint32 vao, uint32 bufferIndex, const void* data, uintptr dataSize);
+		void UpdateUniformBuffer(uint32 buffer, const void* data, uintptr offset, uintptr dataSize);
+		void UpdateUniformBuffer(uint32 buffer, const void* data, uintptr dataSize);
+		ShaderUniformData ScanShaderUniforms(uint32 shader);
+
+		void SetDrawParameters(const DrawParams& drawParams);
+		void Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays = false);
+		void DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex);
+		void DrawInstancedBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, uint32 firstIndex, uint32 baseVertex);
+		void MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, uint32 indirectBuffer, uintptr offset, uint32 drawCount);
+		void DrawLines(uint32 vao, const DrawParams& drawParams, uint32 firstVertex, uint32 numVertices, float width);
+		void Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const class Color& color, uint32 stencil);
+
+		bool HasShaderUniform(uint32 shader, const std::string& uniform);
+		void UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, const float f);
+		void UpdateShaderUniformInt(uint32 shader, const std::string& uniform, const int f);
+		void UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& color);
+		void UpdateShaderUniformVector2(uint32 shader, const std::string& uniform, const Vector2& m);
+		void UpdateShaderUniformVector3(uint32 shader, const std::string& uniform, const Vector3& m);
+		void UpdateShaderUniformVector4F(uint32 shader, const std::string& uniform, const Vector4& m);
+		void UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, const Matrix& m);
+		void UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, void* data);
+
+		void SetStencilWriteMask(uint32 mask);
+		void SetDepthTestEnable(bool enable);
+		void SetFBO(uint32 fbo);
+		void SetVAO(uint32 vao);
+		void CaptureHDRILightingData(Matrix& view, Matrix& projection, Vector2 captureSize, uint32 cubeMapTexture, uint32 hdrTexture, uint32 fbo, uint32 rbo, uint32 shader);
+		void SetViewport(Vector2 pos, Vector2 size);
+
+		// Closes the frame, the statistics of the frame are available until the next one is closed.
+		void EndFrame();
+
+		// Frame commands are only recorded while enabled, resource commands always are.
+		void SetRecording(bool recording) { m_commandStream.SetRecording(recording); }
+		bool GetIsRecording() const { return m_commandStream.GetIsRecording(); }
+
+		RenderCommandStream& GetCommandStream() { return m_commandStream; }
+		const RenderDeviceFrameStats& GetFrameStats() const { return m_lastFrameStats; }
+		const RenderDeviceFrameStats& GetCurrentFrameStats() const { return m_frameStats; }
+
+	private:
+
+		// Counts the command, returns whether it should be recorded.
+		bool BeginCommand(RenderCommandType type, uintptr dataSize = 0);
+		uint32 CreateResource(NullResourceType type, uintptr size = 0);
+		uint32 ReleaseResource(uint32 handle, NullResourceType type, const char* command);
+		NullResource* GetResource(uint32 handle, NullResourceType type, const char* command);
+		bool CheckResource(uint32 handle, NullResourceType type, const char* command, bool allowNull = true);
+		bool CheckBufferRange(uint32 buffer, uintptr offset, uintptr dataSize, const char* command);
+		bool CheckUniform(uint32 shader, const std::string& uniform, const char* command);
+		void CheckDraw(uint32 vao, uint32 numElements, const char* command);
+		void TrackVertexArrayBind(uint32 vao);
+		void CountDraw(uint32 numInstances, uint32 numElements);
+		void ReportError(const char* command, const char* message, const std::string& detail = "");
+
+	private:
+
+		RenderCommandStream m_commandStream;
+		RenderDeviceFrameStats m_frameStats;
+		RenderDeviceFrameStats m_lastFrameStats;
+
+		std::unordered_map<uint32, NullResource> m_resources;
+		std::map<uint32, NullShaderProgram> m_shaderPrograms;
+		std::set<void*> m_fences;
+		std::set<std::string> m_reportedErrors;
+		uint32 m_nextHandle = 1;
+		uintptr m_nextFence = 1;
+
+		// Bound state, binds are only counted when they change like on the GL device.
+		uint32 m_boundShader = 0;
+		uint32 m_boundVAO = 0;
+		uint32 m_boundFBO = 0;
+		Vector2 m_boundViewportPos;
+		Vector2 m_boundViewportSize;
+	};
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: NullWindow
+
+Window without a native window or graphics context behind it, pairs with the NullRenderDevice so the
+engine can run headless. Keeps the window properties & reports time from the system clock.
+Selected with LINA_GRAPHICS_NULL.
+
+Timestamp: 10/20/2026 11:12:36 AM
+*/
+
+#pragma once
+
+#ifndef NullWindow_HPP
+#define NullWindow_HPP
+
+#include "Rendering/RenderingCommon.hpp"
+#include "Rendering/Window.hpp"
+#include <chrono>
+
+namespace LinaEngine::Graphics
+{
+	class NullWindow : public Window
+	{
+	public:
+
+		NullWindow();
+		~NullWindow();
+
+		// Stores the properties, no native window or context is created.
+		bool CreateContext(WindowProperties propsIn) override;
+
+		// Called every frame.
+		void Tick() override {};
+
+		// There is no native window.
+		virtual void* GetNativeWindow() const override { return nullptr; }
+
+		// Returns the time since the context was created.
+		virtual double GetTime() override;
+
+		// Resizes the window & notifies the listeners like a native resize would.
+		virtual void SetSize(const Vector2& newSize) override;
+
+		virtual void SetPos(const Vector2& newPos) override;
+		virtual void SetPosCentered(const Vector2 newPos) override;
+		virtual void Iconify() override;
+		virtual void Maximize() override;
+
+		// Closes the application.
+		virtual void Close() override;
+
+	private:
+
+		std::chrono::steady_clock::time_point m_startTime;
+	};
+}
+
+
+#endif
@@ -0,0 +1,178 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderCommandStream
+
+Commands recorded by the null render device. Each command keeps a copy of its arguments & data in a
+replay function, so the stream can be played back against the GL device for debugging. Resource commands
+are always kept so any recorded frame can be replayed, frame commands only while recording is enabled.
+
+Timestamp: 10/19/2026 9:58:21 PM
+*/
+
+#pragma once
+
+#ifndef RenderCommandStream_HPP
+#define RenderCommandStream_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	class GLRenderDevice;
+
+	// Resource commands come first, everything from SetDrawParameters on belongs to a frame. Texture sub uploads &
+	// geometry pool ranges fill resources later frames keep using, they are resource commands too.
+	enum class RenderCommandType : uint8
+	{
+		Initialize = 0,
+		CreateTexture,
+		UpdateTextureParameters,
+		ReleaseTexture,
+		UpdateTexture,
+		CreateVertexArray,
+		ReleaseVertexArray,
+		UpdateGeometry,
+		CreateSampler,
+		UpdateSampler,
+		ReleaseSampler,
+		CreateBuffer,
+		ReleaseBuffer,
+		CreateShader,
+		ReleaseShader,
+		CreateRenderTarget,
+		UpdateRenderTarget,
+		ReleaseRenderTarget,
+		CreateRenderBuffer,
+		ReleaseRenderBuffer,
+		CreateFence,
+		ReleaseFence,
+		CreateQuery,
+		ReleaseQuery,
+		SetDrawParameters,
+		SetShader,
+		SetTexture,
+		SetFrameBuffer,
+		SetVertexArray,
+		SetViewport,
+		SetState,
+		BindBuffer,
+		UpdateBuffer,
+		UpdateUniform,
+		Draw,
+		Clear,
+		Copy,
+		WaitFence,
+		Query,
+		Count
+	};
+
+	// Fake handles of the recorded device mapped to the ones created during a replay.
+	struct RenderReplayContext
+	{
+		uint32 Get(uint32 handle) const;
+		void* GetFence(void* fence) const;
+
+		std::unordered_map<uint32, uint32> m_handles;
+		std::unordered_map<void*, void*> m_fences;
+	};
+
+	typedef std::function<void(GLRenderDevice&, RenderReplayContext&)> RenderReplayFunction;
+
+	struct RenderCommand
+	{
+		RenderCommandType m_type = RenderCommandType::Count;
+		uint32 m_frame = 0;
+		uintptr m_dataSize = 0;
+		RenderReplayFunction m_replay;
+	};
+
+	struct RenderDeviceFrameStats
+	{
+		uint32 m_frame = 0;
+		uint32 m_commands = 0;
+		uint32 m_drawCalls = 0;
+		uint32 m_indirectDraws = 0;
+		uint32 m_instances = 0;
+		uint32 m_elements = 0;
+		uint32 m_shaderBinds = 0;
+		uint32 m_vertexArrayBinds = 0;
+		uint32 m_textureBinds = 0;
+		uint32 m_frameBufferBinds = 0;
+		uint32 m_bufferBinds = 0;
+		uint32 m_uniformUpdates = 0;
+		uint32 m_validationErrors = 0;
+		uintptr m_uploadedBytes = 0;
+		uint32 m_commandCounts[(uint32)RenderCommandType::Count] = { 0 };
+	};
+
+	class RenderCommandStream
+	{
+
+	public:
+
+		RenderCommandStream() {};
+		~RenderCommandStream() {};
+
+		static bool IsResourceCommand(RenderCommandType type) { return type < RenderCommandType::SetDrawParameters; }
+
+		// Adds the command if it is a resource command or recording is enabled.
+		void Record(RenderCommandType type, uintptr dataSize, const RenderReplayFunction& replay);
+
+		// Closes the current frame, statistics are kept for the recorded frames.
+		void EndFrame(const RenderDeviceFrameStats& stats);
+
+		// Drops the frame commands & statistics, resource commands are kept for later replays.
+		void ClearFrames();
+
+		// Plays every command back in order.
+		void Replay(GLRenderDevice& device) const;
+
+		// Plays the resource commands up to the end of the frame back, then the commands of the frame.
+		void ReplayFrame(GLRenderDevice& device, uint32 frame) const;
+
+		void SetRecording(bool recording) { m_isRecording = recording; }
+		bool GetIsRecording() const { return m_isRecording; }
+		uint32 GetFrame() const { return m_frame; }
+		const std::vector<RenderCommand>& GetCommands() const { return m_commands; }
+		const std::vector<RenderDeviceFrameStats>& GetFrameStats() const { return m_frameStats; }
+
+	private:
+
+		std::vector<RenderCommand> m_commands;
+		std::vector<RenderDeviceFrameStats> m_frameStats;
+		uint32 m_frame = 0;
+		bool m_isRecording = false;
+	};
+}
+
+#endif
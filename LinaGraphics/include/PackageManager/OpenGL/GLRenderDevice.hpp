@@ -59,6 +59,11 @@ namespace LinaEngine::Graphics
 		uint32  numBuffers;
 		uint32  numElements;
 		uint32  instanceComponentsStartIndex;
+		uint32* attributeStarts;
+		uint32* elementSizes;
+		uint32* elementTypes;
+		uint32* sourceBuffers;
+		uintptr* sourceOffsets;
 		BufferUsage bufferUsage;
 	};
 
@@ -87,21 +92,43 @@ namespace LinaEngine::Graphics
 		uint32 CreateCubemapTextureEmpty(Vector2 size, SamplerParameters samplerParams);
 		uint32 CreateTexture2DMSAA(Vector2 size, SamplerParameters samplerParams, int sampleCount);
 		uint32 CreateTexture2DEmpty(Vector2 size, SamplerParameters samplerParams);
+		void UpdateTexture2D(uint32 texture, Vector2 size, const void* data, PixelFormat pixelFormat);
+		void UpdateTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, Vector2 size, const uint16* data, PixelFormat pixelFormat);
+		bool ReadTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, uint16* data, PixelFormat pixelFormat);
 		
 		void SetupTextureParameters(uint32 textureTarget, SamplerParameters samplerParams, bool useBorder = false, float* borderColor = NULL);
 		void UpdateTextureParameters(uint32 bindMode, uint32 id, SamplerParameters samplerParmas);
 	
 		uint32 ReleaseTexture2D(uint32 texture2D);
+		uint32 CreateTextureBuffer(PixelFormat internalPixelFormat, uint32& buffer);
+		void UpdateTextureBuffer(uint32 buffer, const void* data, uintptr dataSize);
+		uint32 ReleaseTextureBuffer(uint32 texture, uint32 buffer);
 		uint32 CreateVertexArray(const float** vertexData, const uint32* vertexElementSizes, const uint32* vertexElementTypes, uint32 numVertexComponents, uint32 numInstanceComponents, uint32 numVertices, const uint32* indices, uint32 numIndices, BufferUsage bufferUsage);
 		uint32 CreateSkyboxVertexArray();
 		uint32 CreateScreenQuadVertexArray();
 		uint32 CreateLineVertexArray();
+		uint32 CreateSpriteBatchVertexArray(uint32 maxSprites);
 		uint32 CreateHDRICubeVertexArray();
 		uint32 ReleaseVertexArray(uint32 vao, bool checkMap = true);
 		uint32 CreateSampler(SamplerParameters samplerParams);
 		uint32 ReleaseSampler(uint32 sampler);
 		uint32 CreateUniformBuffer(const void* data, uintptr dataSize, BufferUsage usage);
 		uint32 ReleaseUniformBuffer(uint32 buffer);
+		uint32 CreateRingBuffer(uintptr size, void** persistentData);
+		uint32 ReleaseRingBuffer(uint32 buffer, bool persistent);
+		void OrphanRingBuffer(uint32 buffer, uintptr size);
+		void WriteRingBuffer(uint32 buffer, uintptr offset, const void* data, uintptr dataSize);
+		void* CreateFence();
+		void WaitFence(void* fence);
+		void ReleaseFence(void* fence);
+		uint32 CreateTimerQuery();
+		uint32 ReleaseTimerQuery(uint32 query);
+		void BeginTimerQuery(uint32 query);
+		void EndTimerQuery();
+		bool GetTimerQueryResult(uint32 query, uint64* elapsedNS);
+		bool SupportsPersistentMapping();
+		bool SupportsMultiDrawIndirect();
+		uint32 GetUniformBufferOffsetAlignment();
 		uint32 CreateShaderProgram(const std::string& shaderText, ShaderUniformData* data, bool usesGeometryShader);
 		bool ValidateShaderProgram(uint32 shader);
 	
@@ -121,11 +148,17 @@ namespace LinaEngine::Graphics
 		void GenerateTextureMipmaps(uint32 texture, TextureBindMode bindMode);
 		void BlitFrameBuffers(uint32 readFBO, uint32 readWidth, uint32 readHeight, uint32 writeFBO, uint32 writeWidth, uint32 writeHeight, BufferBit mask, SamplerFilter filter);
 		bool IsRenderTargetComplete(uint32 fbo);
+		void CopyTextureRegion(uint32 srcTexture, Vector2 srcPos, Vector2 srcSize, uint32 dstTexture, Vector2 dstPos, Vector2 dstSize);
 		void UpdateVertexArray(uint32 vao, uint32 bufferIndex, const void* data, uintptr dataSize);
+		void SetVertexArrayInstanceBuffer(uint32 vao, uint32 bufferIndex, uint32 buffer, uintptr offset);
+		void UpdateVertexArrayRange(uint32 vao, const float** vertexData, uint32 firstVertex, uint32 numVertices, const uint32* indices, uint32 firstIndex, uint32 numIndices);
+		void SetSpriteBatchVertexSource(uint32 vao, uint32 buffer, uintptr offset);
+		void SetLineVertexSource(uint32 vao, uint32 buffer, uintptr offset);
 		void SetShader(uint32 shader);
 		void SetTexture(uint32 texture, uint32 sampler, uint32 unit, TextureBindMode bindTextureMode = TextureBindMode::BINDTEXTURE_TEXTURE2D, bool setSampler = false);
 		void SetShaderUniformBuffer(uint32 shader, const std::string& uniformBufferName, uint32 buffer);
 		void BindUniformBuffer(uint32 buffer, uint32 bindingPoint);
+		void BindUniformBufferRange(uint32 buffer, uint32 bindingPoint, uintptr offset, uintptr dataSize);
 		void BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName);
 		void UpdateVertexArrayBuffer(uint32 vao, uint32 bufferIndex, const void* data, uintptr dataSize);
 		void UpdateUniformBuffer(uint32 buffer, const void* data, uintptr offset, uintptr dataSize);
@@ -134,10 +167,13 @@ namespace LinaEngine::Graphics
 
 		void SetDrawParameters(const DrawParams& drawParams);
 		void Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays = false);
-		void DrawLine(float width);
-		void DrawLine(uint32 shader, const Matrix& model, const Vector3& from, const Vector3& to, float width = 1.0f);
+		void DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex);
+		void DrawInstancedBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, uint32 firstIndex, uint32 baseVertex);
+		void MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, uint32 indirectBuffer, uintptr offset, uint32 drawCount);
+		void DrawLines(uint32 vao, const DrawParams& drawParams, uint32 firstVertex, uint32 numVertices, float width);
 		void Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const class Color& color, uint32 stencil);
 
+		bool HasShaderUniform(uint32 shader, const std::string& uniform);
 		void UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, const float f);
 		void UpdateShaderUniformInt(uint32 shader, const std::string& uniform, const int f);
 		void UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& color);
@@ -166,6 +202,7 @@ namespace LinaEngine::Graphics
 		void SetBlending(BlendFunc sourceBlend, BlendFunc destBlend);
 		void SetStencilTest(bool enable, DrawFunc stencilFunc, uint32 stencilTestMask, uint32 stencilWriteMask, int32 stencilComparisonVal, StencilOp stencilFail, StencilOp stencilPassButDepthFail, StencilOp stencilPass);
 		void SetScissorTest(bool enable, uint32 startX = 0, uint32 startY = 0, uint32 width = 0, uint32 height = 0);
+		void SetInstanceAttributes(const VertexArrayData& vaoData, uint32 bufferIndex, uint32 buffer, uintptr offset);
 
 
 	private:
@@ -177,7 +214,8 @@ namespace LinaEngine::Graphics
 		uint32 m_boundWriteFBO = 0;
 		uint32 m_viewportFBO = 0;
 		uint32 m_boundRBO = 0;
-		uint32 m_boundUBO;
+		uint32 m_boundUBO = 0;
+		uint32 m_copyFBOs[2] = { 0, 0 };
 		uint32 m_boundTextureUnit;
 		Vector2 m_boundViewportSize;
 		Vector2 m_boundViewportPos;
@@ -42,11 +42,21 @@ Timestamp: 4/27/2019 10:23:46 PM
 
 #ifdef LINA_GRAPHICS_OPENGL
 
+#ifdef LINA_GRAPHICS_NULL
+
+#include "PackageManager/Null/NullRenderDevice.hpp"
+
+typedef LinaEngine::Graphics::NullRenderDevice RenderDevice;
+
+#else
+
 #include "PackageManager/OpenGL/GLRenderDevice.hpp"
 
 typedef LinaEngine::Graphics::GLRenderDevice RenderDevice;
 
 #endif
 
+#endif
+
 
 #endif
\ No newline at end of file
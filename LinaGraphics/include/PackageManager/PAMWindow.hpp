@@ -40,11 +40,22 @@ Timestamp: 4/14/2019 7:13:05 PM
 #define PAMWINDOW_HPP
 
 #ifdef LINA_GRAPHICS_OPENGL
+
+#ifdef LINA_GRAPHICS_NULL
+
+#include "PackageManager/Null/NullWindow.hpp"
+
+typedef LinaEngine::Graphics::NullWindow ContextWindow;
+
+#else
+
 #include "PackageManager/OpenGL/GLWindow.hpp"
 
 typedef LinaEngine::Graphics::GLWindow ContextWindow;
 
 #endif
 
+#endif
+
 
 #endif
@@ -0,0 +1,108 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: DebugRenderer
+
+Collects debug lines & shapes during the frame and draws them in a handful of calls. Lines are
+grouped by width & depth test mode, submission is thread safe and the vertices are streamed through
+the frame ring buffer on flush.
+
+Timestamp: 10/19/2026 8:47:12 PM
+*/
+
+#pragma once
+
+#ifndef DebugRenderer_HPP
+#define DebugRenderer_HPP
+
+#include "PackageManager/PAMRenderDevice.hpp"
+#include "Rendering/RenderingCommon.hpp"
+#include <mutex>
+#include <vector>
+
+#define DEBUGRENDERER_MAX_VERTICES (1 << 20)
+#define DEBUGRENDERER_CIRCLE_SEGMENTS 24
+
+namespace LinaEngine::Graphics
+{
+	class RingBuffer;
+
+	struct DebugLineBatch
+	{
+		float m_width = 1.0f;
+		bool m_depthTest = true;
+		std::vector<LineVertex> m_vertices;
+	};
+
+	class DebugRenderer
+	{
+	public:
+
+		DebugRenderer() {}
+		~DebugRenderer();
+
+		void Construct(RenderDevice& renderDeviceIn, RingBuffer& ringBufferIn, uint32 shader);
+
+		// Shapes can be submitted from any thread, they are drawn on the next flush.
+		void DrawLine(const Vector3& from, const Vector3& to, const Color& color, float width = 1.0f, bool depthTest = true);
+		void DrawBox(const Vector3& center, const Vector3& halfExtents, const Color& color, float width = 1.0f, bool depthTest = true);
+		void DrawSphere(const Vector3& center, float radius, const Color& color, float width = 1.0f, bool depthTest = true);
+		void DrawMarker(const Vector3& position, float size, const Color& color, float width = 1.0f, bool depthTest = false);
+
+		// Adds a list of line vertex pairs in one go.
+		void DrawLines(const LineVertex* vertices, uint32 vertexCount, float width = 1.0f, bool depthTest = true);
+
+		// Draws everything submitted so far with one call per batch, then clears the batches.
+		void Flush(const DrawParams& drawParams);
+
+		uint32 GetLastVertexCount() const { return m_lastVertexCount; }
+		uint32 GetLastDrawCount() const { return m_lastDrawCount; }
+
+	private:
+
+		DebugLineBatch& GetBatch(float width, bool depthTest);
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		RingBuffer* m_ringBuffer = nullptr;
+		uint32 m_shaderID = 0;
+		uint32 m_vertexArray = 0;
+		uint32 m_streamBuffer = 0;
+		uintptr m_streamBufferSize = 0;
+		std::mutex m_mutex;
+		std::vector<DebugLineBatch> m_batches;
+		std::vector<DebugLineBatch> m_flushBatches;
+		uint32 m_pendingVertexCount = 0;
+		uint32 m_lastVertexCount = 0;
+		uint32 m_lastDrawCount = 0;
+	};
+}
+
+#endif
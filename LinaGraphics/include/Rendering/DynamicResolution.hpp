@@ -0,0 +1,121 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: DynamicResolution
+
+Drives the internal render scale from the frame times. The GPU time is read back from timer queries a
+few frames late without stalling, the CPU time spans the frame's work up to the swap. A damped controller
+moves the scale towards the one predicted to fit the budget, dropping quickly & recovering slowly, and
+never lowers it for frames the GPU isn't the bottleneck of.
+
+Timestamp: 10/19/2026 11:38:52 PM
+*/
+
+#pragma once
+
+#ifndef DynamicResolution_HPP
+#define DynamicResolution_HPP
+
+#include "PackageManager/PAMRenderDevice.hpp"
+#include <chrono>
+
+#define DYNAMICRESOLUTION_QUERY_COUNT 4
+#define DYNAMICRESOLUTION_DEFAULT_BUDGET_MS (1000.0f / 60.0f)
+#define DYNAMICRESOLUTION_DEFAULT_MIN_SCALE 0.5f
+#define DYNAMICRESOLUTION_DEFAULT_MAX_SCALE 1.0f
+
+namespace LinaEngine::Graphics
+{
+	struct DynamicResolutionStats
+	{
+		float m_scale = 1.0f;
+		float m_targetScale = 1.0f;
+		float m_budgetMS = DYNAMICRESOLUTION_DEFAULT_BUDGET_MS;
+		float m_cpuTimeMS = 0.0f;
+		float m_gpuTimeMS = 0.0f;
+		float m_headroomMS = 0.0f;
+		bool m_hasGPUTime = false;
+		bool m_isCPUBound = false;
+	};
+
+	class DynamicResolution
+	{
+	public:
+
+		DynamicResolution() {}
+		~DynamicResolution();
+
+		void Construct(RenderDevice& renderDeviceIn);
+
+		// Stamps the start of the frame's CPU work, called right after the swap.
+		void BeginFrame();
+
+		// Starts timing the GPU work submitted until the end of the frame.
+		void BeginGPUTimer();
+
+		// Stops the timers, reads back the finished queries & moves the scale towards the budget.
+		void EndFrame();
+
+		// Disabled controllers render at full scale but keep reporting the frame times.
+		void SetEnabled(bool enabled);
+		void SetBudget(float budgetMS);
+		void SetScaleBounds(float minScale, float maxScale);
+
+		bool GetEnabled() const { return m_enabled; }
+		float GetBudget() const { return m_stats.m_budgetMS; }
+		float GetMinScale() const { return m_minScale; }
+		float GetMaxScale() const { return m_maxScale; }
+		float GetScale() const { return m_stats.m_scale; }
+		const DynamicResolutionStats& GetStats() const { return m_stats; }
+
+	private:
+
+		void ReadQueries();
+		void UpdateScale();
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		uint32 m_queries[DYNAMICRESOLUTION_QUERY_COUNT] = { 0 };
+		float m_queryScales[DYNAMICRESOLUTION_QUERY_COUNT] = { 0.0f };
+		bool m_queryPending[DYNAMICRESOLUTION_QUERY_COUNT] = { false };
+		uint32 m_queryIndex = 0;
+		bool m_gpuTimerActive = false;
+		std::chrono::steady_clock::time_point m_frameStart;
+		bool m_frameStarted = false;
+		bool m_enabled = false;
+		float m_minScale = DYNAMICRESOLUTION_DEFAULT_MIN_SCALE;
+		float m_maxScale = DYNAMICRESOLUTION_DEFAULT_MAX_SCALE;
+		float m_sampleScale = 1.0f;
+		bool m_hasCPUTime = false;
+		DynamicResolutionStats m_stats;
+	};
+}
+
+#endif
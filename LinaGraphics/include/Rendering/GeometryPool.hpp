@@ -0,0 +1,120 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: GeometryPool
+
+Shared vertex & index storage for meshes. Pages hold one large vertex array per vertex layout, meshes
+are sub-allocated from free lists of vertex & index ranges so submeshes drawn with the same layout
+share their buffers & can be submitted together with indirect draws.
+
+Timestamp: 10/19/2026 9:12:40 PM
+*/
+
+#pragma once
+
+#ifndef GeometryPool_HPP
+#define GeometryPool_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include "PackageManager/PAMRenderDevice.hpp"
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	class IndexedModel;
+
+	struct GeometryAllocation
+	{
+		uint32 m_page = 0;
+		uint32 m_vertexArray = 0;
+		uint32 m_firstVertex = 0;
+		uint32 m_vertexCount = 0;
+		uint32 m_firstIndex = 0;
+		uint32 m_indexCount = 0;
+	};
+
+	class GeometryPool
+	{
+
+	public:
+
+		struct Statistics
+		{
+			uint32 m_pageCount = 0;
+			uint32 m_allocationCount = 0;
+			uint32 m_usedVertices = 0;
+			uint32 m_usedIndices = 0;
+		};
+
+		GeometryPool() {};
+		~GeometryPool() {};
+
+		void Construct(RenderDevice& renderDeviceIn);
+
+		// Releases all the pages, allocations become invalid.
+		void Release();
+
+		// Places the model into a page with the same layout, creating one if needed. Fails for models larger than a page.
+		bool Allocate(const IndexedModel& model, GeometryAllocation& allocation);
+		void Free(const GeometryAllocation& allocation);
+
+		bool IsConstructed() const { return m_isConstructed; }
+		const Statistics& GetStatistics() const { return m_statistics; }
+
+	private:
+
+		struct FreeRange
+		{
+			uint32 m_offset = 0;
+			uint32 m_size = 0;
+		};
+
+		struct Page
+		{
+			std::vector<uint32> m_layout;
+			std::vector<FreeRange> m_freeVertices;
+			std::vector<FreeRange> m_freeIndices;
+			uint32 m_vertexArray = 0;
+		};
+
+		static std::vector<uint32> GetLayout(const IndexedModel& model);
+		static bool AllocateRange(std::vector<FreeRange>& freeRanges, uint32 size, uint32& offset);
+		static void ReleaseRange(std::vector<FreeRange>& freeRanges, uint32 offset, uint32 size);
+		uint32 CreatePage(const IndexedModel& model, const std::vector<uint32>& layout);
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		std::vector<Page> m_pages;
+		Statistics m_statistics;
+		bool m_isConstructed = false;
+	};
+}
+
+#endif
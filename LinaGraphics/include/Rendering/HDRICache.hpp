@@ -0,0 +1,98 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: HDRICache
+
+Disk cache for the environment maps precomputed from an HDRI, keyed by the hash of the source image & the
+capture resolution. Also projects the environment onto 9 spherical harmonics coefficients for diffuse
+lighting, and integrates the split sum BRDF lookup table on the CPU, which is shipped prebuilt.
+
+Timestamp: 10/19/2026 4:12:37 PM
+*/
+
+#pragma once
+
+#ifndef HDRICache_HPP
+#define HDRICache_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <string>
+#include <vector>
+
+#define HDRICACHE_FOLDERPATH "resources/engine/cache/hdri"
+#define HDRICACHE_EXTENSION ".linahdri"
+#define HDRICACHE_SH_COEFFICIENTS 9
+#define BRDFLUT_FULLPATH "resources/engine/textures/brdfLUT.linalut"
+#define BRDFLUT_RESOLUTION 128
+#define BRDFLUT_SAMPLE_COUNT 1024
+
+namespace LinaEngine::Graphics
+{
+	// Half float RGB texels of the precomputed cubemaps. Mips are stored largest first, faces of a mip in +X, -X, +Y, -Y, +Z, -Z order.
+	struct HDRICacheData
+	{
+		uint64 m_sourceHash = 0;
+		uint32 m_resolution = 0;
+		uint32 m_irradianceResolution = 0;
+		uint32 m_prefilterResolution = 0;
+		uint32 m_prefilterMipCount = 0;
+		bool m_hasIrradianceSH = false;
+		float m_irradianceSH[HDRICACHE_SH_COEFFICIENTS * 3] = { 0.0f };
+		std::vector<uint16> m_environment;
+		std::vector<uint16> m_irradiance;
+		std::vector<uint16> m_prefilter;
+	};
+
+	class HDRICache
+	{
+	public:
+
+		// FNV-1a hash of the file's contents, 0 if it can't be read.
+		static uint64 HashFile(const std::string& path);
+		static std::string GetCachePath(uint64 sourceHash, uint32 resolution);
+
+		// Fails if the file is missing, from another version or doesn't match the given key.
+		static bool Load(const std::string& path, uint64 sourceHash, uint32 resolution, HDRICacheData& data);
+		static bool Save(const std::string& path, const HDRICacheData& data);
+
+		// Half float count of an RGB cubemap with the given mips.
+		static uint32 GetCubemapDataSize(uint32 resolution, uint32 mipCount);
+
+		// Projects an RGB cubemap onto the first 3 SH bands. The coefficients are convolved with the cosine lobe, divided by pi
+		// & premultiplied with the basis constants, so the shader only evaluates a polynomial of the normal.
+		static void ComputeIrradianceSH(const uint16* faces, uint32 resolution, float* coefficients);
+
+		// Scale & bias to F0 of the split sum approximation as RG pairs, NdotV along x & roughness along y.
+		static void ComputeBRDFLut(uint32 resolution, uint32 sampleCount, std::vector<float>& data);
+		static bool LoadBRDFLut(const std::string& path, uint32& resolution, std::vector<float>& data);
+		static bool SaveBRDFLut(const std::string& path, uint32 resolution, const std::vector<float>& data);
+	};
+}
+
+#endif
@@ -41,6 +41,7 @@ Timestamp: 4/26/2019 12:11:36 AM
 
 #include "Core/SizeDefinitions.hpp"
 #include "PackageManager/PAMRenderDevice.hpp"
+#include "Utility/Math/AABB.hpp"
 
 namespace LinaEngine::Graphics
 {
@@ -55,6 +56,10 @@ namespace LinaEngine::Graphics
 
 		// Sets the element size array according to the desired size.
 		void AllocateElement(uint32 elementSize, bool isFloat);
+		void AllocateElement(uint32 elementSize, VertexElementType elementType);
+
+		// Allocates the per-instance transform element, three vec4 attributes holding an InstanceTransform.
+		void AllocateInstanceTransform() { AllocateElement(sizeof(InstanceTransform) / sizeof(float), true); }
 
 		// Adds float data to the m_Elements array, 1 to 4 elems. TODO: Maybe template? Consider inline array push performance.
 		void AddElement(uint32 elementIndex, float e0);
@@ -70,6 +75,22 @@ namespace LinaEngine::Graphics
 
 		// Gets the element array
 		std::vector<std::vector<float>>& GetElements() { return m_elements; }
+		const std::vector<std::vector<float>>& GetElements() const { return m_elements; }
+
+		// Gets the index array
+		const std::vector<uint32>& GetIndices() const { return m_indices; }
+
+		// Gets the component count of each element.
+		const std::vector<uint32>& GetElementSizes() const { return m_elementSizes; }
+
+		// Gets the storage type of each element.
+		const std::vector<uint32>& GetElementTypes() const { return m_elementTypes; }
+
+		// Number of per-vertex elements, instanced elements excluded.
+		uint32 GetVertexElementCount() const { return m_startIndex == ((uint32)-1) ? (uint32)m_elementSizes.size() : m_startIndex; }
+
+		// Number of vertices, taken from the first element.
+		uint32 GetVertexCount() const { return m_elements.size() == 0 ? 0 : (uint32)m_elements[0].size() / m_elementSizes[0]; }
 
 		// Sets the start index for instanced elements.
 		void SetStartIndex(uint32 elementIndex) { m_startIndex = elementIndex; }
@@ -77,6 +98,25 @@ namespace LinaEngine::Graphics
 		// Accessor for num m_Indices.
 		uint32 GetIndexCount() const { return m_indices.size(); }
 
+		// Calculates local bounds from the position element, expected to be the first element.
+		void CalculateBounds();
+
+		const AABB& GetBounds() const { return m_bounds; }
+		const BoundingSphere& GetBoundingSphere() const { return m_boundingSphere; }
+
+		// Creates a model with the same element layout holding only the vertices referenced by the given
+		// triangle list, in first use order. Bounds are calculated for the result.
+		IndexedModel CreateSubset(const std::vector<uint32>& indices) const;
+
+		// Creates the GPU layout of the position, uv, normal & tangent model: 16 bit positions relative to the bounds with
+		// the tangent handedness in w, half float uvs, octahedral normals & tangents. Bitangents are left to the shader.
+		IndexedModel CreateQuantized() const;
+
+		// Quantized positions are decoded as offset + position * scale.
+		bool GetIsQuantized() const { return m_isQuantized; }
+		const Vector3& GetPositionOffset() const { return m_positionOffset; }
+		const Vector3& GetPositionScale() const { return m_positionScale; }
+
 	private:
 
 		// Index & element data.
@@ -88,6 +128,15 @@ namespace LinaEngine::Graphics
 		// Start index for instanced elements.
 		uint32 m_startIndex = 0;
 
+		// Local space bounds.
+		AABB m_bounds;
+		BoundingSphere m_boundingSphere;
+
+		// Position decoding of quantized models.
+		bool m_isQuantized = false;
+		Vector3 m_positionOffset = Vector3::Zero;
+		Vector3 m_positionScale = Vector3::One;
+
 	};
 }
 
@@ -0,0 +1,138 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: LightClusterGrid
+
+Clustered forward light assignment. The view frustum is split in screen tiles & exponential depth
+slices, every point & spot light is assigned to the clusters its bounding sphere touches. Light data,
+the per cluster (offset, count) grid & the light index lists are uploaded as buffer textures once per
+frame so lit shaders only iterate the lights of the cluster they are in.
+
+Timestamp: 10/19/2026 9:18:40 PM
+*/
+
+#pragma once
+
+#ifndef LightClusterGrid_HPP
+#define LightClusterGrid_HPP
+
+#include "PackageManager/PAMRenderDevice.hpp"
+#include "Rendering/RenderCommandBuffer.hpp"
+#include "Utility/Math/Vector.hpp"
+#include "Utility/Math/Matrix.hpp"
+#include "Utility/Math/Color.hpp"
+#include <vector>
+
+#define LIGHTCLUSTER_X 16
+#define LIGHTCLUSTER_Y 9
+#define LIGHTCLUSTER_Z 24
+#define LIGHTCLUSTER_COUNT (LIGHTCLUSTER_X * LIGHTCLUSTER_Y * LIGHTCLUSTER_Z)
+#define LIGHTCLUSTER_MAX_LIGHTS 1024
+#define LIGHTCLUSTER_MAX_LIGHTS_PER_CLUSTER 128
+#define LIGHTCLUSTER_UNIT_LIGHTS 13
+#define LIGHTCLUSTER_UNIT_GRID 14
+#define LIGHTCLUSTER_UNIT_INDICES 15
+
+namespace LinaEngine::Graphics
+{
+	// Three RGBA32F texels per light, see LightingData.glh.
+	struct ClusterLightData
+	{
+		Vector4 m_positionRange;
+		Vector4 m_colorCutoff;
+		Vector4 m_directionOuterCutoff;
+	};
+
+	class LightClusterGrid
+	{
+	public:
+
+		LightClusterGrid() {}
+		~LightClusterGrid();
+
+		void Construct(RenderDevice& renderDeviceIn);
+
+		// Lights are gathered every frame, point lights are placed before spot lights.
+		void Clear();
+		void AddPointLight(const Vector3& position, const Color& color, float range);
+		void AddSpotLight(const Vector3& position, const Vector3& direction, const Color& color, float range, float cutoff, float outerCutoff);
+
+		// Assigns the lights to the clusters of the given view & uploads the buffers.
+		void Build(const Matrix& view, const Matrix& projection, float zNear, float zFar);
+
+		// Binds the buffers to their units & sets the sampler uniforms of the shader.
+		void Bind(uint32 shader, RenderCommandBuffer& commands);
+
+		int GetPointLightCount() const { return m_pointLightCount; }
+		int GetSpotLightCount() const { return m_spotLightCount; }
+
+		// Depth slice of a view depth is log(depth) * scale + bias.
+		float GetSliceScale() const { return m_sliceScale; }
+		float GetSliceBias() const { return m_sliceBias; }
+		uint32 GetIndexCount() const { return (uint32)m_indices.size(); }
+
+	private:
+
+		struct LightBounds
+		{
+			Vector3 m_center;
+			float m_radius;
+			int m_minX, m_maxX, m_minY, m_maxY, m_minZ, m_maxZ;
+		};
+
+		void BuildClusterBounds(const Matrix& projection, float zNear, float zFar);
+		void AssignSlice(uint32 slice);
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		uint32 m_lightsTexture = 0;
+		uint32 m_lightsBuffer = 0;
+		uint32 m_gridTexture = 0;
+		uint32 m_gridBuffer = 0;
+		uint32 m_indicesTexture = 0;
+		uint32 m_indicesBuffer = 0;
+
+		std::vector<ClusterLightData> m_lights;
+		std::vector<ClusterLightData> m_spotLights;
+		std::vector<LightBounds> m_bounds;
+		std::vector<Vector3> m_clusterMin;
+		std::vector<Vector3> m_clusterMax;
+		std::vector<std::vector<uint32>> m_sliceIndices;
+		std::vector<uint32> m_grid;
+		std::vector<uint32> m_indices;
+
+		int m_pointLightCount = 0;
+		int m_spotLightCount = 0;
+		float m_sliceScale = 0.0f;
+		float m_sliceBias = 0.0f;
+	};
+}
+
+#endif
@@ -44,11 +44,20 @@ Timestamp: 5/6/2019 4:23:45 PM
 #include "Rendering/Texture.hpp"
 #include "Rendering/IndexedModel.hpp"
 #include "Rendering/Material.hpp"
+#include "Rendering/MeshOptimizer.hpp"
 
 namespace LinaEngine::Graphics
 {
 	class VertexArray;
 
+	// Simplified copy of the submeshes, drawn while the projected size of the mesh stays below the screen size.
+	struct MeshLOD
+	{
+		std::vector<IndexedModel> m_indexedModels;
+		std::vector<VertexArray*> m_vertexArrays;
+		float m_screenSize = 0.0f;
+	};
+
 	class Mesh
 	{
 
@@ -99,6 +108,20 @@ namespace LinaEngine::Graphics
 			return m_materialIndexArray;
 		}
 
+		// Local bounds enclosing all the vertex arrays.
+		const AABB& GetBounds() const { return m_bounds; }
+
+		// Vertex cache efficiency of the submeshes before & after the import optimizations.
+		const MeshOptimizationReport& GetOptimizationReport() const { return m_optimizationReport; }
+
+		// Level of detail chain, LOD 0 is the imported mesh itself.
+		uint32 GetLODCount() const { return (uint32)m_lods.size() + 1; }
+		std::vector<VertexArray*>& GetLODVertexArrays(uint32 lod) { return lod == 0 ? m_vertexArrays : m_lods[lod - 1].m_vertexArrays; }
+		std::vector<IndexedModel>& GetLODIndexedModels(uint32 lod) { return lod == 0 ? m_indexedModelArray : m_lods[lod - 1].m_indexedModels; }
+
+		// Projected size, as a fraction of the screen height, below which the given LOD is used.
+		float GetLODScreenSize(uint32 lod) const { return m_lods[lod - 1].m_screenSize; }
+
 		static MeshParameters LoadParameters(const std::string& path);
 		static void SaveParameters(const std::string& path, MeshParameters params);
 		void SetParameters(MeshParameters params) { m_parameters = params; }
@@ -108,6 +131,11 @@ namespace LinaEngine::Graphics
 		const int GetID() const { return m_meshID; }
 
 
+	private:
+
+		// Simplifies the submeshes into the LOD chain described by the mesh parameters.
+		void GenerateLODs();
+
 	private:
 
 		static std::map<int, Mesh> s_loadedMeshes;
@@ -122,6 +150,9 @@ namespace LinaEngine::Graphics
 		std::vector<IndexedModel> m_indexedModelArray;
 		std::vector<ModelMaterial> m_materialSpecArray;
 		std::vector<uint32> m_materialIndexArray;
+		std::vector<MeshLOD> m_lods;
+		MeshOptimizationReport m_optimizationReport;
+		AABB m_bounds;
 
 	};
 }
@@ -0,0 +1,105 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: MeshOptimizer
+
+Import time triangle & vertex reordering. Identical vertices are welded, triangles are ordered for the
+post transform vertex cache, then clustered & sorted outwards to reduce overdraw, and vertices are
+finally laid out in the order they are fetched.
+
+Timestamp: 10/19/2026 11:02:41 PM
+*/
+
+#pragma once
+
+#ifndef MeshOptimizer_HPP
+#define MeshOptimizer_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	class IndexedModel;
+
+	// Post transform cache efficiency of a triangle list, simulated with a FIFO cache.
+	struct VertexCacheStatistics
+	{
+		uint32 m_vertexTransforms = 0;
+		uint32 m_triangleCount = 0;
+		uint32 m_vertexCount = 0;
+
+		// Average cache miss ratio, transformed vertices per triangle.
+		float GetACMR() const { return m_triangleCount == 0 ? 0.0f : (float)m_vertexTransforms / (float)m_triangleCount; }
+
+		// Average transform to vertex ratio, 1.0 is optimal.
+		float GetATVR() const { return m_vertexCount == 0 ? 0.0f : (float)m_vertexTransforms / (float)m_vertexCount; }
+
+		void Add(const VertexCacheStatistics& other)
+		{
+			m_vertexTransforms += other.m_vertexTransforms;
+			m_triangleCount += other.m_triangleCount;
+			m_vertexCount += other.m_vertexCount;
+		}
+	};
+
+	struct MeshOptimizationReport
+	{
+		VertexCacheStatistics m_before;
+		VertexCacheStatistics m_after;
+
+		void Add(const MeshOptimizationReport& other)
+		{
+			m_before.Add(other.m_before);
+			m_after.Add(other.m_after);
+		}
+	};
+
+	class MeshOptimizer
+	{
+	public:
+
+		// Runs the whole pass on the model & replaces it with the optimized one.
+		static MeshOptimizationReport Optimize(IndexedModel& model);
+
+		// Points the indices of identical vertices to their first occurence.
+		static void WeldVertices(const IndexedModel& model, std::vector<uint32>& indices);
+
+		// Reorders the triangles for the vertex cache, Forsyth's linear speed algorithm.
+		static void OptimizeVertexCache(std::vector<uint32>& indices, uint32 vertexCount);
+
+		// Splits the cache ordered triangles into clusters at cache flushes & draws outward facing clusters first.
+		// The order is kept only if the cache efficiency doesn't drop more than the threshold.
+		static void OptimizeOverdraw(std::vector<uint32>& indices, const float* positions, uint32 vertexCount, float threshold);
+
+		static VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32>& indices, uint32 vertexCount);
+	};
+}
+
+#endif
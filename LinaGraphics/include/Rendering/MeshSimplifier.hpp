@@ -0,0 +1,59 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: MeshSimplifier
+
+Quadric error metric edge collapse simplification. Vertices are collapsed onto their neighbours, so the
+result only references the source vertices & no new vertex data is generated. Mesh borders & attribute
+seams are locked to keep silhouettes & UV charts intact.
+
+Timestamp: 10/19/2026 10:31:05 PM
+*/
+
+#pragma once
+
+#ifndef MeshSimplifier_HPP
+#define MeshSimplifier_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	class MeshSimplifier
+	{
+	public:
+
+		// Reduces the triangle list towards the target index count, stops early once the collapse error exceeds the
+		// target error, given relative to the mesh extent. Returns the index count of the result.
+		static uint32 Simplify(const float* positions, uint32 vertexCount, const uint32* indices, uint32 indexCount, uint32 targetIndexCount, float targetError, std::vector<uint32>& result);
+	};
+}
+
+#endif
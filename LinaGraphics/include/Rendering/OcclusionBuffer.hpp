@@ -0,0 +1,95 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: OcclusionBuffer
+
+Low resolution CPU depth buffer used for occlusion culling. Occluder triangles are rasterized
+with SSE, a max depth per tile is kept on top to reject most occludee tests early.
+No GPU resources are involved, the buffer can be used from any thread.
+
+Timestamp: 10/19/2026 6:02:17 PM
+*/
+
+#pragma once
+
+#ifndef OcclusionBuffer_HPP
+#define OcclusionBuffer_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include "Utility/Math/Matrix.hpp"
+#include "Utility/Math/AABB.hpp"
+#include <vector>
+
+#define OCCLUSION_BUFFER_WIDTH 256
+#define OCCLUSION_BUFFER_HEIGHT 128
+#define OCCLUSION_TILE_SIZE 8
+
+namespace LinaEngine::Graphics
+{
+	class OcclusionBuffer
+	{
+	public:
+
+		OcclusionBuffer();
+
+		// Resets the depth to the far plane & sets the matrix occluders & occludees are projected with.
+		void Clear(const Matrix& viewProjection);
+
+		// Rasterizes indexed triangles, positions are tightly packed xyz in model space.
+		void RasterizeMesh(const Matrix& model, const float* positions, uint32 vertexCount, const uint32* indices, uint32 indexCount);
+
+		// Updates the tile depths, needs to be called after rasterizing & before testing.
+		void BuildHierarchy();
+
+		// Returns false if the world bounds are completely behind the rasterized occluders.
+		bool IsVisible(const AABB& worldBounds) const;
+
+		// Fills a grayscale RGBA8 image, closer occluders are brighter.
+		void GetDebugImage(std::vector<uint8>& pixels) const;
+
+		const Matrix& GetViewProjection() const { return m_viewProjection; }
+		const float* GetDepth() const { return m_depth.data(); }
+		uint32 GetTriangleCount() const { return m_triangleCount; }
+
+	private:
+
+		void RasterizeTriangle(const float* v0, const float* v1, const float* v2);
+
+	private:
+
+		Matrix m_viewProjection;
+		std::vector<float> m_depth;
+		std::vector<float> m_tileMaxDepth;
+		std::vector<float> m_screenVertices;
+		std::vector<uint8> m_vertexClipped;
+		uint32 m_triangleCount = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: OcclusionBufferCheck
+
+Deterministic checks for the software occlusion buffer. A known wall is rasterized in front of a fixed
+camera & boxes behind, in front of & around it are tested against the expected visibility. Runs on
+the CPU only, so it works without a window or a GPU.
+
+Timestamp: 10/20/2026 10:31:52 AM
+*/
+
+#pragma once
+
+#ifndef OcclusionBufferCheck_HPP
+#define OcclusionBufferCheck_HPP
+
+#include <string>
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	struct OcclusionBufferCheckResult
+	{
+		std::string m_name;
+		bool m_passed = false;
+	};
+
+	class OcclusionBufferCheck
+	{
+	public:
+
+		static std::vector<OcclusionBufferCheckResult> Run();
+
+		// Logs every check, returns true if all of them passed.
+		static bool LogResults(const std::vector<OcclusionBufferCheckResult>& results);
+	};
+}
+
+#endif
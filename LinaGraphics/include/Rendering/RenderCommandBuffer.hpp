@@ -0,0 +1,264 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderCommandBuffer
+
+Linear list of POD render commands. Passes record into their own buffers on worker threads, the
+buffers are then executed in submission order on the thread owning the context. Dynamic data such as
+instance transforms is copied into the buffer & streamed into the frame ring buffer on execution, so
+recording never touches the device.
+
+Timestamp: 10/19/2026 10:03:17 PM
+*/
+
+#pragma once
+
+#ifndef RenderCommandBuffer_HPP
+#define RenderCommandBuffer_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include "PackageManager/PAMRenderDevice.hpp"
+#include "Rendering/RenderingCommon.hpp"
+#include "Utility/Math/Color.hpp"
+#include "Utility/Math/Matrix.hpp"
+#include <vector>
+#include <string>
+#include <new>
+
+#define RENDERCOMMANDBUFFER_ALIGNMENT 16
+#define RENDERCOMMANDBUFFER_INVALID_STREAM ((uint32)-1)
+
+namespace LinaEngine::Graphics
+{
+	class RingBuffer;
+
+	enum class RenderCommandOp : uint8
+	{
+		SetShader = 0,
+		SetFrameBuffer,
+		SetViewport,
+		SetDrawParameters,
+		Clear,
+		BlitFrameBuffers,
+		SetTexture,
+		UniformInt,
+		UniformFloat,
+		UniformVector2,
+		UniformVector3,
+		UniformVector4,
+		UniformColor,
+		UniformMatrix,
+		UploadStream,
+		BindInstanceStream,
+		SetSpriteBatchStream,
+		Draw,
+		DrawBaseVertex,
+		DrawInstancedBaseVertex,
+		MultiDrawIndirect
+	};
+
+	// Precedes every command, size covers the header, the payload & its trailing data.
+	struct RenderCommandHeader
+	{
+		RenderCommandOp m_op = RenderCommandOp::SetShader;
+		uint32 m_size = 0;
+	};
+
+	struct RenderCommandHandle
+	{
+		uint32 m_id = 0;
+	};
+
+	struct RenderCommandViewport
+	{
+		Vector2 m_pos;
+		Vector2 m_size;
+	};
+
+	struct RenderCommandClear
+	{
+		Color m_color;
+		uint32 m_stencil = 0;
+		bool m_clearColor = false;
+		bool m_clearDepth = false;
+		bool m_clearStencil = false;
+	};
+
+	struct RenderCommandBlit
+	{
+		uint32 m_readFBO = 0;
+		uint32 m_readWidth = 0;
+		uint32 m_readHeight = 0;
+		uint32 m_writeFBO = 0;
+		uint32 m_writeWidth = 0;
+		uint32 m_writeHeight = 0;
+		BufferBit m_mask = BufferBit::BIT_COLOR;
+		SamplerFilter m_filter = SamplerFilter::FILTER_NEAREST;
+	};
+
+	struct RenderCommandTexture
+	{
+		uint32 m_texture = 0;
+		uint32 m_sampler = 0;
+		uint32 m_unit = 0;
+		TextureBindMode m_bindMode = TextureBindMode::BINDTEXTURE_TEXTURE2D;
+		bool m_setSampler = false;
+	};
+
+	// Followed by the value & the uniform name, names aren't null terminated.
+	struct RenderCommandUniform
+	{
+		uint32 m_shader = 0;
+		uint16 m_valueSize = 0;
+		uint16 m_nameSize = 0;
+	};
+
+	// Followed by the data.
+	struct RenderCommandUpload
+	{
+		uintptr m_dataSize = 0;
+	};
+
+	struct RenderCommandInstanceStream
+	{
+		uint32 m_vertexArray = 0;
+		uint32 m_bufferIndex = 0;
+		uint32 m_stream = 0;
+		uintptr m_offset = 0;
+		uintptr m_dataSize = 0;
+	};
+
+	struct RenderCommandSpriteStream
+	{
+		uint32 m_vertexArray = 0;
+		uint32 m_stream = 0;
+		uint32 m_fallbackBuffer = 0;
+		uintptr m_fallbackSize = 0;
+	};
+
+	struct RenderCommandDraw
+	{
+		DrawParams m_params;
+		uint32 m_vertexArray = 0;
+		uint32 m_numInstances = 0;
+		uint32 m_numElements = 0;
+		uint32 m_firstIndex = 0;
+		uint32 m_baseVertex = 0;
+		bool m_drawArrays = false;
+	};
+
+	// Followed by the indirect commands, base instances are relative to the start of the instance stream.
+	struct RenderCommandMultiDraw
+	{
+		DrawParams m_params;
+		uint32 m_vertexArray = 0;
+		uint32 m_bufferIndex = 0;
+		uint32 m_stream = 0;
+		uint32 m_instanceStride = 0;
+		uint32 m_drawCount = 0;
+	};
+
+	class RenderCommandBuffer
+	{
+
+	public:
+
+		RenderCommandBuffer() {};
+		~RenderCommandBuffer() {};
+
+		// Drops the recorded commands, the storage is kept for the next frame.
+		void Reset();
+
+		// Runs the commands on the device, streams are written into the ring buffer & fall back to direct uploads when it is full.
+		void Execute(RenderDevice& device, RingBuffer& ringBuffer);
+
+		void SetShader(uint32 shader);
+		void SetFBO(uint32 fbo);
+		void SetViewport(const Vector2& pos, const Vector2& size);
+		void SetDrawParameters(const DrawParams& drawParams);
+		void Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const Color& color, uint32 stencil);
+		void BlitFrameBuffers(uint32 readFBO, uint32 readWidth, uint32 readHeight, uint32 writeFBO, uint32 writeWidth, uint32 writeHeight, BufferBit mask, SamplerFilter filter);
+		void SetTexture(uint32 texture, uint32 sampler, uint32 unit, TextureBindMode bindTextureMode = TextureBindMode::BINDTEXTURE_TEXTURE2D, bool setSampler = false);
+		void UpdateShaderUniformInt(uint32 shader, const std::string& uniform, int value);
+		void UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, float value);
+		void UpdateShaderUniformVector2(uint32 shader, const std::string& uniform, const Vector2& value);
+		void UpdateShaderUniformVector3(uint32 shader, const std::string& uniform, const Vector3& value);
+		void UpdateShaderUniformVector4F(uint32 shader, const std::string& uniform, const Vector4& value);
+		void UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& value);
+		void UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, const Matrix& value);
+
+		// Copies the data into the buffer, returns the stream index the bind & indirect draw commands refer to.
+		uint32 UploadStream(const void* data, uintptr dataSize);
+
+		// Sources an instance component from a range of the stream.
+		void BindInstanceStream(uint32 vao, uint32 bufferIndex, uint32 stream, uintptr offset, uintptr dataSize);
+
+		// Sources the sprite batch vertices from the stream, the fallback buffer is orphaned & refilled if the ring is full.
+		void SetSpriteBatchStream(uint32 vao, uint32 stream, uint32 fallbackBuffer, uintptr fallbackSize);
+
+		void Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays = false);
+		void DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex);
+		void DrawInstancedBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, uint32 firstIndex, uint32 baseVertex);
+
+		// Reserves the indirect commands, the caller fills them in. Drawn one by one if the ring is full.
+		DrawElementsIndirectCommand* MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, uint32 bufferIndex, uint32 stream, uint32 instanceStride, uint32 drawCount);
+
+		bool IsEmpty() const { return m_data.empty(); }
+		uintptr GetSize() const { return m_data.size(); }
+		uint32 GetCommandCount() const { return m_commandCount; }
+		uint32 GetDrawCount() const { return m_drawCount; }
+		uint32 GetIndirectDrawCount() const { return m_indirectDrawCount; }
+
+	private:
+
+		uint8* Allocate(RenderCommandOp op, uintptr payloadSize);
+		void PushUniform(RenderCommandOp op, uint32 shader, const std::string& uniform, const void* value, uint16 valueSize);
+
+		template<typename T>
+		T* Push(RenderCommandOp op, uintptr trailingSize = 0)
+		{
+			return new (Allocate(op, sizeof(T) + trailingSize)) T();
+		}
+
+	private:
+
+		std::vector<uint8> m_data;
+		uint32 m_commandCount = 0;
+		uint32 m_streamCount = 0;
+		uint32 m_drawCount = 0;
+		uint32 m_indirectDrawCount = 0;
+
+		// Resolved while executing, ring offsets & the recorded data of each stream.
+		std::vector<uintptr> m_streamOffsets;
+		std::vector<const uint8*> m_streamData;
+		std::string m_uniformName;
+	};
+}
+
+#endif
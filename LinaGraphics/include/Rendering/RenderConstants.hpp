@@ -45,16 +45,11 @@ namespace LinaEngine::Graphics
 {
 
 
-#define SC_LIGHTCOLOR std::string(".color")
-#define SC_LIGHTDISTANCE std::string(".distance")
-#define SC_LIGHTCUTOFF std::string(".cutOff")
-#define SC_LIGHTOUTERCUTOFF std::string(".outerCutOff")
-#define SC_LIGHTINTENSITY std::string(".intensity")
-#define SC_LIGHTDIRECTION std::string(".direction")
-#define SC_LIGHTPOSITION std::string(".position")
-#define SC_DIRECTIONALLIGHT std::string("directionalLight")
-#define SC_POINTLIGHTS std::string("pointLights")
-#define SC_SPOTLIGHTS std::string("spotLights")
+#define SC_LIGHTBUFFER std::string("lightBuffer")
+#define SC_LIGHTCLUSTERGRID std::string("lightClusterGrid")
+#define SC_LIGHTCLUSTERINDICES std::string("lightClusterIndices")
+#define SC_SHADOWCASCADEMAP std::string("shadowCascadeMap")
+#define SC_RECEIVESHADOWS std::string("receiveShadows")
 
 #define MAT_COLOR "material.color"
 #define MAT_STARTCOLOR "material.startColor"
@@ -83,6 +78,7 @@ namespace LinaEngine::Graphics
 #define MAT_SURFACETYPE "material.surfaceType"
 #define MAT_TILING "material.tiling"
 #define MAT_ISHORIZONTAL "material.horizontal"
+#define MAT_KARISAVERAGE "material.karisAverage"
 #define MAT_BLOOMENABLED "material.bloomEnabled"
 #define MAT_FXAAENABLED "material.fxaaEnabled"
 #define MAT_FXAASPANMAX "material.fxaaSpanMax"
@@ -91,6 +87,7 @@ namespace LinaEngine::Graphics
 #define MAT_EXPOSURE "material.exposure"
 #define MAT_GAMMA "material.gamma"
 #define MAT_INVERSESCREENMAPSIZE "material.inverseScreenMapSize"
+#define MAT_RENDERSCALE "material.renderScale"
 #define MAT_EXTENSION_TEXTURE2D ".texture"
 #define MAT_EXTENSION_ISACTIVE ".isActive"
 #define MAT_TIME "material.time"
@@ -100,6 +97,10 @@ namespace LinaEngine::Graphics
 #define UF_MATRIX_VIEW "view"
 #define UF_MATRIX_PROJECTION "projection"
 #define UF_FLOAT_TIME "uf_time"
+#define UF_MATRIX_LIGHTVIEWPROJECTION "uf_lightViewProjection"
+#define UF_QUANTIZEDVERTICES "uf_quantizedVertices"
+#define UF_POSITIONOFFSET "uf_positionOffset"
+#define UF_POSITIONSCALE "uf_positionScale"
 
 }
 #endif
\ No newline at end of file
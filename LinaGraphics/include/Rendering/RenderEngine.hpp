@@ -52,6 +52,14 @@ Timestamp: 4/15/2019 12:26:31 PM
 #include "Rendering/RenderBuffer.hpp"
 #include "Mesh.hpp"
 #include "UniformBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "RenderCommandBuffer.hpp"
+#include "RenderGraph.hpp"
+#include "GeometryPool.hpp"
+#include "DebugRenderer.hpp"
+#include "ShadowCascades.hpp"
+#include "HDRICache.hpp"
+#include "DynamicResolution.hpp"
 #include "Window.hpp"
 #include "RenderContext.hpp"
 #include "Utility/Math/Color.hpp"
@@ -74,12 +82,6 @@ namespace LinaEngine::Graphics
 {
 	class Shader;
 
-	struct BufferValueRecord
-	{
-		float zNear;
-		float zFar;
-	};
-
 	class RenderEngine
 	{
 	public:
@@ -96,37 +98,54 @@ namespace LinaEngine::Graphics
 		void PushOverlay(Layer& layer);
 		void MaterialUpdated(Material& mat);
 		void UpdateShaderData(Material* mat);
+
+		// Records the material's shader data, used by the passes recording on workers.
+		void RecordShaderData(Material* mat, RenderCommandBuffer& commands);
+
+		// Runs the recorded commands on the render device, streams go through the frame ring buffer.
+		void ExecuteCommands(RenderCommandBuffer& commands);
 		void SetDrawParameters(const DrawParams& params);
 		void UpdateRenderSettings();
 		void* GetFinalImage();
 		void* GetShadowMapImage();
+		void* GetOcclusionBufferImage();
+		RingBuffer& GetFrameRingBuffer() { return m_frameRingBuffer; }
+		DebugRenderer& GetDebugRenderer() { return m_debugRenderer; }
+		const ShadowCascades& GetShadowCascades() const { return m_shadowCascades; }
 		void UpdateSystems();
 
+		// Starts rasterizing this frame's occluders on a worker, called before the simulation step.
+		void KickOcclusionCulling();
+
 
 		// Initializes the setup process for loading an HDRI image to the scene
 		void CaptureCalculateHDRI(Texture& hdriTexture);
 		void SetHDRIData(Material* mat);
 		void RemoveHDRIData(Material* mat);
 
+		// Diffuse IBL from 9 SH coefficients instead of the irradiance cubemap, applies to the next capture.
+		void SetUseIrradianceSH(bool use) { m_useIrradianceSH = use; }
+		bool GetUseIrradianceSH() const { return m_useIrradianceSH; }
+
 		void DrawLine(Vector3 p1, Vector3 p2, Color col, float width = 1.0f);
 
 		void CustomDrawActivation(bool activate) { m_customDrawEnabled = activate; }
 		void SetCustomDrawFunction(const std::function<void()>& func) { m_customDrawFunction = func; }
 
-		Texture& GetFinalImageTexture() { return m_primaryRTTexture0; }
 		void SetPostSceneDrawCallback(std::function<void()>& cb) { m_postSceneDrawCallback = cb; }
 		Vector2 GetViewportSize() { return m_viewportSize; }
+		Vector2 GetScaledRenderSize() const { return m_renderGraph.GetScaledSize(m_renderTargetSize); }
+		DynamicResolution& GetDynamicResolution() { return m_dynamicResolution; }
 		ECS::CameraSystem* GetCameraSystem() { return &m_cameraSystem; }
 		ECS::MeshRendererSystem* GetMeshRendererSystem() { return &m_meshRendererSystem; }
 		Texture& GetHDRICubemap() { return m_hdriCubemap; }
 		static RenderDevice& GetRenderDevice() { return s_renderDevice; }
+		static GeometryPool& GetGeometryPool() { return s_geometryPool; }
 		static Texture& GetDefaultTexture() { return s_defaultTexture; }
 		static Material& GetDefaultUnlitMaterial() { return s_defaultUnlit; }
 		static Shader& GetDefaultShader() { return *s_standardUnlitShader; }
 		RenderSettings& GetRenderSettings() { return m_renderSettings; }
 		DrawParams GetMainDrawParams() { return m_defaultDrawParams; }
-		void SetCurrentPLightCount(int count) { m_currentPointLightCount = count; }
-		void SetCurrentSLightCount(int count) { m_currentSpotLightCount = count; }
 		void SetPreDrawCallback(const std::function<void()>& cb) { m_preDrawCallback = cb; };
 		void SetPostDrawCallback(const std::function<void()>& cb) { m_postDrawCallback = cb; };
 		void DrawSceneObjects(DrawParams& drawpParams, Material* overrideMaterial = nullptr);
@@ -139,31 +158,42 @@ namespace LinaEngine::Graphics
 		void ConstructEngineMaterials();
 		void ConstructEnginePrimitives();
 		void ConstructRenderTargets();
+		void ConstructRenderGraph();
+		void UpdateRenderTargetSize();
 		void DumpMemory();
-		void DrawShadows();
+		void RecordShadows(RenderCommandBuffer& commands);
+		void RecordPasses(DrawParams& drawParams, Material* overrideMaterial, bool recordShadows);
+		void SubmitScenePasses(bool drawDebugLines);
 		void Draw();
-		void DrawFinalize();
+		void DrawScene();
+		void DrawBloomDownsample(uint32 source, bool karisAverage);
+		void DrawBloomUpsample(uint32 lower, uint32 level);
+		void DrawFinalize(uint32 bloom);
 		void DrawOperationsDefault();
 		void UpdateUniformBuffers();
+		void UploadUniformBlock(UniformBuffer& buffer, uint32 bindPoint, const void* data, uintptr dataSize);
 		
 		// Generating necessary maps for HDRI specular highlighting
 		void CalculateHDRICubemap(Texture& hdriTexture, glm::mat4& captureProjection, glm::mat4 views[6]);
 		void CalculateHDRIIrradiance(Matrix& captureProjection, Matrix views[6]);
 		void CalculateHDRIPrefilter(Matrix& captureProjection, Matrix views[6]);
-		void CalculateHDRIBRDF(Matrix& captureProjection, Matrix views[6]);
+		void ConstructBRDFLut();
+		void LoadHDRICache(const HDRICacheData& cache);
+		bool ReadHDRICubemap(Texture& cubemap, uint32 resolution, uint32 mipCount, std::vector<uint16>& data);
+		void UploadHDRICubemap(Texture& cubemap, uint32 resolution, uint32 mipCount, const std::vector<uint16>& data);
 
 
 	private:
 
 		static RenderDevice s_renderDevice;
+
+		// Shared vertex & index storage mesh vertex arrays are placed into.
+		static GeometryPool s_geometryPool;
 		Window* m_appWindow;
 
-		RenderTarget m_primaryRenderTarget;
-		RenderTarget m_pingPongRenderTarget1;
-		RenderTarget m_pingPongRenderTarget2;
-		RenderTarget m_outlineRenderTarget;
 		RenderTarget m_hdriCaptureRenderTarget;
 		RenderTarget m_shadowMapTarget;
+		RenderTarget m_shadowStaticTarget;
 
 #ifdef LINA_EDITOR
 		RenderTarget m_secondaryRenderTarget;
@@ -171,47 +201,48 @@ namespace LinaEngine::Graphics
 		Texture m_secondaryRTTexture;
 #endif
 
-		RenderBuffer m_primaryRenderBuffer;
 		RenderBuffer m_hdriCaptureRenderBuffer;
 
 		// Frame buffer texture parameters
 		SamplerParameters m_mainRTParams;
 		SamplerParameters m_primaryRTParams;
-		SamplerParameters m_pingPongRTParams;
+		SamplerParameters m_bloomRTParams;
 		SamplerParameters m_shadowsRTParams;
+		SamplerParameters m_occlusionDebugParams;
+		SamplerParameters m_hdriCubemapParams;
+		SamplerParameters m_hdriIrradianceParams;
+		SamplerParameters m_hdriPrefilterParams;
+		SamplerParameters m_hdriLutParams;
+		Sampler m_bloomSampler;
 
 		Material m_screenQuadFinalMaterial;
-		Material m_screenQuadBlurMaterial;
 		Material m_screenQuadOutlineMaterial;
 		Material* m_skyboxMaterial = nullptr;
-		Material m_debugDrawMaterial;
 		Material m_hdriMaterial;
 		Material m_shadowMapMaterial;
 		Material m_defaultSkyboxMaterial;
 		static Material s_defaultUnlit;
 
-		Shader* m_hdriBRDFShader = nullptr;
 		Shader* m_hdriPrefilterShader = nullptr;
 		Shader* m_hdriEquirectangularShader = nullptr;
 		Shader* m_hdriIrradianceShader = nullptr;
 		Shader* m_sqFinalShader = nullptr;
-		Shader* m_sqBlurShader = nullptr;
+		Shader* m_sqBloomDownsampleShader = nullptr;
+		Shader* m_sqBloomUpsampleShader = nullptr;
 		Shader* m_sqOutlineShader = nullptr;
 		Shader* m_sqShadowMapShader = nullptr;
 		Shader* m_debugLineShader = nullptr;
 		Shader* m_skyboxSingleColorShader = nullptr;
 		static Shader* s_standardUnlitShader;
 
-		Texture m_primaryRTTexture0;
-		Texture m_primaryRTTexture1;
-		Texture m_pingPongRTTexture1;
-		Texture m_pingPongRTTexture2;
-		Texture m_outlineRTTexture;
 		Texture m_hdriCubemap;
 		Texture m_hdriIrradianceMap;
 		Texture m_hdriPrefilterMap;
 		Texture m_HDRILutMap;
 		Texture m_shadowMapRTTexture;
+		Texture m_shadowStaticRTTexture;
+		Texture m_occlusionDebugTexture;
+		std::vector<uint8> m_occlusionDebugPixels;
 		static Texture s_defaultTexture;
 		Texture m_defaultCubemapTexture;
 
@@ -219,6 +250,7 @@ namespace LinaEngine::Graphics
 		DrawParams m_skyboxDrawParams;
 		DrawParams m_fullscreenQuadDP;
 		DrawParams m_shadowMapDrawParams;
+		DrawParams m_debugLineDrawParams;
 
 		UniformBuffer m_globalDataBuffer;
 		UniformBuffer m_globalLightBuffer;
@@ -228,8 +260,33 @@ namespace LinaEngine::Graphics
 		RenderingDebugData m_debugData;
 		RenderSettings m_renderSettings;
 
-		// Structure that keeps track of current buffer values
-		BufferValueRecord m_bufferValueRecord;
+		// Per-frame dynamic data, instance buffers & uniform blocks are bound by offset.
+		RingBuffer m_frameRingBuffer;
+		uint32 m_uniformBufferAlignment = 256;
+
+		// Passes record into their own buffers on workers, the opaque queue in chunks. Executed in this order on the render thread.
+		RenderCommandBuffer m_shadowCommands;
+		std::vector<RenderCommandBuffer> m_opaqueCommands;
+		RenderCommandBuffer m_transparentCommands;
+		RenderCommandBuffer m_spriteCommands;
+		RenderCommandBuffer m_immediateCommands;
+		uint32 m_opaqueChunkCount = 0;
+
+		// Scene & post process targets are transient, allocated from the graph's pool for the passes that survive culling.
+		RenderGraph m_renderGraph;
+		uint32 m_rgSceneColor = RENDERGRAPH_INVALID_HANDLE;
+		uint32 m_rgOutput = RENDERGRAPH_INVALID_HANDLE;
+		bool m_renderGraphDirty = true;
+		bool m_customDrawActive = false;
+
+		// Scale of the region the scene & bloom passes render into, the final composite upscales it to the output.
+		DynamicResolution m_dynamicResolution;
+
+		// Batched debug lines & shapes, drawn after the scene.
+		DebugRenderer m_debugRenderer;
+
+		// Directional light cascades, tiles of the shadow map atlas. Static casters are kept in their own atlas between frames.
+		ShadowCascades m_shadowCascades;
 
 		LinaEngine::ECS::CameraSystem m_cameraSystem;
 		LinaEngine::ECS::MeshRendererSystem m_meshRendererSystem;
@@ -242,18 +299,23 @@ namespace LinaEngine::Graphics
 		uint32 m_skyboxVAO = 0;
 		uint32 m_screenQuadVAO = 0;
 		uint32 m_hdriCubeVAO = 0;
-		uint32 m_lineVAO = 0;
 
-		int m_currentSpotLightCount = 0;
-		int m_currentPointLightCount = 0;
 		bool m_hdriDataCaptured = false;
+		bool m_useIrradianceSH = true;
+		bool m_hdriIrradianceSHActive = false;
+		float m_hdriIrradianceSH[HDRICACHE_SH_COEFFICIENTS * 3] = { 0.0f };
 		bool m_customDrawEnabled;
 
 		Vector2 m_hdriResolution = Vector2(512, 512);
-		Vector2 m_shadowMapResolution = Vector2(2048, 2048);
+		Vector2 m_shadowMapResolution = Vector2(SHADOWCASCADE_ATLAS_RESOLUTION, SHADOWCASCADE_ATLAS_RESOLUTION);
 		Vector2 m_viewportPos = Vector2::Zero;
 		Vector2 m_viewportSize = Vector2::Zero;
 
+		// Size the transient targets are allocated at, follows the viewport once it stops changing.
+		Vector2 m_renderTargetSize = Vector2::Zero;
+		Vector2 m_pendingRenderTargetSize = Vector2::Zero;
+		uint32 m_resizeSettleFrames = 0;
+
 		std::function<void()> m_postSceneDrawCallback;
 		std::function<void()> m_preDrawCallback;
 		std::function<void()> m_postDrawCallback;
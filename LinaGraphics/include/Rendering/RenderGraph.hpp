@@ -0,0 +1,165 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderGraph
+
+Frame graph, passes declare the resources they read & write and are executed in the order they were
+added. Compiling culls the passes nothing depends on & computes the lifetime of every transient
+resource, transients are acquired from the target pool right before their first pass and released
+after their last one so that resources with disjoint lifetimes share the same allocation.
+
+Timestamp: 10/19/2026 10:41:09 PM
+*/
+
+#pragma once
+
+#ifndef RenderGraph_HPP
+#define RenderGraph_HPP
+
+#include "Rendering/RenderTargetPool.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+#define RENDERGRAPH_INVALID_HANDLE ((uint32)-1)
+
+namespace LinaEngine::Graphics
+{
+	class Texture;
+
+	enum class RenderGraphResourceType : uint8
+	{
+		Texture,
+		DepthBuffer,
+		Imported
+	};
+
+	struct RenderGraphResource
+	{
+		std::string m_name;
+		RenderGraphResourceType m_type = RenderGraphResourceType::Texture;
+		SamplerParameters m_samplerParams;
+		RenderBufferStorage m_storage = RenderBufferStorage::STORAGE_DEPTH;
+		float m_sizeScale = 1.0f;
+
+		// Imported targets are owned outside of the graph.
+		uint32 m_importedFBO = 0;
+		Texture* m_importedTexture = nullptr;
+		Vector2 m_importedPos = Vector2::Zero;
+		Vector2 m_importedSize = Vector2::One;
+
+		// Filled by compile & execute.
+		uint32 m_writer = RENDERGRAPH_INVALID_HANDLE;
+		uint32 m_lastReader = RENDERGRAPH_INVALID_HANDLE;
+		uint32 m_poolEntry = RENDERTARGETPOOL_INVALID_ENTRY;
+	};
+
+	struct RenderGraphPass
+	{
+		std::string m_name;
+		std::function<void()> m_execute;
+		std::vector<uint32> m_reads;
+		std::vector<uint32> m_colorWrites;
+		uint32 m_depthWrite = RENDERGRAPH_INVALID_HANDLE;
+		uint32 m_importedWrite = RENDERGRAPH_INVALID_HANDLE;
+		bool m_hasSideEffects = false;
+
+		// Filled by compile.
+		std::vector<uint32> m_acquires;
+		std::vector<uint32> m_releases;
+		bool m_isCulled = true;
+	};
+
+	class RenderGraph
+	{
+	public:
+
+		RenderGraph() {}
+		~RenderGraph() {}
+
+		void Construct(RenderDevice& renderDeviceIn, const Vector2& renderSize);
+
+		// Removes every pass & resource, pooled allocations are kept for the next setup.
+		void Reset();
+
+		// Transient resources, sized relative to the render size.
+		uint32 CreateTexture(const std::string& name, const SamplerParameters& samplerParams, float sizeScale = 1.0f);
+		uint32 CreateDepthBuffer(const std::string& name, RenderBufferStorage storage, float sizeScale = 1.0f);
+
+		// Targets living outside of the graph, e.g. the default frame buffer or the shadow atlas.
+		uint32 ImportTarget(const std::string& name, uint32 fbo, Texture* texture, const Vector2& pos, const Vector2& size);
+		void UpdateImportedTarget(uint32 resource, uint32 fbo, const Vector2& pos, const Vector2& size);
+
+		// Passes with side effects are never culled, the rest only run if a later pass reads their output.
+		uint32 AddPass(const std::string& name, const std::function<void()>& execute, bool hasSideEffects = false);
+		void Read(uint32 pass, uint32 resource);
+
+		// Textures are bound as color attachments in the order they are written.
+		void Write(uint32 pass, uint32 resource);
+
+		// Culls the unused passes & attachments, computes the transient lifetimes. Returns false if the setup is invalid.
+		bool Compile();
+
+		// Runs the passes, each one with its own targets bound.
+		void Execute();
+
+		// Storage of the pooled allocations is re-specified in place.
+		void Resize(const Vector2& renderSize) { m_pool.Resize(renderSize); }
+
+		// Pooled passes render into the bottom left region of their targets scaled by this, the allocations stay untouched.
+		void SetViewportScale(float scale) { m_viewportScale = scale; }
+		float GetViewportScale() const { return m_viewportScale; }
+		Vector2 GetScaledSize(const Vector2& size) const;
+
+		// Valid while the pass reading the resource runs.
+		Texture* GetTexture(uint32 resource);
+		Vector2 GetSize(uint32 resource);
+		Vector2 GetViewportSize(uint32 resource);
+		bool IsPassCulled(uint32 pass) const { return m_passes[pass].m_isCulled; }
+		bool IsCompiled() const { return m_isCompiled; }
+		const Vector2& GetRenderSize() const { return m_pool.GetRenderSize(); }
+		RenderTargetPool& GetPool() { return m_pool; }
+
+	private:
+
+		uint32 AddResource(const std::string& name, RenderGraphResourceType type);
+		bool IsAttached(uint32 resource) const;
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		RenderTargetPool m_pool;
+		std::vector<RenderGraphPass> m_passes;
+		std::vector<RenderGraphResource> m_resources;
+		bool m_isCompiled = false;
+		float m_viewportScale = 1.0f;
+	};
+}
+
+#endif
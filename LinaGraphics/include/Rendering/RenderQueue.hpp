@@ -0,0 +1,120 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderQueue
+
+Flat list of draw requests keyed by 64-bit sort keys. Keys encode the pass, shader, material,
+mesh & quantized depth so a single radix sort yields the submission order, after which
+consecutive requests sharing the same vertex array & material are merged into instanced draws.
+
+Timestamp: 10/19/2026 2:14:05 PM
+*/
+
+#pragma once
+
+#ifndef RenderQueue_HPP
+#define RenderQueue_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include "Utility/Math/Matrix.hpp"
+#include "Rendering/RenderingCommon.hpp"
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	class VertexArray;
+	class Material;
+
+	enum class RenderQueuePass : uint8
+	{
+		Opaque = 0,
+		Transparent = 1
+	};
+
+	struct RenderQueueItem
+	{
+		uint64 m_key = 0;
+		uint32 m_drawIndex = 0;
+	};
+
+	struct RenderQueueDraw
+	{
+		VertexArray* m_vertexArray = nullptr;
+		Material* m_material = nullptr;
+		InstanceTransform m_transform;
+	};
+
+	// Consecutive sorted draws that share state, submitted as a single instanced call.
+	struct RenderQueueBatch
+	{
+		VertexArray* m_vertexArray = nullptr;
+		Material* m_material = nullptr;
+		uint32 m_firstInstance = 0;
+		uint32 m_instanceCount = 0;
+	};
+
+	class RenderQueue
+	{
+
+	public:
+
+		RenderQueue() {};
+		~RenderQueue() {};
+
+		// Builds a key, opaque keys sort front-to-back within a material, transparent keys sort back-to-front.
+		static uint64 GenerateKey(RenderQueuePass pass, uint32 shaderID, uint32 materialID, uint32 meshID, float normalizedDepth);
+
+		void Push(uint64 key, VertexArray& vertexArray, Material& material, const Matrix& model);
+		void Reserve(size_t count);
+		void Clear();
+
+		// Radix sorts the items & rebuilds the instance data and batches in the sorted order.
+		void Sort();
+
+		const std::vector<RenderQueueBatch>& GetBatches() const { return m_batches; }
+		const std::vector<InstanceTransform>& GetInstances() const { return m_instances; }
+		size_t GetDrawCount() const { return m_items.size(); }
+		bool IsSorted() const { return m_isSorted; }
+
+	private:
+
+		void RadixSort();
+
+	private:
+
+		std::vector<RenderQueueItem> m_items;
+		std::vector<RenderQueueItem> m_sortBuffer;
+		std::vector<RenderQueueDraw> m_draws;
+		std::vector<RenderQueueBatch> m_batches;
+		std::vector<InstanceTransform> m_instances;
+		bool m_isSorted = true;
+	};
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderQueueBenchmark
+
+Times building & sorting the sort-key render queues at several draw counts against the per material
+map & priority queue batching they replaced, on the same random draws. No device work is involved,
+draws only reference stand-in vertex arrays & materials.
+
+Timestamp: 10/20/2026 9:12:41 AM
+*/
+
+#pragma once
+
+#ifndef RenderQueueBenchmark_HPP
+#define RenderQueueBenchmark_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	struct RenderQueueBenchmarkResult
+	{
+		size_t m_drawCount = 0;
+
+		// Map & priority queue path, flushing walks the map & pops the queue.
+		double m_mapBuildMS = 0.0;
+		double m_mapFlushMS = 0.0;
+		size_t m_mapBatchCount = 0;
+
+		// Sort-key path, sorting includes laying out the instances & merging the batches.
+		double m_queueBuildMS = 0.0;
+		double m_queueSortMS = 0.0;
+		size_t m_queueBatchCount = 0;
+	};
+
+	class RenderQueueBenchmark
+	{
+	public:
+
+		// Best time of the iterations for each draw count, a fifth of the draws are transparent.
+		static std::vector<RenderQueueBenchmarkResult> Run(const std::vector<size_t>& drawCounts = { 10000, 100000 }, uint32 iterations = 8);
+		static void LogResults(const std::vector<RenderQueueBenchmarkResult>& results);
+	};
+}
+
+#endif
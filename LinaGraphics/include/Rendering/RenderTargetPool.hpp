@@ -0,0 +1,131 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderTargetPool
+
+Owns the transient frame buffer textures & depth buffers used by the render graph. Allocations are
+sized relative to the render size & handed out per pass, released ones are reused by later passes
+with the same format. Resizing re-specifies the storage in place so cached frame buffers stay valid,
+allocations nobody asked for in a while are released.
+
+Timestamp: 10/19/2026 10:27:44 PM
+*/
+
+#pragma once
+
+#ifndef RenderTargetPool_HPP
+#define RenderTargetPool_HPP
+
+#include "Rendering/RenderingCommon.hpp"
+#include "PackageManager/PAMRenderDevice.hpp"
+#include <vector>
+
+#define RENDERTARGETPOOL_INVALID_ENTRY ((uint32)-1)
+#define RENDERTARGETPOOL_MAX_COLOR_ATTACHMENTS 4
+#define RENDERTARGETPOOL_MAX_IDLE_FRAMES 120
+
+namespace LinaEngine::Graphics
+{
+	class Texture;
+
+	struct RenderTargetPoolEntry
+	{
+		Texture* m_texture = nullptr;
+		uint32 m_renderBuffer = 0;
+		SamplerParameters m_samplerParams;
+		RenderBufferStorage m_storage = RenderBufferStorage::STORAGE_DEPTH;
+		Vector2 m_size = Vector2::One;
+		float m_sizeScale = 1.0f;
+		uint32 m_lastUsedFrame = 0;
+		bool m_isDepth = false;
+		bool m_isAllocated = false;
+		bool m_inUse = false;
+	};
+
+	struct RenderTargetPoolFrameBuffer
+	{
+		uint32 m_colorEntries[RENDERTARGETPOOL_MAX_COLOR_ATTACHMENTS];
+		uint32 m_colorCount = 0;
+		uint32 m_depthEntry = RENDERTARGETPOOL_INVALID_ENTRY;
+		uint32 m_fbo = 0;
+	};
+
+	class RenderTargetPool
+	{
+	public:
+
+		RenderTargetPool() {}
+		~RenderTargetPool();
+
+		void Construct(RenderDevice& renderDeviceIn, const Vector2& renderSize);
+
+		// Returns a free color texture matching the parameters, created if none is available.
+		uint32 AcquireTexture(const SamplerParameters& samplerParams, float sizeScale);
+
+		// Returns a free depth buffer matching the storage, created if none is available.
+		uint32 AcquireDepthBuffer(RenderBufferStorage storage, float sizeScale);
+
+		// Makes the entry available for the next acquire, the allocation is kept.
+		void Release(uint32 entry);
+
+		// Returns the frame buffer with the given attachments, invalid color entries are left unattached.
+		uint32 GetFrameBuffer(const uint32* colorEntries, uint32 colorCount, uint32 depthEntry);
+
+		// Re-specifies every allocation for the new render size.
+		void Resize(const Vector2& renderSize);
+
+		// Releases the allocations that were not acquired for RENDERTARGETPOOL_MAX_IDLE_FRAMES.
+		void NextFrame();
+
+		Texture* GetTexture(uint32 entry) { return entry < m_entries.size() ? m_entries[entry].m_texture : nullptr; }
+		Vector2 GetSize(uint32 entry) const { return entry < m_entries.size() ? m_entries[entry].m_size : Vector2::Zero; }
+		const Vector2& GetRenderSize() const { return m_renderSize; }
+		uint32 GetTextureCount() const { return m_textureCount; }
+		uint32 GetDepthBufferCount() const { return m_depthBufferCount; }
+
+	private:
+
+		uint32 Acquire(bool isDepth, const SamplerParameters& samplerParams, RenderBufferStorage storage, float sizeScale);
+		uint32 FindFreeSlot();
+		Vector2 GetScaledSize(float sizeScale) const;
+		void Free(uint32 entry);
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		std::vector<RenderTargetPoolEntry> m_entries;
+		std::vector<RenderTargetPoolFrameBuffer> m_frameBuffers;
+		Vector2 m_renderSize = Vector2::One;
+		uint32 m_frame = 0;
+		uint32 m_textureCount = 0;
+		uint32 m_depthBufferCount = 0;
+	};
+}
+
+#endif
@@ -43,6 +43,7 @@ Timestamp: 4/14/2019 11:59:32 AM
 #include "Utility/Math/Matrix.hpp"
 #include "Utility/Math/Color.hpp"
 #include "map"
+#include <cereal/cereal.hpp>
 namespace LinaEngine::Graphics
 {
 #define INTERNAL_MAT_PATH "__internal"
@@ -51,6 +52,16 @@ namespace LinaEngine::Graphics
 #define RENDERSETTINGS_FOLDERPATH "resources/engine"
 #define RENDERSETTINGS_FILE "defaultSettings"
 
+	// GPU storage of a vertex element, element data is always held as floats on the CPU & converted when uploaded.
+	enum VertexElementType
+	{
+		ELEMENT_INT = 0,
+		ELEMENT_FLOAT = 1,
+		ELEMENT_UNORM16 = 2,
+		ELEMENT_SNORM16 = 3,
+		ELEMENT_HALF = 4
+	};
+
 	enum BufferUsage
 	{
 		USAGE_STATIC_DRAW = LINA_GRAPHICS_USAGE_STATIC_DRAW,
@@ -97,7 +108,8 @@ namespace LinaEngine::Graphics
 		BINDTEXTURE_TEXTURE2D = LINA_GRAPHICS_BINDTEXTURE_TEXTURE2D,
 		BINDTEXTURE_CUBEMAP = LINA_GRAPHICS_BINDTEXTURE_CUBEMAP,
 		BINDTEXTURE_CUBEMAP_POSITIVE_X = LINA_GRAPHICS_BINDTEXTURE_CUBEMAP_POSITIVE_X,
-		BINDTEXTURE_TEXTURE2D_MULTISAMPLE = LINA_GRAPHICS_BINDTEXTURE_TEXTURE2D_MULTISAMPLE
+		BINDTEXTURE_TEXTURE2D_MULTISAMPLE = LINA_GRAPHICS_BINDTEXTURE_TEXTURE2D_MULTISAMPLE,
+		BINDTEXTURE_TEXTUREBUFFER = LINA_GRAPHICS_BINDTEXTURE_TEXTUREBUFFER
 	};
 
 	enum PixelFormat
@@ -112,7 +124,10 @@ namespace LinaEngine::Graphics
 		FORMAT_DEPTH_AND_STENCIL = 7,
 		FORMAT_SRGB = 8,
 		FORMAT_SRGBA = 9,
-		FORMAT_DEPTH16 = 10
+		FORMAT_DEPTH16 = 10,
+		FORMAT_R32UI = 11,
+		FORMAT_RG32UI = 12,
+		FORMAT_RGBA32F = 13
 	};
 
 
@@ -264,6 +279,44 @@ namespace LinaEngine::Graphics
 		bool visualizeDepth;
 	};
 
+	// Per-instance transform, the rows of the 3x4 affine model matrix. The normal matrix is derived in the shaders.
+	struct InstanceTransform
+	{
+		InstanceTransform() {};
+		InstanceTransform(const Matrix& model)
+		{
+			for (int i = 0; i < 3; i++)
+				m_rows[i] = Vector4(model[0][i], model[1][i], model[2][i], model[3][i]);
+		}
+
+		Vector4 m_rows[3];
+	};
+
+	// Layout of a single indexed indirect draw, consumed by the device as it is.
+	struct DrawElementsIndirectCommand
+	{
+		uint32 m_count = 0;
+		uint32 m_instanceCount = 0;
+		uint32 m_firstIndex = 0;
+		int32 m_baseVertex = 0;
+		uint32 m_baseInstance = 0;
+	};
+
+	// Vertex streamed by the sprite batcher, corners are transformed on the CPU & the color is RGBA8.
+	struct SpriteVertex
+	{
+		float m_position[3];
+		float m_uv[2];
+		uint32 m_color;
+	};
+
+	// Vertex streamed by the debug renderer, pairs of these form the lines.
+	struct LineVertex
+	{
+		float m_position[3];
+		uint32 m_color;
+	};
+
 
 	enum MaterialSurfaceType
 	{
@@ -291,11 +344,20 @@ namespace LinaEngine::Graphics
 		bool m_calculateTangentSpace = true;
 		bool m_flipWinding = false;
 		bool m_flipUVs = false;
+		bool m_optimizeVertexOrder = true;
+		bool m_quantizeVertices = false;
+		int m_lodCount = 3;
+		float m_lodReduction = 0.5f;
+		float m_lodScreenSize = 0.3f;
 
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t version)
 		{
 			archive(m_triangulate, m_smoothNormals, m_calculateTangentSpace, m_flipUVs, m_flipWinding);
+
+			// LOD chain, vertex order optimization & quantization, files older than version 1 keep the defaults.
+			if (version >= 1)
+				archive(m_lodCount, m_lodReduction, m_lodScreenSize, m_optimizeVertexOrder, m_quantizeVertices);
 		}
 	};
 
@@ -367,5 +429,6 @@ namespace LinaEngine::Graphics
 
 }
 
+CEREAL_CLASS_VERSION(LinaEngine::Graphics::MeshParameters, 1);
 
 #endif
\ No newline at end of file
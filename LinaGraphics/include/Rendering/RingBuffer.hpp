@@ -0,0 +1,93 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RingBuffer
+
+Per-frame allocator for dynamic GPU data such as instance matrices & uniform blocks. The buffer
+is split in one segment per frame in flight, segments are fenced & only reused once the GPU is done.
+Persistently mapped where GL 4.4 is available, falls back to orphaning otherwise.
+
+Timestamp: 10/19/2026 7:24:51 PM
+*/
+
+#pragma once
+
+#ifndef RingBuffer_HPP
+#define RingBuffer_HPP
+
+#include "PackageManager/PAMRenderDevice.hpp"
+
+#define RINGBUFFER_FRAME_COUNT 3
+#define RINGBUFFER_INVALID_OFFSET ((uintptr)-1)
+
+namespace LinaEngine::Graphics
+{
+	class RingBuffer
+	{
+	public:
+
+		RingBuffer() {}
+		~RingBuffer();
+
+		// Creates the buffer, frame size is the amount of data that can be written in a single frame.
+		void Construct(RenderDevice& renderDeviceIn, uintptr frameSize);
+
+		// Copies the data into the current frame, returns the offset from the buffer start or RINGBUFFER_INVALID_OFFSET if the frame is full.
+		uintptr Write(const void* data, uintptr dataSize, uintptr alignment = 16);
+
+		// Fences the current frame & moves to the next segment, grows the buffer if the last frames overflowed.
+		void NextFrame();
+
+		uint32 GetID() const { return m_engineBoundID; }
+		bool IsConstructed() const { return m_isConstructed; }
+		bool IsPersistent() const { return m_mappedData != nullptr; }
+		uintptr GetFrameSize() const { return m_frameSize; }
+		uintptr GetPeakUsage() const { return m_peakUsage; }
+
+	private:
+
+		void Create(uintptr frameSize);
+		void Release();
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		uint32 m_engineBoundID = 0;
+		uint8* m_mappedData = nullptr;
+		void* m_fences[RINGBUFFER_FRAME_COUNT] = { nullptr };
+		uintptr m_frameSize = 0;
+		uintptr m_head = 0;
+		uintptr m_peakUsage = 0;
+		uint32 m_frameIndex = 0;
+		bool m_overflowed = false;
+		bool m_isConstructed = false;
+	};
+}
+
+#endif
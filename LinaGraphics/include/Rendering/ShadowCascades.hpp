@@ -0,0 +1,114 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: ShadowCascades
+
+Fits directional light shadow cascades to depth slices of the camera frustum. Each cascade owns a
+quarter of the shadow atlas, its bounding sphere keeps the projection size constant under camera
+rotation & its center is snapped in light space so the projection only moves in whole steps of texels.
+Static caster depth is cached per cascade & only redrawn when the cascade's matrix or the static
+caster set changes.
+
+Timestamp: 10/19/2026 9:52:13 PM
+*/
+
+#pragma once
+
+#ifndef ShadowCascades_HPP
+#define ShadowCascades_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include "Utility/Math/Vector.hpp"
+#include "Utility/Math/Matrix.hpp"
+
+#define SHADOWCASCADE_COUNT 4
+#define SHADOWCASCADE_RESOLUTION 1024
+#define SHADOWCASCADE_ATLAS_RESOLUTION (SHADOWCASCADE_RESOLUTION * 2)
+#define SHADOWCASCADE_MAX_DISTANCE 150.0f
+#define SHADOWCASCADE_SPLIT_LAMBDA 0.75f
+#define SHADOWCASCADE_SNAP_TEXELS 32
+#define SHADOWCASCADE_CASTER_DISTANCE 100.0f
+#define SHADOWCASCADE_UNIT 12
+
+namespace LinaEngine::Graphics
+{
+	struct ShadowCascade
+	{
+		// World to light clip space, used to draw & cull the casters.
+		Matrix m_lightViewProjection;
+
+		// World to atlas uv & depth, used by the lit shaders.
+		Matrix m_atlasMatrix;
+
+		// Lower left pixel of the cascade's tile.
+		Vector2 m_atlasOffset;
+		float m_splitFar = 0.0f;
+		float m_texelSize = 0.0f;
+	};
+
+	class ShadowCascades
+	{
+	public:
+
+		ShadowCascades() {}
+		~ShadowCascades() {}
+
+		// Fits the cascades to the view, returns false if there is no light direction to cast shadows from.
+		bool Update(const Matrix& view, const Matrix& projection, float zNear, float zFar, const Vector3& lightDirection);
+
+		// Static depth of a cascade is stale if it was drawn with another light matrix or static set.
+		bool NeedsStaticUpdate(uint32 cascade, uint32 staticVersion) const;
+		void MarkStaticUpdated(uint32 cascade, uint32 staticVersion);
+		void InvalidateStatic();
+
+		const ShadowCascade& GetCascade(uint32 cascade) const { return m_cascades[cascade]; }
+		bool GetIsActive() const { return m_isActive; }
+		uint32 GetStaticUpdateCount() const { return m_staticUpdateCount; }
+
+	private:
+
+		struct StaticCache
+		{
+			Matrix m_lightViewProjection;
+			uint32 m_version = 0;
+			bool m_isValid = false;
+		};
+
+		void FitCascade(uint32 cascade, const Matrix& inverseView, const Matrix& inverseProjection, float splitNear, float splitFar, const Vector3& lightDirection);
+
+	private:
+
+		ShadowCascade m_cascades[SHADOWCASCADE_COUNT];
+		StaticCache m_staticCaches[SHADOWCASCADE_COUNT];
+		uint32 m_staticUpdateCount = 0;
+		bool m_isActive = false;
+	};
+}
+
+#endif
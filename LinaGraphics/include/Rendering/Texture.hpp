@@ -92,6 +92,7 @@ namespace LinaEngine::Graphics
 		static std::map<int, Texture*> s_loadedTextures;
 
 		friend class RenderEngine;
+		friend class RenderTargetPool;
 
 		TextureBindMode m_bindMode;
 		Sampler m_sampler;
@@ -0,0 +1,101 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: TextureAtlas
+
+Packs 2D textures into shared RGBA pages at runtime so sprites using different textures can be
+drawn together. Textures are copied on the GPU on first use, pages are filled with stb_rect_pack.
+
+Timestamp: 10/19/2026 8:12:36 PM
+*/
+
+#pragma once
+
+#ifndef TextureAtlas_HPP
+#define TextureAtlas_HPP
+
+#include "PackageManager/PAMRenderDevice.hpp"
+#include "Utility/Math/Vector.hpp"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#define TEXTUREATLAS_PAGE_SIZE 2048
+#define TEXTUREATLAS_MAX_PAGES 8
+#define TEXTUREATLAS_PADDING 2
+
+namespace LinaEngine::Graphics
+{
+	class Texture;
+	struct TextureAtlasPage;
+
+	struct TextureAtlasRegion
+	{
+		uint32 m_page = 0;
+		uint32 m_textureID = 0;
+
+		// Min u, min v, max u, max v.
+		Vector4 m_uvRect = Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+	};
+
+	class TextureAtlas
+	{
+	public:
+
+		TextureAtlas();
+		~TextureAtlas();
+
+		void Construct(RenderDevice& renderDeviceIn, uint32 pageSize = TEXTUREATLAS_PAGE_SIZE);
+
+		// Finds the region of the texture, packs it on first use. Null textures map to a white block.
+		// Returns false if the texture can't be atlased, e.g. compressed or larger than a page.
+		bool GetRegion(Texture* texture, TextureAtlasRegion& region);
+
+		// Drops all pages & regions, textures are packed again on their next use.
+		void Clear();
+
+		Texture& GetPage(uint32 page);
+		uint32 GetPageCount() const { return (uint32)m_pages.size(); }
+
+	private:
+
+		bool Allocate(uint32 width, uint32 height, uint32& page, uint32& x, uint32& y);
+		void AddPage();
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		uint32 m_pageSize = TEXTUREATLAS_PAGE_SIZE;
+		std::vector<std::unique_ptr<TextureAtlasPage>> m_pages;
+		std::unordered_map<const Texture*, TextureAtlasRegion> m_regions;
+		TextureAtlasRegion m_whiteRegion;
+	};
+}
+
+#endif
@@ -43,6 +43,9 @@ Timestamp: 4/26/2019 12:30:15 AM
 #include "RenderingCommon.hpp"
 #include "PackageManager/PAMRenderDevice.hpp"
 #include "IndexedModel.hpp"
+#include "RenderConstants.hpp"
+#include "GeometryPool.hpp"
+#include "RenderCommandBuffer.hpp"
 
 namespace LinaEngine::Graphics
 {
@@ -54,14 +57,43 @@ namespace LinaEngine::Graphics
 		VertexArray() : m_engineBoundID(0), m_IndexCount(0), s_renderDevice(nullptr) {};
 		~VertexArray()
 		{
-			m_engineBoundID = s_renderDevice->ReleaseVertexArray(m_engineBoundID);
+			// Arrays never constructed on a device have nothing to release.
+			if (m_geometryPool != nullptr)
+				m_geometryPool->Free(m_poolAllocation);
+			else if (s_renderDevice != nullptr)
+				m_engineBoundID = s_renderDevice->ReleaseVertexArray(m_engineBoundID);
 		}
 	
-		void Construct(RenderDevice& deviceIn, const IndexedModel& model, BufferUsage bufferUsage)
+		// Models placed in the geometry pool share the page's vertex array & are drawn from their range of it.
+		void Construct(RenderDevice& deviceIn, const IndexedModel& model, BufferUsage bufferUsage, GeometryPool* geometryPool = nullptr)
 		{
 			s_renderDevice = &deviceIn;
-			m_engineBoundID = model.CreateVertexArray(deviceIn, bufferUsage);
+
+			if (geometryPool != nullptr && geometryPool->Allocate(model, m_poolAllocation))
+			{
+				m_geometryPool = geometryPool;
+				m_engineBoundID = m_poolAllocation.m_vertexArray;
+			}
+			else
+				m_engineBoundID = model.CreateVertexArray(deviceIn, bufferUsage);
+
 			m_IndexCount = model.GetIndexCount();
+			m_isQuantized = model.GetIsQuantized();
+			m_positionOffset = model.GetPositionOffset();
+			m_positionScale = model.GetPositionScale();
+		}
+
+		// Tells the bound shader how to decode the vertices, shaders without the decode uniforms are skipped.
+		void SetVertexDecodeUniforms(uint32 shader, RenderCommandBuffer& commands)
+		{
+			if (!s_renderDevice->HasShaderUniform(shader, UF_QUANTIZEDVERTICES)) return;
+
+			commands.UpdateShaderUniformInt(shader, UF_QUANTIZEDVERTICES, m_isQuantized);
+			if (m_isQuantized)
+			{
+				commands.UpdateShaderUniformVector3(shader, UF_POSITIONOFFSET, m_positionOffset);
+				commands.UpdateShaderUniformVector3(shader, UF_POSITIONSCALE, m_positionScale);
+			}
 		}
 
 		void UpdateBuffer(uint32 bufferIndex, const void* data, uintptr dataSize)
@@ -69,6 +101,12 @@ namespace LinaEngine::Graphics
 			return s_renderDevice->UpdateVertexArrayBuffer(m_engineBoundID, bufferIndex, data, dataSize);
 		}
 
+		// Sources an instance component from an outside buffer, e.g. a range of the frame ring buffer.
+		void BindInstanceBuffer(uint32 bufferIndex, uint32 buffer, uintptr offset)
+		{
+			s_renderDevice->SetVertexArrayInstanceBuffer(m_engineBoundID, bufferIndex, buffer, offset);
+		}
+
 		uint32 GetID()
 		{ 
 			return m_engineBoundID;
@@ -79,11 +117,27 @@ namespace LinaEngine::Graphics
 			return m_IndexCount;  
 		}
 
+		// Pooled vertex arrays share the GPU ID, the low bits of the sort keys keep them grouped by page & apart by index range.
+		uint32 GetSortID() const
+		{
+			if (m_geometryPool == nullptr) return m_engineBoundID;
+			return ((m_engineBoundID & 0xFu) << 10) | ((m_poolAllocation.m_firstIndex * 2654435761u) >> 22);
+		}
+		bool GetIsPooled() const { return m_geometryPool != nullptr; }
+		bool GetIsQuantized() const { return m_isQuantized; }
+		uint32 GetFirstIndex() const { return m_poolAllocation.m_firstIndex; }
+		uint32 GetBaseVertex() const { return m_poolAllocation.m_firstVertex; }
+
 	private:
 
 		RenderDevice* s_renderDevice = nullptr;
+		GeometryPool* m_geometryPool = nullptr;
+		GeometryAllocation m_poolAllocation;
 		uint32 m_engineBoundID = 0;
 		uint32 m_IndexCount = 0;
+		bool m_isQuantized = false;
+		Vector3 m_positionOffset = Vector3::Zero;
+		Vector3 m_positionScale = Vector3::One;
 		
 	};
 
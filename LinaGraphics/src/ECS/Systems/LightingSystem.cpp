@@ -28,12 +28,31 @@ SOFTWARE.
 
 #include "ECS/Systems/LightingSystem.hpp"  
 #include "Rendering/RenderEngine.hpp"
+#include "Rendering/RenderConstants.hpp"
 
 namespace LinaEngine::ECS
 {
 
 	const float DIRLIGHT_DISTANCE_OFFSET = 10;
 
+	// Radiance below this is treated as zero when deriving a range for lights without a distance.
+	const float LIGHT_ATTENUATION_THRESHOLD = 1.0f / 256.0f;
+
+	static float GetLightRange(float distance, const Color& color)
+	{
+		if (distance > 0.0f) return distance;
+		float intensity = std::max(color.r, std::max(color.g, color.b));
+		return std::sqrt(std::max(intensity, 0.0f) / LIGHT_ATTENUATION_THRESHOLD);
+	}
+
+	void LightingSystem::Construct(ECSRegistry& registry, RenderDevice& rdIn, Graphics::RenderEngine& renderEngineIn)
+	{
+		BaseECSSystem::Construct(registry);
+		s_renderDevice = &rdIn;
+		m_renderEngine = &renderEngineIn;
+		m_clusterGrid.Construct(rdIn);
+	}
+
 	void LightingSystem::UpdateComponents(float delta)
 	{
 		// Flush lights every update.
@@ -41,6 +60,7 @@ namespace LinaEngine::ECS
 		std::get<1>(m_directionalLight) = nullptr;
 		m_pointLights.clear();
 		m_spotLights.clear();
+		m_clusterGrid.Clear();
 
 		// We find the lights here, for the directional light we set it as the current dirLight as there
 		// only can be, actually should be one.
@@ -65,9 +85,11 @@ namespace LinaEngine::ECS
 		for (auto it = pointLightView.begin(); it != pointLightView.end(); ++it)
 		{
 			PointLightComponent* pLight = &pointLightView.get<PointLightComponent>(*it);
-			if (!pLight->m_isEnabled) return;
+			if (!pLight->m_isEnabled) continue;
 
-			m_pointLights.push_back(std::make_pair(&pointLightView.get<TransformComponent>(*it), pLight));
+			TransformComponent* transform = &pointLightView.get<TransformComponent>(*it);
+			m_pointLights.push_back(std::make_pair(transform, pLight));
+			m_clusterGrid.AddPointLight(transform->transform.GetLocation(), pLight->m_color, GetLightRange(pLight->m_distance, pLight->m_color));
 		}
 
 		// Set Spot lights.
@@ -75,70 +97,37 @@ namespace LinaEngine::ECS
 		for (auto it = spotLightView.begin(); it != spotLightView.end(); ++it)
 		{
 			SpotLightComponent* sLight = &spotLightView.get<SpotLightComponent>(*it);
-			if (!sLight->m_isEnabled) return;
+			if (!sLight->m_isEnabled) continue;
 
-			m_spotLights.push_back(std::make_pair(&spotLightView.get<TransformComponent>(*it), sLight));
+			TransformComponent* transform = &spotLightView.get<TransformComponent>(*it);
+			m_spotLights.push_back(std::make_pair(transform, sLight));
+			m_clusterGrid.AddSpotLight(transform->transform.GetLocation(), transform->transform.GetRotation().GetForward(), sLight->m_color, GetLightRange(sLight->m_distance, sLight->m_color), sLight->m_cutoff, sLight->m_outerCutoff);
 		}
 	}
 
-	void LightingSystem::SetLightingShaderData(uint32 shaderID)
+	void LightingSystem::UpdateLightClusters(const Matrix& view, const Matrix& projection, float zNear, float zFar)
 	{
-		// When this function is called it means a shader is activated in the
-		// gpu pipeline, so we go through our available lights and update the shader
-		// data according to their states.
-
-		// Update directional light data.
-		TransformComponent* dirLightTransform = std::get<0>(m_directionalLight);
-		DirectionalLightComponent* dirLight = std::get<1>(m_directionalLight);
-		if (dirLightTransform != nullptr && dirLight != nullptr)
-		{
-			Vector3 direction = Vector3::Zero - dirLightTransform->transform.GetLocation();
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_DIRECTIONALLIGHT + SC_LIGHTCOLOR, dirLight->m_color);
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_DIRECTIONALLIGHT + SC_LIGHTDIRECTION, direction.Normalized());
-		}
-		else
-		{
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_DIRECTIONALLIGHT + SC_LIGHTCOLOR, Color::Black);
-		}
-
-		// Iterate point lights.
-		int currentPointLightCount = 0;
-
-		for (std::vector<std::tuple<TransformComponent*, PointLightComponent*>>::iterator it = m_pointLights.begin(); it != m_pointLights.end(); ++it)
-		{
-			TransformComponent* transform = std::get<0>(*it);
-			PointLightComponent* pointLight = std::get<1>(*it);
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_POINTLIGHTS + "[" + std::to_string(currentPointLightCount) + "]" + SC_LIGHTPOSITION, transform->transform.GetLocation());
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_POINTLIGHTS + "[" + std::to_string(currentPointLightCount) + "]" + SC_LIGHTCOLOR, pointLight->m_color);
-			//m_RenderDevice->UpdateShaderUniformFloat(shaderID, SC_POINTLIGHTS + "[" + std::to_string(currentPointLightCount) + "]" + SC_LIGHTDISTANCE, pointLight->distance);
-			currentPointLightCount++;
-		}
-
-		// Iterate Spot lights.
-		int currentSpotLightCount = 0;
+		// Assign the gathered lights to the clusters of the active view.
+		m_clusterGrid.Build(view, projection, zNear, zFar);
+	}
 
-		for (std::vector<std::tuple<TransformComponent*, SpotLightComponent*>>::iterator it = m_spotLights.begin(); it != m_spotLights.end(); ++it)
-		{
-			TransformComponent* transform = std::get<0>(*it);
-			SpotLightComponent* spotLight = std::get<1>(*it);
-
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTPOSITION, transform->transform.GetLocation());
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTCOLOR, spotLight->m_color);
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTDIRECTION, transform->transform.GetRotation().GetForward());
-			s_renderDevice->UpdateShaderUniformFloat(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTCUTOFF, spotLight->m_cutoff);
-			s_renderDevice->UpdateShaderUniformFloat(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTOUTERCUTOFF, spotLight->m_outerCutoff);
-			//m_RenderDevice->UpdateShaderUniformFloat(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTDISTANCE, spotLight->distance);
-			currentSpotLightCount++;
-		}
+	void LightingSystem::SetLightingShaderData(uint32 shaderID, Graphics::RenderCommandBuffer& commands)
+	{
+		// Light data itself lives in the LightData block & the cluster buffers, only bind them here.
+		m_clusterGrid.Bind(shaderID, commands);
+	}
 
-		m_renderEngine->SetCurrentPLightCount(currentPointLightCount);
-		m_renderEngine->SetCurrentSLightCount(currentSpotLightCount);
+	Vector3 LightingSystem::GetDirectionalLightDirection()
+	{
+		TransformComponent* dirLightTransform = std::get<0>(m_directionalLight);
+		if (dirLightTransform == nullptr) return Vector3::Zero;
+		return (Vector3::Zero - dirLightTransform->transform.GetLocation()).Normalized();
 	}
 
-	void LightingSystem::ResetLightData()
+	Color LightingSystem::GetDirectionalLightColor()
 	{
-		m_renderEngine->SetCurrentPLightCount(0);
-		m_renderEngine->SetCurrentSLightCount(0);
+		DirectionalLightComponent* dirLight = std::get<1>(m_directionalLight);
+		return dirLight != nullptr ? dirLight->m_color : Color::Black;
 	}
 
 	Matrix LightingSystem::GetDirectionalLightMatrix()
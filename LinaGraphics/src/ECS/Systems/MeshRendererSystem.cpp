@@ -27,19 +27,44 @@ SOFTWARE.
 */
 
 #include "ECS/Systems/MeshRendererSystem.hpp"
+#include "ECS/Systems/CameraSystem.hpp"
 #include "ECS/Components/TransformComponent.hpp"
 #include "ECS/Components/MeshRendererComponent.hpp"
+#include "ECS/Components/CameraComponent.hpp"
 #include "Rendering/Mesh.hpp"
 #include "Rendering/RenderEngine.hpp"
 #include "Rendering/Material.hpp"
+#include "Core/Timer.hpp"
+#include "Core/JobSystem.hpp"
+#include <algorithm>
+
+#define OCCLUSION_MAX_OCCLUDERS 32
+#define OCCLUSION_MAX_OCCLUDER_TRIANGLES 4096
+#define OCCLUSION_MIN_OCCLUDER_SIZE 0.1f
+#define SHADOWCASTER_STATIC_FRAMES 30
+#define MESHLOD_HYSTERESIS 0.15f
+#define RECORDING_MIN_CHUNK_BATCHES 32
 
 namespace LinaEngine::ECS
 {
 
 
+	MeshRendererSystem::~MeshRendererSystem()
+	{
+		// The occlusion job references this system.
+		if (m_occlusionFuture.valid())
+			JobSystem::Get().Wait(m_occlusionFuture);
+	}
+
 	void MeshRendererSystem::UpdateComponents(float delta)
 	{
+		LINA_TIMER_START("[Graphics] Mesh Gather");
+
 		auto view = m_ecs->view<TransformComponent, MeshRendererComponent>();
+		m_unboundedRenderers.clear();
+		m_frame++;
+		m_cullingStats.m_staticShadowCasters = m_cullingStats.m_dynamicShadowCasters = 0;
+		m_cullingStats.m_drawCalls = m_cullingStats.m_indirectDraws = 0;
 
 		for (auto entity : view)
 		{
@@ -47,154 +72,605 @@ namespace LinaEngine::ECS
 			if (!renderer.m_isEnabled || renderer.m_excludeFromDrawList || renderer.m_materialID < 0 || renderer.m_meshID < 0) continue;
 
 			TransformComponent& transform = view.get<TransformComponent>(entity);
-
-			// We get the materials, then according to their surface types we add the mesh
-			// data into either opaque queue or the transparent queue.
 			Graphics::Material& mat = LinaEngine::Graphics::Material::GetMaterial(renderer.m_materialID);
 			Graphics::Mesh& mesh = LinaEngine::Graphics::Mesh::GetMesh(renderer.m_meshID);
+			const Matrix model = transform.transform.ToMatrix();
 
-			if (mat.GetSurfaceType() == Graphics::MaterialSurfaceType::Opaque)
+			// Meshes without position data can't be bounded, keep them out of the tree & always visible.
+			if (!mesh.GetBounds().IsValid())
 			{
-				for (int i = 0; i < mesh.GetVertexArrays().size(); i++)
-					RenderOpaque(*mesh.GetVertexArray(i), mat, transform.transform.ToMatrix());
+				SceneProxy& unbounded = m_unboundedRenderers.emplace_back();
+				unbounded.m_entity = entity;
+				unbounded.m_mesh = &mesh;
+				unbounded.m_material = &mat;
+				unbounded.m_model = model;
+				continue;
+			}
+
+			UpdateSceneProxy(entity, mesh, mat, model);
+		}
+
+		// Remove the proxies of renderers that are gone or disabled, renderers that settled down join the static set.
+		for (std::unordered_map<ECSEntity, uint32>::iterator it = m_entityProxies.begin(); it != m_entityProxies.end();)
+		{
+			SceneProxy& sceneProxy = m_sceneProxies[it->second];
+
+			if (sceneProxy.m_frame != m_frame)
+			{
+				if (IsStaticCaster(sceneProxy))
+					m_staticCasterVersion++;
+
+				m_sceneBVH.DestroyProxy(it->second);
+				sceneProxy = SceneProxy();
+				it = m_entityProxies.erase(it);
 			}
 			else
 			{
-				// Transparent queue is a priority queue unlike the opaque one, so we set the priority as distance to the camera.
-				float priority = (m_renderEngine->GetCameraSystem()->GetCameraLocation() - transform.transform.GetLocation()).MagnitudeSqrt();
+				if (m_frame - sceneProxy.m_changeFrame == SHADOWCASTER_STATIC_FRAMES)
+					m_staticCasterVersion++;
+
+				++it;
+			}
+		}
+
+		LINA_TIMER_STOP("[Graphics] Mesh Gather");
+
+		// Query the scene tree for the renderers inside the camera frustum.
+		LINA_TIMER_START("[Graphics] Frustum Culling");
+		m_sceneBVH.Update();
+
+		CameraSystem* cameraSystem = m_renderEngine->GetCameraSystem();
+		const Matrix viewProjection = cameraSystem->GetProjectionMatrix() * cameraSystem->GetViewMatrix();
+		Frustum frustum(viewProjection);
+		m_visibleProxies.clear();
+
+		if (m_frustumCullingEnabled)
+			m_sceneBVH.QueryFrustum(frustum, m_visibleProxies);
+		else
+		{
+			for (std::unordered_map<ECSEntity, uint32>::iterator it = m_entityProxies.begin(); it != m_entityProxies.end(); ++it)
+				m_visibleProxies.push_back(it->second);
+		}
+
+		// Gather every vertex array of the visible renderers with its world bounding sphere, sub meshes are culled in a single batch afterwards.
+		// Visible renderers pick their level of detail from the projected size, different levels batch separately.
+		m_cullCandidates.clear();
+		m_cullSpheres.clear();
+		const Vector3 lodCameraLocation = cameraSystem->GetCameraLocation();
+		const float projectionScale = cameraSystem->GetProjectionMatrix()[1][1];
+
+		for (uint32 proxy : m_visibleProxies)
+		{
+			SceneProxy& sceneProxy = m_sceneProxies[proxy];
+			SelectLOD(sceneProxy, lodCameraLocation, projectionScale);
+			AddCullCandidates(sceneProxy, sceneProxy.m_lod);
+		}
 
-				for (int i = 0; i < mesh.GetVertexArrays().size(); i++)
-					RenderTransparent(*mesh.GetVertexArray(i), mat, transform.transform.ToMatrix(), priority);
+		for (const SceneProxy& unbounded : m_unboundedRenderers)
+			AddCullCandidates(unbounded, 0);
+
+		// Renderers rejected by the tree count as culled as a whole.
+		uint32 totalCount = 0;
+		for (std::unordered_map<ECSEntity, uint32>::iterator it = m_entityProxies.begin(); it != m_entityProxies.end(); ++it)
+			totalCount += (uint32)m_sceneProxies[it->second].m_mesh->GetVertexArrays().size();
+		for (const SceneProxy& unbounded : m_unboundedRenderers)
+			totalCount += (uint32)unbounded.m_mesh->GetVertexArrays().size();
+
+		// Test the spheres against the camera frustum, survivors are refined with their world boxes.
+		const uint32 candidateCount = (uint32)m_cullCandidates.size();
+		m_cullResults.resize(candidateCount);
+
+		// Occluders are rasterized while the simulation runs, their depth is only valid if neither the camera nor any of them moved since.
+		WaitOcclusionCulling();
+		const bool testOcclusion = m_occlusionReady && glm::mat4(m_occlusionBuffer.GetViewProjection()) == glm::mat4(viewProjection) && AreOccludersUnchanged();
+		m_cullingStats.m_occluded = 0;
+
+		if (m_frustumCullingEnabled)
+		{
+			frustum.CullSpheres(m_cullSpheres.data(), candidateCount, m_cullResults.data());
+
+			for (uint32 i = 0; i < candidateCount; i++)
+			{
+				const CullCandidate& candidate = m_cullCandidates[i];
+				if (!m_cullResults[i] || candidate.m_localBounds == nullptr) continue;
+
+				const AABB worldBounds = candidate.m_localBounds->Transform(candidate.m_model);
+				if (!frustum.IntersectsAABB(worldBounds))
+					m_cullResults[i] = 0;
+				else if (testOcclusion && !m_occlusionBuffer.IsVisible(worldBounds))
+				{
+					m_cullResults[i] = 0;
+					m_cullingStats.m_occluded++;
+				}
 			}
 		}
+		else
+			std::fill(m_cullResults.begin(), m_cullResults.end(), (uint8)1);
+
+		LINA_TIMER_STOP("[Graphics] Frustum Culling");
+
+		// Queue the visible candidates, depth is quantized relative to the far plane of the active camera.
+		LINA_TIMER_START("[Graphics] Render Queue Build");
+		CameraComponent* camera = cameraSystem->GetActiveCameraComponent();
+		Vector3 cameraLocation = cameraSystem->GetCameraLocation();
+		const float depthScale = 1.0f / (camera == nullptr ? 1000.0f : camera->m_zFar);
+		m_cullingStats.m_visible = 0;
+
+		for (uint32 i = 0; i < candidateCount; i++)
+		{
+			if (!m_cullResults[i]) continue;
+
+			CullCandidate& candidate = m_cullCandidates[i];
+			const float normalizedDepth = (cameraLocation - Vector3(candidate.m_model[3])).Magnitude() * depthScale;
+			m_cullingStats.m_visible++;
+
+			// According to the material surface types we add the mesh data into either opaque queue or the transparent queue.
+			if (candidate.m_material->GetSurfaceType() == Graphics::MaterialSurfaceType::Opaque)
+				RenderOpaque(*candidate.m_vertexArray, *candidate.m_material, candidate.m_model, normalizedDepth);
+			else
+				RenderTransparent(*candidate.m_vertexArray, *candidate.m_material, candidate.m_model, normalizedDepth);
+		}
 
+		m_cullingStats.m_culled = totalCount - m_cullingStats.m_visible;
+		LINA_TIMER_STOP("[Graphics] Render Queue Build");
 	}
 
-	void MeshRendererSystem::RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn)
+	void MeshRendererSystem::KickOcclusionCulling()
 	{
-		// Render commands basically add the necessary
-		// draw data into the maps/lists etc.
-		Graphics::BatchDrawData drawData;
-		drawData.m_vertexArray = &vertexArray;
-		drawData.m_material = &material;
-		m_opaqueRenderBatch[drawData].m_models.push_back(transformIn);
-		m_opaqueRenderBatch[drawData].m_inverseTransposeModels.push_back(transformIn.Transpose().Inverse());
+		WaitOcclusionCulling();
+		m_occlusionReady = false;
+		m_occluders.clear();
+		m_cullingStats.m_occluders = m_cullingStats.m_occluderTriangles = 0;
+
+		if (!m_occlusionCullingEnabled || !m_frustumCullingEnabled) return;
+
+		// Camera matrices are refreshed by the render engine before the kick, so they match this frame's draw.
+		CameraSystem* cameraSystem = m_renderEngine->GetCameraSystem();
+		const Matrix viewProjection = cameraSystem->GetProjectionMatrix() * cameraSystem->GetViewMatrix();
+		const glm::vec3 cameraLocation = cameraSystem->GetCameraLocation();
+
+		// Occluders are chosen from last frame's renderers, using their current transforms. Large on screen & cheap to rasterize wins.
+		for (std::unordered_map<ECSEntity, uint32>::iterator it = m_entityProxies.begin(); it != m_entityProxies.end(); ++it)
+		{
+			const SceneProxy& sceneProxy = m_sceneProxies[it->second];
+			if (sceneProxy.m_material->GetSurfaceType() != Graphics::MaterialSurfaceType::Opaque || !m_ecs->valid(sceneProxy.m_entity)) continue;
+
+			TransformComponent* transform = m_ecs->try_get<TransformComponent>(sceneProxy.m_entity);
+			if (transform == nullptr) continue;
+
+			uint32 triangleCount = 0;
+			for (const Graphics::IndexedModel& indexedModel : sceneProxy.m_mesh->GetIndexedModels())
+				triangleCount += indexedModel.GetIndexCount() / 3;
+
+			if (triangleCount > OCCLUSION_MAX_OCCLUDER_TRIANGLES) continue;
+
+			const Matrix model = transform->transform.ToMatrix();
+			const AABB worldBounds = sceneProxy.m_mesh->GetBounds().Transform(model);
+			const float distance = glm::max(glm::length(glm::vec3(worldBounds.GetCenter()) - cameraLocation), 0.001f);
+			const float screenSize = glm::length(glm::vec3(worldBounds.GetHalfExtents())) / distance;
+			if (screenSize < OCCLUSION_MIN_OCCLUDER_SIZE) continue;
+
+			Occluder& occluder = m_occluders.emplace_back();
+			occluder.m_entity = sceneProxy.m_entity;
+			occluder.m_proxy = it->second;
+			occluder.m_mesh = sceneProxy.m_mesh;
+			occluder.m_model = model;
+			occluder.m_screenSize = screenSize;
+		}
+
+		if (m_occluders.size() > OCCLUSION_MAX_OCCLUDERS)
+		{
+			std::nth_element(m_occluders.begin(), m_occluders.begin() + OCCLUSION_MAX_OCCLUDERS, m_occluders.end(), [](const Occluder& a, const Occluder& b) { return a.m_screenSize > b.m_screenSize; });
+			m_occluders.resize(OCCLUSION_MAX_OCCLUDERS);
+		}
+
+		m_cullingStats.m_occluders = (uint32)m_occluders.size();
+		m_occlusionBuffer.Clear(viewProjection);
+
+		if (!m_occluders.empty())
+			m_occlusionFuture = JobSystem::Get().Submit([this]() { RasterizeOccluders(); });
 	}
 
-	void MeshRendererSystem::RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn, float priority)
+	void MeshRendererSystem::RasterizeOccluders()
 	{
-		// Render commands basically add the necessary
-		// draw data into the maps/lists etc.
-		Graphics::BatchDrawData drawData;
-		drawData.m_vertexArray = &vertexArray;
-		drawData.m_material = &material;
-		drawData.m_distance = priority;
+		// Runs on a worker, only reads the occluder snapshot & immutable mesh data.
+		for (const Occluder& occluder : m_occluders)
+		{
+			for (const Graphics::IndexedModel& indexedModel : occluder.m_mesh->GetIndexedModels())
+			{
+				if (indexedModel.GetElements().empty()) continue;
+
+				const std::vector<float>& positions = indexedModel.GetElements()[0];
+				const std::vector<uint32>& indices = indexedModel.GetIndices();
+				m_occlusionBuffer.RasterizeMesh(occluder.m_model, positions.data(), (uint32)positions.size() / 3, indices.data(), (uint32)indices.size());
+			}
+		}
 
-		Graphics::BatchModelData modelData;
-		modelData.m_models.push_back(transformIn);
-		modelData.m_inverseTransposeModels.push_back(transformIn.Transpose().Inverse());
-		m_transparentRenderBatch.emplace(std::make_pair(drawData, modelData));
+		m_occlusionBuffer.BuildHierarchy();
 	}
 
-	void MeshRendererSystem::FlushOpaque(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
+	void MeshRendererSystem::WaitOcclusionCulling()
 	{
-		// When flushed, all the data is delegated to the render device to do the actual
-		// drawing. Then the data is cleared if complete flush is requested.
+		if (!m_occlusionFuture.valid()) return;
 
-		for (std::map<Graphics::BatchDrawData, Graphics::BatchModelData>::iterator it = m_opaqueRenderBatch.begin(); it != m_opaqueRenderBatch.end(); ++it)
-		{
-			// Get references.
-			Graphics::BatchDrawData drawData = it->first;
-			Graphics::BatchModelData& modelData = it->second;
-			size_t numTransforms = modelData.m_models.size();
-			if (numTransforms == 0) continue;
+		LINA_TIMER_START("[Graphics] Occlusion Wait");
+		JobSystem::Get().Wait(m_occlusionFuture);
+		m_occlusionReady = true;
+		m_cullingStats.m_occluderTriangles = m_occlusionBuffer.GetTriangleCount();
+		LINA_TIMER_STOP("[Graphics] Occlusion Wait");
+	}
 
-			Graphics::VertexArray* vertexArray = drawData.m_vertexArray;
-			Matrix* models = &modelData.m_models[0];
-			Matrix* inverseTransposeModels = &modelData.m_inverseTransposeModels[0];
+	bool MeshRendererSystem::AreOccludersUnchanged() const
+	{
+		// Proxies hold this frame's transforms by now, removed or reused proxies count as moved.
+		for (const Occluder& occluder : m_occluders)
+		{
+			const SceneProxy& sceneProxy = m_sceneProxies[occluder.m_proxy];
+			if (sceneProxy.m_entity != occluder.m_entity || glm::mat4(sceneProxy.m_model) != glm::mat4(occluder.m_model))
+				return false;
+		}
 
-			// Get the material for drawing, object's own material or overriden material.
-			Graphics::Material* mat = overrideMaterial == nullptr ? drawData.m_material : overrideMaterial;
+		return true;
+	}
 
-			// Draw call.
-			// Update the buffer w/ each transform.
-			vertexArray->UpdateBuffer(5, models, numTransforms * sizeof(Matrix));
-			vertexArray->UpdateBuffer(6, inverseTransposeModels, numTransforms * sizeof(Matrix));
+	const Graphics::OcclusionBuffer& MeshRendererSystem::GetOcclusionBuffer()
+	{
+		WaitOcclusionCulling();
+		return m_occlusionBuffer;
+	}
 
-			m_renderEngine->UpdateShaderData(mat);
-			s_renderDevice->Draw(vertexArray->GetID(), drawParams, numTransforms, vertexArray->GetIndexCount(), false);
+	void MeshRendererSystem::UpdateSceneProxy(ECSEntity entity, Graphics::Mesh& mesh, Graphics::Material& material, const Matrix& model)
+	{
+		std::unordered_map<ECSEntity, uint32>::iterator it = m_entityProxies.find(entity);
 
-			// Clear the buffer.
-			if (completeFlush)
+		if (it == m_entityProxies.end())
+		{
+			const uint32 proxy = m_sceneBVH.CreateProxy(mesh.GetBounds().Transform(model), 0);
+			if (proxy >= m_sceneProxies.size())
+				m_sceneProxies.resize(proxy + 1);
+
+			// User data is the proxy itself, query results index the proxy array directly.
+			m_sceneBVH.SetUserData(proxy, proxy);
+			it = m_entityProxies.emplace(entity, proxy).first;
+			m_sceneProxies[proxy].m_changeFrame = m_frame;
+		}
+		else
+		{
+			// Only refit the tree for renderers that actually moved or switched meshes.
+			SceneProxy& previous = m_sceneProxies[it->second];
+			const bool moved = previous.m_mesh != &mesh || previous.m_model != model;
+			if (moved)
+				m_sceneBVH.MoveProxy(it->second, mesh.GetBounds().Transform(model));
+
+			// Levels of a different mesh don't apply.
+			if (previous.m_mesh != &mesh)
+				previous.m_lod = previous.m_shadowLOD = 0;
+
+			// Any change makes the renderer a moving caster again.
+			if (moved || previous.m_material != &material)
 			{
-				modelData.m_models.clear();
-				modelData.m_inverseTransposeModels.clear();
+				if (IsStaticCaster(previous))
+					m_staticCasterVersion++;
+
+				previous.m_changeFrame = m_frame;
 			}
 		}
+
+		SceneProxy& sceneProxy = m_sceneProxies[it->second];
+		sceneProxy.m_entity = entity;
+		sceneProxy.m_mesh = &mesh;
+		sceneProxy.m_material = &material;
+		sceneProxy.m_model = model;
+		sceneProxy.m_frame = m_frame;
 	}
 
-	void MeshRendererSystem::FlushSingleRenderer(ECS::MeshRendererComponent& mrc, ECS::TransformComponent& tr, Graphics::DrawParams drawParams)
+	void MeshRendererSystem::SelectLOD(SceneProxy& proxy, const Vector3& cameraLocation, float projectionScale)
 	{
-		if (!Graphics::Mesh::MeshExists(mrc.m_meshID) || !Graphics::Material::MaterialExists(mrc.m_materialID))
+		Graphics::Mesh& mesh = *proxy.m_mesh;
+		const uint32 lodCount = mesh.GetLODCount();
+		uint32 lod = proxy.m_lod < lodCount ? proxy.m_lod : lodCount - 1;
+
+		if (lodCount > 1)
 		{
-			LINA_CORE_WARN("Mesh or material does not exists for this renderer, aborting single flush.");
-			return;
+			// Projected diameter as a fraction of the screen height.
+			const AABB worldBounds = mesh.GetBounds().Transform(proxy.m_model);
+			const float distance = glm::max((worldBounds.GetCenter() - cameraLocation).Magnitude(), 0.001f);
+			const float screenSize = worldBounds.GetHalfExtents().Magnitude() * projectionScale / distance;
+
+			// Coarser levels are picked right at their threshold, finer ones only after growing past it by the margin, so renderers don't flicker around it.
+			while (lod + 1 < lodCount && screenSize < mesh.GetLODScreenSize(lod + 1))
+				lod++;
+			while (lod > 0 && screenSize > mesh.GetLODScreenSize(lod) * (1.0f + MESHLOD_HYSTERESIS))
+				lod--;
 		}
 
+		// Shadows follow the camera level only while the caster moves, static casters keep the level their cached shadow was drawn with.
+		if (!IsStaticCaster(proxy))
+			proxy.m_shadowLOD = lod;
 
-		Graphics::Mesh& mesh = Graphics::Mesh::GetMesh(mrc.m_meshID);
-		Graphics::Material& mat = Graphics::Material::GetMaterial(mrc.m_materialID);
+		proxy.m_lod = lod;
+	}
 
-		for (Graphics::VertexArray* va : mesh.GetVertexArrays())
+	void MeshRendererSystem::AddCullCandidates(const SceneProxy& proxy, uint32 lod)
+	{
+		Graphics::Mesh& mesh = *proxy.m_mesh;
+		std::vector<Graphics::VertexArray*>& vertexArrays = mesh.GetLODVertexArrays(lod);
+		std::vector<Graphics::IndexedModel>& indexedModels = mesh.GetLODIndexedModels(lod);
+
+		for (int i = 0; i < vertexArrays.size(); i++)
 		{
-			va->UpdateBuffer(5, &tr.transform.ToMatrix()[0][0], sizeof(Matrix));
-			va->UpdateBuffer(6, &tr.transform.ToMatrix().Inverse().Transpose()[0][0], sizeof(Matrix));
-			m_renderEngine->UpdateShaderData(&mat);
-			s_renderDevice->Draw(va->GetID(), drawParams, 1, va->GetIndexCount(), false);
+			const Graphics::IndexedModel& indexedModel = indexedModels[i];
+			CullCandidate& candidate = m_cullCandidates.emplace_back();
+			candidate.m_vertexArray = vertexArrays[i];
+			candidate.m_material = proxy.m_material;
+			candidate.m_model = proxy.m_model;
+
+			// Models without position data can't be bounded, keep them always visible.
+			if (indexedModel.GetBounds().IsValid())
+			{
+				BoundingSphere worldSphere = indexedModel.GetBoundingSphere().Transform(proxy.m_model);
+				candidate.m_localBounds = &indexedModel.GetBounds();
+				m_cullSpheres.push_back(Vector4(worldSphere.m_center, worldSphere.m_radius));
+			}
+			else
+				m_cullSpheres.push_back(Vector4(Vector3::Zero, FLT_MAX));
 		}
+	}
 
+	bool MeshRendererSystem::IsStaticCaster(const SceneProxy& proxy) const
+	{
+		return m_frame - proxy.m_changeFrame >= SHADOWCASTER_STATIC_FRAMES;
 	}
 
-	void MeshRendererSystem::FlushTransparent(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
+	void MeshRendererSystem::DrawShadowCasters(const Matrix& lightViewProjection, bool staticCasters, const Graphics::DrawParams& drawParams, Graphics::Material& shadowMaterial, Graphics::RenderCommandBuffer& commands)
 	{
-		// When flushed, all the data is delegated to the render device to do the actual
-		// drawing. Then the data is cleared if complete flush is requested.
+		// Casters outside of the light frustum can't throw a shadow into the cascade, the tree rejects them in bulk.
+		Frustum frustum(lightViewProjection);
+		m_shadowProxies.clear();
+		m_sceneBVH.QueryFrustum(frustum, m_shadowProxies);
+		uint32& casterCount = staticCasters ? m_cullingStats.m_staticShadowCasters : m_cullingStats.m_dynamicShadowCasters;
+
+		for (uint32 proxy : m_shadowProxies)
+		{
+			const SceneProxy& sceneProxy = m_sceneProxies[proxy];
+			if (IsStaticCaster(sceneProxy) != staticCasters) continue;
+
+			// Casters use the level picked when they were last visible, frozen once they settle down.
+			Graphics::Mesh& mesh = *sceneProxy.m_mesh;
+			const uint32 lod = sceneProxy.m_shadowLOD < mesh.GetLODCount() ? sceneProxy.m_shadowLOD : 0;
+			std::vector<Graphics::VertexArray*>& vertexArrays = mesh.GetLODVertexArrays(lod);
+			std::vector<Graphics::IndexedModel>& indexedModels = mesh.GetLODIndexedModels(lod);
+
+			for (int i = 0; i < vertexArrays.size(); i++)
+			{
+				// Sub meshes are refined with their own spheres.
+				const Graphics::IndexedModel& indexedModel = indexedModels[i];
+				if (indexedModel.GetBounds().IsValid())
+				{
+					BoundingSphere worldSphere = indexedModel.GetBoundingSphere().Transform(sceneProxy.m_model);
+					if (!frustum.IntersectsSphere(worldSphere.m_center, worldSphere.m_radius)) continue;
+				}
+
+				Graphics::VertexArray& vertexArray = *vertexArrays[i];
+				uint64 key = Graphics::RenderQueue::GenerateKey(Graphics::RenderQueuePass::Opaque, shadowMaterial.GetShaderID(), shadowMaterial.GetID(), vertexArray.GetSortID(), 0.0f);
+				m_shadowQueue.Push(key, vertexArray, shadowMaterial, sceneProxy.m_model);
+				casterCount++;
+			}
+		}
+
+		// Unbounded renderers can't be culled or cached, they go with the moving casters.
+		if (!staticCasters)
+		{
+			for (const SceneProxy& unbounded : m_unboundedRenderers)
+			{
+				for (Graphics::VertexArray* vertexArray : unbounded.m_mesh->GetVertexArrays())
+				{
+					uint64 key = Graphics::RenderQueue::GenerateKey(Graphics::RenderQueuePass::Opaque, shadowMaterial.GetShaderID(), shadowMaterial.GetID(), vertexArray->GetSortID(), 0.0f);
+					m_shadowQueue.Push(key, *vertexArray, shadowMaterial, unbounded.m_model);
+					casterCount++;
+				}
+			}
+		}
+
+		m_shadowQueue.Sort();
+		RecordQueue(m_shadowQueue, commands, drawParams, &shadowMaterial, 0, m_shadowQueue.GetBatches().size());
+		m_shadowQueue.Clear();
+	}
 
-		// Empty out the queue
-		while (!m_transparentRenderBatch.empty())
+	bool MeshRendererSystem::RayCast(const Ray& ray, float maxDistance, ECSEntity& entity, float& distance) const
+	{
+		// Narrow phase runs in mesh space, the direction isn't renormalized so hit distances stay in world units.
+		BVH::RayTestCallback testTriangles = [this](uint32 proxy, const Ray& worldRay, float& hitDistance)
 		{
-			BatchPair pair = m_transparentRenderBatch.top();
+			const SceneProxy& sceneProxy = m_sceneProxies[proxy];
+			const Matrix inverseModel = sceneProxy.m_model.Inverse();
+			const Ray localRay(Vector3(inverseModel * glm::vec4(glm::vec3(worldRay.m_origin), 1.0f)), Vector3(inverseModel * glm::vec4(glm::vec3(worldRay.m_direction), 0.0f)));
+			bool hit = false;
+			hitDistance = FLT_MAX;
+
+			for (const Graphics::IndexedModel& indexedModel : sceneProxy.m_mesh->GetIndexedModels())
+			{
+				if (indexedModel.GetElements().empty()) continue;
+
+				const std::vector<float>& positions = indexedModel.GetElements()[0];
+				const std::vector<uint32>& indices = indexedModel.GetIndices();
+
+				for (size_t i = 0; i + 2 < indices.size(); i += 3)
+				{
+					const float* p0 = &positions[indices[i] * 3];
+					const float* p1 = &positions[indices[i + 1] * 3];
+					const float* p2 = &positions[indices[i + 2] * 3];
+					float triangleDistance = 0.0f;
+
+					if (localRay.IntersectsTriangle(Vector3(p0[0], p0[1], p0[2]), Vector3(p1[0], p1[1], p1[2]), Vector3(p2[0], p2[1], p2[2]), triangleDistance) && triangleDistance < hitDistance)
+					{
+						hitDistance = triangleDistance;
+						hit = true;
+					}
+				}
+			}
+
+			return hit;
+		};
 
-			Graphics::BatchDrawData& drawData = std::get<0>(pair);
-			Graphics::BatchModelData& modelData = std::get<1>(pair);
-			size_t numTransforms = modelData.m_models.size();
-			if (numTransforms == 0) continue;
+		BVH::RayHit hit;
+		if (!m_sceneBVH.RayCast(ray, maxDistance, hit, testTriangles))
+			return false;
 
-			Graphics::VertexArray* vertexArray = drawData.m_vertexArray;
-			Matrix* models = &modelData.m_models[0];
-			Matrix* inverseTransposeModels = &modelData.m_inverseTransposeModels[0];
+		entity = m_sceneProxies[hit.m_userData].m_entity;
+		distance = hit.m_distance;
+		return true;
+	}
+
+	void MeshRendererSystem::QueryOverlaps(const AABB& box, std::vector<ECSEntity>& entities) const
+	{
+		std::vector<uint32> proxies;
+		m_sceneBVH.QueryAABB(box, proxies);
+
+		for (uint32 proxy : proxies)
+			entities.push_back(m_sceneProxies[proxy].m_entity);
+	}
+
+	void MeshRendererSystem::RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn, float normalizedDepth)
+	{
+		// Render commands basically add the necessary
+		// draw data into the queues.
+		uint64 key = Graphics::RenderQueue::GenerateKey(Graphics::RenderQueuePass::Opaque, material.GetShaderID(), material.GetID(), vertexArray.GetSortID(), normalizedDepth);
+		m_opaqueQueue.Push(key, vertexArray, material, transformIn);
+	}
+
+	void MeshRendererSystem::RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn, float normalizedDepth)
+	{
+		// Render commands basically add the necessary
+		// draw data into the queues.
+		uint64 key = Graphics::RenderQueue::GenerateKey(Graphics::RenderQueuePass::Transparent, material.GetShaderID(), material.GetID(), vertexArray.GetSortID(), normalizedDepth);
+		m_transparentQueue.Push(key, vertexArray, material, transformIn);
+	}
+
+	uint32 MeshRendererSystem::PrepareRecording(uint32 maxChunks)
+	{
+		m_opaqueQueue.Sort();
+		m_transparentQueue.Sort();
+
+		// Chunks are only worth a worker with enough batches in them.
+		const size_t batchCount = m_opaqueQueue.GetBatches().size();
+		size_t chunkCount = batchCount / RECORDING_MIN_CHUNK_BATCHES;
+		chunkCount = chunkCount < 1 ? 1 : (chunkCount > maxChunks ? maxChunks : chunkCount);
+
+		m_opaqueChunks.clear();
+		for (size_t i = 0; i < chunkCount; i++)
+			m_opaqueChunks.push_back(batchCount * i / chunkCount);
+		m_opaqueChunks.push_back(batchCount);
+
+		return (uint32)chunkCount;
+	}
+
+	void MeshRendererSystem::RecordOpaque(Graphics::RenderCommandBuffer& commands, uint32 chunk, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial)
+	{
+		RecordQueue(m_opaqueQueue, commands, drawParams, overrideMaterial, m_opaqueChunks[chunk], m_opaqueChunks[chunk + 1]);
+	}
+
+	void MeshRendererSystem::RecordTransparent(Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial)
+	{
+		RecordQueue(m_transparentQueue, commands, drawParams, overrideMaterial, 0, m_transparentQueue.GetBatches().size());
+	}
+
+	void MeshRendererSystem::FinishRecording()
+	{
+		m_opaqueQueue.Clear();
+		m_transparentQueue.Clear();
+	}
+
+	void MeshRendererSystem::AddDrawStats(const Graphics::RenderCommandBuffer& commands)
+	{
+		m_cullingStats.m_drawCalls += commands.GetDrawCount();
+		m_cullingStats.m_indirectDraws += commands.GetIndirectDrawCount();
+	}
+
+	void MeshRendererSystem::RecordQueue(Graphics::RenderQueue& queue, Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, size_t firstBatch, size_t lastBatch)
+	{
+		// Runs on workers, only reads the sorted queue & writes into the command buffer.
+		if (firstBatch >= lastBatch) return;
+
+		// Stream the instances of the range at once, batches are then bound by their offset in the stream.
+		const std::vector<Graphics::InstanceTransform>& instances = queue.GetInstances();
+		const std::vector<Graphics::RenderQueueBatch>& batches = queue.GetBatches();
+		const uint32 firstInstance = batches[firstBatch].m_firstInstance;
+		const uint32 instanceCount = batches[lastBatch - 1].m_firstInstance + batches[lastBatch - 1].m_instanceCount - firstInstance;
+		const uint32 stream = commands.UploadStream(&instances[firstInstance], instanceCount * sizeof(Graphics::InstanceTransform));
+		const bool multiDraw = s_renderDevice->SupportsMultiDrawIndirect();
+
+		for (size_t i = firstBatch; i < lastBatch;)
+		{
+			const Graphics::RenderQueueBatch& batch = batches[i];
+			Graphics::VertexArray* vertexArray = batch.m_vertexArray;
 
 			// Get the material for drawing, object's own material or overriden material.
-			Graphics::Material* mat = overrideMaterial == nullptr ? drawData.m_material : overrideMaterial;
+			Graphics::Material* mat = overrideMaterial == nullptr ? batch.m_material : overrideMaterial;
 
-			// Draw call.
-			// Update the buffer w/ each transform.
-			vertexArray->UpdateBuffer(5, models, numTransforms * sizeof(Matrix));
-			vertexArray->UpdateBuffer(6, inverseTransposeModels, numTransforms * sizeof(Matrix));
+			m_renderEngine->RecordShaderData(mat, commands);
+			vertexArray->SetVertexDecodeUniforms(mat->GetShaderID(), commands);
 
-			m_renderEngine->UpdateShaderData(mat);
-			s_renderDevice->Draw(vertexArray->GetID(), drawParams, numTransforms, vertexArray->GetIndexCount(), false);
+			// Following batches drawn from the same geometry pool page with the same material are submitted together.
+			// Quantized vertex arrays have their own decode uniforms, so they are drawn one by one.
+			size_t runEnd = i + 1;
+			if (multiDraw && vertexArray->GetIsPooled() && !vertexArray->GetIsQuantized())
+			{
+				while (runEnd < lastBatch && batches[runEnd].m_vertexArray->GetID() == vertexArray->GetID() && !batches[runEnd].m_vertexArray->GetIsQuantized()
+					&& (overrideMaterial != nullptr || batches[runEnd].m_material == batch.m_material))
+					runEnd++;
+			}
 
-			// Clear the buffer.
-			if (completeFlush)
+			if (runEnd - i > 1)
 			{
-				modelData.m_models.clear();
-				modelData.m_inverseTransposeModels.clear();
+				// Base instances address the stream, the executor draws them one by one if the ring is full.
+				Graphics::DrawElementsIndirectCommand* indirect = commands.MultiDrawIndirect(vertexArray->GetID(), drawParams, 5, stream, sizeof(Graphics::InstanceTransform), (uint32)(runEnd - i));
+				for (size_t j = i; j < runEnd; j++, indirect++)
+				{
+					indirect->m_count = batches[j].m_vertexArray->GetIndexCount();
+					indirect->m_instanceCount = batches[j].m_instanceCount;
+					indirect->m_firstIndex = batches[j].m_vertexArray->GetFirstIndex();
+					indirect->m_baseVertex = (int32)batches[j].m_vertexArray->GetBaseVertex();
+					indirect->m_baseInstance = batches[j].m_firstInstance - firstInstance;
+				}
+
+				i = runEnd;
+				continue;
 			}
 
-			m_transparentRenderBatch.pop();
+			// Draw call.
+			// Point the instance attributes to the batch's transforms.
+			commands.BindInstanceStream(vertexArray->GetID(), 5, stream, (batch.m_firstInstance - firstInstance) * sizeof(Graphics::InstanceTransform), batch.m_instanceCount * sizeof(Graphics::InstanceTransform));
+			commands.DrawInstancedBaseVertex(vertexArray->GetID(), drawParams, batch.m_instanceCount, vertexArray->GetIndexCount(), vertexArray->GetFirstIndex(), vertexArray->GetBaseVertex());
+			i++;
+		}
+	}
+
+	void MeshRendererSystem::FlushSingleRenderer(ECS::MeshRendererComponent& mrc, ECS::TransformComponent& tr, Graphics::DrawParams drawParams)
+	{
+		if (!Graphics::Mesh::MeshExists(mrc.m_meshID) || !Graphics::Material::MaterialExists(mrc.m_materialID))
+		{
+			LINA_CORE_WARN("Mesh or material does not exists for this renderer, aborting single flush.");
+			return;
+		}
+
+
+		Graphics::Mesh& mesh = Graphics::Mesh::GetMesh(mrc.m_meshID);
+		Graphics::Material& mat = Graphics::Material::GetMaterial(mrc.m_materialID);
+		const Graphics::InstanceTransform instance(tr.transform.ToMatrix());
+		m_singleCommands.Reset();
+		const uint32 stream = m_singleCommands.UploadStream(&instance, sizeof(Graphics::InstanceTransform));
+
+		for (Graphics::VertexArray* va : mesh.GetVertexArrays())
+		{
+			m_renderEngine->RecordShaderData(&mat, m_singleCommands);
+			va->SetVertexDecodeUniforms(mat.GetShaderID(), m_singleCommands);
+			m_singleCommands.BindInstanceStream(va->GetID(), 5, stream, 0, sizeof(Graphics::InstanceTransform));
+			m_singleCommands.DrawInstancedBaseVertex(va->GetID(), drawParams, 1, va->GetIndexCount(), va->GetFirstIndex(), va->GetBaseVertex());
 		}
 
+		m_renderEngine->ExecuteCommands(m_singleCommands);
+
 	}
 
-}
\ No newline at end of file
+}
@@ -30,9 +30,26 @@ SOFTWARE.
 #include "ECS/Components/TransformComponent.hpp"
 #include "ECS/Components/SpriteRendererComponent.hpp"
 #include "Rendering/RenderEngine.hpp"
+#include "Rendering/Shader.hpp"
+#include "Rendering/Texture.hpp"
+#include "Core/Timer.hpp"
+#include <algorithm>
 
 namespace LinaEngine::ECS
 {
+#define SPRITE_SHADER_PATH "resources/engine/shaders/2D/Sprite.glsl"
+#define SPRITEBATCH_SHADER_PATH "resources/engine/shaders/2D/SpriteBatch.glsl"
+#define SPRITEBATCH_INDEX_BITS 24
+
+	SpriteRendererSystem::~SpriteRendererSystem()
+	{
+		if (s_renderDevice != nullptr)
+		{
+			m_batchVertexArray = s_renderDevice->ReleaseVertexArray(m_batchVertexArray);
+			m_streamBuffer = s_renderDevice->ReleaseRingBuffer(m_streamBuffer, false);
+		}
+	}
+
 	void SpriteRendererSystem::Construct(ECSRegistry& registry, Graphics::RenderEngine& renderEngineIn, RenderDevice& renderDeviceIn)
 	{
 		BaseECSSystem::Construct(registry);
@@ -40,6 +57,14 @@ namespace LinaEngine::ECS
 		s_renderDevice = &renderDeviceIn;
 		Graphics::ModelLoader::LoadQuad(m_quadModel);
 		m_spriteVertexArray.Construct(*s_renderDevice, m_quadModel, Graphics::BufferUsage::USAGE_STATIC_COPY);
+
+		// Streaming batcher, materials using the standard sprite shader are drawn through it.
+		m_atlas.Construct(*s_renderDevice);
+		m_spriteShaderID = Graphics::Shader::ShaderExists(SPRITE_SHADER_PATH) ? Graphics::Shader::GetShader(SPRITE_SHADER_PATH).GetID() : 0;
+		Graphics::Material::SetMaterialShader(m_batchMaterial, Graphics::Shader::GetShader(SPRITEBATCH_SHADER_PATH));
+		m_batchVertexArray = s_renderDevice->CreateSpriteBatchVertexArray(SPRITEBATCH_MAX_SPRITES_PER_DRAW);
+		m_streamBufferSize = SPRITEBATCH_MAX_SPRITES_PER_DRAW * 4 * sizeof(Graphics::SpriteVertex);
+		m_streamBuffer = s_renderDevice->CreateRingBuffer(m_streamBufferSize, nullptr);
 	}
 
 	void SpriteRendererSystem::UpdateComponents(float delta)
@@ -50,56 +75,178 @@ namespace LinaEngine::ECS
 		for (auto entity : view)
 		{
 			SpriteRendererComponent& renderer = view.get<SpriteRendererComponent>(entity);
-			if (!renderer.m_isEnabled) return;
+			if (!renderer.m_isEnabled) continue;
 
 			TransformComponent& transform = view.get<TransformComponent>(entity);
 
 			// Dont draw if mesh or material does not exist.
-			if (renderer.m_materialID < 0) continue;
+			if (!Graphics::Material::MaterialExists(renderer.m_materialID)) continue;
 
 			Graphics::Material& mat = LinaEngine::Graphics::Material::GetMaterial(renderer.m_materialID);
-			Render(mat, transform.transform.ToMatrix());
+			RenderSprite(mat, transform.transform.ToMatrix(), renderer.m_sortingLayer, renderer.m_orderInLayer);
+		}
+	}
+
+	void SpriteRendererSystem::RenderSprite(Graphics::Material& material, const Matrix& transformIn, int sortingLayer, int orderInLayer)
+	{
+		// Custom sprite shaders expect per-instance transforms.
+		if (material.GetShaderID() != m_spriteShaderID || m_sortKeys.size() >= SPRITEBATCH_MAX_SPRITES)
+		{
+			Render(material, transformIn);
+			return;
+		}
+
+		Graphics::Texture* texture = nullptr;
+		std::map<std::string, Graphics::MaterialSampler2D>::iterator samplerIt = material.m_sampler2Ds.find(MAT_TEXTURE2D_DIFFUSE);
+		if (samplerIt != material.m_sampler2Ds.end() && samplerIt->second.m_isActive)
+			texture = samplerIt->second.m_boundTexture;
+
+		Graphics::TextureAtlasRegion region;
+		if (!m_atlas.GetRegion(texture, region))
+		{
+			Render(material, transformIn);
+			return;
+		}
+
+		// Layer & order are biased to sort as unsigned, the page keeps equal orders batched together.
+		const uint64 layer = (uint64)((sortingLayer + 32768) & 0xFFFF);
+		const uint64 order = (uint64)((orderInLayer + 32768) & 0xFFFF);
+		m_sortKeys.push_back(layer << 48 | order << 32 | (uint64)(region.m_page & 0xFF) << SPRITEBATCH_INDEX_BITS | (uint64)m_sortKeys.size());
+		m_spriteBatchesBuilt = false;
+
+		std::map<std::string, Color>::iterator colorIt = material.m_colors.find(MAT_OBJECTCOLORPROPERTY);
+		const Color color = colorIt != material.m_colors.end() ? colorIt->second : Color::White;
+		const uint32 packedColor = (uint32)(Math::Clamp(color.r, 0.0f, 1.0f) * 255.0f) | (uint32)(Math::Clamp(color.g, 0.0f, 1.0f) * 255.0f) << 8 | (uint32)(Math::Clamp(color.b, 0.0f, 1.0f) * 255.0f) << 16 | (uint32)(Math::Clamp(color.a, 0.0f, 1.0f) * 255.0f) << 24;
+
+		// Same corners & winding as the instanced quad, u is mirrored there as well.
+		static const float corners[4][2] = { { -0.5f, 0.5f }, { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f } };
+		const glm::mat4& model = transformIn;
+
+		for (int i = 0; i < 4; i++)
+		{
+			const glm::vec4 position = model[3] + model[0] * corners[i][0] + model[1] * corners[i][1];
+			const float u = 0.5f - corners[i][0];
+			const float v = corners[i][1] + 0.5f;
+
+			Graphics::SpriteVertex& vertex = m_vertices.emplace_back();
+			vertex.m_position[0] = position.x;
+			vertex.m_position[1] = position.y;
+			vertex.m_position[2] = position.z;
+			vertex.m_uv[0] = region.m_uvRect.x + u * (region.m_uvRect.z - region.m_uvRect.x);
+			vertex.m_uv[1] = region.m_uvRect.y + v * (region.m_uvRect.w - region.m_uvRect.y);
+			vertex.m_color = packedColor;
 		}
 	}
 
 	void SpriteRendererSystem::Render(Graphics::Material& material, const Matrix& transformIn)
 	{
-		m_renderBatch[&material].m_models.push_back(transformIn);
-		m_renderBatch[&material].m_inverseTransposeModels.push_back(transformIn.Transpose().Inverse());
+		m_renderBatch[&material].m_instances.emplace_back(transformIn);
+	}
+
+	void SpriteRendererSystem::PrepareRecording()
+	{
+		if (!m_spriteBatchesBuilt)
+			BuildSpriteBatches();
 	}
 
-	void SpriteRendererSystem::Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
+	void SpriteRendererSystem::Record(Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
 	{
-		// When flushed, all the data is delegated to the render device to do the actual
-		// drawing. Then the data is cleared if complete flush is requested.
+		// All the data is recorded into the command buffer, which is executed later on.
+		// Then the data is cleared if complete flush is requested.
+
+		// Batched sprites only have the color pass, override materials expect instance data.
+		if (overrideMaterial == nullptr)
+			RecordSpriteBatches(commands, drawParams);
+
+		if (completeFlush)
+		{
+			m_sortKeys.clear();
+			m_vertices.clear();
+			m_sortedVertices.clear();
+			m_spriteBatches.clear();
+			m_spriteBatchesBuilt = true;
+		}
 
 		for (std::map<Graphics::Material*, BatchModelData>::iterator it = m_renderBatch.begin(); it != m_renderBatch.end(); ++it)
 		{
 			// Get references.
 			BatchModelData& modelData = it->second;
-			size_t numTransforms = modelData.m_models.size();
+			size_t numTransforms = modelData.m_instances.size();
 			if (numTransforms == 0) continue;
 
-			Matrix* models = &modelData.m_models[0];
-			Matrix* inverseTransposeModels = &modelData.m_inverseTransposeModels[0];
-
 			// Get the material for drawing, object's own material or overriden material.
 			Graphics::Material* mat = overrideMaterial == nullptr ? it->first : overrideMaterial;
 
 			// Draw call.
-			// Update the buffer w/ each transform.
-			m_spriteVertexArray.UpdateBuffer(2, models, numTransforms * sizeof(Matrix));
-			m_spriteVertexArray.UpdateBuffer(3, inverseTransposeModels, numTransforms * sizeof(Matrix));
+			// Stream the transforms through the frame ring buffer, uploaded to the sprite buffer if it is full.
+			const uintptr dataSize = numTransforms * sizeof(Graphics::InstanceTransform);
+			const uint32 stream = commands.UploadStream(&modelData.m_instances[0], dataSize);
+			commands.BindInstanceStream(m_spriteVertexArray.GetID(), 2, stream, 0, dataSize);
 
-			m_renderEngine->UpdateShaderData(mat);
-			s_renderDevice->Draw(m_spriteVertexArray.GetID(), drawParams, numTransforms, m_spriteVertexArray.GetIndexCount(), false);
+			m_renderEngine->RecordShaderData(mat, commands);
+			commands.Draw(m_spriteVertexArray.GetID(), drawParams, (uint32)numTransforms, m_spriteVertexArray.GetIndexCount(), false);
 
 			// Clear the buffer.
 			if (completeFlush)
 			{
-				modelData.m_models.clear();
-				modelData.m_inverseTransposeModels.clear();
+				modelData.m_instances.clear();
 			}
 		}
 	}
-}
\ No newline at end of file
+
+	void SpriteRendererSystem::BuildSpriteBatches()
+	{
+		LINA_TIMER_START("[Graphics] Sprite Batching");
+
+		// Keys carry the sprite index in their low bits, sorting them orders the vertices.
+		std::sort(m_sortKeys.begin(), m_sortKeys.end());
+		m_sortedVertices.resize(m_vertices.size());
+		m_spriteBatches.clear();
+
+		const uint64 indexMask = ((uint64)1 << SPRITEBATCH_INDEX_BITS) - 1;
+		for (uint32 i = 0; i < (uint32)m_sortKeys.size(); i++)
+		{
+			const uint64 key = m_sortKeys[i];
+			const uint32 sprite = (uint32)(key & indexMask);
+			const uint32 page = (uint32)((key >> SPRITEBATCH_INDEX_BITS) & 0xFF);
+			std::copy_n(&m_vertices[sprite * 4], 4, &m_sortedVertices[i * 4]);
+
+			// A new draw is needed when the page changes or the index pattern runs out.
+			if (!m_spriteBatches.empty() && m_spriteBatches.back().m_page == page && m_spriteBatches.back().m_spriteCount < SPRITEBATCH_MAX_SPRITES_PER_DRAW)
+			{
+				m_spriteBatches.back().m_spriteCount++;
+				continue;
+			}
+
+			SpriteBatch& batch = m_spriteBatches.emplace_back();
+			batch.m_page = page;
+			batch.m_firstSprite = i;
+			batch.m_spriteCount = 1;
+		}
+
+		m_spriteBatchesBuilt = true;
+		LINA_TIMER_STOP("[Graphics] Sprite Batching");
+	}
+
+	void SpriteRendererSystem::RecordSpriteBatches(Graphics::RenderCommandBuffer& commands, const Graphics::DrawParams& drawParams)
+	{
+		if (!m_spriteBatchesBuilt)
+			BuildSpriteBatches();
+
+		if (m_sortedVertices.empty()) return;
+
+		// All sprites go up in one stream, draws select their range with the base vertex.
+		// Our own stream buffer is orphaned & refilled if the ring is full this frame.
+		const uintptr dataSize = m_sortedVertices.size() * sizeof(Graphics::SpriteVertex);
+		m_streamBufferSize = std::max(m_streamBufferSize, dataSize);
+		const uint32 stream = commands.UploadStream(&m_sortedVertices[0], dataSize);
+		commands.SetSpriteBatchStream(m_batchVertexArray, stream, m_streamBuffer, m_streamBufferSize);
+
+		for (const SpriteBatch& batch : m_spriteBatches)
+		{
+			m_batchMaterial.SetTexture(MAT_TEXTURE2D_DIFFUSE, &m_atlas.GetPage(batch.m_page));
+			m_renderEngine->RecordShaderData(&m_batchMaterial, commands);
+			commands.DrawBaseVertex(m_batchVertexArray, drawParams, batch.m_spriteCount * 6, batch.m_firstSprite * 4);
+		}
+	}
+}
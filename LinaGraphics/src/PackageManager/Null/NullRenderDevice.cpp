@@ -0,0 +1,1395 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "PackageManager/Null/NullRenderDevice.hpp"
+#include "PackageManager/OpenGL/GLRenderDevice.hpp"
+#include "PackageManager/Generic/GenericMemory.hpp"
+#include <sstream>
+
+namespace LinaEngine::Graphics
+{
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// GLOBALS DECLARATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	static uint32 GetPixelFormatComponents(PixelFormat format);
+	static std::vector<uint8> CopyBytes(const void* data, uintptr dataSize);
+	static void ReflectShaderUniforms(const std::string& shaderText, NullShaderProgram& program);
+
+	NullRenderDevice::NullRenderDevice()
+	{
+		LINA_CORE_TRACE("[Constructor] -> NullRenderDevice ({0})", typeid(*this).name());
+	}
+
+	NullRenderDevice::~NullRenderDevice()
+	{
+		if (!m_resources.empty())
+			LINA_CORE_WARN("[Null Render Device] {0} resources were not released.", m_resources.size());
+
+		LINA_CORE_TRACE("[Destructor] -> NullRenderDevice ({0})", typeid(*this).name());
+	}
+
+	void NullRenderDevice::Initialize(int width, int height, DrawParams& defaultParams)
+	{
+		LINA_CORE_TRACE("Graphics Information: Null render device, commands are validated & recorded only.");
+		m_boundViewportSize = Vector2((float)width, (float)height);
+
+		if (BeginCommand(RenderCommandType::Initialize))
+		{
+			DrawParams params = defaultParams;
+			m_commandStream.Record(RenderCommandType::Initialize, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { DrawParams replayParams = params; device.Initialize(width, height, replayParams); });
+		}
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// TEXTURE OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 NullRenderDevice::CreateTexture2D(Vector2 size, const void* data, SamplerParameters samplerParams, bool compress, bool useBorder, Color borderColor)
+	{
+		const uintptr dataSize = data == nullptr ? 0 : (uintptr)size.x * (uintptr)size.y * GetPixelFormatComponents(samplerParams.m_textureParams.m_pixelFormat);
+		const uint32 texture = CreateResource(NullResourceType::Texture, dataSize);
+
+		if (BeginCommand(RenderCommandType::CreateTexture, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::CreateTexture, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{ context.m_handles[texture] = device.CreateTexture2D(size, bytes.empty() ? nullptr : bytes.data(), samplerParams, compress, useBorder, borderColor); });
+		}
+
+		return texture;
+	}
+
+	uint32 NullRenderDevice::CreateTextureHDRI(Vector2 size, float* data, SamplerParameters samplerParams)
+	{
+		const uintptr dataSize = data == nullptr ? 0 : (uintptr)size.x * (uintptr)size.y * GetPixelFormatComponents(samplerParams.m_textureParams.m_pixelFormat) * sizeof(float);
+		const uint32 texture = CreateResource(NullResourceType::Texture, dataSize);
+
+		if (BeginCommand(RenderCommandType::CreateTexture, dataSize))
+		{
+			std::vector<float> floats(data, data + dataSize / sizeof(float));
+			m_commandStream.Record(RenderCommandType::CreateTexture, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context) mutable
+				{ context.m_handles[texture] = device.CreateTextureHDRI(size, floats.empty() ? nullptr : floats.data(), samplerParams); });
+		}
+
+		return texture;
+	}
+
+	uint32 NullRenderDevice::CreateCubemapTexture(Vector2 size, SamplerParameters samplerParams, const std::vector<int32*>& data, uint32 dataSize)
+	{
+		const uintptr faceSize = (uintptr)size.x * (uintptr)size.y * GetPixelFormatComponents(samplerParams.m_textureParams.m_pixelFormat);
+		const uint32 texture = CreateResource(NullResourceType::Texture, faceSize * dataSize);
+
+		if (BeginCommand(RenderCommandType::CreateTexture, faceSize * dataSize))
+		{
+			std::vector<std::vector<uint8>> faces;
+			for (uint32 i = 0; i < dataSize && i < (uint32)data.size(); i++)
+				faces.push_back(CopyBytes(data[i], data[i] == nullptr ? 0 : faceSize));
+
+			m_commandStream.Record(RenderCommandType::CreateTexture, faceSize * dataSize, [=](GLRenderDevice& device, RenderReplayContext& context) mutable
+				{
+					std::vector<int32*> faceData;
+					for (std::vector<uint8>& face : faces)
+						faceData.push_back(face.empty() ? nullptr : (int32*)face.data());
+
+					context.m_handles[texture] = device.CreateCubemapTexture(size, samplerParams, faceData, (uint32)faceData.size());
+				});
+		}
+
+		return texture;
+	}
+
+	uint32 NullRenderDevice::CreateCubemapTextureEmpty(Vector2 size, SamplerParameters samplerParams)
+	{
+		const uint32 texture = CreateResource(NullResourceType::Texture);
+
+		if (BeginCommand(RenderCommandType::CreateTexture))
+			m_commandStream.Record(RenderCommandType::CreateTexture, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[texture] = device.CreateCubemapTextureEmpty(size, samplerParams); });
+
+		return texture;
+	}
+
+	uint32 NullRenderDevice::CreateTexture2DMSAA(Vector2 size, SamplerParameters samplerParams, int sampleCount)
+	{
+		const uint32 texture = CreateResource(NullResourceType::Texture);
+
+		if (BeginCommand(RenderCommandType::CreateTexture))
+			m_commandStream.Record(RenderCommandType::CreateTexture, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[texture] = device.CreateTexture2DMSAA(size, samplerParams, sampleCount); });
+
+		return texture;
+	}
+
+	uint32 NullRenderDevice::CreateTexture2DEmpty(Vector2 size, SamplerParameters samplerParams)
+	{
+		const uint32 texture = CreateResource(NullResourceType::Texture);
+
+		if (BeginCommand(RenderCommandType::CreateTexture))
+			m_commandStream.Record(RenderCommandType::CreateTexture, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[texture] = device.CreateTexture2DEmpty(size, samplerParams); });
+
+		return texture;
+	}
+
+	void NullRenderDevice::UpdateTexture2D(uint32 texture, Vector2 size, const void* data, PixelFormat pixelFormat)
+	{
+		if (!CheckResource(texture, NullResourceType::Texture, "UpdateTexture2D", false)) return;
+
+		const uintptr dataSize = data == nullptr ? 0 : (uintptr)size.x * (uintptr)size.y * GetPixelFormatComponents(pixelFormat);
+		if (BeginCommand(RenderCommandType::UpdateTexture, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::UpdateTexture, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{ device.UpdateTexture2D(context.Get(texture), size, bytes.empty() ? nullptr : bytes.data(), pixelFormat); });
+		}
+	}
+
+	void NullRenderDevice::UpdateTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, Vector2 size, const uint16* data, PixelFormat pixelFormat)
+	{
+		if (!CheckResource(texture, NullResourceType::Texture, "UpdateTextureHalf", false)) return;
+
+		const uintptr dataSize = data == nullptr ? 0 : (uintptr)size.x * (uintptr)size.y * GetPixelFormatComponents(pixelFormat) * sizeof(uint16);
+		if (BeginCommand(RenderCommandType::UpdateTexture, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::UpdateTexture, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{ device.UpdateTextureHalf(context.Get(texture), imageTarget, mipLevel, size, bytes.empty() ? nullptr : (const uint16*)bytes.data(), pixelFormat); });
+		}
+	}
+
+	bool NullRenderDevice::ReadTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, uint16* data, PixelFormat pixelFormat)
+	{
+		// Nothing is rasterized, there is no data to read back.
+		CheckResource(texture, NullResourceType::Texture, "ReadTextureHalf", false);
+		return false;
+	}
+
+	void NullRenderDevice::SetupTextureParameters(uint32 textureTarget, SamplerParameters samplerParams, bool useBorder, float* borderColor)
+	{
+		if (BeginCommand(RenderCommandType::UpdateTextureParameters))
+		{
+			std::vector<float> border;
+			if (borderColor != nullptr)
+				border.assign(borderColor, borderColor + 4);
+
+			m_commandStream.Record(RenderCommandType::UpdateTextureParameters, 0, [=](GLRenderDevice& device, RenderReplayContext& context) mutable
+				{ device.SetupTextureParameters(textureTarget, samplerParams, useBorder, border.empty() ? nullptr : border.data()); });
+		}
+	}
+
+	void NullRenderDevice::UpdateTextureParameters(uint32 bindMode, uint32 id, SamplerParameters samplerParams)
+	{
+		if (!CheckResource(id, NullResourceType::Texture, "UpdateTextureParameters", false)) return;
+
+		if (BeginCommand(RenderCommandType::UpdateTextureParameters))
+			m_commandStream.Record(RenderCommandType::UpdateTextureParameters, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateTextureParameters(bindMode, context.Get(id), samplerParams); });
+	}
+
+	uint32 NullRenderDevice::ReleaseTexture2D(uint32 texture2D)
+	{
+		if (ReleaseResource(texture2D, NullResourceType::Texture, "ReleaseTexture2D") != 0 && BeginCommand(RenderCommandType::ReleaseTexture))
+			m_commandStream.Record(RenderCommandType::ReleaseTexture, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseTexture2D(context.Get(texture2D)); });
+
+		return 0;
+	}
+
+	uint32 NullRenderDevice::CreateTextureBuffer(PixelFormat internalPixelFormat, uint32& buffer)
+	{
+		const uint32 texture = CreateResource(NullResourceType::Texture);
+		const uint32 textureBuffer = CreateResource(NullResourceType::Buffer);
+		buffer = textureBuffer;
+
+		if (BeginCommand(RenderCommandType::CreateTexture))
+		{
+			m_commandStream.Record(RenderCommandType::CreateTexture, 0, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{
+					uint32 replayBuffer = 0;
+					context.m_handles[texture] = device.CreateTextureBuffer(internalPixelFormat, replayBuffer);
+					context.m_handles[textureBuffer] = replayBuffer;
+				});
+		}
+
+		return texture;
+	}
+
+	void NullRenderDevice::UpdateTextureBuffer(uint32 buffer, const void* data, uintptr dataSize)
+	{
+		NullResource* resource = GetResource(buffer, NullResourceType::Buffer, "UpdateTextureBuffer");
+		if (resource == nullptr) return;
+		resource->m_size = dataSize;
+
+		if (BeginCommand(RenderCommandType::UpdateBuffer, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::UpdateBuffer, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateTextureBuffer(context.Get(buffer), bytes.data(), bytes.size()); });
+		}
+	}
+
+	uint32 NullRenderDevice::ReleaseTextureBuffer(uint32 texture, uint32 buffer)
+	{
+		const bool released = ReleaseResource(texture, NullResourceType::Texture, "ReleaseTextureBuffer") != 0;
+		ReleaseResource(buffer, NullResourceType::Buffer, "ReleaseTextureBuffer");
+
+		if (released && BeginCommand(RenderCommandType::ReleaseTexture))
+			m_commandStream.Record(RenderCommandType::ReleaseTexture, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseTextureBuffer(context.Get(texture), context.Get(buffer)); });
+
+		return 0;
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// VERTEX ARRAY OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 NullRenderDevice::CreateVertexArray(const float** vertexData, const uint32* vertexElementSizes, const uint32* vertexElementTypes, uint32 numVertexComponents, uint32 numInstanceComponents, uint32 numVertices, const uint32* indices, uint32 numIndices, BufferUsage bufferUsage)
+	{
+		// Vertex data is optional, the storage is only reserved without it.
+		std::vector<uint32> elementSizes(vertexElementSizes, vertexElementSizes + numVertexComponents + numInstanceComponents);
+		std::vector<uint32> elementTypes(vertexElementTypes, vertexElementTypes + numVertexComponents + numInstanceComponents);
+		uintptr dataSize = indices == nullptr ? 0 : (uintptr)numIndices * sizeof(uint32);
+		for (uint32 i = 0; i < numVertexComponents && vertexData != nullptr; i++)
+			dataSize += (uintptr)elementSizes[i] * numVertices * sizeof(float);
+
+		const uint32 vao = CreateResource(NullResourceType::VertexArray, dataSize);
+		NullResource& resource = m_resources[vao];
+		resource.m_numVertices = numVertices;
+		resource.m_numIndices = numIndices;
+		resource.m_numBuffers = numVertexComponents + numInstanceComponents + 1;
+		resource.m_instanceComponentsStartIndex = numVertexComponents;
+		resource.m_elementSizes = elementSizes;
+		TrackVertexArrayBind(vao);
+
+		if (BeginCommand(RenderCommandType::CreateVertexArray, dataSize))
+		{
+			std::vector<std::vector<float>> components;
+			for (uint32 i = 0; i < numVertexComponents && vertexData != nullptr; i++)
+				components.push_back(std::vector<float>(vertexData[i], vertexData[i] + elementSizes[i] * numVertices));
+
+			std::vector<uint32> indexData;
+			if (indices != nullptr)
+				indexData.assign(indices, indices + numIndices);
+
+			m_commandStream.Record(RenderCommandType::CreateVertexArray, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{
+					std::vector<const float*> componentData;
+					for (const std::vector<float>& component : components)
+						componentData.push_back(component.data());
+
+					context.m_handles[vao] = device.CreateVertexArray(componentData.empty() ? nullptr : componentData.data(), elementSizes.data(), elementTypes.data(), numVertexComponents, numInstanceComponents,
+						numVertices, indexData.empty() ? nullptr : indexData.data(), numIndices, bufferUsage);
+				});
+		}
+
+		return vao;
+	}
+
+	uint32 NullRenderDevice::CreateSkyboxVertexArray()
+	{
+		const uint32 vao = CreateResource(NullResourceType::VertexArray);
+
+		if (BeginCommand(RenderCommandType::CreateVertexArray))
+			m_commandStream.Record(RenderCommandType::CreateVertexArray, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[vao] = device.CreateSkyboxVertexArray(); });
+
+		return vao;
+	}
+
+	uint32 NullRenderDevice::CreateScreenQuadVertexArray()
+	{
+		const uint32 vao = CreateResource(NullResourceType::VertexArray);
+
+		if (BeginCommand(RenderCommandType::CreateVertexArray))
+			m_commandStream.Record(RenderCommandType::CreateVertexArray, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[vao] = device.CreateScreenQuadVertexArray(); });
+
+		return vao;
+	}
+
+	uint32 NullRenderDevice::CreateLineVertexArray()
+	{
+		const uint32 vao = CreateResource(NullResourceType::VertexArray);
+
+		if (BeginCommand(RenderCommandType::CreateVertexArray))
+			m_commandStream.Record(RenderCommandType::CreateVertexArray, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[vao] = device.CreateLineVertexArray(); });
+
+		return vao;
+	}
+
+	uint32 NullRenderDevice::CreateSpriteBatchVertexArray(uint32 maxSprites)
+	{
+		const uint32 vao = CreateResource(NullResourceType::VertexArray);
+		m_resources[vao].m_numIndices = maxSprites * 6;
+
+		if (BeginCommand(RenderCommandType::CreateVertexArray))
+			m_commandStream.Record(RenderCommandType::CreateVertexArray, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[vao] = device.CreateSpriteBatchVertexArray(maxSprites); });
+
+		return vao;
+	}
+
+	uint32 NullRenderDevice::CreateHDRICubeVertexArray()
+	{
+		const uint32 vao = CreateResource(NullResourceType::VertexArray);
+
+		if (BeginCommand(RenderCommandType::CreateVertexArray))
+			m_commandStream.Record(RenderCommandType::CreateVertexArray, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[vao] = device.CreateHDRICubeVertexArray(); });
+
+		return vao;
+	}
+
+	uint32 NullRenderDevice::ReleaseVertexArray(uint32 vao, bool checkMap)
+	{
+		if (ReleaseResource(vao, NullResourceType::VertexArray, "ReleaseVertexArray") == 0) return 0;
+		if (m_boundVAO == vao) m_boundVAO = 0;
+
+		if (BeginCommand(RenderCommandType::ReleaseVertexArray))
+			m_commandStream.Record(RenderCommandType::ReleaseVertexArray, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseVertexArray(context.Get(vao), checkMap); });
+
+		return 0;
+	}
+
+	void NullRenderDevice::UpdateVertexArray(uint32 vao, uint32 bufferIndex, const void* data, uintptr dataSize)
+	{
+		NullResource* resource = GetResource(vao, NullResourceType::VertexArray, "UpdateVertexArray");
+		if (resource == nullptr) return;
+
+		if (bufferIndex >= resource->m_numBuffers)
+		{
+			ReportError("UpdateVertexArray", "buffer index out of range");
+			return;
+		}
+
+		TrackVertexArrayBind(vao);
+
+		if (BeginCommand(RenderCommandType::UpdateBuffer, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::UpdateBuffer, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateVertexArray(context.Get(vao), bufferIndex, bytes.data(), bytes.size()); });
+		}
+	}
+
+	void NullRenderDevice::SetVertexArrayInstanceBuffer(uint32 vao, uint32 bufferIndex, uint32 buffer, uintptr offset)
+	{
+		NullResource* resource = GetResource(vao, NullResourceType::VertexArray, "SetVertexArrayInstanceBuffer");
+		if (resource == nullptr || !CheckResource(buffer, NullResourceType::Buffer, "SetVertexArrayInstanceBuffer", false)) return;
+
+		if (bufferIndex < resource->m_instanceComponentsStartIndex || bufferIndex + 1 >= resource->m_numBuffers)
+		{
+			ReportError("SetVertexArrayInstanceBuffer", "buffer index is not an instance component");
+			return;
+		}
+
+		TrackVertexArrayBind(vao);
+		m_frameStats.m_bufferBinds++;
+
+		if (BeginCommand(RenderCommandType::BindBuffer))
+			m_commandStream.Record(RenderCommandType::BindBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetVertexArrayInstanceBuffer(context.Get(vao), bufferIndex, context.Get(buffer), offset); });
+	}
+
+	void NullRenderDevice::UpdateVertexArrayRange(uint32 vao, const float** vertexData, uint32 firstVertex, uint32 numVertices, const uint32* indices, uint32 firstIndex, uint32 numIndices)
+	{
+		NullResource* resource = GetResource(vao, NullResourceType::VertexArray, "UpdateVertexArrayRange");
+		if (resource == nullptr) return;
+
+		if (firstVertex + numVertices > resource->m_numVertices || firstIndex + numIndices > resource->m_numIndices)
+		{
+			ReportError("UpdateVertexArrayRange", "range exceeds the vertex array storage");
+			return;
+		}
+
+		const uint32 numVertexComponents = resource->m_instanceComponentsStartIndex;
+		uintptr dataSize = (uintptr)numIndices * sizeof(uint32);
+		for (uint32 i = 0; i < numVertexComponents; i++)
+			dataSize += (uintptr)resource->m_elementSizes[i] * numVertices * sizeof(float);
+
+		TrackVertexArrayBind(vao);
+
+		if (BeginCommand(RenderCommandType::UpdateGeometry, dataSize))
+		{
+			std::vector<std::vector<float>> components;
+			for (uint32 i = 0; i < numVertexComponents; i++)
+				components.push_back(std::vector<float>(vertexData[i], vertexData[i] + resource->m_elementSizes[i] * numVertices));
+
+			std::vector<uint32> indexData(indices, indices + numIndices);
+			m_commandStream.Record(RenderCommandType::UpdateGeometry, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{
+					std::vector<const float*> componentData;
+					for (const std::vector<float>& component : components)
+						componentData.push_back(component.data());
+
+					device.UpdateVertexArrayRange(context.Get(vao), componentData.data(), firstVertex, numVertices, indexData.data(), firstIndex, numIndices);
+				});
+		}
+	}
+
+	void NullRenderDevice::SetSpriteBatchVertexSource(uint32 vao, uint32 buffer, uintptr offset)
+	{
+		if (!CheckResource(vao, NullResourceType::VertexArray, "SetSpriteBatchVertexSource", false) || !CheckResource(buffer, NullResourceType::Buffer, "SetSpriteBatchVertexSource", false)) return;
+
+		TrackVertexArrayBind(vao);
+		m_frameStats.m_bufferBinds++;
+
+		if (BeginCommand(RenderCommandType::BindBuffer))
+			m_commandStream.Record(RenderCommandType::BindBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetSpriteBatchVertexSource(context.Get(vao), context.Get(buffer), offset); });
+	}
+
+	void NullRenderDevice::SetLineVertexSource(uint32 vao, uint32 buffer, uintptr offset)
+	{
+		if (!CheckResource(vao, NullResourceType::VertexArray, "SetLineVertexSource", false) || !CheckResource(buffer, NullResourceType::Buffer, "SetLineVertexSource", false)) return;
+
+		TrackVertexArrayBind(vao);
+		m_frameStats.m_bufferBinds++;
+
+		if (BeginCommand(RenderCommandType::BindBuffer))
+			m_commandStream.Record(RenderCommandType::BindBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetLineVertexSource(context.Get(vao), context.Get(buffer), offset); });
+	}
+
+	void NullRenderDevice::UpdateVertexArrayBuffer(uint32 vao, uint32 bufferIndex, const void* data, uintptr dataSize)
+	{
+		NullResource* resource = GetResource(vao, NullResourceType::VertexArray, "UpdateVertexArrayBuffer");
+		if (resource == nullptr) return;
+
+		if (bufferIndex >= resource->m_numBuffers)
+		{
+			ReportError("UpdateVertexArrayBuffer", "buffer index out of range");
+			return;
+		}
+
+		TrackVertexArrayBind(vao);
+
+		if (BeginCommand(RenderCommandType::UpdateBuffer, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::UpdateBuffer, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateVertexArrayBuffer(context.Get(vao), bufferIndex, bytes.data(), bytes.size()); });
+		}
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// SAMPLER OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 NullRenderDevice::CreateSampler(SamplerParameters samplerParams)
+	{
+		const uint32 sampler = CreateResource(NullResourceType::Sampler);
+
+		if (BeginCommand(RenderCommandType::CreateSampler))
+			m_commandStream.Record(RenderCommandType::CreateSampler, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[sampler] = device.CreateSampler(samplerParams); });
+
+		return sampler;
+	}
+
+	uint32 NullRenderDevice::ReleaseSampler(uint32 sampler)
+	{
+		if (ReleaseResource(sampler, NullResourceType::Sampler, "ReleaseSampler") != 0 && BeginCommand(RenderCommandType::ReleaseSampler))
+			m_commandStream.Record(RenderCommandType::ReleaseSampler, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseSampler(context.Get(sampler)); });
+
+		return 0;
+	}
+
+	void NullRenderDevice::UpdateSamplerParameters(uint32 sampler, SamplerParameters params)
+	{
+		if (!CheckResource(sampler, NullResourceType::Sampler, "UpdateSamplerParameters", false)) return;
+
+		if (BeginCommand(RenderCommandType::UpdateSampler))
+			m_commandStream.Record(RenderCommandType::UpdateSampler, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateSamplerParameters(context.Get(sampler), params); });
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// BUFFER OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 NullRenderDevice::CreateUniformBuffer(const void* data, uintptr dataSize, BufferUsage usage)
+	{
+		const uint32 buffer = CreateResource(NullResourceType::Buffer, data == nullptr ? 0 : dataSize);
+		m_resources[buffer].m_size = dataSize;
+
+		if (BeginCommand(RenderCommandType::CreateBuffer, data == nullptr ? 0 : dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, data == nullptr ? 0 : dataSize);
+			m_commandStream.Record(RenderCommandType::CreateBuffer, bytes.size(), [=](GLRenderDevice& device, RenderReplayContext& context)
+				{ context.m_handles[buffer] = device.CreateUniformBuffer(bytes.empty() ? nullptr : bytes.data(), dataSize, usage); });
+		}
+
+		return buffer;
+	}
+
+	uint32 NullRenderDevice::ReleaseUniformBuffer(uint32 buffer)
+	{
+		if (ReleaseResource(buffer, NullResourceType::Buffer, "ReleaseUniformBuffer") != 0 && BeginCommand(RenderCommandType::ReleaseBuffer))
+			m_commandStream.Record(RenderCommandType::ReleaseBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseUniformBuffer(context.Get(buffer)); });
+
+		return 0;
+	}
+
+	uint32 NullRenderDevice::CreateRingBuffer(uintptr size, void** persistentData)
+	{
+		// Never persistently mapped, writes go through the device so they can be recorded.
+		if (persistentData != nullptr)
+			*persistentData = nullptr;
+
+		const uint32 buffer = CreateResource(NullResourceType::Buffer);
+		m_resources[buffer].m_size = size;
+
+		if (BeginCommand(RenderCommandType::CreateBuffer))
+			m_commandStream.Record(RenderCommandType::CreateBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[buffer] = device.CreateRingBuffer(size, nullptr); });
+
+		return buffer;
+	}
+
+	uint32 NullRenderDevice::ReleaseRingBuffer(uint32 buffer, bool persistent)
+	{
+		if (ReleaseResource(buffer, NullResourceType::Buffer, "ReleaseRingBuffer") != 0 && BeginCommand(RenderCommandType::ReleaseBuffer))
+			m_commandStream.Record(RenderCommandType::ReleaseBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseRingBuffer(context.Get(buffer), false); });
+
+		return 0;
+	}
+
+	void NullRenderDevice::OrphanRingBuffer(uint32 buffer, uintptr size)
+	{
+		if (!CheckBufferRange(buffer, 0, size, "OrphanRingBuffer")) return;
+
+		if (BeginCommand(RenderCommandType::UpdateBuffer))
+			m_commandStream.Record(RenderCommandType::UpdateBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.OrphanRingBuffer(context.Get(buffer), size); });
+	}
+
+	void NullRenderDevice::WriteRingBuffer(uint32 buffer, uintptr offset, const void* data, uintptr dataSize)
+	{
+		if (!CheckBufferRange(buffer, offset, dataSize, "WriteRingBuffer")) return;
+
+		if (BeginCommand(RenderCommandType::UpdateBuffer, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::UpdateBuffer, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context) { device.WriteRingBuffer(context.Get(buffer), offset, bytes.data(), bytes.size()); });
+		}
+	}
+
+	void* NullRenderDevice::CreateFence()
+	{
+		void* fence = (void*)m_nextFence++;
+		m_fences.insert(fence);
+
+		if (BeginCommand(RenderCommandType::CreateFence))
+			m_commandStream.Record(RenderCommandType::CreateFence, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_fences[fence] = device.CreateFence(); });
+
+		return fence;
+	}
+
+	void NullRenderDevice::WaitFence(void* fence)
+	{
+		if (m_fences.find(fence) == m_fences.end())
+		{
+			ReportError("WaitFence", "unknown or released fence");
+			return;
+		}
+
+		if (BeginCommand(RenderCommandType::WaitFence))
+			m_commandStream.Record(RenderCommandType::WaitFence, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.WaitFence(context.GetFence(fence)); });
+	}
+
+	void NullRenderDevice::ReleaseFence(void* fence)
+	{
+		if (m_fences.erase(fence) == 0)
+		{
+			ReportError("ReleaseFence", "unknown or released fence");
+			return;
+		}
+
+		if (BeginCommand(RenderCommandType::ReleaseFence))
+			m_commandStream.Record(RenderCommandType::ReleaseFence, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseFence(context.GetFence(fence)); });
+	}
+
+	uint32 NullRenderDevice::CreateTimerQuery()
+	{
+		const uint32 query = CreateResource(NullResourceType::Query);
+
+		if (BeginCommand(RenderCommandType::CreateQuery))
+			m_commandStream.Record(RenderCommandType::CreateQuery, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[query] = device.CreateTimerQuery(); });
+
+		return query;
+	}
+
+	uint32 NullRenderDevice::ReleaseTimerQuery(uint32 query)
+	{
+		if (ReleaseResource(query, NullResourceType::Query, "ReleaseTimerQuery") != 0 && BeginCommand(RenderCommandType::ReleaseQuery))
+			m_commandStream.Record(RenderCommandType::ReleaseQuery, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseTimerQuery(context.Get(query)); });
+
+		return 0;
+	}
+
+	void NullRenderDevice::BeginTimerQuery(uint32 query)
+	{
+		if (!CheckResource(query, NullResourceType::Query, "BeginTimerQuery", false)) return;
+
+		if (BeginCommand(RenderCommandType::Query))
+			m_commandStream.Record(RenderCommandType::Query, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.BeginTimerQuery(context.Get(query)); });
+	}
+
+	void NullRenderDevice::EndTimerQuery()
+	{
+		if (BeginCommand(RenderCommandType::Query))
+			m_commandStream.Record(RenderCommandType::Query, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.EndTimerQuery(); });
+	}
+
+	bool NullRenderDevice::GetTimerQueryResult(uint32 query, uint64* elapsedNS)
+	{
+		// Nothing executes on a GPU, there is never a result to read back.
+		CheckResource(query, NullResourceType::Query, "GetTimerQueryResult", false);
+		return false;
+	}
+
+	void NullRenderDevice::BindUniformBuffer(uint32 buffer, uint32 bindingPoint)
+	{
+		if (!CheckResource(buffer, NullResourceType::Buffer, "BindUniformBuffer")) return;
+		m_frameStats.m_bufferBinds++;
+
+		if (BeginCommand(RenderCommandType::BindBuffer))
+			m_commandStream.Record(RenderCommandType::BindBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.BindUniformBuffer(context.Get(buffer), bindingPoint); });
+	}
+
+	void NullRenderDevice::BindUniformBufferRange(uint32 buffer, uint32 bindingPoint, uintptr offset, uintptr dataSize)
+	{
+		if (!CheckBufferRange(buffer, offset, dataSize, "BindUniformBufferRange")) return;
+		m_frameStats.m_bufferBinds++;
+
+		if (BeginCommand(RenderCommandType::BindBuffer))
+			m_commandStream.Record(RenderCommandType::BindBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.BindUniformBufferRange(context.Get(buffer), bindingPoint, offset, dataSize); });
+	}
+
+	void NullRenderDevice::UpdateUniformBuffer(uint32 buffer, const void* data, uintptr offset, uintptr dataSize)
+	{
+		if (!CheckBufferRange(buffer, offset, dataSize, "UpdateUniformBuffer")) return;
+
+		if (BeginCommand(RenderCommandType::UpdateBuffer, dataSize))
+		{
+			std::vector<uint8> bytes = CopyBytes(data, dataSize);
+			m_commandStream.Record(RenderCommandType::UpdateBuffer, dataSize, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateUniformBuffer(context.Get(buffer), bytes.data(), offset, bytes.size()); });
+		}
+	}
+
+	void NullRenderDevice::UpdateUniformBuffer(uint32 buffer, const void* data, uintptr dataSize)
+	{
+		UpdateUniformBuffer(buffer, data, 0, dataSize);
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// SHADER OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 NullRenderDevice::CreateShaderProgram(const std::string& shaderText, ShaderUniformData* data, bool usesGeometryShader)
+	{
+		const uint32 shader = CreateResource(NullResourceType::Shader);
+		NullShaderProgram& program = m_shaderPrograms[shader];
+		ReflectShaderUniforms(shaderText, program);
+		*data = program.m_uniformData;
+
+		if (BeginCommand(RenderCommandType::CreateShader))
+		{
+			m_commandStream.Record(RenderCommandType::CreateShader, 0, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{
+					ShaderUniformData uniformData;
+					context.m_handles[shader] = device.CreateShaderProgram(shaderText, &uniformData, usesGeometryShader);
+				});
+		}
+
+		return shader;
+	}
+
+	bool NullRenderDevice::ValidateShaderProgram(uint32 shader)
+	{
+		// Returns true on errors like the GL device.
+		return !CheckResource(shader, NullResourceType::Shader, "ValidateShaderProgram", false);
+	}
+
+	uint32 NullRenderDevice::ReleaseShaderProgram(uint32 shader)
+	{
+		if (ReleaseResource(shader, NullResourceType::Shader, "ReleaseShaderProgram") == 0) return 0;
+		m_shaderPrograms.erase(shader);
+		if (m_boundShader == shader) m_boundShader = 0;
+
+		if (BeginCommand(RenderCommandType::ReleaseShader))
+			m_commandStream.Record(RenderCommandType::ReleaseShader, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseShaderProgram(context.Get(shader)); });
+
+		return 0;
+	}
+
+	void NullRenderDevice::SetShader(uint32 shader)
+	{
+		if (shader == m_boundShader) return;
+		if (!CheckResource(shader, NullResourceType::Shader, "SetShader")) return;
+
+		m_boundShader = shader;
+		m_frameStats.m_shaderBinds++;
+
+		if (BeginCommand(RenderCommandType::SetShader))
+			m_commandStream.Record(RenderCommandType::SetShader, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetShader(context.Get(shader)); });
+	}
+
+	void NullRenderDevice::SetShaderUniformBuffer(uint32 shader, const std::string& uniformBufferName, uint32 buffer)
+	{
+		if (!CheckResource(shader, NullResourceType::Shader, "SetShaderUniformBuffer", false) || !CheckResource(buffer, NullResourceType::Buffer, "SetShaderUniformBuffer", false)) return;
+		m_frameStats.m_bufferBinds++;
+
+		if (BeginCommand(RenderCommandType::BindBuffer))
+			m_commandStream.Record(RenderCommandType::BindBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetShaderUniformBuffer(context.Get(shader), uniformBufferName, context.Get(buffer)); });
+	}
+
+	void NullRenderDevice::BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName)
+	{
+		if (!CheckResource(shader, NullResourceType::Shader, "BindShaderBlockToBufferPoint", false)) return;
+
+		if (BeginCommand(RenderCommandType::BindBuffer))
+		{
+			m_commandStream.Record(RenderCommandType::BindBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{
+					std::string replayBlockName = blockName;
+					device.BindShaderBlockToBufferPoint(context.Get(shader), blockPoint, replayBlockName);
+				});
+		}
+	}
+
+	ShaderUniformData NullRenderDevice::ScanShaderUniforms(uint32 shader)
+	{
+		std::map<uint32, NullShaderProgram>::iterator it = m_shaderPrograms.find(shader);
+		if (it == m_shaderPrograms.end())
+		{
+			ReportError("ScanShaderUniforms", "unknown or released shader");
+			return ShaderUniformData();
+		}
+
+		return it->second.m_uniformData;
+	}
+
+	bool NullRenderDevice::HasShaderUniform(uint32 shader, const std::string& uniform)
+	{
+		std::map<uint32, NullShaderProgram>::iterator it = m_shaderPrograms.find(shader);
+		return it != m_shaderPrograms.end() && it->second.m_uniforms.find(uniform) != it->second.m_uniforms.end();
+	}
+
+	void NullRenderDevice::UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, const float f)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformFloat") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(float)))
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(float), [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateShaderUniformFloat(context.Get(shader), uniform, f); });
+	}
+
+	void NullRenderDevice::UpdateShaderUniformInt(uint32 shader, const std::string& uniform, const int f)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformInt") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(int)))
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(int), [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateShaderUniformInt(context.Get(shader), uniform, f); });
+	}
+
+	void NullRenderDevice::UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& color)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformColor") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(float) * 3))
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(float) * 3, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateShaderUniformColor(context.Get(shader), uniform, color); });
+	}
+
+	void NullRenderDevice::UpdateShaderUniformVector2(uint32 shader, const std::string& uniform, const Vector2& m)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformVector2") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(float) * 2))
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(float) * 2, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateShaderUniformVector2(context.Get(shader), uniform, m); });
+	}
+
+	void NullRenderDevice::UpdateShaderUniformVector3(uint32 shader, const std::string& uniform, const Vector3& m)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformVector3") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(float) * 3))
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(float) * 3, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateShaderUniformVector3(context.Get(shader), uniform, m); });
+	}
+
+	void NullRenderDevice::UpdateShaderUniformVector4F(uint32 shader, const std::string& uniform, const Vector4& m)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformVector4F") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(float) * 4))
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(float) * 4, [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateShaderUniformVector4F(context.Get(shader), uniform, m); });
+	}
+
+	void NullRenderDevice::UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, const Matrix& m)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformMatrix") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(Matrix)))
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(Matrix), [=](GLRenderDevice& device, RenderReplayContext& context) { device.UpdateShaderUniformMatrix(context.Get(shader), uniform, m); });
+	}
+
+	void NullRenderDevice::UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, void* data)
+	{
+		if (CheckUniform(shader, uniform, "UpdateShaderUniformMatrix") && BeginCommand(RenderCommandType::UpdateUniform, sizeof(float) * 16))
+		{
+			std::vector<float> matrix((float*)data, (float*)data + 16);
+			m_commandStream.Record(RenderCommandType::UpdateUniform, sizeof(float) * 16, [=](GLRenderDevice& device, RenderReplayContext& context) mutable { device.UpdateShaderUniformMatrix(context.Get(shader), uniform, (void*)matrix.data()); });
+		}
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// RENDER TARGET OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 NullRenderDevice::CreateRenderTarget(uint32 texture, int32 width, int32 height, TextureBindMode bindTextureMode, FrameBufferAttachment attachment, uint32 attachmentNumber, uint32 mipLevel, bool noReadWrite, bool bindRBO, FrameBufferAttachment rboAtt, uint32 rbo, bool errorCheck)
+	{
+		CheckResource(texture, NullResourceType::Texture, "CreateRenderTarget");
+		if (bindRBO)
+			CheckResource(rbo, NullResourceType::RenderBuffer, "CreateRenderTarget", false);
+
+		const uint32 fbo = CreateResource(NullResourceType::RenderTarget);
+
+		if (BeginCommand(RenderCommandType::CreateRenderTarget))
+		{
+			m_commandStream.Record(RenderCommandType::CreateRenderTarget, 0, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{ context.m_handles[fbo] = device.CreateRenderTarget(context.Get(texture), width, height, bindTextureMode, attachment, attachmentNumber, mipLevel, noReadWrite, bindRBO, rboAtt, context.Get(rbo), errorCheck); });
+		}
+
+		return fbo;
+	}
+
+	void NullRenderDevice::BindTextureToRenderTarget(uint32 fbo, uint32 texture, TextureBindMode bindTextureMode, FrameBufferAttachment attachment, uint32 attachmentNumber, uint32 textureAttachmentNumber, int mipLevel, bool bindTexture, bool setDefaultFBO)
+	{
+		if (!CheckResource(fbo, NullResourceType::RenderTarget, "BindTextureToRenderTarget", false) || !CheckResource(texture, NullResourceType::Texture, "BindTextureToRenderTarget", false)) return;
+
+		if (BeginCommand(RenderCommandType::UpdateRenderTarget))
+		{
+			m_commandStream.Record(RenderCommandType::UpdateRenderTarget, 0, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{ device.BindTextureToRenderTarget(context.Get(fbo), context.Get(texture), bindTextureMode, attachment, attachmentNumber, textureAttachmentNumber, mipLevel, bindTexture, setDefaultFBO); });
+		}
+	}
+
+	void NullRenderDevice::MultipleDrawBuffersCommand(uint32 fbo, uint32 bufferCount, uint32* attachments)
+	{
+		if (!CheckResource(fbo, NullResourceType::RenderTarget, "MultipleDrawBuffersCommand", false)) return;
+
+		if (BeginCommand(RenderCommandType::UpdateRenderTarget))
+		{
+			std::vector<uint32> attachmentData(attachments, attachments + bufferCount);
+			m_commandStream.Record(RenderCommandType::UpdateRenderTarget, 0, [=](GLRenderDevice& device, RenderReplayContext& context) mutable { device.MultipleDrawBuffersCommand(context.Get(fbo), bufferCount, attachmentData.data()); });
+		}
+	}
+
+	void NullRenderDevice::ResizeRTTexture(uint32 texture, Vector2 newSize, PixelFormat internalPixelFormat, PixelFormat pixelFormat, TextureBindMode bindMode, bool compress)
+	{
+		if (!CheckResource(texture, NullResourceType::Texture, "ResizeRTTexture", false)) return;
+
+		if (BeginCommand(RenderCommandType::UpdateRenderTarget))
+			m_commandStream.Record(RenderCommandType::UpdateRenderTarget, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ResizeRTTexture(context.Get(texture), newSize, internalPixelFormat, pixelFormat, bindMode, compress); });
+	}
+
+	void NullRenderDevice::ResizeRenderBuffer(uint32 fbo, uint32 rbo, Vector2 newSize, RenderBufferStorage storage)
+	{
+		if (!CheckResource(fbo, NullResourceType::RenderTarget, "ResizeRenderBuffer") || !CheckResource(rbo, NullResourceType::RenderBuffer, "ResizeRenderBuffer", false)) return;
+
+		if (BeginCommand(RenderCommandType::UpdateRenderTarget))
+			m_commandStream.Record(RenderCommandType::UpdateRenderTarget, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ResizeRenderBuffer(context.Get(fbo), context.Get(rbo), newSize, storage); });
+	}
+
+	uint32 NullRenderDevice::ReleaseRenderTarget(uint32 target)
+	{
+		if (ReleaseResource(target, NullResourceType::RenderTarget, "ReleaseRenderTarget") == 0) return 0;
+		if (m_boundFBO == target) m_boundFBO = 0;
+
+		if (BeginCommand(RenderCommandType::ReleaseRenderTarget))
+			m_commandStream.Record(RenderCommandType::ReleaseRenderTarget, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseRenderTarget(context.Get(target)); });
+
+		return 0;
+	}
+
+	uint32 NullRenderDevice::CreateRenderBufferObject(RenderBufferStorage storage, uint32 width, uint32 height, int sampleCount)
+	{
+		const uint32 rbo = CreateResource(NullResourceType::RenderBuffer);
+
+		if (BeginCommand(RenderCommandType::CreateRenderBuffer))
+			m_commandStream.Record(RenderCommandType::CreateRenderBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { context.m_handles[rbo] = device.CreateRenderBufferObject(storage, width, height, sampleCount); });
+
+		return rbo;
+	}
+
+	uint32 NullRenderDevice::ReleaseRenderBufferObject(uint32 target)
+	{
+		if (ReleaseResource(target, NullResourceType::RenderBuffer, "ReleaseRenderBufferObject") != 0 && BeginCommand(RenderCommandType::ReleaseRenderBuffer))
+			m_commandStream.Record(RenderCommandType::ReleaseRenderBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.ReleaseRenderBufferObject(context.Get(target)); });
+
+		return 0;
+	}
+
+	bool NullRenderDevice::IsRenderTargetComplete(uint32 fbo)
+	{
+		return CheckResource(fbo, NullResourceType::RenderTarget, "IsRenderTargetComplete", false);
+	}
+
+	void NullRenderDevice::GenerateTextureMipmaps(uint32 texture, TextureBindMode bindMode)
+	{
+		if (!CheckResource(texture, NullResourceType::Texture, "GenerateTextureMipmaps", false)) return;
+
+		if (BeginCommand(RenderCommandType::Copy))
+			m_commandStream.Record(RenderCommandType::Copy, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.GenerateTextureMipmaps(context.Get(texture), bindMode); });
+	}
+
+	void NullRenderDevice::BlitFrameBuffers(uint32 readFBO, uint32 readWidth, uint32 readHeight, uint32 writeFBO, uint32 writeWidth, uint32 writeHeight, BufferBit mask, SamplerFilter filter)
+	{
+		if (!CheckResource(readFBO, NullResourceType::RenderTarget, "BlitFrameBuffers") || !CheckResource(writeFBO, NullResourceType::RenderTarget, "BlitFrameBuffers")) return;
+
+		if (BeginCommand(RenderCommandType::Copy))
+			m_commandStream.Record(RenderCommandType::Copy, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.BlitFrameBuffers(context.Get(readFBO), readWidth, readHeight, context.Get(writeFBO), writeWidth, writeHeight, mask, filter); });
+	}
+
+	void NullRenderDevice::CopyTextureRegion(uint32 srcTexture, Vector2 srcPos, Vector2 srcSize, uint32 dstTexture, Vector2 dstPos, Vector2 dstSize)
+	{
+		if (!CheckResource(srcTexture, NullResourceType::Texture, "CopyTextureRegion", false) || !CheckResource(dstTexture, NullResourceType::Texture, "CopyTextureRegion", false)) return;
+
+		if (BeginCommand(RenderCommandType::Copy))
+			m_commandStream.Record(RenderCommandType::Copy, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.CopyTextureRegion(context.Get(srcTexture), srcPos, srcSize, context.Get(dstTexture), dstPos, dstSize); });
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// DRAWING OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	void NullRenderDevice::SetDrawParameters(const DrawParams& drawParams)
+	{
+		if (BeginCommand(RenderCommandType::SetDrawParameters))
+			m_commandStream.Record(RenderCommandType::SetDrawParameters, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetDrawParameters(drawParams); });
+	}
+
+	void NullRenderDevice::Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays)
+	{
+		if (!drawArrays && numInstances == 0) return;
+
+		CheckDraw(vao, drawArrays ? 0 : numElements, "Draw");
+		CountDraw(drawArrays ? 1 : numInstances, numElements);
+
+		if (BeginCommand(RenderCommandType::Draw))
+			m_commandStream.Record(RenderCommandType::Draw, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.Draw(context.Get(vao), drawParams, numInstances, numElements, drawArrays); });
+	}
+
+	void NullRenderDevice::DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex)
+	{
+		if (numElements == 0) return;
+
+		CheckDraw(vao, numElements, "DrawBaseVertex");
+		CountDraw(1, numElements);
+
+		if (BeginCommand(RenderCommandType::Draw))
+			m_commandStream.Record(RenderCommandType::Draw, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.DrawBaseVertex(context.Get(vao), drawParams, numElements, baseVertex); });
+	}
+
+	void NullRenderDevice::DrawInstancedBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, uint32 firstIndex, uint32 baseVertex)
+	{
+		if (numInstances == 0 || numElements == 0) return;
+
+		CheckDraw(vao, firstIndex + numElements, "DrawInstancedBaseVertex");
+		CountDraw(numInstances, numElements);
+
+		if (BeginCommand(RenderCommandType::Draw))
+			m_commandStream.Record(RenderCommandType::Draw, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.DrawInstancedBaseVertex(context.Get(vao), drawParams, numInstances, numElements, firstIndex, baseVertex); });
+	}
+
+	void NullRenderDevice::MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, uint32 indirectBuffer, uintptr offset, uint32 drawCount)
+	{
+		if (drawCount == 0) return;
+
+		// Commands live in GPU memory, only the buffer range can be validated.
+		CheckDraw(vao, 0, "MultiDrawIndirect");
+		CheckBufferRange(indirectBuffer, offset, drawCount * sizeof(DrawElementsIndirectCommand), "MultiDrawIndirect");
+		m_frameStats.m_drawCalls++;
+		m_frameStats.m_indirectDraws += drawCount;
+
+		if (BeginCommand(RenderCommandType::Draw))
+			m_commandStream.Record(RenderCommandType::Draw, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.MultiDrawIndirect(context.Get(vao), drawParams, context.Get(indirectBuffer), offset, drawCount); });
+	}
+
+	void NullRenderDevice::DrawLines(uint32 vao, const DrawParams& drawParams, uint32 firstVertex, uint32 numVertices, float width)
+	{
+		if (numVertices == 0) return;
+
+		CheckDraw(vao, 0, "DrawLines");
+		CountDraw(1, numVertices);
+
+		if (BeginCommand(RenderCommandType::Draw))
+			m_commandStream.Record(RenderCommandType::Draw, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.DrawLines(context.Get(vao), drawParams, firstVertex, numVertices, width); });
+	}
+
+	void NullRenderDevice::Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const Color& color, uint32 stencil)
+	{
+		if (BeginCommand(RenderCommandType::Clear))
+		{
+			Color clearColor = color;
+			m_commandStream.Record(RenderCommandType::Clear, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.Clear(shouldClearColor, shouldClearDepth, shouldClearStencil, clearColor, stencil); });
+		}
+	}
+
+	void NullRenderDevice::SetTexture(uint32 texture, uint32 sampler, uint32 unit, TextureBindMode bindTextureMode, bool setSampler)
+	{
+		if (!CheckResource(texture, NullResourceType::Texture, "SetTexture")) return;
+		if (setSampler && !CheckResource(sampler, NullResourceType::Sampler, "SetTexture")) return;
+		m_frameStats.m_textureBinds++;
+
+		if (BeginCommand(RenderCommandType::SetTexture))
+			m_commandStream.Record(RenderCommandType::SetTexture, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetTexture(context.Get(texture), context.Get(sampler), unit, bindTextureMode, setSampler); });
+	}
+
+	void NullRenderDevice::SetStencilWriteMask(uint32 mask)
+	{
+		if (BeginCommand(RenderCommandType::SetState))
+			m_commandStream.Record(RenderCommandType::SetState, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetStencilWriteMask(mask); });
+	}
+
+	void NullRenderDevice::SetDepthTestEnable(bool enable)
+	{
+		if (BeginCommand(RenderCommandType::SetState))
+			m_commandStream.Record(RenderCommandType::SetState, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetDepthTestEnable(enable); });
+	}
+
+	void NullRenderDevice::SetFBO(uint32 fbo)
+	{
+		if (fbo == m_boundFBO) return;
+		if (!CheckResource(fbo, NullResourceType::RenderTarget, "SetFBO")) return;
+
+		m_boundFBO = fbo;
+		m_frameStats.m_frameBufferBinds++;
+
+		if (BeginCommand(RenderCommandType::SetFrameBuffer))
+			m_commandStream.Record(RenderCommandType::SetFrameBuffer, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetFBO(context.Get(fbo)); });
+	}
+
+	void NullRenderDevice::SetVAO(uint32 vao)
+	{
+		if (vao == m_boundVAO) return;
+		if (!CheckResource(vao, NullResourceType::VertexArray, "SetVAO")) return;
+
+		TrackVertexArrayBind(vao);
+
+		if (BeginCommand(RenderCommandType::SetVertexArray))
+			m_commandStream.Record(RenderCommandType::SetVertexArray, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetVAO(context.Get(vao)); });
+	}
+
+	void NullRenderDevice::CaptureHDRILightingData(Matrix& view, Matrix& projection, Vector2 captureSize, uint32 cubeMapTexture, uint32 hdrTexture, uint32 fbo, uint32 rbo, uint32 shader)
+	{
+		CheckResource(cubeMapTexture, NullResourceType::Texture, "CaptureHDRILightingData", false);
+		CheckResource(hdrTexture, NullResourceType::Texture, "CaptureHDRILightingData", false);
+		CheckResource(fbo, NullResourceType::RenderTarget, "CaptureHDRILightingData", false);
+		CheckResource(rbo, NullResourceType::RenderBuffer, "CaptureHDRILightingData", false);
+		CheckResource(shader, NullResourceType::Shader, "CaptureHDRILightingData", false);
+		CountDraw(6, 36);
+
+		if (BeginCommand(RenderCommandType::Draw))
+		{
+			Matrix captureView = view;
+			Matrix captureProjection = projection;
+			m_commandStream.Record(RenderCommandType::Draw, 0, [=](GLRenderDevice& device, RenderReplayContext& context)
+				{
+					Matrix replayView = captureView;
+					Matrix replayProjection = captureProjection;
+					device.CaptureHDRILightingData(replayView, replayProjection, captureSize, context.Get(cubeMapTexture), context.Get(hdrTexture), context.Get(fbo), context.Get(rbo), context.Get(shader));
+				});
+		}
+	}
+
+	void NullRenderDevice::SetViewport(Vector2 pos, Vector2 size)
+	{
+		m_boundViewportPos = pos;
+		m_boundViewportSize = size;
+
+		if (BeginCommand(RenderCommandType::SetViewport))
+			m_commandStream.Record(RenderCommandType::SetViewport, 0, [=](GLRenderDevice& device, RenderReplayContext& context) { device.SetViewport(pos, size); });
+	}
+
+	void NullRenderDevice::EndFrame()
+	{
+		m_commandStream.EndFrame(m_frameStats);
+		m_lastFrameStats = m_frameStats;
+		m_frameStats = RenderDeviceFrameStats();
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// VALIDATION
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	bool NullRenderDevice::BeginCommand(RenderCommandType type, uintptr dataSize)
+	{
+		m_frameStats.m_commands++;
+		m_frameStats.m_commandCounts[(uint32)type]++;
+		m_frameStats.m_uploadedBytes += dataSize;
+		return m_commandStream.GetIsRecording() || RenderCommandStream::IsResourceCommand(type);
+	}
+
+	uint32 NullRenderDevice::CreateResource(NullResourceType type, uintptr size)
+	{
+		const uint32 handle = m_nextHandle++;
+		NullResource& resource = m_resources[handle];
+		resource.m_type = type;
+		resource.m_size = size;
+		return handle;
+	}
+
+	uint32 NullRenderDevice::ReleaseResource(uint32 handle, NullResourceType type, const char* command)
+	{
+		// Returns the released handle, 0 if there was nothing to release.
+		if (handle == 0 || !CheckResource(handle, type, command)) return 0;
+		m_resources.erase(handle);
+		return handle;
+	}
+
+	NullResource* NullRenderDevice::GetResource(uint32 handle, NullResourceType type, const char* command)
+	{
+		if (!CheckResource(handle, type, command, false)) return nullptr;
+		return &m_resources[handle];
+	}
+
+	bool NullRenderDevice::CheckResource(uint32 handle, NullResourceType type, const char* command, bool allowNull)
+	{
+		if (handle == 0)
+		{
+			if (!allowNull)
+				ReportError(command, "null handle");
+
+			return allowNull;
+		}
+
+		std::unordered_map<uint32, NullResource>::iterator it = m_resources.find(handle);
+		if (it == m_resources.end())
+		{
+			ReportError(command, "unknown or released handle");
+			return false;
+		}
+
+		if (it->second.m_type != type)
+		{
+			ReportError(command, "handle of the wrong resource type");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool NullRenderDevice::CheckBufferRange(uint32 buffer, uintptr offset, uintptr dataSize, const char* command)
+	{
+		NullResource* resource = GetResource(buffer, NullResourceType::Buffer, command);
+		if (resource == nullptr) return false;
+
+		if (offset + dataSize > resource->m_size)
+		{
+			ReportError(command, "range exceeds the buffer size");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool NullRenderDevice::CheckUniform(uint32 shader, const std::string& uniform, const char* command)
+	{
+		m_frameStats.m_uniformUpdates++;
+
+		std::map<uint32, NullShaderProgram>::iterator it = m_shaderPrograms.find(shader);
+		if (it == m_shaderPrograms.end())
+		{
+			ReportError(command, "unknown or released shader");
+			return false;
+		}
+
+		// Uniforms are set on the bound program, unknown names end up at location 0 on the GL device.
+		if (shader != m_boundShader)
+			ReportError(command, "uniform updated on a shader that is not bound");
+
+		if (it->second.m_uniforms.find(uniform) == it->second.m_uniforms.end())
+			ReportError(command, "uniform is not declared in the shader", uniform);
+
+		return true;
+	}
+
+	void NullRenderDevice::CheckDraw(uint32 vao, uint32 numElements, const char* command)
+	{
+		if (m_boundShader == 0)
+			ReportError(command, "no shader bound");
+
+		NullResource* resource = GetResource(vao, NullResourceType::VertexArray, command);
+		if (resource == nullptr) return;
+
+		// Element counts are only known for vertex arrays created from model data.
+		if (resource->m_numIndices != 0 && numElements > resource->m_numIndices)
+			ReportError(command, "draw exceeds the index count of the vertex array");
+
+		TrackVertexArrayBind(vao);
+	}
+
+	void NullRenderDevice::TrackVertexArrayBind(uint32 vao)
+	{
+		if (vao == m_boundVAO) return;
+		m_boundVAO = vao;
+		m_frameStats.m_vertexArrayBinds++;
+	}
+
+	void NullRenderDevice::CountDraw(uint32 numInstances, uint32 numElements)
+	{
+		m_frameStats.m_drawCalls++;
+		m_frameStats.m_instances += numInstances;
+		m_frameStats.m_elements += numInstances * numElements;
+	}
+
+	void NullRenderDevice::ReportError(const char* command, const char* message, const std::string& detail)
+	{
+		m_frameStats.m_validationErrors++;
+
+		// Report every kind of error once, they tend to repeat each frame.
+		std::string key = std::string(command) + message + detail;
+		if (m_reportedErrors.insert(key).second)
+			LINA_CORE_WARN("[Null Render Device] {0}: {1} {2}", command, message, detail);
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// GLOBALS DEFINITIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	static uint32 GetPixelFormatComponents(PixelFormat format)
+	{
+		switch (format)
+		{
+		case PixelFormat::FORMAT_R:
+		case PixelFormat::FORMAT_R32UI:
+		case PixelFormat::FORMAT_DEPTH:
+		case PixelFormat::FORMAT_DEPTH16:
+			return 1;
+		case PixelFormat::FORMAT_RG:
+		case PixelFormat::FORMAT_RG32UI:
+		case PixelFormat::FORMAT_DEPTH_AND_STENCIL:
+			return 2;
+		case PixelFormat::FORMAT_RGB:
+		case PixelFormat::FORMAT_RGB16F:
+		case PixelFormat::FORMAT_SRGB:
+			return 3;
+		default:
+			return 4;
+		}
+	}
+
+	static std::vector<uint8> CopyBytes(const void* data, uintptr dataSize)
+	{
+		if (data == nullptr || dataSize == 0) return std::vector<uint8>();
+		return std::vector<uint8>((const uint8*)data, (const uint8*)data + dataSize);
+	}
+
+	static void ReflectShaderUniforms(const std::string& shaderText, NullShaderProgram& program)
+	{
+		// Strip the comments & split the text into statements.
+		std::string text;
+		text.reserve(shaderText.size());
+		for (size_t i = 0; i < shaderText.size(); i++)
+		{
+			if (shaderText.compare(i, 2, "//") == 0)
+				i = std::min(shaderText.find('\n', i), shaderText.size()) - 1;
+			else if (shaderText.compare(i, 2, "/*") == 0)
+				i = std::min(shaderText.find("*/", i), shaderText.size() - 2) + 1;
+			else if (shaderText[i] == '{' || shaderText[i] == '}' || shaderText[i] == ';')
+			{
+				text += ' ';
+				text += shaderText[i];
+				text += ' ';
+			}
+			else
+				text += shaderText[i];
+		}
+
+		std::vector<std::string> tokens;
+		std::istringstream stream(text);
+		for (std::string token; stream >> token;)
+			tokens.push_back(token);
+
+		// Struct members, then the uniforms declared outside of blocks.
+		std::map<std::string, std::vector<std::pair<std::string, std::string>>> structs;
+		std::vector<std::pair<std::string, std::string>> uniforms;
+		for (size_t i = 0; i + 2 < tokens.size(); i++)
+		{
+			if (tokens[i] == "struct" && tokens[i + 2] == "{")
+			{
+				std::vector<std::pair<std::string, std::string>>& members = structs[tokens[i + 1]];
+				for (i += 3; i + 2 < tokens.size() && tokens[i] != "}"; i += 3)
+					members.push_back(std::make_pair(tokens[i], tokens[i + 1]));
+			}
+			else if (tokens[i] == "uniform" && tokens[i + 2] != "{" && tokens[i + 3 < tokens.size() ? i + 3 : i] == ";")
+				uniforms.push_back(std::make_pair(tokens[i + 1], tokens[i + 2]));
+		}
+
+		// Flatten struct uniforms into their members like GL reports them.
+		uint32 samplerUnit = 0;
+		while (!uniforms.empty())
+		{
+			const std::string type = uniforms.front().first;
+			const std::string name = uniforms.front().second;
+			uniforms.erase(uniforms.begin());
+
+			std::map<std::string, std::vector<std::pair<std::string, std::string>>>::iterator it = structs.find(type);
+			if (it != structs.end())
+			{
+				for (size_t i = 0; i < it->second.size(); i++)
+					uniforms.insert(uniforms.begin() + i, std::make_pair(it->second[i].first, name + "." + it->second[i].second));
+				continue;
+			}
+
+			program.m_uniforms.insert(name);
+			if (name.find("material.") == std::string::npos && name.find("uf_") == std::string::npos) continue;
+
+			ShaderUniformData& data = program.m_uniformData;
+			if (name.find(".texture") != std::string::npos)
+			{
+				const std::string samplerName = name.substr(0, name.find_last_of("."));
+				if (type == "sampler2D")
+					data.m_sampler2Ds[samplerName] = { samplerUnit++, TextureBindMode::BINDTEXTURE_TEXTURE2D };
+				else if (type == "samplerCube")
+					data.m_sampler2Ds[samplerName] = { samplerUnit++, TextureBindMode::BINDTEXTURE_CUBEMAP };
+			}
+			else if (name.find(".isActive") != std::string::npos)
+				continue;
+
+			if (type == "float")
+				data.m_floats[name] = 0.0f;
+			else if (type == "int")
+				data.m_ints[name] = 0;
+			else if (type == "vec2")
+				data.m_vector2s[name] = Vector2::One;
+			else if (type == "vec3")
+			{
+				if (name.find("color") != std::string::npos || name.find("Color") != std::string::npos)
+					data.m_colors[name] = Color::White;
+				else
+					data.m_vector3s[name] = Vector3::One;
+			}
+			else if (type == "vec4")
+				data.m_vector4s[name] = Vector4::One;
+			else if (type == "bool")
+				data.m_bools[name] = false;
+			else if (type == "mat4")
+				data.m_matrices[name] = Matrix::Identity();
+		}
+	}
+}
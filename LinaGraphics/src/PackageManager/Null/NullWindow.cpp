@@ -0,0 +1,93 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "PackageManager/Null/NullWindow.hpp"
+#include "Utility/Log.hpp"
+
+namespace LinaEngine::Graphics
+{
+	NullWindow::NullWindow()
+	{
+		LINA_CORE_TRACE("[Constructor] -> NullWindow ({0})", typeid(*this).name());
+	}
+
+	NullWindow::~NullWindow()
+	{
+		LINA_CORE_TRACE("[Destructor] -> NullWindow ({0})", typeid(*this).name());
+	}
+
+	bool NullWindow::CreateContext(WindowProperties propsIn)
+	{
+		LINA_CORE_TRACE("[Initialization] -> NullWindow ({0})", typeid(*this).name());
+		m_windowProperties = propsIn;
+		m_startTime = std::chrono::steady_clock::now();
+		return true;
+	}
+
+	double NullWindow::GetTime()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+	}
+
+	void NullWindow::SetSize(const Vector2& newSize)
+	{
+		m_windowProperties.m_width = (unsigned int)newSize.x;
+		m_windowProperties.m_height = (unsigned int)newSize.y;
+
+		if (m_windowResizeCallback)
+			m_windowResizeCallback(newSize);
+	}
+
+	void NullWindow::SetPos(const Vector2& newPos)
+	{
+		m_windowProperties.m_xPos = newPos.x;
+		m_windowProperties.m_yPos = newPos.y;
+	}
+
+	void NullWindow::SetPosCentered(const Vector2 newPos)
+	{
+		// No monitor to center on, the offset is the position.
+		SetPos(newPos);
+	}
+
+	void NullWindow::Iconify()
+	{
+		m_windowProperties.m_windowState = WindowState::Iconified;
+	}
+
+	void NullWindow::Maximize()
+	{
+		m_windowProperties.m_windowState = m_windowProperties.m_windowState != WindowState::Maximized ? WindowState::Maximized : WindowState::Normal;
+	}
+
+	void NullWindow::Close()
+	{
+		if (m_windowCloseCallback)
+			m_windowCloseCallback();
+	}
+}
@@ -0,0 +1,95 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "PackageManager/Null/RenderCommandStream.hpp"
+#include "PackageManager/OpenGL/GLRenderDevice.hpp"
+#include <algorithm>
+
+namespace LinaEngine::Graphics
+{
+	uint32 RenderReplayContext::Get(uint32 handle) const
+	{
+		// 0 is the default object for every kind of handle.
+		if (handle == 0) return 0;
+		std::unordered_map<uint32, uint32>::const_iterator it = m_handles.find(handle);
+		return it == m_handles.end() ? 0 : it->second;
+	}
+
+	void* RenderReplayContext::GetFence(void* fence) const
+	{
+		std::unordered_map<void*, void*>::const_iterator it = m_fences.find(fence);
+		return it == m_fences.end() ? nullptr : it->second;
+	}
+
+	void RenderCommandStream::Record(RenderCommandType type, uintptr dataSize, const RenderReplayFunction& replay)
+	{
+		if (!m_isRecording && !IsResourceCommand(type)) return;
+
+		RenderCommand& command = m_commands.emplace_back();
+		command.m_type = type;
+		command.m_frame = m_frame;
+		command.m_dataSize = dataSize;
+		command.m_replay = replay;
+	}
+
+	void RenderCommandStream::EndFrame(const RenderDeviceFrameStats& stats)
+	{
+		if (m_isRecording)
+		{
+			m_frameStats.push_back(stats);
+			m_frameStats.back().m_frame = m_frame;
+		}
+
+		m_frame++;
+	}
+
+	void RenderCommandStream::ClearFrames()
+	{
+		m_commands.erase(std::remove_if(m_commands.begin(), m_commands.end(), [](const RenderCommand& command) { return !IsResourceCommand(command.m_type); }), m_commands.end());
+		m_frameStats.clear();
+	}
+
+	void RenderCommandStream::Replay(GLRenderDevice& device) const
+	{
+		RenderReplayContext context;
+		for (const RenderCommand& command : m_commands)
+			command.m_replay(device, context);
+	}
+
+	void RenderCommandStream::ReplayFrame(GLRenderDevice& device, uint32 frame) const
+	{
+		RenderReplayContext context;
+		for (const RenderCommand& command : m_commands)
+		{
+			if (command.m_frame > frame) break;
+
+			if (command.m_frame == frame || IsResourceCommand(command.m_type))
+				command.m_replay(device, context);
+		}
+	}
+}
@@ -30,6 +30,7 @@ SOFTWARE.
 #include "Utility/Math/Color.hpp"
 #include "PackageManager/Generic/GenericMemory.hpp"
 #include "glad/glad.h"
+#include <glm/gtc/packing.hpp>
 
 namespace LinaEngine::Graphics
 {
@@ -56,25 +57,6 @@ namespace LinaEngine::Graphics
 	// ---------------------------------------------------------------------
 	// ---------------------------------------------------------------------
 
-	float lineVertices[]
-	{
-		0.0f, 0.0f, 1.0f,
-		0.0f, 0.0f, 0.0f
-	};
-
-	struct btLine {
-		GLfloat vertices[6];
-		btLine(const Vector3& f, const Vector3& t) {
-			vertices[0] = f.x;
-			vertices[1] = f.y;
-			vertices[2] = f.z;
-
-			vertices[3] = t.x;
-			vertices[4] = t.y;
-			vertices[5] = t.z;
-		}
-	};
-
 	float skyboxVertices[] = {
 		// positions          
 		-1.0f,  1.0f, -1.0f,
@@ -189,6 +171,10 @@ namespace LinaEngine::Graphics
 	static void AddAllAttributes(GLuint program, const std::string& vertexShaderText, uint32 version);
 	static bool CheckShaderError(GLuint shader, int flag, bool isProgram, const std::string& errorMessage);
 	static void AddShaderUniforms(GLuint shaderProgram, const std::string& shaderText, std::map<std::string, GLint>& uniformBlockMap, std::map<std::string, GLint>& uniformMap, std::map<std::string, GLint>& samplerMap);
+	static uint32 GetVertexElementByteSize(uint32 elementType);
+	static void PackVertexElement(uint32 elementType, const float* source, uint32 count, uint8* destination);
+	static uint32 GetInterleavedVertexLayout(const uint32* elementSizes, const uint32* elementTypes, uint32 numVertexComponents, uint32* componentOffsets);
+	static void InterleaveVertices(const float** vertexData, const uint32* elementSizes, const uint32* elementTypes, uint32 numVertexComponents, const uint32* componentOffsets, uint32 vertexStride, uint32 numVertices, uint8* destination);
 
 	GLRenderDevice::GLRenderDevice()
 	{
@@ -407,6 +393,37 @@ namespace LinaEngine::Graphics
 		return textureHandle;
 	}
 
+	void GLRenderDevice::UpdateTexture2D(uint32 texture, Vector2 size, const void* data, PixelFormat pixelFormat)
+	{
+		// Replace the whole image, storage is kept as is.
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y, GetOpenGLFormat(pixelFormat), GL_UNSIGNED_BYTE, data);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void GLRenderDevice::UpdateTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, Vector2 size, const uint16* data, PixelFormat pixelFormat)
+	{
+		// Image target is either a 2D texture or one of the cubemap's faces.
+		GLenum textureTarget = imageTarget == TextureBindMode::BINDTEXTURE_TEXTURE2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP;
+		glBindTexture(textureTarget, texture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(imageTarget, mipLevel, 0, 0, size.x, size.y, GetOpenGLFormat(pixelFormat), GL_HALF_FLOAT, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glBindTexture(textureTarget, 0);
+	}
+
+	bool GLRenderDevice::ReadTextureHalf(uint32 texture, TextureBindMode imageTarget, uint32 mipLevel, uint16* data, PixelFormat pixelFormat)
+	{
+		// Synchronous, waits for the GPU to finish writing the texture.
+		GLenum textureTarget = imageTarget == TextureBindMode::BINDTEXTURE_TEXTURE2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP;
+		glBindTexture(textureTarget, texture);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTexImage(imageTarget, mipLevel, GetOpenGLFormat(pixelFormat), GL_HALF_FLOAT, data);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glBindTexture(textureTarget, 0);
+		return glGetError() == GL_NO_ERROR;
+	}
+
 	uint32 GLRenderDevice::CreateTexture2DEmpty(Vector2 size, SamplerParameters samplerParams)
 	{
 		// Declare formats, target & handle for the texture.
@@ -438,6 +455,39 @@ namespace LinaEngine::Graphics
 		return textureHandle;
 	}
 
+	uint32 GLRenderDevice::CreateTextureBuffer(PixelFormat internalPixelFormat, uint32& buffer)
+	{
+		// Buffer texture, read with texelFetch. Data is uploaded separately.
+		uint32 texture;
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+		glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GetOpenGLInternalFormat(internalPixelFormat, false), buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+		return texture;
+	}
+
+	void GLRenderDevice::UpdateTextureBuffer(uint32 buffer, const void* data, uintptr dataSize)
+	{
+		// Orphan the storage, the previous contents might still be in use.
+		glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+		glBufferData(GL_TEXTURE_BUFFER, dataSize, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, dataSize, data);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	}
+
+	uint32 GLRenderDevice::ReleaseTextureBuffer(uint32 texture, uint32 buffer)
+	{
+		if (texture != 0)
+			glDeleteTextures(1, &texture);
+		if (buffer != 0)
+			glDeleteBuffers(1, &buffer);
+		return 0;
+	}
+
 	void GLRenderDevice::SetupTextureParameters(uint32 textureTarget, SamplerParameters samplerParams, bool useBorder, float* borderColor)
 	{
 		// OpenGL texture params.
@@ -496,11 +546,37 @@ namespace LinaEngine::Graphics
 		GLuint VAO;
 		GLuint* buffers = new GLuint[numBuffers];
 		uintptr* bufferSizes = new uintptr[numBuffers];
+		uint32* attributeStarts = new uint32[numBuffers];
+		uint32* elementSizes = new uint32[numBuffers];
+		uint32* elementTypes = new uint32[numBuffers];
+		uint32* sourceBuffers = new uint32[numBuffers];
+		uintptr* sourceOffsets = new uintptr[numBuffers];
 
 		// Generate vertex array object and activate it, then generate necessary buffers.
 		glGenVertexArrays(1, &VAO);
 		SetVAO(VAO);
-		glGenBuffers(numBuffers, buffers);
+
+		// Vertex components are interleaved into a single buffer so a vertex is fetched from one place, they all refer to it.
+		// Components are converted to their storage type & kept 4 byte aligned. Instance components keep their own buffers.
+		// Without vertex data the buffers are only allocated, to be filled in ranges later on.
+		std::vector<uint32> componentOffsets(numVertexComponents);
+		uint32 vertexStride = GetInterleavedVertexLayout(vertexElementSizes, vertexElementTypes, numVertexComponents, componentOffsets.data());
+
+		std::vector<uint8> interleavedData;
+		if (vertexData != nullptr)
+		{
+			interleavedData.resize(vertexStride * numVertices);
+			InterleaveVertices(vertexData, vertexElementSizes, vertexElementTypes, numVertexComponents, componentOffsets.data(), vertexStride, numVertices, interleavedData.data());
+		}
+
+		if (numVertexComponents > 0)
+		{
+			glGenBuffers(1, &buffers[0]);
+			for (uint32 i = 1; i < numVertexComponents; i++)
+				buffers[i] = buffers[0];
+		}
+
+		glGenBuffers(numBuffers - numVertexComponents, &buffers[numVertexComponents]);
 
 		// Define attribute for each buffer.
 		for (uint32 i = 0, attribute = 0; i < numBuffers - 1; i++)
@@ -517,14 +593,44 @@ namespace LinaEngine::Graphics
 			// Define element size for the current buffers, as well as buffer data if applicable.
 			uint32 elementSize = vertexElementSizes[i];
 			uint32 elementType = vertexElementTypes[i];
-			const void* bufferData = inInstancedMode ? nullptr : vertexData[i];
-			uintptr dataSize = inInstancedMode ? elementSize * sizeof(float) : elementSize * sizeof(float) * numVertices;
+			uintptr dataSize = inInstancedMode ? elementSize * sizeof(float) : vertexStride * numVertices;
+
+			// Attribute layout within the buffer, interleaved vertex components are offset by the ones before them.
+			const GLsizei stride = inInstancedMode ? elementSize * sizeof(GLfloat) : vertexStride;
+			const uintptr baseOffset = inInstancedMode ? 0 : componentOffsets[i];
 
-			// Bind the current array buffer & set the data.
+			// Bind the current array buffer & set the data, the interleaved buffer is filled once.
 			glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
-			glBufferData(GL_ARRAY_BUFFER, dataSize, bufferData, attribUsage);
+			if (inInstancedMode)
+				glBufferData(GL_ARRAY_BUFFER, dataSize, nullptr, attribUsage);
+			else if (i == 0)
+				glBufferData(GL_ARRAY_BUFFER, dataSize, vertexData != nullptr ? interleavedData.data() : nullptr, attribUsage);
 			bufferSizes[i] = dataSize;
 
+			// Keep the attribute layout so instance buffers can be re-pointed later on.
+			attributeStarts[i] = attribute;
+			elementSizes[i] = elementSize;
+			elementTypes[i] = elementType;
+			sourceBuffers[i] = buffers[i];
+			sourceOffsets[i] = 0;
+
+			// Elements without data only reserve their attribute location.
+			if (elementSize == 0)
+			{
+				attribute++;
+				continue;
+			}
+
+			// Packed elements are at most 4 components, normalized types are read back as floats.
+			if (elementType == VertexElementType::ELEMENT_UNORM16 || elementType == VertexElementType::ELEMENT_SNORM16 || elementType == VertexElementType::ELEMENT_HALF)
+			{
+				const GLenum glType = elementType == VertexElementType::ELEMENT_UNORM16 ? GL_UNSIGNED_SHORT : (elementType == VertexElementType::ELEMENT_SNORM16 ? GL_SHORT : GL_HALF_FLOAT);
+				glEnableVertexAttribArray(attribute);
+				glVertexAttribPointer(attribute, elementSize, glType, elementType != VertexElementType::ELEMENT_HALF, stride, (const GLvoid*)baseOffset);
+				attribute++;
+				continue;
+			}
+
 			// Define element sizes to pass the required part of the array to the attrib pointer call.
 			uint32 elementSizeDiv = elementSize / 4;
 			uint32 elementSizeRem = elementSize % 4;
@@ -535,9 +641,9 @@ namespace LinaEngine::Graphics
 				glEnableVertexAttribArray(attribute);
 
 				if (elementType != 0)
-					glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, elementSize * sizeof(GLfloat), (const GLvoid*)(sizeof(GLfloat) * j * 4));
+					glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(baseOffset + sizeof(GLfloat) * j * 4));
 				else
-					glVertexAttribIPointer(attribute, 4, GL_INT, elementSize * sizeof(GLfloat), (const GLvoid*)(sizeof(GL_INT) * j * 4));
+					glVertexAttribIPointer(attribute, 4, GL_INT, stride, (const GLvoid*)(baseOffset + sizeof(GL_INT) * j * 4));
 
 				if (inInstancedMode)
 					glVertexAttribDivisor(attribute, 1);
@@ -551,15 +657,16 @@ namespace LinaEngine::Graphics
 				glEnableVertexAttribArray(attribute);
 
 				if (elementType != 0)
-					glVertexAttribPointer(attribute, elementSize, GL_FLOAT, GL_FALSE, elementSize * sizeof(GLfloat), (const GLvoid*)(sizeof(GLint) * elementSizeDiv * 4));
+					glVertexAttribPointer(attribute, elementSize, GL_FLOAT, GL_FALSE, stride, (const GLvoid*)(baseOffset + sizeof(GLint) * elementSizeDiv * 4));
 				else
-					glVertexAttribIPointer(attribute, elementSize, GL_INT, elementSize * sizeof(GLfloat), (const GLvoid*)(sizeof(GLint) * elementSizeDiv * 4));
+					glVertexAttribIPointer(attribute, elementSize, GL_INT, stride, (const GLvoid*)(baseOffset + sizeof(GLint) * elementSizeDiv * 4));
 
 				if (inInstancedMode)
 					glVertexAttribDivisor(attribute, 1);
 
 				attribute++;
 			}
+
 		}
 
 		// Finally bind the element array buffer.
@@ -567,6 +674,11 @@ namespace LinaEngine::Graphics
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[numBuffers - 1]);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, indices, bufferUsage);
 		bufferSizes[numBuffers - 1] = indicesSize;
+		attributeStarts[numBuffers - 1] = 0;
+		elementSizes[numBuffers - 1] = 0;
+		elementTypes[numBuffers - 1] = 0;
+		sourceBuffers[numBuffers - 1] = buffers[numBuffers - 1];
+		sourceOffsets[numBuffers - 1] = 0;
 
 		// Create vertex array based on our calculated data.
 		struct VertexArrayData vaoData;
@@ -576,6 +688,11 @@ namespace LinaEngine::Graphics
 		vaoData.numElements = numIndices;
 		vaoData.bufferUsage = bufferUsage;
 		vaoData.instanceComponentsStartIndex = numVertexComponents;
+		vaoData.attributeStarts = attributeStarts;
+		vaoData.elementSizes = elementSizes;
+		vaoData.elementTypes = elementTypes;
+		vaoData.sourceBuffers = sourceBuffers;
+		vaoData.sourceOffsets = sourceOffsets;
 
 		// Store the array in our map & return the modified vertex array object.
 		m_vaoMap[VAO] = vaoData;
@@ -604,6 +721,11 @@ namespace LinaEngine::Graphics
 		glDeleteBuffers(vaoData->numBuffers, vaoData->buffers);
 		delete[] vaoData->buffers;
 		delete[] vaoData->bufferSizes;
+		delete[] vaoData->attributeStarts;
+		delete[] vaoData->elementSizes;
+		delete[] vaoData->elementTypes;
+		delete[] vaoData->sourceBuffers;
+		delete[] vaoData->sourceOffsets;
 
 		// Remove from the map.
 		m_vaoMap.erase(it);
@@ -640,17 +762,53 @@ namespace LinaEngine::Graphics
 
 	uint32 GLRenderDevice::CreateLineVertexArray()
 	{
-		unsigned int lineVAO, lineVBO;
+		// Debug lines are streamed, the source is set before each flush.
+		unsigned int lineVAO;
 		glGenVertexArrays(1, &lineVAO);
-		glGenBuffers(1, &lineVBO);
 		SetVAO(lineVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(lineVertices), &lineVertices, GL_STATIC_DRAW);
 		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(1);
 		return lineVAO;
 	}
 
+	uint32 GLRenderDevice::CreateSpriteBatchVertexArray(uint32 maxSprites)
+	{
+		// Two triangles per sprite, base vertex offsets the pattern for each batch.
+		std::vector<uint32> indices(maxSprites * 6);
+		for (uint32 i = 0; i < maxSprites; i++)
+		{
+			uint32 vertex = i * 4;
+			uint32* quad = &indices[i * 6];
+			quad[0] = vertex; quad[1] = vertex + 1; quad[2] = vertex + 2;
+			quad[3] = vertex + 2; quad[4] = vertex + 3; quad[5] = vertex;
+		}
+
+		uint32 vao, ibo;
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(1, &ibo);
+		SetVAO(vao);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32), &indices[0], GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glEnableVertexAttribArray(1);
+		glEnableVertexAttribArray(2);
+
+		// Vertices are streamed, only keep the index buffer so the VAO can be released through the map.
+		struct VertexArrayData vaoData;
+		vaoData.buffers = new GLuint[1]{ ibo };
+		vaoData.bufferSizes = new uintptr[1]{ indices.size() * sizeof(uint32) };
+		vaoData.attributeStarts = new uint32[1]{ 0 };
+		vaoData.elementSizes = new uint32[1]{ 0 };
+		vaoData.elementTypes = new uint32[1]{ 0 };
+		vaoData.sourceBuffers = new uint32[1]{ ibo };
+		vaoData.sourceOffsets = new uintptr[1]{ 0 };
+		vaoData.numBuffers = 1;
+		vaoData.numElements = maxSprites * 6;
+		vaoData.bufferUsage = BufferUsage::USAGE_STATIC_DRAW;
+		vaoData.instanceComponentsStartIndex = 1;
+		m_vaoMap[vao] = vaoData;
+		return vao;
+	}
 
 	uint32 GLRenderDevice::CreateHDRICubeVertexArray()
 	{
@@ -718,6 +876,7 @@ namespace LinaEngine::Graphics
 		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
 		glBufferData(GL_UNIFORM_BUFFER, dataSize, data, usage);
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_boundUBO = 0;
 		return ubo;
 	}
 
@@ -725,10 +884,184 @@ namespace LinaEngine::Graphics
 	{
 		// Delete the buffer if exists.
 		if (buffer == 0) return 0;
+		if (m_boundUBO == buffer) m_boundUBO = 0;
 		glDeleteBuffers(1, &buffer);
 		return 0;
 	}
 
+	uint32 GLRenderDevice::GetUniformBufferOffsetAlignment()
+	{
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		return alignment > 0 ? (uint32)alignment : 256;
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// RING BUFFER OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	bool GLRenderDevice::SupportsPersistentMapping()
+	{
+		return GLAD_GL_VERSION_4_4 != 0;
+	}
+
+	bool GLRenderDevice::SupportsMultiDrawIndirect()
+	{
+		return GLAD_GL_VERSION_4_3 != 0;
+	}
+
+	uint32 GLRenderDevice::CreateRingBuffer(uintptr size, void** persistentData)
+	{
+		// Ring buffers live on the copy write target so the array & uniform bindings stay untouched.
+		uint32 buffer;
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+		if (persistentData != nullptr && SupportsPersistentMapping())
+		{
+			// Immutable storage, mapped once for the lifetime of the buffer.
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+			*persistentData = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+
+			if (*persistentData == nullptr)
+				LINA_CORE_ERR("Ring buffer could not be persistently mapped!");
+		}
+		else
+		{
+			// Fallback, orphaned every frame.
+			if (persistentData != nullptr)
+				*persistentData = nullptr;
+
+			glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_DRAW);
+		}
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		return buffer;
+	}
+
+	uint32 GLRenderDevice::ReleaseRingBuffer(uint32 buffer, bool persistent)
+	{
+		if (buffer == 0) return 0;
+
+		if (persistent)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+
+		// Names get recycled, forget vertex arrays sourcing from this buffer so they are re-pointed next time.
+		for (std::map<uint32, VertexArrayData>::iterator it = m_vaoMap.begin(); it != m_vaoMap.end(); ++it)
+		{
+			for (uint32 i = 0; i < it->second.numBuffers; i++)
+			{
+				if (it->second.sourceBuffers[i] == buffer)
+					it->second.sourceBuffers[i] = 0;
+			}
+		}
+
+		if (m_boundUBO == buffer) m_boundUBO = 0;
+		glDeleteBuffers(1, &buffer);
+		return 0;
+	}
+
+	void GLRenderDevice::OrphanRingBuffer(uint32 buffer, uintptr size)
+	{
+		// Hand the old storage to the driver, it will be released once the GPU is done with it.
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	void GLRenderDevice::WriteRingBuffer(uint32 buffer, uintptr offset, const void* data, uintptr dataSize)
+	{
+		// Ranges are never overwritten within a frame, so no synchronization is needed.
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		void* dest = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, dataSize, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+		if (dest != nullptr)
+		{
+			GenericMemory::memcpy(dest, data, dataSize);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		}
+		else
+			glBufferSubData(GL_COPY_WRITE_BUFFER, offset, dataSize, data);
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+
+	void* GLRenderDevice::CreateFence()
+	{
+		return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void GLRenderDevice::WaitFence(void* fence)
+	{
+		if (fence == nullptr) return;
+
+		// Flush on the first wait so the fence is guaranteed to signal.
+		GLsync sync = (GLsync)fence;
+		GLbitfield flags = 0;
+		GLuint64 timeout = 0;
+
+		while (true)
+		{
+			GLenum result = glClientWaitSync(sync, flags, timeout);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+				return;
+
+			flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+			timeout = 1000000;
+		}
+	}
+
+	void GLRenderDevice::ReleaseFence(void* fence)
+	{
+		if (fence != nullptr)
+			glDeleteSync((GLsync)fence);
+	}
+
+	uint32 GLRenderDevice::CreateTimerQuery()
+	{
+		GLuint query;
+		glGenQueries(1, &query);
+		return query;
+	}
+
+	uint32 GLRenderDevice::ReleaseTimerQuery(uint32 query)
+	{
+		if (query != 0)
+			glDeleteQueries(1, &query);
+
+		return 0;
+	}
+
+	void GLRenderDevice::BeginTimerQuery(uint32 query)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, query);
+	}
+
+	void GLRenderDevice::EndTimerQuery()
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	bool GLRenderDevice::GetTimerQueryResult(uint32 query, uint64* elapsedNS)
+	{
+		// Never stalls, results of the frames still in flight are reported as unavailable.
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == 0) return false;
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+		*elapsedNS = elapsed;
+		return true;
+	}
+
 	// ---------------------------------------------------------------------
 	// ---------------------------------------------------------------------
 	// SHADER PROGRAM OPERATIONS
@@ -963,6 +1296,32 @@ namespace LinaEngine::Graphics
 		glBlitFramebuffer(0, 0, readWidth, readHeight, 0, 0, writeWidth, writeHeight, mask, filter);
 	}
 
+	void GLRenderDevice::CopyTextureRegion(uint32 srcTexture, Vector2 srcPos, Vector2 srcSize, uint32 dstTexture, Vector2 dstPos, Vector2 dstSize)
+	{
+		// Blit between two scratch frame buffers, works for any color renderable format.
+		if (m_copyFBOs[0] == 0)
+			glGenFramebuffers(2, m_copyFBOs);
+
+		GLboolean scissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+		if (scissorEnabled)
+			glDisable(GL_SCISSOR_TEST);
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_copyFBOs[0]);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, srcTexture, 0);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_copyFBOs[1]);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, dstTexture, 0);
+
+		GLint sx = (GLint)srcPos.x, sy = (GLint)srcPos.y, dx = (GLint)dstPos.x, dy = (GLint)dstPos.y;
+		glBlitFramebuffer(sx, sy, sx + (GLint)srcSize.x, sy + (GLint)srcSize.y, dx, dy, dx + (GLint)dstSize.x, dy + (GLint)dstSize.y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+		// Restore the cached binding.
+		glBindFramebuffer(GL_FRAMEBUFFER, m_boundFBO);
+		m_boundReadFBO = m_boundWriteFBO = m_boundFBO;
+
+		if (scissorEnabled)
+			glEnable(GL_SCISSOR_TEST);
+	}
+
 	bool GLRenderDevice::IsRenderTargetComplete(uint32 fbo)
 	{
 		SetFBO(fbo);
@@ -1005,6 +1364,10 @@ namespace LinaEngine::Graphics
 		SetVAO(vao);
 		glBindBuffer(GL_ARRAY_BUFFER, vaoData->buffers[bufferIndex]);
 
+		// Instance data might have been sourced from a ring buffer, point it back to our own.
+		if (vaoData->sourceBuffers[bufferIndex] != vaoData->buffers[bufferIndex] || vaoData->sourceOffsets[bufferIndex] != 0)
+			SetInstanceAttributes(*vaoData, bufferIndex, vaoData->buffers[bufferIndex], 0);
+
 		// If buffer size exceeds data size use it as subdata.
 		if (vaoData->bufferSizes[bufferIndex] >= dataSize)
 			glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, data);
@@ -1015,6 +1378,65 @@ namespace LinaEngine::Graphics
 		}
 	}
 
+	void GLRenderDevice::SetVertexArrayInstanceBuffer(uint32 vao, uint32 bufferIndex, uint32 buffer, uintptr offset)
+	{
+		if (vao == 0)  return;
+		std::map<uint32, VertexArrayData>::iterator it = m_vaoMap.find(vao);
+		if (it == m_vaoMap.end()) return;
+
+		// Only instance components can be sourced from outside buffers.
+		const VertexArrayData* vaoData = &it->second;
+		if (bufferIndex < vaoData->instanceComponentsStartIndex || bufferIndex >= vaoData->numBuffers - 1) return;
+
+		// Skip if the attributes already point to the same range.
+		if (vaoData->sourceBuffers[bufferIndex] == buffer && vaoData->sourceOffsets[bufferIndex] == offset) return;
+
+		SetVAO(vao);
+		SetInstanceAttributes(*vaoData, bufferIndex, buffer, offset);
+	}
+
+	void GLRenderDevice::UpdateVertexArrayRange(uint32 vao, const float** vertexData, uint32 firstVertex, uint32 numVertices, const uint32* indices, uint32 firstIndex, uint32 numIndices)
+	{
+		if (vao == 0)  return;
+		std::map<uint32, VertexArrayData>::iterator it = m_vaoMap.find(vao);
+		if (it == m_vaoMap.end()) return;
+
+		const VertexArrayData* vaoData = &it->second;
+		const uint32 numVertexComponents = vaoData->instanceComponentsStartIndex;
+		if (numVertexComponents == 0) return;
+
+		// Pack the vertices with the layout of the array.
+		std::vector<uint32> componentOffsets(numVertexComponents);
+		uint32 vertexStride = GetInterleavedVertexLayout(vaoData->elementSizes, vaoData->elementTypes, numVertexComponents, componentOffsets.data());
+		std::vector<uint8> interleavedData(vertexStride * numVertices);
+		InterleaveVertices(vertexData, vaoData->elementSizes, vaoData->elementTypes, numVertexComponents, componentOffsets.data(), vertexStride, numVertices, interleavedData.data());
+
+		// Write the range, the element array buffer is part of the vertex array state.
+		SetVAO(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, vaoData->buffers[0]);
+		glBufferSubData(GL_ARRAY_BUFFER, (uintptr)firstVertex * vertexStride, interleavedData.size(), interleavedData.data());
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (uintptr)firstIndex * sizeof(uint32), (uintptr)numIndices * sizeof(uint32), indices);
+	}
+
+	void GLRenderDevice::SetSpriteBatchVertexSource(uint32 vao, uint32 buffer, uintptr offset)
+	{
+		// Point the sprite vertex layout to the streamed range.
+		SetVAO(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (const GLvoid*)(offset + offsetof(SpriteVertex, m_position)));
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (const GLvoid*)(offset + offsetof(SpriteVertex, m_uv)));
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex), (const GLvoid*)(offset + offsetof(SpriteVertex, m_color)));
+	}
+
+	void GLRenderDevice::SetLineVertexSource(uint32 vao, uint32 buffer, uintptr offset)
+	{
+		// Point the debug line layout to the streamed range.
+		SetVAO(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex), (const GLvoid*)(offset + offsetof(LineVertex, m_position)));
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(LineVertex), (const GLvoid*)(offset + offsetof(LineVertex, m_color)));
+	}
+
 	// ---------------------------------------------------------------------
 	// ---------------------------------------------------------------------
 	// SHADER OPERATIONS
@@ -1049,8 +1471,16 @@ namespace LinaEngine::Graphics
 
 	void GLRenderDevice::BindUniformBuffer(uint32 bufferObject, uint32 point)
 	{
-		// Bind the buffer object to the point.
+		// Bind the buffer object to the point, this also changes the generic binding.
 		glBindBufferBase(GL_UNIFORM_BUFFER, point, bufferObject);
+		m_boundUBO = bufferObject;
+	}
+
+	void GLRenderDevice::BindUniformBufferRange(uint32 bufferObject, uint32 point, uintptr offset, uintptr dataSize)
+	{
+		// Bind a range of the buffer object to the point, offset needs to respect the alignment.
+		glBindBufferRange(GL_UNIFORM_BUFFER, point, bufferObject, offset, dataSize);
+		m_boundUBO = bufferObject;
 	}
 
 	void GLRenderDevice::BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName)
@@ -1087,6 +1517,10 @@ namespace LinaEngine::Graphics
 		// Use VAO & bind buffer.
 		glBindBuffer(GL_ARRAY_BUFFER, vaoData->buffers[bufferIndex]);
 
+		// Instance data might have been sourced from a ring buffer, point it back to our own.
+		if (vaoData->sourceBuffers[bufferIndex] != vaoData->buffers[bufferIndex] || vaoData->sourceOffsets[bufferIndex] != 0)
+			SetInstanceAttributes(*vaoData, bufferIndex, vaoData->buffers[bufferIndex], 0);
+
 		// If buffer size exceeds data size use it as subdata.
 		if (vaoData->bufferSizes[bufferIndex] >= dataSize)
 			glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, data);
@@ -1239,47 +1673,52 @@ namespace LinaEngine::Graphics
 
 	}
 
-	void GLRenderDevice::DrawLine(float width)
+	void GLRenderDevice::DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex)
 	{
-		// This function requires you to set model matrix in the debuglines shader.
-		glLineWidth(width);
-		glDrawArrays(GL_LINES, 0, 2);
+		if (numElements == 0) return;
+
+		if (!drawParams.skipParameters)
+			SetDrawParameters(drawParams);
+
+		SetVAO(vao);
+		glDrawElementsBaseVertex(drawParams.primitiveType, (GLsizei)numElements, GL_UNSIGNED_INT, 0, (GLint)baseVertex);
 	}
 
-	void GLRenderDevice::DrawLine(uint32 shader, const Matrix& model, const Vector3& from, const Vector3& to, float width)
+	void GLRenderDevice::DrawInstancedBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, uint32 firstIndex, uint32 baseVertex)
 	{
-		// Set line width.
-		glLineWidth(width);
+		if (numInstances == 0 || numElements == 0) return;
 
-		// Lines
-		btLine lines(from, to);
-		Vector3 result = to - from;
-		GLuint vao, vbo;
+		if (!drawParams.skipParameters)
+			SetDrawParameters(drawParams);
 
-		// Buffers
-		glGenVertexArrays(1, &vao);
-		glGenBuffers(1, &vbo);
-		glBindVertexArray(vao);
+		SetVAO(vao);
+		glDrawElementsInstancedBaseVertex(drawParams.primitiveType, (GLsizei)numElements, GL_UNSIGNED_INT, (const GLvoid*)((uintptr)firstIndex * sizeof(uint32)), numInstances, (GLint)baseVertex);
+	}
 
-		//UPLOADING VERTEX
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER,
-			sizeof(GLfloat) * 6, lines.vertices, GL_STATIC_DRAW);
+	void GLRenderDevice::MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, uint32 indirectBuffer, uintptr offset, uint32 drawCount)
+	{
+		if (drawCount == 0) return;
 
-		// Enable position.
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-			sizeof(GLfloat) * 3, (GLvoid*)0);
-		glBindVertexArray(0);
+		if (!drawParams.skipParameters)
+			SetDrawParameters(drawParams);
 
-		// Draw
-		glBindVertexArray(vao);
-		glDrawArrays(GL_LINES, 0, 2);
-		glBindVertexArray(0);
+		// Commands are tightly packed DrawElementsIndirectCommand structs.
+		SetVAO(vao);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+		glMultiDrawElementsIndirect(drawParams.primitiveType, GL_UNSIGNED_INT, (const GLvoid*)offset, drawCount, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
 
-		//delete buffers
-		glDeleteVertexArrays(1, &vao);
-		glDeleteBuffers(1, &vbo);
+	void GLRenderDevice::DrawLines(uint32 vao, const DrawParams& drawParams, uint32 firstVertex, uint32 numVertices, float width)
+	{
+		if (numVertices == 0) return;
+
+		if (!drawParams.skipParameters)
+			SetDrawParameters(drawParams);
+
+		SetVAO(vao);
+		glLineWidth(width);
+		glDrawArrays(GL_LINES, (GLint)firstVertex, (GLsizei)numVertices);
 	}
 
 	void GLRenderDevice::Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const Color& color, uint32 stencil)
@@ -1317,6 +1756,16 @@ namespace LinaEngine::Graphics
 		glUniform1f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)f);
 	}
 
+	bool GLRenderDevice::HasShaderUniform(uint32 shader, const std::string& uniform)
+	{
+		// Unknown names would otherwise resolve to location 0 through the map. Called while recording on workers, so lookups only.
+		std::map<uint32, ShaderProgram>::const_iterator it = m_shaderProgramMap.find(shader);
+		if (it == m_shaderProgramMap.end()) return false;
+
+		const std::map<std::string, int32>& uniformMap = it->second.uniformMap;
+		return uniformMap.find(uniform) != uniformMap.end();
+	}
+
 	void GLRenderDevice::UpdateShaderUniformInt(uint32 shader, const std::string& uniform, const int f)
 	{
 		glUniform1i(m_shaderProgramMap[shader].uniformMap[uniform], (GLint)f);
@@ -1517,6 +1966,33 @@ namespace LinaEngine::Graphics
 
 	}
 
+	void GLRenderDevice::SetInstanceAttributes(const VertexArrayData& vaoData, uint32 bufferIndex, uint32 buffer, uintptr offset)
+	{
+		// Expects the VAO to be bound, re-specifies the attribute pointers of the component with the new source.
+		uint32 elementSize = vaoData.elementSizes[bufferIndex];
+		uint32 elementType = vaoData.elementTypes[bufferIndex];
+		uint32 attribute = vaoData.attributeStarts[bufferIndex];
+		uint32 elementSizeDiv = elementSize / 4;
+		uint32 elementSizeRem = elementSize % 4;
+		GLsizei stride = elementSize * sizeof(GLfloat);
+
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+		for (uint32 j = 0; j < elementSizeDiv + (elementSizeRem != 0 ? 1 : 0); j++, attribute++)
+		{
+			GLint count = j < elementSizeDiv ? 4 : elementSizeRem;
+			const GLvoid* pointer = (const GLvoid*)(offset + sizeof(GLfloat) * j * 4);
+
+			if (elementType != 0)
+				glVertexAttribPointer(attribute, count, GL_FLOAT, GL_FALSE, stride, pointer);
+			else
+				glVertexAttribIPointer(attribute, count, GL_INT, stride, pointer);
+		}
+
+		vaoData.sourceBuffers[bufferIndex] = buffer;
+		vaoData.sourceOffsets[bufferIndex] = offset;
+	}
+
 	void GLRenderDevice::SetScissorTest(bool enable, uint32 startX, uint32 startY, uint32 width, uint32 height)
 	{
 		// Disable if enabled.
@@ -1606,6 +2082,9 @@ namespace LinaEngine::Graphics
 		case PixelFormat::FORMAT_SRGBA: return GL_RGBA;
 		case PixelFormat::FORMAT_RGBA16F: return GL_RGBA;
 		case PixelFormat::FORMAT_RGB16F: return GL_RGBA;
+		case PixelFormat::FORMAT_R32UI: return GL_RED_INTEGER;
+		case PixelFormat::FORMAT_RG32UI: return GL_RG_INTEGER;
+		case PixelFormat::FORMAT_RGBA32F: return GL_RGBA;
 		default:
 			LINA_CORE_ERR("PixelFormat {0} is not a valid PixelFormat.", format);
 			return 0;
@@ -1633,6 +2112,9 @@ namespace LinaEngine::Graphics
 		case PixelFormat::FORMAT_SRGBA: return GL_SRGB_ALPHA;
 		case PixelFormat::FORMAT_RGBA16F: return GL_RGBA16F;
 		case PixelFormat::FORMAT_RGB16F: return GL_RGB16F;
+		case PixelFormat::FORMAT_R32UI: return GL_R32UI;
+		case PixelFormat::FORMAT_RG32UI: return GL_RG32UI;
+		case PixelFormat::FORMAT_RGBA32F: return GL_RGBA32F;
 		default:
 			LINA_CORE_ERR("PixelFormat {0} is not a valid PixelFormat.", format);
 			return 0;
@@ -1795,5 +2277,51 @@ namespace LinaEngine::Graphics
 
 		}
 	}
-}
 
+	static uint32 GetVertexElementByteSize(uint32 elementType)
+	{
+		return elementType == VertexElementType::ELEMENT_UNORM16 || elementType == VertexElementType::ELEMENT_SNORM16 || elementType == VertexElementType::ELEMENT_HALF ? 2 : 4;
+	}
+
+	static void PackVertexElement(uint32 elementType, const float* source, uint32 count, uint8* destination)
+	{
+		// Floats & ints are copied as they are, the rest is converted from the float data.
+		if (GetVertexElementByteSize(elementType) == 4)
+		{
+			GenericMemory::memcpy(destination, source, count * sizeof(float));
+			return;
+		}
+
+		uint16* packed = (uint16*)destination;
+		for (uint32 i = 0; i < count; i++)
+		{
+			if (elementType == VertexElementType::ELEMENT_UNORM16)
+				packed[i] = glm::packUnorm1x16(source[i]);
+			else if (elementType == VertexElementType::ELEMENT_SNORM16)
+				packed[i] = glm::packSnorm1x16(source[i]);
+			else
+				packed[i] = glm::packHalf1x16(source[i]);
+		}
+	}
+
+	static uint32 GetInterleavedVertexLayout(const uint32* elementSizes, const uint32* elementTypes, uint32 numVertexComponents, uint32* componentOffsets)
+	{
+		uint32 vertexStride = 0;
+		for (uint32 i = 0; i < numVertexComponents; i++)
+		{
+			componentOffsets[i] = vertexStride;
+			vertexStride += (elementSizes[i] * GetVertexElementByteSize(elementTypes[i]) + 3) & ~3u;
+		}
+
+		return vertexStride;
+	}
+
+	static void InterleaveVertices(const float** vertexData, const uint32* elementSizes, const uint32* elementTypes, uint32 numVertexComponents, const uint32* componentOffsets, uint32 vertexStride, uint32 numVertices, uint8* destination)
+	{
+		for (uint32 i = 0; i < numVertexComponents; i++)
+		{
+			for (uint32 v = 0; v < numVertices; v++)
+				PackVertexElement(elementTypes[i], &vertexData[i][v * elementSizes[i]], elementSizes[i], &destination[v * vertexStride + componentOffsets[i]]);
+		}
+	}
+}
@@ -0,0 +1,202 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/DebugRenderer.hpp"
+#include "Rendering/RingBuffer.hpp"
+#include "Utility/Math/Math.hpp"
+
+namespace LinaEngine::Graphics
+{
+	static uint32 PackColor(const Color& color)
+	{
+		return (uint32)(Math::Clamp(color.r, 0.0f, 1.0f) * 255.0f) | (uint32)(Math::Clamp(color.g, 0.0f, 1.0f) * 255.0f) << 8 | (uint32)(Math::Clamp(color.b, 0.0f, 1.0f) * 255.0f) << 16 | (uint32)(Math::Clamp(color.a, 0.0f, 1.0f) * 255.0f) << 24;
+	}
+
+	static void AddLine(std::vector<LineVertex>& vertices, const Vector3& from, const Vector3& to, uint32 color)
+	{
+		vertices.push_back({ { from.x, from.y, from.z }, color });
+		vertices.push_back({ { to.x, to.y, to.z }, color });
+	}
+
+	DebugRenderer::~DebugRenderer()
+	{
+		if (s_renderDevice != nullptr)
+		{
+			m_vertexArray = s_renderDevice->ReleaseVertexArray(m_vertexArray, false);
+			m_streamBuffer = s_renderDevice->ReleaseRingBuffer(m_streamBuffer, false);
+		}
+	}
+
+	void DebugRenderer::Construct(RenderDevice& renderDeviceIn, RingBuffer& ringBufferIn, uint32 shader)
+	{
+		s_renderDevice = &renderDeviceIn;
+		m_ringBuffer = &ringBufferIn;
+		m_shaderID = shader;
+		m_vertexArray = s_renderDevice->CreateLineVertexArray();
+		m_streamBufferSize = 4096 * sizeof(LineVertex);
+		m_streamBuffer = s_renderDevice->CreateRingBuffer(m_streamBufferSize, nullptr);
+	}
+
+	void DebugRenderer::DrawLine(const Vector3& from, const Vector3& to, const Color& color, float width, bool depthTest)
+	{
+		uint32 packedColor = PackColor(color);
+		LineVertex vertices[2] = { { { from.x, from.y, from.z }, packedColor }, { { to.x, to.y, to.z }, packedColor } };
+		DrawLines(vertices, 2, width, depthTest);
+	}
+
+	void DebugRenderer::DrawBox(const Vector3& center, const Vector3& halfExtents, const Color& color, float width, bool depthTest)
+	{
+		uint32 packedColor = PackColor(color);
+		Vector3 corners[8];
+		for (int i = 0; i < 8; i++)
+		{
+			corners[i].x = center.x + ((i & 1) ? halfExtents.x : -halfExtents.x);
+			corners[i].y = center.y + ((i & 2) ? halfExtents.y : -halfExtents.y);
+			corners[i].z = center.z + ((i & 4) ? halfExtents.z : -halfExtents.z);
+		}
+
+		// 12 edges, each connects corners differing in a single axis bit.
+		std::vector<LineVertex> vertices;
+		vertices.reserve(24);
+		for (int i = 0; i < 8; i++)
+		{
+			for (int axis = 1; axis < 8; axis <<= 1)
+			{
+				if ((i & axis) == 0)
+					AddLine(vertices, corners[i], corners[i | axis], packedColor);
+			}
+		}
+
+		DrawLines(&vertices[0], (uint32)vertices.size(), width, depthTest);
+	}
+
+	void DebugRenderer::DrawSphere(const Vector3& center, float radius, const Color& color, float width, bool depthTest)
+	{
+		uint32 packedColor = PackColor(color);
+		std::vector<LineVertex> vertices;
+		vertices.reserve(DEBUGRENDERER_CIRCLE_SEGMENTS * 6);
+
+		// One circle on each axis plane.
+		const float step = 2.0f * 3.14159265f / (float)DEBUGRENDERER_CIRCLE_SEGMENTS;
+		for (int i = 0; i < DEBUGRENDERER_CIRCLE_SEGMENTS; i++)
+		{
+			float c0 = std::cos(step * i) * radius, s0 = std::sin(step * i) * radius;
+			float c1 = std::cos(step * (i + 1)) * radius, s1 = std::sin(step * (i + 1)) * radius;
+			AddLine(vertices, center + Vector3(c0, s0, 0.0f), center + Vector3(c1, s1, 0.0f), packedColor);
+			AddLine(vertices, center + Vector3(c0, 0.0f, s0), center + Vector3(c1, 0.0f, s1), packedColor);
+			AddLine(vertices, center + Vector3(0.0f, c0, s0), center + Vector3(0.0f, c1, s1), packedColor);
+		}
+
+		DrawLines(&vertices[0], (uint32)vertices.size(), width, depthTest);
+	}
+
+	void DebugRenderer::DrawMarker(const Vector3& position, float size, const Color& color, float width, bool depthTest)
+	{
+		// Axis cross, marks world positions such as text anchors & contact points.
+		uint32 packedColor = PackColor(color);
+		float half = size * 0.5f;
+		LineVertex vertices[6];
+		vertices[0] = { { position.x - half, position.y, position.z }, packedColor };
+		vertices[1] = { { position.x + half, position.y, position.z }, packedColor };
+		vertices[2] = { { position.x, position.y - half, position.z }, packedColor };
+		vertices[3] = { { position.x, position.y + half, position.z }, packedColor };
+		vertices[4] = { { position.x, position.y, position.z - half }, packedColor };
+		vertices[5] = { { position.x, position.y, position.z + half }, packedColor };
+		DrawLines(vertices, 6, width, depthTest);
+	}
+
+	void DebugRenderer::DrawLines(const LineVertex* vertices, uint32 vertexCount, float width, bool depthTest)
+	{
+		// Vertices are built outside, the lock only covers the append.
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_pendingVertexCount + vertexCount > DEBUGRENDERER_MAX_VERTICES) return;
+
+		DebugLineBatch& batch = GetBatch(width, depthTest);
+		batch.m_vertices.insert(batch.m_vertices.end(), vertices, vertices + (vertexCount & ~1u));
+		m_pendingVertexCount += vertexCount & ~1u;
+	}
+
+	DebugLineBatch& DebugRenderer::GetBatch(float width, bool depthTest)
+	{
+		// Only a few width & depth combinations are ever used, linear search is enough.
+		for (DebugLineBatch& batch : m_batches)
+		{
+			if (batch.m_width == width && batch.m_depthTest == depthTest)
+				return batch;
+		}
+
+		DebugLineBatch& batch = m_batches.emplace_back();
+		batch.m_width = width;
+		batch.m_depthTest = depthTest;
+		return batch;
+	}
+
+	void DebugRenderer::Flush(const DrawParams& drawParams)
+	{
+		// Take the batches, other threads can keep submitting for the next flush.
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_batches.swap(m_flushBatches);
+			m_pendingVertexCount = 0;
+		}
+
+		m_lastVertexCount = 0;
+		m_lastDrawCount = 0;
+
+		for (DebugLineBatch& batch : m_flushBatches)
+		{
+			if (batch.m_vertices.empty()) continue;
+
+			const uintptr dataSize = batch.m_vertices.size() * sizeof(LineVertex);
+			uintptr offset = m_ringBuffer->Write(&batch.m_vertices[0], dataSize);
+
+			if (offset != RINGBUFFER_INVALID_OFFSET)
+				s_renderDevice->SetLineVertexSource(m_vertexArray, m_ringBuffer->GetID(), offset);
+			else
+			{
+				// Ring is full this frame, orphan & refill our own stream buffer.
+				m_streamBufferSize = std::max(m_streamBufferSize, dataSize);
+				s_renderDevice->OrphanRingBuffer(m_streamBuffer, m_streamBufferSize);
+				s_renderDevice->WriteRingBuffer(m_streamBuffer, 0, &batch.m_vertices[0], dataSize);
+				s_renderDevice->SetLineVertexSource(m_vertexArray, m_streamBuffer, 0);
+			}
+
+			DrawParams params = drawParams;
+			params.useDepthTest = batch.m_depthTest;
+
+			s_renderDevice->SetShader(m_shaderID);
+			s_renderDevice->DrawLines(m_vertexArray, params, 0, (uint32)batch.m_vertices.size(), batch.m_width);
+
+			m_lastVertexCount += (uint32)batch.m_vertices.size();
+			m_lastDrawCount++;
+
+			// Keep the capacity for the next frames.
+			batch.m_vertices.clear();
+		}
+	}
+}
@@ -0,0 +1,187 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/DynamicResolution.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Fraction of the budget the GPU aims for, leaves room for the spikes the filtering hides.
+#define DYNAMICRESOLUTION_HEADROOM 0.9f
+#define DYNAMICRESOLUTION_SMOOTHING 0.1f
+#define DYNAMICRESOLUTION_DROP_RATE 0.25f
+#define DYNAMICRESOLUTION_RISE_RATE 0.05f
+#define DYNAMICRESOLUTION_DEADBAND 0.02f
+#define DYNAMICRESOLUTION_SCALE_LIMIT 0.1f
+
+namespace LinaEngine::Graphics
+{
+	// GLOBALS DECLARATIONS
+	static float FilterTime(float filtered, float sample, bool hasFiltered);
+
+	DynamicResolution::~DynamicResolution()
+	{
+		if (s_renderDevice == nullptr) return;
+
+		for (uint32 i = 0; i < DYNAMICRESOLUTION_QUERY_COUNT; i++)
+			m_queries[i] = s_renderDevice->ReleaseTimerQuery(m_queries[i]);
+	}
+
+	void DynamicResolution::Construct(RenderDevice& renderDeviceIn)
+	{
+		s_renderDevice = &renderDeviceIn;
+
+		for (uint32 i = 0; i < DYNAMICRESOLUTION_QUERY_COUNT; i++)
+			m_queries[i] = s_renderDevice->CreateTimerQuery();
+	}
+
+	void DynamicResolution::BeginFrame()
+	{
+		m_frameStart = std::chrono::steady_clock::now();
+		m_frameStarted = true;
+	}
+
+	void DynamicResolution::BeginGPUTimer()
+	{
+		if (s_renderDevice == nullptr || m_gpuTimerActive) return;
+
+		// The oldest query is reused, skip timing this frame if the GPU is still behind on it.
+		if (m_queryPending[m_queryIndex])
+			ReadQueries();
+
+		if (m_queryPending[m_queryIndex]) return;
+
+		s_renderDevice->BeginTimerQuery(m_queries[m_queryIndex]);
+		m_queryScales[m_queryIndex] = m_stats.m_scale;
+		m_gpuTimerActive = true;
+	}
+
+	void DynamicResolution::EndFrame()
+	{
+		if (m_gpuTimerActive)
+		{
+			s_renderDevice->EndTimerQuery();
+			m_queryPending[m_queryIndex] = true;
+			m_queryIndex = (m_queryIndex + 1) % DYNAMICRESOLUTION_QUERY_COUNT;
+			m_gpuTimerActive = false;
+		}
+
+		ReadQueries();
+
+		if (m_frameStarted)
+		{
+			const float cpuTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_frameStart).count();
+			m_stats.m_cpuTimeMS = FilterTime(m_stats.m_cpuTimeMS, cpuTime, m_hasCPUTime);
+			m_hasCPUTime = true;
+			m_frameStarted = false;
+		}
+
+		UpdateScale();
+	}
+
+	void DynamicResolution::SetEnabled(bool enabled)
+	{
+		m_enabled = enabled;
+
+		if (!m_enabled)
+			m_stats.m_scale = 1.0f;
+		else
+			m_stats.m_scale = std::clamp(m_stats.m_scale, m_minScale, m_maxScale);
+	}
+
+	void DynamicResolution::SetBudget(float budgetMS)
+	{
+		m_stats.m_budgetMS = std::max(budgetMS, 0.1f);
+	}
+
+	void DynamicResolution::SetScaleBounds(float minScale, float maxScale)
+	{
+		// The pooled targets are allocated at full size, the scale can only shrink the rendered region.
+		m_maxScale = std::clamp(maxScale, DYNAMICRESOLUTION_SCALE_LIMIT, 1.0f);
+		m_minScale = std::clamp(minScale, DYNAMICRESOLUTION_SCALE_LIMIT, m_maxScale);
+
+		if (m_enabled)
+			m_stats.m_scale = std::clamp(m_stats.m_scale, m_minScale, m_maxScale);
+	}
+
+	void DynamicResolution::ReadQueries()
+	{
+		// Oldest first, so the last sample read is the most recent frame.
+		for (uint32 i = 0; i < DYNAMICRESOLUTION_QUERY_COUNT; i++)
+		{
+			const uint32 index = (m_queryIndex + i) % DYNAMICRESOLUTION_QUERY_COUNT;
+			if (!m_queryPending[index]) continue;
+
+			uint64 elapsed = 0;
+			if (!s_renderDevice->GetTimerQueryResult(m_queries[index], &elapsed))
+				break;
+
+			m_stats.m_gpuTimeMS = FilterTime(m_stats.m_gpuTimeMS, (float)((double)elapsed / 1000000.0), m_stats.m_hasGPUTime);
+			m_stats.m_hasGPUTime = true;
+			m_sampleScale = m_queryScales[index];
+			m_queryPending[index] = false;
+		}
+	}
+
+	void DynamicResolution::UpdateScale()
+	{
+		const float target = m_stats.m_budgetMS * DYNAMICRESOLUTION_HEADROOM;
+		m_stats.m_headroomMS = m_stats.m_budgetMS - std::max(m_stats.m_cpuTimeMS, m_stats.m_gpuTimeMS);
+		m_stats.m_isCPUBound = m_hasCPUTime && m_stats.m_cpuTimeMS > target && m_stats.m_cpuTimeMS > m_stats.m_gpuTimeMS;
+
+		// Without a GPU time there is nothing to predict from, the scale is kept.
+		if (!m_stats.m_hasGPUTime)
+		{
+			m_stats.m_targetScale = m_stats.m_scale;
+			return;
+		}
+
+		// GPU time is assumed to scale with the pixel count, predicted from the scale the sample was rendered at.
+		float desired = m_sampleScale * std::sqrt(target / std::max(m_stats.m_gpuTimeMS, 0.01f));
+		desired = std::clamp(desired, m_minScale, m_maxScale);
+
+		// Lowering the resolution doesn't shorten frames the CPU is holding back.
+		if (m_stats.m_isCPUBound && desired < m_stats.m_scale)
+			desired = m_stats.m_scale;
+
+		m_stats.m_targetScale = desired;
+
+		if (!m_enabled) return;
+
+		const float difference = desired - m_stats.m_scale;
+		if (std::abs(difference) < DYNAMICRESOLUTION_DEADBAND) return;
+
+		const float rate = difference < 0.0f ? DYNAMICRESOLUTION_DROP_RATE : DYNAMICRESOLUTION_RISE_RATE;
+		m_stats.m_scale = std::clamp(m_stats.m_scale + difference * rate, m_minScale, m_maxScale);
+	}
+
+	float FilterTime(float filtered, float sample, bool hasFiltered)
+	{
+		// Exponential moving average, the first sample seeds it.
+		return hasFiltered ? filtered + (sample - filtered) * DYNAMICRESOLUTION_SMOOTHING : sample;
+	}
+}
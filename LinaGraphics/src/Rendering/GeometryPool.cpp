@@ -0,0 +1,207 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/GeometryPool.hpp"
+#include "Rendering/IndexedModel.hpp"
+
+namespace LinaEngine::Graphics
+{
+#define GEOMETRYPOOL_PAGE_VERTICES (1 << 18)
+#define GEOMETRYPOOL_PAGE_INDICES (1 << 20)
+
+	void GeometryPool::Construct(RenderDevice& renderDeviceIn)
+	{
+		s_renderDevice = &renderDeviceIn;
+		m_isConstructed = true;
+	}
+
+	void GeometryPool::Release()
+	{
+		if (!m_isConstructed) return;
+
+		for (Page& page : m_pages)
+			page.m_vertexArray = s_renderDevice->ReleaseVertexArray(page.m_vertexArray);
+
+		m_pages.clear();
+		m_statistics = Statistics();
+		m_isConstructed = false;
+	}
+
+	bool GeometryPool::Allocate(const IndexedModel& model, GeometryAllocation& allocation)
+	{
+		const uint32 vertexCount = model.GetVertexCount();
+		const uint32 indexCount = model.GetIndexCount();
+		if (!m_isConstructed || vertexCount == 0 || indexCount == 0) return false;
+		if (vertexCount > GEOMETRYPOOL_PAGE_VERTICES || indexCount > GEOMETRYPOOL_PAGE_INDICES) return false;
+
+		// First page with the same layout that has room for both ranges.
+		const std::vector<uint32> layout = GetLayout(model);
+		uint32 pageIndex = (uint32)m_pages.size();
+		uint32 firstVertex = 0;
+		uint32 firstIndex = 0;
+
+		for (uint32 i = 0; i < (uint32)m_pages.size(); i++)
+		{
+			Page& page = m_pages[i];
+			if (page.m_layout != layout || !AllocateRange(page.m_freeVertices, vertexCount, firstVertex)) continue;
+
+			if (AllocateRange(page.m_freeIndices, indexCount, firstIndex))
+			{
+				pageIndex = i;
+				break;
+			}
+
+			ReleaseRange(page.m_freeVertices, firstVertex, vertexCount);
+		}
+
+		if (pageIndex == (uint32)m_pages.size())
+		{
+			pageIndex = CreatePage(model, layout);
+			AllocateRange(m_pages[pageIndex].m_freeVertices, vertexCount, firstVertex);
+			AllocateRange(m_pages[pageIndex].m_freeIndices, indexCount, firstIndex);
+		}
+
+		// Upload the ranges, indices stay relative to the model & are offset by the base vertex when drawn.
+		std::vector<const float*> vertexData;
+		for (uint32 i = 0; i < model.GetVertexElementCount(); i++)
+			vertexData.push_back(model.GetElements()[i].data());
+
+		s_renderDevice->UpdateVertexArrayRange(m_pages[pageIndex].m_vertexArray, vertexData.data(), firstVertex, vertexCount, model.GetIndices().data(), firstIndex, indexCount);
+
+		allocation.m_page = pageIndex;
+		allocation.m_vertexArray = m_pages[pageIndex].m_vertexArray;
+		allocation.m_firstVertex = firstVertex;
+		allocation.m_vertexCount = vertexCount;
+		allocation.m_firstIndex = firstIndex;
+		allocation.m_indexCount = indexCount;
+
+		m_statistics.m_allocationCount++;
+		m_statistics.m_usedVertices += vertexCount;
+		m_statistics.m_usedIndices += indexCount;
+		return true;
+	}
+
+	void GeometryPool::Free(const GeometryAllocation& allocation)
+	{
+		if (!m_isConstructed || allocation.m_page >= (uint32)m_pages.size()) return;
+
+		Page& page = m_pages[allocation.m_page];
+		if (page.m_vertexArray != allocation.m_vertexArray) return;
+
+		ReleaseRange(page.m_freeVertices, allocation.m_firstVertex, allocation.m_vertexCount);
+		ReleaseRange(page.m_freeIndices, allocation.m_firstIndex, allocation.m_indexCount);
+
+		m_statistics.m_allocationCount--;
+		m_statistics.m_usedVertices -= allocation.m_vertexCount;
+		m_statistics.m_usedIndices -= allocation.m_indexCount;
+	}
+
+	std::vector<uint32> GeometryPool::GetLayout(const IndexedModel& model)
+	{
+		// Vertex element count followed by the size & type of each element, instanced ones included.
+		std::vector<uint32> layout;
+		layout.push_back(model.GetVertexElementCount());
+		layout.insert(layout.end(), model.GetElementSizes().begin(), model.GetElementSizes().end());
+		layout.insert(layout.end(), model.GetElementTypes().begin(), model.GetElementTypes().end());
+		return layout;
+	}
+
+	bool GeometryPool::AllocateRange(std::vector<FreeRange>& freeRanges, uint32 size, uint32& offset)
+	{
+		// First fit, ranges are kept sorted by offset.
+		for (size_t i = 0; i < freeRanges.size(); i++)
+		{
+			FreeRange& range = freeRanges[i];
+			if (range.m_size < size) continue;
+
+			offset = range.m_offset;
+			range.m_offset += size;
+			range.m_size -= size;
+
+			if (range.m_size == 0)
+				freeRanges.erase(freeRanges.begin() + i);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void GeometryPool::ReleaseRange(std::vector<FreeRange>& freeRanges, uint32 offset, uint32 size)
+	{
+		// Insert in offset order & merge with the neighbours.
+		size_t index = 0;
+		while (index < freeRanges.size() && freeRanges[index].m_offset < offset)
+			index++;
+
+		const bool mergePrevious = index > 0 && freeRanges[index - 1].m_offset + freeRanges[index - 1].m_size == offset;
+		const bool mergeNext = index < freeRanges.size() && offset + size == freeRanges[index].m_offset;
+
+		if (mergePrevious && mergeNext)
+		{
+			freeRanges[index - 1].m_size += size + freeRanges[index].m_size;
+			freeRanges.erase(freeRanges.begin() + index);
+		}
+		else if (mergePrevious)
+			freeRanges[index - 1].m_size += size;
+		else if (mergeNext)
+		{
+			freeRanges[index].m_offset = offset;
+			freeRanges[index].m_size += size;
+		}
+		else
+		{
+			FreeRange range;
+			range.m_offset = offset;
+			range.m_size = size;
+			freeRanges.insert(freeRanges.begin() + index, range);
+		}
+	}
+
+	uint32 GeometryPool::CreatePage(const IndexedModel& model, const std::vector<uint32>& layout)
+	{
+		const uint32 numVertexComponents = model.GetVertexElementCount();
+		const uint32 numInstanceComponents = (uint32)model.GetElementSizes().size() - numVertexComponents;
+
+		// Storage only, ranges are filled as meshes are placed.
+		Page& page = m_pages.emplace_back();
+		page.m_layout = layout;
+		page.m_vertexArray = s_renderDevice->CreateVertexArray(nullptr, model.GetElementSizes().data(), model.GetElementTypes().data(), numVertexComponents, numInstanceComponents, GEOMETRYPOOL_PAGE_VERTICES, nullptr, GEOMETRYPOOL_PAGE_INDICES, BufferUsage::USAGE_STATIC_DRAW);
+
+		FreeRange vertices;
+		vertices.m_size = GEOMETRYPOOL_PAGE_VERTICES;
+		page.m_freeVertices.push_back(vertices);
+
+		FreeRange indices;
+		indices.m_size = GEOMETRYPOOL_PAGE_INDICES;
+		page.m_freeIndices.push_back(indices);
+
+		m_statistics.m_pageCount++;
+		return (uint32)m_pages.size() - 1;
+	}
+}
@@ -0,0 +1,348 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/HDRICache.hpp"
+#include "Utility/Log.hpp"
+#include "glm/gtc/packing.hpp"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#define HDRICACHE_MAGIC 0x5244484C
+#define HDRICACHE_VERSION 1
+#define BRDFLUT_MAGIC 0x4452424C
+#define BRDFLUT_VERSION 1
+#define FNV_OFFSET_BASIS 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+#define IBL_PI 3.14159265359f
+
+namespace LinaEngine::Graphics
+{
+	struct HDRICacheHeader
+	{
+		uint32 m_magic = HDRICACHE_MAGIC;
+		uint32 m_version = HDRICACHE_VERSION;
+		uint64 m_sourceHash = 0;
+		uint32 m_resolution = 0;
+		uint32 m_irradianceResolution = 0;
+		uint32 m_prefilterResolution = 0;
+		uint32 m_prefilterMipCount = 0;
+		uint32 m_hasIrradianceSH = 0;
+		float m_irradianceSH[HDRICACHE_SH_COEFFICIENTS * 3] = { 0.0f };
+	};
+
+	struct BRDFLutHeader
+	{
+		uint32 m_magic = BRDFLUT_MAGIC;
+		uint32 m_version = BRDFLUT_VERSION;
+		uint32 m_resolution = 0;
+		uint32 m_channels = 2;
+	};
+
+	// GLOBALS DECLARATIONS
+	static void CreateParentFolder(const std::string& path);
+	static float RadicalInverse(uint32 bits);
+	static float GeometrySchlickGGX(float NdotV, float roughness);
+
+	uint64 HDRICache::HashFile(const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) return 0;
+
+		uint64 hash = FNV_OFFSET_BASIS;
+		std::vector<char> chunk(64 * 1024);
+
+		while (stream)
+		{
+			stream.read(chunk.data(), chunk.size());
+			const std::streamsize readSize = stream.gcount();
+
+			for (std::streamsize i = 0; i < readSize; i++)
+			{
+				hash ^= (uint8)chunk[i];
+				hash *= FNV_PRIME;
+			}
+		}
+
+		return hash;
+	}
+
+	std::string HDRICache::GetCachePath(uint64 sourceHash, uint32 resolution)
+	{
+		char fileName[64];
+		std::snprintf(fileName, sizeof(fileName), "%016llx_%u", (unsigned long long)sourceHash, resolution);
+		return std::string(HDRICACHE_FOLDERPATH) + "/" + fileName + HDRICACHE_EXTENSION;
+	}
+
+	uint32 HDRICache::GetCubemapDataSize(uint32 resolution, uint32 mipCount)
+	{
+		uint32 size = 0;
+
+		for (uint32 mip = 0; mip < mipCount; mip++)
+		{
+			const uint32 mipResolution = std::max(resolution >> mip, 1u);
+			size += mipResolution * mipResolution * 3 * 6;
+		}
+
+		return size;
+	}
+
+	bool HDRICache::Load(const std::string& path, uint64 sourceHash, uint32 resolution, HDRICacheData& data)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) return false;
+
+		HDRICacheHeader header;
+		stream.read((char*)&header, sizeof(HDRICacheHeader));
+
+		if (!stream || header.m_magic != HDRICACHE_MAGIC || header.m_version != HDRICACHE_VERSION || header.m_sourceHash != sourceHash || header.m_resolution != resolution)
+			return false;
+
+		data.m_sourceHash = header.m_sourceHash;
+		data.m_resolution = header.m_resolution;
+		data.m_irradianceResolution = header.m_irradianceResolution;
+		data.m_prefilterResolution = header.m_prefilterResolution;
+		data.m_prefilterMipCount = header.m_prefilterMipCount;
+		data.m_hasIrradianceSH = header.m_hasIrradianceSH != 0;
+		std::copy(header.m_irradianceSH, header.m_irradianceSH + HDRICACHE_SH_COEFFICIENTS * 3, data.m_irradianceSH);
+
+		// Environment is stored without its mips, they are generated after the upload.
+		data.m_environment.resize(GetCubemapDataSize(data.m_resolution, 1));
+		data.m_irradiance.resize(data.m_irradianceResolution == 0 ? 0 : GetCubemapDataSize(data.m_irradianceResolution, 1));
+		data.m_prefilter.resize(GetCubemapDataSize(data.m_prefilterResolution, data.m_prefilterMipCount));
+
+		stream.read((char*)data.m_environment.data(), data.m_environment.size() * sizeof(uint16));
+		stream.read((char*)data.m_irradiance.data(), data.m_irradiance.size() * sizeof(uint16));
+		stream.read((char*)data.m_prefilter.data(), data.m_prefilter.size() * sizeof(uint16));
+
+		if (!stream)
+		{
+			LINA_CORE_WARN("HDRI cache {0} is truncated, it will be rebuilt.", path);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool HDRICache::Save(const std::string& path, const HDRICacheData& data)
+	{
+		CreateParentFolder(path);
+
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		if (!stream)
+		{
+			LINA_CORE_WARN("HDRI cache {0} couldn't be written.", path);
+			return false;
+		}
+
+		HDRICacheHeader header;
+		header.m_sourceHash = data.m_sourceHash;
+		header.m_resolution = data.m_resolution;
+		header.m_irradianceResolution = data.m_irradiance.empty() ? 0 : data.m_irradianceResolution;
+		header.m_prefilterResolution = data.m_prefilterResolution;
+		header.m_prefilterMipCount = data.m_prefilterMipCount;
+		header.m_hasIrradianceSH = data.m_hasIrradianceSH ? 1 : 0;
+		std::copy(data.m_irradianceSH, data.m_irradianceSH + HDRICACHE_SH_COEFFICIENTS * 3, header.m_irradianceSH);
+
+		stream.write((const char*)&header, sizeof(HDRICacheHeader));
+		stream.write((const char*)data.m_environment.data(), data.m_environment.size() * sizeof(uint16));
+		stream.write((const char*)data.m_irradiance.data(), data.m_irradiance.size() * sizeof(uint16));
+		stream.write((const char*)data.m_prefilter.data(), data.m_prefilter.size() * sizeof(uint16));
+		return (bool)stream;
+	}
+
+	void HDRICache::ComputeIrradianceSH(const uint16* faces, uint32 resolution, float* coefficients)
+	{
+		// Basis constants & the cosine lobe's convolution per band over pi.
+		const float basis[HDRICACHE_SH_COEFFICIENTS] = { 0.282095f, 0.488603f, 0.488603f, 0.488603f, 1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f };
+		const float lobe[HDRICACHE_SH_COEFFICIENTS] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+		double sums[HDRICACHE_SH_COEFFICIENTS * 3] = { 0.0 };
+		double totalWeight = 0.0;
+		const float texelSize = 2.0f / (float)resolution;
+
+		for (uint32 face = 0; face < 6; face++)
+		{
+			for (uint32 y = 0; y < resolution; y++)
+			{
+				const float v = ((float)y + 0.5f) * texelSize - 1.0f;
+
+				for (uint32 x = 0; x < resolution; x++)
+				{
+					const float u = ((float)x + 0.5f) * texelSize - 1.0f;
+
+					// Direction of the texel, same face orientation GL samples cubemaps with.
+					float dir[3];
+					switch (face)
+					{
+					case 0: dir[0] = 1.0f; dir[1] = -v; dir[2] = -u; break;
+					case 1: dir[0] = -1.0f; dir[1] = -v; dir[2] = u; break;
+					case 2: dir[0] = u; dir[1] = 1.0f; dir[2] = v; break;
+					case 3: dir[0] = u; dir[1] = -1.0f; dir[2] = -v; break;
+					case 4: dir[0] = u; dir[1] = -v; dir[2] = 1.0f; break;
+					default: dir[0] = -u; dir[1] = -v; dir[2] = -1.0f; break;
+					}
+
+					// Solid angle of the texel.
+					const float lengthSqr = 1.0f + u * u + v * v;
+					const float weight = 4.0f / ((float)(resolution * resolution) * lengthSqr * std::sqrt(lengthSqr));
+					const float invLength = 1.0f / std::sqrt(lengthSqr);
+					const float nx = dir[0] * invLength, ny = dir[1] * invLength, nz = dir[2] * invLength;
+
+					const float sh[HDRICACHE_SH_COEFFICIENTS] = { 1.0f, ny, nz, nx, nx * ny, ny * nz, 3.0f * nz * nz - 1.0f, nx * nz, nx * nx - ny * ny };
+					const uint16* texel = faces + ((face * resolution + y) * resolution + x) * 3;
+
+					for (uint32 c = 0; c < 3; c++)
+					{
+						const float radiance = glm::unpackHalf1x16(texel[c]) * weight;
+						for (uint32 i = 0; i < HDRICACHE_SH_COEFFICIENTS; i++)
+							sums[i * 3 + c] += radiance * sh[i] * basis[i];
+					}
+
+					totalWeight += weight;
+				}
+			}
+		}
+
+		// Texel solid angles should add up to the whole sphere.
+		const double normalization = totalWeight > 0.0 ? 4.0 * IBL_PI / totalWeight : 0.0;
+
+		for (uint32 i = 0; i < HDRICACHE_SH_COEFFICIENTS; i++)
+		{
+			for (uint32 c = 0; c < 3; c++)
+				coefficients[i * 3 + c] = (float)(sums[i * 3 + c] * normalization) * lobe[i] * basis[i];
+		}
+	}
+
+	void HDRICache::ComputeBRDFLut(uint32 resolution, uint32 sampleCount, std::vector<float>& data)
+	{
+		data.resize(resolution * resolution * 2);
+
+		for (uint32 y = 0; y < resolution; y++)
+		{
+			const float roughness = ((float)y + 0.5f) / (float)resolution;
+			const float a = roughness * roughness;
+
+			for (uint32 x = 0; x < resolution; x++)
+			{
+				const float NdotV = ((float)x + 0.5f) / (float)resolution;
+				const float vx = std::sqrt(1.0f - NdotV * NdotV);
+				const float vz = NdotV;
+				float scale = 0.0f;
+				float bias = 0.0f;
+
+				for (uint32 i = 0; i < sampleCount; i++)
+				{
+					// Importance sample GGX around the normal with a Hammersley point.
+					const float phi = 2.0f * IBL_PI * (float)i / (float)sampleCount;
+					const float xi = RadicalInverse(i);
+					const float cosTheta = std::sqrt((1.0f - xi) / (1.0f + (a * a - 1.0f) * xi));
+					const float sinTheta = std::sqrt(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+					const float hx = std::cos(phi) * sinTheta;
+					const float hz = cosTheta;
+
+					// Reflect the view around the half vector, N is +Z & V has no Y.
+					const float VdotH = vx * hx + vz * hz;
+					const float lz = 2.0f * VdotH * hz - vz;
+
+					if (lz > 0.0f)
+					{
+						const float G = GeometrySchlickGGX(NdotV, roughness) * GeometrySchlickGGX(lz, roughness);
+						const float visibility = (G * std::max(VdotH, 0.0f)) / (std::max(hz, 0.0f) * NdotV);
+						const float fresnel = std::pow(1.0f - std::max(VdotH, 0.0f), 5.0f);
+						scale += (1.0f - fresnel) * visibility;
+						bias += fresnel * visibility;
+					}
+				}
+
+				data[(y * resolution + x) * 2] = scale / (float)sampleCount;
+				data[(y * resolution + x) * 2 + 1] = bias / (float)sampleCount;
+			}
+		}
+	}
+
+	bool HDRICache::LoadBRDFLut(const std::string& path, uint32& resolution, std::vector<float>& data)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) return false;
+
+		BRDFLutHeader header;
+		stream.read((char*)&header, sizeof(BRDFLutHeader));
+
+		if (!stream || header.m_magic != BRDFLUT_MAGIC || header.m_version != BRDFLUT_VERSION || header.m_channels != 2 || header.m_resolution == 0)
+			return false;
+
+		resolution = header.m_resolution;
+		data.resize(resolution * resolution * 2);
+		stream.read((char*)data.data(), data.size() * sizeof(float));
+		return (bool)stream;
+	}
+
+	bool HDRICache::SaveBRDFLut(const std::string& path, uint32 resolution, const std::vector<float>& data)
+	{
+		CreateParentFolder(path);
+
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		if (!stream) return false;
+
+		BRDFLutHeader header;
+		header.m_resolution = resolution;
+		stream.write((const char*)&header, sizeof(BRDFLutHeader));
+		stream.write((const char*)data.data(), data.size() * sizeof(float));
+		return (bool)stream;
+	}
+
+	static void CreateParentFolder(const std::string& path)
+	{
+		std::error_code error;
+		const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+
+		if (!parent.empty())
+			std::filesystem::create_directories(parent, error);
+	}
+
+	// Van der Corpus sequence, the second coordinate of a Hammersley point.
+	static float RadicalInverse(uint32 bits)
+	{
+		bits = (bits << 16u) | (bits >> 16u);
+		bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+		bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+		bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+		bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+		return (float)bits * 2.3283064365386963e-10f;
+	}
+
+	// Schlick-GGX with the k used for image based lighting.
+	static float GeometrySchlickGGX(float NdotV, float roughness)
+	{
+		const float k = (roughness * roughness) / 2.0f;
+		return NdotV / (NdotV * (1.0f - k) + k);
+	}
+}
@@ -28,9 +28,35 @@ SOFTWARE.
 
 #include "Rendering/IndexedModel.hpp"  
 #include "PackageManager/PAMRenderDevice.hpp"
+#include <cmath>
+
+#define QUANTIZATION_MIN_EXTENT 0.0001f
 
 namespace LinaEngine::Graphics
 {
+	// Maps the unit vector onto the octahedron & folds the lower half over, both outputs are in [-1, 1].
+	static void EncodeOctahedral(const float* v, float& u, float& w)
+	{
+		const float length = std::fabs(v[0]) + std::fabs(v[1]) + std::fabs(v[2]);
+		if (length <= 0.0f)
+		{
+			u = w = 0.0f;
+			return;
+		}
+
+		float x = v[0] / length, y = v[1] / length;
+		if (v[2] < 0.0f)
+		{
+			const float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+			const float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		u = x;
+		w = y;
+	}
+
 	void IndexedModel::AddElement(uint32 elementIndex, float e0)
 	{
 	
@@ -62,6 +88,114 @@ namespace LinaEngine::Graphics
 		m_elements[elementIndex].push_back(e3);
 	}
 
+	void IndexedModel::CalculateBounds()
+	{
+		if (m_elements.size() == 0 || m_elementSizes[0] != 3 || m_elements[0].size() == 0)
+		{
+			LINA_CORE_WARN("Indexed model does not have position data, bounds are not calculated.");
+			return;
+		}
+
+		const std::vector<float>& positions = m_elements[0];
+		const size_t vertexCount = positions.size() / 3;
+		m_bounds = AABB::FromPoints(&positions[0], vertexCount);
+		m_boundingSphere = BoundingSphere::FromPoints(m_bounds, &positions[0], vertexCount);
+	}
+
+	IndexedModel IndexedModel::CreateSubset(const std::vector<uint32>& indices) const
+	{
+		IndexedModel subset;
+		subset.m_elementSizes = m_elementSizes;
+		subset.m_elementTypes = m_elementTypes;
+		subset.m_startIndex = m_startIndex;
+		subset.m_elements.resize(m_elements.size());
+		subset.m_indices.reserve(indices.size());
+
+		// Instanced elements don't carry vertex data.
+		const uint32 numVertexComponents = GetVertexElementCount();
+		std::vector<uint32> remap(GetVertexCount(), (uint32)-1);
+		uint32 subsetVertexCount = 0;
+
+		for (uint32 index : indices)
+		{
+			if (remap[index] == (uint32)-1)
+			{
+				remap[index] = subsetVertexCount++;
+
+				for (uint32 i = 0; i < numVertexComponents; i++)
+				{
+					const uint32 elementSize = m_elementSizes[i];
+					const float* source = &m_elements[i][index * elementSize];
+					subset.m_elements[i].insert(subset.m_elements[i].end(), source, source + elementSize);
+				}
+			}
+
+			subset.m_indices.push_back(remap[index]);
+		}
+
+		subset.CalculateBounds();
+		return subset;
+	}
+
+	IndexedModel IndexedModel::CreateQuantized() const
+	{
+		const uint32 vertexCount = GetVertexCount();
+		if (GetVertexElementCount() < 4 || m_elementSizes[0] != 3 || m_elementSizes[1] != 2 || m_elementSizes[2] != 3 || m_elementSizes[3] != 3 || !m_bounds.IsValid())
+		{
+			LINA_CORE_WARN("Indexed model does not have the position, uv, normal & tangent layout, vertices are not quantized.");
+			return *this;
+		}
+
+		IndexedModel quantized;
+		quantized.AllocateElement(4, VertexElementType::ELEMENT_UNORM16); // Positions & tangent handedness
+		quantized.AllocateElement(2, VertexElementType::ELEMENT_HALF); // TexCoords
+		quantized.AllocateElement(2, VertexElementType::ELEMENT_SNORM16); // Normals
+		quantized.AllocateElement(2, VertexElementType::ELEMENT_SNORM16); // Tangents
+		quantized.AllocateElement(0, VertexElementType::ELEMENT_FLOAT); // Keeps the bitangent location, derived in the shader
+		quantized.SetStartIndex(5); // Begin instanced data
+		quantized.AllocateInstanceTransform(); // Model transform
+
+		quantized.m_indices = m_indices;
+		quantized.m_bounds = m_bounds;
+		quantized.m_boundingSphere = m_boundingSphere;
+		quantized.m_isQuantized = true;
+
+		// Flat axes keep a tiny extent so the decode stays invertible.
+		const Vector3 extent = m_bounds.m_boundsMax - m_bounds.m_boundsMin;
+		quantized.m_positionOffset = m_bounds.m_boundsMin;
+		quantized.m_positionScale = Vector3(std::fmax(extent.x, QUANTIZATION_MIN_EXTENT), std::fmax(extent.y, QUANTIZATION_MIN_EXTENT), std::fmax(extent.z, QUANTIZATION_MIN_EXTENT));
+
+		const bool hasBitangents = GetVertexElementCount() > 4 && m_elementSizes[4] == 3;
+
+		for (uint32 v = 0; v < vertexCount; v++)
+		{
+			const float* position = &m_elements[0][v * 3];
+			const float* uv = &m_elements[1][v * 2];
+			const float* normal = &m_elements[2][v * 3];
+			const float* tangent = &m_elements[3][v * 3];
+
+			// Handedness of the tangent frame, the shader rebuilds the bitangent as cross(normal, tangent) * sign.
+			float handedness = 1.0f;
+			if (hasBitangents)
+			{
+				const float* bitangent = &m_elements[4][v * 3];
+				const float cross[3] = { normal[1] * tangent[2] - normal[2] * tangent[1], normal[2] * tangent[0] - normal[0] * tangent[2], normal[0] * tangent[1] - normal[1] * tangent[0] };
+				handedness = cross[0] * bitangent[0] + cross[1] * bitangent[1] + cross[2] * bitangent[2] < 0.0f ? 0.0f : 1.0f;
+			}
+
+			float normalU, normalV, tangentU, tangentV;
+			EncodeOctahedral(normal, normalU, normalV);
+			EncodeOctahedral(tangent, tangentU, tangentV);
+
+			quantized.AddElement(0, (position[0] - quantized.m_positionOffset.x) / quantized.m_positionScale.x, (position[1] - quantized.m_positionOffset.y) / quantized.m_positionScale.y, (position[2] - quantized.m_positionOffset.z) / quantized.m_positionScale.z, handedness);
+			quantized.AddElement(1, uv[0], uv[1]);
+			quantized.AddElement(2, normalU, normalV);
+			quantized.AddElement(3, tangentU, tangentV);
+		}
+
+		return quantized;
+	}
+
 	void IndexedModel::AddIndices(uint32 i0)
 	{
 		m_indices.push_back(i0);
@@ -89,9 +223,14 @@ namespace LinaEngine::Graphics
 	}
 
 	void IndexedModel::AllocateElement(uint32 elementSize, bool isFloat)
+	{
+		AllocateElement(elementSize, isFloat ? VertexElementType::ELEMENT_FLOAT : VertexElementType::ELEMENT_INT);
+	}
+
+	void IndexedModel::AllocateElement(uint32 elementSize, VertexElementType elementType)
 	{
 		m_elementSizes.push_back(elementSize);
-		m_elementTypes.push_back(isFloat ? 1 : 0);
+		m_elementTypes.push_back(elementType);
 		m_elements.push_back(std::vector<float>());
 	}
 
@@ -106,7 +245,7 @@ namespace LinaEngine::Graphics
 		std::vector<const float*> vertexDataArray;
 
 		for (uint32 i = 0; i < numVertexComponents; i++) 
-			vertexDataArray.push_back(&(m_elements[i][0]));
+			vertexDataArray.push_back(m_elements[i].data());
 
 		
 		const float** vertexData = &vertexDataArray[0];
@@ -0,0 +1,287 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/LightClusterGrid.hpp"
+#include "Rendering/RenderConstants.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Timer.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace LinaEngine::Graphics
+{
+	LightClusterGrid::~LightClusterGrid()
+	{
+		if (s_renderDevice != nullptr)
+		{
+			m_lightsTexture = m_lightsBuffer = s_renderDevice->ReleaseTextureBuffer(m_lightsTexture, m_lightsBuffer);
+			m_gridTexture = m_gridBuffer = s_renderDevice->ReleaseTextureBuffer(m_gridTexture, m_gridBuffer);
+			m_indicesTexture = m_indicesBuffer = s_renderDevice->ReleaseTextureBuffer(m_indicesTexture, m_indicesBuffer);
+		}
+	}
+
+	void LightClusterGrid::Construct(RenderDevice& renderDeviceIn)
+	{
+		s_renderDevice = &renderDeviceIn;
+		m_lightsTexture = s_renderDevice->CreateTextureBuffer(PixelFormat::FORMAT_RGBA32F, m_lightsBuffer);
+		m_gridTexture = s_renderDevice->CreateTextureBuffer(PixelFormat::FORMAT_RG32UI, m_gridBuffer);
+		m_indicesTexture = s_renderDevice->CreateTextureBuffer(PixelFormat::FORMAT_R32UI, m_indicesBuffer);
+		m_clusterMin.resize(LIGHTCLUSTER_COUNT);
+		m_clusterMax.resize(LIGHTCLUSTER_COUNT);
+		m_grid.resize(LIGHTCLUSTER_COUNT * 2);
+		m_sliceIndices.resize(LIGHTCLUSTER_Z);
+	}
+
+	void LightClusterGrid::Clear()
+	{
+		m_lights.clear();
+		m_spotLights.clear();
+	}
+
+	void LightClusterGrid::AddPointLight(const Vector3& position, const Color& color, float range)
+	{
+		if (m_lights.size() + m_spotLights.size() >= LIGHTCLUSTER_MAX_LIGHTS) return;
+
+		ClusterLightData& light = m_lights.emplace_back();
+		light.m_positionRange = Vector4(position.x, position.y, position.z, range);
+		light.m_colorCutoff = Vector4(color.r, color.g, color.b, 0.0f);
+		light.m_directionOuterCutoff = Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	void LightClusterGrid::AddSpotLight(const Vector3& position, const Vector3& direction, const Color& color, float range, float cutoff, float outerCutoff)
+	{
+		if (m_lights.size() + m_spotLights.size() >= LIGHTCLUSTER_MAX_LIGHTS) return;
+
+		ClusterLightData& light = m_spotLights.emplace_back();
+		light.m_positionRange = Vector4(position.x, position.y, position.z, range);
+		light.m_colorCutoff = Vector4(color.r, color.g, color.b, cutoff);
+		light.m_directionOuterCutoff = Vector4(direction.x, direction.y, direction.z, outerCutoff);
+	}
+
+	void LightClusterGrid::Build(const Matrix& view, const Matrix& projection, float zNear, float zFar)
+	{
+		LINA_TIMER_START("[Graphics] Light Clustering");
+
+		// Shaders tell the light types apart by index, spots go after the points.
+		m_pointLightCount = (int)m_lights.size();
+		m_spotLightCount = (int)m_spotLights.size();
+		m_lights.insert(m_lights.end(), m_spotLights.begin(), m_spotLights.end());
+
+		zNear = std::max(zNear, 0.01f);
+		zFar = std::max(zFar, zNear + 0.01f);
+		const float logRatio = std::log(zFar / zNear);
+		m_sliceScale = (float)LIGHTCLUSTER_Z / logRatio;
+		m_sliceBias = -(float)LIGHTCLUSTER_Z * std::log(zNear) / logRatio;
+
+		BuildClusterBounds(projection, zNear, zFar);
+
+		// View space bounds & the conservative cluster range of each light.
+		const glm::mat4& viewMatrix = view;
+		const glm::mat4& projectionMatrix = projection;
+		m_bounds.resize(m_lights.size());
+
+		for (size_t i = 0; i < m_lights.size(); i++)
+		{
+			const Vector4& positionRange = m_lights[i].m_positionRange;
+			glm::vec4 viewPosition = viewMatrix * glm::vec4(positionRange.x, positionRange.y, positionRange.z, 1.0f);
+			float radius = positionRange.w;
+			float depth = viewPosition.z;
+
+			LightBounds& bounds = m_bounds[i];
+			bounds.m_center = Vector3(viewPosition.x, viewPosition.y, viewPosition.z);
+			bounds.m_radius = radius;
+
+			// Outside of the depth range, leave the cluster range empty.
+			if (depth + radius < zNear || depth - radius > zFar)
+			{
+				bounds.m_minX = bounds.m_minY = bounds.m_minZ = 1;
+				bounds.m_maxX = bounds.m_maxY = bounds.m_maxZ = 0;
+				continue;
+			}
+
+			float minDepth = std::max(depth - radius, zNear);
+			float maxDepth = std::min(depth + radius, zFar);
+			bounds.m_minZ = std::clamp((int)std::floor(std::log(minDepth) * m_sliceScale + m_sliceBias), 0, LIGHTCLUSTER_Z - 1);
+			bounds.m_maxZ = std::clamp((int)std::floor(std::log(maxDepth) * m_sliceScale + m_sliceBias), 0, LIGHTCLUSTER_Z - 1);
+
+			// Project the corners of the sphere's box clipped to the near plane, its screen extent bounds the sphere's.
+			float minNDCX = 1.0f, minNDCY = 1.0f, maxNDCX = -1.0f, maxNDCY = -1.0f;
+			for (int corner = 0; corner < 8; corner++)
+			{
+				glm::vec4 point(viewPosition.x + ((corner & 1) ? radius : -radius), viewPosition.y + ((corner & 2) ? radius : -radius), (corner & 4) ? maxDepth : minDepth, 1.0f);
+				glm::vec4 clip = projectionMatrix * point;
+				float ndcX = clip.x / clip.w, ndcY = clip.y / clip.w;
+				minNDCX = std::min(minNDCX, ndcX); maxNDCX = std::max(maxNDCX, ndcX);
+				minNDCY = std::min(minNDCY, ndcY); maxNDCY = std::max(maxNDCY, ndcY);
+			}
+
+			bounds.m_minX = std::clamp((int)std::floor((minNDCX * 0.5f + 0.5f) * LIGHTCLUSTER_X), 0, LIGHTCLUSTER_X - 1);
+			bounds.m_maxX = std::clamp((int)std::floor((maxNDCX * 0.5f + 0.5f) * LIGHTCLUSTER_X), 0, LIGHTCLUSTER_X - 1);
+			bounds.m_minY = std::clamp((int)std::floor((minNDCY * 0.5f + 0.5f) * LIGHTCLUSTER_Y), 0, LIGHTCLUSTER_Y - 1);
+			bounds.m_maxY = std::clamp((int)std::floor((maxNDCY * 0.5f + 0.5f) * LIGHTCLUSTER_Y), 0, LIGHTCLUSTER_Y - 1);
+		}
+
+		// Slices are independent, each job fills its own index list & grid entries.
+		if (!m_lights.empty())
+			JobSystem::Get().ParallelFor(LIGHTCLUSTER_Z, 1, [this](uint32 begin, uint32 end) { for (uint32 slice = begin; slice < end; slice++) AssignSlice(slice); });
+
+		// Concatenate the slice lists, grid offsets become absolute.
+		m_indices.clear();
+		for (uint32 slice = 0; slice < LIGHTCLUSTER_Z; slice++)
+		{
+			uint32 base = (uint32)m_indices.size();
+			for (uint32 cluster = slice * LIGHTCLUSTER_X * LIGHTCLUSTER_Y; cluster < (slice + 1) * LIGHTCLUSTER_X * LIGHTCLUSTER_Y; cluster++)
+			{
+				if (m_lights.empty())
+					m_grid[cluster * 2] = m_grid[cluster * 2 + 1] = 0;
+				else
+					m_grid[cluster * 2] += base;
+			}
+
+			if (!m_lights.empty())
+				m_indices.insert(m_indices.end(), m_sliceIndices[slice].begin(), m_sliceIndices[slice].end());
+		}
+
+		// Empty buffers are left with a single element, texel fetches stay inside the storage.
+		if (m_lights.empty()) m_lights.emplace_back();
+		if (m_indices.empty()) m_indices.push_back(0);
+
+		s_renderDevice->UpdateTextureBuffer(m_lightsBuffer, &m_lights[0], m_lights.size() * sizeof(ClusterLightData));
+		s_renderDevice->UpdateTextureBuffer(m_gridBuffer, &m_grid[0], m_grid.size() * sizeof(uint32));
+		s_renderDevice->UpdateTextureBuffer(m_indicesBuffer, &m_indices[0], m_indices.size() * sizeof(uint32));
+
+		LINA_TIMER_STOP("[Graphics] Light Clustering");
+	}
+
+	void LightClusterGrid::BuildClusterBounds(const Matrix& projection, float zNear, float zFar)
+	{
+		// Rays through the tile corners, given by their points on the near & far planes.
+		const glm::mat4 inverseProjection = glm::inverse((const glm::mat4&)projection);
+		glm::vec3 nearPoints[(LIGHTCLUSTER_X + 1) * (LIGHTCLUSTER_Y + 1)];
+		glm::vec3 farPoints[(LIGHTCLUSTER_X + 1) * (LIGHTCLUSTER_Y + 1)];
+
+		for (int y = 0; y <= LIGHTCLUSTER_Y; y++)
+		{
+			for (int x = 0; x <= LIGHTCLUSTER_X; x++)
+			{
+				float ndcX = (float)x / LIGHTCLUSTER_X * 2.0f - 1.0f;
+				float ndcY = (float)y / LIGHTCLUSTER_Y * 2.0f - 1.0f;
+				glm::vec4 nearPoint = inverseProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+				glm::vec4 farPoint = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+				nearPoints[y * (LIGHTCLUSTER_X + 1) + x] = glm::vec3(nearPoint) / nearPoint.w;
+				farPoints[y * (LIGHTCLUSTER_X + 1) + x] = glm::vec3(farPoint) / farPoint.w;
+			}
+		}
+
+		for (int z = 0; z < LIGHTCLUSTER_Z; z++)
+		{
+			// Exponential slices, matching the shader's log(depth) * scale + bias.
+			float sliceDepths[2] = { zNear * std::pow(zFar / zNear, (float)z / LIGHTCLUSTER_Z), zNear * std::pow(zFar / zNear, (float)(z + 1) / LIGHTCLUSTER_Z) };
+
+			for (int y = 0; y < LIGHTCLUSTER_Y; y++)
+			{
+				for (int x = 0; x < LIGHTCLUSTER_X; x++)
+				{
+					glm::vec3 clusterMin(FLT_MAX), clusterMax(-FLT_MAX);
+
+					for (int corner = 0; corner < 4; corner++)
+					{
+						int pointIndex = (y + (corner >> 1)) * (LIGHTCLUSTER_X + 1) + x + (corner & 1);
+						const glm::vec3& nearPoint = nearPoints[pointIndex];
+						const glm::vec3& farPoint = farPoints[pointIndex];
+
+						for (int d = 0; d < 2; d++)
+						{
+							float t = (sliceDepths[d] - nearPoint.z) / (farPoint.z - nearPoint.z);
+							glm::vec3 point = nearPoint + (farPoint - nearPoint) * t;
+							clusterMin = glm::min(clusterMin, point);
+							clusterMax = glm::max(clusterMax, point);
+						}
+					}
+
+					int cluster = x + y * LIGHTCLUSTER_X + z * LIGHTCLUSTER_X * LIGHTCLUSTER_Y;
+					m_clusterMin[cluster] = Vector3(clusterMin.x, clusterMin.y, clusterMin.z);
+					m_clusterMax[cluster] = Vector3(clusterMax.x, clusterMax.y, clusterMax.z);
+				}
+			}
+		}
+	}
+
+	void LightClusterGrid::AssignSlice(uint32 slice)
+	{
+		std::vector<uint32>& indices = m_sliceIndices[slice];
+		indices.clear();
+
+		// Lights touching the slice at all.
+		std::vector<uint32> candidates;
+		for (uint32 i = 0; i < (uint32)m_bounds.size(); i++)
+		{
+			if ((int)slice >= m_bounds[i].m_minZ && (int)slice <= m_bounds[i].m_maxZ)
+				candidates.push_back(i);
+		}
+
+		for (int y = 0; y < LIGHTCLUSTER_Y; y++)
+		{
+			for (int x = 0; x < LIGHTCLUSTER_X; x++)
+			{
+				uint32 cluster = x + y * LIGHTCLUSTER_X + slice * LIGHTCLUSTER_X * LIGHTCLUSTER_Y;
+				const glm::vec3& clusterMin = m_clusterMin[cluster];
+				const glm::vec3& clusterMax = m_clusterMax[cluster];
+				uint32 offset = (uint32)indices.size();
+				uint32 count = 0;
+
+				for (uint32 i : candidates)
+				{
+					const LightBounds& bounds = m_bounds[i];
+					if (x < bounds.m_minX || x > bounds.m_maxX || y < bounds.m_minY || y > bounds.m_maxY) continue;
+
+					// Sphere against the cluster box, through the closest point of the box to the light.
+					const glm::vec3 delta = glm::clamp(static_cast<const glm::vec3&>(bounds.m_center), clusterMin, clusterMax) - static_cast<const glm::vec3&>(bounds.m_center);
+					if (glm::dot(delta, delta) > bounds.m_radius * bounds.m_radius) continue;
+
+					indices.push_back(i);
+					if (++count == LIGHTCLUSTER_MAX_LIGHTS_PER_CLUSTER) break;
+				}
+
+				m_grid[cluster * 2] = offset;
+				m_grid[cluster * 2 + 1] = count;
+			}
+		}
+	}
+
+	void LightClusterGrid::Bind(uint32 shader, RenderCommandBuffer& commands)
+	{
+		commands.SetTexture(m_lightsTexture, 0, LIGHTCLUSTER_UNIT_LIGHTS, TextureBindMode::BINDTEXTURE_TEXTUREBUFFER);
+		commands.SetTexture(m_gridTexture, 0, LIGHTCLUSTER_UNIT_GRID, TextureBindMode::BINDTEXTURE_TEXTUREBUFFER);
+		commands.SetTexture(m_indicesTexture, 0, LIGHTCLUSTER_UNIT_INDICES, TextureBindMode::BINDTEXTURE_TEXTUREBUFFER);
+		commands.UpdateShaderUniformInt(shader, SC_LIGHTBUFFER, LIGHTCLUSTER_UNIT_LIGHTS);
+		commands.UpdateShaderUniformInt(shader, SC_LIGHTCLUSTERGRID, LIGHTCLUSTER_UNIT_GRID);
+		commands.UpdateShaderUniformInt(shader, SC_LIGHTCLUSTERINDICES, LIGHTCLUSTER_UNIT_INDICES);
+	}
+}
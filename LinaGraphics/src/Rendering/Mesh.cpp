@@ -31,12 +31,19 @@ SOFTWARE.
 #include "Utility/UtilityFunctions.hpp"
 #include "Rendering/RenderEngine.hpp"
 #include "Rendering/ModelLoader.hpp"
+#include "Rendering/MeshSimplifier.hpp"
+#include "Core/Timer.hpp"
 #include <stdio.h>
 #include <cereal/archives/binary.hpp>
 #include <fstream>
 
 namespace LinaEngine::Graphics
 {
+#define MESHLOD_MAX_ERROR 0.02f
+#define MESHLOD_MIN_REDUCTION 0.85f
+
+// Parameter files written before MeshParameters was versioned hold only the five import flags, one byte each & no version.
+#define MESHPARAMS_UNVERSIONED_SIZE 5
 
 	std::map<int, Mesh> Mesh::s_loadedMeshes;
 
@@ -45,7 +52,14 @@ namespace LinaEngine::Graphics
 		for (uint32 i = 0; i < m_vertexArrays.size(); i++)
 			delete m_vertexArrays[i];
 
+		for (MeshLOD& lod : m_lods)
+		{
+			for (uint32 i = 0; i < lod.m_vertexArrays.size(); i++)
+				delete lod.m_vertexArrays[i];
+		}
+
 		m_vertexArrays.clear();
+		m_lods.clear();
 		m_indexedModelArray.clear();
 		m_materialSpecArray.clear();
 		m_materialIndexArray.clear();
@@ -67,14 +81,34 @@ namespace LinaEngine::Graphics
 			return GetPrimitive(Primitives::Plane);
 		}
 
+		// Weld & reorder the submeshes for the vertex cache, overdraw & vertex fetch.
+		for (IndexedModel& model : mesh.GetIndexedModels())
+		{
+			if (meshParams.m_optimizeVertexOrder)
+				mesh.m_optimizationReport.Add(MeshOptimizer::Optimize(model));
+			else
+			{
+				MeshOptimizationReport report;
+				report.m_before = report.m_after = MeshOptimizer::AnalyzeVertexCache(model.GetIndices(), model.GetVertexCount());
+				mesh.m_optimizationReport.Add(report);
+			}
+		}
+
 		// Create vertex array for each mesh.
 		for (uint32 i = 0; i < mesh.GetIndexedModels().size(); i++)
 		{
+			mesh.GetIndexedModels()[i].CalculateBounds();
+			mesh.m_bounds.Expand(mesh.GetIndexedModels()[i].GetBounds());
+
+			// The CPU copy stays in floats for culling, picking & LOD generation, the GPU copy goes into the shared geometry pool.
 			VertexArray* vertexArray = new VertexArray();
-			vertexArray->Construct(RenderEngine::GetRenderDevice(), mesh.GetIndexedModels()[i], BufferUsage::USAGE_STATIC_COPY);
+			IndexedModel& model = mesh.GetIndexedModels()[i];
+			vertexArray->Construct(RenderEngine::GetRenderDevice(), meshParams.m_quantizeVertices ? model.CreateQuantized() : model, BufferUsage::USAGE_STATIC_COPY, &RenderEngine::GetGeometryPool());
 			mesh.GetVertexArrays().push_back(vertexArray);
 		}
 
+		mesh.GenerateLODs();
+
 		// Set id
 		mesh.m_meshID = id;
 		mesh.m_path = filePath;
@@ -84,6 +118,71 @@ namespace LinaEngine::Graphics
 		return s_loadedMeshes[id];
 	}
 
+	void Mesh::GenerateLODs()
+	{
+		LINA_TIMER_START("[Graphics] Mesh LOD Generation");
+
+		uint32 previousIndexCount = 0;
+		for (IndexedModel& model : m_indexedModelArray)
+			previousIndexCount += model.GetIndexCount();
+
+		std::vector<uint32> simplified;
+		float screenSize = m_parameters.m_lodScreenSize;
+		float ratio = 1.0f;
+
+		for (int level = 1; level <= m_parameters.m_lodCount; level++)
+		{
+			MeshLOD lod;
+			lod.m_screenSize = screenSize;
+			ratio *= m_parameters.m_lodReduction;
+			uint32 indexCount = 0;
+
+			// Each level simplifies the original submeshes, allowing a larger error the further it goes.
+			for (IndexedModel& model : m_indexedModelArray)
+			{
+				const std::vector<std::vector<float>>& elements = model.GetElements();
+				const std::vector<uint32>& indices = model.GetIndices();
+
+				if (elements.size() == 0 || elements[0].size() == 0 || indices.size() < 3)
+				{
+					lod.m_indexedModels.push_back(model);
+					indexCount += model.GetIndexCount();
+					continue;
+				}
+
+				const uint32 targetIndexCount = (uint32)(indices.size() / 3 * ratio) * 3;
+				MeshSimplifier::Simplify(&elements[0][0], (uint32)elements[0].size() / 3, &indices[0], (uint32)indices.size(), targetIndexCount, MESHLOD_MAX_ERROR * level, simplified);
+
+				if (simplified.size() < 3)
+					simplified = indices;
+
+				// Collapses scatter the triangle order, the subset then follows the new order for fetching.
+				if (m_parameters.m_optimizeVertexOrder)
+					MeshOptimizer::OptimizeVertexCache(simplified, model.GetVertexCount());
+
+				lod.m_indexedModels.push_back(model.CreateSubset(simplified));
+				indexCount += (uint32)simplified.size();
+			}
+
+			// Stop the chain once simplification can't make meaningful progress, locked borders or the error limit.
+			if (indexCount > previousIndexCount * MESHLOD_MIN_REDUCTION)
+				break;
+
+			for (IndexedModel& model : lod.m_indexedModels)
+			{
+				VertexArray* vertexArray = new VertexArray();
+				vertexArray->Construct(RenderEngine::GetRenderDevice(), m_parameters.m_quantizeVertices ? model.CreateQuantized() : model, BufferUsage::USAGE_STATIC_COPY, &RenderEngine::GetGeometryPool());
+				lod.m_vertexArrays.push_back(vertexArray);
+			}
+
+			m_lods.push_back(std::move(lod));
+			previousIndexCount = indexCount;
+			screenSize *= 0.5f;
+		}
+
+		LINA_TIMER_STOP("[Graphics] Mesh LOD Generation");
+	}
+
 	Mesh& Mesh::GetMesh(int id)
 	{
 		if (!MeshExists(id))
@@ -157,11 +256,18 @@ namespace LinaEngine::Graphics
 		MeshParameters params;
 
 		std::ifstream stream(path);
+		stream.seekg(0, std::ios::end);
+		const std::streamoff size = stream.tellg();
+		stream.seekg(0, std::ios::beg);
+
 		{
 			cereal::BinaryInputArchive iarchive(stream);
 
-			// Read the data into it.
-			iarchive(params);
+			// Read the data into it, binary archives can't tell an unversioned file apart so those are read as version 0.
+			if (size == MESHPARAMS_UNVERSIONED_SIZE)
+				params.serialize(iarchive, 0);
+			else
+				iarchive(params);
 		}
 
 		return params;
@@ -0,0 +1,368 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/MeshOptimizer.hpp"
+#include "Rendering/IndexedModel.hpp"
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#define VERTEXCACHE_FORSYTH_SIZE 32
+#define VERTEXCACHE_FIFO_SIZE 16
+#define VERTEXCACHE_MAX_VALENCE 32
+#define OVERDRAW_THRESHOLD 1.05f
+
+namespace LinaEngine::Graphics
+{
+	struct OverdrawCluster
+	{
+		uint32 m_firstTriangle;
+		uint32 m_triangleCount;
+		float m_sortKey;
+	};
+
+	// Forsyth's vertex score, recently used vertices & vertices with few remaining triangles score higher.
+	static float ForsythVertexScore(int cachePosition, uint32 valence)
+	{
+		if (valence == 0) return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+			score = cachePosition < 3 ? 0.75f : std::pow(1.0f - (float)(cachePosition - 3) / (VERTEXCACHE_FORSYTH_SIZE - 3), 1.5f);
+
+		return score + 2.0f * std::pow((float)std::min(valence, (uint32)VERTEXCACHE_MAX_VALENCE), -0.5f);
+	}
+
+	MeshOptimizationReport MeshOptimizer::Optimize(IndexedModel& model)
+	{
+		MeshOptimizationReport report;
+		const uint32 vertexCount = model.GetVertexCount();
+		std::vector<uint32> indices = model.GetIndices();
+		report.m_before = AnalyzeVertexCache(indices, vertexCount);
+
+		if (vertexCount == 0 || indices.size() < 3 || indices.size() % 3 != 0)
+		{
+			report.m_after = report.m_before;
+			return report;
+		}
+
+		WeldVertices(model, indices);
+		OptimizeVertexCache(indices, vertexCount);
+
+		if (model.GetElementSizes()[0] == 3)
+			OptimizeOverdraw(indices, &model.GetElements()[0][0], vertexCount, OVERDRAW_THRESHOLD);
+
+		// The subset lays the vertices out in fetch order & drops the welded duplicates.
+		model = model.CreateSubset(indices);
+		report.m_after = AnalyzeVertexCache(model.GetIndices(), model.GetVertexCount());
+		return report;
+	}
+
+	void MeshOptimizer::WeldVertices(const IndexedModel& model, std::vector<uint32>& indices)
+	{
+		const std::vector<std::vector<float>>& elements = model.GetElements();
+		const std::vector<uint32>& elementSizes = model.GetElementSizes();
+		const uint32 elementCount = model.GetVertexElementCount();
+		const uint32 vertexCount = model.GetVertexCount();
+
+		uint32 vertexSize = 0;
+		for (uint32 i = 0; i < elementCount; i++)
+			vertexSize += elementSizes[i];
+
+		// Vertices are compared bitwise across all of their elements.
+		std::unordered_map<std::string, uint32> vertexMap;
+		vertexMap.reserve(vertexCount);
+		std::vector<uint32> remap(vertexCount);
+		std::string key(vertexSize * sizeof(float), '\0');
+
+		for (uint32 v = 0; v < vertexCount; v++)
+		{
+			for (uint32 i = 0, offset = 0; i < elementCount; offset += elementSizes[i], i++)
+				std::memcpy(&key[offset * sizeof(float)], &elements[i][v * elementSizes[i]], elementSizes[i] * sizeof(float));
+
+			remap[v] = vertexMap.emplace(key, v).first->second;
+		}
+
+		for (uint32& index : indices)
+			index = remap[index];
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32>& indices, uint32 vertexCount)
+	{
+		const uint32 triangleCount = (uint32)indices.size() / 3;
+		if (triangleCount == 0) return;
+
+		// Triangles around each vertex, the live ones are kept at the front of each vertex's range.
+		std::vector<uint32> valences(vertexCount, 0);
+		for (uint32 index : indices)
+			valences[index]++;
+
+		std::vector<uint32> offsets(vertexCount + 1, 0);
+		for (uint32 v = 0; v < vertexCount; v++)
+			offsets[v + 1] = offsets[v] + valences[v];
+
+		std::vector<uint32> adjacency(indices.size());
+		std::vector<uint32> fill(offsets.begin(), offsets.end() - 1);
+		for (uint32 i = 0; i < (uint32)indices.size(); i++)
+			adjacency[fill[indices[i]]++] = i / 3;
+
+		std::vector<int> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32 v = 0; v < vertexCount; v++)
+			vertexScores[v] = ForsythVertexScore(-1, valences[v]);
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<uint8> emitted(triangleCount, 0);
+		int bestTriangle = 0;
+
+		for (uint32 t = 0; t < triangleCount; t++)
+		{
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+			if (triangleScores[t] > triangleScores[bestTriangle])
+				bestTriangle = (int)t;
+		}
+
+		std::vector<uint32> result;
+		result.reserve(indices.size());
+		uint32 cache[VERTEXCACHE_FORSYTH_SIZE + 3];
+		uint32 cacheCount = 0;
+		uint32 scanCursor = 0;
+
+		while (result.size() < indices.size())
+		{
+			// Nothing in the cache has triangles left, continue with the next triangle in the source order.
+			if (bestTriangle < 0)
+			{
+				while (scanCursor < triangleCount && emitted[scanCursor])
+					scanCursor++;
+
+				if (scanCursor == triangleCount) break;
+				bestTriangle = (int)scanCursor;
+			}
+
+			const uint32 triangle = (uint32)bestTriangle;
+			emitted[triangle] = 1;
+
+			// Emitted vertices go to the front of the cache, the rest shifts back.
+			uint32 newCache[VERTEXCACHE_FORSYTH_SIZE + 3];
+			uint32 newCacheCount = 0;
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const uint32 v = indices[triangle * 3 + corner];
+				result.push_back(v);
+
+				uint32* triangles = &adjacency[offsets[v]];
+				for (uint32 k = 0; k < valences[v]; k++)
+				{
+					if (triangles[k] != triangle) continue;
+
+					std::swap(triangles[k], triangles[valences[v] - 1]);
+					valences[v]--;
+					break;
+				}
+
+				if (std::find(newCache, newCache + newCacheCount, v) == newCache + newCacheCount)
+					newCache[newCacheCount++] = v;
+			}
+
+			for (uint32 i = 0; i < cacheCount; i++)
+			{
+				if (std::find(newCache, newCache + newCacheCount, cache[i]) == newCache + newCacheCount)
+					newCache[newCacheCount++] = cache[i];
+			}
+
+			// Rescore the vertices that moved, including the ones that fell out of the cache.
+			for (uint32 i = 0; i < newCacheCount; i++)
+			{
+				const uint32 v = newCache[i];
+				cachePositions[v] = i < VERTEXCACHE_FORSYTH_SIZE ? (int)i : -1;
+
+				const float score = ForsythVertexScore(cachePositions[v], valences[v]);
+				const float delta = score - vertexScores[v];
+				vertexScores[v] = score;
+
+				for (uint32 k = 0; k < valences[v]; k++)
+					triangleScores[adjacency[offsets[v] + k]] += delta;
+			}
+
+			cacheCount = std::min(newCacheCount, (uint32)VERTEXCACHE_FORSYTH_SIZE);
+			std::memcpy(cache, newCache, cacheCount * sizeof(uint32));
+
+			// Next triangle is the best one touching the cache.
+			bestTriangle = -1;
+			float bestScore = -1.0f;
+
+			for (uint32 i = 0; i < cacheCount; i++)
+			{
+				const uint32 v = cache[i];
+				for (uint32 k = 0; k < valences[v]; k++)
+				{
+					const uint32 candidate = adjacency[offsets[v] + k];
+					if (triangleScores[candidate] > bestScore)
+					{
+						bestScore = triangleScores[candidate];
+						bestTriangle = (int)candidate;
+					}
+				}
+			}
+		}
+
+		indices.swap(result);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<uint32>& indices, const float* positions, uint32 vertexCount, float threshold)
+	{
+		const uint32 triangleCount = (uint32)indices.size() / 3;
+		if (triangleCount < 2) return;
+
+		// Triangles that miss the cache with all three vertices start a new cluster, reordering clusters barely changes cache behaviour.
+		std::vector<OverdrawCluster> clusters;
+		std::vector<uint32> timestamps(vertexCount, 0);
+		uint32 time = VERTEXCACHE_FIFO_SIZE + 1;
+
+		for (uint32 t = 0; t < triangleCount; t++)
+		{
+			uint32 misses = 0;
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const uint32 v = indices[t * 3 + corner];
+				if (time - timestamps[v] > VERTEXCACHE_FIFO_SIZE)
+				{
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+
+			if (t == 0 || misses == 3)
+				clusters.push_back({ t, 0, 0.0f });
+
+			clusters.back().m_triangleCount++;
+		}
+
+		if (clusters.size() < 2) return;
+
+		// Area weighted centroids & normals.
+		std::vector<float> clusterData(clusters.size() * 6, 0.0f);
+		float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+		float meshArea = 0.0f;
+
+		for (uint32 c = 0; c < (uint32)clusters.size(); c++)
+		{
+			float* data = &clusterData[c * 6];
+			float clusterArea = 0.0f;
+
+			for (uint32 t = clusters[c].m_firstTriangle; t < clusters[c].m_firstTriangle + clusters[c].m_triangleCount; t++)
+			{
+				const float* p0 = &positions[indices[t * 3] * 3];
+				const float* p1 = &positions[indices[t * 3 + 1] * 3];
+				const float* p2 = &positions[indices[t * 3 + 2] * 3];
+
+				const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				const float normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+				const float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+				for (int axis = 0; axis < 3; axis++)
+				{
+					data[axis] += (p0[axis] + p1[axis] + p2[axis]) / 3.0f * area;
+					data[3 + axis] += normal[axis];
+				}
+
+				clusterArea += area;
+			}
+
+			for (int axis = 0; axis < 3; axis++)
+				meshCentroid[axis] += data[axis];
+
+			meshArea += clusterArea;
+
+			if (clusterArea > 0.0f)
+			{
+				for (int axis = 0; axis < 3; axis++)
+					data[axis] /= clusterArea;
+			}
+		}
+
+		if (meshArea <= 0.0f) return;
+
+		for (int axis = 0; axis < 3; axis++)
+			meshCentroid[axis] /= meshArea;
+
+		// Clusters facing away from the center are more likely to occlude the rest, draw them first.
+		for (uint32 c = 0; c < (uint32)clusters.size(); c++)
+		{
+			const float* data = &clusterData[c * 6];
+			const float normalLength = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+			if (normalLength <= 0.0f) continue;
+
+			clusters[c].m_sortKey = ((data[0] - meshCentroid[0]) * data[3] + (data[1] - meshCentroid[1]) * data[4] + (data[2] - meshCentroid[2]) * data[5]) / normalLength;
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const OverdrawCluster& a, const OverdrawCluster& b) { return a.m_sortKey > b.m_sortKey; });
+
+		std::vector<uint32> result;
+		result.reserve(indices.size());
+
+		for (const OverdrawCluster& cluster : clusters)
+			result.insert(result.end(), indices.begin() + cluster.m_firstTriangle * 3, indices.begin() + (cluster.m_firstTriangle + cluster.m_triangleCount) * 3);
+
+		if (AnalyzeVertexCache(result, vertexCount).GetACMR() <= AnalyzeVertexCache(indices, vertexCount).GetACMR() * threshold)
+			indices.swap(result);
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32>& indices, uint32 vertexCount)
+	{
+		VertexCacheStatistics statistics;
+		statistics.m_triangleCount = (uint32)indices.size() / 3;
+
+		// Timestamps emulate a FIFO cache, a vertex is a hit while fewer than cache size transforms happened since it was loaded.
+		std::vector<uint32> timestamps(vertexCount, 0);
+		std::vector<uint8> referenced(vertexCount, 0);
+		uint32 time = VERTEXCACHE_FIFO_SIZE + 1;
+
+		for (uint32 index : indices)
+		{
+			if (time - timestamps[index] > VERTEXCACHE_FIFO_SIZE)
+			{
+				timestamps[index] = time++;
+				statistics.m_vertexTransforms++;
+			}
+
+			if (!referenced[index])
+			{
+				referenced[index] = 1;
+				statistics.m_vertexCount++;
+			}
+		}
+
+		return statistics;
+	}
+}
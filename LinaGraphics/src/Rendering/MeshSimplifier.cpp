@@ -0,0 +1,265 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/MeshSimplifier.hpp"
+#include <unordered_map>
+#include <string>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace LinaEngine::Graphics
+{
+	// Symmetric 4x4 error quadric, upper triangle stored row by row.
+	struct Quadric
+	{
+		double m_a[10] = { 0.0 };
+
+		void AddPlane(double nx, double ny, double nz, double d, double weight)
+		{
+			m_a[0] += weight * nx * nx; m_a[1] += weight * nx * ny; m_a[2] += weight * nx * nz; m_a[3] += weight * nx * d;
+			m_a[4] += weight * ny * ny; m_a[5] += weight * ny * nz; m_a[6] += weight * ny * d;
+			m_a[7] += weight * nz * nz; m_a[8] += weight * nz * d;
+			m_a[9] += weight * d * d;
+		}
+
+		void Add(const Quadric& other)
+		{
+			for (int i = 0; i < 10; i++)
+				m_a[i] += other.m_a[i];
+		}
+
+		double Evaluate(const float* p) const
+		{
+			const double x = p[0], y = p[1], z = p[2];
+			return m_a[0] * x * x + 2.0 * m_a[1] * x * y + 2.0 * m_a[2] * x * z + 2.0 * m_a[3] * x
+				+ m_a[4] * y * y + 2.0 * m_a[5] * y * z + 2.0 * m_a[6] * y
+				+ m_a[7] * z * z + 2.0 * m_a[8] * z
+				+ m_a[9];
+		}
+	};
+
+	struct Collapse
+	{
+		uint32 m_from;
+		uint32 m_to;
+		double m_cost;
+	};
+
+	static uint64 EdgeKey(uint32 a, uint32 b)
+	{
+		return a < b ? ((uint64)a << 32 | b) : ((uint64)b << 32 | a);
+	}
+
+	static void TriangleNormal(const float* p0, const float* p1, const float* p2, float* normal)
+	{
+		const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+		normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+		normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+	}
+
+	uint32 MeshSimplifier::Simplify(const float* positions, uint32 vertexCount, const uint32* indices, uint32 indexCount, uint32 targetIndexCount, float targetError, std::vector<uint32>& result)
+	{
+		result.assign(indices, indices + indexCount);
+		if (indexCount <= targetIndexCount || vertexCount == 0) return indexCount;
+
+		// Weld vertices by position, attribute copies of the same point share one quadric.
+		std::vector<uint32> weld(vertexCount);
+		std::vector<uint32> wedgeCounts;
+		{
+			std::unordered_map<std::string, uint32> positionMap;
+			positionMap.reserve(vertexCount);
+			for (uint32 v = 0; v < vertexCount; v++)
+			{
+				std::string key((const char*)&positions[v * 3], sizeof(float) * 3);
+				auto it = positionMap.emplace(key, (uint32)wedgeCounts.size());
+				if (it.second) wedgeCounts.push_back(0);
+				weld[v] = it.first->second;
+				wedgeCounts[weld[v]]++;
+			}
+		}
+
+		// Edges used by a single triangle are borders, their vertices never move. Neither do seam vertices.
+		std::vector<uint8> lockedPoints(wedgeCounts.size(), 0);
+		{
+			std::unordered_map<uint64, uint32> edgeCounts;
+			edgeCounts.reserve(indexCount);
+			for (uint32 i = 0; i < indexCount; i += 3)
+			{
+				for (int e = 0; e < 3; e++)
+					edgeCounts[EdgeKey(weld[indices[i + e]], weld[indices[i + (e + 1) % 3]])]++;
+			}
+
+			for (const auto& edge : edgeCounts)
+			{
+				if (edge.second != 1) continue;
+				lockedPoints[(uint32)(edge.first >> 32)] = 1;
+				lockedPoints[(uint32)(edge.first & 0xFFFFFFFF)] = 1;
+			}
+		}
+
+		std::vector<uint8> locked(vertexCount);
+		for (uint32 v = 0; v < vertexCount; v++)
+			locked[v] = lockedPoints[weld[v]] || wedgeCounts[weld[v]] > 1;
+
+		// Area weighted plane quadrics of the triangles around each point.
+		std::vector<Quadric> quadrics(wedgeCounts.size());
+		float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (uint32 v = 0; v < vertexCount; v++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				boundsMin[axis] = std::min(boundsMin[axis], positions[v * 3 + axis]);
+				boundsMax[axis] = std::max(boundsMax[axis], positions[v * 3 + axis]);
+			}
+		}
+
+		for (uint32 i = 0; i < indexCount; i += 3)
+		{
+			const float* p0 = &positions[indices[i] * 3];
+			float normal[3];
+			TriangleNormal(p0, &positions[indices[i + 1] * 3], &positions[indices[i + 2] * 3], normal);
+			const double length = std::sqrt((double)normal[0] * normal[0] + (double)normal[1] * normal[1] + (double)normal[2] * normal[2]);
+			if (length <= 0.0) continue;
+
+			const double nx = normal[0] / length, ny = normal[1] / length, nz = normal[2] / length;
+			const double d = -(nx * p0[0] + ny * p0[1] + nz * p0[2]);
+			for (int corner = 0; corner < 3; corner++)
+				quadrics[weld[indices[i + corner]]].AddPlane(nx, ny, nz, d, length * 0.5);
+		}
+
+		const double extent = std::sqrt((double)(boundsMax[0] - boundsMin[0]) * (boundsMax[0] - boundsMin[0]) + (double)(boundsMax[1] - boundsMin[1]) * (boundsMax[1] - boundsMin[1]) + (double)(boundsMax[2] - boundsMin[2]) * (boundsMax[2] - boundsMin[2]));
+		const double errorLimit = (targetError * extent) * (targetError * extent);
+
+		std::vector<uint32> remap(vertexCount);
+		std::vector<uint8> touched(vertexCount);
+		std::vector<uint32> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32> adjacency;
+		std::vector<Collapse> collapses;
+
+		// Each pass collapses the cheapest edges whose endpoints weren't touched yet in the pass.
+		while (result.size() > targetIndexCount)
+		{
+			const uint32 triangleCount = (uint32)result.size() / 3;
+
+			// Triangles around each vertex, used to reject collapses that flip faces.
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (uint32 index : result)
+				adjacencyOffsets[index + 1]++;
+			for (uint32 v = 0; v < vertexCount; v++)
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+			adjacency.resize(result.size());
+			std::vector<uint32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32 i = 0; i < (uint32)result.size(); i++)
+				adjacency[fill[result[i]]++] = i / 3;
+
+			collapses.clear();
+			for (uint32 i = 0; i < (uint32)result.size(); i += 3)
+			{
+				for (int e = 0; e < 3; e++)
+				{
+					const uint32 a = result[i + e], b = result[i + (e + 1) % 3];
+					if (!locked[a]) collapses.push_back({ a, b, quadrics[weld[a]].Evaluate(&positions[b * 3]) + quadrics[weld[b]].Evaluate(&positions[b * 3]) });
+					if (!locked[b]) collapses.push_back({ b, a, quadrics[weld[a]].Evaluate(&positions[a * 3]) + quadrics[weld[b]].Evaluate(&positions[a * 3]) });
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& x, const Collapse& y) { return x.m_cost < y.m_cost; });
+
+			for (uint32 v = 0; v < vertexCount; v++)
+				remap[v] = v;
+			std::fill(touched.begin(), touched.end(), 0);
+
+			uint32 remainingIndices = (uint32)result.size();
+			uint32 collapseCount = 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (remainingIndices <= targetIndexCount || collapse.m_cost > errorLimit) break;
+				if (touched[collapse.m_from] || touched[collapse.m_to]) continue;
+
+				// Triangles that keep their area must not turn around.
+				bool flips = false;
+				uint32 removedTriangles = 0;
+				const float* target = &positions[collapse.m_to * 3];
+
+				for (uint32 t = adjacencyOffsets[collapse.m_from]; t < adjacencyOffsets[collapse.m_from + 1] && !flips; t++)
+				{
+					const uint32 triangle = adjacency[t];
+					uint32 corners[3] = { remap[result[triangle * 3]], remap[result[triangle * 3 + 1]], remap[result[triangle * 3 + 2]] };
+					if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) continue;
+
+					if (corners[0] == collapse.m_to || corners[1] == collapse.m_to || corners[2] == collapse.m_to)
+					{
+						removedTriangles++;
+						continue;
+					}
+
+					const float* before[3] = { &positions[corners[0] * 3], &positions[corners[1] * 3], &positions[corners[2] * 3] };
+					const float* after[3] = { before[0], before[1], before[2] };
+					for (int corner = 0; corner < 3; corner++)
+						if (corners[corner] == collapse.m_from) after[corner] = target;
+
+					float normalBefore[3], normalAfter[3];
+					TriangleNormal(before[0], before[1], before[2], normalBefore);
+					TriangleNormal(after[0], after[1], after[2], normalAfter);
+					flips = normalBefore[0] * normalAfter[0] + normalBefore[1] * normalAfter[1] + normalBefore[2] * normalAfter[2] <= 0.0f;
+				}
+
+				if (flips) continue;
+
+				remap[collapse.m_from] = collapse.m_to;
+				touched[collapse.m_from] = touched[collapse.m_to] = 1;
+				quadrics[weld[collapse.m_to]].Add(quadrics[weld[collapse.m_from]]);
+				remainingIndices -= removedTriangles * 3;
+				collapseCount++;
+			}
+
+			if (collapseCount == 0) break;
+
+			// Apply the collapses & drop the triangles that became degenerate.
+			uint32 writeIndex = 0;
+			for (uint32 i = 0; i < triangleCount * 3; i += 3)
+			{
+				const uint32 a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+				if (a == b || b == c || a == c) continue;
+
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+
+			result.resize(writeIndex);
+		}
+
+		return (uint32)result.size();
+	}
+}
@@ -80,8 +80,7 @@ namespace LinaEngine::Graphics
 			//currentModel.AllocateElement(3, false); // Joint IDs
 			//currentModel.AllocateElement(3, true); // Weights
 			currentModel.SetStartIndex(5); // Begin instanced data
-			currentModel.AllocateElement(16, true); // Model Matrix
-			currentModel.AllocateElement(16, true); // Inverse transpose matrix
+			currentModel.AllocateInstanceTransform(); // Model transform
 
 			const aiVector3D aiZeroVector(0.0f, 0.0f, 0.0f);
 
@@ -164,8 +163,7 @@ namespace LinaEngine::Graphics
 			currentModel.AllocateElement(3, true); // Tangents
 			currentModel.AllocateElement(3, true); // Bitangents
 			currentModel.SetStartIndex(5); // Begin instanced data
-			currentModel.AllocateElement(16, true); // Model Matrix
-			currentModel.AllocateElement(16, true); // Inverse transpose matrix
+			currentModel.AllocateInstanceTransform(); // Model transform
 
 
 			const aiVector3D aiZeroVector(0.0f, 0.0f, 0.0f);
@@ -227,8 +225,7 @@ namespace LinaEngine::Graphics
 		currentModel.AllocateElement(3, true); // Positions
 		currentModel.AllocateElement(2, true); // TexCoords
 		currentModel.SetStartIndex(2); // Begin instanced data
-		currentModel.AllocateElement(16, true); // Model Matrix
-		currentModel.AllocateElement(16, true); // Inverse transpose matrix
+		currentModel.AllocateInstanceTransform(); // Model transform
 
 		Vector3 vertices[] = {
 			Vector3(-0.5f, 0.5f, 0.0f),  // left top, id 0
@@ -276,8 +273,7 @@ namespace LinaEngine::Graphics
 		currentModel.AllocateElement(3, true); // Normals
 		currentModel.AllocateElement(3, true); // Tangents
 		currentModel.SetStartIndex(4); // Begin instanced data
-		currentModel.AllocateElement(16, true); // Model Matrix
-		currentModel.AllocateElement(16, true); // Inverse transpose matrix
+		currentModel.AllocateInstanceTransform(); // Model transform
 
 
 		const aiVector3D aiZeroVector(0.0f, 0.0f, 0.0f);
@@ -0,0 +1,292 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/OcclusionBuffer.hpp"
+#include "PackageManager/PAMSIMD.hpp"
+#include <algorithm>
+
+namespace LinaEngine::Graphics
+{
+#define OCCLUSION_TILES_X (OCCLUSION_BUFFER_WIDTH / OCCLUSION_TILE_SIZE)
+#define OCCLUSION_TILES_Y (OCCLUSION_BUFFER_HEIGHT / OCCLUSION_TILE_SIZE)
+#define OCCLUSION_MIN_W 1e-4f
+
+	// GLOBALS DECLARATIONS
+	static const float* EdgeOrigin(const float* a, const float* b);
+
+	OcclusionBuffer::OcclusionBuffer()
+	{
+		m_depth.resize(OCCLUSION_BUFFER_WIDTH * OCCLUSION_BUFFER_HEIGHT, 1.0f);
+		m_tileMaxDepth.resize(OCCLUSION_TILES_X * OCCLUSION_TILES_Y, 1.0f);
+	}
+
+	void OcclusionBuffer::Clear(const Matrix& viewProjection)
+	{
+		m_viewProjection = viewProjection;
+		m_triangleCount = 0;
+		std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+		std::fill(m_tileMaxDepth.begin(), m_tileMaxDepth.end(), 1.0f);
+	}
+
+	void OcclusionBuffer::RasterizeMesh(const Matrix& model, const float* positions, uint32 vertexCount, const uint32* indices, uint32 indexCount)
+	{
+		const glm::mat4 modelViewProjection = glm::mat4(m_viewProjection) * glm::mat4(model);
+		m_screenVertices.resize(vertexCount * 3);
+		m_vertexClipped.resize(vertexCount);
+
+		// Project the vertices once, anything in front of the near plane can't be rasterized safely so its triangles are skipped.
+		for (uint32 i = 0; i < vertexCount; i++)
+		{
+			const glm::vec4 clip = modelViewProjection * glm::vec4(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 1.0f);
+			m_vertexClipped[i] = clip.w < OCCLUSION_MIN_W || clip.z < -clip.w;
+			if (m_vertexClipped[i]) continue;
+
+			const float invW = 1.0f / clip.w;
+			m_screenVertices[i * 3] = (clip.x * invW * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH;
+			m_screenVertices[i * 3 + 1] = (clip.y * invW * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT;
+			m_screenVertices[i * 3 + 2] = clip.z * invW * 0.5f + 0.5f;
+		}
+
+		for (uint32 i = 0; i + 2 < indexCount; i += 3)
+		{
+			const uint32 i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+			if (m_vertexClipped[i0] || m_vertexClipped[i1] || m_vertexClipped[i2]) continue;
+			RasterizeTriangle(&m_screenVertices[i0 * 3], &m_screenVertices[i1 * 3], &m_screenVertices[i2 * 3]);
+		}
+	}
+
+	void OcclusionBuffer::RasterizeTriangle(const float* v0, const float* v1, const float* v2)
+	{
+		float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v1[1] - v0[1]) * (v2[0] - v0[0]);
+
+		// Both windings are rasterized so that single sided geometry like walls & planes occlude from behind too.
+		if (area < 0.0f)
+		{
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		if (area < 1e-6f) return;
+
+		const int minX = glm::max(0, (int)glm::min(v0[0], glm::min(v1[0], v2[0])));
+		const int maxX = glm::min(OCCLUSION_BUFFER_WIDTH - 1, (int)glm::max(v0[0], glm::max(v1[0], v2[0])));
+		const int minY = glm::max(0, (int)glm::min(v0[1], glm::min(v1[1], v2[1])));
+		const int maxY = glm::min(OCCLUSION_BUFFER_HEIGHT - 1, (int)glm::max(v0[1], glm::max(v1[1], v2[1])));
+		if (minX > maxX || minY > maxY) return;
+
+		m_triangleCount++;
+
+		// Edge functions are positive inside, each one is the barycentric weight of the opposite vertex scaled by area.
+		const float a01 = v0[1] - v1[1], b01 = v1[0] - v0[0], c01 = -(a01 * v0[0] + b01 * v0[1]);
+		const float a12 = v1[1] - v2[1], b12 = v2[0] - v1[0], c12 = -(a12 * v1[0] + b12 * v1[1]);
+		const float a20 = v2[1] - v0[1], b20 = v0[0] - v2[0], c20 = -(a20 * v2[0] + b20 * v2[1]);
+
+		// Coverage evaluates every edge from the same endpoint no matter which triangle it belongs to, so a shared edge gives exactly
+		// negated values on both sides & pixel centers lying on it can't fall through a rounding crack between the two triangles.
+		const float* o01 = EdgeOrigin(v0, v1);
+		const float* o12 = EdgeOrigin(v1, v2);
+		const float* o20 = EdgeOrigin(v2, v0);
+
+		// Depth is linear in screen space after the perspective divide.
+		const float invArea = 1.0f / area;
+		const float zA = (a12 * v0[2] + a20 * v1[2] + a01 * v2[2]) * invArea;
+		const float zB = (b12 * v0[2] + b20 * v1[2] + b01 * v2[2]) * invArea;
+		const float zC = (c12 * v0[2] + c20 * v1[2] + c01 * v2[2]) * invArea;
+
+		// Rows are processed in aligned blocks of four pixels, the buffer width is a multiple of four.
+		const int startX = minX & ~3;
+
+#ifdef LINA_SIMD_SSE
+		const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			const float py = (float)y + 0.5f;
+			const __m128 rowE01 = _mm_set1_ps(b01 * (py - o01[1])), rowE12 = _mm_set1_ps(b12 * (py - o12[1])), rowE20 = _mm_set1_ps(b20 * (py - o20[1]));
+			const __m128 rowZ = _mm_set1_ps(zB * py + zC);
+			float* row = &m_depth[y * OCCLUSION_BUFFER_WIDTH];
+
+			for (int x = startX; x <= maxX; x += 4)
+			{
+				const __m128 px = _mm_add_ps(_mm_set1_ps((float)x), laneOffsets);
+				const __m128 e01 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a01), _mm_sub_ps(px, _mm_set1_ps(o01[0]))), rowE01);
+				const __m128 e12 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a12), _mm_sub_ps(px, _mm_set1_ps(o12[0]))), rowE12);
+				const __m128 e20 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a20), _mm_sub_ps(px, _mm_set1_ps(o20[0]))), rowE20);
+				const __m128 inside = _mm_and_ps(_mm_cmpge_ps(e01, zero), _mm_and_ps(_mm_cmpge_ps(e12, zero), _mm_cmpge_ps(e20, zero)));
+				if (_mm_movemask_ps(inside) == 0) continue;
+
+				const __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(zA), px), rowZ);
+				const __m128 depth = _mm_loadu_ps(row + x);
+				const __m128 closest = _mm_min_ps(depth, z);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest), _mm_andnot_ps(inside, depth)));
+			}
+		}
+#else
+		for (int y = minY; y <= maxY; y++)
+		{
+			const float py = (float)y + 0.5f;
+			float* row = &m_depth[y * OCCLUSION_BUFFER_WIDTH];
+
+			for (int x = startX; x < startX + ((maxX - startX) / 4 + 1) * 4; x++)
+			{
+				const float px = (float)x + 0.5f;
+				if (a01 * (px - o01[0]) + b01 * (py - o01[1]) < 0.0f || a12 * (px - o12[0]) + b12 * (py - o12[1]) < 0.0f || a20 * (px - o20[0]) + b20 * (py - o20[1]) < 0.0f) continue;
+
+				const float z = zA * px + zB * py + zC;
+				row[x] = glm::min(row[x], z);
+			}
+		}
+#endif
+	}
+
+	void OcclusionBuffer::BuildHierarchy()
+	{
+		// Each tile keeps its farthest depth, an occludee behind it is hidden in the whole tile.
+		for (int ty = 0; ty < OCCLUSION_TILES_Y; ty++)
+		{
+			for (int tx = 0; tx < OCCLUSION_TILES_X; tx++)
+			{
+				const float* tile = &m_depth[ty * OCCLUSION_TILE_SIZE * OCCLUSION_BUFFER_WIDTH + tx * OCCLUSION_TILE_SIZE];
+
+#ifdef LINA_SIMD_SSE
+				__m128 maxDepth = _mm_setzero_ps();
+				for (int y = 0; y < OCCLUSION_TILE_SIZE; y++)
+				{
+					const float* row = tile + y * OCCLUSION_BUFFER_WIDTH;
+					for (int x = 0; x < OCCLUSION_TILE_SIZE; x += 4)
+						maxDepth = _mm_max_ps(maxDepth, _mm_loadu_ps(row + x));
+				}
+
+				maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, _MM_SHUFFLE(2, 3, 0, 1)));
+				maxDepth = _mm_max_ps(maxDepth, _mm_shuffle_ps(maxDepth, maxDepth, _MM_SHUFFLE(1, 0, 3, 2)));
+				m_tileMaxDepth[ty * OCCLUSION_TILES_X + tx] = _mm_cvtss_f32(maxDepth);
+#else
+				float maxDepth = 0.0f;
+				for (int y = 0; y < OCCLUSION_TILE_SIZE; y++)
+				{
+					for (int x = 0; x < OCCLUSION_TILE_SIZE; x++)
+						maxDepth = glm::max(maxDepth, tile[y * OCCLUSION_BUFFER_WIDTH + x]);
+				}
+
+				m_tileMaxDepth[ty * OCCLUSION_TILES_X + tx] = maxDepth;
+#endif
+			}
+		}
+	}
+
+	bool OcclusionBuffer::IsVisible(const AABB& worldBounds) const
+	{
+		float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minDepth = FLT_MAX;
+		const glm::mat4 viewProjection = glm::mat4(m_viewProjection);
+
+		// Project the corners, boxes crossing the near plane are always visible.
+		for (int i = 0; i < 8; i++)
+		{
+			const glm::vec4 corner((i & 1) ? worldBounds.m_boundsMax.x : worldBounds.m_boundsMin.x, (i & 2) ? worldBounds.m_boundsMax.y : worldBounds.m_boundsMin.y, (i & 4) ? worldBounds.m_boundsMax.z : worldBounds.m_boundsMin.z, 1.0f);
+			const glm::vec4 clip = viewProjection * corner;
+			if (clip.w < OCCLUSION_MIN_W || clip.z < -clip.w) return true;
+
+			const float invW = 1.0f / clip.w;
+			const float x = (clip.x * invW * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH;
+			const float y = (clip.y * invW * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT;
+			minX = glm::min(minX, x);
+			maxX = glm::max(maxX, x);
+			minY = glm::min(minY, y);
+			maxY = glm::max(maxY, y);
+			minDepth = glm::min(minDepth, clip.z * invW * 0.5f + 0.5f);
+		}
+
+		if (maxX < 0.0f || maxY < 0.0f || minX >= (float)OCCLUSION_BUFFER_WIDTH || minY >= (float)OCCLUSION_BUFFER_HEIGHT)
+			return false;
+
+		const int x0 = glm::max(0, (int)minX), x1 = glm::min(OCCLUSION_BUFFER_WIDTH - 1, (int)maxX);
+		const int y0 = glm::max(0, (int)minY), y1 = glm::min(OCCLUSION_BUFFER_HEIGHT - 1, (int)maxY);
+
+		for (int ty = y0 / OCCLUSION_TILE_SIZE; ty <= y1 / OCCLUSION_TILE_SIZE; ty++)
+		{
+			for (int tx = x0 / OCCLUSION_TILE_SIZE; tx <= x1 / OCCLUSION_TILE_SIZE; tx++)
+			{
+				// Closest point of the box is behind every occluder pixel in this tile.
+				if (m_tileMaxDepth[ty * OCCLUSION_TILES_X + tx] < minDepth) continue;
+
+				const int rowStart = glm::max(y0, ty * OCCLUSION_TILE_SIZE), rowEnd = glm::min(y1, ty * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1);
+				const int colStart = glm::max(x0, tx * OCCLUSION_TILE_SIZE), colEnd = glm::min(x1, tx * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1);
+
+				for (int y = rowStart; y <= rowEnd; y++)
+				{
+					const float* row = &m_depth[y * OCCLUSION_BUFFER_WIDTH];
+
+#ifdef LINA_SIMD_SSE
+					const __m128 boxDepth = _mm_set1_ps(minDepth);
+					for (int x = colStart & ~3; x <= colEnd; x += 4)
+					{
+						int lanes = _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth));
+
+						// Mask out the lanes outside of the projected rectangle.
+						for (int i = 0; i < 4; i++)
+						{
+							if (x + i < colStart || x + i > colEnd)
+								lanes &= ~(1 << i);
+						}
+
+						if (lanes != 0) return true;
+					}
+#else
+					for (int x = colStart; x <= colEnd; x++)
+					{
+						if (row[x] >= minDepth) return true;
+					}
+#endif
+				}
+			}
+		}
+
+		return false;
+	}
+
+	void OcclusionBuffer::GetDebugImage(std::vector<uint8>& pixels) const
+	{
+		pixels.resize(m_depth.size() * 4);
+
+		// Post projection depth is packed close to 1, raise it to spread the visible range.
+		for (size_t i = 0; i < m_depth.size(); i++)
+		{
+			const uint8 value = (uint8)(glm::clamp(1.0f - glm::pow(m_depth[i], 64.0f), 0.0f, 1.0f) * 255.0f);
+			pixels[i * 4] = pixels[i * 4 + 1] = pixels[i * 4 + 2] = value;
+			pixels[i * 4 + 3] = 255;
+		}
+	}
+
+	static const float* EdgeOrigin(const float* a, const float* b)
+	{
+		// Orders the endpoints the same way regardless of the edge direction.
+		if (a[1] != b[1]) return a[1] < b[1] ? a : b;
+		return a[0] <= b[0] ? a : b;
+	}
+}
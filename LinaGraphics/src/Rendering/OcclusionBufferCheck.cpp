@@ -0,0 +1,113 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/OcclusionBufferCheck.hpp"
+#include "Rendering/OcclusionBuffer.hpp"
+#include "Utility/Log.hpp"
+
+// Wall half size & distance in front of the camera, the camera looks down +Z from the origin.
+#define OCCLUSIONCHECK_WALL_EXTENT 2.0f
+#define OCCLUSIONCHECK_WALL_DISTANCE 10.0f
+
+namespace LinaEngine::Graphics
+{
+	std::vector<OcclusionBufferCheckResult> OcclusionBufferCheck::Run()
+	{
+		std::vector<OcclusionBufferCheckResult> results;
+		auto check = [&](const char* name, bool passed)
+		{
+			OcclusionBufferCheckResult& result = results.emplace_back();
+			result.m_name = name;
+			result.m_passed = passed;
+		};
+
+		// Same projection & view setup as the camera system.
+		const Matrix projection = Matrix::Perspective(45.0f, 2.0f, 0.1f, 100.0f);
+		const Matrix view = Matrix::InitLookAt(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 1.0f, 0.0f));
+		const Matrix viewProjection = projection * view;
+
+		OcclusionBuffer buffer;
+		buffer.Clear(viewProjection);
+		buffer.BuildHierarchy();
+		check("Empty buffer hides nothing", buffer.IsVisible(AABB(Vector3(-1.0f, -1.0f, 19.0f), Vector3(1.0f, 1.0f, 21.0f))));
+
+		// A single quad wall facing the camera, both windings so culling conventions don't matter. Its diagonal runs through the
+		// screen center, so the hidden box also catches cracks between the two triangles.
+		const float e = OCCLUSIONCHECK_WALL_EXTENT;
+		const float d = OCCLUSIONCHECK_WALL_DISTANCE;
+		const float positions[] = { -e, -e, d,  e, -e, d,  e, e, d,  -e, e, d };
+		const uint32 indices[] = { 0, 1, 2, 0, 2, 3, 0, 2, 1, 0, 3, 2 };
+
+		buffer.Clear(viewProjection);
+		buffer.RasterizeMesh(Matrix::Identity(), positions, 4, indices, 12);
+		buffer.BuildHierarchy();
+		check("Wall triangles are rasterized", buffer.GetTriangleCount() > 0);
+
+		const AABB hidden(Vector3(-1.0f, -1.0f, d + 9.0f), Vector3(1.0f, 1.0f, d + 11.0f));
+		const AABB inFront(Vector3(-1.0f, -1.0f, d - 6.0f), Vector3(1.0f, 1.0f, d - 4.0f));
+		// The wall edge projects to twice its extent at twice the distance, these boxes sit right of & across that edge.
+		const AABB besideWall(Vector3(e * 3.0f, -1.0f, d + 9.0f), Vector3(e * 4.0f, 1.0f, d + 11.0f));
+		const AABB acrossEdge(Vector3(e, -1.0f, d + 9.0f), Vector3(e * 3.0f, 1.0f, d + 11.0f));
+		const AABB throughWall(Vector3(-1.0f, -1.0f, d - 1.0f), Vector3(1.0f, 1.0f, d + 1.0f));
+
+		check("Box behind the wall is hidden", !buffer.IsVisible(hidden));
+		check("Box in front of the wall is visible", buffer.IsVisible(inFront));
+		check("Box beside the wall is visible", buffer.IsVisible(besideWall));
+		check("Box across the wall edge is visible", buffer.IsVisible(acrossEdge));
+		check("Box through the wall is visible", buffer.IsVisible(throughWall));
+
+		// Moving the camera behind the wall exposes the box again.
+		buffer.Clear(projection * Matrix::InitLookAt(Vector3(0.0f, 0.0f, d + 2.0f), Vector3(0.0f, 0.0f, d + 3.0f), Vector3(0.0f, 1.0f, 0.0f)));
+		buffer.RasterizeMesh(Matrix::Identity(), positions, 4, indices, 12);
+		buffer.BuildHierarchy();
+		check("Wall behind the camera hides nothing", buffer.IsVisible(hidden));
+
+		return results;
+	}
+
+	bool OcclusionBufferCheck::LogResults(const std::vector<OcclusionBufferCheckResult>& results)
+	{
+		bool allPassed = true;
+
+		for (const OcclusionBufferCheckResult& result : results)
+		{
+			if (result.m_passed)
+			{
+				LINA_CORE_TRACE("[Occlusion Check] Passed: {0}", result.m_name);
+			}
+			else
+			{
+				LINA_CORE_ERR("[Occlusion Check] Failed: {0}", result.m_name);
+			}
+
+			allPassed = allPassed && result.m_passed;
+		}
+
+		return allPassed;
+	}
+}
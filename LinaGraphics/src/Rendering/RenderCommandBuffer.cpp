@@ -0,0 +1,427 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderCommandBuffer.hpp"
+#include "Rendering/RingBuffer.hpp"
+#include "PackageManager/Generic/GenericMemory.hpp"
+
+namespace LinaEngine::Graphics
+{
+	void RenderCommandBuffer::Reset()
+	{
+		m_data.clear();
+		m_commandCount = m_streamCount = 0;
+		m_drawCount = m_indirectDrawCount = 0;
+	}
+
+	void RenderCommandBuffer::Execute(RenderDevice& device, RingBuffer& ringBuffer)
+	{
+		m_streamOffsets.clear();
+		m_streamData.clear();
+
+		uintptr position = 0;
+		while (position < m_data.size())
+		{
+			const RenderCommandHeader& header = *(const RenderCommandHeader*)&m_data[position];
+			const uint8* payload = &m_data[position + sizeof(RenderCommandHeader)];
+			position += header.m_size;
+
+			switch (header.m_op)
+			{
+			case RenderCommandOp::SetShader:
+				device.SetShader(((const RenderCommandHandle*)payload)->m_id);
+				break;
+
+			case RenderCommandOp::SetFrameBuffer:
+				device.SetFBO(((const RenderCommandHandle*)payload)->m_id);
+				break;
+
+			case RenderCommandOp::SetViewport:
+			{
+				const RenderCommandViewport& command = *(const RenderCommandViewport*)payload;
+				device.SetViewport(command.m_pos, command.m_size);
+				break;
+			}
+
+			case RenderCommandOp::SetDrawParameters:
+				device.SetDrawParameters(*(const DrawParams*)payload);
+				break;
+
+			case RenderCommandOp::Clear:
+			{
+				const RenderCommandClear& command = *(const RenderCommandClear*)payload;
+				device.Clear(command.m_clearColor, command.m_clearDepth, command.m_clearStencil, command.m_color, command.m_stencil);
+				break;
+			}
+
+			case RenderCommandOp::BlitFrameBuffers:
+			{
+				const RenderCommandBlit& command = *(const RenderCommandBlit*)payload;
+				device.BlitFrameBuffers(command.m_readFBO, command.m_readWidth, command.m_readHeight, command.m_writeFBO, command.m_writeWidth, command.m_writeHeight, command.m_mask, command.m_filter);
+				break;
+			}
+
+			case RenderCommandOp::SetTexture:
+			{
+				const RenderCommandTexture& command = *(const RenderCommandTexture*)payload;
+				device.SetTexture(command.m_texture, command.m_sampler, command.m_unit, command.m_bindMode, command.m_setSampler);
+				break;
+			}
+
+			case RenderCommandOp::UniformInt:
+			case RenderCommandOp::UniformFloat:
+			case RenderCommandOp::UniformVector2:
+			case RenderCommandOp::UniformVector3:
+			case RenderCommandOp::UniformVector4:
+			case RenderCommandOp::UniformColor:
+			case RenderCommandOp::UniformMatrix:
+			{
+				// Values are copied out as they aren't aligned, the name string keeps its capacity between commands.
+				const RenderCommandUniform& command = *(const RenderCommandUniform*)payload;
+				const uint8* value = payload + sizeof(RenderCommandUniform);
+				m_uniformName.assign((const char*)(value + command.m_valueSize), command.m_nameSize);
+				float data[16];
+				GenericMemory::memcpy(data, value, command.m_valueSize);
+
+				if (header.m_op == RenderCommandOp::UniformInt)
+				{
+					int intValue = 0;
+					GenericMemory::memcpy(&intValue, value, sizeof(int));
+					device.UpdateShaderUniformInt(command.m_shader, m_uniformName, intValue);
+				}
+				else if (header.m_op == RenderCommandOp::UniformFloat)
+					device.UpdateShaderUniformFloat(command.m_shader, m_uniformName, data[0]);
+				else if (header.m_op == RenderCommandOp::UniformVector2)
+					device.UpdateShaderUniformVector2(command.m_shader, m_uniformName, Vector2(data[0], data[1]));
+				else if (header.m_op == RenderCommandOp::UniformVector3)
+					device.UpdateShaderUniformVector3(command.m_shader, m_uniformName, Vector3(data[0], data[1], data[2]));
+				else if (header.m_op == RenderCommandOp::UniformVector4)
+					device.UpdateShaderUniformVector4F(command.m_shader, m_uniformName, Vector4(data[0], data[1], data[2], data[3]));
+				else if (header.m_op == RenderCommandOp::UniformColor)
+					device.UpdateShaderUniformColor(command.m_shader, m_uniformName, Color(data[0], data[1], data[2], data[3]));
+				else
+					device.UpdateShaderUniformMatrix(command.m_shader, m_uniformName, (void*)data);
+				break;
+			}
+
+			case RenderCommandOp::UploadStream:
+			{
+				// Offset stays invalid if the ring is full, users of the stream upload the recorded data themselves then.
+				const RenderCommandUpload& command = *(const RenderCommandUpload*)payload;
+				const uint8* data = payload + sizeof(RenderCommandUpload);
+				m_streamOffsets.push_back(ringBuffer.Write(data, command.m_dataSize));
+				m_streamData.push_back(data);
+				break;
+			}
+
+			case RenderCommandOp::BindInstanceStream:
+			{
+				const RenderCommandInstanceStream& command = *(const RenderCommandInstanceStream*)payload;
+				const uintptr streamOffset = m_streamOffsets[command.m_stream];
+
+				if (streamOffset != RINGBUFFER_INVALID_OFFSET)
+					device.SetVertexArrayInstanceBuffer(command.m_vertexArray, command.m_bufferIndex, ringBuffer.GetID(), streamOffset + command.m_offset);
+				else
+					device.UpdateVertexArrayBuffer(command.m_vertexArray, command.m_bufferIndex, m_streamData[command.m_stream] + command.m_offset, command.m_dataSize);
+				break;
+			}
+
+			case RenderCommandOp::SetSpriteBatchStream:
+			{
+				const RenderCommandSpriteStream& command = *(const RenderCommandSpriteStream*)payload;
+				const uintptr streamOffset = m_streamOffsets[command.m_stream];
+
+				if (streamOffset != RINGBUFFER_INVALID_OFFSET)
+					device.SetSpriteBatchVertexSource(command.m_vertexArray, ringBuffer.GetID(), streamOffset);
+				else
+				{
+					// Ring is full this frame, orphan & refill the fallback buffer.
+					const RenderCommandUpload& stream = *(const RenderCommandUpload*)(m_streamData[command.m_stream] - sizeof(RenderCommandUpload));
+					device.OrphanRingBuffer(command.m_fallbackBuffer, command.m_fallbackSize);
+					device.WriteRingBuffer(command.m_fallbackBuffer, 0, m_streamData[command.m_stream], stream.m_dataSize);
+					device.SetSpriteBatchVertexSource(command.m_vertexArray, command.m_fallbackBuffer, 0);
+				}
+				break;
+			}
+
+			case RenderCommandOp::Draw:
+			{
+				const RenderCommandDraw& command = *(const RenderCommandDraw*)payload;
+				device.Draw(command.m_vertexArray, command.m_params, command.m_numInstances, command.m_numElements, command.m_drawArrays);
+				break;
+			}
+
+			case RenderCommandOp::DrawBaseVertex:
+			{
+				const RenderCommandDraw& command = *(const RenderCommandDraw*)payload;
+				device.DrawBaseVertex(command.m_vertexArray, command.m_params, command.m_numElements, command.m_baseVertex);
+				break;
+			}
+
+			case RenderCommandOp::DrawInstancedBaseVertex:
+			{
+				const RenderCommandDraw& command = *(const RenderCommandDraw*)payload;
+				device.DrawInstancedBaseVertex(command.m_vertexArray, command.m_params, command.m_numInstances, command.m_numElements, command.m_firstIndex, command.m_baseVertex);
+				break;
+			}
+
+			case RenderCommandOp::MultiDrawIndirect:
+			{
+				const RenderCommandMultiDraw& command = *(const RenderCommandMultiDraw*)payload;
+				const DrawElementsIndirectCommand* indirect = (const DrawElementsIndirectCommand*)(payload + sizeof(RenderCommandMultiDraw));
+				const uintptr streamOffset = m_streamOffsets[command.m_stream];
+				uintptr indirectOffset = RINGBUFFER_INVALID_OFFSET;
+
+				if (streamOffset != RINGBUFFER_INVALID_OFFSET)
+					indirectOffset = ringBuffer.Write(indirect, command.m_drawCount * sizeof(DrawElementsIndirectCommand));
+
+				if (indirectOffset != RINGBUFFER_INVALID_OFFSET)
+				{
+					device.SetVertexArrayInstanceBuffer(command.m_vertexArray, command.m_bufferIndex, ringBuffer.GetID(), streamOffset);
+					device.MultiDrawIndirect(command.m_vertexArray, command.m_params, ringBuffer.GetID(), indirectOffset, command.m_drawCount);
+					break;
+				}
+
+				// Ring is full, draw the commands one by one with their own instance ranges.
+				for (uint32 i = 0; i < command.m_drawCount; i++)
+				{
+					const DrawElementsIndirectCommand& draw = indirect[i];
+					const uintptr instanceOffset = (uintptr)draw.m_baseInstance * command.m_instanceStride;
+
+					if (streamOffset != RINGBUFFER_INVALID_OFFSET)
+						device.SetVertexArrayInstanceBuffer(command.m_vertexArray, command.m_bufferIndex, ringBuffer.GetID(), streamOffset + instanceOffset);
+					else
+						device.UpdateVertexArrayBuffer(command.m_vertexArray, command.m_bufferIndex, m_streamData[command.m_stream] + instanceOffset, (uintptr)draw.m_instanceCount * command.m_instanceStride);
+
+					device.DrawInstancedBaseVertex(command.m_vertexArray, command.m_params, draw.m_instanceCount, draw.m_count, draw.m_firstIndex, (uint32)draw.m_baseVertex);
+				}
+				break;
+			}
+			}
+		}
+	}
+
+	void RenderCommandBuffer::SetShader(uint32 shader)
+	{
+		Push<RenderCommandHandle>(RenderCommandOp::SetShader)->m_id = shader;
+	}
+
+	void RenderCommandBuffer::SetFBO(uint32 fbo)
+	{
+		Push<RenderCommandHandle>(RenderCommandOp::SetFrameBuffer)->m_id = fbo;
+	}
+
+	void RenderCommandBuffer::SetViewport(const Vector2& pos, const Vector2& size)
+	{
+		RenderCommandViewport* command = Push<RenderCommandViewport>(RenderCommandOp::SetViewport);
+		command->m_pos = pos;
+		command->m_size = size;
+	}
+
+	void RenderCommandBuffer::SetDrawParameters(const DrawParams& drawParams)
+	{
+		*Push<DrawParams>(RenderCommandOp::SetDrawParameters) = drawParams;
+	}
+
+	void RenderCommandBuffer::Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const Color& color, uint32 stencil)
+	{
+		RenderCommandClear* command = Push<RenderCommandClear>(RenderCommandOp::Clear);
+		command->m_color = color;
+		command->m_stencil = stencil;
+		command->m_clearColor = shouldClearColor;
+		command->m_clearDepth = shouldClearDepth;
+		command->m_clearStencil = shouldClearStencil;
+	}
+
+	void RenderCommandBuffer::BlitFrameBuffers(uint32 readFBO, uint32 readWidth, uint32 readHeight, uint32 writeFBO, uint32 writeWidth, uint32 writeHeight, BufferBit mask, SamplerFilter filter)
+	{
+		RenderCommandBlit* command = Push<RenderCommandBlit>(RenderCommandOp::BlitFrameBuffers);
+		command->m_readFBO = readFBO;
+		command->m_readWidth = readWidth;
+		command->m_readHeight = readHeight;
+		command->m_writeFBO = writeFBO;
+		command->m_writeWidth = writeWidth;
+		command->m_writeHeight = writeHeight;
+		command->m_mask = mask;
+		command->m_filter = filter;
+	}
+
+	void RenderCommandBuffer::SetTexture(uint32 texture, uint32 sampler, uint32 unit, TextureBindMode bindTextureMode, bool setSampler)
+	{
+		RenderCommandTexture* command = Push<RenderCommandTexture>(RenderCommandOp::SetTexture);
+		command->m_texture = texture;
+		command->m_sampler = sampler;
+		command->m_unit = unit;
+		command->m_bindMode = bindTextureMode;
+		command->m_setSampler = setSampler;
+	}
+
+	void RenderCommandBuffer::UpdateShaderUniformInt(uint32 shader, const std::string& uniform, int value)
+	{
+		PushUniform(RenderCommandOp::UniformInt, shader, uniform, &value, sizeof(int));
+	}
+
+	void RenderCommandBuffer::UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, float value)
+	{
+		PushUniform(RenderCommandOp::UniformFloat, shader, uniform, &value, sizeof(float));
+	}
+
+	void RenderCommandBuffer::UpdateShaderUniformVector2(uint32 shader, const std::string& uniform, const Vector2& value)
+	{
+		const float data[2] = { value.x, value.y };
+		PushUniform(RenderCommandOp::UniformVector2, shader, uniform, data, sizeof(data));
+	}
+
+	void RenderCommandBuffer::UpdateShaderUniformVector3(uint32 shader, const std::string& uniform, const Vector3& value)
+	{
+		const float data[3] = { value.x, value.y, value.z };
+		PushUniform(RenderCommandOp::UniformVector3, shader, uniform, data, sizeof(data));
+	}
+
+	void RenderCommandBuffer::UpdateShaderUniformVector4F(uint32 shader, const std::string& uniform, const Vector4& value)
+	{
+		const float data[4] = { value.x, value.y, value.z, value.w };
+		PushUniform(RenderCommandOp::UniformVector4, shader, uniform, data, sizeof(data));
+	}
+
+	void RenderCommandBuffer::UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& value)
+	{
+		const float data[4] = { value.r, value.g, value.b, value.a };
+		PushUniform(RenderCommandOp::UniformColor, shader, uniform, data, sizeof(data));
+	}
+
+	void RenderCommandBuffer::UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, const Matrix& value)
+	{
+		PushUniform(RenderCommandOp::UniformMatrix, shader, uniform, &value[0][0], sizeof(float) * 16);
+	}
+
+	uint32 RenderCommandBuffer::UploadStream(const void* data, uintptr dataSize)
+	{
+		RenderCommandUpload* command = Push<RenderCommandUpload>(RenderCommandOp::UploadStream, dataSize);
+		command->m_dataSize = dataSize;
+		GenericMemory::memcpy((uint8*)command + sizeof(RenderCommandUpload), data, dataSize);
+		return m_streamCount++;
+	}
+
+	void RenderCommandBuffer::BindInstanceStream(uint32 vao, uint32 bufferIndex, uint32 stream, uintptr offset, uintptr dataSize)
+	{
+		RenderCommandInstanceStream* command = Push<RenderCommandInstanceStream>(RenderCommandOp::BindInstanceStream);
+		command->m_vertexArray = vao;
+		command->m_bufferIndex = bufferIndex;
+		command->m_stream = stream;
+		command->m_offset = offset;
+		command->m_dataSize = dataSize;
+	}
+
+	void RenderCommandBuffer::SetSpriteBatchStream(uint32 vao, uint32 stream, uint32 fallbackBuffer, uintptr fallbackSize)
+	{
+		RenderCommandSpriteStream* command = Push<RenderCommandSpriteStream>(RenderCommandOp::SetSpriteBatchStream);
+		command->m_vertexArray = vao;
+		command->m_stream = stream;
+		command->m_fallbackBuffer = fallbackBuffer;
+		command->m_fallbackSize = fallbackSize;
+	}
+
+	void RenderCommandBuffer::Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays)
+	{
+		RenderCommandDraw* command = Push<RenderCommandDraw>(RenderCommandOp::Draw);
+		command->m_params = drawParams;
+		command->m_vertexArray = vao;
+		command->m_numInstances = numInstances;
+		command->m_numElements = numElements;
+		command->m_drawArrays = drawArrays;
+		m_drawCount++;
+	}
+
+	void RenderCommandBuffer::DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex)
+	{
+		RenderCommandDraw* command = Push<RenderCommandDraw>(RenderCommandOp::DrawBaseVertex);
+		command->m_params = drawParams;
+		command->m_vertexArray = vao;
+		command->m_numElements = numElements;
+		command->m_baseVertex = baseVertex;
+		m_drawCount++;
+	}
+
+	void RenderCommandBuffer::DrawInstancedBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, uint32 firstIndex, uint32 baseVertex)
+	{
+		RenderCommandDraw* command = Push<RenderCommandDraw>(RenderCommandOp::DrawInstancedBaseVertex);
+		command->m_params = drawParams;
+		command->m_vertexArray = vao;
+		command->m_numInstances = numInstances;
+		command->m_numElements = numElements;
+		command->m_firstIndex = firstIndex;
+		command->m_baseVertex = baseVertex;
+		m_drawCount++;
+	}
+
+	DrawElementsIndirectCommand* RenderCommandBuffer::MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, uint32 bufferIndex, uint32 stream, uint32 instanceStride, uint32 drawCount)
+	{
+		RenderCommandMultiDraw* command = Push<RenderCommandMultiDraw>(RenderCommandOp::MultiDrawIndirect, drawCount * sizeof(DrawElementsIndirectCommand));
+		command->m_params = drawParams;
+		command->m_vertexArray = vao;
+		command->m_bufferIndex = bufferIndex;
+		command->m_stream = stream;
+		command->m_instanceStride = instanceStride;
+		command->m_drawCount = drawCount;
+		m_drawCount++;
+		m_indirectDrawCount += drawCount;
+
+		DrawElementsIndirectCommand* indirect = (DrawElementsIndirectCommand*)((uint8*)command + sizeof(RenderCommandMultiDraw));
+		for (uint32 i = 0; i < drawCount; i++)
+			new (&indirect[i]) DrawElementsIndirectCommand();
+
+		return indirect;
+	}
+
+	uint8* RenderCommandBuffer::Allocate(RenderCommandOp op, uintptr payloadSize)
+	{
+		// Commands start aligned, the header keeps the payload aligned for its members.
+		const uintptr size = (sizeof(RenderCommandHeader) + payloadSize + RENDERCOMMANDBUFFER_ALIGNMENT - 1) / RENDERCOMMANDBUFFER_ALIGNMENT * RENDERCOMMANDBUFFER_ALIGNMENT;
+		const uintptr position = m_data.size();
+		m_data.resize(position + size);
+
+		RenderCommandHeader* header = new (&m_data[position]) RenderCommandHeader();
+		header->m_op = op;
+		header->m_size = (uint32)size;
+		m_commandCount++;
+		return &m_data[position + sizeof(RenderCommandHeader)];
+	}
+
+	void RenderCommandBuffer::PushUniform(RenderCommandOp op, uint32 shader, const std::string& uniform, const void* value, uint16 valueSize)
+	{
+		RenderCommandUniform* command = Push<RenderCommandUniform>(op, valueSize + uniform.size());
+		command->m_shader = shader;
+		command->m_valueSize = valueSize;
+		command->m_nameSize = (uint16)uniform.size();
+
+		uint8* data = (uint8*)command + sizeof(RenderCommandUniform);
+		GenericMemory::memcpy(data, value, valueSize);
+		GenericMemory::memcpy(data + valueSize, uniform.data(), uniform.size());
+	}
+}
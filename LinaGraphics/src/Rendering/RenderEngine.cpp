@@ -40,26 +40,73 @@ SOFTWARE.
 #include "PackageManager/OpenGL/GLRenderDevice.hpp"
 #include "Helpers/DrawParameterHelper.hpp"
 #include "Core/Timer.hpp"
+#include "Core/JobSystem.hpp"
 
 namespace LinaEngine::Graphics
 {
 	RenderDevice RenderEngine::s_renderDevice;
+	GeometryPool RenderEngine::s_geometryPool;
 	Texture RenderEngine::s_defaultTexture;
 	Material RenderEngine::s_defaultUnlit;
 	Shader* RenderEngine::s_standardUnlitShader;
 
-	constexpr size_t UNIFORMBUFFER_VIEWDATA_SIZE = (sizeof(Matrix) * 3) + (sizeof(Vector4)) + (sizeof(float) * 2);
+	// CPU side mirrors of the shader blocks, laid out according to std140.
+	struct ViewDataBlock
+	{
+		Matrix projection;
+		Matrix view;
+		Matrix lightSpace;
+		Vector4 cameraPosition;
+		float cameraNear;
+		float cameraFar;
+		float padding[2];
+	};
+
+	struct LightDataBlock
+	{
+		int32 pointLightCount;
+		int32 spotLightCount;
+		int32 padding[2];
+		Vector4 ambientColor;
+		Vector4 dirLightPos;
+		Vector4 dirLightDirection;
+		Vector4 dirLightColor;
+		int32 clusterCounts[4];
+		Vector4 clusterParams;
+		Matrix shadowCascades[SHADOWCASCADE_COUNT];
+		Vector4 shadowSplits;
+		Vector4 shadowTexelSizes;
+		Vector4 shadowParams;
+		Vector4 irradianceSH[HDRICACHE_SH_COEFFICIENTS];
+		Vector4 iblParams;
+	};
+
+	struct DebugDataBlock
+	{
+		int32 visualizeDepth;
+		int32 padding[3];
+	};
+
+	constexpr size_t UNIFORMBUFFER_VIEWDATA_SIZE = sizeof(ViewDataBlock);
 	constexpr int UNIFORMBUFFER_VIEWDATA_BINDPOINT = 0;
 	constexpr auto UNIFORMBUFFER_VIEWDATA_NAME = "ViewData";
 
-	constexpr size_t UNIFORMBUFFER_LIGHTDATA_SIZE = (sizeof(int) * 2) + sizeof(Vector4) + sizeof(Vector4);
+	constexpr size_t UNIFORMBUFFER_LIGHTDATA_SIZE = sizeof(LightDataBlock);
 	constexpr int UNIFORMBUFFER_LIGHTDATA_BINDPOINT = 1;
 	constexpr auto UNIFORMBUFFER_LIGHTDATA_NAME = "LightData";
 
-	constexpr size_t UNIFORMBUFFER_DEBUGDATA_SIZE = (sizeof(bool) * 1);
+	constexpr size_t UNIFORMBUFFER_DEBUGDATA_SIZE = sizeof(DebugDataBlock);
 	constexpr int UNIFORMBUFFER_DEBUGDATA_BINDPOINT = 2;
 	constexpr auto UNIFORMBUFFER_DEBUGDATA_NAME = "DebugData";
 
+	constexpr size_t FRAME_RINGBUFFER_SIZE = 4 * 1024 * 1024;
+
+	constexpr uint32 BLOOM_MIP_COUNT = 5;
+	constexpr uint32 RENDERTARGET_RESIZE_SETTLE_FRAMES = 6;
+	constexpr uint32 HDRI_IRRADIANCE_RESOLUTION = 32;
+	constexpr uint32 HDRI_PREFILTER_RESOLUTION = 128;
+	constexpr uint32 HDRI_PREFILTER_MIP_COUNT = 5;
+
 	RenderEngine::RenderEngine()
 	{
 		LINA_CORE_TRACE("[Constructor] -> RenderEngine ({0})", typeid(*this).name());
@@ -70,11 +117,13 @@ namespace LinaEngine::Graphics
 		// Dump the remaining memory.
 		DumpMemory();
 
+		// Meshes are gone, release the shared geometry.
+		s_geometryPool.Release();
+
 		// Release Vertex Array Objects
 		m_skyboxVAO = s_renderDevice.ReleaseVertexArray(m_skyboxVAO);
 		m_screenQuadVAO = s_renderDevice.ReleaseVertexArray(m_screenQuadVAO);
 		m_hdriCubeVAO = s_renderDevice.ReleaseVertexArray(m_hdriCubeVAO);
-		m_lineVAO = s_renderDevice.ReleaseVertexArray(m_lineVAO);
 
 		LINA_CORE_TRACE("[Destructor] -> RenderEngine ({0})", typeid(*this).name());
 	}
@@ -103,6 +152,7 @@ namespace LinaEngine::Graphics
 		m_skyboxDrawParams = DrawParameterHelper::GetSkybox();
 		m_fullscreenQuadDP = DrawParameterHelper::GetFullScreenQuad();
 		m_shadowMapDrawParams = DrawParameterHelper::GetShadowMap();
+		m_debugLineDrawParams = DrawParameterHelper::GetDebugLines();
 
 
 		// Initialize the render device.
@@ -120,6 +170,13 @@ namespace LinaEngine::Graphics
 		m_globalDebugBuffer.Construct(s_renderDevice, UNIFORMBUFFER_DEBUGDATA_SIZE, BufferUsage::USAGE_DYNAMIC_DRAW, NULL);
 		m_globalDebugBuffer.Bind(UNIFORMBUFFER_DEBUGDATA_BINDPOINT);
 
+		// Construct the ring buffer per-frame dynamic data is streamed through.
+		m_frameRingBuffer.Construct(s_renderDevice, FRAME_RINGBUFFER_SIZE);
+		m_uniformBufferAlignment = s_renderDevice.GetUniformBufferOffsetAlignment();
+
+		// Construct the geometry pool before any meshes are created.
+		s_geometryPool.Construct(s_renderDevice);
+
 		// Initialize the engine shaders.
 		ConstructEngineShaders();
 
@@ -133,7 +190,9 @@ namespace LinaEngine::Graphics
 		m_skyboxVAO = s_renderDevice.CreateSkyboxVertexArray();
 		m_hdriCubeVAO = s_renderDevice.CreateHDRICubeVertexArray();
 		m_screenQuadVAO = s_renderDevice.CreateScreenQuadVertexArray();
-		m_lineVAO = s_renderDevice.CreateLineVertexArray();
+
+		// Debug lines are streamed through the frame ring buffer.
+		m_debugRenderer.Construct(s_renderDevice, m_frameRingBuffer, m_debugLineShader->GetID());
 
 		// Construct render targets
 		ConstructRenderTargets();
@@ -166,8 +225,6 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::Render()
 	{
-		// DrawShadows();
-
 		if (m_preDrawCallback)
 			m_preDrawCallback();
 
@@ -199,8 +256,20 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::Swap()
 	{
+		// Frame times & the next scale are taken before the swap, waiting on it isn't part of the frame's work.
+		m_dynamicResolution.EndFrame();
+
 		// Update window.
 		m_appWindow->Tick();
+		m_dynamicResolution.BeginFrame();
+
+		// Fence this frame's dynamic data & move on.
+		m_frameRingBuffer.NextFrame();
+
+#ifdef LINA_GRAPHICS_NULL
+		// Close the recorded frame & its statistics.
+		s_renderDevice.EndFrame();
+#endif
 	}
 
 	void RenderEngine::SetViewportDisplay(Vector2 pos, Vector2 size)
@@ -211,16 +280,37 @@ namespace LinaEngine::Graphics
 
 		m_cameraSystem.SetAspectRatio((float)m_viewportSize.x / (float)m_viewportSize.y);
 
-		// Resize render buffers & frame buffer textures
-		s_renderDevice.ResizeRTTexture(m_primaryRTTexture0.GetID(), m_viewportSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRTTexture(m_primaryRTTexture1.GetID(), m_viewportSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
-		//s_renderDevice.ResizeRTTexture(m_OutlineRTTexture.GetID(), windowSize, primaryRTParams.m_textureParams.m_internalPixelFormat, primaryRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRTTexture(m_pingPongRTTexture1.GetID(), m_viewportSize, m_pingPongRTParams.m_textureParams.m_internalPixelFormat, m_pingPongRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRTTexture(m_pingPongRTTexture1.GetID(), m_viewportSize, m_pingPongRTParams.m_textureParams.m_internalPixelFormat, m_pingPongRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRenderBuffer(m_primaryRenderTarget.GetID(), m_primaryRenderBuffer.GetID(), m_viewportSize, RenderBufferStorage::STORAGE_DEPTH);
+		// Render targets follow once the size stops changing, see UpdateRenderTargetSize.
+		if (size.x >= 1.0f && size.y >= 1.0f)
+		{
+			m_pendingRenderTargetSize = size;
+			m_resizeSettleFrames = 0;
+		}
+
+#ifndef LINA_EDITOR
+		// The final pass draws straight into the window.
+		if (m_renderGraph.IsCompiled())
+			m_renderGraph.UpdateImportedTarget(m_rgOutput, 0, m_viewportPos, m_viewportSize);
+#endif
+	}
+
+	void RenderEngine::UpdateRenderTargetSize()
+	{
+		if (m_pendingRenderTargetSize == m_renderTargetSize) return;
+
+		// Dragging a window resizes every frame, meanwhile the last allocation is stretched over the viewport.
+		if (m_renderTargetSize != Vector2::Zero && ++m_resizeSettleFrames < RENDERTARGET_RESIZE_SETTLE_FRAMES) return;
+
+		m_renderTargetSize = m_pendingRenderTargetSize;
+		m_renderGraph.Resize(m_renderTargetSize);
 
 #ifdef LINA_EDITOR
-		s_renderDevice.ResizeRTTexture(m_secondaryRTTexture.GetID(), m_viewportSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
+		s_renderDevice.ResizeRTTexture(m_secondaryRTTexture.GetID(), m_renderTargetSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
+		s_renderDevice.ResizeRenderBuffer(m_secondaryRenderTarget.GetID(), m_secondaryRenderBuffer.GetID(), m_renderTargetSize, RenderBufferStorage::STORAGE_DEPTH);
+		m_secondaryRTTexture.m_size = m_renderTargetSize;
+
+		if (m_renderGraph.IsCompiled())
+			m_renderGraph.UpdateImportedTarget(m_rgOutput, m_secondaryRenderTarget.GetID(), m_viewportPos, m_renderTargetSize);
 #endif
 	}
 
@@ -279,25 +369,32 @@ namespace LinaEngine::Graphics
 		m_hdriEquirectangularShader = &Shader::CreateShader("resources/engine/shaders/HDRI/HDRIEquirectangular.glsl");
 		m_hdriIrradianceShader = &Shader::CreateShader( "resources/engine/shaders/HDRI/HDRIIrradiance.glsl");
 		m_hdriPrefilterShader = &Shader::CreateShader("resources/engine/shaders/HDRI/HDRIPrefilter.glsl");
-		m_hdriBRDFShader = &Shader::CreateShader("resources/engine/shaders/HDRI/HDRIBRDF.glsl");
 
 
 		// Screen Quad Shaders
 		m_sqFinalShader = &Shader::CreateShader("resources/engine/shaders/ScreenQuads/SQFinal.glsl");
 		m_sqFinalShader->BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		m_sqBlurShader = &Shader::CreateShader("resources/engine/shaders/ScreenQuads/SQBlur.glsl");
-		m_sqBlurShader->BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		m_sqBloomDownsampleShader = &Shader::CreateShader("resources/engine/shaders/ScreenQuads/SQBloomDownsample.glsl");
+		m_sqBloomUpsampleShader = &Shader::CreateShader("resources/engine/shaders/ScreenQuads/SQBloomUpsample.glsl");
 		m_sqOutlineShader = &Shader::CreateShader("resources/engine/shaders/ScreenQuads/SQOutline.glsl");
 		m_sqOutlineShader->BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 		m_sqShadowMapShader = &Shader::CreateShader("resources/engine/shaders/ScreenQuads/SQShadowMap.glsl");
 		m_sqShadowMapShader->BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);;
 
+		// Bloom passes bind their textures directly, units are fixed. Uniforms go to the bound program.
+		s_renderDevice.SetShader(m_sqBloomDownsampleShader->GetID());
+		s_renderDevice.UpdateShaderUniformInt(m_sqBloomDownsampleShader->GetID(), MAT_MAP_SCREEN MAT_EXTENSION_TEXTURE2D, 0);
+		s_renderDevice.SetShader(m_sqBloomUpsampleShader->GetID());
+		s_renderDevice.UpdateShaderUniformInt(m_sqBloomUpsampleShader->GetID(), MAT_MAP_SCREEN MAT_EXTENSION_TEXTURE2D, 0);
+		s_renderDevice.UpdateShaderUniformInt(m_sqBloomUpsampleShader->GetID(), MAT_MAP_BLOOM MAT_EXTENSION_TEXTURE2D, 1);
+
 		// Line
 		m_debugLineShader = &Shader::CreateShader("resources/engine/shaders/Misc/DebugLine.glsl");
 		m_debugLineShader->BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 
 		// 2D
 		Shader::CreateShader("resources/engine/shaders/2D/Sprite.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader::CreateShader("resources/engine/shaders/2D/SpriteBatch.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 	}
 
 	bool RenderEngine::ValidateEngineShaders()
@@ -317,10 +414,8 @@ namespace LinaEngine::Graphics
 	void RenderEngine::ConstructEngineMaterials()
 	{
 		Material::SetMaterialShader(m_screenQuadFinalMaterial, *m_sqFinalShader);
-		Material::SetMaterialShader(m_screenQuadBlurMaterial, *m_sqBlurShader);
 		Material::SetMaterialShader(m_screenQuadOutlineMaterial, *m_sqOutlineShader);
 		Material::SetMaterialShader(m_hdriMaterial, *m_hdriEquirectangularShader);
-		Material::SetMaterialShader(m_debugDrawMaterial, *m_debugLineShader);
 		Material::SetMaterialShader(m_shadowMapMaterial, *m_sqShadowMapShader);
 		Material::SetMaterialShader(m_defaultSkyboxMaterial, *m_skyboxSingleColorShader);
 		Material::SetMaterialShader(s_defaultUnlit, *s_standardUnlitShader);
@@ -352,11 +447,11 @@ namespace LinaEngine::Graphics
 		m_primaryRTParams.m_textureParams.m_wrapS = m_primaryRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
 
 
-		// Ping pong
-		m_pingPongRTParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
-		m_pingPongRTParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
-		m_pingPongRTParams.m_textureParams.m_minFilter = m_pingPongRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-		m_pingPongRTParams.m_textureParams.m_wrapS = m_pingPongRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+		// Bloom mip chain
+		m_bloomRTParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
+		m_bloomRTParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
+		m_bloomRTParams.m_textureParams.m_minFilter = m_bloomRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
+		m_bloomRTParams.m_textureParams.m_wrapS = m_bloomRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
 
 		// Shadows depth.
 		m_shadowsRTParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_DEPTH;
@@ -364,46 +459,51 @@ namespace LinaEngine::Graphics
 		m_shadowsRTParams.m_textureParams.m_minFilter = m_shadowsRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_NEAREST;
 		m_shadowsRTParams.m_textureParams.m_wrapS = m_shadowsRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_BORDER;
 
-		// Initialize primary RT textures
-		m_primaryRTTexture0.ConstructRTTexture(s_renderDevice, m_viewportSize, m_primaryRTParams, false);
-		m_primaryRTTexture1.ConstructRTTexture(s_renderDevice, m_viewportSize, m_primaryRTParams, false);
-
-		// Initialize ping pong rt texture
-		m_pingPongRTTexture1.ConstructRTTexture(s_renderDevice, m_viewportSize, m_pingPongRTParams, false);
-		m_pingPongRTTexture2.ConstructRTTexture(s_renderDevice, m_viewportSize, m_pingPongRTParams, false);
-
-		// Initialize outilne RT texture
-		//m_OutlineRTTexture.ConstructRTTexture(s_renderDevice, screenSize, primaryRTParams, false);
-
-		// Shadow map RT texture
+		// Occlusion buffer debug view.
+		m_occlusionDebugParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGBA;
+		m_occlusionDebugParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGBA;
+		m_occlusionDebugParams.m_textureParams.m_minFilter = m_occlusionDebugParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_NEAREST;
+		m_occlusionDebugParams.m_textureParams.m_wrapS = m_occlusionDebugParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+
+		// HDRI environment, irradiance & prefiltered specular cubemaps.
+		m_hdriCubemapParams.m_textureParams.m_wrapR = m_hdriCubemapParams.m_textureParams.m_wrapS = m_hdriCubemapParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+		m_hdriCubemapParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
+		m_hdriCubemapParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR_MIPMAP_LINEAR;
+		m_hdriCubemapParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
+		m_hdriCubemapParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
+		m_hdriIrradianceParams = m_hdriCubemapParams;
+		m_hdriPrefilterParams = m_hdriCubemapParams;
+		m_hdriPrefilterParams.m_textureParams.m_generateMipMaps = true;
+
+		// BRDF lut.
+		m_hdriLutParams.m_textureParams.m_wrapR = m_hdriLutParams.m_textureParams.m_wrapS = m_hdriLutParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+		m_hdriLutParams.m_textureParams.m_minFilter = m_hdriLutParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
+		m_hdriLutParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
+		m_hdriLutParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
+
+		// Bloom levels are sampled in between texels, clamped at the edges.
+		m_bloomSampler.Construct(s_renderDevice, m_bloomRTParams, TextureBindMode::BINDTEXTURE_TEXTURE2D);
+
+		// Scene & post process targets are transient, the graph allocates them on first use.
+		m_renderGraph.Construct(s_renderDevice, m_viewportSize);
+		m_dynamicResolution.Construct(s_renderDevice);
+
+		// Shadow map RT textures, the static atlas keeps the depth of the static casters between frames.
 		m_shadowMapRTTexture.ConstructRTTexture(s_renderDevice, m_shadowMapResolution, m_shadowsRTParams, true);
+		m_shadowStaticRTTexture.ConstructRTTexture(s_renderDevice, m_shadowMapResolution, m_shadowsRTParams, true);
 
-		// Initialize primary render buffer
-		m_primaryRenderBuffer.Construct(s_renderDevice, RenderBufferStorage::STORAGE_DEPTH, m_viewportSize);
+		// Occlusion debug texture, filled from the CPU when requested.
+		m_occlusionDebugTexture.ConstructRTTexture(s_renderDevice, Vector2(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT), m_occlusionDebugParams, false);
 
 		// Initialize hdri render buffer
 		m_hdriCaptureRenderBuffer.Construct(s_renderDevice, RenderBufferStorage::STORAGE_DEPTH_COMP24, m_hdriResolution);
 
-		// Initialize primary render target.
-		m_primaryRenderTarget.Construct(s_renderDevice, m_primaryRTTexture0, m_viewportSize, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, FrameBufferAttachment::ATTACHMENT_DEPTH, m_primaryRenderBuffer.GetID());
-
-		// Bind the extre texture to primary render target, also tell open gl that we are running mrts.
-		s_renderDevice.BindTextureToRenderTarget(m_primaryRenderTarget.GetID(), m_primaryRTTexture1.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 1);
-		uint32 attachments[2] = { FrameBufferAttachment::ATTACHMENT_COLOR , (FrameBufferAttachment::ATTACHMENT_COLOR + (uint32)1) };
-		s_renderDevice.MultipleDrawBuffersCommand(m_primaryRenderTarget.GetID(), 2, attachments);
-
-		// Initialize ping pong render targets
-		m_pingPongRenderTarget1.Construct(s_renderDevice, m_pingPongRTTexture1, m_viewportSize, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-		m_pingPongRenderTarget2.Construct(s_renderDevice, m_pingPongRTTexture2, m_viewportSize, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-
-		// Initialize outline render target
-		//m_OutlineRenderTarget.Construct(s_renderDevice, m_OutlineRTTexture, m_viewportSize.x, m_viewportSize.y, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-
 		// Initialize HDRI render target
 		m_hdriCaptureRenderTarget.Construct(s_renderDevice, m_hdriResolution, FrameBufferAttachment::ATTACHMENT_DEPTH, m_hdriCaptureRenderBuffer.GetID());
 
 		// Initialize depth map for shadows
 		m_shadowMapTarget.Construct(s_renderDevice, m_shadowMapRTTexture, m_shadowMapResolution, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_DEPTH, true);
+		m_shadowStaticTarget.Construct(s_renderDevice, m_shadowStaticRTTexture, m_shadowMapResolution, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_DEPTH, true);
 
 #ifdef LINA_EDITOR
 		m_secondaryRTTexture.ConstructRTTexture(s_renderDevice, m_viewportSize, m_primaryRTParams, false);
@@ -412,6 +512,68 @@ namespace LinaEngine::Graphics
 #endif
 	}
 
+	void RenderEngine::ConstructRenderGraph()
+	{
+		m_renderGraph.Reset();
+
+		// The shadow atlas keeps the static casters between frames, the output is the window or the editor's scene view.
+		const uint32 shadowMap = m_renderGraph.ImportTarget("Shadow Map", m_shadowMapTarget.GetID(), &m_shadowMapRTTexture, Vector2::Zero, m_shadowMapResolution);
+#ifdef LINA_EDITOR
+		m_rgOutput = m_renderGraph.ImportTarget("Output", m_secondaryRenderTarget.GetID(), &m_secondaryRTTexture, m_viewportPos, m_renderTargetSize);
+#else
+		m_rgOutput = m_renderGraph.ImportTarget("Output", 0, nullptr, m_viewportPos, m_viewportSize);
+#endif
+
+		m_rgSceneColor = m_renderGraph.CreateTexture("Scene Color", m_primaryRTParams);
+		const uint32 brightColor = m_renderGraph.CreateTexture("Bright Color", m_primaryRTParams);
+		const uint32 sceneDepth = m_renderGraph.CreateDepthBuffer("Scene Depth", RenderBufferStorage::STORAGE_DEPTH);
+
+		uint32 pass = m_renderGraph.AddPass("Shadows", [this]() { if (!m_customDrawActive) ExecuteCommands(m_shadowCommands); });
+		m_renderGraph.Write(pass, shadowMap);
+
+		pass = m_renderGraph.AddPass("Scene", [this]() { DrawScene(); });
+		m_renderGraph.Read(pass, shadowMap);
+		m_renderGraph.Write(pass, m_rgSceneColor);
+		m_renderGraph.Write(pass, brightColor);
+		m_renderGraph.Write(pass, sceneDepth);
+
+		// Bright color is downsampled into a chain of mips starting at half resolution.
+		uint32 bloom = brightColor;
+		uint32 bloomMips[BLOOM_MIP_COUNT];
+		for (uint32 i = 0; i < BLOOM_MIP_COUNT; i++)
+		{
+			const uint32 source = bloom;
+			const bool karisAverage = i == 0;
+			bloom = bloomMips[i] = m_renderGraph.CreateTexture("Bloom Down " + std::to_string(i), m_bloomRTParams, 0.5f / (float)(1 << i));
+			pass = m_renderGraph.AddPass("Bloom Down " + std::to_string(i), [this, source, karisAverage]() { DrawBloomDownsample(source, karisAverage); });
+			m_renderGraph.Read(pass, source);
+			m_renderGraph.Write(pass, bloom);
+		}
+
+		// Then tent filtered back up level by level, the last step to full resolution is done by the final pass.
+		for (int32 i = BLOOM_MIP_COUNT - 2; i >= 0; i--)
+		{
+			const uint32 lower = bloom;
+			const uint32 level = bloomMips[i];
+			bloom = m_renderGraph.CreateTexture("Bloom Up " + std::to_string(i), m_bloomRTParams, 0.5f / (float)(1 << i));
+			pass = m_renderGraph.AddPass("Bloom Up " + std::to_string(i), [this, lower, level]() { DrawBloomUpsample(lower, level); });
+			m_renderGraph.Read(pass, lower);
+			m_renderGraph.Read(pass, level);
+			m_renderGraph.Write(pass, bloom);
+		}
+
+		// Without bloom nothing reads the chain, its passes & the bright attachment are culled.
+		const uint32 finalBloom = m_renderSettings.m_bloomEnabled ? bloom : RENDERGRAPH_INVALID_HANDLE;
+		pass = m_renderGraph.AddPass("Final", [this, finalBloom]() { DrawFinalize(finalBloom); }, true);
+		m_renderGraph.Read(pass, m_rgSceneColor);
+		if (finalBloom != RENDERGRAPH_INVALID_HANDLE)
+			m_renderGraph.Read(pass, finalBloom);
+		m_renderGraph.Write(pass, m_rgOutput);
+
+		m_renderGraph.Compile();
+		m_renderGraphDirty = false;
+	}
+
 	void RenderEngine::DumpMemory()
 	{
 		// Clear dumps.
@@ -421,118 +583,133 @@ namespace LinaEngine::Graphics
 		Shader::UnloadAll();
 	}
 
-	void RenderEngine::DrawShadows()
+	void RenderEngine::RecordShadows(RenderCommandBuffer& commands)
 	{
-		// Clear color.
-		s_renderDevice.Clear(true, true, false, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+		// Runs on a worker, cascades are fitted when the uniform buffers are updated.
+		if (!m_shadowCascades.GetIsActive()) return;
 
-		// Update pipeline.
-		m_renderingPipeline.UpdateSystems(0.0f);
+		const Vector2 cascadeSize = Vector2(SHADOWCASCADE_RESOLUTION, SHADOWCASCADE_RESOLUTION);
+		const uint32 staticVersion = m_meshRendererSystem.GetStaticCasterVersion();
 
-		// Update uniform buffers on GPU
-		UpdateUniformBuffers();
-
-		// Set depth frame 
-		s_renderDevice.SetFBO(m_shadowMapTarget.GetID());
-		s_renderDevice.SetViewport(Vector2::Zero, m_shadowMapResolution);
-
-		// Clear color.
-		s_renderDevice.Clear(false, true, false, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+		// Tiles are cleared through the scissor rect, depth writes have to be on for the clear.
+		DrawParams tileClearParams = m_shadowMapDrawParams;
+		tileClearParams.useScissorTest = true;
+		tileClearParams.scissorWidth = tileClearParams.scissorHeight = SHADOWCASCADE_RESOLUTION;
 
-		// Draw scene
-		DrawSceneObjects(m_shadowMapDrawParams, &m_shadowMapMaterial);
+		// Static casters are only redrawn into the tiles whose light matrix or static set changed.
+		for (uint32 i = 0; i < SHADOWCASCADE_COUNT; i++)
+		{
+			if (!m_shadowCascades.NeedsStaticUpdate(i, staticVersion)) continue;
+
+			const ShadowCascade& cascade = m_shadowCascades.GetCascade(i);
+			commands.SetFBO(m_shadowStaticTarget.GetID());
+			commands.SetViewport(cascade.m_atlasOffset, cascadeSize);
+			tileClearParams.scissorStartX = (uint32)cascade.m_atlasOffset.x;
+			tileClearParams.scissorStartY = (uint32)cascade.m_atlasOffset.y;
+			commands.SetDrawParameters(tileClearParams);
+			commands.Clear(false, true, false, Color::White, 0xFF);
+
+			m_shadowMapMaterial.SetMatrix4(UF_MATRIX_LIGHTVIEWPROJECTION, cascade.m_lightViewProjection);
+			m_meshRendererSystem.DrawShadowCasters(cascade.m_lightViewProjection, true, m_shadowMapDrawParams, m_shadowMapMaterial, commands);
+			m_shadowCascades.MarkStaticUpdated(i, staticVersion);
+		}
 
-		// Add the shadow texture
-		std::set<Material*>& shadowMappedMaterials = Material::GetShadowMappedMaterials();
-		for (std::set<Material*>::iterator it = shadowMappedMaterials.begin(); it != shadowMappedMaterials.end(); ++it)
-			(*it)->SetTexture(MAT_TEXTURE2D_SHADOWMAP, &m_shadowMapRTTexture);
+		// Start from the cached static depth, the moving casters are drawn on top. Blits are scissored too.
+		commands.SetDrawParameters(m_shadowMapDrawParams);
+		commands.BlitFrameBuffers(m_shadowStaticTarget.GetID(), (uint32)m_shadowMapResolution.x, (uint32)m_shadowMapResolution.y, m_shadowMapTarget.GetID(), (uint32)m_shadowMapResolution.x, (uint32)m_shadowMapResolution.y, BufferBit::BIT_DEPTH, SamplerFilter::FILTER_NEAREST);
+		commands.SetFBO(m_shadowMapTarget.GetID());
 
+		for (uint32 i = 0; i < SHADOWCASCADE_COUNT; i++)
+		{
+			const ShadowCascade& cascade = m_shadowCascades.GetCascade(i);
+			commands.SetViewport(cascade.m_atlasOffset, cascadeSize);
+			m_shadowMapMaterial.SetMatrix4(UF_MATRIX_LIGHTVIEWPROJECTION, cascade.m_lightViewProjection);
+			m_meshRendererSystem.DrawShadowCasters(cascade.m_lightViewProjection, false, m_shadowMapDrawParams, m_shadowMapMaterial, commands);
+		}
 	}
 
 	void RenderEngine::Draw()
 	{
-		// Set render target
-		s_renderDevice.SetFBO(m_primaryRenderTarget.GetID());
-		s_renderDevice.SetViewport(Vector2::Zero, m_viewportSize);
+		// Targets & passes are only rebuilt when the size settled or the settings changed.
+		UpdateRenderTargetSize();
+		if (m_renderGraphDirty)
+			ConstructRenderGraph();
 
-		if (m_customDrawEnabled && m_customDrawFunction)
-			m_customDrawFunction();
-		else
-		{		
-			// Clear color.
-			s_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+		m_customDrawActive = m_customDrawEnabled && m_customDrawFunction;
+
+		// Scale is fixed for the frame before any screen sized data is updated.
+		m_dynamicResolution.BeginGPUTimer();
+		m_renderGraph.SetViewportScale(m_dynamicResolution.GetScale());
 
+		if (!m_customDrawActive)
+		{
 			// Update 
 			UpdateSystems();
 
-			// Draw skybox.
-			DrawSkybox();
-
-			// Draw scene
-			DrawSceneObjects(m_defaultDrawParams);
+			// Shadow & scene passes are recorded in parallel, the graph submits them in pass order.
+			RecordPasses(m_defaultDrawParams, nullptr, true);
 		}
 
-		// Finalize drawing.
-		DrawFinalize();
+		m_renderGraph.Execute();
 	}
 
-	void RenderEngine::DrawFinalize()
+	void RenderEngine::DrawScene()
 	{
-		bool horizontal = true;
-
-		if (m_renderSettings.m_bloomEnabled)
+		if (m_customDrawActive)
 		{
-			// Write to the pingpong buffers to apply 2 pass gaussian blur.
-			bool firstIteration = true;
-			unsigned int amount = 4;
-			for (unsigned int i = 0; i < amount; i++)
-			{
-				// Select FBO
-				s_renderDevice.SetFBO(horizontal ? m_pingPongRenderTarget1.GetID() : m_pingPongRenderTarget2.GetID());
-
-				// Setup material & use.
-				m_screenQuadBlurMaterial.SetBool(MAT_ISHORIZONTAL, horizontal);
-				if (firstIteration)
-					m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_primaryRTTexture1);
-				else
-				{
-					if (horizontal)
-						m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_pingPongRTTexture2);
-					else
-						m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_pingPongRTTexture1);
-				}
-
-				// Update shader data & draw.
-				UpdateShaderData(&m_screenQuadBlurMaterial);
-				s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
-				horizontal = !horizontal;
-				if (firstIteration) firstIteration = false;
-			}
+			m_customDrawFunction();
+			return;
 		}
 
-#ifdef LINA_EDITOR
-		s_renderDevice.SetFBO(m_secondaryRenderTarget.GetID());
-#else
-		// Back to default buffer
-		s_renderDevice.SetFBO(0);
-#endif
+		// Clear color.
+		s_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
 
-		s_renderDevice.SetViewport(m_viewportPos, m_viewportSize);
+		// Draw skybox.
+		DrawSkybox();
 
+		// Draw scene
+		SubmitScenePasses(true);
+	}
+
+	void RenderEngine::DrawBloomDownsample(uint32 source, bool karisAverage)
+	{
+		// Few uniforms & a single texture, bound directly instead of through a material.
+		const uint32 shader = m_sqBloomDownsampleShader->GetID();
+		s_renderDevice.SetShader(shader);
+		s_renderDevice.UpdateShaderUniformInt(shader, MAT_KARISAVERAGE, karisAverage);
+		s_renderDevice.UpdateShaderUniformFloat(shader, MAT_RENDERSCALE, m_renderGraph.GetViewportScale());
+		s_renderDevice.SetTexture(m_renderGraph.GetTexture(source)->GetID(), m_bloomSampler.GetID(), 0, TextureBindMode::BINDTEXTURE_TEXTURE2D, true);
+		s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
+	}
+
+	void RenderEngine::DrawBloomUpsample(uint32 lower, uint32 level)
+	{
+		const uint32 shader = m_sqBloomUpsampleShader->GetID();
+		s_renderDevice.SetShader(shader);
+		s_renderDevice.UpdateShaderUniformFloat(shader, MAT_RENDERSCALE, m_renderGraph.GetViewportScale());
+		s_renderDevice.SetTexture(m_renderGraph.GetTexture(lower)->GetID(), m_bloomSampler.GetID(), 0, TextureBindMode::BINDTEXTURE_TEXTURE2D, true);
+		s_renderDevice.SetTexture(m_renderGraph.GetTexture(level)->GetID(), m_bloomSampler.GetID(), 1, TextureBindMode::BINDTEXTURE_TEXTURE2D, true);
+		s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
+	}
+
+	void RenderEngine::DrawFinalize(uint32 bloom)
+	{
 		// Clear color bit.
 		s_renderDevice.Clear(true, true, true, Color::White, 0xFF);
 
 		// Set frame buffer texture on the material.
-		m_screenQuadFinalMaterial.SetTexture(MAT_MAP_SCREEN, &m_primaryRTTexture0, TextureBindMode::BINDTEXTURE_TEXTURE2D);
+		Texture* sceneColor = m_renderGraph.GetTexture(m_rgSceneColor);
+		m_screenQuadFinalMaterial.SetTexture(MAT_MAP_SCREEN, sceneColor, TextureBindMode::BINDTEXTURE_TEXTURE2D);
 
-		if (m_screenQuadFinalMaterial.m_bools[MAT_BLOOMENABLED])
-			m_screenQuadFinalMaterial.SetTexture(MAT_MAP_BLOOM, horizontal ? &m_pingPongRTTexture1 : &m_pingPongRTTexture2, TextureBindMode::BINDTEXTURE_TEXTURE2D);
+		if (bloom != RENDERGRAPH_INVALID_HANDLE)
+			m_screenQuadFinalMaterial.SetTexture(MAT_MAP_BLOOM, m_renderGraph.GetTexture(bloom), TextureBindMode::BINDTEXTURE_TEXTURE2D);
 
-		// m_ScreenQuadFinalMaterial.SetTexture(MAT_MAP_OUTLINE, &m_OutlineRTTexture, TextureBindMode::BINDTEXTURE_TEXTURE2D);
-
-		Vector2 inverseMapSize = 1.0f / m_primaryRTTexture0.GetSize();
+		Vector2 inverseMapSize = 1.0f / sceneColor->GetSize();
 		m_screenQuadFinalMaterial.SetVector3(MAT_INVERSESCREENMAPSIZE, Vector3(inverseMapSize.x, inverseMapSize.y, 0.0));
 
+		// Scene & bloom only cover the scaled region of their targets, upscaled to the output here.
+		m_screenQuadFinalMaterial.SetFloat(MAT_RENDERSCALE, m_renderGraph.GetViewportScale());
+
 		// update shader w/ material data.
 		UpdateShaderData(&m_screenQuadFinalMaterial);
 
@@ -542,9 +719,8 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::DrawLine(Vector3 p1, Vector3 p2, Color col, float width)
 	{
-		s_renderDevice.SetShader(m_debugDrawMaterial.m_shaderID);
-		s_renderDevice.UpdateShaderUniformColor(m_debugDrawMaterial.m_shaderID, MAT_COLOR, col);
-		s_renderDevice.DrawLine(m_debugDrawMaterial.m_shaderID, Matrix::Identity(), p1, p2, width);
+		// Queued, drawn with the rest of the frame's lines after the scene.
+		m_debugRenderer.DrawLine(p1, p2, col, width);
 	}
 
 	void RenderEngine::SetDrawParameters(const DrawParams& params)
@@ -561,6 +737,9 @@ namespace LinaEngine::Graphics
 		m_screenQuadFinalMaterial.SetFloat(MAT_FXAASPANMAX, m_renderSettings.m_fxaaSpanMax);
 		m_screenQuadFinalMaterial.SetFloat(MAT_GAMMA, m_renderSettings.m_gamma);
 		m_screenQuadFinalMaterial.SetFloat(MAT_EXPOSURE, m_renderSettings.m_exposure);
+
+		// Bloom passes are culled from the graph when disabled.
+		m_renderGraphDirty = true;
 	}
 
 	void RenderEngine::DrawOperationsDefault()
@@ -596,149 +775,296 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::DrawSceneObjects(DrawParams& drawParams, Material* overrideMaterial)
 	{
-		m_meshRendererSystem.FlushOpaque(drawParams, overrideMaterial, true);
-		m_meshRendererSystem.FlushTransparent(drawParams, overrideMaterial, true);
-		m_spriteRendererSystem.Flush(drawParams, overrideMaterial, true);
+		RecordPasses(drawParams, overrideMaterial, false);
+
+		// Debug lines only go to the color pass.
+		SubmitScenePasses(overrideMaterial == nullptr);
+	}
+
+	void RenderEngine::RecordPasses(DrawParams& drawParams, Material* overrideMaterial, bool recordShadows)
+	{
+		LINA_TIMER_START("[Graphics] Command Recording");
+		JobSystem& jobSystem = JobSystem::Get();
+
+		// Queues are sorted & split up front, recording only reads them.
+		m_opaqueChunkCount = m_meshRendererSystem.PrepareRecording(jobSystem.GetWorkerCount() + 1);
+		m_spriteRendererSystem.PrepareRecording();
+
+		if (m_opaqueCommands.size() < m_opaqueChunkCount)
+			m_opaqueCommands.resize(m_opaqueChunkCount);
+
+		for (RenderCommandBuffer& commands : m_opaqueCommands)
+			commands.Reset();
+
+		m_shadowCommands.Reset();
+		m_transparentCommands.Reset();
+		m_spriteCommands.Reset();
+
+		// Every pass & opaque chunk records into its own buffer, this thread takes the first chunk.
+		std::vector<std::future<void>> jobs;
+		if (recordShadows)
+			jobs.push_back(jobSystem.Submit([this]() { RecordShadows(m_shadowCommands); }));
+
+		for (uint32 i = 1; i < m_opaqueChunkCount; i++)
+			jobs.push_back(jobSystem.Submit([this, i, &drawParams, overrideMaterial]() { m_meshRendererSystem.RecordOpaque(m_opaqueCommands[i], i, drawParams, overrideMaterial); }));
+
+		jobs.push_back(jobSystem.Submit([this, &drawParams, overrideMaterial]() { m_meshRendererSystem.RecordTransparent(m_transparentCommands, drawParams, overrideMaterial); }));
+		jobs.push_back(jobSystem.Submit([this, &drawParams, overrideMaterial]() { m_spriteRendererSystem.Record(m_spriteCommands, drawParams, overrideMaterial, true); }));
+		m_meshRendererSystem.RecordOpaque(m_opaqueCommands[0], 0, drawParams, overrideMaterial);
+
+		for (std::future<void>& job : jobs)
+			jobSystem.Wait(job);
+
+		m_meshRendererSystem.FinishRecording();
+		m_meshRendererSystem.AddDrawStats(m_shadowCommands);
+		m_meshRendererSystem.AddDrawStats(m_transparentCommands);
+		for (uint32 i = 0; i < m_opaqueChunkCount; i++)
+			m_meshRendererSystem.AddDrawStats(m_opaqueCommands[i]);
+
+		LINA_TIMER_STOP("[Graphics] Command Recording");
+	}
+
+	void RenderEngine::SubmitScenePasses(bool drawDebugLines)
+	{
+		for (uint32 i = 0; i < m_opaqueChunkCount; i++)
+			ExecuteCommands(m_opaqueCommands[i]);
+
+		ExecuteCommands(m_transparentCommands);
+		ExecuteCommands(m_spriteCommands);
 
 		// Post scene draw callback.
 		if (m_postSceneDrawCallback)
 			m_postSceneDrawCallback();
 
+		if (drawDebugLines)
+			m_debugRenderer.Flush(m_debugLineDrawParams);
+	}
+
+	void RenderEngine::ExecuteCommands(RenderCommandBuffer& commands)
+	{
+		commands.Execute(s_renderDevice, m_frameRingBuffer);
 	}
 
 	void RenderEngine::UpdateUniformBuffers()
 	{
 		Vector3 cameraLocation = m_cameraSystem.GetCameraLocation();
-		Vector4 viewPos = Vector4(cameraLocation.x, cameraLocation.y, cameraLocation.z, 1.0f);
+		ECS::CameraComponent* cameraComponent = m_cameraSystem.GetActiveCameraComponent();
 
-		// Update global matrix buffer
-		uintptr currentGlobalDataOffset = 0;
+		// Fill the blocks on the CPU, then upload each in one go.
+		ViewDataBlock viewData;
+		viewData.projection = m_cameraSystem.GetProjectionMatrix();
+		viewData.view = m_cameraSystem.GetViewMatrix();
+		viewData.lightSpace = m_lightingSystem.GetDirectionalLightMatrix();
+		viewData.cameraPosition = Vector4(cameraLocation.x, cameraLocation.y, cameraLocation.z, 1.0f);
+		viewData.cameraNear = cameraComponent != nullptr ? cameraComponent->m_zNear : 0.0f;
+		viewData.cameraFar = cameraComponent != nullptr ? cameraComponent->m_zFar : 0.0f;
 
-		m_globalDataBuffer.Update(&m_cameraSystem.GetProjectionMatrix()[0][0], currentGlobalDataOffset, sizeof(Matrix));
-		currentGlobalDataOffset += sizeof(Matrix);
+		// Cluster the lights for this view, shaders find their lights through the cluster grid.
+		m_lightingSystem.UpdateLightClusters(viewData.view, viewData.projection, viewData.cameraNear, viewData.cameraFar);
+		const LightClusterGrid& clusterGrid = m_lightingSystem.GetClusterGrid();
 
-		m_globalDataBuffer.Update(&m_cameraSystem.GetViewMatrix()[0][0], currentGlobalDataOffset, sizeof(Matrix));
-		currentGlobalDataOffset += sizeof(Matrix);
+		// Fit the shadow cascades to the same view.
+		Vector3 dirLightDirection = m_lightingSystem.GetDirectionalLightDirection();
+		m_shadowCascades.Update(viewData.view, viewData.projection, viewData.cameraNear, viewData.cameraFar, dirLightDirection);
 
-		m_globalDataBuffer.Update(&m_lightingSystem.GetDirectionalLightMatrix()[0][0], currentGlobalDataOffset, sizeof(Matrix));
-		currentGlobalDataOffset += sizeof(Matrix);
+		Color ambient = m_lightingSystem.GetAmbientColor();
+		Color dirLightColor = m_lightingSystem.GetDirectionalLightColor();
+		LightDataBlock lightData;
+		lightData.pointLightCount = clusterGrid.GetPointLightCount();
+		lightData.spotLightCount = clusterGrid.GetSpotLightCount();
+		lightData.ambientColor = Vector4(ambient.r, ambient.g, ambient.b, 1.0f);
+		lightData.dirLightPos = Vector4(cameraLocation.x, cameraLocation.y, cameraLocation.z, 1.0f);
+		lightData.dirLightDirection = Vector4(dirLightDirection.x, dirLightDirection.y, dirLightDirection.z, 0.0f);
+		lightData.dirLightColor = Vector4(dirLightColor.r, dirLightColor.g, dirLightColor.b, 1.0f);
+		lightData.clusterCounts[0] = LIGHTCLUSTER_X;
+		lightData.clusterCounts[1] = LIGHTCLUSTER_Y;
+		lightData.clusterCounts[2] = LIGHTCLUSTER_Z;
+		lightData.clusterCounts[3] = 0;
+		const Vector2 renderSize = GetScaledRenderSize();
+		lightData.clusterParams = Vector4(renderSize.x, renderSize.y, clusterGrid.GetSliceScale(), clusterGrid.GetSliceBias());
+
+		for (uint32 i = 0; i < SHADOWCASCADE_COUNT; i++)
+		{
+			const ShadowCascade& cascade = m_shadowCascades.GetCascade(i);
+			lightData.shadowCascades[i] = cascade.m_atlasMatrix;
+			lightData.shadowSplits[i] = cascade.m_splitFar;
+			lightData.shadowTexelSizes[i] = cascade.m_texelSize;
+		}
 
-		m_globalDataBuffer.Update(&viewPos, currentGlobalDataOffset, sizeof(Vector4));
-		currentGlobalDataOffset += sizeof(Vector4);
+		// Enabled, atlas texel size, depth bias & normal offset in cascade texels.
+		lightData.shadowParams = Vector4(m_shadowCascades.GetIsActive() ? 1.0f : 0.0f, 1.0f / m_shadowMapResolution.x, 0.0005f, 1.5f);
 
-		ECS::CameraComponent* cameraComponent = m_cameraSystem.GetActiveCameraComponent();
+		// SH irradiance of the HDRI, used instead of the irradiance cubemap when active.
+		for (uint32 i = 0; i < HDRICACHE_SH_COEFFICIENTS; i++)
+			lightData.irradianceSH[i] = Vector4(m_hdriIrradianceSH[i * 3], m_hdriIrradianceSH[i * 3 + 1], m_hdriIrradianceSH[i * 3 + 2], 0.0f);
 
-		if (cameraComponent != nullptr)
-		{
-			// Update only if changed.
-			if (m_bufferValueRecord.zNear != cameraComponent->m_zNear)
-			{
-				m_bufferValueRecord.zNear = cameraComponent->m_zNear;
-				m_globalDataBuffer.Update(&cameraComponent->m_zNear, currentGlobalDataOffset, sizeof(float));
-			}
-			currentGlobalDataOffset += sizeof(float);
+		lightData.iblParams = Vector4(m_hdriDataCaptured && m_hdriIrradianceSHActive ? 1.0f : 0.0f, 0.0f, 0.0f, 0.0f);
 
+		DebugDataBlock debugData;
+		debugData.visualizeDepth = m_debugData.visualizeDepth ? 1 : 0;
 
-			// Update only if changed.
-			if (m_bufferValueRecord.zFar != cameraComponent->m_zFar)
-			{
-				m_bufferValueRecord.zFar = cameraComponent->m_zFar;
-				m_globalDataBuffer.Update(&cameraComponent->m_zNear, currentGlobalDataOffset, sizeof(float));
-			}
-			currentGlobalDataOffset += sizeof(float);
-		}
+		UploadUniformBlock(m_globalDataBuffer, UNIFORMBUFFER_VIEWDATA_BINDPOINT, &viewData, sizeof(ViewDataBlock));
+		UploadUniformBlock(m_globalLightBuffer, UNIFORMBUFFER_LIGHTDATA_BINDPOINT, &lightData, sizeof(LightDataBlock));
+		UploadUniformBlock(m_globalDebugBuffer, UNIFORMBUFFER_DEBUGDATA_BINDPOINT, &debugData, sizeof(DebugDataBlock));
+	}
 
-		// Update lights buffer.
-		Color ambient = m_lightingSystem.GetAmbientColor();
-		Vector4 ambientColor = Vector4(ambient.r, ambient.g, ambient.b, 1.0f);
-		m_globalLightBuffer.Update(&m_currentPointLightCount, 0, sizeof(int));
-		m_globalLightBuffer.Update(&m_currentSpotLightCount, sizeof(int), sizeof(int));
-		m_globalLightBuffer.Update(&ambientColor, sizeof(int) * 2, sizeof(float) * 4);
-		m_globalLightBuffer.Update(&m_cameraSystem.GetCameraLocation(), (sizeof(int) * 2) + (sizeof(float) * 4), sizeof(float) * 4);
+	void RenderEngine::UploadUniformBlock(UniformBuffer& buffer, uint32 bindPoint, const void* data, uintptr dataSize)
+	{
+		// Bind a fresh range of the ring buffer, previous ranges might still be read by the GPU.
+		uintptr offset = m_frameRingBuffer.Write(data, dataSize, m_uniformBufferAlignment);
 
-		// Update debug fufer.
-		m_globalDebugBuffer.Update(&m_debugData.visualizeDepth, 0, sizeof(bool));
+		if (offset != RINGBUFFER_INVALID_OFFSET)
+			s_renderDevice.BindUniformBufferRange(m_frameRingBuffer.GetID(), bindPoint, offset, dataSize);
+		else
+		{
+			// Ring is full this frame, use the dedicated buffer.
+			buffer.Update(data, 0, dataSize);
+			buffer.Bind(bindPoint);
+		}
 	}
 
 	void RenderEngine::UpdateShaderData(Material* data)
 	{
+		// Immediate path, recorded & executed right away.
+		m_immediateCommands.Reset();
+		RecordShaderData(data, m_immediateCommands);
+		ExecuteCommands(m_immediateCommands);
+	}
 
-		s_renderDevice.SetShader(data->GetShaderID());
+	void RenderEngine::RecordShaderData(Material* data, RenderCommandBuffer& commands)
+	{
+		commands.SetShader(data->GetShaderID());
 
 		for (auto const& d : (*data).m_floats)
-			s_renderDevice.UpdateShaderUniformFloat(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformFloat(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_bools)
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformInt(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_colors)
-			s_renderDevice.UpdateShaderUniformColor(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformColor(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_ints)
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformInt(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_vector2s)
-			s_renderDevice.UpdateShaderUniformVector2(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformVector2(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_vector3s)
-			s_renderDevice.UpdateShaderUniformVector3(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformVector3(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_vector4s)
-			s_renderDevice.UpdateShaderUniformVector4F(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformVector4F(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_matrices)
-			s_renderDevice.UpdateShaderUniformMatrix(data->m_shaderID, d.first, d.second);
+			commands.UpdateShaderUniformMatrix(data->m_shaderID, d.first, d.second);
 
 		for (auto const& d : (*data).m_sampler2Ds)
 		{
 			// Set whether the texture is active or not.
 			bool isActive = (d.second.m_isActive && d.second.m_boundTexture != nullptr && !d.second.m_boundTexture->GetIsEmpty()) ? true : false;
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first + MAT_EXTENSION_ISACTIVE, isActive);
+			commands.UpdateShaderUniformInt(data->m_shaderID, d.first + MAT_EXTENSION_ISACTIVE, isActive);
 
 			// Set the texture to corresponding active unit.
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first + MAT_EXTENSION_TEXTURE2D, d.second.m_unit);
+			commands.UpdateShaderUniformInt(data->m_shaderID, d.first + MAT_EXTENSION_TEXTURE2D, d.second.m_unit);
 
 			// Set texture
 			if (isActive)
-				s_renderDevice.SetTexture(d.second.m_boundTexture->GetID(), d.second.m_boundTexture->GetSamplerID(), d.second.m_unit, d.second.m_bindMode, true);
+				commands.SetTexture(d.second.m_boundTexture->GetID(), d.second.m_boundTexture->GetSamplerID(), d.second.m_unit, d.second.m_bindMode, true);
 			else
 			{
 
 				if (d.second.m_bindMode == TextureBindMode::BINDTEXTURE_TEXTURE2D)
-					s_renderDevice.SetTexture(s_defaultTexture.GetID(), s_defaultTexture.GetSamplerID(), d.second.m_unit, BINDTEXTURE_TEXTURE2D);
+					commands.SetTexture(s_defaultTexture.GetID(), s_defaultTexture.GetSamplerID(), d.second.m_unit, BINDTEXTURE_TEXTURE2D);
 				else
-					s_renderDevice.SetTexture(m_defaultCubemapTexture.GetID(), m_defaultCubemapTexture.GetSamplerID(), d.second.m_unit, BINDTEXTURE_CUBEMAP);
+					commands.SetTexture(m_defaultCubemapTexture.GetID(), m_defaultCubemapTexture.GetSamplerID(), d.second.m_unit, BINDTEXTURE_CUBEMAP);
 			}
 		}
 
 
 		if (data->m_receivesLighting)
-			m_lightingSystem.SetLightingShaderData(data->GetShaderID());
+		{
+			m_lightingSystem.SetLightingShaderData(data->GetShaderID(), commands);
+
+			// Cascade atlas is bound to its own unit, past the material samplers.
+			commands.SetTexture(m_shadowMapRTTexture.GetID(), m_shadowMapRTTexture.GetSamplerID(), SHADOWCASCADE_UNIT, TextureBindMode::BINDTEXTURE_TEXTURE2D, true);
+			commands.UpdateShaderUniformInt(data->GetShaderID(), SC_SHADOWCASCADEMAP, SHADOWCASCADE_UNIT);
+			commands.UpdateShaderUniformInt(data->GetShaderID(), SC_RECEIVESHADOWS, data->m_isShadowMapped);
+		}
 
 	}
 
 	void RenderEngine::CaptureCalculateHDRI(Texture& hdriTexture)
 	{
-		// Create projection & view matrices for capturing HDRI data.
-		Matrix captureProjection = Matrix::PerspectiveRH(90.0f, 1.0f, 0.1f, 10.0f);
-		Matrix captureViews[] =
-		{
-			Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-			Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(-1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-			Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  1.0f,  0.0f), glm::vec3(0.0f,  0.0f,  1.0f)),
-			Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f,  0.0f), glm::vec3(0.0f,  0.0f, -1.0f)),
-			Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f,  1.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-			Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f, -1.0f), glm::vec3(0.0f, -1.0f,  0.0f))
-		};
-
-		// Calculate HDRI, Irradiance, Prefilter and BRDF
-		CalculateHDRICubemap(hdriTexture, captureProjection, captureViews);
-		CalculateHDRIIrradiance(captureProjection, captureViews);
-		CalculateHDRIPrefilter(captureProjection, captureViews);
-		CalculateHDRIBRDF(captureProjection, captureViews);
+		// The lut only depends on the BRDF, it's loaded once.
+		if (m_HDRILutMap.GetIsEmpty())
+			ConstructBRDFLut();
+
+		// Precomputed maps are cached per source image & capture resolution.
+		const uint32 resolution = (uint32)m_hdriResolution.x;
+		const uint64 sourceHash = hdriTexture.GetPath().empty() ? 0 : HDRICache::HashFile(hdriTexture.GetPath());
+		const std::string cachePath = HDRICache::GetCachePath(sourceHash, resolution);
+		HDRICacheData cache;
+
+		bool cacheValid = sourceHash != 0 && HDRICache::Load(cachePath, sourceHash, resolution, cache);
+		cacheValid = cacheValid && (m_useIrradianceSH ? cache.m_hasIrradianceSH : !cache.m_irradiance.empty());
+
+		if (cacheValid)
+		{
+			LoadHDRICache(cache);
+			LINA_CORE_TRACE("HDRI maps loaded from the cache. {0}", cachePath);
+		}
+		else
+		{
+			// Create projection & view matrices for capturing HDRI data.
+			Matrix captureProjection = Matrix::PerspectiveRH(90.0f, 1.0f, 0.1f, 10.0f);
+			Matrix captureViews[] =
+			{
+				Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
+				Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(-1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
+				Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  1.0f,  0.0f), glm::vec3(0.0f,  0.0f,  1.0f)),
+				Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f,  0.0f), glm::vec3(0.0f,  0.0f, -1.0f)),
+				Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f,  1.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
+				Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f, -1.0f), glm::vec3(0.0f, -1.0f,  0.0f))
+			};
+
+			// Calculate HDRI, read it back for the SH projection & the cache.
+			CalculateHDRICubemap(hdriTexture, captureProjection, captureViews);
+			cache.m_sourceHash = sourceHash;
+			cache.m_resolution = resolution;
+			bool readBack = ReadHDRICubemap(m_hdriCubemap, resolution, 1, cache.m_environment);
+
+			if (readBack)
+			{
+				HDRICache::ComputeIrradianceSH(cache.m_environment.data(), resolution, cache.m_irradianceSH);
+				cache.m_hasIrradianceSH = true;
+			}
+
+			// Irradiance cubemap is still needed if the SH path is off or the environment couldn't be read.
+			if (!m_useIrradianceSH || !readBack)
+			{
+				CalculateHDRIIrradiance(captureProjection, captureViews);
+				cache.m_irradianceResolution = HDRI_IRRADIANCE_RESOLUTION;
+				readBack = readBack && ReadHDRICubemap(m_hdriIrradianceMap, HDRI_IRRADIANCE_RESOLUTION, 1, cache.m_irradiance);
+			}
+
+			// Prefilter.
+			CalculateHDRIPrefilter(captureProjection, captureViews);
+			cache.m_prefilterResolution = HDRI_PREFILTER_RESOLUTION;
+			cache.m_prefilterMipCount = HDRI_PREFILTER_MIP_COUNT;
+			readBack = readBack && ReadHDRICubemap(m_hdriPrefilterMap, HDRI_PREFILTER_RESOLUTION, HDRI_PREFILTER_MIP_COUNT, cache.m_prefilter);
+
+			if (readBack && sourceHash != 0)
+				HDRICache::Save(cachePath, cache);
+		}
+
 		s_renderDevice.SetFBO(0);
 		s_renderDevice.SetViewport(m_viewportPos, m_viewportSize);
 
+		// Diffuse lighting is read from the light data block when the SH path is used.
+		m_hdriIrradianceSHActive = m_useIrradianceSH && cache.m_hasIrradianceSH;
+		std::copy(cache.m_irradianceSH, cache.m_irradianceSH + HDRICACHE_SH_COEFFICIENTS * 3, m_hdriIrradianceSH);
+
 		// Set flag
 		m_hdriDataCaptured = true;
 
@@ -752,19 +1078,8 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::CalculateHDRICubemap(Texture& hdriTexture, glm::mat4& captureProjection, glm::mat4 views[6])
 	{
-		// Generate sampler.
-		SamplerParameters samplerParams;
-		samplerParams.m_textureParams.m_wrapR = samplerParams.m_textureParams.m_wrapS = samplerParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
-		samplerParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-		samplerParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR_MIPMAP_LINEAR;
-		samplerParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
-		samplerParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
-
-		// Set resolution.
-		m_hdriResolution = Vector2(512, 512);
-
 		// Construct Cubemap texture.
-		m_hdriCubemap.ConstructRTCubemapTexture(s_renderDevice, m_hdriResolution, samplerParams);
+		m_hdriCubemap.ConstructRTCubemapTexture(s_renderDevice, m_hdriResolution, m_hdriCubemapParams);
 
 		// Setup shader data.
 		uint32 equirectangularShader = m_hdriEquirectangularShader->GetID();
@@ -774,6 +1089,7 @@ namespace LinaEngine::Graphics
 		s_renderDevice.UpdateShaderUniformMatrix(equirectangularShader, UF_MATRIX_PROJECTION, captureProjection);
 		s_renderDevice.SetTexture(hdriTexture.GetID(), hdriTexture.GetSamplerID(), 0);
 		s_renderDevice.SetFBO(m_hdriCaptureRenderTarget.GetID());
+		s_renderDevice.ResizeRenderBuffer(m_hdriCaptureRenderTarget.GetID(), m_hdriCaptureRenderBuffer.GetID(), m_hdriResolution, RenderBufferStorage::STORAGE_DEPTH_COMP24);
 		s_renderDevice.SetViewport(Vector2::Zero, m_hdriResolution);
 
 		// Draw the cubemap.
@@ -793,19 +1109,11 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::CalculateHDRIIrradiance(Matrix& captureProjection, Matrix views[6])
 	{
-		// Generate sampler.
-		SamplerParameters irradianceParams;
-		irradianceParams.m_textureParams.m_wrapR = irradianceParams.m_textureParams.m_wrapS = irradianceParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
-		irradianceParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-		irradianceParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR_MIPMAP_LINEAR;
-		irradianceParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
-		irradianceParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
-
 		// Set resolution
-		Vector2 irradianceMapResolsution = Vector2(32, 32);
+		Vector2 irradianceMapResolsution = Vector2(HDRI_IRRADIANCE_RESOLUTION, HDRI_IRRADIANCE_RESOLUTION);
 
 		// Create irradiance texture & scale render buffer according to the resolution.
-		m_hdriIrradianceMap.ConstructRTCubemapTexture(s_renderDevice, irradianceMapResolsution, irradianceParams);
+		m_hdriIrradianceMap.ConstructRTCubemapTexture(s_renderDevice, irradianceMapResolsution, m_hdriIrradianceParams);
 		s_renderDevice.SetFBO(m_hdriCaptureRenderTarget.GetID());
 		s_renderDevice.ResizeRenderBuffer(m_hdriCaptureRenderTarget.GetID(), m_hdriCaptureRenderBuffer.GetID(), irradianceMapResolsution, RenderBufferStorage::STORAGE_DEPTH_COMP24);
 
@@ -830,39 +1138,30 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::CalculateHDRIPrefilter(Matrix& captureProjection, Matrix views[6])
 	{
-		// Generate sampler.
-		SamplerParameters prefilterParams;
-		prefilterParams.m_textureParams.m_generateMipMaps = true;
-		prefilterParams.m_textureParams.m_wrapR = prefilterParams.m_textureParams.m_wrapS = prefilterParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
-		prefilterParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR_MIPMAP_LINEAR;
-		prefilterParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-		prefilterParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
-		prefilterParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
-
 		// Set resolution
-		Vector2 prefilterResolution = Vector2(128, 128);
+		Vector2 prefilterResolution = Vector2(HDRI_PREFILTER_RESOLUTION, HDRI_PREFILTER_RESOLUTION);
 
 		// Construct prefilter texture.
-		m_hdriPrefilterMap.ConstructRTCubemapTexture(s_renderDevice, prefilterResolution, prefilterParams);
+		m_hdriPrefilterMap.ConstructRTCubemapTexture(s_renderDevice, prefilterResolution, m_hdriPrefilterParams);
 
 		// Setup shader data.
 		uint32 prefilterShader = m_hdriPrefilterShader->GetID();
 		s_renderDevice.SetShader(prefilterShader);
 		s_renderDevice.UpdateShaderUniformInt(prefilterShader, MAT_MAP_ENVIRONMENT + std::string(MAT_EXTENSION_TEXTURE2D), 0);
 		s_renderDevice.UpdateShaderUniformInt(prefilterShader, MAT_MAP_ENVIRONMENT + std::string(MAT_EXTENSION_ISACTIVE), 1);
-		s_renderDevice.UpdateShaderUniformFloat(prefilterShader, MAT_ENVIRONMENTRESOLUTION, 512.0f);
+		s_renderDevice.UpdateShaderUniformFloat(prefilterShader, MAT_ENVIRONMENTRESOLUTION, m_hdriResolution.x);
 		s_renderDevice.UpdateShaderUniformMatrix(prefilterShader, UF_MATRIX_PROJECTION, captureProjection);
 		s_renderDevice.SetTexture(m_hdriCubemap.GetID(), m_hdriCubemap.GetSamplerID(), 0, TextureBindMode::BINDTEXTURE_CUBEMAP);
 
 		// Setup mip levels & switch fbo.
-		uint32 maxMipLevels = 5;
+		uint32 maxMipLevels = HDRI_PREFILTER_MIP_COUNT;
 		s_renderDevice.SetFBO(m_hdriCaptureRenderTarget.GetID());
 
 		for (uint32 mip = 0; mip < maxMipLevels; ++mip)
 		{
 			// reisze framebuffer according to mip-level size.
-			unsigned int mipWidth = 128 * std::pow(0.5, mip);
-			unsigned int mipHeight = 128 * std::pow(0.5, mip);
+			unsigned int mipWidth = HDRI_PREFILTER_RESOLUTION >> mip;
+			unsigned int mipHeight = HDRI_PREFILTER_RESOLUTION >> mip;
 			s_renderDevice.ResizeRenderBuffer(m_hdriCaptureRenderTarget.GetID(), m_hdriCaptureRenderBuffer.GetID(), Vector2(mipWidth, mipHeight), RenderBufferStorage::STORAGE_DEPTH_COMP24);
 			s_renderDevice.SetViewport(Vector2::Zero, Vector2(mipWidth, mipHeight));
 
@@ -879,35 +1178,83 @@ namespace LinaEngine::Graphics
 		}
 	}
 
-	void RenderEngine::CalculateHDRIBRDF(Matrix& captureProjection, Matrix views[6])
+	void RenderEngine::ConstructBRDFLut()
 	{
-		// Generate sampler.
-		SamplerParameters samplerParams;
-		samplerParams.m_textureParams.m_wrapR = samplerParams.m_textureParams.m_wrapS = samplerParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
-		samplerParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-		samplerParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR;
-		samplerParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
-		samplerParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
+		// Prebuilt asset, integrated on the CPU & written out if it's missing.
+		uint32 resolution = 0;
+		std::vector<float> lut;
+
+		if (!HDRICache::LoadBRDFLut(BRDFLUT_FULLPATH, resolution, lut))
+		{
+			LINA_CORE_WARN("BRDF lut {0} is missing, integrating it on the CPU.", BRDFLUT_FULLPATH);
+			resolution = BRDFLUT_RESOLUTION;
+			HDRICache::ComputeBRDFLut(resolution, BRDFLUT_SAMPLE_COUNT, lut);
+			HDRICache::SaveBRDFLut(BRDFLUT_FULLPATH, resolution, lut);
+		}
 
-		// Set resolution.
-		Vector2 brdfLutSize = Vector2(512, 512);
+		// Lut texture is RGB, blue is unused.
+		std::vector<float> pixels(resolution * resolution * 3, 0.0f);
+		for (uint32 i = 0; i < resolution * resolution; i++)
+		{
+			pixels[i * 3] = lut[i * 2];
+			pixels[i * 3 + 1] = lut[i * 2 + 1];
+		}
 
-		// Create BRDF texture.
-		m_HDRILutMap.ConstructHDRI(s_renderDevice, samplerParams, brdfLutSize, NULL);
+		m_HDRILutMap.ConstructHDRI(s_renderDevice, m_hdriLutParams, Vector2(resolution, resolution), pixels.data(), BRDFLUT_FULLPATH);
+	}
 
-		// Scale render buffer according to the resolution & bind lut map to frame buffer.
-		s_renderDevice.ResizeRenderBuffer(m_hdriCaptureRenderTarget.GetID(), m_hdriCaptureRenderBuffer.GetID(), brdfLutSize, RenderBufferStorage::STORAGE_DEPTH_COMP24);
-		s_renderDevice.BindTextureToRenderTarget(m_hdriCaptureRenderTarget.GetID(), m_HDRILutMap.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 0, 0, 0, true, false);
+	void RenderEngine::LoadHDRICache(const HDRICacheData& cache)
+	{
+		// Environment mips are generated, the rest is uploaded as is.
+		m_hdriCubemap.ConstructRTCubemapTexture(s_renderDevice, m_hdriResolution, m_hdriCubemapParams);
+		UploadHDRICubemap(m_hdriCubemap, cache.m_resolution, 1, cache.m_environment);
+		s_renderDevice.GenerateTextureMipmaps(m_hdriCubemap.GetID(), TextureBindMode::BINDTEXTURE_CUBEMAP);
 
-		// Setup shader.
-		uint32 brdfShader = m_hdriBRDFShader->GetID();
-		s_renderDevice.SetShader(brdfShader);
+		if (!cache.m_irradiance.empty())
+		{
+			m_hdriIrradianceMap.ConstructRTCubemapTexture(s_renderDevice, Vector2(cache.m_irradianceResolution, cache.m_irradianceResolution), m_hdriIrradianceParams);
+			UploadHDRICubemap(m_hdriIrradianceMap, cache.m_irradianceResolution, 1, cache.m_irradiance);
+		}
 
-		// Switch framebuffer & draw.
-		s_renderDevice.SetFBO(m_hdriCaptureRenderTarget.GetID());
-		s_renderDevice.SetViewport(Vector2::Zero, brdfLutSize);
-		s_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
-		s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
+		m_hdriPrefilterMap.ConstructRTCubemapTexture(s_renderDevice, Vector2(cache.m_prefilterResolution, cache.m_prefilterResolution), m_hdriPrefilterParams);
+		UploadHDRICubemap(m_hdriPrefilterMap, cache.m_prefilterResolution, cache.m_prefilterMipCount, cache.m_prefilter);
+	}
+
+	bool RenderEngine::ReadHDRICubemap(Texture& cubemap, uint32 resolution, uint32 mipCount, std::vector<uint16>& data)
+	{
+		data.resize(HDRICache::GetCubemapDataSize(resolution, mipCount));
+		uint16* texels = data.data();
+
+		for (uint32 mip = 0; mip < mipCount; mip++)
+		{
+			const uint32 mipResolution = std::max(resolution >> mip, 1u);
+
+			for (uint32 face = 0; face < 6; face++)
+			{
+				if (!s_renderDevice.ReadTextureHalf(cubemap.GetID(), (TextureBindMode)(TextureBindMode::BINDTEXTURE_CUBEMAP_POSITIVE_X + face), mip, texels, PixelFormat::FORMAT_RGB))
+					return false;
+
+				texels += mipResolution * mipResolution * 3;
+			}
+		}
+
+		return true;
+	}
+
+	void RenderEngine::UploadHDRICubemap(Texture& cubemap, uint32 resolution, uint32 mipCount, const std::vector<uint16>& data)
+	{
+		const uint16* texels = data.data();
+
+		for (uint32 mip = 0; mip < mipCount; mip++)
+		{
+			const uint32 mipResolution = std::max(resolution >> mip, 1u);
+
+			for (uint32 face = 0; face < 6; face++)
+			{
+				s_renderDevice.UpdateTextureHalf(cubemap.GetID(), (TextureBindMode)(TextureBindMode::BINDTEXTURE_CUBEMAP_POSITIVE_X + face), mip, Vector2(mipResolution, mipResolution), texels, PixelFormat::FORMAT_RGB);
+				texels += mipResolution * mipResolution * 3;
+			}
+		}
 	}
 
 	void RenderEngine::SetHDRIData(Material* mat)
@@ -924,7 +1271,12 @@ namespace LinaEngine::Graphics
 			return;
 		}
 
-		mat->SetTexture(MAT_TEXTURE2D_IRRADIANCEMAP, &m_hdriIrradianceMap, TextureBindMode::BINDTEXTURE_CUBEMAP);
+		// Diffuse lighting comes from the SH coefficients of the light data block instead.
+		if (m_hdriIrradianceSHActive)
+			mat->RemoveTexture(MAT_TEXTURE2D_IRRADIANCEMAP);
+		else
+			mat->SetTexture(MAT_TEXTURE2D_IRRADIANCEMAP, &m_hdriIrradianceMap, TextureBindMode::BINDTEXTURE_CUBEMAP);
+
 		mat->SetTexture(MAT_TEXTURE2D_BRDFLUTMAP, &m_HDRILutMap, TextureBindMode::BINDTEXTURE_TEXTURE2D);
 		mat->SetTexture(MAT_TEXTURE2D_PREFILTERMAP, &m_hdriPrefilterMap, TextureBindMode::BINDTEXTURE_CUBEMAP);
 	}
@@ -958,7 +1310,8 @@ namespace LinaEngine::Graphics
 #ifdef LINA_EDITOR
 		return (void*)m_secondaryRTTexture.GetID();
 #else
-		return (void*)m_primaryRTTexture0.GetID();
+		Texture* sceneColor = m_renderGraph.IsCompiled() ? m_renderGraph.GetTexture(m_rgSceneColor) : nullptr;
+		return (void*)(sceneColor != nullptr ? sceneColor->GetID() : 0);
 #endif
 	}
 
@@ -967,6 +1320,20 @@ namespace LinaEngine::Graphics
 		return (void*)m_shadowMapRTTexture.GetID();
 	}
 
+	void* RenderEngine::GetOcclusionBufferImage()
+	{
+		m_meshRendererSystem.GetOcclusionBuffer().GetDebugImage(m_occlusionDebugPixels);
+		s_renderDevice.UpdateTexture2D(m_occlusionDebugTexture.GetID(), Vector2(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT), m_occlusionDebugPixels.data(), m_occlusionDebugParams.m_textureParams.m_pixelFormat);
+		return (void*)m_occlusionDebugTexture.GetID();
+	}
+
+	void RenderEngine::KickOcclusionCulling()
+	{
+		// Refresh the camera matrices first so the occluders are rasterized from this frame's view.
+		m_cameraSystem.UpdateComponents(0.0f);
+		m_meshRendererSystem.KickOcclusionCulling();
+	}
+
 	void RenderEngine::UpdateSystems()
 	{
 		// Update pipeline.
@@ -0,0 +1,310 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderGraph.hpp"
+#include "Rendering/Texture.hpp"
+#include "Utility/Log.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace LinaEngine::Graphics
+{
+	void RenderGraph::Construct(RenderDevice& renderDeviceIn, const Vector2& renderSize)
+	{
+		s_renderDevice = &renderDeviceIn;
+		m_pool.Construct(renderDeviceIn, renderSize);
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_passes.clear();
+		m_resources.clear();
+		m_isCompiled = false;
+	}
+
+	uint32 RenderGraph::CreateTexture(const std::string& name, const SamplerParameters& samplerParams, float sizeScale)
+	{
+		const uint32 resource = AddResource(name, RenderGraphResourceType::Texture);
+		m_resources[resource].m_samplerParams = samplerParams;
+		m_resources[resource].m_sizeScale = sizeScale;
+		return resource;
+	}
+
+	uint32 RenderGraph::CreateDepthBuffer(const std::string& name, RenderBufferStorage storage, float sizeScale)
+	{
+		const uint32 resource = AddResource(name, RenderGraphResourceType::DepthBuffer);
+		m_resources[resource].m_storage = storage;
+		m_resources[resource].m_sizeScale = sizeScale;
+		return resource;
+	}
+
+	uint32 RenderGraph::ImportTarget(const std::string& name, uint32 fbo, Texture* texture, const Vector2& pos, const Vector2& size)
+	{
+		const uint32 resource = AddResource(name, RenderGraphResourceType::Imported);
+		m_resources[resource].m_importedTexture = texture;
+		UpdateImportedTarget(resource, fbo, pos, size);
+		return resource;
+	}
+
+	void RenderGraph::UpdateImportedTarget(uint32 resource, uint32 fbo, const Vector2& pos, const Vector2& size)
+	{
+		RenderGraphResource& target = m_resources[resource];
+		target.m_importedFBO = fbo;
+		target.m_importedPos = pos;
+		target.m_importedSize = size;
+	}
+
+	uint32 RenderGraph::AddPass(const std::string& name, const std::function<void()>& execute, bool hasSideEffects)
+	{
+		RenderGraphPass pass;
+		pass.m_name = name;
+		pass.m_execute = execute;
+		pass.m_hasSideEffects = hasSideEffects;
+		m_passes.push_back(pass);
+		m_isCompiled = false;
+		return (uint32)m_passes.size() - 1;
+	}
+
+	void RenderGraph::Read(uint32 pass, uint32 resource)
+	{
+		m_passes[pass].m_reads.push_back(resource);
+		m_isCompiled = false;
+	}
+
+	void RenderGraph::Write(uint32 pass, uint32 resource)
+	{
+		RenderGraphPass& target = m_passes[pass];
+		const RenderGraphResourceType type = m_resources[resource].m_type;
+
+		if (type == RenderGraphResourceType::Texture)
+		{
+			if (target.m_colorWrites.size() == RENDERTARGETPOOL_MAX_COLOR_ATTACHMENTS)
+			{
+				LINA_CORE_ERR("[Render Graph] -> Pass {0} exceeds the color attachment limit!", target.m_name);
+				return;
+			}
+
+			target.m_colorWrites.push_back(resource);
+		}
+		else if (type == RenderGraphResourceType::DepthBuffer)
+			target.m_depthWrite = resource;
+		else
+			target.m_importedWrite = resource;
+
+		m_isCompiled = false;
+	}
+
+	bool RenderGraph::Compile()
+	{
+		m_isCompiled = false;
+
+		for (RenderGraphResource& resource : m_resources)
+		{
+			resource.m_writer = RENDERGRAPH_INVALID_HANDLE;
+			resource.m_lastReader = RENDERGRAPH_INVALID_HANDLE;
+			resource.m_poolEntry = RENDERTARGETPOOL_INVALID_ENTRY;
+		}
+
+		// Every resource has a single producer.
+		for (uint32 i = 0; i < m_passes.size(); i++)
+		{
+			RenderGraphPass& pass = m_passes[i];
+			pass.m_acquires.clear();
+			pass.m_releases.clear();
+			pass.m_isCulled = true;
+
+			std::vector<uint32> writes = pass.m_colorWrites;
+			if (pass.m_depthWrite != RENDERGRAPH_INVALID_HANDLE) writes.push_back(pass.m_depthWrite);
+			if (pass.m_importedWrite != RENDERGRAPH_INVALID_HANDLE) writes.push_back(pass.m_importedWrite);
+
+			for (uint32 resource : writes)
+			{
+				if (m_resources[resource].m_writer != RENDERGRAPH_INVALID_HANDLE)
+				{
+					LINA_CORE_ERR("[Render Graph] -> {0} is written by both {1} & {2}!", m_resources[resource].m_name, m_passes[m_resources[resource].m_writer].m_name, pass.m_name);
+					return false;
+				}
+
+				m_resources[resource].m_writer = i;
+			}
+
+			for (uint32 resource : pass.m_reads)
+			{
+				const RenderGraphResource& read = m_resources[resource];
+				if (read.m_writer == RENDERGRAPH_INVALID_HANDLE && read.m_type != RenderGraphResourceType::Imported)
+				{
+					LINA_CORE_ERR("[Render Graph] -> {0} reads {1} before any pass writes it!", pass.m_name, read.m_name);
+					return false;
+				}
+			}
+		}
+
+		// Walk back from the passes with side effects, producers of what they read are kept.
+		std::vector<uint32> stack;
+		for (uint32 i = 0; i < m_passes.size(); i++)
+		{
+			if (m_passes[i].m_hasSideEffects)
+			{
+				m_passes[i].m_isCulled = false;
+				stack.push_back(i);
+			}
+		}
+
+		while (!stack.empty())
+		{
+			const uint32 pass = stack.back();
+			stack.pop_back();
+
+			for (uint32 resource : m_passes[pass].m_reads)
+			{
+				const uint32 writer = m_resources[resource].m_writer;
+				if (writer != RENDERGRAPH_INVALID_HANDLE && m_passes[writer].m_isCulled)
+				{
+					m_passes[writer].m_isCulled = false;
+					stack.push_back(writer);
+				}
+			}
+		}
+
+		// Passes run in order, the last reader ends the lifetime.
+		for (uint32 i = 0; i < m_passes.size(); i++)
+		{
+			if (m_passes[i].m_isCulled) continue;
+
+			for (uint32 resource : m_passes[i].m_reads)
+				m_resources[resource].m_lastReader = i;
+		}
+
+		// Color outputs nobody reads are left unattached, depth is kept for testing within the pass.
+		for (uint32 i = 0; i < m_resources.size(); i++)
+		{
+			const RenderGraphResource& resource = m_resources[i];
+			if (resource.m_type == RenderGraphResourceType::Imported || resource.m_writer == RENDERGRAPH_INVALID_HANDLE || m_passes[resource.m_writer].m_isCulled || !IsAttached(i)) continue;
+
+			const uint32 lastPass = resource.m_lastReader != RENDERGRAPH_INVALID_HANDLE ? resource.m_lastReader : resource.m_writer;
+			m_passes[resource.m_writer].m_acquires.push_back(i);
+			m_passes[lastPass].m_releases.push_back(i);
+		}
+
+		m_isCompiled = true;
+		return true;
+	}
+
+	void RenderGraph::Execute()
+	{
+		if (!m_isCompiled) return;
+
+		for (RenderGraphPass& pass : m_passes)
+		{
+			if (pass.m_isCulled) continue;
+
+			for (uint32 resource : pass.m_acquires)
+			{
+				RenderGraphResource& transient = m_resources[resource];
+				if (transient.m_type == RenderGraphResourceType::DepthBuffer)
+					transient.m_poolEntry = m_pool.AcquireDepthBuffer(transient.m_storage, transient.m_sizeScale);
+				else
+					transient.m_poolEntry = m_pool.AcquireTexture(transient.m_samplerParams, transient.m_sizeScale);
+			}
+
+			// Bind the pass targets.
+			if (pass.m_importedWrite != RENDERGRAPH_INVALID_HANDLE)
+			{
+				const RenderGraphResource& target = m_resources[pass.m_importedWrite];
+				s_renderDevice->SetFBO(target.m_importedFBO);
+				s_renderDevice->SetViewport(target.m_importedPos, target.m_importedSize);
+			}
+			else if (!pass.m_colorWrites.empty() || pass.m_depthWrite != RENDERGRAPH_INVALID_HANDLE)
+			{
+				uint32 colorEntries[RENDERTARGETPOOL_MAX_COLOR_ATTACHMENTS];
+				const uint32 depthEntry = pass.m_depthWrite != RENDERGRAPH_INVALID_HANDLE ? m_resources[pass.m_depthWrite].m_poolEntry : RENDERTARGETPOOL_INVALID_ENTRY;
+				uint32 sizeEntry = depthEntry;
+
+				for (uint32 i = 0; i < pass.m_colorWrites.size(); i++)
+				{
+					colorEntries[i] = IsAttached(pass.m_colorWrites[i]) ? m_resources[pass.m_colorWrites[i]].m_poolEntry : RENDERTARGETPOOL_INVALID_ENTRY;
+					if (sizeEntry == RENDERTARGETPOOL_INVALID_ENTRY)
+						sizeEntry = colorEntries[i];
+				}
+
+				if (sizeEntry != RENDERTARGETPOOL_INVALID_ENTRY)
+				{
+					s_renderDevice->SetFBO(m_pool.GetFrameBuffer(colorEntries, (uint32)pass.m_colorWrites.size(), depthEntry));
+					s_renderDevice->SetViewport(Vector2::Zero, GetScaledSize(m_pool.GetSize(sizeEntry)));
+				}
+			}
+
+			pass.m_execute();
+
+			for (uint32 resource : pass.m_releases)
+				m_pool.Release(m_resources[resource].m_poolEntry);
+		}
+
+		m_pool.NextFrame();
+	}
+
+	Texture* RenderGraph::GetTexture(uint32 resource)
+	{
+		const RenderGraphResource& target = m_resources[resource];
+		return target.m_type == RenderGraphResourceType::Imported ? target.m_importedTexture : m_pool.GetTexture(target.m_poolEntry);
+	}
+
+	Vector2 RenderGraph::GetSize(uint32 resource)
+	{
+		const RenderGraphResource& target = m_resources[resource];
+		return target.m_type == RenderGraphResourceType::Imported ? target.m_importedSize : m_pool.GetSize(target.m_poolEntry);
+	}
+
+	Vector2 RenderGraph::GetViewportSize(uint32 resource)
+	{
+		const RenderGraphResource& target = m_resources[resource];
+		return target.m_type == RenderGraphResourceType::Imported ? target.m_importedSize : GetScaledSize(m_pool.GetSize(target.m_poolEntry));
+	}
+
+	Vector2 RenderGraph::GetScaledSize(const Vector2& size) const
+	{
+		// Rounded to whole pixels & never collapsed, the smallest bloom mips would vanish otherwise.
+		return Vector2(std::max(1.0f, std::floor(size.x * m_viewportScale + 0.5f)), std::max(1.0f, std::floor(size.y * m_viewportScale + 0.5f)));
+	}
+
+	uint32 RenderGraph::AddResource(const std::string& name, RenderGraphResourceType type)
+	{
+		RenderGraphResource resource;
+		resource.m_name = name;
+		resource.m_type = type;
+		m_resources.push_back(resource);
+		m_isCompiled = false;
+		return (uint32)m_resources.size() - 1;
+	}
+
+	bool RenderGraph::IsAttached(uint32 resource) const
+	{
+		const RenderGraphResource& target = m_resources[resource];
+		return target.m_type == RenderGraphResourceType::DepthBuffer || target.m_lastReader != RENDERGRAPH_INVALID_HANDLE;
+	}
+}
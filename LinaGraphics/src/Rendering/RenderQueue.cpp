@@ -0,0 +1,174 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderQueue.hpp"
+#include "Core/Timer.hpp"
+#include <cstring>
+
+namespace LinaEngine::Graphics
+{
+#define RENDERQUEUE_DEPTH_BITS 24
+#define RENDERQUEUE_DEPTH_MAX ((1u << RENDERQUEUE_DEPTH_BITS) - 1)
+#define RENDERQUEUE_SHADER_MASK 0x3FFu
+#define RENDERQUEUE_MATERIAL_MASK 0x3FFFu
+#define RENDERQUEUE_MESH_MASK 0x3FFFu
+#define RENDERQUEUE_RADIX_BITS 8
+#define RENDERQUEUE_RADIX_SIZE (1 << RENDERQUEUE_RADIX_BITS)
+#define RENDERQUEUE_RADIX_PASSES (64 / RENDERQUEUE_RADIX_BITS)
+
+	uint64 RenderQueue::GenerateKey(RenderQueuePass pass, uint32 shaderID, uint32 materialID, uint32 meshID, float normalizedDepth)
+	{
+		// Quantize the depth to fit into the key.
+		float clampedDepth = normalizedDepth < 0.0f ? 0.0f : (normalizedDepth > 1.0f ? 1.0f : normalizedDepth);
+		uint64 depth = (uint64)(clampedDepth * (float)RENDERQUEUE_DEPTH_MAX);
+		uint64 shader = shaderID & RENDERQUEUE_SHADER_MASK;
+		uint64 material = materialID & RENDERQUEUE_MATERIAL_MASK;
+		uint64 mesh = meshID & RENDERQUEUE_MESH_MASK;
+		uint64 key = (uint64)pass << 62;
+
+		// Opaque: pass(2) | shader(10) | material(14) | mesh(14) | depth(24), front-to-back within the same state.
+		// Transparent: pass(2) | inverted depth(24) | shader(10) | material(14) | mesh(14), back-to-front regardless of state.
+		if (pass == RenderQueuePass::Opaque)
+			key |= (shader << 52) | (material << 38) | (mesh << 24) | depth;
+		else
+			key |= ((RENDERQUEUE_DEPTH_MAX - depth) << 38) | (shader << 28) | (material << 14) | mesh;
+
+		return key;
+	}
+
+	void RenderQueue::Push(uint64 key, VertexArray& vertexArray, Material& material, const Matrix& model)
+	{
+		RenderQueueItem item;
+		item.m_key = key;
+		item.m_drawIndex = (uint32)m_draws.size();
+		m_items.push_back(item);
+
+		RenderQueueDraw& draw = m_draws.emplace_back();
+		draw.m_vertexArray = &vertexArray;
+		draw.m_material = &material;
+		draw.m_transform = InstanceTransform(model);
+		m_isSorted = false;
+	}
+
+	void RenderQueue::Reserve(size_t count)
+	{
+		m_items.reserve(count);
+		m_draws.reserve(count);
+		m_instances.reserve(count);
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_items.clear();
+		m_draws.clear();
+		m_batches.clear();
+		m_instances.clear();
+		m_isSorted = true;
+	}
+
+	void RenderQueue::Sort()
+	{
+		if (m_isSorted) return;
+
+		LINA_TIMER_START("[Graphics] Render Queue Sort");
+		RadixSort();
+
+		// Lay out the instance data in the sorted order & merge draws sharing the same state.
+		m_batches.clear();
+		m_instances.resize(m_items.size());
+
+		for (uint32 i = 0; i < (uint32)m_items.size(); i++)
+		{
+			const RenderQueueDraw& draw = m_draws[m_items[i].m_drawIndex];
+			m_instances[i] = draw.m_transform;
+
+			if (!m_batches.empty() && m_batches.back().m_vertexArray == draw.m_vertexArray && m_batches.back().m_material == draw.m_material)
+			{
+				m_batches.back().m_instanceCount++;
+				continue;
+			}
+
+			RenderQueueBatch& batch = m_batches.emplace_back();
+			batch.m_vertexArray = draw.m_vertexArray;
+			batch.m_material = draw.m_material;
+			batch.m_firstInstance = i;
+			batch.m_instanceCount = 1;
+		}
+
+		m_isSorted = true;
+		LINA_TIMER_STOP("[Graphics] Render Queue Sort");
+	}
+
+	void RenderQueue::RadixSort()
+	{
+		const size_t count = m_items.size();
+		if (count < 2) return;
+
+		// Build all digit histograms in a single pass over the keys.
+		uint32 histograms[RENDERQUEUE_RADIX_PASSES][RENDERQUEUE_RADIX_SIZE];
+		std::memset(histograms, 0, sizeof(histograms));
+
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64 key = m_items[i].m_key;
+			for (int pass = 0; pass < RENDERQUEUE_RADIX_PASSES; pass++)
+				histograms[pass][(key >> (pass * RENDERQUEUE_RADIX_BITS)) & (RENDERQUEUE_RADIX_SIZE - 1)]++;
+		}
+
+		m_sortBuffer.resize(count);
+		RenderQueueItem* source = m_items.data();
+		RenderQueueItem* destination = m_sortBuffer.data();
+
+		for (int pass = 0; pass < RENDERQUEUE_RADIX_PASSES; pass++)
+		{
+			const int shift = pass * RENDERQUEUE_RADIX_BITS;
+			uint32* histogram = histograms[pass];
+
+			// Skip digits all keys share, which is common for the pass & shader bits.
+			if (histogram[(source[0].m_key >> shift) & (RENDERQUEUE_RADIX_SIZE - 1)] == count)
+				continue;
+
+			uint32 offset = 0;
+			for (int i = 0; i < RENDERQUEUE_RADIX_SIZE; i++)
+			{
+				uint32 bucketCount = histogram[i];
+				histogram[i] = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				destination[histogram[(source[i].m_key >> shift) & (RENDERQUEUE_RADIX_SIZE - 1)]++] = source[i];
+
+			std::swap(source, destination);
+		}
+
+		// Make sure the sorted items end up in the item list.
+		if (source != m_items.data())
+			m_items.swap(m_sortBuffer);
+	}
+}
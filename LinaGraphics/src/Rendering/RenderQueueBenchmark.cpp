@@ -0,0 +1,209 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderQueueBenchmark.hpp"
+#include "Rendering/RenderQueue.hpp"
+#include "Rendering/VertexArray.hpp"
+#include "Rendering/Material.hpp"
+#include "Utility/Log.hpp"
+#include "Core/Timer.hpp"
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <tuple>
+
+#define RENDERQUEUEBENCHMARK_MESH_COUNT 64
+#define RENDERQUEUEBENCHMARK_MATERIAL_COUNT 32
+#define RENDERQUEUEBENCHMARK_SHADER_COUNT 8
+
+namespace LinaEngine::Graphics
+{
+	// The batching MeshRendererSystem used before the sort-key queues.
+	struct MapDrawData
+	{
+		VertexArray* m_vertexArray;
+		Material* m_material;
+		float m_distance;
+	};
+
+	struct MapModelData
+	{
+		std::vector<Matrix> m_models;
+		std::vector<Matrix> m_inverseTransposeModels;
+	};
+
+	typedef std::tuple<MapDrawData, MapModelData> MapPair;
+
+	struct MapPairComparison
+	{
+		bool operator()(const MapPair& lhs, const MapPair& rhs) const
+		{
+			return std::get<0>(lhs).m_distance < std::get<0>(rhs).m_distance;
+		}
+	};
+
+	struct MapDrawDataComparison
+	{
+		bool operator()(const MapDrawData& lhs, const MapDrawData& rhs) const
+		{
+			return std::tie(lhs.m_vertexArray, lhs.m_material) < std::tie(rhs.m_vertexArray, rhs.m_material);
+		}
+	};
+
+	struct BenchmarkDraw
+	{
+		uint32 m_mesh = 0;
+		uint32 m_material = 0;
+		bool m_transparent = false;
+		float m_depth = 0.0f;
+		Matrix m_model;
+	};
+
+	std::vector<RenderQueueBenchmarkResult> RenderQueueBenchmark::Run(const std::vector<size_t>& drawCounts, uint32 iterations)
+	{
+		// Stand-ins are never constructed on a device, only their addresses end up in the batches.
+		std::unique_ptr<VertexArray[]> vertexArrays(new VertexArray[RENDERQUEUEBENCHMARK_MESH_COUNT]);
+		std::unique_ptr<Material[]> materials(new Material[RENDERQUEUEBENCHMARK_MATERIAL_COUNT]);
+		std::vector<RenderQueueBenchmarkResult> results;
+
+		for (size_t drawCount : drawCounts)
+		{
+			// Random but repeatable draws.
+			std::mt19937 random(1337);
+			std::uniform_int_distribution<uint32> meshRange(0, RENDERQUEUEBENCHMARK_MESH_COUNT - 1), materialRange(0, RENDERQUEUEBENCHMARK_MATERIAL_COUNT - 1), passRange(0, 4);
+			std::uniform_real_distribution<float> positionRange(-500.0f, 500.0f), depthRange(0.0f, 1.0f);
+
+			std::vector<BenchmarkDraw> draws(drawCount);
+			for (BenchmarkDraw& draw : draws)
+			{
+				draw.m_mesh = meshRange(random);
+				draw.m_material = materialRange(random);
+				draw.m_transparent = passRange(random) == 0;
+				draw.m_depth = depthRange(random);
+				draw.m_model = Matrix::Translate(Vector3(positionRange(random), positionRange(random), positionRange(random)));
+			}
+
+			RenderQueueBenchmarkResult result;
+			result.m_drawCount = drawCount;
+
+			// Map & priority queue path.
+			std::map<MapDrawData, MapModelData, MapDrawDataComparison> opaqueBatch;
+			std::priority_queue<MapPair, std::vector<MapPair>, MapPairComparison> transparentBatch;
+
+			auto mapBuild = [&]()
+			{
+				for (const BenchmarkDraw& draw : draws)
+				{
+					MapDrawData drawData;
+					drawData.m_vertexArray = &vertexArrays[draw.m_mesh];
+					drawData.m_material = &materials[draw.m_material];
+					drawData.m_distance = draw.m_depth;
+
+					if (!draw.m_transparent)
+					{
+						MapModelData& modelData = opaqueBatch[drawData];
+						modelData.m_models.push_back(draw.m_model);
+						modelData.m_inverseTransposeModels.push_back(draw.m_model.Transpose().Inverse());
+					}
+					else
+					{
+						MapModelData modelData;
+						modelData.m_models.push_back(draw.m_model);
+						modelData.m_inverseTransposeModels.push_back(draw.m_model.Transpose().Inverse());
+						transparentBatch.emplace(std::make_pair(drawData, modelData));
+					}
+				}
+			};
+
+			auto mapClear = [&]()
+			{
+				opaqueBatch.clear();
+				transparentBatch = std::priority_queue<MapPair, std::vector<MapPair>, MapPairComparison>();
+			};
+
+			result.m_mapBuildMS = Timer::TimeBest(iterations, mapClear, mapBuild);
+			result.m_mapFlushMS = Timer::TimeBest(iterations, [&]() { mapClear(); mapBuild(); }, [&]()
+			{
+				size_t batchCount = opaqueBatch.size();
+				for (std::map<MapDrawData, MapModelData, MapDrawDataComparison>::iterator it = opaqueBatch.begin(); it != opaqueBatch.end(); ++it)
+					it->second.m_models.clear();
+
+				for (; !transparentBatch.empty(); batchCount++)
+					transparentBatch.pop();
+
+				result.m_mapBatchCount = batchCount;
+			});
+
+			// Sort-key path, keys are generated the way MeshRendererSystem does.
+			RenderQueue opaqueQueue, transparentQueue;
+			opaqueQueue.Reserve(drawCount);
+			transparentQueue.Reserve(drawCount);
+
+			auto queueBuild = [&]()
+			{
+				for (const BenchmarkDraw& draw : draws)
+				{
+					const uint32 shaderID = draw.m_material % RENDERQUEUEBENCHMARK_SHADER_COUNT;
+
+					if (!draw.m_transparent)
+						opaqueQueue.Push(RenderQueue::GenerateKey(RenderQueuePass::Opaque, shaderID, draw.m_material, draw.m_mesh, draw.m_depth), vertexArrays[draw.m_mesh], materials[draw.m_material], draw.m_model);
+					else
+						transparentQueue.Push(RenderQueue::GenerateKey(RenderQueuePass::Transparent, shaderID, draw.m_material, draw.m_mesh, draw.m_depth), vertexArrays[draw.m_mesh], materials[draw.m_material], draw.m_model);
+				}
+			};
+
+			auto queueClear = [&]()
+			{
+				opaqueQueue.Clear();
+				transparentQueue.Clear();
+			};
+
+			result.m_queueBuildMS = Timer::TimeBest(iterations, queueClear, queueBuild);
+			result.m_queueSortMS = Timer::TimeBest(iterations, [&]() { queueClear(); queueBuild(); }, [&]()
+			{
+				opaqueQueue.Sort();
+				transparentQueue.Sort();
+			});
+
+			result.m_queueBatchCount = opaqueQueue.GetBatches().size() + transparentQueue.GetBatches().size();
+			results.push_back(result);
+		}
+
+		return results;
+	}
+
+	void RenderQueueBenchmark::LogResults(const std::vector<RenderQueueBenchmarkResult>& results)
+	{
+		for (const RenderQueueBenchmarkResult& result : results)
+		{
+			LINA_CORE_TRACE("[Render Queue Benchmark] {0} draws: map build {1:.3f} ms, flush {2:.3f} ms, {3} batches", result.m_drawCount, result.m_mapBuildMS, result.m_mapFlushMS, result.m_mapBatchCount);
+			LINA_CORE_TRACE("[Render Queue Benchmark] {0} draws: queue build {1:.3f} ms, sort {2:.3f} ms, {3} batches", result.m_drawCount, result.m_queueBuildMS, result.m_queueSortMS, result.m_queueBatchCount);
+		}
+	}
+}
@@ -0,0 +1,265 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderTargetPool.hpp"
+#include "Rendering/Texture.hpp"
+
+namespace LinaEngine::Graphics
+{
+	// GLOBALS DECLARATIONS
+	static bool IsMatchingFormat(const TextureParameters& a, const TextureParameters& b);
+
+	RenderTargetPool::~RenderTargetPool()
+	{
+		for (uint32 i = 0; i < m_entries.size(); i++)
+		{
+			if (m_entries[i].m_isAllocated)
+				Free(i);
+		}
+	}
+
+	void RenderTargetPool::Construct(RenderDevice& renderDeviceIn, const Vector2& renderSize)
+	{
+		s_renderDevice = &renderDeviceIn;
+		m_renderSize = renderSize;
+	}
+
+	uint32 RenderTargetPool::AcquireTexture(const SamplerParameters& samplerParams, float sizeScale)
+	{
+		return Acquire(false, samplerParams, RenderBufferStorage::STORAGE_DEPTH, sizeScale);
+	}
+
+	uint32 RenderTargetPool::AcquireDepthBuffer(RenderBufferStorage storage, float sizeScale)
+	{
+		return Acquire(true, SamplerParameters(), storage, sizeScale);
+	}
+
+	uint32 RenderTargetPool::Acquire(bool isDepth, const SamplerParameters& samplerParams, RenderBufferStorage storage, float sizeScale)
+	{
+		// Reuse a released allocation of the same format, this is where passes with disjoint lifetimes alias.
+		for (uint32 i = 0; i < m_entries.size(); i++)
+		{
+			RenderTargetPoolEntry& entry = m_entries[i];
+			if (!entry.m_isAllocated || entry.m_inUse || entry.m_isDepth != isDepth || entry.m_sizeScale != sizeScale) continue;
+
+			if (isDepth ? entry.m_storage == storage : IsMatchingFormat(entry.m_samplerParams.m_textureParams, samplerParams.m_textureParams))
+			{
+				entry.m_inUse = true;
+				entry.m_lastUsedFrame = m_frame;
+				return i;
+			}
+		}
+
+		const uint32 index = FindFreeSlot();
+		RenderTargetPoolEntry& entry = m_entries[index];
+		entry.m_isDepth = isDepth;
+		entry.m_samplerParams = samplerParams;
+		entry.m_storage = storage;
+		entry.m_sizeScale = sizeScale;
+		entry.m_size = GetScaledSize(sizeScale);
+		entry.m_isAllocated = true;
+		entry.m_inUse = true;
+		entry.m_lastUsedFrame = m_frame;
+
+		if (isDepth)
+		{
+			entry.m_renderBuffer = s_renderDevice->CreateRenderBufferObject(storage, (uint32)entry.m_size.x, (uint32)entry.m_size.y, 0);
+			m_depthBufferCount++;
+		}
+		else
+		{
+			entry.m_texture = new Texture();
+			entry.m_texture->ConstructRTTexture(*s_renderDevice, entry.m_size, samplerParams, false);
+			m_textureCount++;
+		}
+
+		return index;
+	}
+
+	void RenderTargetPool::Release(uint32 entry)
+	{
+		if (entry < m_entries.size())
+			m_entries[entry].m_inUse = false;
+	}
+
+	uint32 RenderTargetPool::GetFrameBuffer(const uint32* colorEntries, uint32 colorCount, uint32 depthEntry)
+	{
+		// Attachments are stable across resizes, so is the frame buffer.
+		for (RenderTargetPoolFrameBuffer& frameBuffer : m_frameBuffers)
+		{
+			if (frameBuffer.m_colorCount != colorCount || frameBuffer.m_depthEntry != depthEntry) continue;
+
+			bool matches = true;
+			for (uint32 i = 0; i < colorCount && matches; i++)
+				matches = frameBuffer.m_colorEntries[i] == colorEntries[i];
+
+			if (matches)
+				return frameBuffer.m_fbo;
+		}
+
+		RenderTargetPoolFrameBuffer frameBuffer;
+		frameBuffer.m_colorCount = colorCount;
+		frameBuffer.m_depthEntry = depthEntry;
+
+		uint32 firstColor = RENDERTARGETPOOL_INVALID_ENTRY;
+		for (uint32 i = 0; i < colorCount; i++)
+		{
+			frameBuffer.m_colorEntries[i] = colorEntries[i];
+			if (firstColor == RENDERTARGETPOOL_INVALID_ENTRY && colorEntries[i] != RENDERTARGETPOOL_INVALID_ENTRY)
+				firstColor = i;
+		}
+
+		const bool hasDepth = depthEntry != RENDERTARGETPOOL_INVALID_ENTRY;
+		const uint32 rbo = hasDepth ? m_entries[depthEntry].m_renderBuffer : 0;
+		const Vector2 size = firstColor != RENDERTARGETPOOL_INVALID_ENTRY ? m_entries[colorEntries[firstColor]].m_size : m_entries[depthEntry].m_size;
+
+		if (firstColor == RENDERTARGETPOOL_INVALID_ENTRY)
+			frameBuffer.m_fbo = s_renderDevice->CreateRenderTarget(0, (int32)size.x, (int32)size.y, TextureBindMode::BINDTEXTURE_NONE, FrameBufferAttachment::ATTACHMENT_COLOR, 0, 0, true, true, FrameBufferAttachment::ATTACHMENT_DEPTH, rbo, false);
+		else
+		{
+			const uint32 texture = m_entries[colorEntries[firstColor]].m_texture->GetID();
+			frameBuffer.m_fbo = s_renderDevice->CreateRenderTarget(texture, (int32)size.x, (int32)size.y, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, firstColor, 0, false, hasDepth, FrameBufferAttachment::ATTACHMENT_DEPTH, rbo, true);
+		}
+
+		// Bind the remaining color attachments, unattached slots are left out of the draw buffers.
+		if (colorCount > 1)
+		{
+			uint32 drawBuffers[RENDERTARGETPOOL_MAX_COLOR_ATTACHMENTS];
+			for (uint32 i = 0; i < colorCount; i++)
+			{
+				const bool attached = colorEntries[i] != RENDERTARGETPOOL_INVALID_ENTRY;
+				if (attached && i != firstColor)
+					s_renderDevice->BindTextureToRenderTarget(frameBuffer.m_fbo, m_entries[colorEntries[i]].m_texture->GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, i);
+
+				drawBuffers[i] = attached ? (FrameBufferAttachment::ATTACHMENT_COLOR + i) : 0;
+			}
+
+			s_renderDevice->MultipleDrawBuffersCommand(frameBuffer.m_fbo, colorCount, drawBuffers);
+		}
+
+		m_frameBuffers.push_back(frameBuffer);
+		return frameBuffer.m_fbo;
+	}
+
+	void RenderTargetPool::Resize(const Vector2& renderSize)
+	{
+		m_renderSize = renderSize;
+
+		// Storage is re-specified on the same objects, attachments of the cached frame buffers remain.
+		for (RenderTargetPoolEntry& entry : m_entries)
+		{
+			if (!entry.m_isAllocated) continue;
+
+			entry.m_size = GetScaledSize(entry.m_sizeScale);
+
+			if (entry.m_isDepth)
+				s_renderDevice->ResizeRenderBuffer(0, entry.m_renderBuffer, entry.m_size, entry.m_storage);
+			else
+			{
+				const TextureParameters& params = entry.m_samplerParams.m_textureParams;
+				s_renderDevice->ResizeRTTexture(entry.m_texture->GetID(), entry.m_size, params.m_internalPixelFormat, params.m_pixelFormat);
+				entry.m_texture->m_size = entry.m_size;
+			}
+		}
+	}
+
+	void RenderTargetPool::NextFrame()
+	{
+		m_frame++;
+
+		for (uint32 i = 0; i < m_entries.size(); i++)
+		{
+			const RenderTargetPoolEntry& entry = m_entries[i];
+			if (entry.m_isAllocated && !entry.m_inUse && m_frame - entry.m_lastUsedFrame > RENDERTARGETPOOL_MAX_IDLE_FRAMES)
+				Free(i);
+		}
+	}
+
+	uint32 RenderTargetPool::FindFreeSlot()
+	{
+		for (uint32 i = 0; i < m_entries.size(); i++)
+		{
+			if (!m_entries[i].m_isAllocated)
+				return i;
+		}
+
+		m_entries.push_back(RenderTargetPoolEntry());
+		return (uint32)m_entries.size() - 1;
+	}
+
+	Vector2 RenderTargetPool::GetScaledSize(float sizeScale) const
+	{
+		const float width = (float)(int)(m_renderSize.x * sizeScale);
+		const float height = (float)(int)(m_renderSize.y * sizeScale);
+		return Vector2(width < 1.0f ? 1.0f : width, height < 1.0f ? 1.0f : height);
+	}
+
+	void RenderTargetPool::Free(uint32 index)
+	{
+		// Frame buffers referencing the allocation go first.
+		for (uint32 i = 0; i < m_frameBuffers.size();)
+		{
+			RenderTargetPoolFrameBuffer& frameBuffer = m_frameBuffers[i];
+			bool references = frameBuffer.m_depthEntry == index;
+			for (uint32 j = 0; j < frameBuffer.m_colorCount && !references; j++)
+				references = frameBuffer.m_colorEntries[j] == index;
+
+			if (references)
+			{
+				s_renderDevice->ReleaseRenderTarget(frameBuffer.m_fbo);
+				m_frameBuffers[i] = m_frameBuffers.back();
+				m_frameBuffers.pop_back();
+			}
+			else
+				i++;
+		}
+
+		RenderTargetPoolEntry& entry = m_entries[index];
+
+		if (entry.m_isDepth)
+		{
+			entry.m_renderBuffer = s_renderDevice->ReleaseRenderBufferObject(entry.m_renderBuffer);
+			m_depthBufferCount--;
+		}
+		else
+		{
+			delete entry.m_texture;
+			entry.m_texture = nullptr;
+			m_textureCount--;
+		}
+
+		entry.m_isAllocated = false;
+		entry.m_inUse = false;
+	}
+
+	static bool IsMatchingFormat(const TextureParameters& a, const TextureParameters& b)
+	{
+		return a.m_pixelFormat == b.m_pixelFormat && a.m_internalPixelFormat == b.m_internalPixelFormat && a.m_minFilter == b.m_minFilter && a.m_magFilter == b.m_magFilter
+			&& a.m_wrapS == b.m_wrapS && a.m_wrapT == b.m_wrapT;
+	}
+}
@@ -0,0 +1,138 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RingBuffer.hpp"
+#include "PackageManager/Generic/GenericMemory.hpp"
+
+namespace LinaEngine::Graphics
+{
+#define RINGBUFFER_FRAME_ALIGNMENT 256
+
+	RingBuffer::~RingBuffer()
+	{
+		if (m_isConstructed)
+			Release();
+	}
+
+	void RingBuffer::Construct(RenderDevice& renderDeviceIn, uintptr frameSize)
+	{
+		s_renderDevice = &renderDeviceIn;
+		Create(frameSize);
+		m_isConstructed = true;
+	}
+
+	uintptr RingBuffer::Write(const void* data, uintptr dataSize, uintptr alignment)
+	{
+		// Align the head, segments start at RINGBUFFER_FRAME_ALIGNMENT so offsets inherit the alignment.
+		uintptr alignedHead = (m_head + alignment - 1) / alignment * alignment;
+
+		if (alignedHead + dataSize > m_frameSize)
+		{
+			m_overflowed = true;
+			m_peakUsage = m_peakUsage > alignedHead + dataSize ? m_peakUsage : alignedHead + dataSize;
+			return RINGBUFFER_INVALID_OFFSET;
+		}
+
+		uintptr offset = m_frameIndex * m_frameSize + alignedHead;
+
+		if (m_mappedData != nullptr)
+			GenericMemory::memcpy(m_mappedData + offset, data, dataSize);
+		else
+			s_renderDevice->WriteRingBuffer(m_engineBoundID, offset, data, dataSize);
+
+		m_head = alignedHead + dataSize;
+		m_peakUsage = m_peakUsage > m_head ? m_peakUsage : m_head;
+		return offset;
+	}
+
+	void RingBuffer::NextFrame()
+	{
+		// Mark the end of the GPU commands reading the current segment.
+		if (m_mappedData != nullptr)
+			m_fences[m_frameIndex] = s_renderDevice->CreateFence();
+
+		// Grow to fit the peak usage, rare so simply recreate everything.
+		if (m_overflowed)
+		{
+			uintptr newSize = m_frameSize * 2;
+			while (newSize < m_peakUsage) newSize *= 2;
+			LINA_CORE_WARN("Ring buffer frame size exceeded, growing from {0} to {1} bytes.", m_frameSize, newSize);
+			Release();
+			Create(newSize);
+			return;
+		}
+
+		m_frameIndex = (m_frameIndex + 1) % RINGBUFFER_FRAME_COUNT;
+		m_head = 0;
+
+		if (m_mappedData != nullptr)
+		{
+			// Wait until the GPU stopped reading the segment we are about to overwrite.
+			if (m_fences[m_frameIndex] != nullptr)
+			{
+				s_renderDevice->WaitFence(m_fences[m_frameIndex]);
+				s_renderDevice->ReleaseFence(m_fences[m_frameIndex]);
+				m_fences[m_frameIndex] = nullptr;
+			}
+		}
+		else if (m_frameIndex == 0)
+		{
+			// Without persistent mapping the driver takes care of in flight data once the storage is orphaned.
+			s_renderDevice->OrphanRingBuffer(m_engineBoundID, m_frameSize * RINGBUFFER_FRAME_COUNT);
+		}
+	}
+
+	void RingBuffer::Create(uintptr frameSize)
+	{
+		void* mappedData = nullptr;
+		m_frameSize = (frameSize + RINGBUFFER_FRAME_ALIGNMENT - 1) / RINGBUFFER_FRAME_ALIGNMENT * RINGBUFFER_FRAME_ALIGNMENT;
+		m_engineBoundID = s_renderDevice->CreateRingBuffer(m_frameSize * RINGBUFFER_FRAME_COUNT, &mappedData);
+		m_mappedData = (uint8*)mappedData;
+		m_frameIndex = 0;
+		m_head = 0;
+		m_peakUsage = 0;
+		m_overflowed = false;
+	}
+
+	void RingBuffer::Release()
+	{
+		// Make sure no segment is in use before deleting the storage.
+		for (uint32 i = 0; i < RINGBUFFER_FRAME_COUNT; i++)
+		{
+			if (m_fences[i] != nullptr)
+			{
+				s_renderDevice->WaitFence(m_fences[i]);
+				s_renderDevice->ReleaseFence(m_fences[i]);
+				m_fences[i] = nullptr;
+			}
+		}
+
+		m_engineBoundID = s_renderDevice->ReleaseRingBuffer(m_engineBoundID, m_mappedData != nullptr);
+		m_mappedData = nullptr;
+	}
+}
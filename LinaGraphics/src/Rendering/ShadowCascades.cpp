@@ -0,0 +1,143 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/ShadowCascades.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace LinaEngine::Graphics
+{
+	bool ShadowCascades::Update(const Matrix& view, const Matrix& projection, float zNear, float zFar, const Vector3& lightDirection)
+	{
+		m_staticUpdateCount = 0;
+		m_isActive = lightDirection.Magnitude() > 0.0f;
+		if (!m_isActive) return false;
+
+		// Practical split scheme, a blend of logarithmic & uniform splits over the shadowed range.
+		zNear = std::max(zNear, 0.01f);
+		const float shadowFar = std::max(std::min(zFar, SHADOWCASCADE_MAX_DISTANCE), zNear + 0.01f);
+		const Matrix inverseView = view.Inverse();
+		const Matrix inverseProjection = projection.Inverse();
+		float splitNear = zNear;
+
+		for (uint32 i = 0; i < SHADOWCASCADE_COUNT; i++)
+		{
+			const float ratio = (float)(i + 1) / SHADOWCASCADE_COUNT;
+			const float logSplit = zNear * std::pow(shadowFar / zNear, ratio);
+			const float uniformSplit = zNear + (shadowFar - zNear) * ratio;
+			const float splitFar = SHADOWCASCADE_SPLIT_LAMBDA * logSplit + (1.0f - SHADOWCASCADE_SPLIT_LAMBDA) * uniformSplit;
+
+			FitCascade(i, inverseView, inverseProjection, splitNear, splitFar, lightDirection);
+			splitNear = splitFar;
+		}
+
+		return true;
+	}
+
+	void ShadowCascades::FitCascade(uint32 cascade, const Matrix& inverseView, const Matrix& inverseProjection, float splitNear, float splitFar, const Vector3& lightDirection)
+	{
+		// Corners of the slice in view space, found along the rays through the frustum corners.
+		glm::vec3 corners[8];
+		glm::vec3 center(0.0f);
+
+		for (int corner = 0; corner < 4; corner++)
+		{
+			const float ndcX = (corner & 1) ? 1.0f : -1.0f;
+			const float ndcY = (corner & 2) ? 1.0f : -1.0f;
+			glm::vec4 nearPoint = inverseProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+			glm::vec4 farPoint = inverseProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+			const glm::vec3 rayStart = glm::vec3(nearPoint) / nearPoint.w;
+			const glm::vec3 rayEnd = glm::vec3(farPoint) / farPoint.w;
+
+			for (int d = 0; d < 2; d++)
+			{
+				const float t = ((d == 0 ? splitNear : splitFar) - rayStart.z) / (rayEnd.z - rayStart.z);
+				corners[corner * 2 + d] = rayStart + (rayEnd - rayStart) * t;
+				center += corners[corner * 2 + d];
+			}
+		}
+
+		// The sphere is computed in view space so its radius doesn't change while the camera turns.
+		center /= 8.0f;
+		float radius = 0.0f;
+		for (int i = 0; i < 8; i++)
+			radius = std::max(radius, glm::length(corners[i] - center));
+
+		// Padding the sphere by the snap step keeps the slice covered wherever the center snaps to.
+		const float texelSize = 2.0f * radius / (float)(SHADOWCASCADE_RESOLUTION - 2 * SHADOWCASCADE_SNAP_TEXELS);
+		const float snapStep = texelSize * SHADOWCASCADE_SNAP_TEXELS;
+		const float extent = radius + snapStep;
+
+		// Snap the center on the light's axes, the light matrix only changes once the camera moves a full step.
+		const glm::vec3 direction = glm::normalize(glm::vec3(lightDirection));
+		const glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		const glm::mat4 lightRotation = glm::lookAtLH(glm::vec3(0.0f), direction, up);
+		glm::vec3 lightCenter = glm::vec3(lightRotation * (glm::mat4(inverseView) * glm::vec4(center, 1.0f)));
+		lightCenter = glm::floor(lightCenter / snapStep) * snapStep;
+		const glm::vec3 worldCenter = glm::vec3(glm::inverse(lightRotation) * glm::vec4(lightCenter, 1.0f));
+
+		// Casters up to a fixed distance towards the light are kept in front of the near plane.
+		const float backDistance = extent + SHADOWCASCADE_CASTER_DISTANCE;
+		const Matrix lightView = Matrix::InitLookAt(worldCenter - direction * backDistance, worldCenter, up);
+		const Matrix lightProjection = Matrix::Orthographic(-extent, extent, -extent, extent, 0.0f, backDistance + extent);
+
+		ShadowCascade& shadowCascade = m_cascades[cascade];
+		shadowCascade.m_lightViewProjection = lightProjection * lightView;
+		shadowCascade.m_splitFar = splitFar;
+		shadowCascade.m_texelSize = 2.0f * extent / SHADOWCASCADE_RESOLUTION;
+		shadowCascade.m_atlasOffset = Vector2((float)(cascade & 1) * SHADOWCASCADE_RESOLUTION, (float)(cascade >> 1) * SHADOWCASCADE_RESOLUTION);
+
+		// Clip space to the cascade's quarter of the atlas, depth to [0, 1].
+		glm::mat4 tile(1.0f);
+		tile[0][0] = tile[1][1] = 0.25f;
+		tile[2][2] = 0.5f;
+		tile[3] = glm::vec4(0.25f + (float)(cascade & 1) * 0.5f, 0.25f + (float)(cascade >> 1) * 0.5f, 0.5f, 1.0f);
+		shadowCascade.m_atlasMatrix = tile * glm::mat4(shadowCascade.m_lightViewProjection);
+	}
+
+	bool ShadowCascades::NeedsStaticUpdate(uint32 cascade, uint32 staticVersion) const
+	{
+		const StaticCache& cache = m_staticCaches[cascade];
+		return !cache.m_isValid || cache.m_version != staticVersion || glm::mat4(cache.m_lightViewProjection) != glm::mat4(m_cascades[cascade].m_lightViewProjection);
+	}
+
+	void ShadowCascades::MarkStaticUpdated(uint32 cascade, uint32 staticVersion)
+	{
+		StaticCache& cache = m_staticCaches[cascade];
+		cache.m_lightViewProjection = m_cascades[cascade].m_lightViewProjection;
+		cache.m_version = staticVersion;
+		cache.m_isValid = true;
+		m_staticUpdateCount++;
+	}
+
+	void ShadowCascades::InvalidateStatic()
+	{
+		for (uint32 i = 0; i < SHADOWCASCADE_COUNT; i++)
+			m_staticCaches[i].m_isValid = false;
+	}
+}
@@ -0,0 +1,186 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/TextureAtlas.hpp"
+#include "Rendering/Texture.hpp"
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "Utility/stb/stb_rect_pack.h"
+
+namespace LinaEngine::Graphics
+{
+#define TEXTUREATLAS_WHITE_SIZE 4
+#define TEXTUREATLAS_REJECTED ((uint32)-1)
+
+	struct TextureAtlasPage
+	{
+		Texture m_texture;
+		stbrp_context m_context;
+		std::vector<stbrp_node> m_nodes;
+	};
+
+	TextureAtlas::TextureAtlas()
+	{
+
+	}
+
+	TextureAtlas::~TextureAtlas()
+	{
+
+	}
+
+	void TextureAtlas::Construct(RenderDevice& renderDeviceIn, uint32 pageSize)
+	{
+		s_renderDevice = &renderDeviceIn;
+		m_pageSize = pageSize;
+		Clear();
+	}
+
+	bool TextureAtlas::GetRegion(Texture* texture, TextureAtlasRegion& region)
+	{
+		if (texture == nullptr)
+		{
+			region = m_whiteRegion;
+			return true;
+		}
+
+		// Ids are compared as well, a released texture's address might be reused.
+		std::unordered_map<const Texture*, TextureAtlasRegion>::iterator it = m_regions.find(texture);
+		if (it != m_regions.end() && it->second.m_textureID == texture->GetID())
+		{
+			region = it->second;
+			return region.m_page != TEXTUREATLAS_REJECTED;
+		}
+
+		TextureAtlasRegion& newRegion = m_regions[texture];
+		newRegion.m_textureID = texture->GetID();
+		newRegion.m_page = TEXTUREATLAS_REJECTED;
+
+		// Compressed formats can't be attached to a frame buffer, these are drawn separately.
+		Vector2 size = texture->GetSize();
+		uint32 width = (uint32)size.x;
+		uint32 height = (uint32)size.y;
+		if (texture->GetIsEmpty() || texture->IsCompressed() || width == 0 || height == 0)
+			return false;
+
+		uint32 page, x, y;
+		if (!Allocate(width + TEXTUREATLAS_PADDING * 2, height + TEXTUREATLAS_PADDING * 2, page, x, y))
+			return false;
+
+		// Copy the texture & stretch its edge texels over the padding to avoid bleeding.
+		uint32 atlasTexture = m_pages[page]->m_texture.GetID();
+		const float p = (float)TEXTUREATLAS_PADDING;
+		const float w = (float)width;
+		const float h = (float)height;
+		const Vector2 origin((float)x + p, (float)y + p);
+		s_renderDevice->CopyTextureRegion(texture->GetID(), Vector2(0.0f, 0.0f), Vector2(w, h), atlasTexture, origin, Vector2(w, h));
+		s_renderDevice->CopyTextureRegion(texture->GetID(), Vector2(0.0f, 0.0f), Vector2(1.0f, h), atlasTexture, Vector2((float)x, origin.y), Vector2(p, h));
+		s_renderDevice->CopyTextureRegion(texture->GetID(), Vector2(w - 1.0f, 0.0f), Vector2(1.0f, h), atlasTexture, Vector2(origin.x + w, origin.y), Vector2(p, h));
+		s_renderDevice->CopyTextureRegion(texture->GetID(), Vector2(0.0f, 0.0f), Vector2(w, 1.0f), atlasTexture, Vector2(origin.x, (float)y), Vector2(w, p));
+		s_renderDevice->CopyTextureRegion(texture->GetID(), Vector2(0.0f, h - 1.0f), Vector2(w, 1.0f), atlasTexture, Vector2(origin.x, origin.y + h), Vector2(w, p));
+
+		const float pageSize = (float)m_pageSize;
+		newRegion.m_page = page;
+		newRegion.m_uvRect = Vector4(origin.x / pageSize, origin.y / pageSize, (origin.x + w) / pageSize, (origin.y + h) / pageSize);
+		region = newRegion;
+		return true;
+	}
+
+	void TextureAtlas::Clear()
+	{
+		m_pages.clear();
+		m_regions.clear();
+
+		// First page starts with a white block for untextured sprites.
+		AddPage();
+		uint32 page, x, y;
+		Allocate(TEXTUREATLAS_WHITE_SIZE, TEXTUREATLAS_WHITE_SIZE, page, x, y);
+
+		std::vector<uint8> white(TEXTUREATLAS_WHITE_SIZE * TEXTUREATLAS_WHITE_SIZE * 4, 255);
+		s_renderDevice->UpdateTexture2D(m_pages[0]->m_texture.GetID(), Vector2(TEXTUREATLAS_WHITE_SIZE, TEXTUREATLAS_WHITE_SIZE), &white[0], PixelFormat::FORMAT_RGBA);
+
+		const float center = (TEXTUREATLAS_WHITE_SIZE * 0.5f) / (float)m_pageSize;
+		m_whiteRegion.m_page = 0;
+		m_whiteRegion.m_uvRect = Vector4(center, center, center, center);
+	}
+
+	Texture& TextureAtlas::GetPage(uint32 page)
+	{
+		return m_pages[page]->m_texture;
+	}
+
+	bool TextureAtlas::Allocate(uint32 width, uint32 height, uint32& page, uint32& x, uint32& y)
+	{
+		if (width > m_pageSize || height > m_pageSize)
+			return false;
+
+		// Try the existing pages first, open a new one if none fits.
+		for (uint32 i = 0; i <= (uint32)m_pages.size(); i++)
+		{
+			if (i == (uint32)m_pages.size())
+			{
+				if (m_pages.size() >= TEXTUREATLAS_MAX_PAGES)
+					return false;
+				AddPage();
+			}
+
+			stbrp_rect rect;
+			rect.id = 0;
+			rect.w = (stbrp_coord)width;
+			rect.h = (stbrp_coord)height;
+			stbrp_pack_rects(&m_pages[i]->m_context, &rect, 1);
+
+			if (rect.was_packed)
+			{
+				page = i;
+				x = rect.x;
+				y = rect.y;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void TextureAtlas::AddPage()
+	{
+		SamplerParameters params;
+		params.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGBA;
+		params.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGBA;
+		params.m_textureParams.m_minFilter = params.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
+		params.m_textureParams.m_wrapS = params.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+
+		std::unique_ptr<TextureAtlasPage> page = std::make_unique<TextureAtlasPage>();
+		page->m_texture.ConstructRTTexture(*s_renderDevice, Vector2((float)m_pageSize, (float)m_pageSize), params, false);
+		page->m_texture.GetSampler().UpdateSettings(params);
+		page->m_nodes.resize(m_pageSize);
+		stbrp_init_target(&page->m_context, m_pageSize, m_pageSize, &page->m_nodes[0], m_pageSize);
+		m_pages.push_back(std::move(page));
+	}
+}
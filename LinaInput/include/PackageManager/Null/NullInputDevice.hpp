@@ -0,0 +1,75 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: NullInputDevice
+
+Input device for the headless null window, there is no hardware to poll so nothing is ever pressed
+& the mouse stays where it was put. Selected with LINA_GRAPHICS_NULL.
+
+Timestamp: 10/20/2026 11:26:04 AM
+*/
+
+#pragma once
+
+#ifndef NullInputDevice_HPP
+#define NullInputDevice_HPP
+
+#include "Input/InputDevice.hpp"
+
+namespace LinaEngine::Input
+{
+	class NullInputDevice : public InputDevice
+	{
+
+	public:
+
+		NullInputDevice();
+		virtual ~NullInputDevice();
+
+		void Initialize(void* contextWindowPointer) override;
+		void Tick() override {};
+		bool GetKey(int keyCode) override { return false; }
+		bool GetKeyDown(int keyCode) override { return false; }
+		bool GetKeyUp(int keyCode) override { return false; }
+		bool GetMouseButton(int index) override { return false; }
+		bool GetMouseButtonDown(int index) override { return false; }
+		bool GetMouseButtonUp(int index) override { return false; }
+		Vector2 GetMousePosition() override { return m_mousePosition; }
+		void SetCursorMode(CursorMode mode) const override {};
+		void SetMousePosition(const Vector2& v) const override { m_mousePosition = v; }
+		Vector2 GetRawMouseAxis() override { return Vector2::Zero; }
+		Vector2 GetMouseAxis() override { return Vector2::Zero; }
+
+	private:
+
+		mutable Vector2 m_mousePosition = Vector2::Zero;
+	};
+}
+
+#endif
@@ -41,9 +41,17 @@ Timestamp: 4/14/2019 7:12:53 PM
 #define PAMINPUTDEVICE_HPP
 
 #ifdef LINA_GRAPHICS_OPENGL
+
+#ifdef LINA_GRAPHICS_NULL
+#include "Null/NullInputDevice.hpp"
+
+typedef LinaEngine::Input::NullInputDevice InputDevice;
+#else
 #include "OpenGL/GLInputDevice.hpp"
 
 typedef LinaEngine::Input::GLInputDevice InputDevice;
 #endif
 
+#endif
+
 #endif
\ No newline at end of file
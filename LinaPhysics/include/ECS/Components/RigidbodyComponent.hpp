@@ -38,6 +38,15 @@ Timestamp: 9/30/2020 2:46:27 AM
 
 #include "ECS/ECSComponent.hpp"
 #include "Utility/Math/Vector.hpp"
+#include "Utility/Math/Quaternion.hpp"
+#include <cereal/cereal.hpp>
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+#include <vector>
+#include <cmath>
+
+// Compound child counts above this fail the load, guards the layout probing of untagged snapshots.
+#define RIGIDBODY_MAX_COMPOUND_CHILDREN 4096
 
 namespace LinaEngine::ECS
 {
@@ -46,7 +55,33 @@ namespace LinaEngine::ECS
 		Sphere,
 		BOX,
 		Cylinder,
-		CAPSULE
+		CAPSULE,
+		Compound
+	};
+
+	// Fields rigidbodies were stored with, each one adds to the previous. Version 1 archives are Kinematic.
+	enum class RigidbodyLayout
+	{
+		Base,
+		CompoundChildren,
+		Kinematic
+	};
+
+	// Child of a compound shape, placed relative to the body.
+	struct CompoundCollisionChild
+	{
+		CollisionShape m_collisionShape = CollisionShape::BOX;
+		LinaEngine::Vector3 m_halfExtents = LinaEngine::Vector3::One;
+		float m_radius = 0.5f;
+		float m_capsuleHeight = 1.0f;
+		LinaEngine::Vector3 m_localLocation = LinaEngine::Vector3::Zero;
+		LinaEngine::Quaternion m_localRotation;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(m_collisionShape, m_halfExtents, m_radius, m_capsuleHeight, m_localLocation, m_localRotation);
+		}
 	};
 
 	struct RigidbodyComponent : public ECSComponent
@@ -58,15 +93,88 @@ namespace LinaEngine::ECS
 		float m_radius = 0.0f; // used for sphere & capsule shapes.
 		float m_capsuleHeight = 0.0f; 
 		bool m_alive = false;
+		bool m_isKinematic = false; // moved by its transform instead of the simulation.
 		int m_bodyID = 0;
+		std::vector<CompoundCollisionChild> m_compoundChildren; // used for compound shapes, children can't be compounds.
 
 		template<class Archive>
-		void serialize(Archive& archive)
+		void save(Archive& archive, std::uint32_t version) const
 		{
-			archive(m_collisionShape, m_localInertia, m_halfExtents, m_mass, m_radius, m_capsuleHeight, m_bodyID, m_alive, m_isEnabled); 
+			archive(m_collisionShape, m_localInertia, m_halfExtents, m_mass, m_radius, m_capsuleHeight, m_bodyID, m_alive, m_isEnabled, m_compoundChildren, m_isKinematic);
 		}
 
+		template<class Archive>
+		void load(Archive& archive, std::uint32_t version);
+
 	};
+
+	// Loads rigidbodies of snapshots written before the component was versioned with the given layout.
+	// Cereal still reads a version in front of the first rigidbody, in these files that is its collision shape.
+	class RigidbodyLegacyInputArchive : public cereal::BinaryInputArchive
+	{
+	public:
+
+		RigidbodyLegacyInputArchive(std::istream& stream, RigidbodyLayout layout) : cereal::BinaryInputArchive(stream), m_layout(layout) {};
+
+		RigidbodyLayout m_layout = RigidbodyLayout::Base;
+		bool m_firstRigidbodyRead = false;
+	};
+
+	// Sizes & masses are never negative, NaN or infinite.
+	inline bool RigidbodyValueValid(float value) { return std::isfinite(value) && value >= 0.0f; }
+
+	template<class Archive>
+	void RigidbodyComponent::load(Archive& archive, std::uint32_t version)
+	{
+		RigidbodyLegacyInputArchive* legacyArchive = dynamic_cast<RigidbodyLegacyInputArchive*>(&archive);
+		const RigidbodyLayout layout = legacyArchive != nullptr ? legacyArchive->m_layout : (version >= 1 ? RigidbodyLayout::Kinematic : RigidbodyLayout::Base);
+
+		if (legacyArchive == nullptr && version != 1)
+			throw cereal::Exception("Rigidbody version is unknown.");
+
+		if (legacyArchive != nullptr && !legacyArchive->m_firstRigidbodyRead)
+		{
+			m_collisionShape = (CollisionShape)version;
+			legacyArchive->m_firstRigidbodyRead = true;
+		}
+		else
+			archive(m_collisionShape);
+
+		// Bools are read as bytes so a wrong layout fails here, before misread entities reach the registry.
+		std::uint8_t alive = 0, enabled = 0;
+		archive(m_localInertia, m_halfExtents, m_mass, m_radius, m_capsuleHeight, m_bodyID, alive, enabled);
+
+		if ((int)m_collisionShape < 0 || m_collisionShape > CollisionShape::Compound || alive > 1 || enabled > 1 || m_bodyID < -1
+			|| !RigidbodyValueValid(m_mass) || !RigidbodyValueValid(m_radius) || !RigidbodyValueValid(m_capsuleHeight)
+			|| !RigidbodyValueValid(m_halfExtents.x) || !RigidbodyValueValid(m_halfExtents.y) || !RigidbodyValueValid(m_halfExtents.z)
+			|| !std::isfinite(m_localInertia.x) || !std::isfinite(m_localInertia.y) || !std::isfinite(m_localInertia.z))
+			throw cereal::Exception("Rigidbody data out of range.");
+
+		m_alive = alive == 1;
+		m_isEnabled = enabled == 1;
+		if (layout == RigidbodyLayout::Base) return;
+
+		cereal::size_type childCount = 0;
+		archive(cereal::make_size_tag(childCount));
+		if (childCount > RIGIDBODY_MAX_COMPOUND_CHILDREN)
+			throw cereal::Exception("Rigidbody compound child count out of range.");
+
+		m_compoundChildren.resize((size_t)childCount);
+		for (CompoundCollisionChild& child : m_compoundChildren)
+			archive(child);
+
+		if (layout == RigidbodyLayout::Kinematic)
+		{
+			std::uint8_t kinematic = 0;
+			archive(kinematic);
+			if (kinematic > 1)
+				throw cereal::Exception("Rigidbody data out of range.");
+
+			m_isKinematic = kinematic == 1;
+		}
+	}
 }
 
+CEREAL_CLASS_VERSION(LinaEngine::ECS::RigidbodyComponent, 1);
+
 #endif
@@ -57,8 +57,15 @@ namespace LinaEngine::ECS
 
 		RigidbodySystem() {};
 
+		// Applies the bodies Bullet moved during the last step to their transforms.
 		virtual void UpdateComponents(float delta) override;
 
+		// Rebuilds the shapes of bodies whose transform scale changed since they were built, called before the step.
+		void RefreshScaledShapes();
+
+		// Pushes changed transforms of kinematic bodies into Bullet, called before the step.
+		void PushKinematicTransforms();
+
 		void Construct(ECSRegistry& registry, LinaEngine::Physics::PhysicsEngine* physicsEngine) 
 		{ 
 			BaseECSSystem::Construct(registry);
@@ -0,0 +1,101 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: CollisionShapeCache
+
+Shares Bullet collision shapes between rigidbodies with the same shape type & dimensions. Shapes are
+reference counted, keyed by their quantized parameters, and deleted with their last reference. The body
+scale is baked into the primitive dimensions, so equally sized bodies share a shape whatever their scale
+& no shared shape ever gets a local scaling. Compound children are cached shapes themselves.
+
+Timestamp: 10/20/2026 4:55:13 AM
+*/
+
+#pragma once
+
+#ifndef CollisionShapeCache_HPP
+#define CollisionShapeCache_HPP
+
+#include "ECS/Components/RigidbodyComponent.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include "btBulletDynamicsCommon.h"
+#include <map>
+#include <vector>
+
+// Dimensions closer than this share a shape.
+#define COLLISIONSHAPECACHE_QUANTIZATION 0.0001f
+
+namespace LinaEngine::Physics
+{
+	class CollisionShapeCache
+	{
+	public:
+
+		CollisionShapeCache() {};
+		~CollisionShapeCache();
+
+		// Adds a reference to the shape of the rigidbody at the given scale, creating it if it isn't cached.
+		btCollisionShape* Acquire(const LinaEngine::ECS::RigidbodyComponent& rb, const Vector3& scale = Vector3::One);
+
+		// Drops a reference, the shape is deleted once nothing uses it. Shapes not from the cache are ignored.
+		void Release(btCollisionShape* shape);
+
+		// Deletes every shape regardless of the references, for shutdown.
+		void Clear();
+
+		size_t GetShapeCount() const { return m_shapes.size(); }
+		uint32 GetReferenceCount() const { return m_referenceCount; }
+
+	private:
+
+		struct ShapeEntry
+		{
+			btCollisionShape* m_shape = nullptr;
+			uint32 m_references = 0;
+
+			// Cached shapes this one holds references to, compound children.
+			std::vector<btCollisionShape*> m_children;
+		};
+
+		typedef std::vector<int32> ShapeKey;
+
+		btCollisionShape* AcquirePrimitive(LinaEngine::ECS::CollisionShape type, const Vector3& halfExtents, float radius, float capsuleHeight, const Vector3& scale);
+		btCollisionShape* AcquireCompound(const std::vector<LinaEngine::ECS::CompoundCollisionChild>& children, const Vector3& scale);
+		btCollisionShape* AddReference(const ShapeKey& key);
+		btCollisionShape* Insert(const ShapeKey& key, btCollisionShape* shape, const std::vector<btCollisionShape*>& children);
+
+	private:
+
+		std::map<ShapeKey, ShapeEntry> m_shapes;
+		std::map<btCollisionShape*, ShapeKey> m_shapeKeys;
+		uint32 m_referenceCount = 0;
+	};
+}
+
+#endif
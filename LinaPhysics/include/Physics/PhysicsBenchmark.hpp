@@ -0,0 +1,68 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysicsBenchmark
+
+Drops a pile of box stacks onto a ground box & times the steps of the single threaded world against the
+multithreaded world at increasing thread counts. Uses its own worlds & limits the thread count of its own
+loops only, the engine world isn't touched. Can run on a worker after the physics engine set up its task scheduler.
+
+Timestamp: 10/20/2026 4:12:30 AM
+*/
+
+#pragma once
+
+#ifndef PhysicsBenchmark_HPP
+#define PhysicsBenchmark_HPP
+
+#include "Core/SizeDefinitions.hpp"
+#include <string>
+#include <vector>
+
+namespace LinaEngine::Physics
+{
+	struct PhysicsBenchmarkResult
+	{
+		std::string m_world;
+		int m_threadCount = 1;
+		double m_averageStepMS = 0.0;
+		double m_maxStepMS = 0.0;
+	};
+
+	class PhysicsBenchmark
+	{
+	public:
+
+		// First result is the single threaded world, then one per thread count doubling up to the pool size.
+		static std::vector<PhysicsBenchmarkResult> Run(uint32 bodyCount = 10000, uint32 steps = 60);
+		static void LogResults(const std::vector<PhysicsBenchmarkResult>& results);
+	};
+}
+
+#endif
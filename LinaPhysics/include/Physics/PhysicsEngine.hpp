@@ -41,8 +41,13 @@ Timestamp: 5/1/2019 2:35:28 AM
 
 #include "ECS/Systems/RigidbodySystem.hpp"
 #include "PhysicsGizmoDrawer.hpp"
+#include "PhysicsTaskScheduler.hpp"
+#include "CollisionShapeCache.hpp"
+#include "PhysicsMotionState.hpp"
 #include "btBulletDynamicsCommon.h"
 
+#define PHYSICS_MULTITHREADED_DEFAULT true
+
 namespace LinaEngine
 {
 	namespace ECS
@@ -57,6 +62,8 @@ namespace LinaEngine
 	}
 }
 
+class btConstraintSolverPoolMt;
+
 namespace LinaEngine::Physics
 {
 
@@ -82,25 +89,52 @@ namespace LinaEngine::Physics
 		btRigidBody* GetActiveRigidbody(int id) { return m_bodies[id]; }
 		void SetDebugDraw(bool enabled) { m_debugDrawEnabled = enabled; }
 
+		// Picks btDiscreteDynamicsWorldMt on the job system over the single threaded world, only before Initialize.
+		// Initialize falls back to the single threaded world if the Bullet libraries aren't thread safe.
+		void SetMultithreaded(bool multithreaded);
+		bool GetMultithreaded() const { return m_multithreaded; }
+
+		// Threads the multithreaded world splits its loops over, clamped to the job system size.
+		void SetThreadCount(int count) { m_taskScheduler.setNumThreads(count); }
+		int GetThreadCount() const { return m_multithreaded ? m_taskScheduler.GetActiveThreadCount() : 1; }
+		int GetMaxThreadCount() const { return m_taskScheduler.getMaxNumThreads(); }
+
+		// Bodies Bullet moved during the last step & the kinematic bodies fed from their transforms.
+		std::vector<PhysicsMotionState*>& GetMovedStates() { return m_movedStates; }
+		const std::map<int, PhysicsMotionState*>& GetKinematicStates() const { return m_kinematicStates; }
+
+		// Scales the body shapes were built with, the scale is baked into the cached shapes.
+		const std::map<int, Vector3>& GetBodyScales() const { return m_bodyScales; }
+
+		// Shapes shared between the bodies.
+		const CollisionShapeCache& GetShapeCache() const { return m_shapeCache; }
+
 	private:
 
-		btCollisionShape* GetCollisionShape(LinaEngine::ECS::RigidbodyComponent rb);
+		void SetKinematic(int id, btRigidBody* body, bool kinematic);
 
 	private:
 
 		btDefaultCollisionConfiguration* m_collisionConfig = nullptr;
 		btCollisionDispatcher* m_collisionDispatcher = nullptr;
 		btBroadphaseInterface* m_overlappingPairCache = nullptr;
-		btSequentialImpulseConstraintSolver* m_impulseSolver = nullptr;
+		btConstraintSolver* m_impulseSolver = nullptr;
+		btConstraintSolverPoolMt* m_solverPool = nullptr;
 		btDiscreteDynamicsWorld* m_world = nullptr;
+		PhysicsTaskScheduler m_taskScheduler;
+		CollisionShapeCache m_shapeCache;
 
 		PhysicsGizmoDrawer m_gizmoDrawer;
 
 		LinaEngine::ECS::RigidbodySystem m_rigidbodySystem;
 		LinaEngine::ECS::ECSSystemList m_physicsPipeline;
 
-		std::map<int, btRigidBody*> m_bodies;		
+		std::map<int, btRigidBody*> m_bodies;
+		std::map<int, PhysicsMotionState*> m_kinematicStates;
+		std::map<int, Vector3> m_bodyScales;
+		std::vector<PhysicsMotionState*> m_movedStates;
 		bool m_debugDrawEnabled = false;
+		bool m_multithreaded = PHYSICS_MULTITHREADED_DEFAULT;
 
 		DISALLOW_COPY_ASSIGN_MOVE(PhysicsEngine)
 	};
@@ -0,0 +1,85 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysicsMotionState
+
+Motion state linking a rigidbody to its entity. Bullet only synchronizes active bodies, so each state
+queues itself to the moved list the first time it is written during a step & the rigidbody system applies
+just those. Kinematic states take their transform from the entity whenever it changes.
+
+Timestamp: 10/20/2026 5:32:07 AM
+*/
+
+#pragma once
+
+#ifndef PhysicsMotionState_HPP
+#define PhysicsMotionState_HPP
+
+#include "ECS/ECSSystem.hpp"
+#include "Utility/Math/Vector.hpp"
+#include "Utility/Math/Quaternion.hpp"
+#include "LinearMath/btMotionState.h"
+#include "LinearMath/btTransform.h"
+#include <vector>
+
+namespace LinaEngine::Physics
+{
+	class PhysicsMotionState : public btMotionState
+	{
+	public:
+
+		BT_DECLARE_ALIGNED_ALLOCATOR();
+
+		PhysicsMotionState(const btTransform& transform, LinaEngine::ECS::ECSEntity entity, std::vector<PhysicsMotionState*>* movedStates) :
+			m_worldTransform(transform), m_kinematicRotation(transform.getRotation()), m_entity(entity), m_movedStates(movedStates) {};
+		virtual ~PhysicsMotionState() {};
+
+		virtual void getWorldTransform(btTransform& worldTransform) const override { worldTransform = m_worldTransform; }
+		virtual void setWorldTransform(const btTransform& worldTransform) override;
+
+		// Updates the transform Bullet reads for kinematic bodies, returns false if nothing changed.
+		bool SetKinematicTransform(const Vector3& location, const Quaternion& rotation);
+
+		// Called once the moved list is applied.
+		void ClearMoved() { m_moved = false; }
+
+		const btTransform& GetWorldTransform() const { return m_worldTransform; }
+		LinaEngine::ECS::ECSEntity GetEntity() const { return m_entity; }
+
+	private:
+
+		btTransform m_worldTransform;
+		btQuaternion m_kinematicRotation; // last pushed, the basis doesn't round trip exactly.
+		LinaEngine::ECS::ECSEntity m_entity;
+		std::vector<PhysicsMotionState*>* m_movedStates = nullptr;
+		bool m_moved = false;
+	};
+}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysicsTaskScheduler
+
+Bullet task scheduler running the parallel loops of the multithreaded dynamics world on the engine
+JobSystem. The calling thread takes the first range & helps with pending jobs while it waits for the rest.
+
+Timestamp: 10/20/2026 3:48:52 AM
+*/
+
+#pragma once
+
+#ifndef PhysicsTaskScheduler_HPP
+#define PhysicsTaskScheduler_HPP
+
+#include "LinearMath/btThreads.h"
+
+namespace LinaEngine::Physics
+{
+	class PhysicsTaskScheduler : public btITaskScheduler
+	{
+	public:
+
+		PhysicsTaskScheduler();
+		virtual ~PhysicsTaskScheduler() {};
+
+		virtual int getMaxNumThreads() const override { return m_maxThreadCount; }
+
+		// Bullet sizes its per thread storage from this & any pool worker may pick up a range, so it is
+		// always the pool size. setNumThreads only limits how many ranges a loop is split into.
+		virtual int getNumThreads() const override { return m_maxThreadCount; }
+		virtual void setNumThreads(int numThreads) override;
+
+		virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+		virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+		int GetActiveThreadCount() const { return m_activeThreadCount; }
+
+		// Limits the loops started from the calling thread only, 0 clears it. Lets a world stepped on a worker
+		// pick its own split without changing the one of the engine world.
+		static void SetCallerThreadLimit(int numThreads) { s_callerThreadLimit = numThreads; }
+
+		// Libraries built without BT_THREADSAFE run btParallelFor inline & never reach a scheduler.
+		static bool IsBulletThreadSafe();
+
+	private:
+
+		// Range size splitting count items over the active threads, at least grainSize.
+		int GetRangeSize(int count, int grainSize) const;
+
+	private:
+
+		int m_maxThreadCount = 1;
+		int m_activeThreadCount = 1;
+		static thread_local int s_callerThreadLimit;
+	};
+}
+
+#endif
@@ -35,27 +35,57 @@ namespace LinaEngine::ECS
 {
 	void RigidbodySystem::UpdateComponents(float delta)
 	{
-		auto view = m_ecs->view<TransformComponent, RigidbodyComponent>();
+		// Only active bodies are synchronized by Bullet, so sleeping & static ones never reach the list.
+		std::vector<LinaEngine::Physics::PhysicsMotionState*>& movedStates = m_physicsEngine->GetMovedStates();
 
-		// Find all entities with rigidbody component and transform component attached to them.
-		for (auto entity : view)
+		for (LinaEngine::Physics::PhysicsMotionState* state : movedStates)
 		{
-			RigidbodyComponent& rbComponent = view.get<RigidbodyComponent>(entity);
-			if (!rbComponent.m_isEnabled) continue;
+			state->ClearMoved();
 
-			TransformComponent& transform = view.get<TransformComponent>(entity);
+			ECSEntity entity = state->GetEntity();
+			if (!m_ecs->valid(entity)) continue;
 
-			// We get the rigidbody information from the world, and update the entity's transformation
-			// based on the body's transformation. So we keep the game world that does the rendering via
-			// transformations in sync with the physics world.
-			btRigidBody* rb = m_physicsEngine->GetActiveRigidbody(rbComponent.m_bodyID);
-			btTransform btTrans;
-			rb->getMotionState()->getWorldTransform(btTrans);
+			auto [rbComponent, transform] = m_ecs->try_get<RigidbodyComponent, TransformComponent>(entity);
+			if (rbComponent == nullptr || transform == nullptr || !rbComponent->m_isEnabled) continue;
 
-			transform.transform.SetLocation(Vector3(btTrans.getOrigin().getX(), btTrans.getOrigin().getY(), btTrans.getOrigin().getZ()));
-			transform.transform.SetRotation(Quaternion(btTrans.getRotation().getX(), btTrans.getRotation().getY(), btTrans.getRotation().getZ(), btTrans.getRotation().getW()));
+			// Keep the game world that does the rendering via transformations in sync with the physics world.
+			const btTransform& btTrans = state->GetWorldTransform();
+			const btQuaternion btRot = btTrans.getRotation();
+			transform->transform.SetLocationAndRotation(Vector3(btTrans.getOrigin().getX(), btTrans.getOrigin().getY(), btTrans.getOrigin().getZ()), Quaternion(btRot.getX(), btRot.getY(), btRot.getZ(), btRot.getW()));
 		}
+
+		movedStates.clear();
 	}
-}
 
+	void RigidbodySystem::RefreshScaledShapes()
+	{
+		const std::map<int, Vector3>& bodyScales = m_physicsEngine->GetBodyScales();
+		auto view = m_ecs->view<RigidbodyComponent, TransformComponent>();
 
+		for (ECSEntity entity : view)
+		{
+			RigidbodyComponent& rbComponent = view.get<RigidbodyComponent>(entity);
+			if (!rbComponent.m_alive) continue;
+
+			// Scale is baked into the cached shapes, a rescaled body needs a shape of its new size.
+			std::map<int, Vector3>::const_iterator it = bodyScales.find(rbComponent.m_bodyID);
+			if (it != bodyScales.end() && it->second != view.get<TransformComponent>(entity).transform.GetScale())
+				m_physicsEngine->OnRigidbodyUpdated(*m_ecs, entity);
+		}
+	}
+
+	void RigidbodySystem::PushKinematicTransforms()
+	{
+		for (const std::pair<const int, LinaEngine::Physics::PhysicsMotionState*>& pair : m_physicsEngine->GetKinematicStates())
+		{
+			ECSEntity entity = pair.second->GetEntity();
+			if (!m_ecs->valid(entity)) continue;
+
+			auto [rbComponent, transform] = m_ecs->try_get<RigidbodyComponent, TransformComponent>(entity);
+			if (rbComponent == nullptr || transform == nullptr || !rbComponent->m_isEnabled) continue;
+
+			// Bullet reads kinematic motion states every step, unchanged transforms are skipped.
+			pair.second->SetKinematicTransform(transform->transform.GetLocation(), transform->transform.GetRotation());
+		}
+	}
+}
@@ -0,0 +1,205 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/CollisionShapeCache.hpp"
+#include "Utility/Log.hpp"
+#include <cmath>
+
+namespace LinaEngine::Physics
+{
+	using namespace LinaEngine::ECS;
+
+	// GLOBALS DECLARATIONS
+	static int32 Quantize(float value);
+
+	CollisionShapeCache::~CollisionShapeCache()
+	{
+		Clear();
+	}
+
+	btCollisionShape* CollisionShapeCache::Acquire(const RigidbodyComponent& rb, const Vector3& scale)
+	{
+		const Vector3 absScale(std::fabs(scale.x), std::fabs(scale.y), std::fabs(scale.z));
+
+		if (rb.m_collisionShape == CollisionShape::Compound)
+		{
+			btCollisionShape* compound = AcquireCompound(rb.m_compoundChildren, absScale);
+			if (compound != nullptr)
+				return compound;
+
+			LINA_CORE_WARN("[Collision Shape Cache] -> Compound shape has no valid children, using a sphere instead.");
+			return AcquirePrimitive(CollisionShape::Sphere, rb.m_halfExtents, rb.m_radius, rb.m_capsuleHeight, absScale);
+		}
+
+		return AcquirePrimitive(rb.m_collisionShape, rb.m_halfExtents, rb.m_radius, rb.m_capsuleHeight, absScale);
+	}
+
+	void CollisionShapeCache::Release(btCollisionShape* shape)
+	{
+		std::map<btCollisionShape*, ShapeKey>::iterator keyIt = m_shapeKeys.find(shape);
+		if (keyIt == m_shapeKeys.end()) return;
+
+		std::map<ShapeKey, ShapeEntry>::iterator entryIt = m_shapes.find(keyIt->second);
+		ShapeEntry& entry = entryIt->second;
+		m_referenceCount--;
+
+		if (--entry.m_references > 0) return;
+
+		const std::vector<btCollisionShape*> children = entry.m_children;
+		delete entry.m_shape;
+		m_shapes.erase(entryIt);
+		m_shapeKeys.erase(keyIt);
+
+		for (btCollisionShape* child : children)
+			Release(child);
+	}
+
+	void CollisionShapeCache::Clear()
+	{
+		for (std::map<ShapeKey, ShapeEntry>::iterator it = m_shapes.begin(); it != m_shapes.end(); ++it)
+			delete it->second.m_shape;
+
+		m_shapes.clear();
+		m_shapeKeys.clear();
+		m_referenceCount = 0;
+	}
+
+	btCollisionShape* CollisionShapeCache::AcquirePrimitive(CollisionShape type, const Vector3& halfExtents, float radius, float capsuleHeight, const Vector3& scale)
+	{
+		// Scale is baked into the dimensions, spheres take the largest axis & capsules the largest radial one.
+		if (type == CollisionShape::BOX || type == CollisionShape::Cylinder)
+		{
+			const btVector3 extents(halfExtents.x * scale.x, halfExtents.y * scale.y, halfExtents.z * scale.z);
+			const ShapeKey key = { (int32)type, Quantize(extents.x()), Quantize(extents.y()), Quantize(extents.z()) };
+
+			if (btCollisionShape* shape = AddReference(key))
+				return shape;
+
+			btCollisionShape* shape = nullptr;
+			if (type == CollisionShape::BOX)
+				shape = new btBoxShape(extents);
+			else
+				shape = new btCylinderShape(extents);
+
+			return Insert(key, shape, {});
+		}
+		else if (type == CollisionShape::Sphere)
+		{
+			const float scaledRadius = radius * glm::max(scale.x, glm::max(scale.y, scale.z));
+			const ShapeKey key = { (int32)type, Quantize(scaledRadius) };
+
+			if (btCollisionShape* shape = AddReference(key))
+				return shape;
+
+			return Insert(key, new btSphereShape(scaledRadius), {});
+		}
+		else if (type == CollisionShape::CAPSULE)
+		{
+			const float scaledRadius = radius * glm::max(scale.x, scale.z);
+			const float scaledHeight = capsuleHeight * scale.y;
+			const ShapeKey key = { (int32)type, Quantize(scaledRadius), Quantize(scaledHeight) };
+
+			if (btCollisionShape* shape = AddReference(key))
+				return shape;
+
+			return Insert(key, new btCapsuleShape(scaledRadius, scaledHeight), {});
+		}
+
+		return nullptr;
+	}
+
+	btCollisionShape* CollisionShapeCache::AcquireCompound(const std::vector<CompoundCollisionChild>& children, const Vector3& scale)
+	{
+		// Children first, the compound is keyed by their keys & placements.
+		std::vector<btCollisionShape*> childShapes;
+		std::vector<btTransform> childTransforms;
+		ShapeKey key = { (int32)CollisionShape::Compound };
+
+		for (const CompoundCollisionChild& child : children)
+		{
+			btCollisionShape* childShape = AcquirePrimitive(child.m_collisionShape, child.m_halfExtents, child.m_radius, child.m_capsuleHeight, scale);
+			if (childShape == nullptr) continue;
+
+			// Placement is scaled per axis, the child rotation isn't, exact for uniform scales & axis aligned children.
+			const btVector3 location(child.m_localLocation.x * scale.x, child.m_localLocation.y * scale.y, child.m_localLocation.z * scale.z);
+			const btQuaternion rotation(child.m_localRotation.x, child.m_localRotation.y, child.m_localRotation.z, child.m_localRotation.w);
+			childShapes.push_back(childShape);
+			childTransforms.push_back(btTransform(rotation, location));
+
+			const ShapeKey& childKey = m_shapeKeys[childShape];
+			key.push_back((int32)childKey.size());
+			key.insert(key.end(), childKey.begin(), childKey.end());
+			key.insert(key.end(), { Quantize(location.x()), Quantize(location.y()), Quantize(location.z()) });
+			key.insert(key.end(), { Quantize(rotation.x()), Quantize(rotation.y()), Quantize(rotation.z()), Quantize(rotation.w()) });
+		}
+
+		if (childShapes.empty())
+			return nullptr;
+
+		// An existing compound already holds references to the same children.
+		if (btCollisionShape* shape = AddReference(key))
+		{
+			for (btCollisionShape* childShape : childShapes)
+				Release(childShape);
+
+			return shape;
+		}
+
+		btCompoundShape* compound = new btCompoundShape(true, (int)childShapes.size());
+		for (size_t i = 0; i < childShapes.size(); i++)
+			compound->addChildShape(childTransforms[i], childShapes[i]);
+
+		return Insert(key, compound, childShapes);
+	}
+
+	btCollisionShape* CollisionShapeCache::AddReference(const ShapeKey& key)
+	{
+		std::map<ShapeKey, ShapeEntry>::iterator it = m_shapes.find(key);
+		if (it == m_shapes.end()) return nullptr;
+
+		it->second.m_references++;
+		m_referenceCount++;
+		return it->second.m_shape;
+	}
+
+	btCollisionShape* CollisionShapeCache::Insert(const ShapeKey& key, btCollisionShape* shape, const std::vector<btCollisionShape*>& children)
+	{
+		ShapeEntry& entry = m_shapes[key];
+		entry.m_shape = shape;
+		entry.m_references = 1;
+		entry.m_children = children;
+		m_shapeKeys[shape] = key;
+		m_referenceCount++;
+		return shape;
+	}
+
+	int32 Quantize(float value)
+	{
+		return (int32)std::lround(value / COLLISIONSHAPECACHE_QUANTIZATION);
+	}
+}
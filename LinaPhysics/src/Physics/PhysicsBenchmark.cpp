@@ -0,0 +1,185 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/PhysicsBenchmark.hpp"
+#include "Physics/PhysicsTaskScheduler.hpp"
+#include "Utility/Log.hpp"
+#include "btBulletDynamicsCommon.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include <chrono>
+#include <cmath>
+
+#define PHYSICSBENCHMARK_DELTA (1.0f / 60.0f)
+#define PHYSICSBENCHMARK_STACK_HEIGHT 16
+#define PHYSICSBENCHMARK_HALF_EXTENT 0.5f
+
+namespace LinaEngine::Physics
+{
+	// GLOBALS DECLARATIONS
+	static PhysicsBenchmarkResult RunWorld(bool multithreaded, int threadCount, uint32 bodyCount, uint32 steps);
+
+	std::vector<PhysicsBenchmarkResult> PhysicsBenchmark::Run(uint32 bodyCount, uint32 steps)
+	{
+		std::vector<PhysicsBenchmarkResult> results;
+		results.push_back(RunWorld(false, 1, bodyCount, steps));
+
+		if (!PhysicsTaskScheduler::IsBulletThreadSafe())
+		{
+			LINA_CORE_WARN("[Physics Benchmark] -> Bullet libraries are built without BT_THREADSAFE, btDiscreteDynamicsWorldMt would run serially, only the single threaded world is measured.");
+			return results;
+		}
+
+		btITaskScheduler* scheduler = btGetTaskScheduler();
+		if (scheduler == nullptr || scheduler->getMaxNumThreads() < 2)
+		{
+			LINA_CORE_WARN("[Physics Benchmark] -> No multithreaded task scheduler is set, only the single threaded world is measured.");
+			return results;
+		}
+
+		// The thread count is limited for the loops of this thread only, the engine world keeps its split.
+		if (dynamic_cast<PhysicsTaskScheduler*>(scheduler) == nullptr)
+		{
+			LINA_CORE_WARN("[Physics Benchmark] -> The task scheduler isn't the engine one, only the single threaded world is measured.");
+			return results;
+		}
+
+		const int maxThreads = scheduler->getMaxNumThreads();
+
+		for (int threads = 1; ; threads *= 2)
+		{
+			const int threadCount = threads < maxThreads ? threads : maxThreads;
+			results.push_back(RunWorld(true, threadCount, bodyCount, steps));
+			if (threadCount == maxThreads) break;
+		}
+
+		PhysicsTaskScheduler::SetCallerThreadLimit(0);
+		return results;
+	}
+
+	void PhysicsBenchmark::LogResults(const std::vector<PhysicsBenchmarkResult>& results)
+	{
+		const double baseline = results.empty() ? 0.0 : results[0].m_averageStepMS;
+
+		for (const PhysicsBenchmarkResult& result : results)
+			LINA_CORE_TRACE("[Physics Benchmark] {0} ({1} threads): {2:.3f} ms average, {3:.3f} ms max, {4:.2f}x", result.m_world, result.m_threadCount, result.m_averageStepMS, result.m_maxStepMS, baseline / (result.m_averageStepMS > 1e-6 ? result.m_averageStepMS : 1e-6));
+	}
+
+	PhysicsBenchmarkResult RunWorld(bool multithreaded, int threadCount, uint32 bodyCount, uint32 steps)
+	{
+		btDefaultCollisionConfiguration collisionConfig;
+		btDbvtBroadphase broadphase;
+		btCollisionDispatcher* dispatcher = nullptr;
+		btConstraintSolverPoolMt* solverPool = nullptr;
+		btConstraintSolver* solver = nullptr;
+		btDiscreteDynamicsWorld* world = nullptr;
+
+		if (multithreaded)
+		{
+			PhysicsTaskScheduler::SetCallerThreadLimit(threadCount);
+			dispatcher = new btCollisionDispatcherMt(&collisionConfig);
+			solverPool = new btConstraintSolverPoolMt(btGetTaskScheduler()->getMaxNumThreads());
+			solver = new btSequentialImpulseConstraintSolverMt();
+			world = new btDiscreteDynamicsWorldMt(dispatcher, &broadphase, solverPool, solver, &collisionConfig);
+		}
+		else
+		{
+			dispatcher = new btCollisionDispatcher(&collisionConfig);
+			solver = new btSequentialImpulseConstraintSolver();
+			world = new btDiscreteDynamicsWorld(dispatcher, &broadphase, solver, &collisionConfig);
+		}
+
+		world->setGravity(btVector3(0, -10, 0));
+
+		// Square grid of stacks with a small gap, alternate stacks are offset so the pile topples & settles.
+		const int stackCount = (int)((bodyCount + PHYSICSBENCHMARK_STACK_HEIGHT - 1) / PHYSICSBENCHMARK_STACK_HEIGHT);
+		const int side = (int)std::ceil(std::sqrt((float)stackCount));
+		const float spacing = PHYSICSBENCHMARK_HALF_EXTENT * 2.0f + 0.05f;
+
+		btBoxShape groundShape(btVector3(side * spacing + 10.0f, 1.0f, side * spacing + 10.0f));
+		btBoxShape boxShape(btVector3(PHYSICSBENCHMARK_HALF_EXTENT, PHYSICSBENCHMARK_HALF_EXTENT, PHYSICSBENCHMARK_HALF_EXTENT));
+		btVector3 boxInertia(0, 0, 0);
+		boxShape.calculateLocalInertia(1.0f, boxInertia);
+
+		std::vector<btRigidBody*> bodies;
+		bodies.reserve(bodyCount + 1);
+
+		btTransform transform;
+		transform.setIdentity();
+		transform.setOrigin(btVector3(0, -1.0f, 0));
+		bodies.push_back(new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(0.0f, nullptr, &groundShape)));
+		bodies.back()->setWorldTransform(transform);
+		world->addRigidBody(bodies.back());
+
+		for (uint32 i = 0; i < bodyCount; i++)
+		{
+			const int stack = (int)(i / PHYSICSBENCHMARK_STACK_HEIGHT);
+			const int level = (int)(i % PHYSICSBENCHMARK_STACK_HEIGHT);
+			const float offset = (stack % 2) * PHYSICSBENCHMARK_HALF_EXTENT * 0.3f * (level % 2);
+			const float x = ((stack % side) - side * 0.5f) * spacing + offset;
+			const float z = ((stack / side) - side * 0.5f) * spacing;
+			const float y = PHYSICSBENCHMARK_HALF_EXTENT + level * (PHYSICSBENCHMARK_HALF_EXTENT * 2.0f + 0.01f);
+
+			transform.setOrigin(btVector3(x, y, z));
+			btRigidBody* body = new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(1.0f, nullptr, &boxShape, boxInertia));
+			body->setWorldTransform(transform);
+			bodies.push_back(body);
+			world->addRigidBody(body);
+		}
+
+		PhysicsBenchmarkResult result;
+		result.m_world = multithreaded ? "btDiscreteDynamicsWorldMt" : "btDiscreteDynamicsWorld";
+		result.m_threadCount = threadCount;
+
+		double total = 0.0;
+		for (uint32 i = 0; i < steps; i++)
+		{
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			world->stepSimulation(PHYSICSBENCHMARK_DELTA, 0);
+			const double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			total += duration;
+			result.m_maxStepMS = duration > result.m_maxStepMS ? duration : result.m_maxStepMS;
+		}
+
+		result.m_averageStepMS = steps > 0 ? total / steps : 0.0;
+
+		for (btRigidBody* body : bodies)
+		{
+			world->removeRigidBody(body);
+			delete body;
+		}
+
+		delete world;
+		delete solver;
+		delete solverPool;
+		delete dispatcher;
+		return result;
+	}
+}
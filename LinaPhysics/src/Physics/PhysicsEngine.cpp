@@ -32,6 +32,10 @@ SOFTWARE.
 #include "ECS/Components/TransformComponent.hpp"
 #include "Utility/UtilityFunctions.hpp"
 #include "Utility/Math/Color.hpp"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include <algorithm>
 
 
 namespace LinaEngine::Physics
@@ -45,15 +49,6 @@ namespace LinaEngine::Physics
 	{
 		LINA_CORE_TRACE("[Destructor] -> Physics Engine ({0})", typeid(*this).name());
 
-		// Remove collision shapes.
-		for (std::map<int, btRigidBody*>::iterator it = m_bodies.begin(); it != m_bodies.end(); ++it)
-		{
-			if (it->second->getMotionState())
-			{
-				delete it->second->getCollisionShape();
-			}
-		}
-
 		//remove the rigidbodies from the dynamics world and delete them
 		for (int i = m_world->getNumCollisionObjects() - 1; i >= 0; i--)
 		{
@@ -69,9 +64,16 @@ namespace LinaEngine::Physics
 
 		delete m_world;
 		delete m_impulseSolver;
+		delete m_solverPool;
 		delete m_overlappingPairCache;
 		delete m_collisionDispatcher;
 		delete m_collisionConfig;
+
+		// Remove collision shapes.
+		m_shapeCache.Clear();
+
+		if (m_multithreaded && btGetTaskScheduler() == &m_taskScheduler)
+			btSetTaskScheduler(nullptr);
 	}
 
 	void PhysicsEngine::Initialize(LinaEngine::ECS::ECSRegistry& ecsReg, std::function<void(Vector3,Vector3,Color,float)>& cb)
@@ -84,17 +86,34 @@ namespace LinaEngine::Physics
 		// collision configuration contains default setup for memory, collision setup. Advanced users can create their own configuration.
 		m_collisionConfig = new btDefaultCollisionConfiguration();
 
-		// use the default collision dispatcher. For parallel processing you can use a diffent dispatcher (see Extras/BulletMultiThreaded)
-		m_collisionDispatcher = new btCollisionDispatcher(m_collisionConfig);
-
 		// btDbvtBroadphase is a good general purpose broadphase. You can also try out btAxis3Sweep.
 		m_overlappingPairCache = new btDbvtBroadphase();
 
-		// the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
-		m_impulseSolver = new btSequentialImpulseConstraintSolver;
+		if (m_multithreaded && !PhysicsTaskScheduler::IsBulletThreadSafe())
+		{
+			LINA_CORE_WARN("[Physics Engine] -> Bullet libraries are built without BT_THREADSAFE, falling back to the single threaded world.");
+			m_multithreaded = false;
+		}
+
+		if (m_multithreaded)
+		{
+			// The scheduler has to be set before the Mt dispatcher, which sizes its per thread storage from it.
+			btSetTaskScheduler(&m_taskScheduler);
+
+			// Narrowphase over pairs in parallel, a solver per thread for small islands & a parallel solver for large ones.
+			m_collisionDispatcher = new btCollisionDispatcherMt(m_collisionConfig);
+			m_solverPool = new btConstraintSolverPoolMt(m_taskScheduler.getMaxNumThreads());
+			m_impulseSolver = new btSequentialImpulseConstraintSolverMt();
+			m_world = new btDiscreteDynamicsWorldMt(m_collisionDispatcher, m_overlappingPairCache, m_solverPool, m_impulseSolver, m_collisionConfig);
+			LINA_CORE_TRACE("[Physics Engine] -> Multithreaded world on {0} threads", m_taskScheduler.getMaxNumThreads());
+		}
+		else
+		{
+			m_collisionDispatcher = new btCollisionDispatcher(m_collisionConfig);
+			m_impulseSolver = new btSequentialImpulseConstraintSolver;
+			m_world = new btDiscreteDynamicsWorld(m_collisionDispatcher, m_overlappingPairCache, m_impulseSolver, m_collisionConfig);
+		}
 
-		// Create dynamics world
-		m_world = new btDiscreteDynamicsWorld(m_collisionDispatcher, m_overlappingPairCache, m_impulseSolver, m_collisionConfig);
 		m_world->setGravity(btVector3(0, -10, 0));
 
 		// Initialize the debug drawer.
@@ -106,7 +125,7 @@ namespace LinaEngine::Physics
 		m_rigidbodySystem.Construct(ecsReg, this);
 		m_physicsPipeline.AddSystem(m_rigidbodySystem);
 		ecsReg.on_construct<LinaEngine::ECS::RigidbodyComponent>().connect<&PhysicsEngine::OnRigidbodyOrTransformAdded>(this);
-		ecsReg.on_destroy<LinaEngine::ECS::RigidbodyComponent>().connect<&PhysicsEngine::OnRigidbodyOrTransformAdded>(this);
+		ecsReg.on_destroy<LinaEngine::ECS::RigidbodyComponent>().connect<&PhysicsEngine::OnRigidbodyRemoved>(this);
 		ecsReg.on_construct<LinaEngine::ECS::TransformComponent>().connect<&PhysicsEngine::OnRigidbodyOrTransformAdded>(this);
 		ecsReg.on_update<LinaEngine::ECS::RigidbodyComponent>().connect<&PhysicsEngine::OnRigidbodyUpdated>(this);
 		
@@ -115,7 +134,9 @@ namespace LinaEngine::Physics
 
 	void PhysicsEngine::Tick(float fixedDelta)
 	{
-		// Update physics.
+		// Rebuild shapes of rescaled bodies & feed kinematic bodies before the step reads them, then update physics.
+		m_rigidbodySystem.RefreshScaledShapes();
+		m_rigidbodySystem.PushKinematicTransforms();
 		m_world->stepSimulation(fixedDelta, 10);
 		m_physicsPipeline.UpdateSystems(fixedDelta);
 	}
@@ -125,6 +146,17 @@ namespace LinaEngine::Physics
 
 	}
 
+	void PhysicsEngine::SetMultithreaded(bool multithreaded)
+	{
+		if (m_world != nullptr)
+		{
+			LINA_CORE_WARN("[Physics Engine] -> The world is already created, multithreading can only be changed before initialization.");
+			return;
+		}
+
+		m_multithreaded = multithreaded;
+	}
+
 	void PhysicsEngine::OnRigidbodyOrTransformAdded(entt::registry& reg, entt::entity ent)
 	{
 		// If the object doesn't have a transform & rigidbody yet, return.
@@ -135,16 +167,20 @@ namespace LinaEngine::Physics
 		if (rb.m_alive) return;
 
 		LinaEngine::ECS::TransformComponent& tr = reg.get<LinaEngine::ECS::TransformComponent>(ent);
-		btCollisionShape* colShape = GetCollisionShape(rb);
+		const Vector3 scale = tr.transform.GetScale();
+		btCollisionShape* colShape = m_shapeCache.Acquire(rb, scale);
 
 		btTransform transform;
 		transform.setIdentity();
 		Vector3 location = tr.transform.GetLocation();
+		Quaternion rotation = tr.transform.GetRotation();
 		transform.setOrigin(btVector3(location.x, location.y, location.z));
+		transform.setRotation(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w));
 
-		btScalar mass(rb.m_mass);
+		// Kinematic bodies get infinite mass, the solver must not push them around through contacts.
+		btScalar mass(rb.m_isKinematic ? 0.0f : rb.m_mass);
 
-		//rigidbody is dynamic if and only if mass is non zero, otherwise static
+		//rigidbody is dynamic if and only if mass is non zero & it isn't kinematic, otherwise static
 		bool isDynamic = (mass != 0.f);
 
 		btVector3 localInertia(0, 0, 0);
@@ -155,7 +191,7 @@ namespace LinaEngine::Physics
 		rb.m_localInertia = Vector3(localInertia.getX(), localInertia.getY(), localInertia.getZ());
 
 		// using motionstate is recommended, it provides interpolation capabilities, and only synchronizes 'active' objects
-		btDefaultMotionState* myMotionState = new btDefaultMotionState(transform);
+		PhysicsMotionState* myMotionState = new PhysicsMotionState(transform, ent, &m_movedStates);
 		btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, myMotionState, colShape, localInertia);
 		btRigidBody* body = new btRigidBody(rbInfo);
 
@@ -163,7 +199,9 @@ namespace LinaEngine::Physics
 		// so that its simulated.
 		int id = LinaEngine::Utility::GetUniqueID();
 		m_bodies[id] = body;
+		m_bodyScales[id] = scale;
 		rb.m_bodyID = id;
+		SetKinematic(id, body, rb.m_isKinematic);
 
 		rb.m_alive = true;
 		m_world->addRigidBody(body);
@@ -172,39 +210,89 @@ namespace LinaEngine::Physics
 	void PhysicsEngine::OnRigidbodyRemoved(entt::registry& reg, entt::entity ent)
 	{
 		LinaEngine::ECS::RigidbodyComponent& rbComp = reg.get<LinaEngine::ECS::RigidbodyComponent>(ent);
+		if (!rbComp.m_alive) return;
+
 		btRigidBody* rb = m_bodies[rbComp.m_bodyID];
-		
-		if (rb->getMotionState())
-			delete rb->getMotionState();
+		btMotionState* motionState = rb->getMotionState();
+
+		// Drop the state from the sync lists before it is gone.
+		m_kinematicStates.erase(rbComp.m_bodyID);
+		m_movedStates.erase(std::remove(m_movedStates.begin(), m_movedStates.end(), motionState), m_movedStates.end());
 
 		m_world->removeRigidBody(rb);
+		m_shapeCache.Release(rb->getCollisionShape());
+
+		delete motionState;
+		delete rb;
 
 		m_bodies.erase(rbComp.m_bodyID);
+		m_bodyScales.erase(rbComp.m_bodyID);
+		rbComp.m_alive = false;
 	}
 
 	void PhysicsEngine::OnRigidbodyUpdated(entt::registry& reg, entt::entity ent)
 	{
 		LinaEngine::ECS::RigidbodyComponent& rbComp = reg.get<LinaEngine::ECS::RigidbodyComponent>(ent);
 		btRigidBody* rb = m_bodies[rbComp.m_bodyID];
+		const Vector3 scale = reg.has<LinaEngine::ECS::TransformComponent>(ent) ? reg.get<LinaEngine::ECS::TransformComponent>(ent).transform.GetScale() : Vector3::One;
 
-		// We remove the body, replace the collision shape
-		// Recalculate it and add it to the world again.
-		rb->activate(true);
-		m_world->removeRigidBody(rb);
-
+		// Swap the shape in place, the body stays in the broadphase & only its stale pairs are dropped.
 		btCollisionShape* previousShape = rb->getCollisionShape();
-		btCollisionShape* newShape = GetCollisionShape(rbComp);
-		rb->setCollisionShape(newShape);
+		btCollisionShape* newShape = m_shapeCache.Acquire(rbComp, scale);
+		m_bodyScales[rbComp.m_bodyID] = scale;
+
+		if (newShape != previousShape)
+		{
+			rb->setCollisionShape(newShape);
 
+			if (rb->getBroadphaseHandle())
+				m_world->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(rb->getBroadphaseHandle(), m_world->getDispatcher());
+		}
+
+		// Zero mass for kinematic bodies as on creation.
+		const btScalar mass(rbComp.m_isKinematic ? 0.0f : rbComp.m_mass);
 		btVector3 inertia(0, 0, 0);
-		newShape->calculateLocalInertia(btScalar(rbComp.m_mass), inertia);
+		if (mass != 0.0f)
+			newShape->calculateLocalInertia(mass, inertia);
+
+		rbComp.m_localInertia = Vector3(inertia.getX(), inertia.getY(), inertia.getZ());
 
-		rb->setMassProps(btScalar(rbComp.m_mass), inertia);
+		// Static or kinematic & dynamic bodies live in different collision filter groups, flipping between them needs a re-add.
+		const bool wasStatic = rb->isStaticOrKinematicObject();
+		rb->setMassProps(mass, inertia);
 		rb->updateInertiaTensor();
+		SetKinematic(rbComp.m_bodyID, rb, rbComp.m_isKinematic);
+
+		if (wasStatic != rb->isStaticOrKinematicObject())
+		{
+			m_world->removeRigidBody(rb);
+			m_world->addRigidBody(rb);
+		}
+		else
+			m_world->updateSingleAabb(rb);
 
-		delete previousShape;
+		rb->activate(true);
+		m_shapeCache.Release(previousShape);
+	}
+
+	void PhysicsEngine::SetKinematic(int id, btRigidBody* body, bool kinematic)
+	{
+		if (kinematic)
+		{
+			// Kinematic bodies never sleep, Bullet reads their motion state every step.
+			body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+			body->setActivationState(DISABLE_DEACTIVATION);
+			m_kinematicStates[id] = static_cast<PhysicsMotionState*>(body->getMotionState());
+		}
+		else
+		{
+			body->setCollisionFlags(body->getCollisionFlags() & ~btCollisionObject::CF_KINEMATIC_OBJECT);
+
+			if (body->getActivationState() == DISABLE_DEACTIVATION)
+				body->forceActivationState(ACTIVE_TAG);
 
-		m_world->addRigidBody(rb);
+			m_kinematicStates.erase(id);
+		}
 	}
 
 	void PhysicsEngine::OnPostSceneDraw()
@@ -213,22 +301,5 @@ namespace LinaEngine::Physics
 			m_world->debugDrawWorld();
 	}
 
-	btCollisionShape* PhysicsEngine::GetCollisionShape(LinaEngine::ECS::RigidbodyComponent rb)
-	{
-		btCollisionShape* colShape = nullptr;
-
-		// Create collision shape depending on the type
-		if (rb.m_collisionShape == LinaEngine::ECS::CollisionShape::BOX)
-			colShape = new btBoxShape(btVector3(rb.m_halfExtents.x, rb.m_halfExtents.y, rb.m_halfExtents.z));
-		else if (rb.m_collisionShape == LinaEngine::ECS::CollisionShape::Sphere)
-			colShape = new btSphereShape(btScalar(rb.m_radius));
-		else if (rb.m_collisionShape == LinaEngine::ECS::CollisionShape::CAPSULE)
-			colShape = new btCapsuleShape(btScalar(rb.m_radius), btScalar(rb.m_capsuleHeight));
-		else if (rb.m_collisionShape == LinaEngine::ECS::CollisionShape::Cylinder)
-			colShape = new btCylinderShape(btVector3(rb.m_halfExtents.x, rb.m_halfExtents.y, rb.m_halfExtents.z));
-
-		return colShape;
-	}
-
 }
 
@@ -0,0 +1,58 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/PhysicsMotionState.hpp"
+
+namespace LinaEngine::Physics
+{
+	void PhysicsMotionState::setWorldTransform(const btTransform& worldTransform)
+	{
+		m_worldTransform = worldTransform;
+
+		// Called from synchronizeMotionStates on the stepping thread, queue once per step.
+		if (!m_moved)
+		{
+			m_moved = true;
+			m_movedStates->push_back(this);
+		}
+	}
+
+	bool PhysicsMotionState::SetKinematicTransform(const Vector3& location, const Quaternion& rotation)
+	{
+		const btVector3 origin(location.x, location.y, location.z);
+		const btQuaternion orientation(rotation.x, rotation.y, rotation.z, rotation.w);
+
+		if (m_worldTransform.getOrigin() == origin && m_kinematicRotation == orientation)
+			return false;
+
+		m_worldTransform.setOrigin(origin);
+		m_worldTransform.setRotation(orientation);
+		m_kinematicRotation = orientation;
+		return true;
+	}
+}
@@ -0,0 +1,131 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/PhysicsTaskScheduler.hpp"
+#include "Core/JobSystem.hpp"
+
+namespace LinaEngine::Physics
+{
+	thread_local int PhysicsTaskScheduler::s_callerThreadLimit = 0;
+
+	PhysicsTaskScheduler::PhysicsTaskScheduler() : btITaskScheduler("LinaJobSystem")
+	{
+		// Worker threads plus the calling one, Bullet can't index more than BT_MAX_THREAD_COUNT.
+		const int poolSize = (int)JobSystem::Get().GetWorkerCount() + 1;
+		m_maxThreadCount = poolSize < (int)BT_MAX_THREAD_COUNT ? poolSize : (int)BT_MAX_THREAD_COUNT;
+		m_activeThreadCount = m_maxThreadCount;
+	}
+
+	void PhysicsTaskScheduler::setNumThreads(int numThreads)
+	{
+		m_activeThreadCount = numThreads < 1 ? 1 : (numThreads > m_maxThreadCount ? m_maxThreadCount : numThreads);
+	}
+
+	void PhysicsTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+	{
+		const int count = iEnd - iBegin;
+		if (count <= 0) return;
+
+		const int rangeSize = GetRangeSize(count, grainSize);
+		if (rangeSize >= count)
+		{
+			body.forLoop(iBegin, iEnd);
+			return;
+		}
+
+		JobSystem& jobSystem = JobSystem::Get();
+		std::vector<std::future<void>> futures;
+		for (int begin = iBegin + rangeSize; begin < iEnd; begin += rangeSize)
+		{
+			const int end = begin + rangeSize < iEnd ? begin + rangeSize : iEnd;
+			futures.push_back(jobSystem.Submit([&body, begin, end]() { body.forLoop(begin, end); }));
+		}
+
+		body.forLoop(iBegin, iBegin + rangeSize);
+
+		for (std::future<void>& future : futures)
+			jobSystem.Wait(future);
+	}
+
+	btScalar PhysicsTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+	{
+		const int count = iEnd - iBegin;
+		if (count <= 0) return btScalar(0);
+
+		const int rangeSize = GetRangeSize(count, grainSize);
+		if (rangeSize >= count)
+			return body.sumLoop(iBegin, iEnd);
+
+		// Each range writes its own slot, summed in order once all of them are done.
+		const int rangeCount = (count + rangeSize - 1) / rangeSize;
+		std::vector<btScalar> sums(rangeCount, btScalar(0));
+
+		JobSystem& jobSystem = JobSystem::Get();
+		std::vector<std::future<void>> futures;
+		for (int range = 1; range < rangeCount; range++)
+		{
+			const int begin = iBegin + range * rangeSize;
+			const int end = begin + rangeSize < iEnd ? begin + rangeSize : iEnd;
+			btScalar* sum = &sums[range];
+			futures.push_back(jobSystem.Submit([&body, begin, end, sum]() { *sum = body.sumLoop(begin, end); }));
+		}
+
+		sums[0] = body.sumLoop(iBegin, iBegin + rangeSize);
+
+		for (std::future<void>& future : futures)
+			jobSystem.Wait(future);
+
+		btScalar total = btScalar(0);
+		for (btScalar sum : sums)
+			total += sum;
+
+		return total;
+	}
+
+	bool PhysicsTaskScheduler::IsBulletThreadSafe()
+	{
+		// Only a thread safe build creates the default scheduler, it is dropped right away.
+		static const bool threadSafe = []()
+		{
+			btITaskScheduler* scheduler = btCreateDefaultTaskScheduler();
+			const bool created = scheduler != nullptr;
+			delete scheduler;
+			return created;
+		}();
+
+		return threadSafe;
+	}
+
+	int PhysicsTaskScheduler::GetRangeSize(int count, int grainSize) const
+	{
+		const int minGrain = grainSize < 1 ? 1 : grainSize;
+		const int threads = s_callerThreadLimit > 0 ? (s_callerThreadLimit < m_maxThreadCount ? s_callerThreadLimit : m_maxThreadCount) : m_activeThreadCount;
+		const int evenSize = (count + threads - 1) / threads;
+		return evenSize > minGrain ? evenSize : minGrain;
+	}
+}
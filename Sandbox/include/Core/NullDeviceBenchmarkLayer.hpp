@@ -0,0 +1,82 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: NullDeviceBenchmarkLayer
+
+Headless frame benchmark for builds with LINA_GRAPHICS_NULL. Runs the loaded level for a fixed number
+of frames against the null render device, logs the average CPU frame time & the per frame device
+statistics, then closes the application.
+
+Timestamp: 10/20/2026 11:41:19 AM
+*/
+
+#pragma once
+
+#ifndef NullDeviceBenchmarkLayer_HPP
+#define NullDeviceBenchmarkLayer_HPP
+
+#ifdef LINA_GRAPHICS_NULL
+
+#include "Core/Layer.hpp"
+#include "PackageManager/Null/RenderCommandStream.hpp"
+
+// First frames create & upload the level resources, they are left out of the averages.
+#define NULLBENCHMARK_WARMUP_FRAMES 60
+#define NULLBENCHMARK_FRAMES 600
+
+namespace LinaEngine
+{
+	class NullDeviceBenchmarkLayer : public Layer
+	{
+	public:
+
+		NullDeviceBenchmarkLayer() : Layer("NullDeviceBenchmark") {};
+		~NullDeviceBenchmarkLayer() {};
+
+		virtual void Tick(float deltaTime) override;
+
+	private:
+
+		void LogResults();
+
+	private:
+
+		uint32 m_frame = 0;
+		double m_frameTimeSum = 0.0;
+		uint64 m_drawCalls = 0;
+		uint64 m_commands = 0;
+		uint64 m_uniformUpdates = 0;
+		uint64 m_uploadedBytes = 0;
+		uint64 m_validationErrors = 0;
+	};
+}
+
+#endif
+
+#endif
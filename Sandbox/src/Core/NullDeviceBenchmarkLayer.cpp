@@ -0,0 +1,73 @@
+/*
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/NullDeviceBenchmarkLayer.hpp"
+
+#ifdef LINA_GRAPHICS_NULL
+
+#include "Core/Application.hpp"
+#include "Rendering/RenderEngine.hpp"
+#include "Rendering/Window.hpp"
+
+namespace LinaEngine
+{
+	void NullDeviceBenchmarkLayer::Tick(float deltaTime)
+	{
+		// Layers tick before the frame renders, the device statistics belong to the previous frame.
+		m_frame++;
+		if (m_frame <= NULLBENCHMARK_WARMUP_FRAMES) return;
+
+		const Graphics::RenderDeviceFrameStats& stats = Graphics::RenderEngine::GetRenderDevice().GetFrameStats();
+		m_frameTimeSum += Application::GetApp().GetRawDelta();
+		m_drawCalls += stats.m_drawCalls;
+		m_commands += stats.m_commands;
+		m_uniformUpdates += stats.m_uniformUpdates;
+		m_uploadedBytes += stats.m_uploadedBytes;
+		m_validationErrors += stats.m_validationErrors;
+
+		if (m_frame == NULLBENCHMARK_WARMUP_FRAMES + NULLBENCHMARK_FRAMES)
+		{
+			LogResults();
+			Application::GetAppWindow().Close();
+		}
+	}
+
+	void NullDeviceBenchmarkLayer::LogResults()
+	{
+		const double frames = (double)NULLBENCHMARK_FRAMES;
+		LINA_CLIENT_INFO("[Null Device Benchmark] {0} frames, {1:.3f} ms per frame", NULLBENCHMARK_FRAMES, m_frameTimeSum * 1000.0 / frames);
+		LINA_CLIENT_INFO("[Null Device Benchmark] Per frame: {0:.1f} draw calls, {1:.1f} commands, {2:.1f} uniform updates, {3:.1f} KB uploaded", m_drawCalls / frames, m_commands / frames, m_uniformUpdates / frames, m_uploadedBytes / frames / 1024.0);
+
+		if (m_validationErrors > 0)
+		{
+			LINA_CLIENT_ERR("[Null Device Benchmark] {0} validation errors", m_validationErrors);
+		}
+	}
+}
+
+#endif
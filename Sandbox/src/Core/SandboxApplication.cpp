@@ -33,6 +33,7 @@ Timestamp: 12/29/2018 11:15:41 PM
 #include "ECS/Components/RigidbodyComponent.hpp"
 #include "FPSDemo/HeadbobComponent.hpp"
 #include "FPSDemo/PlayerMotionComponent.hpp"
+#include "Core/NullDeviceBenchmarkLayer.hpp"
 
 class SandboxApplication : public LinaEngine::Application
 {
@@ -67,6 +68,11 @@ class SandboxApplication : public LinaEngine::Application
 
 		InstallLevel(m_fpsDemoLevel, true, "resources/sandbox/FPSDemo/levels/", "FPSDemo");
 
+#ifdef LINA_GRAPHICS_NULL
+		// Headless builds benchmark the level against the null device & quit.
+		GetMainStack().PushLayer(m_nullDeviceBenchmark);
+#endif
+
 		// Run engine.
 		Run();
 
@@ -86,6 +92,10 @@ class SandboxApplication : public LinaEngine::Application
 		FPSDemoLevel m_fpsDemoLevel;
 		Example1Level m_startupLevel;
 
+#ifdef LINA_GRAPHICS_NULL
+		LinaEngine::NullDeviceBenchmarkLayer m_nullDeviceBenchmark;
+#endif
+
 
 		// Inherited via Application
 		virtual void SerializeRegistry(LinaEngine::ECS::ECSRegistry& registry, cereal::BinaryOutputArchive& oarchive) override